@@ -21,6 +21,7 @@
 #define ASR_CLIENT_H
 
 #include <ixwebsocket/IXWebSocket.h>
+#include <deque>
 #include <string>
 #include <vector>
 #include <map>
@@ -30,6 +31,13 @@
 #include <zlib.h>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
+#include <optional>
+#include "asr/async_executor.h"
+#include "asr/session_capture.h"
+#include "asr/packet_size_controller.h"
+#include "asr/request_scheduler.h"
+#include "asr/session_memory.h"
 
 using json = nlohmann::json;
 
@@ -426,7 +434,7 @@ public:
     // ============================================================================
 
     /**
-     * @brief 连接到 ASR 服务器
+     * @brief 连接到 ASR 服务器（阻塞等待 connectAsync() 完成，最长 5 秒）
      * @return 是否成功启动连接
      */
     bool connect();
@@ -484,6 +492,43 @@ public:
      */
     std::string sendFullClientRequestAndGetResponse(int timeoutMs = 5000);
 
+    // ============================================================================
+    // 异步接口
+    // ============================================================================
+    //
+    // 返回的 Future 由 WebSocket 回调线程完成，then() 的后续处理在执行器上运行，
+    // 超时由执行器的定时器触发；调用线程不需要等待。失败时 error().code 为服务端错误码，
+    // 超时为 ERROR_TIMEOUT，连接关闭 / 断开为 ERROR_UNKNOWN。上面的阻塞接口在这些 Future 上等待。
+
+    /**
+     * @brief 设置执行后续处理与超时的执行器（为空时使用 AsyncExecutor::shared()）
+     *
+     * 应在 connectAsync() 之前设置；多个会话共用一个执行器即可由一个线程驱动
+     */
+    void setExecutor(std::shared_ptr<AsyncExecutor> executor);
+    std::shared_ptr<AsyncExecutor> getExecutor() const;
+
+    /**
+     * @brief 开始连接，WebSocket 打开时完成
+     */
+    AsrFuture<bool> connectAsync(int timeoutMs = 5000);
+
+    /**
+     * @brief 发送完整客户端请求，收到会话开始的响应时完成（值为响应 JSON）
+     */
+    AsrFuture<std::string> sendFullClientRequestAsync(int timeoutMs = 5000);
+
+    /**
+     * @brief 发送音频包，收到该包对应的服务端响应时完成（服务端按发送顺序逐包响应）
+     */
+    AsrFuture<std::string> sendAudioAsync(const std::vector<uint8_t>& audioData, int32_t sequence,
+                                          int timeoutMs = 3000);
+
+    /**
+     * @brief 收到最终结果（最后一包音频的响应）时完成；已收到时立即完成
+     */
+    AsrFuture<std::string> finalResponseAsync(int timeoutMs = 5000) const;
+
     // ============================================================================
     // 获取状态信息
     // ============================================================================
@@ -506,6 +551,19 @@ public:
      */
     std::string getFullClientRequestJson() const;
 
+    /**
+     * @brief 按给定配置构造 Full Client Request 的请求 JSON（不需要连接）
+     * @param config API 配置
+     * @return 请求 JSON 对象
+     */
+    static json constructRequest(const AsrApiConfig& config);
+
+    /**
+     * @brief 获取当前 API 配置
+     * @return API 配置（只读）
+     */
+    const AsrApiConfig& getApiConfig() const;
+
     // ============================================================================
     // 错误处理方法
     // ============================================================================
@@ -552,7 +610,7 @@ public:
     // ============================================================================
 
     /**
-     * @brief 获取用于等待最终响应的同步原语
+     * @brief 获取用于等待最终响应的同步原语（兼容保留，新代码使用 finalResponseAsync()）
      * @return 同步原语
      */
     std::mutex& getMutex();
@@ -563,8 +621,48 @@ public:
     // 新增：测试握手/鉴权
     bool testHandshake();
 
+    // ============================================================================
+    // 会话抓包与回放
+    // ============================================================================
+
+    /**
+     * @brief 设置会话录制器，录制之后收发的每一个 WebSocket 帧
+     * @param recorder 为空时停止录制；应在 connect() 之前设置
+     */
+    void setSessionRecorder(std::shared_ptr<SessionRecorder> recorder);
+
+    /**
+     * @brief 回放入口：把一条消息直接交给消息处理（不经过网络，也不录制）
+     *
+     * 与 WebSocket 线程收到消息时走同一路径（parseBinaryResponse、分句与回调），
+     * 供 replayIntoClient() 在无网络时重现服务端响应
+     */
+    void injectMessage(const ix::WebSocketMessagePtr& msg);
+
     bool waitForResponse(int timeoutMs, std::string* response = nullptr);
 
+    // ============================================================================
+    // 链路测量
+    // ============================================================================
+
+    /**
+     * @brief 设置分包时长控制器，之后每个音频包的响应 RTT 与结果延迟都报告给它
+     *
+     * 服务端对每个音频包回复一条响应，按发送顺序匹配；结果中分句的最晚结束时间
+     * 对应会话内已发送音频的位置，据此计算“发出该段音频 → 收到识别文本”的延迟
+     */
+    void setPacketSizeController(std::shared_ptr<PacketSizeController> controller);
+
+    /**
+     * @brief 持有调度器发放的会话许可，disconnect() 或析构时归还
+     */
+    void setSchedulerLease(SessionLease lease);
+
+    /**
+     * @brief 会话内存统计：帧缓冲池、响应暂存区与 zlib 流的复用情况
+     */
+    SessionMemoryStats getMemoryStats() const;
+
     // ============================================================================
     // 音频格式验证方法
     // ============================================================================
@@ -610,6 +708,16 @@ private:
      * @param msg WebSocket 消息指针
      */
     void handleMessage(const ix::WebSocketMessagePtr& msg);
+
+    /**
+     * @brief 按消息类型分发（handleMessage 录制后调用，回放时直接调用）
+     */
+    void dispatchMessage(const ix::WebSocketMessagePtr& msg);
+
+    /**
+     * @brief 把收到的消息写入会话录制器
+     */
+    void recordMessage(const ix::WebSocketMessagePtr& msg);
     
     /**
      * @brief 处理二进制消息
@@ -671,6 +779,29 @@ private:
      * @param j JSON对象
      */
     void extractLogId(const json& j);
+
+    /**
+     * @brief 记录发出的音频包 / 按收到的响应计算 RTT 与结果延迟（未设置控制器时不记录）
+     */
+    void probePacketSent(size_t audioBytes, bool sent);
+    void probeResponse(const json& j);
+
+    /**
+     * @brief 异步等待者：发出的请求按顺序与响应匹配，出错 / 断开时全部失败
+     */
+    using ResponseWaiter = std::optional<AsrPromise<std::string>>;
+    void pushResponseWaiter(ResponseWaiter waiter);
+    void dropResponseWaiter(const ResponseWaiter& waiter);
+    void resolveNextResponse(const std::string& jsonStr);
+    void resolveFinalWaiters(const std::string& jsonStr);
+    void failAsyncWaiters(uint32_t code, const std::string& message);
+    void takeResponseWaitersLocked(std::vector<AsrPromise<std::string>>& waiters);
+
+    /**
+     * @brief 发送完整客户端请求 / 音频包；waiter 在发送前登记，保证先于响应
+     */
+    bool sendFullClientRequestPacket(ResponseWaiter waiter);
+    bool sendAudioPacket(const std::vector<uint8_t>& audioData, int32_t sequence, ResponseWaiter waiter);
     
     /**
      * @brief 检查会话是否已开始
@@ -704,7 +835,7 @@ private:
      * @param reservedData 保留数据
      * @return 4 字节的协议头部
      */
-    std::vector<uint8_t> generateHeader(uint8_t messageType, uint8_t messageTypeSpecificFlags, 
+    std::array<uint8_t, 4> generateHeader(uint8_t messageType, uint8_t messageTypeSpecificFlags, 
                                        uint8_t serialMethod, uint8_t compressionType, uint8_t reservedData);
     
     /**
@@ -717,30 +848,10 @@ private:
     /**
      * @brief 解析二进制响应协议
      * @param binaryData 二进制数据
-     * @return 解析后的 JSON 字符串
+     * @param out 解析后的 JSON 字符串（写入调用方的缓冲区，复用其容量）
+     * @return 是否解析出内容
      */
-    std::string parseBinaryResponse(const std::string& binaryData);
-    
-    /**
-     * @brief GZIP 压缩字符串
-     * @param data 原始字符串
-     * @return 压缩后的数据
-     */
-    std::vector<uint8_t> gzipCompress(const std::string& data);
-    
-    /**
-     * @brief GZIP 压缩字节数组
-     * @param data 原始字节数组
-     * @return 压缩后的数据
-     */
-    std::vector<uint8_t> gzipCompress(const std::vector<uint8_t>& data);
-    
-    /**
-     * @brief Gzip 解压缩
-     * @param data 要解压缩的数据
-     * @return 解压缩后的字符串
-     */
-    std::string gzipDecompress(const std::string& data);
+    bool parseBinaryResponse(const std::string& binaryData, std::string& out);
     
     /**
      * @brief 生成 UUID
@@ -770,6 +881,34 @@ private:
     std::mutex m_mutex;
     std::condition_variable m_cv;
     std::string m_lastResponse;
+    // 会话录制（为空时不录制）
+    std::shared_ptr<SessionRecorder> m_recorder;
+    // 最近发出的音频包的追踪流 id（事件追踪启用时由发送线程写入，网络线程读取）
+    std::atomic<uint64_t> m_traceFlow{0};
+    // 在途记录的上限：服务端不按包回复（或不返回时间戳）时只保留最近的记录
+    static constexpr size_t kMaxInFlightRecords = 1024;
+    // 链路测量：发送线程写入、网络线程读取，m_probeMutex 保护
+    struct SentPacket {
+        int64_t audioEndMs = 0;     // 包结束在会话音频时间线上的位置
+        int64_t sentNs = 0;
+    };
+    std::shared_ptr<PacketSizeController> m_packetSizer;
+    std::mutex m_probeMutex;
+    RingQueue<SentPacket> m_awaitingResponse{kMaxInFlightRecords};
+    RingQueue<SentPacket> m_awaitingResult{kMaxInFlightRecords};
+    int64_t m_sentAudioMs = 0;
+    int64_t m_resultEndMs = 0;
+    // 会话许可（由 AsrManager 通过 RequestScheduler 获取）
+    SessionLease m_schedulerLease;
+    std::mutex m_leaseMutex;
+    // 异步接口：按发送顺序等待响应（同步发送的包以空位占位），连接与最终结果的等待者
+    std::shared_ptr<AsyncExecutor> m_executor;
+    mutable std::mutex m_asyncMutex;
+    RingQueue<ResponseWaiter> m_responseWaiters{kMaxInFlightRecords};
+    std::vector<AsrPromise<bool>> m_connectWaiters;
+    mutable std::vector<AsrPromise<std::string>> m_finalWaiters;
+    // 会话内存：协议帧缓冲池、zlib 流与响应暂存区，disconnect() 时整体释放
+    SessionMemory m_memory;
 };
 
 } // namespace Asr
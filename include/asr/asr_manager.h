@@ -33,6 +33,7 @@
 #include <filesystem>
 #include "asr/asr_client.h"
 #include "asr/asr_debug_config.h"
+#include "asr/transcription_cache.h"
 #include "secure_key_manager.h"     //仅服务于LOG打印信息的隐码
 
 namespace Asr {
@@ -223,6 +224,40 @@ struct AsrConfig {
     // ============================================================================
     bool enableUsageTracking = true;                       // 是否启用使用统计
     std::string statsDataDir = "";                         // 统计数据存储目录
+
+    // ============================================================================
+    // 实时会话切换配置
+    // ============================================================================
+    int liveSessionMaxMs = 30 * 60 * 1000;                 // 单个实时会话最长时长，到期前切换到新会话（0 表示不切换）
+    int liveSessionOverlapMs = 10000;                      // 新旧会话同时接收音频的重叠时长
+    int liveSessionFinalizeTimeoutMs = 5000;               // 旧会话等待最终结果的超时
+
+    // ============================================================================
+    // 识别结果缓存配置
+    // ============================================================================
+    bool enableResultCache = true;                         // 是否启用文件识别结果缓存
+    uint64_t resultCacheMaxBytes = 256ull * 1024 * 1024;   // 缓存目录容量上限（字节）
+
+    // ============================================================================
+    // 文件识别断线续传配置
+    // ============================================================================
+    int fileRetryMaxAttempts = 8;                          // 连续无进展时的最大重连次数
+    uint32_t fileRetryMinWaitMs = 1000;                    // 重连退避最短等待（毫秒）
+    uint32_t fileRetryMaxWaitMs = 30000;                   // 重连退避最长等待（毫秒）
+
+    // ============================================================================
+    // 音频分包配置
+    // ============================================================================
+    bool adaptivePacketSize = true;                        // 按测得的 RTT 与结果延迟调整每包音频时长
+    int packetMs = 100;                                    // 初始（关闭自适应时为固定）包时长
+    int minPacketMs = 50;                                  // 自适应下限
+    int maxPacketMs = 400;                                 // 自适应上限
+
+    // ============================================================================
+    // 请求调度配置
+    // ============================================================================
+    RequestPriority requestPriority = RequestPriority::INTERACTIVE; // 会话许可与音频额度的优先级
+    int schedulerWaitMs = 120000;                          // 等待许可 / 额度的上限（毫秒，<0 表示一直等）
 };
 
 /**
@@ -308,6 +343,64 @@ public:
     bool startRecognition();
     void stopRecognition();
     
+    // ============================================================================
+    // 实时会话无缝切换（先建后断）
+    // ============================================================================
+    
+    /**
+     * @brief 创建并连接一个新的识别会话（已发送初始化包）
+     *
+     * 阻塞直到会话就绪或失败，应在后台线程调用。返回的会话尚未接收音频，
+     * 由调用方在合适的时间点通过 attachStandbySession() 接入
+     * @return 就绪的客户端，失败时返回空
+     */
+    std::unique_ptr<AsrClient> openStandbySession();
+    
+    /**
+     * @brief 接入备用会话，此后 sendAudio() 同时发往主会话与备用会话
+     */
+    void attachStandbySession(std::unique_ptr<AsrClient> client);
+    
+    /**
+     * @brief 备用会话转为主会话
+     * @return 原主会话，由调用方发送结束包、等待定稿后断开
+     */
+    std::unique_ptr<AsrClient> promoteStandbySession();
+    
+    /**
+     * @brief 断开并丢弃备用会话
+     */
+    void discardStandbySession();
+    
+    bool hasStandbySession() const;
+    
+    /**
+     * @brief 当前主会话客户端（用于区分回调消息来自哪个会话）
+     */
+    const AsrClient* getActiveClient() const;
+
+    // ============================================================================
+    // 音频分包
+    // ============================================================================
+
+    /**
+     * @brief 当前每包音频时长（毫秒）
+     *
+     * 实时调用方按此值切分音频；文件识别按 100ms 的整数倍合并发送
+     */
+    int getPacketMs() const;
+
+    /**
+     * @brief 分包控制器（本管理器创建的所有会话共享）
+     */
+    std::shared_ptr<PacketSizeController> getPacketSizeController() const;
+    PacketSizeStats getPacketSizeStats() const;
+
+    /**
+     * @brief 当前会话的会话内存统计（帧缓冲池与编解码状态的复用情况）
+     */
+    SessionMemoryStats getMemoryStats() const;
+    
     // ============================================================================
     // 音频文件处理
     // ============================================================================
@@ -431,7 +524,12 @@ private:
     // 私有方法
     // ============================================================================
     std::unique_ptr<AsrClient> createClient(ClientType type);
+    std::unique_ptr<AsrClient> createConfiguredClient();
     bool initializeClient();
+    // 经请求调度器取得会话许可后建立连接，并把连接结果反馈给调度器
+    bool connectClient(AsrClient& client);
+    // 发送前扣除音频额度（实时优先级立即返回）
+    bool acquireAudioBudget(size_t bytes);
     void updateStatus(AsrStatus status);
     AudioFileInfo parseWavFile(const std::string& filePath, const std::vector<uint8_t>& header);
     AudioFileInfo parsePcmFile(const std::string& filePath, const std::vector<uint8_t>& header);
@@ -446,12 +544,25 @@ private:
     bool createDataDirectory() const;
     void logStats(const std::string& message) const;
 
+    // 识别结果缓存相关私有方法
+    TranscriptionCache* getResultCache();
+    void finishFileResult(bool complete);
+    
+    // 文件识别会话与断线续传相关私有方法
+    bool resetFileClient(const AudioFileInfo& audioInfo);
+    bool runFileSession(size_t startPacket, bool waitForFinal, int timeoutMs, bool& receivedFinal);
+    size_t prepareFileResume();
+    void saveFileProgress();
+
     // ============================================================================
     // 私有成员变量
     // ============================================================================
     AsrConfig m_config;
     AsrStatus m_status;
     std::unique_ptr<AsrClient> m_client;
+    std::unique_ptr<AsrClient> m_standbyClient;              // 会话切换时的备用会话
+    std::shared_ptr<PacketSizeController> m_packetSizer;     // 分包时长控制（跨会话保留测量）
+    mutable std::mutex m_sessionMutex_;                       // 保护 m_client 切换与音频扇出
     AsrCallback* m_callback = nullptr;
     std::vector<AsrResult> m_results;
     AsrResult m_latestResult;
@@ -484,6 +595,17 @@ private:
     // 文件路径
     std::string m_statsFilePath_;                             // 统计文件路径
     std::string m_backupFilePath_;                            // 备份文件路径
+
+    // ============================================================================
+    // 识别结果缓存相关成员变量
+    // ============================================================================
+    std::unique_ptr<TranscriptionCache> m_resultCache_;       // 磁盘结果缓存（按需创建）
+    TranscriptionCacheEntry m_fileResult_;                    // 当前文件识别的累计结果
+    size_t m_fileResultBase_ = 0;                             // 续传时保留的定稿分句数
+    int64_t m_fileResultOffsetMs_ = 0;                        // 当前会话在文件时间轴上的起点
+    bool m_fileResultActive_ = false;                         // 是否正在记录文件识别结果
+    std::string m_fileProgressPath_;                          // 续传进度文件路径
+    mutable std::mutex m_fileResultMutex_;                    // 文件识别结果互斥锁
 };
 
 } // namespace Asr 
\ No newline at end of file
@@ -0,0 +1,303 @@
+//
+// 异步执行器与 Future
+//
+// AsrClient 的网络事件都来自 ixwebsocket 的回调线程。同步接口让调用线程睡眠等待响应，
+// 每个会话都要占用一个几乎一直在睡眠的线程。异步接口返回 AsrFuture：网络线程收到响应时
+// 完成它，后续处理投递到 AsyncExecutor 上执行，超时也由执行器的定时器触发，
+// 因此一个执行线程即可驱动大量会话。阻塞接口只是在 Future 上等待，保持兼容。
+//
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Asr {
+
+// ============================================================================
+// 执行器
+// ============================================================================
+
+/**
+ * @brief 任务队列 + 定时器，由固定数量的工作线程执行
+ *
+ * 任务不应阻塞：阻塞的任务会推迟同一执行器上所有会话的后续处理与超时
+ */
+class AsyncExecutor {
+public:
+    using Task = std::function<void()>;
+    using Clock = std::chrono::steady_clock;
+
+    explicit AsyncExecutor(int threads = 1);
+    ~AsyncExecutor();
+
+    AsyncExecutor(const AsyncExecutor&) = delete;
+    AsyncExecutor& operator=(const AsyncExecutor&) = delete;
+
+    /**
+     * @brief 进程内共享的执行器（一个工作线程，AsrClient 默认使用）
+     */
+    static std::shared_ptr<AsyncExecutor> shared();
+
+    void post(Task task);
+
+    /**
+     * @brief delayMs 毫秒后执行（同一时刻到期的任务按投递顺序执行）
+     */
+    void postAfter(int delayMs, Task task);
+
+    /**
+     * @brief 停止工作线程，丢弃未执行的任务与定时器（析构时自动调用）
+     */
+    void shutdown();
+
+    bool isWorkerThread() const;
+    size_t pendingTasks() const;
+    uint64_t executedTasks() const;
+
+private:
+    // 队列与工作线程共享：最后一个引用在工作线程的任务里释放时，该线程分离后仍持有队列
+    struct Queue;
+
+    std::shared_ptr<Queue> m_queue;
+    std::vector<std::thread> m_threads;
+};
+
+// ============================================================================
+// Promise / Future
+// ============================================================================
+
+/**
+ * @brief 异步操作失败的原因（code 使用 asr_client.h 中的错误码）
+ */
+struct AsyncError {
+    uint32_t code = 0;
+    std::string message;
+};
+
+template <typename T>
+class AsrFuture;
+
+namespace detail {
+
+template <typename T>
+struct AsyncState {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool settled = false;
+    bool ok = false;
+    T value{};
+    AsyncError error;
+    std::vector<std::function<void()>> continuations;
+};
+
+} // namespace detail
+
+/**
+ * @brief 异步结果的写入端：resolve / reject 只有第一次生效
+ */
+template <typename T>
+class AsrPromise {
+public:
+    AsrPromise() : m_state(std::make_shared<detail::AsyncState<T>>()) {}
+
+    /**
+     * @brief 读取端；后续处理投递到 executor（为空时在完成的线程上直接执行）
+     */
+    AsrFuture<T> future(std::shared_ptr<AsyncExecutor> executor = nullptr) const {
+        return AsrFuture<T>(m_state, std::move(executor));
+    }
+
+    bool resolve(T value) { return settle(true, std::move(value), AsyncError()); }
+    bool reject(uint32_t code, std::string message) {
+        return settle(false, T{}, AsyncError{code, std::move(message)});
+    }
+
+    bool settled() const {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        return m_state->settled;
+    }
+
+    /**
+     * @brief timeoutMs 毫秒后仍未完成则以 code 失败（<0 表示不设超时）
+     */
+    void expireAfter(AsyncExecutor& executor, int timeoutMs, uint32_t code, std::string message) const {
+        if (timeoutMs < 0) {
+            return;
+        }
+        std::weak_ptr<detail::AsyncState<T>> weak = m_state;
+        executor.postAfter(timeoutMs, [weak, code, message]() {
+            if (auto state = weak.lock()) {
+                AsrPromise(std::move(state)).reject(code, message);
+            }
+        });
+    }
+
+    bool sameAs(const AsrPromise& other) const { return m_state == other.m_state; }
+
+private:
+    explicit AsrPromise(std::shared_ptr<detail::AsyncState<T>> state) : m_state(std::move(state)) {}
+
+    bool settle(bool ok, T value, AsyncError error) {
+        std::vector<std::function<void()>> continuations;
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            if (m_state->settled) {
+                return false;
+            }
+            m_state->settled = true;
+            m_state->ok = ok;
+            m_state->value = std::move(value);
+            m_state->error = std::move(error);
+            continuations.swap(m_state->continuations);
+        }
+        m_state->cv.notify_all();
+        for (auto& continuation : continuations) {
+            continuation();
+        }
+        return true;
+    }
+
+    std::shared_ptr<detail::AsyncState<T>> m_state;
+};
+
+/**
+ * @brief 异步结果的读取端（可复制，所有副本共享同一结果）
+ */
+template <typename T>
+class AsrFuture {
+public:
+    AsrFuture() = default;
+
+    bool valid() const { return m_state != nullptr; }
+
+    bool ready() const {
+        if (!m_state) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        return m_state->settled;
+    }
+
+    /**
+     * @brief 阻塞等待完成
+     * @param timeoutMs <0 表示一直等
+     * @return 是否已完成（成功或失败）
+     */
+    bool wait(int timeoutMs = -1) const {
+        if (!m_state) {
+            return false;
+        }
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        if (timeoutMs < 0) {
+            m_state->cv.wait(lock, [this] { return m_state->settled; });
+            return true;
+        }
+        return m_state->cv.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return m_state->settled; });
+    }
+
+    /**
+     * @brief 已完成且成功
+     */
+    bool ok() const {
+        if (!m_state) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        return m_state->settled && m_state->ok;
+    }
+
+    T value() const {
+        if (!m_state) {
+            return T{};
+        }
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        return m_state->value;
+    }
+
+    AsyncError error() const {
+        if (!m_state) {
+            return AsyncError{0, "invalid future"};
+        }
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        return m_state->error;
+    }
+
+    const std::shared_ptr<AsyncExecutor>& executor() const { return m_executor; }
+
+    /**
+     * @brief 完成后调用 callback（已完成时立即投递）
+     */
+    void then(std::function<void(const AsrFuture<T>&)> callback) const {
+        if (!m_state) {
+            return;
+        }
+        // 回调只弱引用结果：完成前被丢弃的 Future 不会因回调互相引用而泄漏
+        std::weak_ptr<detail::AsyncState<T>> weakState = m_state;
+        std::weak_ptr<AsyncExecutor> weakExecutor = m_executor;
+        const bool bound = m_executor != nullptr;
+        auto run = [weakState, weakExecutor, bound, callback]() {
+            auto state = weakState.lock();
+            if (!state) {
+                return;
+            }
+            AsrFuture<T> self(std::move(state), weakExecutor.lock());
+            if (!bound) {
+                callback(self);
+            } else if (auto executor = self.m_executor) {
+                executor->post([self, callback]() { callback(self); });
+            }
+        };
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            if (!m_state->settled) {
+                m_state->continuations.push_back(std::move(run));
+                return;
+            }
+        }
+        run();
+    }
+
+    /**
+     * @brief 完成后用 step 发起下一步异步操作，返回下一步的结果（串联 连接 → 请求 → 发送）
+     */
+    template <typename U>
+    AsrFuture<U> chain(std::function<AsrFuture<U>(const AsrFuture<T>&)> step) const {
+        AsrPromise<U> next;
+        AsrFuture<U> result = next.future(m_executor);
+        then([next, step](const AsrFuture<T>& self) mutable {
+            AsrFuture<U> inner = step(self);
+            if (!inner.valid()) {
+                next.reject(0, "invalid future");
+                return;
+            }
+            inner.then([next](const AsrFuture<U>& done) mutable {
+                if (done.ok()) {
+                    next.resolve(done.value());
+                } else {
+                    AsyncError error = done.error();
+                    next.reject(error.code, std::move(error.message));
+                }
+            });
+        });
+        return result;
+    }
+
+private:
+    friend class AsrPromise<T>;
+
+    AsrFuture(std::shared_ptr<detail::AsyncState<T>> state, std::shared_ptr<AsyncExecutor> executor)
+        : m_state(std::move(state)), m_executor(std::move(executor)) {}
+
+    std::shared_ptr<detail::AsyncState<T>> m_state;
+    std::shared_ptr<AsyncExecutor> m_executor;
+};
+
+} // namespace Asr
@@ -0,0 +1,157 @@
+//
+// 自适应音频分包时长
+//
+// 每个音频包都有固定开销（协议头、WebSocket / TCP 帧、服务端逐包处理与响应）。
+// 链路好时小包能缩短首个部分结果的等待；丢包的链路上每次重传都会阻塞其后所有在途的包，
+// 包越多，被阻塞的结果越多；带宽或服务端跟不上时逐包开销还会让队列持续增长。
+// 本模块按测得的逐包响应 RTT 与结果延迟，在服务端接受的范围内调整每包音频时长。
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Asr {
+
+/**
+ * @brief 分包时长配置
+ */
+struct PacketSizeConfig {
+    bool adaptive = true;           ///< 关闭时始终使用 initialMs
+    int initialMs = 100;
+    int minMs = 50;                 ///< 服务端建议每包 100~200ms，过小的包逐包开销占比过高
+    int maxMs = 400;
+    int stepMs = 10;                ///< 包时长粒度（16kHz 下 160 个样本）
+    int evaluateEvery = 10;         ///< 每收到 N 个 RTT 样本评估一次
+    bool recordMetrics = true;      ///< 写入 MetricsRegistry（离线仿真时关闭）
+};
+
+/**
+ * @brief 一次包时长调整
+ */
+struct PacketSizeDecision {
+    int64_t atMs = 0;               ///< 相对测量开始的时间
+    int fromMs = 0;
+    int toMs = 0;
+    double srttMs = 0.0;
+    double rttVarMs = 0.0;
+    double resultLatencyMs = 0.0;
+    std::string reason;             ///< loss / queue / stall / latency / fast-link
+};
+
+/**
+ * @brief 分包统计
+ */
+struct PacketSizeStats {
+    bool adaptive = true;
+    int packetMs = 0;               ///< 当前包时长
+    double srttMs = 0.0;            ///< 平滑 RTT（发包 → 对应响应）
+    double rttVarMs = 0.0;
+    double minRttMs = 0.0;          ///< 近期最小 RTT（无排队时的基线）
+    double resultLatencyMs = 0.0;   ///< 平滑结果延迟（发出某段音频 → 收到覆盖它的识别文本）
+    double stallRate = 0.0;         ///< 每个响应出现停顿的概率
+    double stallMs = 0.0;           ///< 停顿时 RTT 超出平滑值的幅度
+    uint64_t packets = 0;
+    uint64_t rttSamples = 0;
+    uint64_t resultSamples = 0;
+    uint64_t losses = 0;            ///< 发送失败 / 响应超时
+    uint64_t stalls = 0;
+    uint64_t changes = 0;
+    std::vector<PacketSizeDecision> history;  ///< 最近的调整（最多 kHistorySize 条）
+};
+
+/**
+ * @brief 按 RTT 与结果延迟调整每包音频时长
+ *
+ * RTT 按 RFC 6298 平滑；超过 srtt + 4·rttvar（即 TCP 的重传超时）的样本记为一次停顿。
+ * 每次停顿阻塞约 stallMs / packetMs 个结果，受影响的比例约为
+ * stallRate·stallMs / packetMs，控制器让它不超过 5%（停顿不进入 p95）：
+ * - 发送失败 / 响应超时：翻倍；
+ * - 平滑 RTT 超过 2 倍基线 + 包时长（带宽或服务端跟不上，队列在增长）：增大 1.5 倍；
+ * - 停顿占比超出预算：增大到满足预算的包时长（每次最多 1.5 倍）；
+ * - 停顿占比明显低于预算：连续两个评估窗口满足后按 stepMs 减小；
+ * - 减小后结果延迟反而上升（服务端逐包开销占主导）：退回原值并暂停减小。
+ *
+ * 时间由调用方传入，便于离线仿真。所有方法线程安全
+ */
+class PacketSizeController {
+public:
+    static constexpr size_t kHistorySize = 32;
+
+    explicit PacketSizeController(const PacketSizeConfig& config = PacketSizeConfig());
+
+    /**
+     * @brief 替换配置并重置状态
+     */
+    void setConfig(const PacketSizeConfig& config);
+    PacketSizeConfig getConfig() const;
+
+    /**
+     * @brief 回到初始包时长，清空测量
+     * @param nowNs 调整记录的时间起点（0 表示取第一个测量样本的时间）
+     */
+    void reset(int64_t nowNs = 0);
+
+    int packetMs() const;
+
+    /**
+     * @brief 当前包时长对应的样本数（单声道）
+     */
+    size_t packetSamples(int sampleRate) const;
+
+    void onPacketSent(int packetMs);
+    void onRtt(int64_t rttNs, int64_t nowNs);
+    void onResultLatency(int64_t latencyNs);
+    void onLoss(int64_t nowNs);
+
+    PacketSizeStats stats() const;
+
+private:
+    void evaluateLocked(int64_t nowNs);
+    void updateMinRttLocked(double rttMs);
+    void applyLocked(int toMs, const char* reason, int64_t nowNs);
+    int clampLocked(double ms) const;
+
+    PacketSizeConfig m_config;
+    int m_packetMs;
+    int64_t m_originNs = 0;
+
+    bool m_hasRtt = false;
+    double m_srttMs = 0.0;
+    double m_rttVarMs = 0.0;
+    double m_minRttMs = 0.0;        // 当前与上一个窗口最小值中的较小者
+    double m_windowMinRttMs = 0.0;
+    double m_prevMinRttMs = 0.0;
+    int m_minRttSamples = 0;
+    double m_stallRate = 0.0;
+    double m_stallMs = 0.0;
+    double m_resultLatencyMs = 0.0;
+    bool m_hasResultLatency = false;
+
+    int m_windowSamples = 0;
+    int m_windowLosses = 0;
+    int m_goodWindows = 0;
+    int m_holdWindows = 0;          // 退回后暂停减小的窗口数
+
+    // 最近一次减小前的状态，用于判断减小是否让结果延迟变差
+    bool m_probing = false;
+    int m_probeFromMs = 0;
+    double m_probeLatencyMs = 0.0;
+    uint64_t m_probeResultSamples = 0;
+
+    uint64_t m_packets = 0;
+    uint64_t m_rttSamples = 0;
+    uint64_t m_resultSamples = 0;
+    uint64_t m_losses = 0;
+    uint64_t m_stalls = 0;
+    uint64_t m_changes = 0;
+    std::deque<PacketSizeDecision> m_history;
+    mutable std::mutex m_mutex;
+};
+
+} // namespace Asr
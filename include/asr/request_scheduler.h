@@ -0,0 +1,231 @@
+//
+// 进程级 ASR 请求调度
+//
+// 服务端按账户限制并发会话数、建连频率与识别时长配额。会话多时各自重试会同时撞上限制，
+// 全部失败。本模块在进程内统一发放会话许可与音频额度：
+// - 三个令牌桶：并发会话、每秒建连次数、每分钟音频秒数；
+// - 三个优先级：实时 > 交互式文件识别 > 批量积压，低优先级不能占用为高优先级预留的容量；
+// - 服务端返回限流 / 配额 / 繁忙错误时收紧对应的限制，并对非实时请求做带抖动的退避，
+//   一段时间内没有再出错则逐步恢复。
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <string>
+
+namespace Asr {
+
+/**
+ * @brief 请求优先级（数值越小越优先）
+ */
+enum class RequestPriority {
+    LIVE = 0,           // 实时识别 / 字幕：会话与音频额度不会被其他类别占满
+    INTERACTIVE = 1,    // 用户等待结果的文件识别
+    BATCH = 2           // 批量积压，只使用剩余容量
+};
+
+constexpr int kRequestPriorityCount = 3;
+
+const char* requestPriorityName(RequestPriority priority);
+bool parseRequestPriority(const std::string& name, RequestPriority& priority);
+
+/**
+ * @brief 调度限制（0 表示不限制）
+ */
+struct SchedulerLimits {
+    int maxSessions = 8;                    // 并发会话数
+    double connectsPerSecond = 2.0;         // 建连速率
+    int connectBurst = 4;                   // 建连突发上限
+    double audioSecondsPerMinute = 0.0;     // 音频时长配额（每分钟可发送的音频秒数）
+    int liveReservedSessions = 1;           // 非实时请求不能占用的会话数
+    int interactiveReservedSessions = 1;    // 批量请求额外不能占用的会话数
+    double liveReservedAudio = 0.2;         // 非实时请求不能用掉的音频额度比例
+    double interactiveReservedAudio = 0.2;  // 批量请求额外不能用掉的比例
+    uint32_t backoffMinMs = 1000;           // 限流错误后的退避（按连续错误次数指数增长，带抖动）
+    uint32_t backoffMaxMs = 60000;
+    uint32_t recoveryMs = 30000;            // 无限流错误多久后恢复一半被收紧的限制
+};
+
+/**
+ * @brief 调度统计
+ */
+struct SchedulerStats {
+    struct PerPriority {
+        int active = 0;             // 持有的会话许可
+        int waiting = 0;            // 正在等待会话许可或音频额度
+        uint64_t granted = 0;       // 发放的会话许可
+        uint64_t timeouts = 0;      // 等待超时或被取消
+        double waitMsMax = 0.0;     // 最长等待
+        double waitMsTotal = 0.0;
+        double audioSeconds = 0.0;  // 已计入的音频时长
+    };
+    std::array<PerPriority, kRequestPriorityCount> priorities;
+    SchedulerLimits limits;             // 配置的限制
+    double sessionLimit = 0.0;          // 按服务端反馈收紧后的有效限制
+    double connectsPerSecond = 0.0;
+    double audioSecondsPerMinute = 0.0;
+    double audioTokens = 0.0;           // 音频桶余量（秒），实时请求透支时为负
+    int64_t backoffRemainingMs = 0;
+    uint64_t rateLimited = 0;
+    uint64_t quotaExceeded = 0;
+    uint64_t serverBusy = 0;
+};
+
+class RequestScheduler;
+
+/**
+ * @brief 会话许可：析构或 release() 时归还
+ */
+class SessionLease {
+public:
+    SessionLease() = default;
+    ~SessionLease();
+
+    SessionLease(SessionLease&& other) noexcept;
+    SessionLease& operator=(SessionLease&& other) noexcept;
+    SessionLease(const SessionLease&) = delete;
+    SessionLease& operator=(const SessionLease&) = delete;
+
+    bool valid() const { return m_scheduler != nullptr; }
+    RequestPriority priority() const { return m_priority; }
+    void release();
+
+private:
+    friend class RequestScheduler;
+    SessionLease(RequestScheduler* scheduler, RequestPriority priority)
+        : m_scheduler(scheduler), m_priority(priority) {}
+
+    RequestScheduler* m_scheduler = nullptr;
+    RequestPriority m_priority = RequestPriority::INTERACTIVE;
+};
+
+/**
+ * @brief 进程级请求调度器
+ *
+ * 等待者按优先级、同优先级按到达顺序排队；只要有更高优先级的请求在等，
+ * 低优先级请求就不会拿到许可。实时请求不受退避限制，音频额度不足时允许透支
+ * （透支部分由之后的非实时请求偿还），因此批量任务不会让实时字幕停下来
+ */
+class RequestScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief 进程内共享的实例（首次调用时按环境变量初始化限制）
+     */
+    static RequestScheduler& instance();
+
+    /**
+     * @brief 环境变量：PERFX_ASR_MAX_SESSIONS、PERFX_ASR_CONNECTS_PER_SEC、PERFX_ASR_AUDIO_SEC_PER_MIN
+     */
+    static SchedulerLimits limitsFromEnv();
+
+    /**
+     * @brief 服务端的限流 / 配额 / 繁忙错误（调度器会对其做出反应）
+     */
+    static bool isLimitError(uint32_t code);
+
+    explicit RequestScheduler(const SchedulerLimits& limits = SchedulerLimits());
+
+    RequestScheduler(const RequestScheduler&) = delete;
+    RequestScheduler& operator=(const RequestScheduler&) = delete;
+
+    /**
+     * @brief 替换限制并撤销所有按反馈做的收紧
+     */
+    void setLimits(const SchedulerLimits& limits);
+    SchedulerLimits getLimits() const;
+
+    /**
+     * @brief 获取一个会话许可并消耗一个建连令牌
+     * @param timeoutMs 最长等待（<0 表示一直等）
+     * @param cancel 置位时放弃等待
+     * @return 超时或取消时返回无效的许可
+     */
+    SessionLease acquireSession(RequestPriority priority, int timeoutMs = -1,
+                                const std::atomic<bool>* cancel = nullptr);
+
+    /**
+     * @brief 发送音频前扣除额度；实时请求立即返回（允许透支），其余请求等待额度
+     * @return 超时或取消时返回 false
+     */
+    bool acquireAudio(RequestPriority priority, double seconds, int timeoutMs = -1,
+                      const std::atomic<bool>* cancel = nullptr);
+
+    /**
+     * @brief 服务端错误反馈
+     *
+     * - 限流：建连速率减半；
+     * - 配额超限：音频额度减半（未配置时按最近一分钟的用量减半）；
+     * - 繁忙：并发会话上限降到当前会话数减一。
+     * 三者都会让非实时请求退避
+     */
+    void reportError(uint32_t code);
+
+    /**
+     * @brief 会话成功建立，清零连续错误计数
+     */
+    void reportSuccess();
+
+    /**
+     * @brief 第 attempt 次（从 0 开始）重试前的等待：指数增长、随机抖动，且不短于当前退避
+     */
+    uint32_t retryDelayMs(uint32_t attempt);
+
+    SchedulerStats stats() const;
+
+private:
+    friend class SessionLease;
+
+    struct TokenBucket {
+        double tokens = 0.0;
+        double rate = 0.0;          // 每秒补充
+        double capacity = 0.0;
+        Clock::time_point last;
+
+        void refill(Clock::time_point now);
+    };
+
+    void releaseSession(RequestPriority priority);
+    void resetLocked(Clock::time_point now);
+    void refillLocked(Clock::time_point now);
+    bool isFrontLocked(RequestPriority priority, uint64_t ticket) const;
+    bool canStartSessionLocked(RequestPriority priority, Clock::time_point now) const;
+    bool canSendAudioLocked(RequestPriority priority, double seconds, Clock::time_point now) const;
+    Clock::time_point nextWakeLocked(Clock::time_point now) const;
+    uint32_t backoffMsLocked(uint32_t attempt);
+    void recordWaitLocked(RequestPriority priority, Clock::time_point begin, bool granted);
+
+    SchedulerLimits m_limits;
+    double m_sessionLimit = 0.0;
+    TokenBucket m_connects;
+    TokenBucket m_audio;
+    std::array<int, kRequestPriorityCount> m_active{};
+    std::array<std::deque<uint64_t>, kRequestPriorityCount> m_waiters;        // 等待会话许可
+    std::array<std::deque<uint64_t>, kRequestPriorityCount> m_audioWaiters;   // 等待音频额度
+    uint64_t m_nextTicket = 0;
+
+    // 最近一分钟的音频用量（配额超限且未配置额度时据此设定额度）
+    double m_usageSeconds = 0.0;
+    Clock::time_point m_usageStart;
+
+    Clock::time_point m_backoffUntil;
+    Clock::time_point m_lastLimitError;
+    Clock::time_point m_lastRecovery;
+    uint32_t m_consecutiveErrors = 0;
+    std::mt19937 m_rng;
+
+    SchedulerStats m_stats;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+};
+
+} // namespace Asr
@@ -0,0 +1,240 @@
+//
+// ASR 会话抓包与回放
+//
+// 录制 AsrClient 收发的每一个 WebSocket 帧（单调时钟时间戳）到紧凑的会话抓包文件，
+// 之后无需连接云端即可按原始节奏（或加速 / 不等待）重现会话：
+//   - 注入回放：服务端帧直接交给 AsrClient 的消息处理，覆盖 parseBinaryResponse、
+//     分句处理与回调（界面更新）路径，用于确定性的回归与性能测试
+//   - 模拟服务端：在本地端口扮演 ASR 服务端，按抓包回应真实客户端
+//     （客户端把 cluster 指向 ws://127.0.0.1:<port>）
+//   - 客户端回放：按抓包节奏把客户端帧发给服务端（通常是模拟服务端），测量响应时序
+//
+// 文件格式（变长整数为无符号 LEB128）：
+//   文件头：魔数 "PXAC"，版本（1 字节），元数据长度（varint），元数据（JSON，不含凭据）
+//   帧记录：方向（1 字节），距上一帧的微秒数（varint），负载长度（varint），负载
+// 音频包占绝大部分体积，原样保存；录制中断时最后一条记录可能不完整，读取时丢弃并标记。
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Asr {
+
+class AsrClient;
+
+/**
+ * @brief 抓包帧方向 / 事件类型
+ */
+enum class CaptureDirection : uint8_t {
+    ClientBinary = 0,   ///< 客户端 → 服务端二进制帧（完整请求 / 音频包）
+    ServerBinary = 1,   ///< 服务端 → 客户端二进制帧
+    ServerText = 2,     ///< 服务端 → 客户端文本帧
+    Open = 3,           ///< 连接建立，负载为响应头 JSON 对象
+    Close = 4,          ///< 连接关闭，负载为 {"code":N,"reason":"..."}
+    Error = 5           ///< 连接错误，负载为错误原因
+};
+
+/**
+ * @brief 方向名称（client / server / text / open / close / error）
+ */
+const char* captureDirectionName(CaptureDirection direction);
+
+/**
+ * @brief 该帧是否由服务端一侧产生（回放服务端时需要重现）
+ */
+bool isServerSide(CaptureDirection direction);
+
+/**
+ * @brief 抓包帧
+ */
+struct CaptureFrame {
+    int64_t timeUs = 0;                 ///< 距录制开始的微秒数（单调时钟）
+    CaptureDirection direction = CaptureDirection::ClientBinary;
+    std::string payload;
+};
+
+// ============================================================================
+// 录制
+// ============================================================================
+
+/**
+ * @brief 会话录制器
+ *
+ * record() 线程安全：发送在识别线程、接收在 WebSocket 线程。文件在第一帧到来时才创建，
+ * 创建后未发生连接的客户端不会留下空文件。写入经 stdio 缓冲，连接关闭 / 出错时刷新
+ */
+class SessionRecorder {
+public:
+    SessionRecorder() = default;
+    ~SessionRecorder();
+
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+    /**
+     * @brief 设置输出路径与元数据（不创建文件）
+     * @param metadata 写入文件头的 JSON 文本
+     */
+    void open(const std::string& path, const std::string& metadata);
+
+    /**
+     * @brief 追加一帧，时间戳取调用时刻
+     */
+    void record(CaptureDirection direction, const void* data, size_t size);
+    void record(CaptureDirection direction, const std::string& payload);
+
+    /**
+     * @brief 刷新并关闭文件，之后的 record() 被忽略
+     */
+    void close();
+
+    const std::string& getPath() const { return m_path; }
+    uint64_t getFrameCount() const;
+
+    /**
+     * @brief 创建或写入文件失败时的错误信息
+     */
+    std::string getLastError() const;
+
+private:
+    bool ensureFileLocked();
+
+    mutable std::mutex m_mutex;
+    std::string m_path;
+    std::string m_metadata;
+    std::FILE* m_file = nullptr;
+    bool m_closed = false;
+    int64_t m_startNs = 0;
+    int64_t m_lastUs = 0;
+    uint64_t m_frames = 0;
+    std::string m_lastError;
+};
+
+// ============================================================================
+// 读取
+// ============================================================================
+
+/**
+ * @brief 已加载的会话抓包
+ */
+class SessionCapture {
+public:
+    bool load(const std::string& path, std::string& error);
+
+    /**
+     * @brief 从内存解析（文件内容）
+     */
+    bool parse(const std::string& data, std::string& error);
+
+    const std::string& getMetadata() const { return m_metadata; }
+    const std::vector<CaptureFrame>& getFrames() const { return m_frames; }
+
+    /**
+     * @brief 最后一帧的时间戳
+     */
+    int64_t getDurationUs() const;
+
+    /**
+     * @brief 末尾有不完整的记录（录制被中断）
+     */
+    bool isTruncated() const { return m_truncated; }
+
+    size_t countFrames(CaptureDirection direction) const;
+
+private:
+    std::string m_metadata;
+    std::vector<CaptureFrame> m_frames;
+    bool m_truncated = false;
+};
+
+// ============================================================================
+// 回放
+// ============================================================================
+
+/**
+ * @brief 回放选项
+ */
+struct ReplayOptions {
+    double speed = 1.0;                 ///< 时间缩放：2 表示两倍速；0 表示不等待，尽快回放
+    int clientWaitTimeoutMs = 5000;     ///< 模拟服务端等待对应客户端帧的超时，超时后照常发送
+};
+
+/**
+ * @brief 回放统计
+ */
+struct ReplayStats {
+    uint64_t serverFrames = 0;          ///< 交付 / 发出的服务端帧数
+    uint64_t clientFrames = 0;          ///< 注入回放：跳过的客户端帧数；其他模式：发出 / 收到的客户端帧数
+    uint64_t bytes = 0;                 ///< 服务端帧负载字节数
+    int64_t captureDurationUs = 0;      ///< 抓包原始时长
+    int64_t elapsedUs = 0;              ///< 回放实际耗时
+    int64_t maxLagUs = 0;               ///< 实际交付落后于计划时间的最大值（不等待模式下不统计）
+    uint64_t gateTimeouts = 0;          ///< 模拟服务端：等待客户端帧超时的次数
+
+    /**
+     * 注入回放：每个服务端帧在 AsrClient 中的处理耗时（含回调）；
+     * 客户端回放：每个服务端帧距其之前最后一个客户端帧发出的响应时延
+     */
+    std::vector<int64_t> latencyUs;
+};
+
+/**
+ * @brief 注入回放：把抓包中的服务端帧按时序交给 client 处理，客户端帧跳过
+ *
+ * client 无需连接；回调在调用线程中执行
+ * @param stop 非空时每帧检查，置位后提前结束
+ */
+void replayIntoClient(const SessionCapture& capture, AsrClient& client, const ReplayOptions& options,
+                      ReplayStats& stats, const std::atomic<bool>* stop = nullptr);
+
+/**
+ * @brief 客户端回放：连接 url，按抓包时序发送客户端帧并接收服务端帧
+ *
+ * 只重现第一个连接段；抓包不含凭据，不能直接用于云端服务
+ * @return 连接失败时返回 false
+ */
+bool replayClientSide(const SessionCapture& capture, const std::string& url, const ReplayOptions& options,
+                      ReplayStats& stats, std::string& error, const std::atomic<bool>* stop = nullptr);
+
+/**
+ * @brief 模拟 ASR 服务端
+ *
+ * 抓包按 Open 事件切分为连接段，第 N 个接入的连接回放第 N 段（循环使用）。
+ * 每个服务端帧在客户端发来抓包中先于它的全部客户端帧之后才发送，
+ * 与最后一个客户端帧的间隔按原始间隔缩放，从而重现服务端的响应节奏
+ */
+class SessionMockServer {
+public:
+    SessionMockServer(const SessionCapture& capture, const ReplayOptions& options);
+    ~SessionMockServer();
+
+    SessionMockServer(const SessionMockServer&) = delete;
+    SessionMockServer& operator=(const SessionMockServer&) = delete;
+
+    bool start(const std::string& host, int port, std::string& error);
+    void stop();
+
+    /**
+     * @brief 已完成回放的连接数
+     */
+    uint64_t getSessionsServed() const;
+
+    /**
+     * @brief 全部连接的累计统计（latencyUs 不统计）
+     */
+    ReplayStats getStats() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace Asr
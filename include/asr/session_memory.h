@@ -0,0 +1,248 @@
+//
+// 会话内存：协议帧缓冲池与复用的压缩 / 解压状态
+//
+// 每个会话持续地编码音频包、解码响应。原实现每个包都要新建头部、压缩结果与整帧三个
+// 缓冲区，并初始化一次 zlib 压缩流（deflateInit 每次分配约 256KB 的窗口与哈希表）；
+// 每个响应复制两次 payload、解压到新字符串，再把 JSON 解析两遍。
+// SessionMemory 由 AsrClient 持有，会话期间复用这些内存：
+// - 定长缓冲池：协议帧从池中取块直接编码，发送后归还；
+// - zlib 压缩 / 解压流只初始化一次，之后用 reset 复用；
+// - 解压后的响应写入暂存区，容量保留给下一个响应；
+// - 在途记录使用固定容量的环形队列。
+// 会话结束（disconnect）时整体释放。稳态下音频路径不再分配，响应路径只剩
+// 每个响应一棵 JSON 树（大小取决于响应本身）。
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <zlib.h>
+
+namespace Asr {
+
+// ============================================================================
+// 固定容量环形队列
+// ============================================================================
+
+/**
+ * @brief 先进先出队列，满时丢弃最早的元素
+ *
+ * 存储在第一次写入时按容量一次分配，之后不再分配；clear() 只重置元素、保留存储
+ */
+template <typename T>
+class RingQueue {
+public:
+    explicit RingQueue(size_t capacity) : m_capacity(capacity > 0 ? capacity : 1) {}
+
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+
+    /**
+     * @brief 追加到队尾；队列已满时先移出最早的元素写入 evicted
+     * @return 是否移出了元素
+     */
+    bool push_back(T value, T* evicted = nullptr) {
+        if (m_items.empty()) {
+            m_items.resize(m_capacity);
+        }
+        bool dropped = false;
+        if (m_size == m_capacity) {
+            T oldest = take_front();
+            if (evicted) {
+                *evicted = std::move(oldest);
+            }
+            dropped = true;
+        }
+        m_items[index(m_size)] = std::move(value);
+        ++m_size;
+        return dropped;
+    }
+
+    T& front() { return m_items[m_head]; }
+    const T& front() const { return m_items[m_head]; }
+
+    /**
+     * @brief 第 i 个元素（0 为队首）
+     */
+    T& operator[](size_t i) { return m_items[index(i)]; }
+    const T& operator[](size_t i) const { return m_items[index(i)]; }
+
+    T take_front() {
+        T value = std::move(m_items[m_head]);
+        m_items[m_head] = T();
+        m_head = (m_head + 1) % m_capacity;
+        --m_size;
+        return value;
+    }
+
+    void pop_front() { take_front(); }
+
+    /**
+     * @brief 移除第 i 个元素，之后的元素前移
+     */
+    void erase(size_t i) {
+        for (size_t k = i; k + 1 < m_size; ++k) {
+            m_items[index(k)] = std::move(m_items[index(k + 1)]);
+        }
+        m_items[index(m_size - 1)] = T();
+        --m_size;
+    }
+
+    void clear() {
+        while (m_size > 0) {
+            pop_front();
+        }
+        m_head = 0;
+    }
+
+private:
+    size_t index(size_t i) const { return (m_head + i) % m_capacity; }
+
+    std::vector<T> m_items;
+    size_t m_capacity;
+    size_t m_head = 0;
+    size_t m_size = 0;
+};
+
+// ============================================================================
+// 定长缓冲池
+// ============================================================================
+
+/**
+ * @brief 字节缓冲池：所有块容量相同，取出的缓冲区长度为 0
+ *
+ * 请求超过块大小时块大小翻倍到足够容纳，旧的空闲块随之丢弃（会话开始的几个包后稳定）。
+ * 线程安全
+ */
+class BufferPool {
+public:
+    explicit BufferPool(size_t maxFree = 8);
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * @brief 取一个容量不小于 bytes 的缓冲区
+     */
+    std::vector<uint8_t> acquire(size_t bytes, bool* allocated = nullptr);
+
+    /**
+     * @brief 归还缓冲区（容量小于当前块大小或空闲块已满时直接释放）
+     */
+    void recycle(std::vector<uint8_t> buffer);
+
+    /**
+     * @brief 释放所有空闲块
+     */
+    void clear();
+
+    size_t blockSize() const;
+    size_t freeBytes() const;
+    uint64_t hits() const;
+    uint64_t allocations() const;
+
+private:
+    mutable std::mutex m_mutex;
+    size_t m_maxFree;
+    size_t m_blockSize = 0;
+    std::vector<std::vector<uint8_t>> m_free;
+    uint64_t m_hits = 0;
+    uint64_t m_allocations = 0;
+};
+
+// ============================================================================
+// 会话内存
+// ============================================================================
+
+/**
+ * @brief 会话内存统计（计数跨会话累计）
+ */
+struct SessionMemoryStats {
+    uint64_t framesEncoded = 0;     // 编码的协议帧（完整请求与音频包）
+    uint64_t responsesDecoded = 0;  // 解压的响应
+    uint64_t poolHits = 0;          // 从池中取到空闲块
+    uint64_t poolAllocations = 0;   // 池中无空闲块时新分配的块
+    uint64_t scratchGrowths = 0;    // 响应暂存区扩容
+    uint64_t codecInits = 0;        // zlib 流初始化（之后用 reset 复用）
+    uint64_t releases = 0;          // 会话结束时的整体释放
+    size_t blockSize = 0;           // 当前帧缓冲块大小
+    size_t retainedBytes = 0;       // 池与暂存区当前持有的容量
+
+    /**
+     * @brief 本模块负责的全部堆分配次数（稳态下不再增长）
+     */
+    uint64_t allocations() const { return poolAllocations + scratchGrowths + codecInits; }
+};
+
+/**
+ * @brief 单个会话的协议编解码内存
+ *
+ * 编码与解码各有一把锁：发送线程编码、网络线程解码互不阻塞
+ */
+class SessionMemory {
+public:
+    SessionMemory();
+    ~SessionMemory();
+
+    SessionMemory(const SessionMemory&) = delete;
+    SessionMemory& operator=(const SessionMemory&) = delete;
+
+    /**
+     * @brief 编码一帧：Header(4) + 序列号(4，大端) + Payload Size(4，大端) + Gzip(payload)
+     * @return 池中的缓冲区，发送后用 recycle() 归还；压缩失败时为空
+     */
+    std::vector<uint8_t> encodeFrame(const std::array<uint8_t, 4>& header, int32_t sequence,
+                                     const void* payload, size_t size);
+
+    void recycle(std::vector<uint8_t> frame);
+
+    /**
+     * @brief Gzip 解压到 out（覆盖原内容，复用其容量）
+     * @return 解压出错时返回 false；输入不完整时保留已解压的部分
+     */
+    bool decompress(const char* data, size_t size, std::string& out);
+
+    /**
+     * @brief 取出 / 归还响应暂存区（容量保留到下一个响应）
+     *
+     * 暂存区在处理期间由调用方持有，回调里断开会话也不会释放正在使用的内存
+     */
+    std::string takeText();
+    void returnText(std::string text);
+
+    /**
+     * @brief 会话结束：释放缓冲池、暂存区与 zlib 流
+     */
+    void release();
+
+    SessionMemoryStats stats() const;
+
+private:
+    void countAllocation();
+
+    BufferPool m_frames;
+
+    mutable std::mutex m_encodeMutex;
+    z_stream m_deflate{};
+    bool m_deflateReady = false;
+    uint64_t m_framesEncoded = 0;
+    uint64_t m_deflateInits = 0;
+
+    mutable std::mutex m_decodeMutex;
+    z_stream m_inflate{};
+    bool m_inflateReady = false;
+    std::string m_text;
+    uint64_t m_responsesDecoded = 0;
+    uint64_t m_inflateInits = 0;
+    uint64_t m_scratchGrowths = 0;
+    uint64_t m_releases = 0;
+};
+
+} // namespace Asr
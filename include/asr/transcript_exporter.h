@@ -0,0 +1,195 @@
+//
+// 转录结果导出
+//
+// 把分句结果流式写出为 JSON / SRT / WebVTT / LRC。导出器逐句接收结果，经固定大小的
+// 缓冲直接写到文件（或字符串），内存占用与转录长度无关；文件先写到临时文件，
+// 完成后再替换目标文件，中途失败不会留下半截文件。
+//
+// 主要功能：
+// - JSON 字符串按规范转义（引号、反斜杠、控制字符，非法 UTF-8 替换为 U+FFFD），整数用 to_chars 格式化
+// - SRT / WebVTT 按显示宽度断行（全角字符计 2 列），超出行数或时长时拆分为多条字幕
+// - 拆分后的字幕时间优先按词级时间对齐，没有词级结果时按字数比例估算
+// - 开启词级时间时输出 JSON words、WebVTT 时间标签、增强 LRC（服务端返回了词级结果时）
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "asr/transcription_cache.h"
+
+namespace Asr {
+
+/**
+ * @brief 导出格式
+ */
+enum class ExportFormat {
+    Json,
+    Srt,
+    WebVtt,
+    Lrc
+};
+
+/**
+ * @brief 按名称或扩展名解析导出格式（json / srt / vtt / webvtt / lrc，可带前导点，不区分大小写）
+ */
+bool exportFormatFromName(const std::string& name, ExportFormat& format);
+
+/**
+ * @brief 导出格式的文件扩展名（不含点）
+ */
+const char* exportFormatExtension(ExportFormat format);
+
+/**
+ * @brief 导出选项
+ */
+struct ExportOptions {
+    bool wordTimestamps = false;    ///< 输出词级时间（分句带 words 时），通常由 exportOptionsFromConfig 按请求配置设置
+    int maxLineWidth = 42;          ///< 字幕单行最大显示宽度（列，全角字符计 2）
+    int maxLines = 2;               ///< 每条字幕最多行数
+    int64_t maxCueMs = 7000;        ///< 单条字幕最长时长，超出时拆分
+    std::string title;              ///< LRC [ti:] 标签，空时不输出
+};
+
+/**
+ * @brief 按产生结果的 ASR 请求配置生成导出选项：词级时间跟随 enableWordTimeOffset
+ */
+ExportOptions exportOptionsFromConfig(const AsrApiConfig& config);
+
+// ============================================================================
+// 输出
+// ============================================================================
+
+/**
+ * @brief 导出目标
+ */
+class ExportSink {
+public:
+    virtual ~ExportSink() = default;
+    virtual bool write(const char* data, size_t size) = 0;
+};
+
+/**
+ * @brief 写入字符串
+ */
+class StringSink : public ExportSink {
+public:
+    explicit StringSink(std::string& output) : m_output(output) {}
+    bool write(const char* data, size_t size) override;
+
+private:
+    std::string& m_output;
+};
+
+/**
+ * @brief 写入文件：先写 <path>.tmp，commit() 成功后替换目标文件
+ */
+class FileSink : public ExportSink {
+public:
+    FileSink() = default;
+    ~FileSink() override;
+
+    FileSink(const FileSink&) = delete;
+    FileSink& operator=(const FileSink&) = delete;
+
+    bool open(const std::string& path, std::string& error);
+    bool write(const char* data, size_t size) override;
+
+    /**
+     * @brief 关闭临时文件并替换目标文件
+     */
+    bool commit(std::string& error);
+
+    /**
+     * @brief 放弃写入，删除临时文件
+     */
+    void discard();
+
+private:
+    std::FILE* m_file = nullptr;
+    std::string m_path;
+    std::string m_tempPath;
+    bool m_failed = false;
+};
+
+/**
+ * @brief 固定大小缓冲的文本写入器
+ */
+class ExportWriter {
+public:
+    static constexpr size_t kBufferSize = 64 * 1024;
+
+    explicit ExportWriter(ExportSink& sink);
+    ~ExportWriter();
+
+    ExportWriter(const ExportWriter&) = delete;
+    ExportWriter& operator=(const ExportWriter&) = delete;
+
+    void write(const char* data, size_t size);
+    void write(const std::string& text) { write(text.data(), text.size()); }
+    void put(char c) {
+        if (m_size == kBufferSize) {
+            flush();
+        }
+        m_buffer[m_size++] = c;
+    }
+
+    void writeInt(int64_t value);
+
+    /**
+     * @brief 写出带引号的 JSON 字符串（UTF-8 原样输出，只转义必须转义的字符）
+     */
+    void writeJsonString(const char* data, size_t size);
+    void writeJsonString(const std::string& text) { writeJsonString(text.data(), text.size()); }
+
+    /**
+     * @brief 写出缓冲中的数据
+     * @return 目前为止全部写入成功
+     */
+    bool flush();
+
+    bool failed() const { return m_failed; }
+
+private:
+    ExportSink& m_sink;
+    std::unique_ptr<char[]> m_buffer;
+    size_t m_size = 0;
+    bool m_failed = false;
+};
+
+// ============================================================================
+// 导出器
+// ============================================================================
+
+/**
+ * @brief 流式转录导出器：begin() → add() × N → finish()
+ */
+class TranscriptExporter {
+public:
+    static std::unique_ptr<TranscriptExporter> create(ExportFormat format, ExportWriter& writer,
+                                                      const ExportOptions& options = ExportOptions());
+
+    virtual ~TranscriptExporter() = default;
+
+    virtual void begin() = 0;
+    virtual void add(const CachedUtterance& utterance) = 0;
+    virtual void finish() = 0;
+};
+
+/**
+ * @brief 导出完整结果到文件
+ */
+bool exportTranscript(const std::vector<CachedUtterance>& utterances, ExportFormat format,
+                      const std::string& filePath, const ExportOptions& options, std::string& error);
+
+/**
+ * @brief 导出完整结果为字符串
+ */
+std::string exportTranscriptToString(const std::vector<CachedUtterance>& utterances, ExportFormat format,
+                                     const ExportOptions& options = ExportOptions());
+
+} // namespace Asr
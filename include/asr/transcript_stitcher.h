@@ -0,0 +1,98 @@
+//
+// 多会话转录拼接
+//
+// 实时转录按“先建后断”切换 ASR 会话：新会话提前建立，重叠窗口内同一段音频
+// 同时发往新旧两个会话，旧会话定稿后关闭。本模块把各会话的结果平移到统一的
+// 发送时间线上，并在分句时间边界处拼接，保证切换前后既不丢句也不重复。
+//
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "asr/transcription_cache.h"
+
+namespace Asr {
+
+/**
+ * @brief 实时会话结果拼接器
+ *
+ * 会话以不透明指针标识（通常是 AsrClient*）。时间均为发送时间线上的毫秒数，
+ * 即从启用实时识别起累计发送的音频时长。
+ *
+ * 拼接规则：旧会话关闭时，结束时间早于其最后一个包（留出 guardMs 余量）的分句，
+ * 以及起点早于新会话起点、新会话无法完整覆盖的分句，作为定稿结果提交；
+ * 之后只采用新会话中起点不早于最后提交分句结束时间的分句。
+ * 重叠期间新会话的结果暂不输出。所有方法线程安全
+ */
+class TranscriptStitcher {
+public:
+    explicit TranscriptStitcher(int64_t guardMs = 300, int64_t toleranceMs = 200);
+
+    void reset();
+
+    /**
+     * @brief 登记新会话
+     * @param startMs 该会话第一个音频包在发送时间线上的位置
+     */
+    void beginSession(const void* session, int64_t startMs);
+
+    /**
+     * @brief 会话不再接收音频
+     * @param endMs 最后一个音频包结束时在发送时间线上的位置
+     */
+    void endSession(const void* session, int64_t endMs);
+
+    /**
+     * @brief 用服务端消息更新会话的当前结果（result_type=full，每条消息包含会话内全部分句）
+     * @return 会话已登记且消息包含分句时返回 true
+     */
+    bool update(const void* session, const std::string& message);
+
+    /**
+     * @brief 关闭会话（已定稿或放弃等待），按拼接规则提交其结果并移除
+     */
+    void closeSession(const void* session);
+
+    /**
+     * @brief 会话的最新分句（已平移到发送时间线，未登记时为空）
+     */
+    std::vector<CachedUtterance> sessionUtterances(const void* session) const;
+
+    /**
+     * @brief 拼接后的完整结果：已提交分句 + 最早的活动会话中尚未提交的分句
+     */
+    std::vector<CachedUtterance> merged() const;
+
+    /**
+     * @brief 同 merged()，并在同一快照中给出已稳定的时间点
+     * @param settledMs 输出：起点早于此时间的分句都已定稿，之后在 merged() 中的位置与内容不再变化；
+     *                  此时间之前的音频也不会再产生新的分句
+     */
+    std::vector<CachedUtterance> merged(int64_t& settledMs) const;
+
+private:
+    struct Session {
+        const void* id = nullptr;
+        int64_t startMs = 0;
+        int64_t endMs = -1;                       // -1 表示仍在接收音频
+        std::vector<CachedUtterance> utterances;  // 已平移到发送时间线
+    };
+
+    Session* findLocked(const void* session);
+    const Session* findLocked(const void* session) const;
+    std::vector<CachedUtterance> mergedLocked() const;
+    int64_t settledLocked() const;
+
+    const int64_t m_guardMs;
+    const int64_t m_toleranceMs;
+    std::vector<CachedUtterance> m_committed;
+    int64_t m_cutMs = 0;                          // 已提交分句的最晚结束时间
+    std::deque<Session> m_sessions;               // 按建立顺序，front 为最早的会话
+    mutable std::mutex m_mutex;
+};
+
+} // namespace Asr
@@ -0,0 +1,170 @@
+//
+// 识别结果持久化缓存
+//
+// 以“PCM 数据哈希 + 影响识别结果的 AsrApiConfig 字段”为键，把文件识别得到的
+// 分句 / 词级结果保存到磁盘。同一文件在相同参数下再次识别时直接返回缓存结果，
+// 不再按实时速率重新上传音频、消耗服务时长。
+//
+// 主要功能：
+// - 内容寻址的缓存键（XXH64）
+// - 每个条目带校验和，读取时校验，损坏条目自动删除
+// - 按最近访问时间淘汰（LRU），总大小不超过上限
+// - 未完成的识别保存已确认的包序号，下次从最后一个定稿分句处续传
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "asr/asr_client.h"
+
+namespace Asr {
+
+// ============================================================================
+// 缓存数据结构
+// ============================================================================
+
+/**
+ * @brief 词级识别结果
+ */
+struct CachedWord {
+    std::string text;       // 词文本
+    int64_t startMs = 0;    // 起始时间（毫秒，相对文件开头）
+    int64_t endMs = 0;      // 结束时间（毫秒，相对文件开头）
+};
+
+/**
+ * @brief 分句识别结果
+ */
+struct CachedUtterance {
+    std::string text;                 // 分句文本
+    int64_t startMs = 0;              // 起始时间（毫秒，相对文件开头）
+    int64_t endMs = 0;                // 结束时间（毫秒，相对文件开头）
+    bool definite = false;            // 是否已定稿
+    std::vector<CachedWord> words;    // 词级结果（服务端未返回时为空）
+    std::string speaker;              // 说话人 / 声道标签（多声道实时识别时非空）
+};
+
+/**
+ * @brief 单个文件的缓存条目
+ */
+struct TranscriptionCacheEntry {
+    std::string key;                          // 缓存键
+    std::string sourcePath;                   // 源文件路径（仅供查看）
+    size_t totalPackets = 0;                  // 音频总包数
+    size_t ackedPackets = 0;                  // 已收到服务器响应的包数
+    bool complete = false;                    // 是否已收到最终结果
+    std::vector<CachedUtterance> utterances;  // 分句结果（时间轴相对文件开头）
+
+    /**
+     * @brief 拼接全部分句文本
+     */
+    std::string text() const;
+
+    /**
+     * @brief 开头连续定稿分句的个数
+     */
+    size_t finalizedCount() const;
+
+    /**
+     * @brief 最后一个连续定稿分句的结束时间（毫秒），没有定稿分句时为 0
+     */
+    int64_t finalizedEndMs() const;
+};
+
+// ============================================================================
+// 识别结果缓存
+// ============================================================================
+
+/**
+ * @brief 磁盘识别结果缓存
+ *
+ * 每个条目是缓存目录下的一个 <key>.json 文件，写入时先写临时文件再重命名。
+ * 文件修改时间即最近访问时间，命中时刷新，超过容量时从最旧的条目开始删除。
+ * 所有方法线程安全
+ */
+class TranscriptionCache {
+public:
+    static constexpr uint64_t kDefaultMaxBytes = 256ull * 1024 * 1024;
+
+    explicit TranscriptionCache(const std::string& cacheDir, uint64_t maxBytes = kDefaultMaxBytes);
+
+    /**
+     * @brief 计算缓存键
+     *
+     * 键由 PCM 数据、实际发出的请求参数（AsrClient::constructRequest，去掉 uid / reqid）
+     * 与服务地址（cluster）共同决定，凭据等无关字段不参与
+     */
+    static std::string makeKey(const std::vector<uint8_t>& pcm, const AsrApiConfig& config);
+
+    /**
+     * @brief 读取条目
+     * @return 条目存在且通过校验时返回 true；校验失败的条目会被删除
+     */
+    bool load(const std::string& key, TranscriptionCacheEntry& entry);
+
+    /**
+     * @brief 写入（覆盖）条目，并按容量上限淘汰旧条目
+     */
+    bool store(const TranscriptionCacheEntry& entry);
+
+    void remove(const std::string& key);
+    void clear();
+
+    /**
+     * @brief 缓存目录当前占用的字节数
+     */
+    uint64_t totalBytes() const;
+
+    const std::string& getCacheDir() const { return m_cacheDir; }
+    std::string getLastError() const;
+
+    // ============================================================================
+    // 条目文件读写（缓存目录与续传进度文件共用同一格式）
+    // ============================================================================
+
+    /**
+     * @brief 原子写入条目文件（临时文件 + 重命名）
+     */
+    static bool writeEntryFile(const std::string& path, const TranscriptionCacheEntry& entry,
+                               std::string* error = nullptr);
+
+    /**
+     * @brief 读取并校验条目文件
+     * @param key 期望的缓存键，与文件中记录的不一致时视为无效
+     * @return 文件存在且通过版本、校验和与键检查时返回 true
+     */
+    static bool readEntryFile(const std::string& path, const std::string& key,
+                              TranscriptionCacheEntry& entry, std::string* error = nullptr);
+
+    // ============================================================================
+    // 与服务端消息格式互转
+    // ============================================================================
+
+    /**
+     * @brief 解析服务端 result.utterances
+     * @param offsetMs 加到所有时间戳上的偏移（续传会话的起点）
+     * @return 消息包含 utterances 数组时返回 true
+     */
+    static bool parseServerMessage(const std::string& message, int64_t offsetMs,
+                                   std::vector<CachedUtterance>& utterances);
+
+    /**
+     * @brief 生成与服务端完整结果格式一致的消息，供回调方按原有逻辑解析
+     */
+    static std::string toServerMessage(const std::vector<CachedUtterance>& utterances);
+
+private:
+    std::string entryPath(const std::string& key) const;
+    void evictLocked(const std::string& keepKey);
+
+    std::string m_cacheDir;
+    uint64_t m_maxBytes;
+    mutable std::mutex m_mutex;
+    std::string m_lastError;
+};
+
+} // namespace Asr
@@ -14,11 +14,13 @@ class AudioDevice {
 public:
     using AudioCallback = std::function<void(const void* input, void* output, size_t frameCount)>;
     using ErrorCallback = std::function<void(const std::string&)>;
+    // 参数为新设备与其实际打开的流配置
+    using DeviceChangedCallback = std::function<void(const DeviceInfo&, const AudioConfig&)>;
 
     AudioDevice();
     ~AudioDevice();
 
-    // 初始化 PortAudio
+    // 初始化设备（PortAudio 引用在打开流时向 DeviceRegistry 借用）
     bool initialize();
     
     // 获取所有可用的音频设备
@@ -55,6 +57,15 @@ public:
 
     void setErrorCallback(ErrorCallback cb);
 
+    // 输入设备丢失后自动切换到备用设备（默认开启），切换成功时在看门狗线程中回调新设备与实际流配置。
+    // 新设备协商出的数据布局（格式等）与原流相同时已恢复采集；不同时流已打开但未启动，
+    // 回调方按新配置重建下游后调用 startStream()
+    void setDeviceChangedCallback(DeviceChangedCallback cb);
+    void setFailoverEnabled(bool enabled);
+
+    // 累计的上溢/下溢次数
+    uint64_t getXrunCount() const;
+
 private:
     class Impl;
     std::unique_ptr<Impl> impl_;
@@ -4,6 +4,7 @@
 #include "audio_device.h"
 #include "audio_processor.h"
 #include "audio_thread.h"
+#include "sample_pipeline.h"
 #include <memory>
 #include <string>
 #include <vector>
@@ -99,55 +100,13 @@ struct LyricSyncManager {
     }
     
     // 导出为LRC格式
-    std::string exportToLRC() const {
-        std::lock_guard<std::mutex> lock(mutex);
-        std::string lrc;
-        lrc += "[ti:ASR转录结果]\n";
-        lrc += "[ar:自动语音识别]\n";
-        lrc += "[al:PerfXAgent]\n";
-        lrc += "[by:ASR转录]\n\n";
-        
-        for (const auto& segment : segments) {
-            // 转换毫秒为LRC时间格式 [mm:ss.xx]
-            int minutes = static_cast<int>(segment.startTime) / 60000;
-            int seconds = (static_cast<int>(segment.startTime) % 60000) / 1000;
-            int centiseconds = (static_cast<int>(segment.startTime) % 1000) / 10;
-            
-            char timeStr[16];
-            snprintf(timeStr, sizeof(timeStr), "[%02d:%02d.%02d]", minutes, seconds, centiseconds);
-            
-            lrc += timeStr + segment.text + "\n";
-        }
-        return lrc;
-    }
+    std::string exportToLRC() const;
     
-    // 导出为JSON格式
-    std::string exportToJSON() const {
-        std::lock_guard<std::mutex> lock(mutex);
-        std::string json = "{\n";
-        json += "  \"fullText\": \"" + fullText + "\",\n";
-        json += "  \"totalDuration\": " + std::to_string(totalDuration) + ",\n";
-        json += "  \"segments\": [\n";
-        
-        for (size_t i = 0; i < segments.size(); ++i) {
-            const auto& segment = segments[i];
-            json += "    {\n";
-            json += "      \"text\": \"" + segment.text + "\",\n";
-            json += "      \"startTime\": " + std::to_string(segment.startTime) + ",\n";
-            json += "      \"endTime\": " + std::to_string(segment.endTime) + ",\n";
-            json += "      \"confidence\": " + std::to_string(segment.confidence) + ",\n";
-            json += "      \"isFinal\": " + std::string(segment.isFinal ? "true" : "false") + "\n";
-            json += "    }";
-            if (i < segments.size() - 1) {
-                json += ",";
-            }
-            json += "\n";
-        }
-        
-        json += "  ]\n";
-        json += "}";
-        return json;
-    }
+    // 导出为JSON格式（字符串按JSON规范转义）
+    std::string exportToJSON() const;
+    
+    // 导出到文件，format 为 lrc / json / srt / vtt（先写临时文件，完成后替换）
+    bool exportToFile(const std::string& filePath, const std::string& format, std::string& error) const;
 };
 
 /**
@@ -207,6 +166,10 @@ public:
     bool updateConfig(const AudioConfig& config);
     const AudioConfig& getConfig() const;
 
+    // 按实际打开的输入流格式（设备不支持时可能与请求的格式不同）选定的转换函数，
+    // 外部回调收到的数据即为该格式
+    SampleConverter getInputConverter() const;
+
     // 获取所有可用设备
     std::vector<DeviceInfo> getAvailableDevices();
     
@@ -378,6 +341,7 @@ Q_SIGNALS:
     void recordingProgressUpdated(double duration, size_t bytes);
     void waveformDataUpdated(const QVector<float>& waveformData);
     void recordingCompleted(const QString& filePath);
+    void inputDeviceChanged(const QString& deviceName);  // 设备丢失后已切换到备用设备
 
 public Q_SLOTS:
     void emitOutputFileInfo(const QString& info) { emit outputFileInfo(info); }
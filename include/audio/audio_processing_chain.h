@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace perfx {
+namespace audio {
+
+/**
+ * @brief 处理链配置
+ */
+struct ProcessingChainConfig {
+    int sampleRate = 16000;             ///< 采样率
+    int channels = 1;                   ///< 声道数（交织输入，每个声道独立处理）
+    int blockMs = 10;                   ///< 处理块长(ms)，各阶段均按固定块长工作
+    size_t maxFramesPerCall = 1024;     ///< 单次 process() 的最大帧数，用于预分配缓冲
+
+    bool enableHighPass = true;         ///< 高通滤波（去除直流与低频隆隆声）
+    float highPassHz = 80.0f;           ///< 高通截止频率
+
+    bool enableNoiseSuppression = true; ///< 谱减降噪
+    float noiseOverSubtraction = 2.0f;  ///< 过减因子
+    float noiseGainFloorDb = -20.0f;    ///< 单个频点的最大衰减
+    bool enableDereverb = false;        ///< 晚期混响抑制（与降噪共用 STFT）
+    float reverbT60Seconds = 0.4f;      ///< 假设的房间混响时间
+
+    bool enableAGC = true;              ///< 自动增益控制 + 限幅器
+    float agcTargetDb = -20.0f;         ///< 目标 RMS 电平(dBFS)
+    float agcMaxGainDb = 30.0f;         ///< 最大增益
+    float agcMinGainDb = -12.0f;        ///< 最小增益
+    float agcGateDb = -55.0f;           ///< 低于此电平的块视为静音，增益保持不变
+    float limiterCeilingDb = -1.0f;     ///< 限幅器上限(dBFS)
+};
+
+/**
+ * @brief 处理阶段接口
+ *
+ * 每个声道持有独立的阶段实例。prepare() 中完成全部内存分配，
+ * process() 在音频线程中调用，不得分配内存或加锁
+ */
+class ProcessingStage {
+public:
+    virtual ~ProcessingStage() = default;
+
+    virtual const char* name() const = 0;
+
+    /**
+     * @brief 按采样率与块长预分配资源
+     */
+    virtual void prepare(int sampleRate, size_t blockSize) = 0;
+
+    virtual void reset() = 0;
+
+    /**
+     * @brief 就地处理一个单声道块（长度恒为 prepare 时的 blockSize）
+     */
+    virtual void process(float* block, size_t blockSize) = 0;
+
+    /**
+     * @brief 阶段引入的额外延迟（帧）
+     */
+    virtual size_t latencyFrames() const { return 0; }
+};
+
+using StageFactory = std::function<std::unique_ptr<ProcessingStage>()>;
+
+/**
+ * @brief 单个阶段的耗时统计
+ */
+struct StageStats {
+    std::string name;
+    uint64_t blocks = 0;            ///< 已处理的单声道块数
+    double avgUsPerBlock = 0.0;     ///< 每声道每块平均耗时(us)
+    double maxUsPerBlock = 0.0;     ///< 单块（全部声道）最大耗时(us)
+};
+
+/**
+ * @brief 块式音频处理链
+ *
+ * 将任意长度的回调缓冲切分为固定 10ms 块，依次通过各处理阶段
+ * （默认：高通 → 降噪/去混响 → AGC + 限幅）。回调长度不是块长整数倍时，
+ * 首次出现缺口时补入不足一块的静音，此后延迟保持不变
+ */
+class AudioProcessingChain {
+public:
+    explicit AudioProcessingChain(const ProcessingChainConfig& config);
+    ~AudioProcessingChain();
+
+    /**
+     * @brief 按配置创建默认处理链
+     */
+    static std::unique_ptr<AudioProcessingChain> createDefault(const ProcessingChainConfig& config);
+
+    /**
+     * @brief 追加处理阶段（为每个声道各创建一个实例）
+     */
+    void addStage(const StageFactory& factory);
+    void clearStages();
+    size_t stageCount() const;
+
+    void reset();
+
+    /**
+     * @brief 就地处理交织样本
+     */
+    void process(float* interleaved, size_t frames);
+    void process(int16_t* interleaved, size_t frames);
+
+    /**
+     * @brief 当前总延迟（块对齐补偿 + 各阶段延迟）
+     */
+    size_t getLatencyFrames() const;
+    size_t getBlockSize() const { return blockSize_; }
+    const ProcessingChainConfig& getConfig() const { return config_; }
+
+    std::vector<StageStats> getStageStats() const;
+
+    /**
+     * @brief 用合成的带噪语音测量各阶段每声道 CPU 占用
+     * @param seconds 处理的音频时长
+     */
+    static std::vector<StageStats> benchmark(const ProcessingChainConfig& config, double seconds = 10.0);
+
+private:
+    struct StageSlot {
+        std::vector<std::unique_ptr<ProcessingStage>> perChannel;
+        std::atomic<uint64_t> blocks{0};
+        std::atomic<uint64_t> totalNs{0};
+        std::atomic<uint64_t> maxNs{0};
+    };
+
+    void processPlanar(size_t frames);
+    void runBlock();
+
+    ProcessingChainConfig config_;
+    size_t blockSize_;
+    size_t channels_;
+    size_t ringCapacity_;
+
+    std::vector<std::unique_ptr<StageSlot>> stages_;
+
+    // 每声道的输入 / 输出 FIFO（环形，容量固定）
+    std::vector<std::vector<float>> inputRing_;
+    std::vector<std::vector<float>> outputRing_;
+    size_t inputHead_ = 0;
+    size_t inputSize_ = 0;
+    size_t outputHead_ = 0;
+    size_t outputSize_ = 0;
+    size_t alignmentLatency_ = 0;
+
+    std::vector<std::vector<float>> block_;     ///< 每声道的当前块
+    std::vector<float> scratch_;                ///< INT16 路径的交织浮点缓冲
+};
+
+} // namespace audio
+} // namespace perfx
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "audio_types.h"
+#include "audio_processing_chain.h"
 #include <memory>
 #include <vector>
 
@@ -17,6 +18,10 @@ public:
     void updateConfig(const AudioConfig& config);
     const AudioConfig& getConfig() const;
     void processAudio(const void* input, void* output, unsigned long frameCount);
+
+    // 处理链（高通 / 降噪 / AGC，由 AudioConfig 开关控制）
+    bool hasProcessingChain() const;
+    std::vector<StageStats> getProcessingStats() const;
     
     // Opus 编码解码相关函数
     bool encodeOpus(const void* input, size_t frames, std::vector<std::vector<uint8_t>>& encodedFrames);
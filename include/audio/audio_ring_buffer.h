@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace perfx {
+namespace audio {
+
+/**
+ * @brief 生产者 → 消费者的唤醒信号
+ *
+ * 生产者一侧 signal() 不加锁、不分配内存，可在实时音频回调中调用：
+ *  - Linux: eventfd（消费者用 poll 带超时阻塞）
+ *  - macOS: dispatch_semaphore
+ *  - Windows: 内核信号量
+ *  - 其他平台: 条件变量（带超时等待，丢失的通知最多延迟一个超时周期）
+ */
+class ConsumerSignal {
+public:
+    ConsumerSignal();
+    ~ConsumerSignal();
+
+    ConsumerSignal(const ConsumerSignal&) = delete;
+    ConsumerSignal& operator=(const ConsumerSignal&) = delete;
+
+    void signal();
+
+    /**
+     * @brief 阻塞直到被唤醒或超时
+     * @return 是否被唤醒
+     */
+    bool wait(int timeoutMs);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief 预分配的单生产者 / 单消费者音频块环形缓冲
+ *
+ * 缓冲由固定数量的槽组成，每槽最多容纳 framesPerSlot 帧。push() 把超长的
+ * 回调缓冲拆分到连续多个槽中；剩余空间不足时整块丢弃并计入溢出统计，
+ * 而不是阻塞音频回调
+ */
+class AudioRingBuffer {
+public:
+    /**
+     * @brief 环形缓冲统计
+     */
+    struct Stats {
+        uint64_t pushedChunks = 0;      ///< 成功写入的槽数
+        uint64_t droppedChunks = 0;     ///< 因缓冲已满被丢弃的回调次数
+        uint64_t droppedFrames = 0;     ///< 被丢弃的帧数
+        size_t capacity = 0;            ///< 槽数
+        size_t highWatermark = 0;       ///< 历史最高占用槽数
+    };
+
+    AudioRingBuffer(size_t slotCount, size_t framesPerSlot, size_t bytesPerFrame);
+    ~AudioRingBuffer();
+
+    AudioRingBuffer(const AudioRingBuffer&) = delete;
+    AudioRingBuffer& operator=(const AudioRingBuffer&) = delete;
+
+    /**
+     * @brief 生产者：写入一段交织音频并唤醒消费者
+     * @param captureNs 首样本的采集时间（随槽保存，供消费者计算延迟）
+     * @return 缓冲已满被丢弃时返回 false
+     */
+    bool push(const void* data, size_t frames, int64_t captureNs = 0);
+
+    /**
+     * @brief 消费者：当前可读槽数
+     */
+    size_t available() const;
+
+    /**
+     * @brief 消费者：读取队首槽（调用 pop() 前数据保持有效）
+     * @param frames 输出该槽中的帧数
+     * @param captureNs 可选，输出该槽的采集时间
+     * @return 缓冲为空时返回 nullptr
+     */
+    const uint8_t* front(size_t& frames, int64_t* captureNs = nullptr) const;
+
+    /**
+     * @brief 消费者：释放队首槽
+     */
+    void pop();
+
+    /**
+     * @brief 消费者：阻塞等待新数据
+     * @return 超时前是否有数据可读
+     */
+    bool waitForData(int timeoutMs);
+
+    /**
+     * @brief 唤醒正在等待的消费者（用于停止）
+     */
+    void wake();
+
+    Stats getStats() const;
+
+    size_t framesPerSlot() const { return framesPerSlot_; }
+    size_t bytesPerFrame() const { return bytesPerFrame_; }
+
+private:
+    const size_t slotCount_;
+    const size_t framesPerSlot_;
+    const size_t bytesPerFrame_;
+    const size_t slotBytes_;
+
+    std::vector<uint8_t> data_;
+    std::vector<size_t> frames_;
+    std::vector<int64_t> captureNs_;
+
+    std::atomic<uint64_t> head_{0};     ///< 消费者读位置（单调递增）
+    std::atomic<uint64_t> tail_{0};     ///< 生产者写位置（单调递增）
+
+    std::atomic<uint64_t> pushedChunks_{0};
+    std::atomic<uint64_t> droppedChunks_{0};
+    std::atomic<uint64_t> droppedFrames_{0};
+    std::atomic<size_t> highWatermark_{0};
+
+    ConsumerSignal signal_;
+};
+
+} // namespace audio
+} // namespace perfx
@@ -5,6 +5,8 @@
 #include "audio_device.h"
 #include "audio_processor.h"
 #include <memory>
+#include <string>
+#include <vector>
 #include <thread>
 #include <atomic>
 #include <queue>
@@ -18,6 +20,30 @@ class AudioProcessor;
 struct DeviceInfo;
 struct AudioConfig;
 
+/**
+ * @brief 消费者流水线中单个阶段的耗时统计
+ */
+struct PipelineStageTiming {
+    std::string name;
+    uint64_t calls = 0;         ///< 调用次数（每批一次）
+    double avgUs = 0.0;         ///< 平均耗时(us)
+    double maxUs = 0.0;         ///< 最大耗时(us)
+};
+
+/**
+ * @brief 消费者流水线统计
+ */
+struct PipelineStats {
+    uint64_t pushedChunks = 0;      ///< 写入环形缓冲的槽数
+    uint64_t droppedChunks = 0;     ///< 环形缓冲已满被丢弃的回调次数
+    uint64_t droppedFrames = 0;     ///< 被丢弃的帧数
+    uint64_t batches = 0;           ///< 消费者处理的批次数
+    uint64_t frames = 0;            ///< 消费者处理的总帧数
+    size_t ringCapacity = 0;        ///< 环形缓冲槽数
+    size_t ringHighWatermark = 0;   ///< 环形缓冲历史最高占用
+    std::vector<PipelineStageTiming> stages;    ///< 各处理器及最终回调的耗时
+};
+
 class AudioThread {
 public:
     AudioThread();
@@ -38,14 +64,21 @@ public:
     // 设置输出设备
     bool setOutputDevice(const DeviceInfo& device);
     
-    // 添加音频处理回调
+    // 添加音频处理器（消费者线程中按添加顺序依次就地处理）
     void addProcessor(std::shared_ptr<AudioProcessor> processor);
     
     // 设置音频处理器
     void setProcessor(std::shared_ptr<AudioProcessor> processor);
     
-    // 设置回调
+    // 设置回调（在消费者线程中以处理后的数据调用，而非实时音频回调中）
     void setInputCallback(AudioCallback callback);
+
+    // 由外部生产者（如 AudioDevice 回调）写入音频，可在实时线程中调用；
+    // 消费者未运行时返回 false，缓冲已满时丢弃并计入统计
+    bool submit(const void* input, unsigned long frameCount);
+
+    // 获取环形缓冲与各阶段耗时统计
+    PipelineStats getPipelineStats() const;
     
     // 获取当前状态
     bool isRunning() const;
@@ -53,9 +86,12 @@ public:
     // 获取当前配置
     AudioConfig getCurrentConfig() const;
 
-    //
+    // 启动消费者线程（重复调用无副作用）
     bool startRecording();
 
+    // 等待消费者处理完调用前已写入的数据（消费者继续运行），超时返回 false
+    bool flush(int timeoutMs);
+
 private:
     class Impl;
     std::unique_ptr<Impl> impl_;
@@ -58,11 +58,14 @@ enum class SampleRate : int {
 
 /**
  * @brief 通道数枚举
- * 定义了音频通道配置
+ * 定义了音频通道配置；其他声道数（多声道声卡）用 static_cast<ChannelCount>(n) 表示
  */
 enum class ChannelCount : int {
     MONO = 1,              ///< 单声道
-    STEREO = 2             ///< 立体声
+    STEREO = 2,            ///< 立体声
+    QUAD = 4,              ///< 4 声道（会议室多麦克风声卡）
+    SURROUND_5_1 = 6,      ///< 6 声道
+    SURROUND_7_1 = 8       ///< 8 声道
 };
 
 /**
@@ -109,6 +112,9 @@ struct DeviceInfo {
     int maxOutputChannels;              ///< 最大输出通道数
     double defaultSampleRate;           ///< 默认采样率
     double defaultLatency;              ///< 默认延迟(秒)
+    std::string hostApi;                ///< 宿主音频API名称（由DeviceRegistry填充）
+    std::vector<int> supportedSampleRates; ///< 探测到的可用采样率（单声道 INT16 输入）
+    bool isDefaultInput = false;        ///< 是否为系统默认输入设备
 };
 
 
@@ -135,13 +141,22 @@ struct AudioConfig {
     int opusComplexity = 10;                            ///< Opus复杂度
 
     // 处理参数
-    bool enableAGC = false;                             ///< 是否启用自动增益控制
+    bool enableAGC = false;                             ///< 是否启用自动增益控制（含限幅器）
+    bool enableHighPass = false;                        ///< 是否启用高通滤波
+    bool enableNoiseSuppression = false;                ///< 是否启用谱减降噪
+    bool enableDereverb = false;                        ///< 是否在降噪中同时抑制晚期混响
 
     // 录音参数
     std::string outputFile;                             ///< 输出文件名
     bool autoStartRecording = false;                    ///< 是否自动开始录音
     int maxRecordingDuration = 0;                       ///< 最大录音时长(秒)
 
+    // 采样率、声道数、格式与每缓冲帧数都相同（回调数据布局相同）
+    bool sameStreamLayout(const AudioConfig& other) const {
+        return sampleRate == other.sampleRate && channels == other.channels && format == other.format &&
+               framesPerBuffer == other.framesPerBuffer;
+    }
+
     // 序列化方法
     void fromJson(const std::string& jsonStr) {
         auto j = nlohmann::json::parse(jsonStr);
@@ -154,6 +169,9 @@ struct AudioConfig {
         opusBitrate = j["opusBitrate"];
         opusComplexity = j["opusComplexity"];
         enableAGC = j["enableAGC"];
+        enableHighPass = j.value("enableHighPass", false);
+        enableNoiseSuppression = j.value("enableNoiseSuppression", false);
+        enableDereverb = j.value("enableDereverb", false);
         outputFile = j["outputFile"];
         autoStartRecording = j["autoStartRecording"];
         maxRecordingDuration = j["maxRecordingDuration"];
@@ -170,6 +188,9 @@ struct AudioConfig {
             {"opusBitrate", opusBitrate},
             {"opusComplexity", opusComplexity},
             {"enableAGC", enableAGC},
+            {"enableHighPass", enableHighPass},
+            {"enableNoiseSuppression", enableNoiseSuppression},
+            {"enableDereverb", enableDereverb},
             {"outputFile", outputFile},
             {"autoStartRecording", autoStartRecording},
             {"maxRecordingDuration", maxRecordingDuration}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "audio_types.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace perfx {
+namespace audio {
+
+/**
+ * @brief 采集图中的一个输入源
+ */
+struct CaptureSource {
+    DeviceInfo device;
+    std::string label;              ///< 轨道标签（空时取设备名）
+};
+
+/**
+ * @brief 采集图配置
+ */
+struct CaptureGraphConfig {
+    int sampleRate = 16000;         ///< 所有输入源按此标称采样率打开，输出同一采样率
+    size_t framesPerBuffer = 256;
+    bool mix = false;               ///< true：各源混为一条单声道轨道；false：每源一条轨道（交织输出）
+    bool driftCorrection = true;    ///< 关闭后次要源按 1:1 读取（用于对比时钟漂移的影响）
+    int targetLatencyMs = 80;       ///< 次要源 FIFO 的目标水位，吸收回调抖动
+    double driftTimeConstantSec = 30.0; ///< 漂移估计的指数遗忘时间常数
+};
+
+/**
+ * @brief 单个输入源的统计
+ */
+struct CaptureSourceStats {
+    std::string label;
+    std::string device;
+    bool master = false;            ///< 主时钟源（输出按其回调节奏产生）
+    double rateHz = 0.0;            ///< 按回调时间戳与样本数估计的实际采样率（steady_clock 时基）
+    double driftPpm = 0.0;          ///< 相对主时钟源的漂移（主时钟源为 0）
+    double ratio = 1.0;             ///< 当前重采样比（每个输出帧消耗的输入帧数）
+    double fillMs = 0.0;            ///< 当前 FIFO 水位
+    uint64_t frames = 0;            ///< 已采集的帧数
+    uint64_t underruns = 0;         ///< FIFO 取空（该块补静音）的次数
+    uint64_t overruns = 0;          ///< FIFO 写满（丢弃输入）的次数
+    uint64_t xruns = 0;             ///< 设备上报的上溢 / 下溢
+};
+
+/**
+ * @brief 按回调时间戳与累计样本数估计设备的实际采样率
+ *
+ * 对 (采集时间, 累计帧数) 做带指数遗忘的最小二乘直线拟合，斜率即采样率。
+ * 单次回调时间戳的抖动（毫秒级）在长基线上被平均掉，30 s 时间常数下精度约数 ppm
+ */
+class DriftEstimator {
+public:
+    explicit DriftEstimator(double timeConstantSec = 30.0) : timeConstantSec_(timeConstantSec) {}
+
+    void reset();
+
+    /**
+     * @param captureNs 本次回调首样本的采集时间
+     * @param frames 本次回调的帧数
+     */
+    void update(int64_t captureNs, size_t frames);
+
+    /**
+     * @brief 估计的采样率；观测不足 2 s 时返回 0
+     */
+    double rateHz() const;
+
+private:
+    double timeConstantSec_;
+    int64_t originNs_ = -1;
+    double lastX_ = 0.0;
+    double totalFrames_ = 0.0;
+    double weight_ = 0.0, meanX_ = 0.0, meanY_ = 0.0, cxx_ = 0.0, cxy_ = 0.0;
+};
+
+/**
+ * @brief 多输入源采集图
+ *
+ * 同时打开多个输入设备（例如麦克风 + PulseAudio / PipeWire 的 monitor 源），
+ * 第一个源为主时钟：其回调中从各次要源的无锁 FIFO 读取等量的帧，输出交织的 INT16
+ * （每源一条单声道轨道，或混为一条）。次要源的时钟漂移由 DriftEstimator 估计，
+ * 经三次 Hermite 插值的自适应重采样补偿，重采样比再按 FIFO 水位做微调，
+ * 长时间运行时各轨道保持同步、FIFO 不会持续增长或取空。
+ *
+ * 输出回调在主时钟源的音频回调线程中调用，不加锁、不分配内存
+ */
+class CaptureGraph {
+public:
+    using AudioCallback = std::function<void(const void* input, void* output, size_t frameCount)>;
+    using ErrorCallback = std::function<void(const std::string&)>;
+
+    CaptureGraph();
+    ~CaptureGraph();
+
+    CaptureGraph(const CaptureGraph&) = delete;
+    CaptureGraph& operator=(const CaptureGraph&) = delete;
+
+    bool open(const std::vector<CaptureSource>& sources, const CaptureGraphConfig& config = CaptureGraphConfig());
+    bool start();
+    void stop();
+    void close();
+
+    void setCallback(AudioCallback callback);
+    void setErrorCallback(ErrorCallback callback);
+
+    /**
+     * @brief 输出轨道数（mix 时为 1）与各轨道标签
+     */
+    int trackCount() const;
+    std::vector<std::string> trackLabels() const;
+
+    std::vector<CaptureSourceStats> getStats() const;
+    uint64_t getXrunCount() const;
+    bool isRunning() const;
+    std::string getLastError() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace audio
+} // namespace perfx
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "audio/sample_pipeline.h"
+
+namespace perfx {
+namespace audio {
+
+/**
+ * @brief 声道分组：组内声道取平均后作为一路单声道输出
+ */
+struct ChannelGroup {
+    std::string label;              ///< 说话人 / 声道标签
+    std::vector<int> channels;      ///< 0 起始的声道索引
+};
+
+/**
+ * @brief 把多声道交织输入拆分为按组的单声道 INT16 平面
+ *
+ * 非 INT16 输入先经 SampleConverter 转为交织 INT16，再用 dsp::deinterleave 一次拆出
+ * 全部声道；单组且包含全部声道时直接混音，单声道 INT16 输入不拷贝。
+ * 缓冲按最大帧数增长后复用，只应在单个线程（音频消费者线程）中调用
+ */
+class ChannelSplitter {
+public:
+    /**
+     * @brief 按输入格式与分组配置
+     * @param groups 为空时所有声道混为一组；越界的声道索引被忽略，没有有效声道的组取声道 0
+     */
+    void configure(const SampleConverter& converter, std::vector<ChannelGroup> groups);
+
+    /**
+     * @brief 每声道一组，标签为 ch1..chN
+     */
+    static std::vector<ChannelGroup> perChannelGroups(int channels);
+
+    /**
+     * @brief 拆分一段交织输入；结果在下次调用前有效
+     */
+    void split(const void* input, size_t frames);
+
+    size_t groupCount() const { return groups_.size(); }
+    const ChannelGroup& group(size_t index) const { return groups_[index]; }
+    const int16_t* output(size_t index) const { return outputs_[index]; }
+    int channels() const { return converter_.channels; }
+
+private:
+    void reserve(size_t frames);
+
+    SampleConverter converter_;
+    std::vector<ChannelGroup> groups_;
+    bool downmixOnly_ = true;                   // 单组且包含全部声道：不需要拆分
+    std::vector<int16_t> interleaved_;          // 非 INT16 输入转换后的交织样本
+    std::vector<int16_t> planes_;               // 各声道平面，按 capacity_ 步长排列
+    std::vector<int16_t*> planePtrs_;
+    std::vector<int16_t> mixes_;                // 多声道组的混音结果
+    std::vector<const int16_t*> outputs_;
+    size_t capacity_ = 0;
+};
+
+} // namespace audio
+} // namespace perfx
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace perfx {
+namespace audio {
+
+/**
+ * @brief 流式 XXH64 哈希
+ *
+ * 非加密哈希，仅用于内容寻址与完整性校验（去重、缓存键），吞吐量远高于 SHA 系列
+ */
+class Xxh64 {
+public:
+    explicit Xxh64(uint64_t seed = 0);
+
+    void reset(uint64_t seed = 0);
+    void update(const void* data, size_t length);
+    uint64_t digest() const;
+
+    /**
+     * @brief 一次性计算整块数据的哈希
+     */
+    static uint64_t hash(const void* data, size_t length, uint64_t seed = 0);
+
+private:
+    uint64_t v1_, v2_, v3_, v4_;
+    uint64_t seed_;
+    uint64_t totalLength_;
+    unsigned char buffer_[32];
+    size_t bufferSize_;
+};
+
+/**
+ * @brief 64 位哈希格式化为 16 位小写十六进制
+ */
+std::string toHex(uint64_t value);
+
+/**
+ * @brief 计算文件内容哈希
+ *
+ * 文件按固定块长切分，各块并行计算 XXH64，再对“块哈希序列 + 文件长度”求一次 XXH64。
+ * 块长固定，结果与线程数无关
+ *
+ * @param filePath 文件路径
+ * @param error 失败时写入错误信息（可为空）
+ * @param threads 并行线程数，0 表示按硬件并发数
+ * @param chunkSize 块长（字节）
+ * @return 形如 "<16位十六进制>-<文件长度>" 的内容标识，失败时返回空串
+ */
+std::string hashFileContent(const std::string& filePath, std::string* error = nullptr,
+                            unsigned threads = 0, size_t chunkSize = 16 * 1024 * 1024);
+
+} // namespace audio
+} // namespace perfx
@@ -0,0 +1,206 @@
+#pragma once
+
+#include "audio_types.h"
+#include "virtual_device.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace perfx {
+namespace audio {
+
+/**
+ * @brief PortAudio 全局互斥锁
+ *
+ * PortAudio 的初始化/枚举/打开流不是线程安全的。DeviceRegistry 在后台线程
+ * 重新枚举设备时持有此锁，AudioDevice 打开/关闭流时也需持有
+ */
+std::mutex& portAudioMutex();
+
+/**
+ * @brief 音频设备注册表
+ *
+ * 在后台线程中枚举一次全部设备并缓存 DeviceInfo（含采样率探测结果），
+ * 之后通过低成本的拓扑指纹轮询检测热插拔：
+ *  - Linux: 读取 /proc/asound/cards 与 /proc/asound/pcm，无需调用 PortAudio
+ *  - 其他平台: 没有低成本通知源，无活动流时按较长周期完整重新枚举
+ *
+ * PortAudio 只在 Pa_Terminate/Pa_Initialize 之后才会刷新设备表，且引用计数归零前
+ * Pa_Terminate 不会真正终止。因此进程内的 PortAudio 引用统一由注册表持有，其他模块
+ * 通过 acquirePortAudio()/PortAudioLease 借用；检测到变化但仍有活动流或借用者时
+ * 只标记为过期，待全部释放后再刷新
+ *
+ * 所有事件均在注册表的工作线程中通知，监听者需要自行切换到所需线程。
+ * 本类不依赖 Qt，可在无界面的命令行 / 守护进程中使用
+ *
+ * 虚拟输入设备（见 virtual_device.h）通过 addVirtualDevice() 或环境变量
+ * PERFX_VIRTUAL_DEVICES（多个描述串以 ';' 分隔）注册，排在 PortAudio 设备之后
+ * 出现在设备列表中，但不会被选作故障转移的备用设备
+ */
+class DeviceRegistry {
+public:
+    /**
+     * @brief 设备事件类型
+     */
+    enum class Event {
+        Ready,      ///< 首次枚举完成
+        Changed,    ///< 设备列表发生变化
+        Stale       ///< 检测到拓扑变化，但因有活动流暂时无法刷新
+    };
+
+    /**
+     * @brief 设备事件监听者
+     * @param added 新增设备名称（仅 Ready / Changed）
+     * @param removed 移除设备名称（仅 Changed）
+     */
+    using Listener = std::function<void(Event event,
+                                        const std::vector<std::string>& added,
+                                        const std::vector<std::string>& removed)>;
+
+    static DeviceRegistry& getInstance();
+
+    DeviceRegistry(const DeviceRegistry&) = delete;
+    DeviceRegistry& operator=(const DeviceRegistry&) = delete;
+
+    /**
+     * @brief 启动后台线程：首次枚举 + 热插拔轮询（重复调用无副作用）
+     * @param pollIntervalMs 拓扑指纹轮询周期
+     */
+    void start(int pollIntervalMs = 2000);
+
+    /**
+     * @brief 停止后台线程并释放持有的 PortAudio 引用
+     */
+    void stop();
+
+    /**
+     * @brief 首次枚举是否已完成
+     */
+    bool isReady() const;
+
+    /**
+     * @brief 阻塞等待首次枚举完成
+     * @return 超时前是否就绪
+     */
+    bool waitUntilReady(int timeoutMs) const;
+
+    /**
+     * @brief 获取缓存的全部设备（不访问 PortAudio）
+     */
+    std::vector<DeviceInfo> getDevices() const;
+
+    /**
+     * @brief 获取缓存的输入设备（不访问 PortAudio）
+     */
+    std::vector<DeviceInfo> getInputDevices() const;
+
+    /**
+     * @brief 按名称查找设备（重新枚举后索引可能变化，名称保持稳定）
+     */
+    bool findByName(const std::string& name, DeviceInfo& device) const;
+
+    /**
+     * @brief 为丢失的输入设备选择替代设备
+     * @details 优先系统默认输入设备，其次第一个满足通道数的输入设备；
+     *          均不满足时返回 index = -1 的设备
+     */
+    DeviceInfo getFallbackInputDevice(const DeviceInfo& lost, int minChannels) const;
+
+    /**
+     * @brief 注册虚拟输入设备；同名设备已存在时替换其配置并沿用索引
+     * @param device 输出分配了索引的设备信息
+     * @return 来源无法读取时返回 false
+     */
+    bool addVirtualDevice(const VirtualDeviceConfig& config, DeviceInfo& device, std::string& error);
+
+    /**
+     * @brief 注销虚拟输入设备（已打开的流不受影响）
+     */
+    bool removeVirtualDevice(const std::string& name);
+
+    /**
+     * @brief 按设备索引查找虚拟设备配置
+     * @return 该索引不是虚拟设备时返回 false
+     */
+    bool getVirtualDevice(int index, VirtualDeviceConfig& config) const;
+
+    /**
+     * @brief 请求在下一个轮询周期完整重新枚举
+     */
+    void requestRescan();
+
+    /**
+     * @brief 活动流计数，非零时不会重新初始化 PortAudio
+     */
+    void retainStream();
+    void releaseStream();
+
+    /**
+     * @brief 借用注册表持有的 PortAudio 引用（尚未初始化时在此初始化）
+     * @details 存在借用者时注册表不会 Pa_Terminate/Pa_Initialize；注册表已停止时
+     *          最后一个借用者归还时终止 PortAudio
+     * @return 初始化失败时返回 false 并写入 error
+     */
+    bool acquirePortAudio(std::string* error = nullptr);
+    void releasePortAudio();
+
+    /**
+     * @brief 注册设备事件监听者
+     * @return 监听者 ID，用于 removeListener
+     */
+    int addListener(Listener listener);
+
+    /**
+     * @brief 注销监听者；返回后不会再有该监听者的回调在执行
+     */
+    void removeListener(int id);
+
+private:
+    DeviceRegistry();
+    ~DeviceRegistry();
+
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief PortAudio 借用凭据：析构时归还 DeviceRegistry 的 PortAudio 引用
+ */
+class PortAudioLease {
+public:
+    PortAudioLease() = default;
+    ~PortAudioLease() { reset(); }
+
+    PortAudioLease(const PortAudioLease&) = delete;
+    PortAudioLease& operator=(const PortAudioLease&) = delete;
+
+    PortAudioLease(PortAudioLease&& other) noexcept : held_(other.held_) { other.held_ = false; }
+    PortAudioLease& operator=(PortAudioLease&& other) noexcept {
+        if (this != &other) {
+            reset();
+            held_ = other.held_;
+            other.held_ = false;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 借用 PortAudio（已持有时直接返回 true）
+     */
+    bool acquire(std::string* error = nullptr);
+
+    /**
+     * @brief 归还 PortAudio（未持有时无操作）
+     */
+    void reset();
+
+    bool held() const { return held_; }
+
+private:
+    bool held_ = false;
+};
+
+} // namespace audio
+} // namespace perfx
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace perfx {
+namespace audio {
+namespace dsp {
+
+/**
+ * @brief DSP 内核实现
+ * @details 首次调用时按 CPU 能力自动选择：AVX2 > SSE2 > 标量（x86），NEON（ARM）
+ */
+enum class DspBackend {
+    SCALAR = 0,
+    SSE2,
+    AVX2,
+    NEON
+};
+
+/**
+ * @brief 电平测量结果（归一化到 0.0 ~ 1.0）
+ */
+struct LevelInfo {
+    float peak = 0.0f;
+    float rms = 0.0f;
+};
+
+/**
+ * @brief 基准测试结果
+ */
+struct BenchmarkResult {
+    std::string kernel;         ///< 内核名称
+    std::string backend;        ///< 对比的 SIMD 实现
+    double scalarNsPerSample;   ///< 标量实现每样本耗时(ns)
+    double simdNsPerSample;     ///< SIMD 实现每样本耗时(ns)
+    double speedup;             ///< 加速比
+};
+
+// ============================================================================
+// 后端选择
+// ============================================================================
+
+DspBackend getActiveBackend();
+const char* getBackendName(DspBackend backend);
+std::vector<DspBackend> getSupportedBackends();
+
+/**
+ * @brief 强制使用指定后端（用于基准测试与排查）
+ * @return CPU 不支持该后端时返回 false，当前后端不变
+ */
+bool setBackend(DspBackend backend);
+
+// ============================================================================
+// 采样格式转换
+// 浮点范围 [-1.0, 1.0]；转为整数时饱和截断，NaN 视为 0
+// INT24 为 3 字节小端紧凑格式（与 PortAudio paInt24 一致）
+// ============================================================================
+
+void int16ToFloat(const int16_t* in, float* out, size_t count);
+void floatToInt16(const float* in, int16_t* out, size_t count);
+void int24ToFloat(const uint8_t* in, float* out, size_t count);
+void floatToInt24(const float* in, uint8_t* out, size_t count);
+void int32ToFloat(const int32_t* in, float* out, size_t count);
+void floatToInt32(const float* in, int32_t* out, size_t count);
+void floatToDouble(const float* in, double* out, size_t count);
+void doubleToFloat(const double* in, float* out, size_t count);
+
+// ============================================================================
+// 声道处理（立体声走 SIMD 快速路径，其他声道数走标量）
+// ============================================================================
+
+void interleave(const float* const* planes, float* out, int channels, size_t frames);
+void deinterleave(const float* in, float* const* planes, int channels, size_t frames);
+// INT16 拆分：2 / 4 / 8 声道有向量化实现，其余声道数逐样本拷贝
+void deinterleave(const int16_t* in, int16_t* const* planes, int channels, size_t frames);
+
+/**
+ * @brief 交织多声道混缩为单声道（各声道取平均）
+ */
+void downmixToMono(const float* in, float* out, int channels, size_t frames);
+void downmixToMono(const int16_t* in, int16_t* out, int channels, size_t frames);
+
+// ============================================================================
+// 增益、电平与数据清洗
+// ============================================================================
+
+void applyGain(float* samples, size_t count, float gain);
+
+LevelInfo measureLevels(const float* samples, size_t count);
+LevelInfo measureLevels(const int16_t* samples, size_t count);
+
+/**
+ * @brief 将 NaN/Inf 替换为 0
+ * @return 被替换的样本数
+ */
+size_t scrubNonFinite(float* samples, size_t count);
+
+// ============================================================================
+// 基准测试
+// ============================================================================
+
+/**
+ * @brief 对每个内核比较标量实现与当前最佳 SIMD 实现
+ * @param samples 每次调用处理的样本数
+ * @param iterations 重复次数
+ */
+std::vector<BenchmarkResult> runBenchmarks(size_t samples = 48000, int iterations = 200);
+
+} // namespace dsp
+} // namespace audio
+} // namespace perfx
@@ -3,14 +3,43 @@
 #include <string>
 #include <vector>
 #include <filesystem>
+#include <functional>
 #include <memory>
+#include <mutex>
 
 namespace perfx {
 namespace audio {
 
+/**
+ * @brief 单个文件的导入结果
+ */
+struct ImportResult {
+    std::string sourcePath;         ///< 源文件路径
+    std::string storedPath;         ///< 工作目录中的文件路径（<targetDir>/<stem>/<文件名>）
+    std::string blobPath;           ///< 内容存储中的文件路径
+    std::string contentHash;        ///< 内容标识（见 hashFileContent）
+    bool deduplicated = false;      ///< 内容已存在，未再次复制数据
+    std::string method;             ///< 写入内容存储的方式：reused / reflink / copy_file_range / copy
+    bool success = false;
+    std::string error;
+};
+
+/**
+ * @brief 批量导入进度回调（每完成一个文件调用一次，调用已串行化）
+ * @param completed 已完成的文件数
+ * @param total 文件总数
+ * @param result 刚完成文件的结果
+ */
+using ImportProgressCallback = std::function<void(size_t completed, size_t total, const ImportResult& result)>;
+
 /**
  * @brief 文件导入器类
  * 负责处理音频文件的导入、验证和存储
+ *
+ * 导入的文件按内容哈希存放在 <targetDir>/.blobs 下，相同内容只保存一份：
+ * 优先 reflink（写时复制，FICLONE / clonefile），其次 copy_file_range，最后普通复制。
+ * 工作目录 <targetDir>/<stem>/ 中的文件同样从内容存储 reflink 或复制得到，与内容存储
+ * 不共享 inode，就地修改工作文件（重新编码、裁剪）不会影响内容存储及其他去重到同一哈希的导入
  */
 class FileImporter {
 public:
@@ -30,21 +59,28 @@ public:
      * @param targetDir 目标目录
      * @return 导入是否成功
      */
-    bool importAudioFile(const std::string& sourcePath, const std::string& targetDir);
+    bool importAudioFile(const std::string& sourcePath, const std::string& targetDir,
+                         ImportResult* result = nullptr);
 
     /**
-     * @brief 批量导入音频文件
+     * @brief 批量导入音频文件（并行）
      * @param sourcePaths 源文件路径列表
      * @param targetDir 目标目录
+     * @param progress 进度回调（在工作线程中调用）
+     * @param maxParallel 最大并行数，0 表示按硬件并发数（最多 4）
      * @return 成功导入的文件数量
      */
-    size_t importAudioFiles(const std::vector<std::string>& sourcePaths, const std::string& targetDir);
+    size_t importAudioFiles(const std::vector<std::string>& sourcePaths, const std::string& targetDir,
+                            const ImportProgressCallback& progress = nullptr, unsigned maxParallel = 0);
 
     /**
      * @brief 获取最后一次错误信息
      * @return 错误信息字符串
      */
-    std::string getLastError() const { return lastError_; }
+    std::string getLastError() const {
+        std::lock_guard<std::mutex> lock(errorMutex_);
+        return lastError_;
+    }
 
     /**
      * @brief 获取保存文件的目录信息
@@ -58,18 +94,36 @@ private:
     /**
      * @brief 创建目标目录
      * @param dirPath 目录路径
+     * @param error 失败时写入错误信息
      * @return 是否创建成功
      */
-    bool createTargetDirectory(const std::string& dirPath);
+    static bool createTargetDirectory(const std::string& dirPath, std::string& error);
 
     /**
-     * @brief 复制文件
+     * @brief 复制文件内容：reflink → copy_file_range → 普通复制
      * @param sourcePath 源文件路径
-     * @param targetPath 目标文件路径
+     * @param targetPath 目标文件路径（不得已存在）
+     * @param method 输出实际使用的方式
+     * @param error 失败时写入错误信息
      * @return 是否复制成功
      */
-    bool copyFile(const std::string& sourcePath, const std::string& targetPath);
+    static bool cloneFile(const std::string& sourcePath, const std::string& targetPath,
+                          std::string& method, std::string& error);
+
+    /**
+     * @brief 导入单个文件（不修改 lastError_，可并行调用）
+     */
+    bool importOne(const std::string& sourcePath, const std::string& targetDir,
+                   unsigned hashThreads, ImportResult& result);
+
+    /**
+     * @brief 校验文件存在、扩展名受支持、WAV 文件头有效
+     */
+    static bool validateAudioFile(const std::string& filePath, std::string& error);
+
+    void setLastError(const std::string& error);
 
+    mutable std::mutex errorMutex_;
     std::string lastError_;  ///< 最后一次错误信息
 };
 
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+namespace perfx {
+namespace audio {
+
+/**
+ * @brief 采集路径指标名称
+ *
+ * 后缀表示单位：_us 微秒，_frames 帧，_slots 环形缓冲槽
+ */
+namespace metrics {
+
+constexpr const char* kCallbackDuration = "audio.callback_us";              ///< 设备回调耗时
+constexpr const char* kInputLatency = "audio.input_adc_latency_us";         ///< ADC 采样 → 回调（来自 timeInfo）
+constexpr const char* kConsumerLag = "audio.consumer_lag_frames";           ///< 消费者取数时积压的帧数
+constexpr const char* kRingOccupancy = "audio.ring_occupancy_slots";        ///< 消费者取数时的环形缓冲占用
+constexpr const char* kCaptureToConsumer = "audio.capture_to_consumer_us";  ///< 采集 → 消费者处理
+constexpr const char* kMicToPacket = "asr.mic_to_packet_us";                ///< 包内最早样本采集 → 发送
+constexpr const char* kMicToFirstPartial = "asr.mic_to_first_partial_us";   ///< 语句首包采集 → 首个识别文本
+constexpr const char* kAsrPacketRtt = "asr.packet_rtt_us";                 ///< 发包 → 对应的服务端响应
+constexpr const char* kAsrResultLatency = "asr.result_latency_us";         ///< 发出某段音频 → 收到覆盖它的识别文本
+constexpr const char* kAsrPacketDuration = "asr.packet_ms";                ///< 每个音频包的时长（分包选择的历史分布）
+
+constexpr const char* kXrunInputOverflow = "audio.xrun.input_overflow";
+constexpr const char* kXrunInputUnderflow = "audio.xrun.input_underflow";
+constexpr const char* kXrunOutputOverflow = "audio.xrun.output_overflow";
+constexpr const char* kXrunOutputUnderflow = "audio.xrun.output_underflow";
+constexpr const char* kRingDropped = "audio.ring_dropped_chunks";           ///< 环形缓冲已满被丢弃的回调
+constexpr const char* kAsrPacketsSent = "asr.packets_sent";
+constexpr const char* kAsrUtterances = "asr.utterances";
+constexpr const char* kAsrPacketMsCurrent = "asr.packet_ms_current";       ///< 当前分包时长
+constexpr const char* kAsrPacketSizeChanges = "asr.packet_size_changes";
+constexpr const char* kAsrSessionAllocations = "asr.session_allocations";   ///< 会话内存（帧缓冲、响应暂存区、zlib 流）的堆分配
+
+/**
+ * @brief 单调时钟当前时间（纳秒），各指标统一使用该时间基准
+ */
+int64_t nowNs();
+
+/**
+ * @brief 设置 / 读取本线程当前正在传递的音频的采集时间（纳秒）
+ *
+ * 设备回调在调用下游前设置为“首样本被 ADC 采样的时间”，AudioThread 的消费者
+ * 在调用输入回调前恢复为该批数据的采集时间，下游据此计算端到端延迟而无需改动
+ * 回调签名。为 0 表示未知
+ */
+void setCurrentCaptureTime(int64_t captureNs);
+int64_t currentCaptureTime();
+
+} // namespace metrics
+
+/**
+ * @brief 无锁对数直方图
+ *
+ * 每个 2 的幂区间再分 4 个子桶（相对误差 ≤ 25%），record() 只做原子加，
+ * 可在实时音频回调中调用
+ */
+class LatencyHistogram {
+public:
+    static constexpr size_t kBucketCount = 192;
+
+    void record(uint64_t value);
+    void reset();
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 估算分位数（取所在桶的中点，并夹在已观测的最小/最大值之间）
+     * @param quantile 0~1
+     */
+    uint64_t percentile(double quantile) const;
+
+    uint64_t min() const;
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+    double mean() const;
+
+private:
+    static size_t bucketIndex(uint64_t value);
+    static uint64_t bucketLower(size_t index);
+    static uint64_t bucketUpper(size_t index);
+
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> min_{UINT64_MAX};
+    std::atomic<uint64_t> max_{0};
+};
+
+/**
+ * @brief 直方图摘要
+ */
+struct HistogramSummary {
+    std::string name;
+    uint64_t count = 0;
+    uint64_t min = 0;
+    uint64_t max = 0;
+    double mean = 0.0;
+    uint64_t p50 = 0;
+    uint64_t p90 = 0;
+    uint64_t p99 = 0;
+};
+
+/**
+ * @brief 指标快照
+ */
+struct MetricsSnapshot {
+    std::vector<HistogramSummary> histograms;
+    std::vector<std::pair<std::string, int64_t>> counters;
+};
+
+/**
+ * @brief 进程内指标注册表
+ *
+ * histogram()/counter() 首次调用时创建指标，返回的引用在进程生命周期内有效。
+ * 查找需要加锁，实时路径应在初始化时取得引用并缓存
+ */
+class MetricsRegistry {
+public:
+    static MetricsRegistry& instance();
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    LatencyHistogram& histogram(const std::string& name);
+    std::atomic<int64_t>& counter(const std::string& name);
+
+    MetricsSnapshot snapshot() const;
+
+    /**
+     * @brief 格式化为多行文本报告
+     */
+    std::string formatReport() const;
+
+    /**
+     * @brief 清零全部指标（指标本身保留，已缓存的引用仍然有效）
+     */
+    void reset();
+
+    /**
+     * @brief 启动后台线程，按周期把报告输出到标准输出（重复调用只更新周期）
+     */
+    void startPeriodicDump(int intervalMs);
+    void stopPeriodicDump();
+
+private:
+    MetricsRegistry() = default;
+    ~MetricsRegistry();
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<LatencyHistogram>> histograms_;
+    std::map<std::string, std::unique_ptr<std::atomic<int64_t>>> counters_;
+
+    std::mutex dumpMutex_;
+    std::condition_variable dumpCv_;
+    std::thread dumpThread_;
+    bool dumpRunning_ = false;
+    int dumpIntervalMs_ = 0;
+};
+
+/**
+ * @brief 按语句统计端到端延迟
+ *
+ * 语句从“上一条语句确定（definite）或会话开始后发出的第一个音频包”算起，
+ * 收到该语句第一条非空识别文本时记录 mic → 首个部分结果的延迟
+ */
+class UtteranceLatencyTracker {
+public:
+    UtteranceLatencyTracker();
+
+    /**
+     * @brief 新会话开始，丢弃未完成的语句
+     */
+    void reset();
+
+    /**
+     * @brief 一个音频包已发出
+     * @param captureNs 包内最早样本的采集时间（0 表示未知，不计入统计）
+     */
+    void onPacketSent(int64_t captureNs);
+
+    /**
+     * @brief 收到识别结果
+     * @param hasText 结果中是否有非空文本
+     * @param definite 是否为确定结果（语句结束）
+     */
+    void onResult(bool hasText, bool definite);
+
+private:
+    std::mutex mutex_;
+    int64_t utteranceStartNs_ = 0;
+    bool partialReported_ = false;
+
+    LatencyHistogram& micToPacket_;
+    LatencyHistogram& micToFirstPartial_;
+    std::atomic<int64_t>& packetsSent_;
+    std::atomic<int64_t>& utterances_;
+};
+
+} // namespace audio
+} // namespace perfx
@@ -0,0 +1,325 @@
+#pragma once
+
+#include "audio_types.h"
+#include "dsp_kernels.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace perfx {
+namespace audio {
+
+/**
+ * @brief 编译期采样格式特征
+ *
+ * 采集链路中与格式相关的代码按 <格式, 声道布局> 实例化，流打开时选定一次实例，
+ * 之后经函数指针调用，内层循环中不再按 SampleFormat / ChannelCount 分支
+ */
+template <SampleFormat F>
+struct SampleTraits;
+
+template <>
+struct SampleTraits<SampleFormat::INT16> {
+    using Storage = int16_t;
+    static constexpr size_t kBytes = 2;
+    static constexpr bool kIsFloat = false;
+    static constexpr const char* kName = "int16";
+};
+
+/**
+ * INT24 为 3 字节小端紧凑格式（与 PortAudio paInt24 一致），按字节访问
+ */
+template <>
+struct SampleTraits<SampleFormat::INT24> {
+    using Storage = uint8_t;
+    static constexpr size_t kBytes = 3;
+    static constexpr bool kIsFloat = false;
+    static constexpr const char* kName = "int24";
+};
+
+template <>
+struct SampleTraits<SampleFormat::INT32> {
+    using Storage = int32_t;
+    static constexpr size_t kBytes = 4;
+    static constexpr bool kIsFloat = false;
+    static constexpr const char* kName = "int32";
+};
+
+template <>
+struct SampleTraits<SampleFormat::FLOAT32> {
+    using Storage = float;
+    static constexpr size_t kBytes = 4;
+    static constexpr bool kIsFloat = true;
+    static constexpr const char* kName = "float32";
+};
+
+template <>
+struct SampleTraits<SampleFormat::FLOAT64> {
+    using Storage = double;
+    static constexpr size_t kBytes = 8;
+    static constexpr bool kIsFloat = true;
+    static constexpr const char* kName = "float64";
+};
+
+/**
+ * @brief 编译期声道布局，N 为 0 表示声道数在运行时给出（多于两声道的设备）
+ */
+template <int N>
+struct ChannelLayout {
+    static_assert(N >= 0, "channel count must be non-negative");
+    static constexpr int kChannels = N;
+
+    static constexpr int count(int runtimeChannels) {
+        return N == 0 ? runtimeChannels : N;
+    }
+};
+
+using MonoLayout = ChannelLayout<1>;
+using StereoLayout = ChannelLayout<2>;
+using DynamicLayout = ChannelLayout<0>;
+
+/**
+ * @brief 每个样本的字节数（FLOAT64 以外均为 PortAudio 支持的格式）
+ */
+constexpr size_t bytesPerSample(SampleFormat format) {
+    switch (format) {
+        case SampleFormat::INT16: return SampleTraits<SampleFormat::INT16>::kBytes;
+        case SampleFormat::INT24: return SampleTraits<SampleFormat::INT24>::kBytes;
+        case SampleFormat::INT32: return SampleTraits<SampleFormat::INT32>::kBytes;
+        case SampleFormat::FLOAT32: return SampleTraits<SampleFormat::FLOAT32>::kBytes;
+        case SampleFormat::FLOAT64: return SampleTraits<SampleFormat::FLOAT64>::kBytes;
+    }
+    return 0;
+}
+
+constexpr const char* sampleFormatName(SampleFormat format) {
+    switch (format) {
+        case SampleFormat::INT16: return SampleTraits<SampleFormat::INT16>::kName;
+        case SampleFormat::INT24: return SampleTraits<SampleFormat::INT24>::kName;
+        case SampleFormat::INT32: return SampleTraits<SampleFormat::INT32>::kName;
+        case SampleFormat::FLOAT32: return SampleTraits<SampleFormat::FLOAT32>::kName;
+        case SampleFormat::FLOAT64: return SampleTraits<SampleFormat::FLOAT64>::kName;
+    }
+    return "unknown";
+}
+
+// ============================================================================
+// 块转换内核（编译期选择 dsp 内核，交织样本）
+// ============================================================================
+
+namespace pipeline {
+
+constexpr size_t kChunkSamples = 2048;      ///< 需要中间浮点缓冲时每段的样本数（栈上）
+
+template <SampleFormat F>
+void toFloat(const void* in, float* out, size_t samples) {
+    if constexpr (F == SampleFormat::INT16) {
+        dsp::int16ToFloat(static_cast<const int16_t*>(in), out, samples);
+    } else if constexpr (F == SampleFormat::INT24) {
+        dsp::int24ToFloat(static_cast<const uint8_t*>(in), out, samples);
+    } else if constexpr (F == SampleFormat::INT32) {
+        dsp::int32ToFloat(static_cast<const int32_t*>(in), out, samples);
+    } else if constexpr (F == SampleFormat::FLOAT32) {
+        if (in != out) {
+            std::memcpy(out, in, samples * sizeof(float));
+        }
+    } else {
+        dsp::doubleToFloat(static_cast<const double*>(in), out, samples);
+    }
+}
+
+template <SampleFormat F>
+void fromFloat(const float* in, void* out, size_t samples) {
+    if constexpr (F == SampleFormat::INT16) {
+        dsp::floatToInt16(in, static_cast<int16_t*>(out), samples);
+    } else if constexpr (F == SampleFormat::INT24) {
+        dsp::floatToInt24(in, static_cast<uint8_t*>(out), samples);
+    } else if constexpr (F == SampleFormat::INT32) {
+        dsp::floatToInt32(in, static_cast<int32_t*>(out), samples);
+    } else if constexpr (F == SampleFormat::FLOAT32) {
+        if (in != out) {
+            std::memcpy(out, in, samples * sizeof(float));
+        }
+    } else {
+        dsp::floatToDouble(in, static_cast<double*>(out), samples);
+    }
+}
+
+/**
+ * @brief 转为 INT16（声道数不变），用于 Opus 编码等只接受 16 位的下游
+ */
+template <SampleFormat F>
+void toInt16(const void* in, int16_t* out, size_t samples) {
+    if constexpr (F == SampleFormat::INT16) {
+        if (in != out) {
+            std::memcpy(out, in, samples * sizeof(int16_t));
+        }
+    } else if constexpr (F == SampleFormat::FLOAT32) {
+        dsp::floatToInt16(static_cast<const float*>(in), out, samples);
+    } else {
+        float chunk[kChunkSamples];
+        const uint8_t* src = static_cast<const uint8_t*>(in);
+        while (samples > 0) {
+            const size_t n = samples < kChunkSamples ? samples : kChunkSamples;
+            toFloat<F>(src, chunk, n);
+            dsp::floatToInt16(chunk, out, n);
+            src += n * SampleTraits<F>::kBytes;
+            out += n;
+            samples -= n;
+        }
+    }
+}
+
+/**
+ * @brief 混缩为单声道浮点（各声道取平均）
+ */
+template <SampleFormat F, class Layout>
+void toMonoFloat(const void* in, float* out, size_t frames, int runtimeChannels) {
+    const int channels = Layout::count(runtimeChannels);
+    if constexpr (Layout::kChannels == 1) {
+        toFloat<F>(in, out, frames);
+    } else if constexpr (F == SampleFormat::FLOAT32) {
+        dsp::downmixToMono(static_cast<const float*>(in), out, channels, frames);
+    } else {
+        float chunk[kChunkSamples];
+        const size_t chunkFrames = kChunkSamples / static_cast<size_t>(channels);
+        const uint8_t* src = static_cast<const uint8_t*>(in);
+        while (frames > 0) {
+            const size_t n = frames < chunkFrames ? frames : chunkFrames;
+            toFloat<F>(src, chunk, n * channels);
+            dsp::downmixToMono(chunk, out, channels, n);
+            src += n * channels * SampleTraits<F>::kBytes;
+            out += n;
+            frames -= n;
+        }
+    }
+}
+
+/**
+ * @brief 混缩为单声道 INT16（ASR 输入格式）
+ */
+template <SampleFormat F, class Layout>
+void toMonoInt16(const void* in, int16_t* out, size_t frames, int runtimeChannels) {
+    const int channels = Layout::count(runtimeChannels);
+    if constexpr (F == SampleFormat::INT16) {
+        if constexpr (Layout::kChannels == 1) {
+            toInt16<F>(in, out, frames);
+        } else {
+            dsp::downmixToMono(static_cast<const int16_t*>(in), out, channels, frames);
+        }
+    } else if constexpr (Layout::kChannels == 1) {
+        toInt16<F>(in, out, frames);
+    } else {
+        float chunk[kChunkSamples];
+        const size_t chunkFrames = kChunkSamples / static_cast<size_t>(channels);
+        const uint8_t* src = static_cast<const uint8_t*>(in);
+        while (frames > 0) {
+            const size_t n = frames < chunkFrames ? frames : chunkFrames;
+            toMonoFloat<F, Layout>(src, chunk, n, channels);
+            dsp::floatToInt16(chunk, out, n);
+            src += n * channels * SampleTraits<F>::kBytes;
+            out += n;
+            frames -= n;
+        }
+    }
+}
+
+/**
+ * @brief 将 NaN/Inf 替换为 0（整数格式无需处理）
+ * @return 被替换的样本数
+ */
+template <SampleFormat F>
+size_t scrub(void* data, size_t samples) {
+    if constexpr (F == SampleFormat::FLOAT32) {
+        return dsp::scrubNonFinite(static_cast<float*>(data), samples);
+    } else if constexpr (F == SampleFormat::FLOAT64) {
+        double* values = static_cast<double*>(data);
+        size_t replaced = 0;
+        for (size_t i = 0; i < samples; ++i) {
+            if (!std::isfinite(values[i])) {
+                values[i] = 0.0;
+                ++replaced;
+            }
+        }
+        return replaced;
+    } else {
+        (void)data;
+        (void)samples;
+        return 0;
+    }
+}
+
+} // namespace pipeline
+
+// ============================================================================
+// 运行时入口：按流格式选定一次的转换函数表
+// ============================================================================
+
+/**
+ * @brief 某一 <格式, 声道数> 的转换函数表
+ *
+ * 由 create() 在打开流 / 更新配置时选定模板实例；单声道与立体声各有专门实例，
+ * 其他声道数使用运行时声道数的实例
+ */
+struct SampleConverter {
+    using ToFloatFn = void (*)(const void* in, float* out, size_t samples);
+    using FromFloatFn = void (*)(const float* in, void* out, size_t samples);
+    using ToInt16Fn = void (*)(const void* in, int16_t* out, size_t samples);
+    using ToMonoFloatFn = void (*)(const void* in, float* out, size_t frames, int channels);
+    using ToMonoInt16Fn = void (*)(const void* in, int16_t* out, size_t frames, int channels);
+    using ScrubFn = size_t (*)(void* data, size_t samples);
+
+    SampleFormat format = SampleFormat::INT16;
+    int channels = 1;
+    size_t bytesPerFrame = 2;
+
+    // 默认构造为单声道 INT16
+    ToFloatFn toFloat = &pipeline::toFloat<SampleFormat::INT16>;        ///< 交织样本 → 浮点（声道数不变）
+    FromFloatFn fromFloat = &pipeline::fromFloat<SampleFormat::INT16>;  ///< 浮点 → 交织样本
+    ToInt16Fn toInt16 = &pipeline::toInt16<SampleFormat::INT16>;        ///< 交织样本 → INT16（声道数不变）
+    ScrubFn scrub = &pipeline::scrub<SampleFormat::INT16>;              ///< 清洗 NaN/Inf，返回替换数
+
+    static SampleConverter create(SampleFormat format, int channels);
+
+    /**
+     * @brief 是否已经是单声道 INT16（ASR 可直接使用，无需转换）
+     */
+    bool isMonoInt16() const { return format == SampleFormat::INT16 && channels == 1; }
+
+    void toMonoFloat(const void* in, float* out, size_t frames) const {
+        toMonoFloatFn_(in, out, frames, channels);
+    }
+
+    void toMonoInt16(const void* in, int16_t* out, size_t frames) const {
+        toMonoInt16Fn_(in, out, frames, channels);
+    }
+
+private:
+    ToMonoFloatFn toMonoFloatFn_ = &pipeline::toMonoFloat<SampleFormat::INT16, MonoLayout>;
+    ToMonoInt16Fn toMonoInt16Fn_ = &pipeline::toMonoInt16<SampleFormat::INT16, MonoLayout>;
+
+    template <SampleFormat F, class Layout>
+    static SampleConverter make(int channels);
+
+    template <SampleFormat F>
+    static SampleConverter forChannels(int channels);
+};
+
+template <SampleFormat F, class Layout>
+SampleConverter SampleConverter::make(int channels) {
+    SampleConverter converter;
+    converter.format = F;
+    converter.channels = Layout::count(channels);
+    converter.bytesPerFrame = SampleTraits<F>::kBytes * static_cast<size_t>(converter.channels);
+    converter.toFloat = &pipeline::toFloat<F>;
+    converter.fromFloat = &pipeline::fromFloat<F>;
+    converter.toInt16 = &pipeline::toInt16<F>;
+    converter.scrub = &pipeline::scrub<F>;
+    converter.toMonoFloatFn_ = &pipeline::toMonoFloat<F, Layout>;
+    converter.toMonoInt16Fn_ = &pipeline::toMonoInt16<F, Layout>;
+    return converter;
+}
+
+} // namespace audio
+} // namespace perfx
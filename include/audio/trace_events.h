@@ -0,0 +1,163 @@
+#pragma once
+
+#include "latency_metrics.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace perfx {
+namespace audio {
+
+/**
+ * @brief 跨线程事件追踪
+ *
+ * 采集回调、消费者、ASR 发送 / 网络线程与界面线程各自把事件追加到线程私有的
+ * 事件块中（单写者，无锁；每 4096 个事件在分配新块时加一次锁），导出为
+ * Chrome trace JSON（chrome://tracing 与 ui.perfetto.dev 均可直接打开）。
+ *
+ * 未启用时每个追踪点只有一次 relaxed 原子读和一个分支。事件名必须是字符串
+ * 字面量（只保存指针）。
+ *
+ * 流事件（flow）用同一个 id 把不同线程上的步骤连成箭头。采集路径以音频块的
+ * 采集时间（metrics::nowNs 时基）作为 id：设备回调 → 消费者 → ASR 发包 →
+ * 收到识别结果 → 界面刷新，各环节都能拿到这批数据的采集时间，无需额外传递。
+ */
+namespace trace {
+
+constexpr size_t kDefaultMaxEvents = size_t{1} << 20;   ///< 默认事件上限（约 32 MB），超出后丢弃并计数
+
+namespace detail {
+extern std::atomic<bool> g_enabled;
+
+void recordSlice(const char* name, int64_t beginNs, int64_t endNs);
+void recordInstant(const char* name);
+void recordCounter(const char* name, int64_t value);
+void recordFlow(const char* name, uint64_t id, char phase);
+void setThreadName(const char* name);
+} // namespace detail
+
+/**
+ * @brief 追踪是否启用（热路径上唯一的开销）
+ */
+inline bool enabled() {
+    return detail::g_enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief 清空已有事件并开始记录
+ * @param maxEvents 事件总数上限
+ */
+void start(size_t maxEvents = kDefaultMaxEvents);
+
+/**
+ * @brief 停止记录（已记录的事件保留，可继续导出）
+ */
+void stop();
+
+/**
+ * @brief 丢弃已记录的事件
+ */
+void clear();
+
+/**
+ * @brief 追踪统计
+ */
+struct TraceStats {
+    uint64_t events = 0;        ///< 已记录事件数
+    uint64_t dropped = 0;       ///< 超出上限被丢弃的事件数
+    size_t threads = 0;         ///< 产生过事件的线程数
+};
+
+TraceStats stats();
+
+/**
+ * @brief 导出为 Chrome trace JSON（可在记录过程中调用，得到调用时刻的快照）
+ */
+bool writeChromeTrace(const std::string& path, std::string& error);
+
+/**
+ * @brief 按 PERFX_TRACE=<文件> 启动追踪
+ * @return 环境变量已设置时返回输出路径，否则返回空串
+ */
+std::string startFromEnv();
+
+/**
+ * @brief 设置当前线程在追踪中显示的名称（未启用时无开销，可在回调中每次调用）
+ */
+inline void setThreadName(const char* name) {
+    if (enabled()) detail::setThreadName(name);
+}
+
+/**
+ * @brief 已完成的时间片（beginNs / endNs 为 metrics::nowNs 时基）
+ */
+inline void slice(const char* name, int64_t beginNs, int64_t endNs) {
+    if (enabled()) detail::recordSlice(name, beginNs, endNs);
+}
+
+inline void instant(const char* name) {
+    if (enabled()) detail::recordInstant(name);
+}
+
+inline void counter(const char* name, int64_t value) {
+    if (enabled()) detail::recordCounter(name, value);
+}
+
+/**
+ * @brief 流事件：起点 / 中间步骤 / 终点，id 为 0 时忽略
+ */
+inline void flowBegin(const char* name, uint64_t id) {
+    if (enabled() && id != 0) detail::recordFlow(name, id, 's');
+}
+
+inline void flowStep(const char* name, uint64_t id) {
+    if (enabled() && id != 0) detail::recordFlow(name, id, 't');
+}
+
+inline void flowEnd(const char* name, uint64_t id) {
+    if (enabled() && id != 0) detail::recordFlow(name, id, 'f');
+}
+
+/**
+ * @brief 设置 / 读取本线程当前处理的流 id
+ *
+ * 跨模块传递流 id 而不改动调用签名（与 metrics::setCurrentCaptureTime 同理），
+ * 例如发包前设置，AsrClient 在发送时读取并关联到之后的识别结果
+ */
+void setCurrentFlow(uint64_t id);
+uint64_t currentFlow();
+
+/**
+ * @brief 作用域时间片，析构时记录
+ */
+class Scope {
+public:
+    explicit Scope(const char* name)
+        : name_(enabled() ? name : nullptr), beginNs_(name_ ? metrics::nowNs() : 0) {}
+
+    ~Scope() {
+        if (name_) detail::recordSlice(name_, beginNs_, metrics::nowNs());
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* name_;
+    int64_t beginNs_;
+};
+
+} // namespace trace
+
+} // namespace audio
+} // namespace perfx
+
+#define PERFX_TRACE_CONCAT_INNER(a, b) a##b
+#define PERFX_TRACE_CONCAT(a, b) PERFX_TRACE_CONCAT_INNER(a, b)
+
+/**
+ * @brief 追踪当前作用域：PERFX_TRACE_SCOPE("audio.callback");
+ */
+#define PERFX_TRACE_SCOPE(name) \
+    ::perfx::audio::trace::Scope PERFX_TRACE_CONCAT(perfxTraceScope_, __LINE__)(name)
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "audio_types.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace perfx {
+namespace audio {
+
+/**
+ * @brief 虚拟输入设备的时钟
+ */
+enum class VirtualClock {
+    Realtime,       ///< 按采样率（乘以 speed 倍速）定时回调，模拟真实声卡
+    FreeRunning     ///< 不等待，尽快产生下一个缓冲（吞吐压测，下游跟不上时由环形缓冲丢弃并计数）
+};
+
+/**
+ * @brief 虚拟输入设备配置
+ *
+ * 虚拟设备回放 WAV 文件或信号生成器，经 AudioDevice 以配置的 framesPerBuffer 回调，
+ * 用于没有麦克风的 CI / 服务器上复现实时链路的负载与时序
+ */
+struct VirtualDeviceConfig {
+    std::string name;                   ///< 设备名称，空时按来源生成（"Virtual: <来源>"）
+    std::string source = "speech";      ///< WAV 文件路径，或生成器：speech / sine[:HZ] / noise / silence
+    VirtualClock clock = VirtualClock::Realtime;
+    double speed = 1.0;                 ///< Realtime 时钟的倍速（>1 加速回放）
+    bool loop = true;                   ///< 文件播完后从头循环；否则播完即停止回调
+    double jitterMs = 0.0;              ///< 每次回调在标称时间之后随机延迟 0~jitterMs 毫秒
+    double xrunRate = 0.0;              ///< 每个缓冲发生上溢的概率：丢弃该缓冲，下一次回调报告 xrun
+    uint32_t seed = 1;                  ///< 抖动 / xrun / 噪声的随机种子，相同种子结果可复现
+    int sampleRate = 16000;             ///< 生成器的标称采样率（文件来源取文件采样率）
+    int channels = 1;                   ///< 生成器的通道数（文件来源取文件通道数）
+};
+
+/**
+ * @brief 虚拟设备索引从此值开始，与 PortAudio 设备索引区分
+ */
+constexpr int kVirtualDeviceIndexBase = 1000;
+
+/**
+ * @brief 虚拟设备的宿主 API 名称（DeviceInfo::hostApi）
+ */
+constexpr const char* kVirtualHostApi = "Virtual";
+
+/**
+ * @brief 解析设备描述串：<来源>[,key=value...]
+ *
+ * key：name、clock=realtime|free、speed、loop=0|1、jitter（毫秒）、xrun（概率）、seed、rate、channels。
+ * 例：sample/38s.wav,speed=4,jitter=2,xrun=0.01
+ */
+bool parseVirtualDeviceSpec(const std::string& spec, VirtualDeviceConfig& config, std::string& error);
+
+/**
+ * @brief 生成虚拟设备的 DeviceInfo（文件来源读取 WAV 头获取采样率与通道数）
+ * @param index 设备索引（由 DeviceRegistry 分配）
+ */
+bool describeVirtualDevice(const VirtualDeviceConfig& config, int index, DeviceInfo& device, std::string& error);
+
+/**
+ * @brief 虚拟采集流
+ *
+ * 打开时把来源转换为请求的采样率 / 通道数，启动后在独立线程中按时钟产生
+ * framesPerBuffer 帧的缓冲，并转换为请求的采样格式（INT16 / INT24 / INT32 / FLOAT32）
+ */
+class VirtualInputStream {
+public:
+    /**
+     * @param input 交织采样数据（AudioConfig::format 格式）
+     * @param frameCount 帧数
+     * @param xrun 自上次回调以来发生过上溢（有缓冲被丢弃）
+     * @param captureNs 首样本的标称采集时间（metrics::nowNs 时基）
+     */
+    using Callback = std::function<void(const void* input, size_t frameCount, bool xrun, int64_t captureNs)>;
+
+    VirtualInputStream(const VirtualDeviceConfig& device, const AudioConfig& config);
+    ~VirtualInputStream();
+
+    VirtualInputStream(const VirtualInputStream&) = delete;
+    VirtualInputStream& operator=(const VirtualInputStream&) = delete;
+
+    /**
+     * @brief 加载来源并校验配置
+     */
+    bool open(std::string& error);
+
+    bool start(Callback callback);
+    void stop();
+
+    /**
+     * @brief 回调线程运行中且来源未播完
+     */
+    bool isActive() const;
+
+    uint64_t getFramesDelivered() const;
+    uint64_t getXrunCount() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace audio
+} // namespace perfx
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace perfx {
+namespace audio {
+
+/**
+ * @brief 静音段处理方式
+ */
+enum class VadMode {
+    SUPPRESS,   ///< 完全丢弃静音段
+    COMPRESS    ///< 每段静音最多保留 maxSilenceMs，让服务端仍能看到句子边界
+};
+
+/**
+ * @brief VAD 配置
+ */
+struct VadConfig {
+    int sampleRate = 16000;             ///< 输入采样率（单声道 INT16）
+    int frameMs = 10;                   ///< 分析帧长(ms)
+    VadMode mode = VadMode::COMPRESS;   ///< 静音段处理方式
+    int hangoverMs = 300;               ///< 语音结束后继续发送的时长，避免截断尾音
+    int preRollMs = 200;                ///< 语音起点前补发的时长，避免截断词首
+    int maxSilenceMs = 600;             ///< COMPRESS 模式下每段静音保留的时长
+
+    float energyThresholdDb = -45.0f;   ///< 固定能量门限(dBFS)，低于此值一律视为静音
+    float zcrMax = 0.45f;               ///< 过零率上限，超过视为宽带噪声
+
+    // 统计模型：自适应噪声底估计，门限 = 噪声底 + speechMarginDb
+    bool adaptiveNoiseFloor = true;     ///< 是否启用自适应噪声底
+    float speechMarginDb = 9.0f;        ///< 语音需高出噪声底的分贝数
+    float noiseFloorRiseDb = 0.05f;     ///< 每帧噪声底最大上升量（慢升）
+    float noiseFloorFallAlpha = 0.2f;   ///< 能量低于噪声底时的跟随系数（快降）
+};
+
+/**
+ * @brief VAD 统计信息
+ */
+struct VadStats {
+    uint64_t inputSamples = 0;      ///< 输入样本数
+    uint64_t outputSamples = 0;     ///< 实际发送的样本数
+    uint64_t speechFrames = 0;      ///< 判定为语音的帧数
+    uint64_t silenceFrames = 0;     ///< 判定为静音的帧数
+    float noiseFloorDb = 0.0f;      ///< 当前噪声底估计
+};
+
+/**
+ * @brief 客户端语音活动检测
+ *
+ * 位于 ASR 发送前的消费阶段：按帧计算能量与过零率判断语音，
+ * 丢弃或压缩静音段，并在语音起止处保留 pre-roll / hangover。
+ *
+ * 由于发送的音频不再与采集时间线一一对应，检测器记录“输出样本 → 输入样本”
+ * 的偏移映射，用于把服务端返回的时间戳还原到采集时间线
+ */
+class VoiceActivityDetector {
+public:
+    explicit VoiceActivityDetector(const VadConfig& config = VadConfig());
+
+    /**
+     * @brief 重置状态（新会话开始时调用）
+     */
+    void reset();
+
+    /**
+     * @brief 处理一段采集音频
+     * @param samples 单声道 INT16 样本
+     * @param count 样本数
+     * @param out 追加需要发送的样本（不清空）
+     * @return 本次追加的样本数
+     */
+    size_t process(const int16_t* samples, size_t count, std::vector<int16_t>& out);
+
+    /**
+     * @brief 将发送流中的时间映射回采集时间线（线程安全）
+     * @param outputMs 服务端返回的时间戳(ms)
+     * @return 采集时间线上的时间戳(ms)
+     */
+    int64_t mapOutputToInputMs(int64_t outputMs) const;
+
+    /**
+     * @brief 丢弃在 outputMs 之前结束的映射段（线程安全）
+     * @details 映射表按发送段增长，调用方确认该时间之前的结果都已定稿并映射后调用；
+     *          之后只保证不早于 outputMs 的时间映射正确
+     */
+    void discardMappingBefore(int64_t outputMs);
+
+    /**
+     * @brief 当前是否处于语音段（含 hangover）
+     */
+    bool isSpeechActive() const { return inSpeech_; }
+
+    VadStats getStats() const;
+    const VadConfig& getConfig() const { return config_; }
+
+private:
+    struct OffsetSegment {
+        int64_t outputStart;    ///< 发送流中的起始样本
+        int64_t inputStart;     ///< 采集时间线中的起始样本
+    };
+
+    bool classifyFrame(const int16_t* frame);
+    void emitSamples(const int16_t* samples, size_t count, int64_t inputPos, std::vector<int16_t>& out);
+    void flushPreRoll(std::vector<int16_t>& out);
+
+    VadConfig config_;
+    size_t frameSamples_;
+    int hangoverFrames_;
+    size_t preRollCapacity_;
+    size_t maxSilenceSamples_;
+
+    // 不足一帧的残留样本
+    std::vector<int16_t> pending_;
+
+    // pre-roll 环形缓冲（只保存尚未发送的、与当前帧相邻的样本）
+    std::vector<int16_t> preRoll_;
+    size_t preRollHead_ = 0;
+    size_t preRollSize_ = 0;
+
+    bool inSpeech_ = false;
+    int hangoverLeft_ = 0;
+    size_t silenceEmitted_ = 0;
+    float noiseFloorDb_;
+
+    int64_t inputPos_ = 0;          ///< 下一个待分析样本在采集时间线中的位置
+    int64_t outputPos_ = 0;         ///< 已发送样本数
+    int64_t nextContiguous_ = -1;   ///< 紧接上次发送的输入位置
+
+    mutable std::mutex mapMutex_;
+    std::vector<OffsetSegment> segments_;
+    VadStats stats_;
+};
+
+} // namespace audio
+} // namespace perfx
@@ -0,0 +1,124 @@
+//
+// 字幕广播服务器
+//
+// 把实时转录结果推送给大量观看端（浏览器 / 大屏）。基于 ix::HttpServer，同一端口提供：
+//   - WebSocket 订阅：ws://host:port/captions?since=<seq>
+//   - HTTP 查询：GET /transcript[?since=<seq>]、GET /stats
+//
+// 每次结果变化只序列化一次，生成带序号的共享帧（shared_ptr）追加到历史环中。每个订阅者
+// 只记录已发送的序号，其发送队列就是历史末尾 clientQueueFrames 帧，发布方（ASR 回调线程）
+// 的开销与订阅者数无关，也不触碰套接字。发送由一组发送线程完成，每个订阅者同一时刻最多
+// 占用一个发送线程；对端不读取导致发送阻塞时只占住该线程，超过 sendStallTimeoutMs 后断开。
+// 落后超过队列上限的客户端跳过积压帧，改发最新快照（drop-to-latest）。
+// 新加入或断线重连的客户端可携带上次收到的序号，在队列窗口内补发增量，否则发送快照。
+//
+// 帧格式（JSON 文本）：
+//   {"type":"snapshot","seq":N,"ts_us":T,"count":C,"final":false,"utterances":[{"index":0,...}, ...]}
+//   {"type":"delta","seq":N,"ts_us":T,"count":C,"final":false,"utterances":[{"index":i,...}]}
+// delta 只包含变化的分句；count 为当前分句总数，客户端据此截断多余分句。
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "asr/transcription_cache.h"
+
+namespace perfx {
+namespace logic {
+
+/**
+ * @brief 字幕广播服务器配置
+ */
+struct CaptionServerConfig {
+    std::string host = "127.0.0.1";       ///< 监听地址，局域网观看时设为 0.0.0.0
+    int port = 8765;                      ///< 监听端口
+    size_t maxClients = 4096;             ///< 最大连接数（ix 每个连接一个线程）
+    size_t clientQueueFrames = 64;        ///< 单个客户端待发送帧上限，超出后改发快照（也是续传窗口）
+    size_t historyFrames = 1024;          ///< GET /transcript?since= 可查询的历史帧数
+    int senderThreads = 4;                ///< 发送线程数，应多于可能同时阻塞的客户端数
+    int sendStallTimeoutMs = 2000;        ///< 单次发送阻塞超过此时长视为客户端失联并断开
+};
+
+/**
+ * @brief 共享字幕帧（序列化一次，所有订阅者共享）
+ */
+struct CaptionFrame {
+    uint64_t seq = 0;
+    bool snapshot = false;
+    std::string payload;
+};
+
+using CaptionFramePtr = std::shared_ptr<const CaptionFrame>;
+
+/**
+ * @brief 字幕广播统计
+ */
+struct CaptionServerStats {
+    size_t clients = 0;               ///< 当前订阅者数
+    uint64_t lastSeq = 0;             ///< 最新帧序号
+    uint64_t framesPublished = 0;     ///< 生成的增量帧数
+    uint64_t framesSent = 0;          ///< 交付给连接的帧数（全部客户端累计）
+    uint64_t framesDropped = 0;       ///< 落后超过队列上限而跳过的帧数
+    uint64_t snapshotsSent = 0;       ///< 发送的快照数（新连接 + 溢出 + 续传超出窗口）
+    uint64_t resumes = 0;             ///< 在队列窗口内完成的续传次数
+    uint64_t stalledDisconnects = 0;  ///< 因发送阻塞被断开的客户端数
+};
+
+/**
+ * @brief 字幕广播服务器
+ *
+ * publish()/reset() 线程安全，可在 ASR 回调线程中直接调用
+ */
+class CaptionServer {
+public:
+    explicit CaptionServer(const CaptionServerConfig& config = CaptionServerConfig());
+    ~CaptionServer();
+
+    CaptionServer(const CaptionServer&) = delete;
+    CaptionServer& operator=(const CaptionServer&) = delete;
+
+    /**
+     * @brief 开始监听
+     * @param error 失败原因
+     */
+    bool start(std::string& error);
+
+    /**
+     * @brief 断开全部客户端并停止监听
+     */
+    void stop();
+
+    bool isRunning() const;
+
+    /**
+     * @brief 发布当前完整结果，与上次发布的结果比较后生成增量帧
+     * @param utterances 当前全部分句（时间为采集时间线）
+     * @param final 会话是否已结束
+     * @return 新帧序号，结果无变化时返回 0
+     */
+    uint64_t publish(const std::vector<Asr::CachedUtterance>& utterances, bool final = false);
+
+    /**
+     * @brief 开始新的转录（清空结果与历史，客户端收到空快照）
+     */
+    void reset();
+
+    /**
+     * @brief 最新快照帧（按序号缓存，多个请求共享同一份序列化结果）
+     */
+    CaptionFramePtr getSnapshot() const;
+
+    CaptionServerStats getStats() const;
+    const CaptionServerConfig& getConfig() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace logic
+} // namespace perfx
@@ -4,11 +4,18 @@
 #include <QTimer>
 #include <QString>
 #include <QVector>
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <vector>
 #include <mutex>
+#include <thread>
 #include "audio/audio_manager.h"
+#include "audio/voice_activity_detector.h"
+#include "audio/latency_metrics.h"
 #include "asr/asr_manager.h"
+#include "asr/transcript_stitcher.h"
+#include "logic/caption_server.h"
 
 namespace perfx {
 namespace logic {
@@ -76,6 +83,19 @@ public:
     // 新增：清理和重置ASR状态
     void resetAsrState();
     
+    // 客户端VAD：发送前丢弃/压缩静音段（默认开启，环境变量 ASR_CLIENT_VAD=0 关闭）
+    void setClientVadEnabled(bool enabled);
+    bool isClientVadEnabled() const { return clientVadEnabled_; }
+    
+    // 将服务端返回的时间戳（相对已发送音频）映射回采集时间线
+    qint64 mapAsrTimeMs(qint64 asrTimeMs) const;
+    
+    // 记录识别结果到达，用于统计 mic → 首个部分结果延迟（ASR 回调线程调用）
+    void recordAsrResultLatency(bool hasText, bool definite);
+    
+    // 处理某个识别会话的分句结果，拼接各会话后发出 asrUtterancesUpdated（ASR 回调线程调用）
+    void handleAsrUtterances(const Asr::AsrClient* client, const std::string& message);
+    
     // 转录文本管理
     void setCumulativeTranscriptionText(const QString& text) { cumulativeTranscriptionText_ = text; }
     QString getCumulativeTranscriptionText() const { return cumulativeTranscriptionText_; }
@@ -113,6 +133,13 @@ private:
     // 实时ASR相关方法
     void processAsrAudio(const void* data, size_t frameCount);
     bool sendAsrAudioPacket(const std::vector<uint8_t>& audioData, bool isLast);
+    
+    // 会话无缝切换（先建后断）
+    void updateSessionRollover(bool primaryLost = false);
+    void finishDrainingSession(std::unique_ptr<Asr::AsrClient> client);
+    void stopSessionRollover();
+    void emitStitchedUtterances();
+    std::vector<Asr::CachedUtterance> mapStitchedUtterancesLocked(const std::vector<Asr::CachedUtterance>& merged);
 
     std::unique_ptr<audio::AudioManager> audioManager_;
     QTimer* waveformTimer_;  // 波形更新定时器
@@ -125,6 +152,7 @@ private:
 
     std::vector<audio::DeviceInfo> availableDevices_;
     int selectedDeviceId_ = -1;
+    int deviceListenerId_ = 0;  // DeviceRegistry 监听者 ID
 
     // 实时ASR状态
     bool realtimeAsrEnabled_ = false;
@@ -132,8 +160,52 @@ private:
     std::unique_ptr<RealtimeAsrCallback> realtimeAsrCallback_;
     std::mutex asrMutex_;
     std::vector<uint8_t> asrAudioBuffer_;
+    std::vector<uint8_t> asrPacketBuffer_;  // 发包缓冲（复用容量，稳态下发包不再分配）
     size_t asrBufferSize_ = 0;
-    static constexpr size_t ASR_PACKET_SIZE = 16000 * 2 * 100 / 1000; // 100ms @ 16kHz INT16
+    static constexpr int ASR_SAMPLE_RATE = 16000;  // 每包样本数由 AsrManager 的分包控制器决定
+    
+    // 客户端VAD
+    std::atomic<bool> clientVadEnabled_{true};  // 采集线程发送、ASR 回调线程映射时间时读取，界面线程修改
+    std::unique_ptr<audio::VoiceActivityDetector> asrVad_;
+    std::vector<int16_t> asrVadOutput_;
+    
+    // 输入流格式（设备打开后从 AudioManager 取得）；非单声道 INT16 时先混缩转换再送入 ASR
+    audio::SampleConverter inputConverter_;
+    std::vector<int16_t> asrMonoBuffer_;
+    
+    // 端到端延迟统计（mic → 发包、mic → 首个部分结果）
+    audio::UtteranceLatencyTracker asrLatency_;
+    int64_t asrBufferCaptureNs_ = 0;  // asrAudioBuffer_ 首样本的采集时间
+    
+    // 会话无缝切换：到期前建立新会话，重叠窗口内双发，旧会话定稿后关闭
+    enum class RolloverState { Idle, Opening, Overlap };
+    RolloverState rolloverState_ = RolloverState::Idle;
+    Asr::TranscriptStitcher asrStitcher_;
+    // 已定稿分句的缓存（按拼接结果中的位置）：映射到采集时间线后的结果与界面数据。
+    // asrUtterancesUpdated 只重建未定稿的分句；已定稿分句不再重新映射，VAD 映射表可随之裁剪
+    struct UtteranceMapCache {
+        bool definite = false;
+        std::string text;
+        qint64 rawStartMs = 0;          // 发送时间线上的时间（判断缓存是否仍对应同一分句）
+        qint64 rawEndMs = 0;
+        Asr::CachedUtterance mapped;    // 采集时间线上的分句（含词级时间）
+        QVariantMap map;                // 界面数据，首次发出时构建
+    };
+    std::vector<UtteranceMapCache> asrUtteranceMaps_;
+    std::mutex asrUtteranceMapsMutex_;
+    int64_t asrSentMs_ = 0;                                         // 已发送音频时长（VAD 输出时间线）
+    int64_t overlapStartMs_ = 0;                                    // 重叠窗口起点（发送时间线）
+    std::chrono::steady_clock::time_point asrSessionStart_;         // 当前主会话建立时间
+    std::chrono::steady_clock::time_point standbySessionStart_;     // 备用会话建立时间
+    std::chrono::steady_clock::time_point nextStandbyAttempt_;      // 备用会话建立失败后的重试时间
+    std::mutex standbyMutex_;
+    std::unique_ptr<Asr::AsrClient> pendingStandby_;                // 已就绪、尚未接入的备用会话
+    std::atomic<bool> standbyOpenDone_{false};
+    std::thread standbyOpenThread_;
+    std::thread sessionDrainThread_;
+    
+    // 字幕广播（未设置 PERFX_CAPTION_PORT 时为空）
+    std::unique_ptr<CaptionServer> captionServer_;
     
     // 录音统计
     size_t recordedBytes_ = 0;
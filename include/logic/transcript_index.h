@@ -0,0 +1,129 @@
+//
+// 转录全文索引
+//
+// 为全部录音的转录结果建立倒排索引，按关键词查找“哪段录音、哪个时间点”说过。
+//
+// 分词：中文（及日文假名、全角符号之外的 CJK 文字）按重叠二元组切分，每个连续 CJK 串的最后一个字
+// 额外作为单字词，因此任意单字查询都能通过“以该字开头的词”前缀匹配命中；标点与空白不打断 CJK 串
+// （ASR 自动加的标点不影响查询）。西文与数字按单词切分并转为小写，全角 ASCII 先转半角。
+// 查询串用同样的规则切分，按词位置做短语匹配。
+//
+// 存储：目录下若干不可变段文件（*.pxti）加一个 manifest.json。每次 commit() 把新增录音写成一个段，
+// 同一量级的段达到 mergeFactor 个时合并（分层合并，写放大为对数级）。段文件以 mmap 方式打开，
+// 查询直接在映射内存上二分查找词典、顺序解码倒排，不把索引读入内存。
+//
+// 倒排格式：每个词一条倒排，按分句号递增：varint(分句号差值) varint(出现次数) varint(位置差值)...
+// 分句表记录 (录音号, 开始毫秒, 结束毫秒)，命中结果即分句的开始时间。
+//
+// 多个实例（含不同进程）可以同时写同一目录：commit / compact 持目录锁（index.lock）重新读取 manifest
+// 后合并写回，录音号在提交时分配。查询可与写入并发，只看到本实例打开 / 提交时的状态。
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "asr/transcription_cache.h"
+
+namespace perfx {
+namespace logic {
+
+/**
+ * @brief 全文索引配置
+ */
+struct TranscriptIndexConfig {
+    std::string directory;          ///< 索引目录，空时使用 defaultDirectory()
+    size_t mergeFactor = 4;         ///< 同一量级的段达到此数量时合并
+};
+
+/**
+ * @brief 查询命中（一个分句）
+ */
+struct TranscriptHit {
+    uint32_t recordingId = 0;
+    std::string recording;          ///< 录音路径（addRecording 时传入）
+    int64_t startMs = 0;            ///< 分句开始时间（录音时间线）
+    int64_t endMs = 0;
+};
+
+/**
+ * @brief 索引统计
+ */
+struct TranscriptIndexStats {
+    size_t recordings = 0;          ///< 有效录音数
+    size_t segments = 0;            ///< 段文件数
+    uint64_t utterances = 0;        ///< 段中的分句数（含已删除录音的分句，合并后清除）
+    uint64_t terms = 0;             ///< 各段词典条目数之和
+    uint64_t postingsBytes = 0;     ///< 倒排数据字节数
+    uint64_t diskBytes = 0;         ///< 段文件总字节数
+    int64_t indexedMs = 0;          ///< 有效录音的转录总时长
+};
+
+/**
+ * @brief 转录全文索引
+ *
+ * search()/getStats() 可在任意线程并发调用；addRecording()/commit()/compact() 之间互斥
+ */
+class TranscriptIndex {
+public:
+    explicit TranscriptIndex(const TranscriptIndexConfig& config = TranscriptIndexConfig());
+    ~TranscriptIndex();
+
+    TranscriptIndex(const TranscriptIndex&) = delete;
+    TranscriptIndex& operator=(const TranscriptIndex&) = delete;
+
+    /**
+     * @brief 默认索引目录：<当前目录>/data/transcript_index（与识别结果缓存同级）
+     */
+    static std::string defaultDirectory();
+
+    /**
+     * @brief 打开（或创建）索引目录，映射全部段文件
+     * @param error 失败原因
+     */
+    bool open(std::string& error);
+
+    /**
+     * @brief 添加录音的转录结果；同一路径已存在时替换旧结果
+     *
+     * 结果在 commit() 之后才能被查询到
+     */
+    void addRecording(const std::string& recording, const std::vector<Asr::CachedUtterance>& utterances);
+
+    /**
+     * @brief 删除录音（commit() 后生效）
+     * @return 录音存在
+     */
+    bool removeRecording(const std::string& recording);
+
+    /**
+     * @brief 写出新段与 manifest，并按需合并段
+     */
+    bool commit(std::string& error);
+
+    /**
+     * @brief 把全部段合并为一个段，清除已删除录音的数据
+     */
+    bool compact(std::string& error);
+
+    /**
+     * @brief 短语查询
+     * @param query 查询串（中文、西文单词或混合）
+     * @param limit 最多返回的命中数，0 表示不限
+     * @return 命中分句，按录音号、开始时间排序
+     */
+    std::vector<TranscriptHit> search(const std::string& query, size_t limit = 100) const;
+
+    TranscriptIndexStats getStats() const;
+    const std::string& getDirectory() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace logic
+} // namespace perfx
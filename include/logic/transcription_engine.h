@@ -0,0 +1,166 @@
+//
+// 无界面转录引擎
+//
+// 把“采集设备 → 处理链 → 客户端 VAD → ASR 会话 → 结果拼接”以及文件识别
+// 封装为不依赖 Qt 的组件，供命令行工具与守护进程使用。
+// 图形界面仍使用 RealtimeTranscriptionController（信号槽 + 波形显示），
+// 两者共享同一套 perfx_core 组件。
+//
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "asr/asr_manager.h"
+#include "asr/transcription_cache.h"
+#include "audio/audio_types.h"
+#include "audio/capture_graph.h"
+#include "audio/channel_splitter.h"
+#include "audio/voice_activity_detector.h"
+
+namespace perfx {
+namespace logic {
+
+/**
+ * @brief 实时识别的额外输入源（例如系统音频的 monitor 设备）
+ */
+struct LiveSource {
+    int deviceIndex = -1;
+    std::string deviceName;         ///< 非空时优先于 deviceIndex（先精确匹配，再子串匹配）
+    std::string label;              ///< 轨道标签，作为识别结果的 speaker
+};
+
+/**
+ * @brief 实时识别选项
+ */
+struct LiveOptions {
+    int deviceIndex = -1;           ///< 输入设备索引，-1 表示系统默认输入设备
+    std::string deviceName;         ///< 按名称选择设备（非空时优先于 deviceIndex）
+    bool enableVad = true;          ///< 客户端 VAD：只发送语音段
+    bool enableProcessing = true;   ///< 高通 + 降噪 + AGC
+    int channels = 1;               ///< 采集声道数；大于 1 且未指定分组时每个声道一个 ASR 会话
+    std::vector<audio::ChannelGroup> channelGroups; ///< 声道分组（每组一个 ASR 会话，组内声道混音），非空时优先
+
+    // 多源采集：主设备为主时钟，额外输入源经漂移补偿后与其对齐（与多声道分组互斥）
+    std::vector<LiveSource> extraSources;
+    std::string sourceLabel = "mic";    ///< 多源采集时主设备的轨道标签
+    bool mixSources = false;            ///< true：各源混为一路，一个 ASR 会话；false：每源一个 ASR 会话
+    bool driftCorrection = true;
+};
+
+/**
+ * @brief 转录结果更新
+ */
+struct TranscriptUpdate {
+    std::string source;                         ///< 文件路径，实时识别为 "live"
+    std::vector<Asr::CachedUtterance> utterances; ///< 当前完整结果（时间为采集 / 文件时间线）
+    bool final = false;                         ///< 文件识别完成或实时会话已结束
+};
+
+/**
+ * @brief 单个声道组（ASR 会话）的统计
+ */
+struct LiveChannelStats {
+    std::string label;
+    std::vector<int> channels;
+    int64_t sentMs = 0;
+    uint64_t packetsSent = 0;
+    uint64_t sendFailures = 0;
+    uint64_t reconnects = 0;
+    int64_t processNs = 0;          ///< 消费者线程中 VAD + 分包 + 发送的累计耗时
+    audio::VadStats vad;
+    Asr::PacketSizeStats packetSize; ///< 当前包时长、RTT 与结果延迟
+    Asr::SessionMemoryStats memory;  ///< 当前会话的帧缓冲池与编解码内存复用
+};
+
+/**
+ * @brief 实时识别统计
+ */
+struct LiveStats {
+    bool active = false;
+    std::string deviceName;
+    int64_t capturedMs = 0;         ///< 采集的音频时长
+    int64_t sentMs = 0;             ///< 发送到服务端的音频时长（VAD 之后，各会话之和）
+    uint64_t packetsSent = 0;
+    uint64_t sendFailures = 0;
+    uint64_t reconnects = 0;
+    uint64_t xruns = 0;
+    audio::VadStats vad;            ///< 各声道组之和（噪声底取第一组）
+    int captureChannels = 1;
+    int64_t splitNs = 0;            ///< 格式转换 + 声道拆分的累计耗时
+    std::vector<LiveChannelStats> channels; ///< 按声道组，单会话时只有一项
+    std::vector<audio::CaptureSourceStats> sources; ///< 多源采集时各输入源的漂移与 FIFO 统计
+};
+
+/**
+ * @brief 无界面转录引擎
+ *
+ * 文件识别与实时识别各自使用独立的 AsrManager 实例，可同时进行。
+ * 回调在 ASR / 音频消费者线程中调用，调用方需自行同步
+ */
+class TranscriptionEngine {
+public:
+    using UpdateCallback = std::function<void(const TranscriptUpdate&)>;
+    using ErrorCallback = std::function<void(const std::string&)>;
+
+    explicit TranscriptionEngine(const Asr::AsrConfig& config = defaultAsrConfig());
+    ~TranscriptionEngine();
+
+    TranscriptionEngine(const TranscriptionEngine&) = delete;
+    TranscriptionEngine& operator=(const TranscriptionEngine&) = delete;
+
+    /**
+     * @brief 从环境变量加载的 ASR 配置（与图形界面的默认配置一致）
+     */
+    static Asr::AsrConfig defaultAsrConfig();
+
+    /**
+     * @brief 枚举输入设备（等待设备注册表首次枚举完成）
+     */
+    static std::vector<audio::DeviceInfo> listInputDevices(int timeoutMs = 10000);
+
+    void setUpdateCallback(UpdateCallback callback);
+    void setErrorCallback(ErrorCallback callback);
+
+    const Asr::AsrConfig& getConfig() const;
+
+    // ============================================================================
+    // 文件识别
+    // ============================================================================
+
+    /**
+     * @brief 识别音频文件（阻塞，多个调用按顺序执行）
+     * @param utterances 输出的分句结果
+     * @param timeoutMs 发送完毕后等待最终结果的超时
+     * @param priority 调度优先级（批量积压用 BATCH，不占用交互式与实时请求的容量）
+     */
+    bool transcribeFile(const std::string& filePath, std::vector<Asr::CachedUtterance>& utterances,
+                        int timeoutMs = 30000, Asr::RequestPriority priority = Asr::RequestPriority::INTERACTIVE);
+
+    // ============================================================================
+    // 实时识别
+    // ============================================================================
+
+    bool startLive(const LiveOptions& options = LiveOptions());
+
+    /**
+     * @brief 停止采集，发送结束包并等待最后的分句定稿
+     */
+    void stopLive();
+
+    bool isLive() const;
+    LiveStats getLiveStats() const;
+    std::vector<Asr::CachedUtterance> getLiveTranscript() const;
+
+    std::string getLastError() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace logic
+} // namespace perfx
@@ -17,11 +17,13 @@
 #include <QToolButton>
 #include <QCloseEvent>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <QMap>
 #include "audio/audio_manager.h"
 #include "asr/asr_manager.h"
+#include "asr/transcript_exporter.h"
 
 namespace perfx {
 namespace audio {
@@ -39,6 +41,11 @@ public:
     void onClose(Asr::AsrClient* client) override;
     void onMessage(Asr::AsrClient* client, const std::string& message) override;
     void onError(Asr::AsrClient* client, const std::string& error) override;
+
+    /**
+     * @brief 取出当前文件的分句结果（供导出），并清空
+     */
+    std::vector<Asr::CachedUtterance> takeUtterances();
 public slots:
     void clearText();
     void updateTextEdit(const QString& text, int sentenceIndex);
@@ -50,6 +57,8 @@ private:
     QMap<int, QString> sentences_;
     QString currentText_;
     QString m_intermediateLine;
+    std::mutex utterancesMutex_;
+    std::vector<Asr::CachedUtterance> utterances_;  // 最近一条结果中的全部分句（ASR 线程写入）
 };
 
 class AudioToTextWindow : public QWidget {
@@ -102,6 +111,8 @@ private:
     void updatePlaybackControls();
     QString formatTime(qint64 milliseconds);
     void startNextAsrTask();
+    void exportTranscriptFile(Asr::ExportFormat format, const QString& filter);
+    Asr::ExportOptions currentExportOptions() const;
     void resetState();
     
     // 窗口事件处理
@@ -128,6 +139,8 @@ private:
     std::vector<std::string> inputFiles_;
     std::vector<std::string> workFiles_;  // 工作文件（转换后的WAV文件）
     std::vector<std::string>::iterator currentWorkFile_;
+    std::vector<Asr::CachedUtterance> lastUtterances_;  // 最近完成的文件的分句结果（菜单导出使用）
+    Asr::ExportOptions lastExportOptions_;               // 最近完成的文件的导出选项（词级时间跟随其请求配置）
     
     bool hasWorkFiles_;  // 是否有工作文件
 };
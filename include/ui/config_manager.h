@@ -211,6 +211,15 @@ public:
      */
     AsrConfig loadConfig();
     
+    /**
+     * @brief 应用已加载的配置（须在 GUI 线程调用）
+     * @details 后台线程可用 ConfigLoader::loadConfigWithPriority(getConfigFilePath())
+     *          读取配置，再回到 GUI 线程调用本函数，避免与界面并发修改配置状态
+     * @param config 配置对象
+     * @param source 配置来源
+     */
+    void applyLoadedConfig(const AsrConfig& config, ConfigSource source);
+    
     /**
      * @brief 保存配置到本地文件（仅保存非敏感配置）
      * @param config 配置对象
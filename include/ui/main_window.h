@@ -21,6 +21,7 @@ class AudioToTextWindow;
 class RealtimeAudioToTextWindow;
 class SystemConfigWindow;
 class ConfigManager;
+class StartupPipeline;
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -41,7 +42,13 @@ private:
                            const QIcon& icon, QGridLayout* layout, 
                            int row, int col, QObject* receiver, 
                            void (MainWindow::*slot)());
-    void loadAsrConfig();
+    void startDeferredInit();
+    
+    // 二级页面在首次导航时才创建，缩短冷启动时间
+    AudioToTextWindow* ensureAudioToTextWindow();
+    RealtimeAudioToTextWindow* ensureRealtimeAudioToTextWindow();
+    SystemConfigWindow* ensureSystemConfigWindow();
+    bool checkAsrReady();
 
 private slots:
     void switchToAudioToText();
@@ -49,6 +56,8 @@ private slots:
     void switchToSystemConfig();
     void switchToMainMenu();
     void onConfigUpdated();
+    void onAsrConfigReady(bool valid);
+    void onStartupFinished();
     
 private:
     QPoint dragPosition_;
@@ -62,6 +71,9 @@ private:
     ConfigManager* configManager_;
     bool asrConfigLoaded_;
     bool asrConfigValid_;
+    
+    // 启动流水线（后台初始化 PortAudio / 设备 / 配置 / 统计）
+    StartupPipeline* startupPipeline_;
 };
 
 } // namespace ui
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QMutex>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <vector>
+#include "audio/audio_types.h"
+#include "ui/config_manager.h"
+
+namespace perfx {
+namespace ui {
+
+/**
+ * @brief 启动阶段记录
+ */
+struct StartupPhase {
+    QString name;           // 阶段名称
+    QString thread;         // 执行线程（gui / worker）
+    qint64 startMs = 0;     // 相对进程启动的起始时间
+    qint64 durationMs = 0;  // 阶段耗时
+    bool ok = true;         // 是否成功
+};
+
+/**
+ * @brief 启动追踪器
+ *
+ * 记录冷启动各阶段的起止时间，可被多个工作线程并发写入，
+ * 所有启动任务结束后由 StartupPipeline 输出汇总
+ */
+class StartupTrace {
+public:
+    static StartupTrace& instance();
+
+    /**
+     * @brief 重置起点，应在 main() 的第一行调用
+     */
+    void begin();
+
+    /**
+     * @brief 自起点以来经过的毫秒数
+     */
+    qint64 elapsedMs() const;
+
+    /**
+     * @brief 记录一个已完成的阶段
+     */
+    void record(const QString& name, qint64 startMs, qint64 durationMs, bool ok = true);
+
+    /**
+     * @brief 记录一个瞬时事件（耗时为 0，例如“主窗口已显示”）
+     */
+    void mark(const QString& name);
+
+    std::vector<StartupPhase> phases() const;
+
+    /**
+     * @brief 按开始时间排序输出所有阶段
+     */
+    void dump() const;
+
+private:
+    StartupTrace();
+
+    QElapsedTimer clock_;
+    mutable QMutex mutex_;
+    std::vector<StartupPhase> phases_;
+};
+
+/**
+ * @brief 作用域内的启动阶段计时，析构时写入 StartupTrace
+ */
+class ScopedStartupPhase {
+public:
+    explicit ScopedStartupPhase(const QString& name);
+    ~ScopedStartupPhase();
+
+    void setOk(bool ok) { ok_ = ok; }
+
+private:
+    QString name_;
+    qint64 startMs_;
+    bool ok_ = true;
+};
+
+/**
+ * @brief 启动流水线
+ *
+ * 主菜单显示后再在独立的线程池中并发执行耗时的初始化：
+ *  - PortAudio 初始化 + 输入设备枚举（由 audio::DeviceRegistry 完成并缓存）
+ *  - ASR 凭证配置加载
+ *  - AsrManager 构造（环境变量配置）+ 使用统计加载
+ * 每项完成后在 GUI 线程发出对应的就绪信号，全部完成后输出启动追踪。
+ * 设备枚举超时时先发出 audioReady(false)，设备列表保持未就绪；注册表稍后就绪时
+ * 再发出 audioReady(true) 与 devicesReady
+ */
+class StartupPipeline : public QObject {
+    Q_OBJECT
+
+public:
+    explicit StartupPipeline(QObject* parent = nullptr);
+    ~StartupPipeline();
+
+    /**
+     * @brief 启动所有后台任务（只生效一次）
+     */
+    void start();
+
+    bool isAudioReady() const { return audioReady_; }
+    bool isConfigReady() const { return configReady_; }
+    bool isStatsReady() const { return statsReady_; }
+    bool isFinished() const { return started_ && pendingTasks_ == 0; }
+
+    /**
+     * @brief 后台枚举得到的输入设备（isAudioReady() 为 true 之后有效）
+     */
+    const std::vector<audio::DeviceInfo>& inputDevices() const { return inputDevices_; }
+
+    /**
+     * @brief 后台加载得到的 ASR 配置（configReady 之后有效）
+     */
+    const AsrConfig& asrConfig() const { return asrConfig_; }
+
+signals:
+    void audioReady(bool ok);
+    void devicesReady(const QStringList& names, const QList<int>& indices);
+    void configReady(bool valid);
+    void statsReady(bool ok);
+    void finished();
+
+private:
+    struct AudioResult {
+        bool timedOut = false;      // 等待注册表首次枚举超时，devices 为空且不是最终结果
+        std::vector<audio::DeviceInfo> devices;
+    };
+
+    struct ConfigResult {
+        AsrConfig config;
+        ConfigSource source = ConfigSource::INVALID;
+        bool loaded = false;
+    };
+
+    void startAudioTask();
+    void startConfigTask();
+    void startStatsTask();
+    void onTaskFinished();
+    void publishDevices(std::vector<audio::DeviceInfo> devices);
+    void watchRegistryReady();
+    void onRegistryReady();
+
+    QThreadPool pool_;
+    bool started_ = false;
+    int pendingTasks_ = 0;
+
+    bool audioReady_ = false;
+    bool configReady_ = false;
+    bool statsReady_ = false;
+    int registryListener_ = -1;     // 设备枚举超时后等待注册表就绪的监听者
+
+    std::vector<audio::DeviceInfo> inputDevices_;
+    AsrConfig asrConfig_;
+};
+
+} // namespace ui
+} // namespace perfx
@@ -6,6 +6,8 @@
 #include "asr/asr_client.h"
 #include "asr/asr_log_utils.h"
 #include "asr/secure_key_manager.h"  // 使用ASR命名空间的SecureKeyManager
+#include "audio/latency_metrics.h"
+#include "audio/trace_events.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -42,6 +44,7 @@ AsrClient::AsrClient() : m_connected(false), m_seq(0), m_callback(nullptr), m_re
     m_config = AsrApiConfig(); // 使用默认值
     m_finalResponseReceived = false;
     m_reqId = generateUuid();
+    m_executor = AsyncExecutor::shared();
     
     // 设置 WebSocket 回调
     m_webSocket.setOnMessageCallback([this](const ix::WebSocketMessagePtr& msg) {
@@ -59,6 +62,7 @@ AsrClient::AsrClient() : m_connected(false), m_seq(0), m_callback(nullptr), m_re
 
 AsrClient::~AsrClient() {
     std::cout << "[ASR-THREAD] Destroying AsrClient..." << std::endl;
+    failAsyncWaiters(ERROR_UNKNOWN, "client destroyed");
     
     try {
         // 断开WebSocket连接
@@ -274,15 +278,52 @@ void AsrClient::setSilenceThreshold(int threshold) {
 // ============================================================================
 
 bool AsrClient::connect() {
+    AsrFuture<bool> future = connectAsync(5000);
+    future.wait(5000);
+    if (future.ok()) {
+        std::cout << "[ASR-CRED] WebSocket连接成功" << std::endl;
+        return true;
+    }
+    std::cout << "[ASR-CRED] WebSocket连接失败: " << future.error().message << std::endl;
+    return false;
+}
+
+AsrFuture<bool> AsrClient::connectAsync(int timeoutMs) {
+    AsrPromise<bool> promise;
+    AsrFuture<bool> future = promise.future(getExecutor());
     try {
         std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
         if (!lock.owns_lock()) {
-            return false; // 避免死锁
+            promise.reject(ERROR_UNKNOWN, "connect already in progress"); // 避免死锁
+            return future;
         }
         
         if (m_connected) {
-            return true;
+            promise.resolve(true);
+            return future;
+        }
+        {
+            // 新会话的音频时间线从 0 开始
+            std::lock_guard<std::mutex> probeLock(m_probeMutex);
+            m_awaitingResponse.clear();
+            m_awaitingResult.clear();
+            m_sentAudioMs = 0;
+            m_resultEndMs = 0;
+        }
+        // 上一个会话的开始 / 结束标志与未完成的响应等待不属于新会话
+        m_readyForAudio = false;
+        m_finalResponseReceived = false;
+        m_lastResponse.clear();
+        std::vector<AsrPromise<std::string>> stale;
+        {
+            std::lock_guard<std::mutex> asyncLock(m_asyncMutex);
+            takeResponseWaitersLocked(stale);
+            m_connectWaiters.push_back(promise);
+        }
+        for (auto& waiter : stale) {
+            waiter.reject(ERROR_UNKNOWN, "session restarted");
         }
+        promise.expireAfter(*getExecutor(), timeoutMs, ERROR_TIMEOUT, "connect timeout");
 
         // 检查URL是否有效
         std::string url = m_config.cluster;
@@ -300,48 +341,35 @@ bool AsrClient::connect() {
             handleMessage(msg);
         });
 
-        // 启动WebSocket线程
+        // 启动WebSocket线程，连接结果由 handleConnectionOpen / handleConnectionError 通知
         m_webSocket.start();
-        
-        // 等待连接建立，但设置超时
-        auto startTime = std::chrono::steady_clock::now();
-        while (m_webSocket.getReadyState() != ix::ReadyState::Open && 
-               std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5)) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        }
-        
-        m_connected = (m_webSocket.getReadyState() == ix::ReadyState::Open);
-        if (m_connected) {
-            std::cout << "[ASR-CRED] WebSocket连接成功" << std::endl;
-        } else {
-            std::cout << "[ASR-CRED] WebSocket连接失败" << std::endl;
-        }
-        return m_connected;
     } catch (const std::exception& e) {
         std::cerr << "[ERROR] ASR connection failed: " << e.what() << std::endl;
-        return false;
+        promise.reject(ERROR_UNKNOWN, e.what());
     }
+    return future;
 }
 
 void AsrClient::disconnect() {
+    {
+        std::lock_guard<std::mutex> leaseLock(m_leaseMutex);
+        m_schedulerLease.release();
+    }
+    failAsyncWaiters(ERROR_UNKNOWN, "disconnected");
     try {
         std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
         if (!lock.owns_lock()) {
             // 如果无法获取锁，强制停止
             m_webSocket.stop();
-            return;
-        }
-        
-        if (!m_connected) {
-            return;
+        } else if (m_connected) {
+            m_connected = false;
+            m_webSocket.stop();
         }
-
-        m_connected = false;
-        m_webSocket.stop();
-        
     } catch (const std::exception& e) {
         std::cerr << "[ERROR] ASR disconnect failed: " << e.what() << std::endl;
     }
+    // 会话结束：整体释放帧缓冲池、zlib 流与响应暂存区
+    m_memory.release();
 }
 
 bool AsrClient::isConnected() const {
@@ -353,36 +381,30 @@ bool AsrClient::isConnected() const {
 // ============================================================================
 
 bool AsrClient::sendAudio(const std::vector<uint8_t>& audioData, int32_t sequence) {
+    return sendAudioPacket(audioData, sequence, std::nullopt);
+}
+
+bool AsrClient::sendAudioPacket(const std::vector<uint8_t>& audioData, int32_t sequence, ResponseWaiter waiter) {
+    PERFX_TRACE_SCOPE("asr.send");
+    if (perfx::audio::trace::enabled()) {
+        // 最近发出的音频包所属的追踪流，收到下一个识别结果时接续
+        m_traceFlow.store(perfx::audio::trace::currentFlow(), std::memory_order_relaxed);
+    }
     if (!m_connected) {
         logErrorWithTimestamp("❌ 未连接");
         return false;
     }
     bool isLast = (sequence < 0);
     
-    // 1. Header (4字节) - 不包含序列号
-    std::vector<uint8_t> packet = generateHeader(
-        AUDIO_ONLY_REQUEST,
-        isLast ? NEG_WITH_SEQUENCE : POS_SEQUENCE,
-        RAW_BYTES,
-        GZIP_COMPRESSION,
-        0x00
-    );
-    
-    // 2. 序列号 (4字节，大端序，有符号)
-    for (int i = 3; i >= 0; --i) {
-        packet.push_back((sequence >> (i * 8)) & 0xFF);
+    // Header(4) + 序列号(4，大端序，有符号) + Payload Size(4，大端序) + Gzip 压缩的音频，
+    // 在会话内存池的缓冲区中直接编码
+    std::vector<uint8_t> packet = m_memory.encodeFrame(
+        generateHeader(AUDIO_ONLY_REQUEST, isLast ? NEG_WITH_SEQUENCE : POS_SEQUENCE, RAW_BYTES, GZIP_COMPRESSION, 0x00),
+        sequence, audioData.data(), audioData.size());
+    if (packet.empty()) {
+        logErrorWithTimestamp("❌ GZIP 压缩失败");
+        return false;
     }
-    
-    // 3. Gzip 压缩音频数据
-    std::vector<uint8_t> payload = gzipCompress(audioData);
-    
-    // 4. Payload Size (4字节，大端序)
-    uint32_t payloadSize = payload.size();
-    for (int i = 3; i >= 0; --i)
-        packet.push_back((payloadSize >> (i * 8)) & 0xFF);
-    
-    // 5. Payload
-    packet.insert(packet.end(), payload.begin(), payload.end());
 
     // ========== 协议包详细打印 ==========
 #if ASR_ENABLE_PROTOCOL_LOG
@@ -399,7 +421,17 @@ bool AsrClient::sendAudio(const std::vector<uint8_t>& audioData, int32_t sequenc
 #endif
 
     // 实际发送
+    if (m_recorder) {
+        m_recorder->record(CaptureDirection::ClientBinary, packet.data(), packet.size());
+    }
+    pushResponseWaiter(waiter);
     auto sendInfo = m_webSocket.sendBinary(packet);
+    // 发送时帧已复制进 WebSocket 的发送缓冲，缓冲区归还给池
+    m_memory.recycle(std::move(packet));
+    if (!sendInfo.success) {
+        dropResponseWaiter(waiter);
+    }
+    probePacketSent(audioData.size(), sendInfo.success);
     return sendInfo.success;
 }
 
@@ -416,14 +448,21 @@ bool AsrClient::sendAudioFile(const std::vector<uint8_t>& audioData, bool isLast
 // ============================================================================
 
 bool AsrClient::sendFullClientRequestAndWaitResponse(int timeoutMs, std::string* response) {
+    AsrFuture<std::string> future = sendFullClientRequestAsync(timeoutMs);
+    future.wait(timeoutMs);
+    const bool ok = future.ok();
+    if (response) {
+        *response = ok ? future.value() : "";
+    }
+    return ok;
+}
+
+bool AsrClient::sendFullClientRequestPacket(ResponseWaiter waiter) {
     if (!m_connected) {
         logErrorWithTimestamp("❌ 未连接");
         return false;
     }
     
-    // 连接建立后等待短暂时间，确保连接稳定
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
-    
     // 构造请求 JSON
     json requestParams = constructRequest();
     std::string jsonStr = requestParams.dump();
@@ -431,52 +470,38 @@ bool AsrClient::sendFullClientRequestAndWaitResponse(int timeoutMs, std::string*
     logWithTimestamp("📤 JSON_STRING: " + jsonStr);
     logWithTimestamp("📤 JSON原始长度: " + std::to_string(jsonStr.length()) + " bytes");
     
-    // Gzip 压缩
-    std::vector<uint8_t> payload = gzipCompress(jsonStr);
-    if (payload.empty()) {
+    // Header(4) + 序列号(4，大端序，有符号) + Payload Size(4，大端序) + Gzip 压缩的 JSON
+    std::vector<uint8_t> packet = m_memory.encodeFrame(
+        generateHeader(FULL_CLIENT_REQUEST, POS_SEQUENCE, JSON_SERIALIZATION, GZIP_COMPRESSION, 0x00),
+        m_seq, jsonStr.data(), jsonStr.size());
+    if (packet.empty()) {
         logErrorWithTimestamp("❌ GZIP 压缩失败");
         return false;
     }
-#if ASR_ENABLE_PROTOCOL_LOG
-    logWithTimestamp("📤 gzip压缩后长度: " + std::to_string(payload.size()) + " bytes");
-#endif
-    
-    // 1. Header (4字节) - 描述消息类型、序列化方式、压缩格式等
-    std::vector<uint8_t> packet = generateHeader(
-        FULL_CLIENT_REQUEST,
-        POS_SEQUENCE,
-        JSON_SERIALIZATION,
-        GZIP_COMPRESSION,
-        0x00
-    );
-    
-    // 2. 序列号 (4字节，大端序，有符号)
-    for (int i = 3; i >= 0; --i) {
-        packet.push_back((m_seq >> (i * 8)) & 0xFF);
-    }
-    
-    // 3. Payload Size (4字节，大端序) - payload的长度
-    uint32_t payloadSize = payload.size();
-    for (int i = 3; i >= 0; --i)
-        packet.push_back((payloadSize >> (i * 8)) & 0xFF);
-    
-    // 4. Payload - 具体负载内容（压缩后的JSON数据）
-    packet.insert(packet.end(), payload.begin(), payload.end());
     
     // 调试输出
 #if ASR_ENABLE_PROTOCOL_LOG
+    logWithTimestamp("📤 gzip压缩后长度: " + std::to_string(packet.size() - 12) + " bytes");
     logWithTimestamp("📤 HEADER: " + hexString(packet));
     logWithTimestamp("📤 PAYLOAD_LEN: " + hexString(std::vector<uint8_t>(packet.begin() + 8, packet.begin() + 12)));
 #endif
 
-    // 4. 发送
-    std::string binaryData(reinterpret_cast<const char*>(packet.data()), packet.size());
-    m_webSocket.sendBinary(binaryData);
+    // 发送
+    if (m_recorder) {
+        m_recorder->record(CaptureDirection::ClientBinary, packet.data(), packet.size());
+    }
+    pushResponseWaiter(waiter);
+    const bool sent = m_webSocket.sendBinary(packet).success;
+    m_memory.recycle(std::move(packet));
+    if (!sent) {
+        dropResponseWaiter(waiter);
+        logErrorWithTimestamp("❌ 发送完整客户端请求失败");
+        return false;
+    }
     
     // 递增序列号
     m_seq++;
-    
-    return waitForResponse(timeoutMs, response);
+    return true;
 }
 
 std::string AsrClient::sendFullClientRequestAndGetResponse(int timeoutMs) {
@@ -489,6 +514,10 @@ std::string AsrClient::sendFullClientRequestAndGetResponse(int timeoutMs) {
 // 获取状态信息
 // ============================================================================
 
+SessionMemoryStats AsrClient::getMemoryStats() const {
+    return m_memory.stats();
+}
+
 std::string AsrClient::getLogId() const {
     return m_logId;
 }
@@ -502,6 +531,10 @@ std::string AsrClient::getFullClientRequestJson() const {
     return req.dump(2); // 格式化输出
 }
 
+const AsrApiConfig& AsrClient::getApiConfig() const {
+    return m_config;
+}
+
 // ============================================================================
 // 音频格式验证方法实现
 // ============================================================================
@@ -567,15 +600,307 @@ void AsrClient::updateHeaders() {
 }
 
 void AsrClient::handleMessage(const ix::WebSocketMessagePtr& msg) {
+    if (msg && m_recorder) {
+        recordMessage(msg);
+    }
+    dispatchMessage(msg);
+}
+
+void AsrClient::injectMessage(const ix::WebSocketMessagePtr& msg) {
+    dispatchMessage(msg);
+}
+
+void AsrClient::setSessionRecorder(std::shared_ptr<SessionRecorder> recorder) {
+    m_recorder = std::move(recorder);
+}
+
+void AsrClient::setSchedulerLease(SessionLease lease) {
+    std::lock_guard<std::mutex> lock(m_leaseMutex);
+    m_schedulerLease = std::move(lease);
+}
+
+// ============================================================================
+// 链路测量
+// ============================================================================
+
+namespace {
+// 错误帧：Header(头部大小 × 4 字节) + 错误码(4字节，大端序) + Payload Size + Payload
+uint32_t errorCodeFromFrame(const std::string& frame) {
+    const size_t headerSize = static_cast<size_t>(static_cast<unsigned char>(frame[0]) & 0x0F) * 4;
+    if (frame.size() < headerSize + 4) {
+        return 0;
+    }
+    uint32_t code = 0;
+    for (size_t i = headerSize; i < headerSize + 4; ++i) {
+        code = (code << 8) | static_cast<unsigned char>(frame[i]);
+    }
+    return code;
+}
+}
+
+void AsrClient::setPacketSizeController(std::shared_ptr<PacketSizeController> controller) {
+    std::lock_guard<std::mutex> lock(m_probeMutex);
+    m_packetSizer = std::move(controller);
+}
+
+void AsrClient::probePacketSent(size_t audioBytes, bool sent) {
+    const int64_t now = perfx::audio::metrics::nowNs();
+    std::shared_ptr<PacketSizeController> sizer;
+    int packetMs = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_probeMutex);
+        if (!m_packetSizer) {
+            return;
+        }
+        sizer = m_packetSizer;
+        const size_t bytesPerMs = static_cast<size_t>(m_config.sampleRate / 1000) *
+                                  static_cast<size_t>(m_config.bits / 8) * static_cast<size_t>(m_config.channels);
+        packetMs = bytesPerMs > 0 ? static_cast<int>(audioBytes / bytesPerMs) : 0;
+        if (sent) {
+            m_sentAudioMs += packetMs;
+            // 队列满时丢弃最早的记录
+            m_awaitingResponse.push_back({m_sentAudioMs, now});
+            m_awaitingResult.push_back({m_sentAudioMs, now});
+        }
+    }
+    if (sent) {
+        sizer->onPacketSent(packetMs);
+    } else {
+        sizer->onLoss(now);
+    }
+}
+
+void AsrClient::probeResponse(const json& j) {
+    const int64_t now = perfx::audio::metrics::nowNs();
+    std::shared_ptr<PacketSizeController> sizer;
+    int64_t rttNs = 0;
+    int64_t latencyNs = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_probeMutex);
+        if (!m_packetSizer) {
+            return;
+        }
+        sizer = m_packetSizer;
+        // 会话开始的响应到达时还没有发出音频，队列为空
+        if (!m_awaitingResponse.empty()) {
+            rttNs = now - m_awaitingResponse.front().sentNs;
+            m_awaitingResponse.pop_front();
+        }
+
+        // 结果覆盖到的最晚音频位置
+        int64_t endMs = 0;
+        if (j.contains("result") && j["result"].is_object() && j["result"].contains("utterances") &&
+            j["result"]["utterances"].is_array()) {
+            for (const auto& utterance : j["result"]["utterances"]) {
+                if (utterance.is_object() && utterance.contains("end_time") && utterance["end_time"].is_number()) {
+                    endMs = std::max(endMs, utterance["end_time"].get<int64_t>());
+                }
+            }
+        }
+        if (endMs > m_resultEndMs) {
+            m_resultEndMs = endMs;
+            while (!m_awaitingResult.empty() && m_awaitingResult.front().audioEndMs < endMs) {
+                m_awaitingResult.pop_front();
+            }
+            // 包含结果结束位置的那个包
+            if (!m_awaitingResult.empty()) {
+                latencyNs = now - m_awaitingResult.front().sentNs;
+            }
+        }
+    }
+    if (rttNs > 0) {
+        sizer->onRtt(rttNs, now);
+    }
+    if (latencyNs > 0) {
+        sizer->onResultLatency(latencyNs);
+    }
+}
+
+// ============================================================================
+// 异步接口
+// ============================================================================
+
+void AsrClient::setExecutor(std::shared_ptr<AsyncExecutor> executor) {
+    std::lock_guard<std::mutex> lock(m_asyncMutex);
+    m_executor = executor ? std::move(executor) : AsyncExecutor::shared();
+}
+
+std::shared_ptr<AsyncExecutor> AsrClient::getExecutor() const {
+    std::lock_guard<std::mutex> lock(m_asyncMutex);
+    return m_executor;
+}
+
+AsrFuture<std::string> AsrClient::sendFullClientRequestAsync(int timeoutMs) {
+    const auto executor = getExecutor();
+    AsrPromise<std::string> promise;
+    AsrFuture<std::string> future = promise.future(executor);
+    if (!sendFullClientRequestPacket(promise)) {
+        promise.reject(ERROR_UNKNOWN, "send full client request failed");
+        return future;
+    }
+    promise.expireAfter(*executor, timeoutMs, ERROR_TIMEOUT, "full client request timeout");
+    return future;
+}
+
+AsrFuture<std::string> AsrClient::sendAudioAsync(const std::vector<uint8_t>& audioData, int32_t sequence,
+                                                 int timeoutMs) {
+    const auto executor = getExecutor();
+    AsrPromise<std::string> promise;
+    AsrFuture<std::string> future = promise.future(executor);
+    if (!sendAudioPacket(audioData, sequence, promise)) {
+        promise.reject(ERROR_UNKNOWN, "send audio failed");
+        return future;
+    }
+    promise.expireAfter(*executor, timeoutMs, ERROR_TIMEOUT, "audio response timeout");
+    return future;
+}
+
+AsrFuture<std::string> AsrClient::finalResponseAsync(int timeoutMs) const {
+    const auto executor = getExecutor();
+    AsrPromise<std::string> promise;
+    AsrFuture<std::string> future = promise.future(executor);
+    bool received = false;
+    bool connected = false;
+    {
+        // 与 resolveFinalWaiters 在同一把锁下检查标志，不会漏掉正在到达的最终结果
+        std::lock_guard<std::mutex> lock(m_asyncMutex);
+        received = m_finalResponseReceived;
+        connected = m_connected;
+        if (!received && connected) {
+            m_finalWaiters.push_back(promise);
+        }
+    }
+    if (received) {
+        promise.resolve(m_lastResponse);
+    } else if (!connected) {
+        promise.reject(ERROR_UNKNOWN, "not connected");
+    } else {
+        promise.expireAfter(*executor, timeoutMs, ERROR_TIMEOUT, "final response timeout");
+    }
+    return future;
+}
+
+void AsrClient::pushResponseWaiter(ResponseWaiter waiter) {
+    ResponseWaiter dropped;
+    {
+        std::lock_guard<std::mutex> lock(m_asyncMutex);
+        // 服务端不按包回复时只保留最近的记录
+        m_responseWaiters.push_back(std::move(waiter), &dropped);
+    }
+    if (dropped) {
+        dropped->reject(ERROR_TIMEOUT, "response record dropped");
+    }
+}
+
+void AsrClient::dropResponseWaiter(const ResponseWaiter& waiter) {
+    std::lock_guard<std::mutex> lock(m_asyncMutex);
+    // 发送失败的包没有响应：从队尾找到登记的那一项移除（空位之间无需区分）
+    for (size_t i = m_responseWaiters.size(); i-- > 0;) {
+        const ResponseWaiter& entry = m_responseWaiters[i];
+        const bool same = waiter ? (entry && entry->sameAs(*waiter)) : !entry;
+        if (same) {
+            m_responseWaiters.erase(i);
+            return;
+        }
+    }
+}
+
+void AsrClient::resolveNextResponse(const std::string& jsonStr) {
+    ResponseWaiter waiter;
+    {
+        std::lock_guard<std::mutex> lock(m_asyncMutex);
+        if (m_responseWaiters.empty()) {
+            return;
+        }
+        waiter = m_responseWaiters.take_front();
+    }
+    if (waiter) {
+        waiter->resolve(jsonStr);
+    }
+}
+
+void AsrClient::resolveFinalWaiters(const std::string& jsonStr) {
+    std::vector<AsrPromise<std::string>> waiters;
+    {
+        std::lock_guard<std::mutex> lock(m_asyncMutex);
+        waiters.swap(m_finalWaiters);
+    }
+    for (auto& waiter : waiters) {
+        waiter.resolve(jsonStr);
+    }
+}
+
+void AsrClient::takeResponseWaitersLocked(std::vector<AsrPromise<std::string>>& waiters) {
+    // 环形队列保留存储：逐项取出而不是整体交换
+    while (!m_responseWaiters.empty()) {
+        ResponseWaiter waiter = m_responseWaiters.take_front();
+        if (waiter) {
+            waiters.push_back(std::move(*waiter));
+        }
+    }
+}
+
+void AsrClient::failAsyncWaiters(uint32_t code, const std::string& message) {
+    std::vector<AsrPromise<std::string>> responses;
+    std::vector<AsrPromise<bool>> connects;
+    std::vector<AsrPromise<std::string>> finals;
+    {
+        std::lock_guard<std::mutex> lock(m_asyncMutex);
+        takeResponseWaitersLocked(responses);
+        connects.swap(m_connectWaiters);
+        finals.swap(m_finalWaiters);
+    }
+    for (auto& waiter : responses) {
+        waiter.reject(code, message);
+    }
+    for (auto& waiter : connects) {
+        waiter.reject(code, message);
+    }
+    for (auto& waiter : finals) {
+        waiter.reject(code, message);
+    }
+}
+
+void AsrClient::recordMessage(const ix::WebSocketMessagePtr& msg) {
+    switch (msg->type) {
+        case ix::WebSocketMessageType::Message:
+            m_recorder->record(msg->binary ? CaptureDirection::ServerBinary : CaptureDirection::ServerText, msg->str);
+            break;
+        case ix::WebSocketMessageType::Open: {
+            json headers = json::object();
+            for (const auto& header : msg->openInfo.headers) {
+                headers[header.first] = header.second;
+            }
+            m_recorder->record(CaptureDirection::Open, headers.dump());
+            break;
+        }
+        case ix::WebSocketMessageType::Close:
+            m_recorder->record(CaptureDirection::Close,
+                               json{{"code", msg->closeInfo.code}, {"reason", msg->closeInfo.reason}}.dump());
+            break;
+        case ix::WebSocketMessageType::Error:
+            m_recorder->record(CaptureDirection::Error, msg->errorInfo.reason);
+            break;
+        default:
+            break;
+    }
+}
+
+void AsrClient::dispatchMessage(const ix::WebSocketMessagePtr& msg) {
     try {
         if (!msg) {
             logErrorWithTimestamp("❌ 收到空的WebSocket消息");
             return;
         }
         
+        perfx::audio::trace::setThreadName("asr.network");
+        PERFX_TRACE_SCOPE("asr.receive");
         switch (msg->type) {
             case ix::WebSocketMessageType::Message: {
                 if (msg->binary) {
+                    const uint64_t flow = m_traceFlow.load(std::memory_order_relaxed);
+                    perfx::audio::trace::flowStep("asr.response", flow);
+                    perfx::audio::trace::setCurrentFlow(flow);
                     handleBinaryMessage(msg);
                 } else {
                     handleTextMessage(msg);
@@ -657,32 +982,42 @@ void AsrClient::handleFullServerResponse(const ix::WebSocketMessagePtr& msg, uin
         logWithTimestamp("🎯 收到最终结果响应 (Full Server Response)");
     }
     
-    // 解析二进制协议获取JSON响应
-    std::string jsonResponse = parseBinaryResponse(msg->str);
-    if (!jsonResponse.empty()) {
+    // 解析二进制协议获取JSON响应（写入会话内存的暂存区，处理完归还）
+    std::string jsonResponse = m_memory.takeText();
+    if (parseBinaryResponse(msg->str, jsonResponse)) {
 #if ASR_ENABLE_PROTOCOL_LOG
         logWithTimestamp("🧹 解析后的响应: " + jsonResponse);
 #endif
         processJsonResponse(jsonResponse);
     }
+    if (flags == 0x03) {
+        resolveFinalWaiters(jsonResponse);
+    }
+    m_memory.returnText(std::move(jsonResponse));
 }
 
 void AsrClient::handleServerAck(const ix::WebSocketMessagePtr& msg) {
     logWithTimestamp("✅ 收到服务器确认 (Server ACK)");
     
     // 解析ACK消息，可能包含额外信息
-    std::string jsonResponse = parseBinaryResponse(msg->str);
-    if (!jsonResponse.empty()) {
+    std::string jsonResponse = m_memory.takeText();
+    if (parseBinaryResponse(msg->str, jsonResponse)) {
         processJsonResponse(jsonResponse);
     }
+    m_memory.returnText(std::move(jsonResponse));
 }
 
 void AsrClient::handleErrorResponse(const ix::WebSocketMessagePtr& msg) {
     logErrorWithTimestamp("❌ 收到错误响应");
     
-    std::string jsonResponse = parseBinaryResponse(msg->str);
-    if (!jsonResponse.empty()) {
+    std::string jsonResponse;
+    if (parseBinaryResponse(msg->str, jsonResponse)) {
         m_lastError = parseErrorResponse(jsonResponse);
+        // payload 中没有错误码时取协议头后的错误码字段
+        const uint32_t frameCode = errorCodeFromFrame(msg->str);
+        if (frameCode != 0 && (m_lastError.code == ERROR_SUCCESS || m_lastError.code == ERROR_UNKNOWN)) {
+            m_lastError.code = frameCode;
+        }
         logErrorWithTimestamp("❌ 错误详情: " + m_lastError.getErrorDescription());
         logErrorWithTimestamp("❌ 错误消息: " + m_lastError.message);
         logErrorWithTimestamp("❌ 错误代码: " + std::to_string(m_lastError.code));
@@ -692,12 +1027,14 @@ void AsrClient::handleErrorResponse(const ix::WebSocketMessagePtr& msg) {
             logErrorWithTimestamp("❌ ❌ ASR连接错误: payload unmarshal: no request object before data");
             logErrorWithTimestamp("🔍 可能原因: 1) 请求格式不正确 2) 发送时机过早 3) 协议版本不匹配");
         }
+        failAsyncWaiters(m_lastError.code, m_lastError.message);
         
         if (m_callback) {
             m_callback->onError(this, m_lastError.message);
         }
     } else {
         logErrorWithTimestamp("❌ 无法解析错误响应");
+        failAsyncWaiters(ERROR_UNKNOWN, "Unknown error response");
         if (m_callback) {
             m_callback->onError(this, "Unknown error response");
         }
@@ -713,6 +1050,7 @@ void AsrClient::handleTextMessage(const ix::WebSocketMessagePtr& msg) {
     if (hasError(msg->str)) {
         m_lastError = parseErrorResponse(msg->str);
         logErrorWithTimestamp("❌ 检测到错误: " + m_lastError.getErrorDescription());
+        failAsyncWaiters(m_lastError.code, m_lastError.message);
         
         if (m_callback) {
             m_callback->onError(this, m_lastError.message);
@@ -742,6 +1080,15 @@ void AsrClient::handleConnectionOpen(const ix::WebSocketMessagePtr& msg) {
         logWithTimestamp("⚠️ 未找到 X-Tt-Logid");
     }
     
+    std::vector<AsrPromise<bool>> connects;
+    {
+        std::lock_guard<std::mutex> lock(m_asyncMutex);
+        connects.swap(m_connectWaiters);
+    }
+    for (auto& waiter : connects) {
+        waiter.resolve(true);
+    }
+    
     if (m_callback) {
         m_callback->onOpen(this);
     }
@@ -750,6 +1097,12 @@ void AsrClient::handleConnectionOpen(const ix::WebSocketMessagePtr& msg) {
 void AsrClient::handleConnectionClose(const ix::WebSocketMessagePtr& msg) {
     logWithTimestamp("🔌 WebSocket 连接已关闭 (code: " + std::to_string(msg->closeInfo.code) + ", reason: " + msg->closeInfo.reason + ")");
     m_connected = false;
+    {
+        // 服务端关闭的会话不再占用调度许可
+        std::lock_guard<std::mutex> leaseLock(m_leaseMutex);
+        m_schedulerLease.release();
+    }
+    failAsyncWaiters(ERROR_UNKNOWN, "connection closed: " + msg->closeInfo.reason);
     
     if (m_callback) {
         m_callback->onClose(this);
@@ -761,6 +1114,16 @@ void AsrClient::handleConnectionError(const ix::WebSocketMessagePtr& msg) {
     logErrorWithTimestamp("🔍 错误详情: HTTP状态=" + std::to_string(msg->errorInfo.http_status) 
              + ", 重试次数=" + std::to_string(msg->errorInfo.retries) 
              + ", 等待时间=" + std::to_string(msg->errorInfo.wait_time) + "ms");
+
+    // 握手阶段的限流 / 过载以 HTTP 状态返回，映射为服务端错误码供调度器识别
+    if (msg->errorInfo.http_status == 429) {
+        m_lastError = AsrError(ERROR_RATE_LIMITED, msg->errorInfo.reason);
+    } else if (msg->errorInfo.http_status == 503) {
+        m_lastError = AsrError(ERROR_SERVER_BUSY, msg->errorInfo.reason);
+    } else {
+        m_lastError = AsrError(ERROR_UNKNOWN, msg->errorInfo.reason);
+    }
+    failAsyncWaiters(m_lastError.code, msg->errorInfo.reason);
     
     if (m_callback) {
         m_callback->onError(this, msg->errorInfo.reason);
@@ -781,11 +1144,13 @@ void AsrClient::processJsonResponse(const std::string& jsonStr) {
         
         // 提取 log_id
         extractLogId(j);
+        probeResponse(j);
         
         // 检查是否为会话开始响应
         if (checkSessionStarted(j)) {
             setReadyForAudio();
         }
+        resolveNextResponse(jsonStr);
         
         // 调用回调函数
         if (m_callback) {
@@ -830,77 +1195,80 @@ void AsrClient::setReadyForAudio() {
 
 // 构造请求包
 json AsrClient::constructRequest() const {
+    return constructRequest(m_config);
+}
+
+json AsrClient::constructRequest(const AsrApiConfig& config) {
     json req = {
-        {"user", {{"uid", m_config.uid}}},
+        {"user", {{"uid", config.uid}}},
         {"audio", {
-            {"format", m_config.format},
-            {"sample_rate", m_config.sampleRate},
-            {"bits", m_config.bits},
-            {"channel", m_config.channels},
-            {"codec", m_config.codec}
+            {"format", config.format},
+            {"sample_rate", config.sampleRate},
+            {"bits", config.bits},
+            {"channel", config.channels},
+            {"codec", config.codec}
         }},
         {"request", {
-            {"model_name", m_config.modelName},
-            {"enable_punc", m_config.enablePunc},
-            {"vad_segment_duration", m_config.vadSegmentDuration},
+            {"model_name", config.modelName},
+            {"enable_punc", config.enablePunc},
+            {"vad_segment_duration", config.vadSegmentDuration},
             {"enable_final_result", true},
             {"enable_interim_result", true},
-            {"language", m_config.language},
-            {"result_type", m_config.resultType}
+            {"language", config.language},
+            {"result_type", config.resultType}
         }}
     };
     
     // 添加可选的高级配置参数
-    if (m_config.enableItn) {
-        req["request"]["enable_itn"] = m_config.enableItn;
+    if (config.enableItn) {
+        req["request"]["enable_itn"] = config.enableItn;
     }
-    if (m_config.enableTimestamp) {
-        req["request"]["enable_timestamp"] = m_config.enableTimestamp;
+    if (config.enableTimestamp) {
+        req["request"]["enable_timestamp"] = config.enableTimestamp;
     }
-    if (m_config.enableVoiceDetection) {
-        req["request"]["enable_voice_detection"] = m_config.enableVoiceDetection;
+    if (config.enableVoiceDetection) {
+        req["request"]["enable_voice_detection"] = config.enableVoiceDetection;
     }
-    if (m_config.enableSemanticSentenceDetection) {
-        req["request"]["enable_semantic_sentence_detection"] = m_config.enableSemanticSentenceDetection;
+    if (config.enableSemanticSentenceDetection) {
+        req["request"]["enable_semantic_sentence_detection"] = config.enableSemanticSentenceDetection;
     }
-    if (m_config.enableInverseTextNormalization) {
-        req["request"]["enable_inverse_text_normalization"] = m_config.enableInverseTextNormalization;
+    if (config.enableInverseTextNormalization) {
+        req["request"]["enable_inverse_text_normalization"] = config.enableInverseTextNormalization;
     }
-    if (m_config.enableWordTimeOffset) {
-        req["request"]["enable_word_time_offset"] = m_config.enableWordTimeOffset;
+    if (config.enableWordTimeOffset) {
+        req["request"]["enable_word_time_offset"] = config.enableWordTimeOffset;
     }
-    if (m_config.enablePartialResult) {
-        req["request"]["enable_partial_result"] = m_config.enablePartialResult;
+    if (config.enablePartialResult) {
+        req["request"]["enable_partial_result"] = config.enablePartialResult;
     }
-    if (m_config.enableFinalResult) {
-        req["request"]["enable_final_result"] = m_config.enableFinalResult;
+    if (config.enableFinalResult) {
+        req["request"]["enable_final_result"] = config.enableFinalResult;
     }
-    if (m_config.enableInterimResult) {
-        req["request"]["enable_interim_result"] = m_config.enableInterimResult;
+    if (config.enableInterimResult) {
+        req["request"]["enable_interim_result"] = config.enableInterimResult;
     }
-    if (m_config.enableSilenceDetection) {
-        req["request"]["enable_silence_detection"] = m_config.enableSilenceDetection;
-        req["request"]["silence_threshold"] = m_config.silenceThreshold;
+    if (config.enableSilenceDetection) {
+        req["request"]["enable_silence_detection"] = config.enableSilenceDetection;
+        req["request"]["silence_threshold"] = config.silenceThreshold;
     }
     
     return req;
 }
 
-std::vector<uint8_t> AsrClient::generateHeader(
+std::array<uint8_t, 4> AsrClient::generateHeader(
     uint8_t messageType,
     uint8_t messageTypeSpecificFlags,
     uint8_t serialMethod,
     uint8_t compressionType,
     uint8_t reservedData
 ) {
-    std::vector<uint8_t> header;
     uint8_t headerSize = 2; // 8字节 = 2个4字节块
-    header.push_back((PROTOCOL_VERSION << 4) | headerSize);
-    header.push_back((messageType << 4) | messageTypeSpecificFlags);
-    header.push_back((serialMethod << 4) | compressionType);
-    header.push_back(reservedData);
-    
-    return header;
+    return {
+        static_cast<uint8_t>((PROTOCOL_VERSION << 4) | headerSize),
+        static_cast<uint8_t>((messageType << 4) | messageTypeSpecificFlags),
+        static_cast<uint8_t>((serialMethod << 4) | compressionType),
+        reservedData
+    };
 }
 
 std::vector<uint8_t> AsrClient::generateBeforePayload(int32_t sequence) {
@@ -911,68 +1279,6 @@ std::vector<uint8_t> AsrClient::generateBeforePayload(int32_t sequence) {
     return beforePayload;
 }
 
-std::vector<uint8_t> AsrClient::gzipCompress(const std::string& data) {
-    std::vector<uint8_t> compressed;
-    z_stream strm;
-    strm.zalloc = Z_NULL;
-    strm.zfree = Z_NULL;
-    strm.opaque = Z_NULL;
-    
-    if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
-        logErrorWithTimestamp("❌ GZIP 压缩初始化失败");
-        return compressed;
-    }
-    
-    strm.avail_in = data.size();
-    strm.next_in = (Bytef*)data.data();
-    
-    compressed.resize(data.size() + 1024); // 预留空间
-    strm.avail_out = compressed.size();
-    strm.next_out = compressed.data();
-    
-    int ret = deflate(&strm, Z_FINISH);
-    if (ret == Z_STREAM_END) {
-        compressed.resize(compressed.size() - strm.avail_out);
-    } else {
-        logErrorWithTimestamp("❌ GZIP 压缩失败");
-        compressed.clear();
-    }
-    
-    deflateEnd(&strm);
-    return compressed;
-}
-
-std::vector<uint8_t> AsrClient::gzipCompress(const std::vector<uint8_t>& data) {
-    std::vector<uint8_t> compressed;
-    z_stream strm;
-    strm.zalloc = Z_NULL;
-    strm.zfree = Z_NULL;
-    strm.opaque = Z_NULL;
-    
-    if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
-        logErrorWithTimestamp("❌ GZIP 压缩初始化失败");
-        return compressed;
-    }
-    
-    strm.avail_in = data.size();
-    strm.next_in = (Bytef*)data.data();
-    
-    compressed.resize(data.size() + 1024); // 预留空间
-    strm.avail_out = compressed.size();
-    strm.next_out = compressed.data();
-    
-    int ret = deflate(&strm, Z_FINISH);
-    if (ret == Z_STREAM_END) {
-        compressed.resize(compressed.size() - strm.avail_out);
-    } else {
-        logErrorWithTimestamp("❌ GZIP 压缩失败");
-        compressed.clear();
-    }
-    
-    deflateEnd(&strm);
-    return compressed;
-}
-
 bool AsrClient::waitForResponse(int timeoutMs, std::string* response) {
     // 使用条件变量等待响应，避免忙等待
     std::unique_lock<std::mutex> lock(m_mutex);
@@ -1114,10 +1420,12 @@ std::string AsrClient::getErrorDescription(uint32_t errorCode) {
 
 // 解析二进制协议，详见火山引擎 ASR WebSocket 协议文档：
 // Header(4字节) + [序列号/错误码](4字节) + Payload Size(4字节) + Payload
-std::string AsrClient::parseBinaryResponse(const std::string& binaryData) {
+bool AsrClient::parseBinaryResponse(const std::string& binaryData, std::string& out) {
+    PERFX_TRACE_SCOPE("asr.parse");
+    out.clear();
     if (binaryData.size() < 4) {
         logErrorWithTimestamp("❌ 二进制数据太小，无法解析协议头");
-        return "";
+        return false;
     }
     
     // 解析协议头
@@ -1159,281 +1467,130 @@ std::string AsrClient::parseBinaryResponse(const std::string& binaryData) {
     size_t totalHeaderSize = headerSize * 4;
     if (binaryData.size() < totalHeaderSize) {
         logErrorWithTimestamp("❌ 二进制数据太小，无法包含完整头部");
-        return "";
+        return false;
     }
     
-    // 提取 payload
-    std::string payload = binaryData.substr(totalHeaderSize);
+    // 在原始帧上解析 payload，不再复制
+    const char* payload = binaryData.data() + totalHeaderSize;
+    const size_t payloadLength = binaryData.size() - totalHeaderSize;
+    auto readUint32 = [payload](size_t offset) {
+        uint32_t value = 0;
+        for (size_t i = offset; i < offset + 4; ++i) {
+            value = (value << 8) | static_cast<unsigned char>(payload[i]);
+        }
+        return value;
+    };
+    
+    // 解压到 out（复用其容量）并校验 JSON；校验只做语法检查，不构建 JSON 树
+    auto decodeBody = [&](const char* data, size_t size, const char* what) {
+        if (compressionType == GZIP_COMPRESSION) {
+            m_memory.decompress(data, size, out);
+            if (!out.empty()) {
+                if (serializationMethod == JSON_SERIALIZATION && !json::accept(out)) {
+                    logErrorWithTimestamp(std::string("❌ ") + what + "解压缩后的数据不是有效JSON");
+                    logErrorWithTimestamp("❌ 解压缩数据内容: " + out.substr(0, 100));
+                    out.clear();
+                    return false;
+                }
+                return true;
+            }
+        }
+        
+        // 未压缩的数据（或解压失败时按原始数据处理）
+        out.assign(data, size);
+        if (serializationMethod == JSON_SERIALIZATION && !json::accept(out)) {
+            logErrorWithTimestamp(std::string("❌ ") + what + "未压缩的数据不是有效JSON");
+            logErrorWithTimestamp("❌ 数据内容: " + out.substr(0, 100));
+            out.clear();
+            return false;
+        }
+        return !out.empty();
+    };
     
     // 根据消息类型处理 payload
     if (messageType == FULL_SERVER_RESPONSE) {
         // 完整服务器响应: Header(4字节) + 序列号(4字节) + Payload Size(4字节) + Payload
         // 包含完整的识别结果，可能包含多个utterances和最终状态
-        if (payload.size() < 8) {
+        if (payloadLength < 8) {
             logErrorWithTimestamp("❌ payload 太小，无法解析序列号和payload size");
-            return "";
+            return false;
         }
         
-        // 解析序列号 (4字节，大端序，有符号)
-        // sequence: 对应客户端发送的音频包序列号，用于匹配请求和响应
-        int32_t sequence = 0;
-        for (int i = 0; i < 4; ++i) {
-            sequence = (sequence << 8) | static_cast<unsigned char>(payload[i]);
-        }
+        // 序列号 (4字节，大端序，有符号)：对应客户端发送的音频包序列号，用于匹配请求和响应
 #if ASR_ENABLE_PROTOCOL_LOG
-        logWithTimestamp("  - 序列号: " + std::to_string(sequence));
+        logWithTimestamp("  - 序列号: " + std::to_string(static_cast<int32_t>(readUint32(0))));
 #endif
         
-        // 解析 payload size (4字节，大端序)
-        uint32_t payloadSize = 0;
-        for (int i = 4; i < 8; ++i) {
-            payloadSize = (payloadSize << 8) | static_cast<unsigned char>(payload[i]);
-        }
-        
+        // payload size (4字节，大端序)
+        const uint32_t payloadSize = readUint32(4);
 #if ASR_ENABLE_PROTOCOL_LOG
         logWithTimestamp("  - payload size: " + std::to_string(payloadSize));
 #endif
         
-        if (payload.size() < 8 + payloadSize) {
+        if (payloadLength < 8 + static_cast<size_t>(payloadSize)) {
             logErrorWithTimestamp("❌ payload 数据不完整");
-            return "";
-        }
-        
-        std::string payloadData = payload.substr(8, payloadSize);
-        
-        // 解压缩
-        if (compressionType == GZIP_COMPRESSION) {
-            std::string decompressed = gzipDecompress(payloadData);
-            if (!decompressed.empty()) {
-                // 根据序列化方法处理数据
-                if (serializationMethod == JSON_SERIALIZATION) {
-                    // 验证解压缩后的数据是否为有效的JSON
-                    try {
-                        json parsed = json::parse(decompressed);
-                        (void)parsed; // 避免未使用变量警告
-                        return decompressed;
-                    } catch (const std::exception& e) {
-                        logErrorWithTimestamp("❌ 解压缩后的数据不是有效JSON: " + std::string(e.what()));
-                        logErrorWithTimestamp("❌ 解压缩数据内容: " + decompressed.substr(0, 100));
-                        return "";
-                    }
-                } else {
-                    // 非JSON序列化，直接返回解压缩后的数据
-                    return decompressed;
-                }
-            }
-        }
-        
-        // 验证未压缩的数据
-        if (serializationMethod == JSON_SERIALIZATION) {
-            // 验证未压缩的数据是否为有效的JSON
-            try {
-                json parsed = json::parse(payloadData);
-                (void)parsed; // 避免未使用变量警告
-                return payloadData;
-            } catch (const std::exception& e) {
-                logErrorWithTimestamp("❌ 未压缩的数据不是有效JSON: " + std::string(e.what()));
-                logErrorWithTimestamp("❌ 数据内容: " + payloadData.substr(0, 100));
-                return "";
-            }
-        } else {
-            // 非JSON序列化，直接返回原始数据
-            return payloadData;
+            return false;
         }
+        return decodeBody(payload + 8, payloadSize, "");
     }
     
     if (messageType == SERVER_ACK) {
         // 服务器确认响应: Header(4字节) + 序列号(4字节) + [Payload Size(4字节) + Payload]
         // ACK消息用于确认音频包已被服务器接收，可能包含额外的状态信息
-        if (payload.size() < 4) {
+        if (payloadLength < 4) {
             logErrorWithTimestamp("❌ ACK payload 太小，无法解析序列号");
-            return "";
-        }
-        
-        // 解析序列号 (4字节，大端序，有符号)
-        // sequence: 确认的音频包序列号，表示服务器已成功接收该音频包
-        int32_t sequence = 0;
-        for (int i = 0; i < 4; ++i) {
-            sequence = (sequence << 8) | static_cast<unsigned char>(payload[i]);
+            return false;
         }
         
+        // 序列号 (4字节，大端序，有符号)：服务器已成功接收的音频包
+        const int32_t sequence = static_cast<int32_t>(readUint32(0));
 #if ASR_ENABLE_PROTOCOL_LOG
         logWithTimestamp("  - ACK 序列号: " + std::to_string(sequence));
 #endif
         
         // 检查是否有额外的 payload
-        if (payload.size() >= 8) {
-            // 解析 payload size (4字节，大端序)
-            uint32_t payloadSize = 0;
-            for (int i = 4; i < 8; ++i) {
-                payloadSize = (payloadSize << 8) | static_cast<unsigned char>(payload[i]);
-            }
-            
+        if (payloadLength >= 8) {
+            const uint32_t payloadSize = readUint32(4);
 #if ASR_ENABLE_PROTOCOL_LOG
             logWithTimestamp("  - ACK payload size: " + std::to_string(payloadSize));
 #endif
-            
-            if (payload.size() >= 8 + payloadSize) {
-                std::string payloadData = payload.substr(8, payloadSize);
-                
-                // 解压缩
-                if (compressionType == GZIP_COMPRESSION) {
-                    std::string decompressed = gzipDecompress(payloadData);
-                    if (!decompressed.empty()) {
-                        // 根据序列化方法处理数据
-                        if (serializationMethod == JSON_SERIALIZATION) {
-                            // 验证解压缩后的数据是否为有效的JSON
-                            try {
-                                json parsed = json::parse(decompressed);
-                                (void)parsed; // 避免未使用变量警告
-                                return decompressed;
-                            } catch (const std::exception& e) {
-                                logErrorWithTimestamp("❌ ACK解压缩后的数据不是有效JSON: " + std::string(e.what()));
-                                return "";
-                            }
-                        } else {
-                            // 非JSON序列化，直接返回解压缩后的数据
-                            return decompressed;
-                        }
-                    }
-                }
-                
-                // 验证未压缩的数据
-                if (serializationMethod == JSON_SERIALIZATION) {
-                    // 验证未压缩的数据是否为有效的JSON
-                    try {
-                        json parsed = json::parse(payloadData);
-                        (void)parsed; // 避免未使用变量警告
-                        return payloadData;
-                    } catch (const std::exception& e) {
-                        logErrorWithTimestamp("❌ ACK未压缩的数据不是有效JSON: " + std::string(e.what()));
-                        return "";
-                    }
-                } else {
-                    // 非JSON序列化，直接返回原始数据
-                    return payloadData;
-                }
+            if (payloadLength >= 8 + static_cast<size_t>(payloadSize)) {
+                return decodeBody(payload + 8, payloadSize, "ACK");
             }
         }
         
         // 如果没有 payload，返回简单的 ACK 确认
-        return "{\"type\":\"ack\",\"sequence\":" + std::to_string(sequence) + "}";
+        out.assign("{\"type\":\"ack\",\"sequence\":");
+        out += std::to_string(sequence);
+        out += '}';
+        return true;
     }
     
     if (messageType == ERROR_RESPONSE) {
         // 错误响应: Header(4字节) + 错误码(4字节) + Payload Size(4字节) + Payload
         // 当服务器处理请求时发生错误时返回，包含详细的错误信息
-        if (payload.size() < 8) {
+        if (payloadLength < 8) {
             logErrorWithTimestamp("❌ 错误响应 payload 太小");
-            return "";
+            return false;
         }
         
-        // 解析错误码 (4字节，大端序)
-        // errorCode: 火山引擎ASR官方错误码，用于标识具体的错误类型
+        // 错误码 (4字节，大端序)：火山引擎ASR官方错误码
         // 45xxxxxx: 客户端错误，55xxxxxx: 服务器错误
-        uint32_t errorCode = 0;
-        for (int i = 0; i < 4; ++i) {
-            errorCode = (errorCode << 8) | static_cast<unsigned char>(payload[i]);
-        }
-        
-        // 解析 payload size (4字节，大端序)
-        uint32_t payloadSize = 0;
-        for (int i = 4; i < 8; ++i) {
-            payloadSize = (payloadSize << 8) | static_cast<unsigned char>(payload[i]);
-        }
-        
+        const uint32_t payloadSize = readUint32(4);
 #if ASR_ENABLE_PROTOCOL_LOG
-        logWithTimestamp("  - 错误码: " + std::to_string(errorCode));
+        logWithTimestamp("  - 错误码: " + std::to_string(readUint32(0)));
         logWithTimestamp("  - payload size: " + std::to_string(payloadSize));
 #endif
         
-        if (payload.size() < 8 + payloadSize) {
+        if (payloadLength < 8 + static_cast<size_t>(payloadSize)) {
             logErrorWithTimestamp("❌ 错误响应数据不完整");
-            return "";
-        }
-        
-        std::string payloadData = payload.substr(8, payloadSize);
-        
-        // 解压缩
-        if (compressionType == GZIP_COMPRESSION) {
-            std::string decompressed = gzipDecompress(payloadData);
-            if (!decompressed.empty()) {
-                // 根据序列化方法处理数据
-                if (serializationMethod == JSON_SERIALIZATION) {
-                    // 验证解压缩后的数据是否为有效的JSON
-                    try {
-                        json parsed = json::parse(decompressed);
-                        (void)parsed; // 避免未使用变量警告
-                        return decompressed;
-                    } catch (const std::exception& e) {
-                        logErrorWithTimestamp("❌ 错误响应解压缩后的数据不是有效JSON: " + std::string(e.what()));
-                        return "";
-                    }
-                } else {
-                    // 非JSON序列化，直接返回解压缩后的数据
-                    return decompressed;
-                }
-            }
-        }
-        
-        // 验证未压缩的数据
-        if (serializationMethod == JSON_SERIALIZATION) {
-            // 验证未压缩的数据是否为有效的JSON
-            try {
-                json parsed = json::parse(payloadData);
-                (void)parsed; // 避免未使用变量警告
-                return payloadData;
-            } catch (const std::exception& e) {
-                logErrorWithTimestamp("❌ 错误响应未压缩的数据不是有效JSON: " + std::string(e.what()));
-                return "";
-            }
-        } else {
-            // 非JSON序列化，直接返回原始数据
-            return payloadData;
+            return false;
         }
+        return decodeBody(payload + 8, payloadSize, "错误响应");
     }
     
     logErrorWithTimestamp("❌ 不支持的消息类型: " + std::to_string(messageType));
-    return "";
-}
-
-std::string AsrClient::gzipDecompress(const std::string& data) {
-    if (data.empty()) {
-        return "";
-    }
-    
-    z_stream strm;
-    strm.zalloc = Z_NULL;
-    strm.zfree = Z_NULL;
-    strm.opaque = Z_NULL;
-    strm.avail_in = data.size();
-    strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
-    
-    if (inflateInit2(&strm, 16 + MAX_WBITS) != Z_OK) {
-        logErrorWithTimestamp("❌ GZIP 解压缩初始化失败");
-        return "";
-    }
-    
-    std::string decompressed;
-    char buffer[4096];
-    
-    do {
-        strm.avail_out = sizeof(buffer);
-        strm.next_out = reinterpret_cast<Bytef*>(buffer);
-        
-        int ret = inflate(&strm, Z_NO_FLUSH);
-        if (ret == Z_STREAM_ERROR) {
-            logErrorWithTimestamp("❌ GZIP 解压缩错误");
-            inflateEnd(&strm);
-            return "";
-        }
-        
-        int have = sizeof(buffer) - strm.avail_out;
-        decompressed.append(buffer, have);
-    } while (strm.avail_out == 0);
-    
-    inflateEnd(&strm);
-    return decompressed;
+    return false;
 }
 
 bool AsrClient::testHandshake() {
@@ -5,13 +5,15 @@
 #include "asr/asr_manager.h"
 #include "asr/asr_log_utils.h"
 #include "asr/asr_client.h"
-#include "ui/config_manager.h"  // 添加SecureKeyManager的头文件
 #include "asr/secure_key_manager.h"
+#include "audio/trace_events.h"
 #include <iostream>
 #include <cstdlib>
 #include <nlohmann/json.hpp>
+#include <ixwebsocket/IXExponentialBackoff.h>
 #include <fstream>
 #include <vector>
+#include <deque>
 #include <thread>
 #include <string>
 #include <cstring>
@@ -22,11 +24,31 @@
 #include <stdexcept>
 #include <filesystem>
 #include <mutex>
+#include <atomic>
+#include <ctime>
 
 using json = nlohmann::json;
 
 namespace Asr {
 
+// 文件识别分包时长（毫秒），续传时据此换算包下标与时间轴偏移
+static constexpr int64_t kFilePacketMs = 100;
+// 每确认多少个包写一次续传进度文件（约 5 秒音频）
+static constexpr size_t kFileCheckpointPackets = 50;
+// 单个音频包等待服务端响应的超时（超时视为丢包，续传时从更大的包开始）
+static constexpr int kFileAckTimeoutMs = 3000;
+// 续传进度文件后缀（与音频文件放在同一目录）
+static constexpr const char* kFileProgressSuffix = ".asr_progress.json";
+
+static PacketSizeConfig packetSizeConfigFrom(const AsrConfig& config) {
+    PacketSizeConfig packetConfig;
+    packetConfig.adaptive = config.adaptivePacketSize;
+    packetConfig.initialMs = config.packetMs;
+    packetConfig.minMs = config.minPacketMs;
+    packetConfig.maxMs = config.maxPacketMs;
+    return packetConfig;
+}
+
 // ============================================================================
 // 日志工具函数
 // ============================================================================
@@ -114,6 +136,7 @@ AsrManager::AsrManager()
     
     // 从环境变量加载配置
     loadConfigFromEnv(m_config);
+    m_packetSizer = std::make_shared<PacketSizeController>(packetSizeConfigFrom(m_config));
     
     // 输出初始日志配置（仅在INFO级别以上）
     if (m_config.logLevel >= ASR_LOG_INFO) {
@@ -137,7 +160,13 @@ AsrManager::~AsrManager() {
 // ============================================================================
 
 void AsrManager::setConfig(const AsrConfig& config) {
+    const PacketSizeConfig previous = packetSizeConfigFrom(m_config);
     m_config = config;
+    const PacketSizeConfig next = packetSizeConfigFrom(m_config);
+    if (next.adaptive != previous.adaptive || next.initialMs != previous.initialMs ||
+        next.minMs != previous.minMs || next.maxMs != previous.maxMs) {
+        m_packetSizer->setConfig(next);
+    }
 }
 
 AsrConfig AsrManager::getConfig() const {
@@ -199,7 +228,7 @@ bool AsrManager::connect() {
         }
         
         // 连接客户端，并等待连接成功
-        if (!m_client->connect()) {
+        if (!connectClient(*m_client)) {
             logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ ASR 客户端连接失败", true);
             updateStatus(AsrStatus::ERROR);
             return false;
@@ -234,6 +263,36 @@ bool AsrManager::connect() {
     }
 }
 
+bool AsrManager::connectClient(AsrClient& client) {
+    auto& scheduler = RequestScheduler::instance();
+    SessionLease lease = scheduler.acquireSession(m_config.requestPriority, m_config.schedulerWaitMs, &m_stopFlag);
+    if (!lease.valid()) {
+        logMessage(m_config.logLevel, ASR_LOG_ERROR,
+                   std::string("❌ 等待会话许可超时 (优先级: ") + requestPriorityName(m_config.requestPriority) + ")", true);
+        return false;
+    }
+    // 建连失败经 onError 回调反馈给调度器
+    if (!client.connect()) {
+        return false;
+    }
+    scheduler.reportSuccess();
+    client.setSchedulerLease(std::move(lease));
+    return true;
+}
+
+bool AsrManager::acquireAudioBudget(size_t bytes) {
+    if (!m_client || bytes == 0) {
+        return true;
+    }
+    const auto& api = m_client->getApiConfig();
+    const double bytesPerSecond = static_cast<double>(api.sampleRate) * (api.bits / 8) * api.channels;
+    if (bytesPerSecond <= 0.0) {
+        return true;
+    }
+    return RequestScheduler::instance().acquireAudio(m_config.requestPriority, static_cast<double>(bytes) / bytesPerSecond,
+                                                     m_config.schedulerWaitMs, &m_stopFlag);
+}
+
 void AsrManager::disconnect() {
     logMessage(m_config.logLevel, ASR_LOG_INFO, "🔌 开始断开 ASR 连接...");
     
@@ -270,11 +329,22 @@ bool AsrManager::sendAudio(const std::vector<uint8_t>& audioData, bool isLast) {
     
     updateStatus(AsrStatus::RECOGNIZING);
     
+    if (!acquireAudioBudget(audioData.size())) {
+        logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ 等待音频额度超时，未发送音频", true);
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> sessionLock(m_sessionMutex_);
     if (!m_client->sendAudio(audioData, isLast)) {
         logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ 发送音频数据失败", true);
         return false;
     }
     
+    // 会话切换的重叠窗口内，同一段音频同时发往备用会话
+    if (m_standbyClient && !m_standbyClient->sendAudio(audioData, isLast)) {
+        logMessage(m_config.logLevel, ASR_LOG_WARN, "⚠️ 发送音频到备用会话失败");
+    }
+    
     // 业务层日志
     if (m_config.enableBusinessLog) {
         logMessage(m_config.logLevel, ASR_LOG_DEBUG, "📤 音频数据发送成功 (" + std::to_string(audioData.size()) + " bytes)");
@@ -334,6 +404,8 @@ void AsrManager::stopRecognition() {
     m_stopFlag = true;
     m_stopRequested = true;
     
+    discardStandbySession();
+    
     // 断开客户端连接
     if (m_client) {
         logMessage(m_config.logLevel, ASR_LOG_INFO, "🔌 断开ASR客户端连接...");
@@ -371,6 +443,89 @@ void AsrManager::stopRecognition() {
     logMessage(m_config.logLevel, ASR_LOG_INFO, "✅ ASR识别已停止");
 }
 
+// ============================================================================
+// 实时会话无缝切换
+// ============================================================================
+
+std::unique_ptr<AsrClient> AsrManager::openStandbySession() {
+    logMessage(m_config.logLevel, ASR_LOG_INFO, "🔗 正在建立备用识别会话...");
+    
+    std::unique_ptr<AsrClient> client = createConfiguredClient();
+    if (!client || !connectClient(*client)) {
+        logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ 备用会话连接失败", true);
+        return nullptr;
+    }
+    
+    std::string response;
+    if (!client->sendFullClientRequestAndWaitResponse(10000, &response)) {
+        logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ 备用会话初始化失败", true);
+        client->disconnect();
+        return nullptr;
+    }
+    try {
+        json j = json::parse(response);
+        if (j.contains("error") || (j.contains("code") && j["code"] != 0)) {
+            logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ 备用会话 Full Server Response 包含错误: " + response, true);
+            client->disconnect();
+            return nullptr;
+        }
+    } catch (...) {
+        // 忽略解析失败，假定成功
+    }
+    
+    logMessage(m_config.logLevel, ASR_LOG_INFO, "✅ 备用识别会话已就绪");
+    return client;
+}
+
+void AsrManager::attachStandbySession(std::unique_ptr<AsrClient> client) {
+    std::unique_ptr<AsrClient> previous;
+    {
+        std::lock_guard<std::mutex> lock(m_sessionMutex_);
+        previous = std::move(m_standbyClient);
+        m_standbyClient = std::move(client);
+    }
+    if (previous) {
+        previous->disconnect();
+    }
+}
+
+std::unique_ptr<AsrClient> AsrManager::promoteStandbySession() {
+    std::lock_guard<std::mutex> lock(m_sessionMutex_);
+    if (!m_standbyClient) {
+        return nullptr;
+    }
+    std::unique_ptr<AsrClient> previous = std::move(m_client);
+    m_client = std::move(m_standbyClient);
+    // 旧主会话可能已断开并把状态置为 DISCONNECTED，以新主会话的连接状态为准
+    if (m_client->isConnected()) {
+        updateStatus(AsrStatus::RECOGNIZING);
+    }
+    logMessage(m_config.logLevel, ASR_LOG_INFO, "🔀 备用会话已切换为主会话");
+    return previous;
+}
+
+void AsrManager::discardStandbySession() {
+    std::unique_ptr<AsrClient> standby;
+    {
+        std::lock_guard<std::mutex> lock(m_sessionMutex_);
+        standby = std::move(m_standbyClient);
+    }
+    if (standby) {
+        standby->disconnect();
+        logMessage(m_config.logLevel, ASR_LOG_INFO, "🔌 备用会话已断开");
+    }
+}
+
+bool AsrManager::hasStandbySession() const {
+    std::lock_guard<std::mutex> lock(m_sessionMutex_);
+    return m_standbyClient != nullptr;
+}
+
+const AsrClient* AsrManager::getActiveClient() const {
+    std::lock_guard<std::mutex> lock(m_sessionMutex_);
+    return m_client.get();
+}
+
 // ============================================================================
 // 结果获取方法
 // ============================================================================
@@ -441,9 +596,9 @@ bool AsrManager::loadConfigFromEnv(AsrConfig& config) {
         std::cout << "   export VOLC_SECRET_KEY=your_secret_key" << std::endl;
         
         // 使用SecureKeyManager获取混淆的API密钥（体验模式）
-        config.appId = perfx::ui::SecureKeyManager::getAppId();
-        config.accessToken = perfx::ui::SecureKeyManager::getAccessToken();
-        config.secretKey = perfx::ui::SecureKeyManager::getSecretKey();
+        config.appId = SecureKeyManager::getAppId();
+        config.accessToken = SecureKeyManager::getAccessToken();
+        config.secretKey = SecureKeyManager::getSecretKey();
         config.isValid = true;
         config.configSource = "trial_mode";
         
@@ -463,10 +618,37 @@ bool AsrManager::loadConfigFromEnv(AsrConfig& config) {
     if (dataLog) config.enableDataLog = (std::string(dataLog) == "1");
     if (protocolLog) config.enableProtocolLog = (std::string(protocolLog) == "1");
     if (audioLog) config.enableAudioLog = (std::string(audioLog) == "1");
+
+    // 分包配置：ASR_PACKET_MS 指定初始包时长，ASR_ADAPTIVE_PACKET=0 时固定使用该值
+    const char* packetMs = std::getenv("ASR_PACKET_MS");
+    const char* adaptivePacket = std::getenv("ASR_ADAPTIVE_PACKET");
+    if (packetMs && std::atoi(packetMs) > 0) config.packetMs = std::atoi(packetMs);
+    if (adaptivePacket) config.adaptivePacketSize = (std::string(adaptivePacket) != "0");
+
+    // 调度优先级：ASR_PRIORITY=live|interactive|batch
+    const char* priority = std::getenv("ASR_PRIORITY");
+    if (priority) parseRequestPriority(priority, config.requestPriority);
     
     return true;
 }
 
+int AsrManager::getPacketMs() const {
+    return m_packetSizer->packetMs();
+}
+
+std::shared_ptr<PacketSizeController> AsrManager::getPacketSizeController() const {
+    return m_packetSizer;
+}
+
+PacketSizeStats AsrManager::getPacketSizeStats() const {
+    return m_packetSizer->stats();
+}
+
+SessionMemoryStats AsrManager::getMemoryStats() const {
+    std::lock_guard<std::mutex> lock(m_sessionMutex_);
+    return m_client ? m_client->getMemoryStats() : SessionMemoryStats();
+}
+
 std::string AsrManager::getStatusName(AsrStatus status) {
     switch (status) {
         case AsrStatus::DISCONNECTED:
@@ -488,11 +670,75 @@ std::string AsrManager::getStatusName(AsrStatus status) {
 // 私有方法
 // ============================================================================
 
+// 为客户端附加会话录制器（PERFX_ASR_CAPTURE_DIR），每个客户端一个抓包文件
+static void attachSessionRecorder(AsrClient& client, const std::string& captureDir) {
+    static std::atomic<uint64_t> s_captureCounter{0};
+
+    std::error_code ec;
+    std::filesystem::create_directories(captureDir, ec);
+
+    const auto now = std::chrono::system_clock::now();
+    const std::time_t nowTime = std::chrono::system_clock::to_time_t(now);
+    std::tm localTime{};
+#ifdef _WIN32
+    localtime_s(&localTime, &nowTime);
+#else
+    localtime_r(&nowTime, &localTime);
+#endif
+    std::ostringstream name;
+    name << "asr-" << std::put_time(&localTime, "%Y%m%d-%H%M%S") << "-" << s_captureCounter++ << ".pxac";
+    const std::string path = (std::filesystem::path(captureDir) / name.str()).string();
+
+    // 元数据只含地址与请求参数，凭据在握手头中，不写入抓包
+    json metadata = {
+        {"format", "perfx-asr-capture"},
+        {"created_ms", std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count()},
+        {"url", client.getApiConfig().cluster},
+        {"request", json::parse(client.getFullClientRequestJson(), nullptr, false)}
+    };
+    auto recorder = std::make_shared<SessionRecorder>();
+    recorder->open(path, metadata.dump());
+    client.setSessionRecorder(std::move(recorder));
+}
+
 std::unique_ptr<AsrClient> AsrManager::createClient(ClientType type) {
     (void)type; // 忽略参数，当前只支持IXWebSocket
     return std::make_unique<AsrClient>();
 }
 
+std::unique_ptr<AsrClient> AsrManager::createConfiguredClient() {
+    std::unique_ptr<AsrClient> client = createClient(m_config.clientType);
+    if (!client) {
+        return nullptr;
+    }
+    
+    // 设置客户端配置 - 使用AsrApiConfig
+    // 注意：所有API相关的配置都由AsrClient内部管理，这里只传递必要的认证信息
+    client->setAppId(m_config.appId);
+    client->setToken(m_config.accessToken);
+    client->setSecretKey(m_config.secretKey);
+    
+    // 设置默认音频格式 (这些配置现在由AsrClient管理)
+    client->setAudioFormat("pcm", 1, 16000, 16, "raw");
+    
+    // 将 AsrManager 自身设置为回调处理者
+    client->setCallback(this);
+    client->setPacketSizeController(m_packetSizer);
+    client->setSegDuration(m_packetSizer->packetMs());
+
+    // 指向非默认服务端，例如本地模拟服务端（perfx-cli replay --mode server）
+    const char* url = std::getenv("PERFX_ASR_URL");
+    if (url && *url) {
+        client->setCluster(url);
+    }
+    // 会话抓包：文件在第一帧收发时才创建
+    const char* captureDir = std::getenv("PERFX_ASR_CAPTURE_DIR");
+    if (captureDir && *captureDir) {
+        attachSessionRecorder(*client, captureDir);
+    }
+    return client;
+}
+
 bool AsrManager::initializeClient() {
     if (m_client) {
         logMessage(m_config.logLevel, ASR_LOG_DEBUG, "✅ 客户端已存在，跳过初始化");
@@ -501,24 +747,12 @@ bool AsrManager::initializeClient() {
     
     logMessage(m_config.logLevel, ASR_LOG_DEBUG, "📡 正在创建IXWebSocket客户端");
     
-    m_client = createClient(m_config.clientType);
+    m_client = createConfiguredClient();
     if (!m_client) {
         logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ 创建客户端实例失败", true);
         return false;
     }
     
-    // 设置客户端配置 - 使用AsrApiConfig
-    // 注意：所有API相关的配置都由AsrClient内部管理，这里只传递必要的认证信息
-    m_client->setAppId(m_config.appId);
-    m_client->setToken(m_config.accessToken);
-    m_client->setSecretKey(m_config.secretKey);
-    
-    // 设置默认音频格式 (这些配置现在由AsrClient管理)
-    m_client->setAudioFormat("pcm", 1, 16000, 16, "raw");
-    
-    // 将 AsrManager 自身设置为回调处理者
-    m_client->setCallback(this);
-    
     logMessage(m_config.logLevel, ASR_LOG_DEBUG, "✅ 客户端配置完成");
     return true;
 }
@@ -746,18 +980,117 @@ bool AsrManager::recognizeAudioFile(const std::string& filePath, bool waitForFin
         logMessage(m_config.logLevel, ASR_LOG_INFO, "📦 音频包[" + std::to_string(i) + "]: " + std::to_string(m_audioPackets[i].size()) + " 字节");
     }
     
-    // 步骤3: 连接ASR服务
-    if (m_config.enableFlowLog) {
-        logMessage(m_config.logLevel, ASR_LOG_INFO, "=== 步骤3: 连接ASR服务 ===");
+    // 步骤3: 查询识别结果缓存与续传进度
+    // 客户端先创建不连接，缓存命中时无需联网
+    if (!resetFileClient(audioInfo)) {
+        logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ 创建ASR客户端失败", true);
+        return false;
+    }
+    
+    const std::string cacheKey = TranscriptionCache::makeKey(audioData, m_client->getApiConfig());
+    {
+        std::lock_guard<std::mutex> lock(m_fileResultMutex_);
+        m_fileResult_ = TranscriptionCacheEntry();
+        m_fileResult_.key = cacheKey;
+        m_fileResult_.sourcePath = filePath;
+        m_fileResult_.totalPackets = m_audioPackets.size();
+        m_fileResultBase_ = 0;
+        m_fileResultOffsetMs_ = 0;
+        m_fileProgressPath_ = filePath + kFileProgressSuffix;
+        m_fileResultActive_ = true;
+    }
+    
+    TranscriptionCacheEntry resumeFrom;
+    if (TranscriptionCache* cache = getResultCache()) {
+        TranscriptionCacheEntry cached;
+        if (cache->load(cacheKey, cached)) {
+            if (cached.complete) {
+                {
+                    std::lock_guard<std::mutex> lock(m_fileResultMutex_);
+                    m_fileResultActive_ = false;
+                }
+                logMessage(m_config.logLevel, ASR_LOG_INFO, "⚡ 命中识别结果缓存: " + std::to_string(cached.utterances.size()) + " 个分句");
+                if (m_callback) {
+                    m_callback->onMessage(m_client.get(), TranscriptionCache::toServerMessage(cached.utterances));
+                }
+                logMessage(m_config.logLevel, ASR_LOG_INFO, "=== 识别流程结束 ===");
+                return true;
+            }
+            resumeFrom = std::move(cached);
+        }
     }
     
+    // 文件旁的续传进度文件（关闭结果缓存时同样生效），取进度较多的一方
+    TranscriptionCacheEntry progress;
+    if (TranscriptionCache::readEntryFile(filePath + kFileProgressSuffix, cacheKey, progress) &&
+        progress.ackedPackets > resumeFrom.ackedPackets) {
+        resumeFrom = std::move(progress);
+    }
+    if (resumeFrom.totalPackets == m_audioPackets.size() && resumeFrom.ackedPackets > 0) {
+        std::lock_guard<std::mutex> lock(m_fileResultMutex_);
+        m_fileResult_.utterances = std::move(resumeFrom.utterances);
+        m_fileResult_.ackedPackets = resumeFrom.ackedPackets;
+    }
+    size_t startPacket = prepareFileResume();
+    if (startPacket > 0) {
+        logMessage(m_config.logLevel, ASR_LOG_INFO, "♻️ 从上次进度续传: 已定稿 " + std::to_string(m_fileResultBase_) +
+                   " 个分句，从第 " + std::to_string(startPacket + 1) + " 个包继续");
+    }
+    
+    // 步骤4: 识别会话；断线时按指数退避重连，从最后一个定稿分句处开启新会话
+    uint32_t retryCount = 0;
+    while (true) {
+        bool receivedFinal = false;
+        if (runFileSession(startPacket, waitForFinal, timeoutMs, receivedFinal)) {
+            finishFileResult(receivedFinal);
+            logMessage(m_config.logLevel, ASR_LOG_INFO, "=== 识别流程结束 ===");
+            return true;
+        }
+        
+        size_t ackedPackets = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_fileResultMutex_);
+            ackedPackets = m_fileResult_.ackedPackets;
+        }
+        saveFileProgress();
+        
+        // 本次会话有进展则重新计算退避，只有连续无进展的失败才计入上限
+        if (ackedPackets > startPacket) {
+            retryCount = 0;
+        }
+        if (static_cast<int>(retryCount) >= m_config.fileRetryMaxAttempts || m_stopFlag) {
+            logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ 文件识别失败，已保存进度: " + std::to_string(ackedPackets) +
+                       "/" + std::to_string(m_audioPackets.size()) + " 个包", true);
+            finishFileResult(false);
+            return false;
+        }
+        
+        // 服务端限流 / 配额 / 繁忙时按调度器的退避等待，避免各会话同时重试再次撞上限制
+        const uint32_t waitMs = m_client && RequestScheduler::isLimitError(m_client->getLastError().code)
+            ? RequestScheduler::instance().retryDelayMs(retryCount)
+            : ix::calculateRetryWaitMilliseconds(retryCount, m_config.fileRetryMaxWaitMs, m_config.fileRetryMinWaitMs);
+        ++retryCount;
+        logMessage(m_config.logLevel, ASR_LOG_WARN, "🔁 " + std::to_string(waitMs) + "ms 后重连 (第 " +
+                   std::to_string(retryCount) + " 次)");
+        for (uint32_t waited = 0; waited < waitMs && !m_stopFlag; waited += 100) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        
+        if (!resetFileClient(audioInfo)) {
+            finishFileResult(false);
+            return false;
+        }
+        startPacket = prepareFileResume();
+        logMessage(m_config.logLevel, ASR_LOG_INFO, "♻️ 续传: 从第 " + std::to_string(startPacket + 1) + " 个包开始新会话");
+    }
+}
+
+bool AsrManager::resetFileClient(const AudioFileInfo& audioInfo) {
     // 确保客户端使用更新后的配置重新初始化
     if (m_client) {
         m_client.reset(); // 重置客户端，强制重新初始化
     }
-    
-    if (!connect()) {
-        logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ 连接ASR服务失败", true);
+    if (!initializeClient()) {
         return false;
     }
     
@@ -769,8 +1102,23 @@ bool AsrManager::recognizeAudioFile(const std::string& filePath, bool waitForFin
     }
     
     m_client->setAudioFormat(format, audioInfo.channels, audioInfo.sampleRate, audioInfo.bitsPerSample, audioInfo.codec);
+    return true;
+}
+
+bool AsrManager::runFileSession(size_t startPacket, bool waitForFinal, int timeoutMs, bool& receivedFinal) {
+    receivedFinal = false;
+    
+    // 连接ASR服务
+    if (m_config.enableFlowLog) {
+        logMessage(m_config.logLevel, ASR_LOG_INFO, "=== 连接ASR服务 ===");
+    }
+    
+    if (!connect()) {
+        logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ 连接ASR服务失败", true);
+        return false;
+    }
     
-    // 步骤4: 发送Full Client Request（初始化包），并等待服务器响应
+    // 发送Full Client Request（初始化包），并等待服务器响应
     std::string response;
     if (!m_client->sendFullClientRequestAndWaitResponse(10000, &response)) {
         logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ 初始化包发送失败或未收到服务器响应", true);
@@ -789,52 +1137,227 @@ bool AsrManager::recognizeAudioFile(const std::string& filePath, bool waitForFin
         // 忽略解析失败，假定成功
     }
 
-    // 步骤5: 分包发送音频，每包都等待服务器响应
-    logMessage(m_config.logLevel, ASR_LOG_INFO, "=== 步骤5: 开始发送音频包 ===");
-    for (size_t i = 0; i < m_audioPackets.size(); ++i) {
-        bool isLast = (i == m_audioPackets.size() - 1);
-        int seq = 2 + i;
+    // 分包发送音频，每包的服务器响应经 Future 异步确认：发送线程只按音频时长控制节奏，
+    // 每次发送前收取已完成的确认，响应超时或出错时终止本次会话
+    // 续传时新会话的序号仍从2开始，包下标从 startPacket 开始
+    // 续传下标与进度始终以 kFilePacketMs 为单位；按控制器的包时长把连续几个单位合并成一个包发送
+    logMessage(m_config.logLevel, ASR_LOG_INFO, "=== 开始发送音频包 ===");
+    struct PendingAck {
+        size_t end;
+        int32_t seq;
+        uint64_t traceFlow;
+        AsrFuture<std::string> response;
+    };
+    std::deque<PendingAck> pendingAcks;
+    // 按发送顺序收取已完成的确认；返回 false 表示有包响应超时或出错
+    auto collectAcks = [this, &pendingAcks]() {
+        size_t acked = 0;
+        bool failed = false;
+        while (!pendingAcks.empty() && pendingAcks.front().response.ready()) {
+            const PendingAck& ack = pendingAcks.front();
+            if (!ack.response.ok()) {
+                const AsyncError error = ack.response.error();
+                if (error.code == ERROR_TIMEOUT) {
+                    logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ 等待音频包响应超时 seq=" + std::to_string(ack.seq), true);
+                    // 续传的新会话从更大的包开始
+                    m_packetSizer->onLoss(perfx::audio::metrics::nowNs());
+                } else {
+                    logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ 音频包响应失败 seq=" + std::to_string(ack.seq) +
+                               ": " + error.message, true);
+                }
+                failed = true;
+                break;
+            }
+            perfx::audio::trace::flowEnd("asr.file_ack", ack.traceFlow);
+            acked = ack.end;
+            pendingAcks.pop_front();
+        }
+        if (acked > 0) {
+            std::lock_guard<std::mutex> lock(m_fileResultMutex_);
+            m_fileResult_.ackedPackets = std::max(m_fileResult_.ackedPackets, acked);
+        }
+        return !failed;
+    };
+    std::vector<uint8_t> wirePacket;
+    int seq = 2;
+    for (size_t i = startPacket; i < m_audioPackets.size();) {
+        const size_t units = static_cast<size_t>(std::max<int64_t>(1, m_packetSizer->packetMs() / kFilePacketMs));
+        const size_t end = std::min(m_audioPackets.size(), i + units);
+        bool isLast = (end == m_audioPackets.size());
         int sendSeq = isLast ? -seq : seq;
+        ++seq;
+        wirePacket.clear();
+        for (size_t k = i; k < end; ++k) {
+            wirePacket.insert(wirePacket.end(), m_audioPackets[k].begin(), m_audioPackets[k].end());
+        }
 
-        logMessage(m_config.logLevel, ASR_LOG_INFO, "📤 发送音频包 " + std::to_string(i+1) + "/" + std::to_string(m_audioPackets.size()) + " (seq=" + std::to_string(sendSeq) + ")");
+        logMessage(m_config.logLevel, ASR_LOG_INFO, "📤 发送音频包 " + std::to_string(end) + "/" + std::to_string(m_audioPackets.size()) + " (seq=" + std::to_string(sendSeq) + ")");
 
+        if (!collectAcks()) {
+            m_client->disconnect();
+            return false;
+        }
         if (!m_client->isConnected()) {
             logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ 连接已断开，终止流式发送", true);
             m_client->disconnect();
             return false;
         }
-        if (!m_client->sendAudio(m_audioPackets[i], sendSeq)) {
-            logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ 发送音频包失败 seq=" + std::to_string(sendSeq), true);
+        // 文件识别没有采集时间，以发包时刻作为追踪流 id
+        perfx::audio::trace::setThreadName("asr.worker");
+        const uint64_t traceFlow = perfx::audio::trace::enabled()
+            ? static_cast<uint64_t>(perfx::audio::metrics::nowNs()) : 0;
+        perfx::audio::trace::flowBegin("asr.file_packet", traceFlow);
+        perfx::audio::trace::setCurrentFlow(traceFlow);
+        if (!acquireAudioBudget(wirePacket.size())) {
+            logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ 等待音频额度超时 seq=" + std::to_string(sendSeq), true);
             m_client->disconnect();
             return false;
         }
-        // 等待服务器响应
-        std::string audioResp;
-        if (!m_client->waitForResponse(3000, &audioResp)) {
-            logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ 等待音频包响应超时 seq=" + std::to_string(sendSeq), true);
+        AsrFuture<std::string> response = m_client->sendAudioAsync(wirePacket, sendSeq, kFileAckTimeoutMs);
+        if (response.ready() && !response.ok()) {
+            logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ 发送音频包失败 seq=" + std::to_string(sendSeq), true);
             m_client->disconnect();
             return false;
         }
-        // 可加最小帧间隔sleep (使用固定的100ms间隔)
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        pendingAcks.push_back({end, sendSeq, traceFlow, std::move(response)});
+        if (end / kFileCheckpointPackets != i / kFileCheckpointPackets) {
+            saveFileProgress();
+        }
+        // 按本包音频时长控制发送节奏
+        std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int64_t>(end - i) * kFilePacketMs));
+        i = end;
     }
 
-    // 步骤6: 等待最终识别结果（可选）
+    // 等待最终识别结果（可选）；连接断开时 Future 立即失败
     if (waitForFinal) {
-        int totalWait = 0, maxWait = timeoutMs > 0 ? timeoutMs : 5000;
-        while (totalWait < maxWait) {
-            if (m_client->hasReceivedFinalResponse()) break;
-            if (!m_client->isConnected()) break;
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            totalWait += 100;
-        }
+        const int maxWait = timeoutMs > 0 ? timeoutMs : 5000;
+        PERFX_TRACE_SCOPE("asr.wait_final");
+        m_client->finalResponseAsync(maxWait).wait(maxWait);
     }
 
+    receivedFinal = m_client->hasReceivedFinalResponse();
+    if (receivedFinal) {
+        // 最终结果即最后一个包的响应，之前的包都已确认
+        pendingAcks.clear();
+        std::lock_guard<std::mutex> lock(m_fileResultMutex_);
+        m_fileResult_.ackedPackets = m_audioPackets.size();
+    } else {
+        collectAcks();
+    }
+    const bool droppedBeforeFinal = waitForFinal && !receivedFinal && !m_client->isConnected();
     m_client->disconnect();
-    logMessage(m_config.logLevel, ASR_LOG_INFO, "=== 识别流程结束 ===");
+    if (droppedBeforeFinal) {
+        logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ 等待最终结果时连接断开", true);
+        return false;
+    }
     return true;
 }
 
+size_t AsrManager::prepareFileResume() {
+    std::lock_guard<std::mutex> lock(m_fileResultMutex_);
+    // 只保留开头连续的定稿分句，从最后一个定稿分句结束处续传。
+    // 分句边界处是静音，向上取整到包边界不会截断下一句
+    const size_t finalized = m_fileResult_.finalizedCount();
+    const int64_t boundaryMs = m_fileResult_.finalizedEndMs();
+    size_t startPacket = std::min(static_cast<size_t>((boundaryMs + kFilePacketMs - 1) / kFilePacketMs),
+                                  m_fileResult_.ackedPackets);
+    // 至少重发最后一个包，否则服务端收不到结束标记
+    if (!m_audioPackets.empty()) {
+        startPacket = std::min(startPacket, m_audioPackets.size() - 1);
+    }
+    
+    // 起点被已确认包数或末包截到边界之前时，该点之后结束的定稿分句会被重新识别，丢掉以免重复
+    const int64_t offsetMs = static_cast<int64_t>(startPacket) * kFilePacketMs;
+    size_t kept = finalized;
+    while (kept > 0 && m_fileResult_.utterances[kept - 1].endMs > offsetMs) {
+        --kept;
+    }
+    
+    m_fileResult_.utterances.resize(kept);
+    m_fileResult_.ackedPackets = startPacket;
+    m_fileResultBase_ = kept;
+    m_fileResultOffsetMs_ = offsetMs;
+    return startPacket;
+}
+
+void AsrManager::saveFileProgress() {
+    TranscriptionCacheEntry progress;
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(m_fileResultMutex_);
+        if (!m_fileResultActive_ || m_fileResult_.ackedPackets == 0) {
+            return;
+        }
+        // 进度文件只记录定稿分句，未定稿部分续传时会重新识别
+        progress.key = m_fileResult_.key;
+        progress.sourcePath = m_fileResult_.sourcePath;
+        progress.totalPackets = m_fileResult_.totalPackets;
+        progress.ackedPackets = m_fileResult_.ackedPackets;
+        progress.utterances.assign(m_fileResult_.utterances.begin(),
+                                   m_fileResult_.utterances.begin() + m_fileResult_.finalizedCount());
+        path = m_fileProgressPath_;
+    }
+    
+    std::string error;
+    if (!TranscriptionCache::writeEntryFile(path, progress, &error)) {
+        logMessage(m_config.logLevel, ASR_LOG_WARN, "⚠️ 保存识别进度失败: " + error);
+    }
+}
+
+TranscriptionCache* AsrManager::getResultCache() {
+    if (!m_config.enableResultCache) {
+        return nullptr;
+    }
+    if (!m_resultCache_) {
+        std::string dataDir = m_config.statsDataDir;
+        if (dataDir.empty()) {
+            dataDir = std::filesystem::current_path().string() + "/data";
+        }
+        m_resultCache_ = std::make_unique<TranscriptionCache>(dataDir + "/asr_cache", m_config.resultCacheMaxBytes);
+    }
+    return m_resultCache_.get();
+}
+
+void AsrManager::finishFileResult(bool complete) {
+    if (!complete) {
+        saveFileProgress();
+    }
+    
+    TranscriptionCacheEntry entry;
+    std::string progressPath;
+    {
+        std::lock_guard<std::mutex> lock(m_fileResultMutex_);
+        if (!m_fileResultActive_) {
+            return;
+        }
+        m_fileResultActive_ = false;
+        m_fileResult_.complete = complete;
+        entry = m_fileResult_;
+        progressPath = m_fileProgressPath_;
+    }
+    
+    // 识别完成后进度文件不再需要
+    if (complete) {
+        std::error_code ec;
+        std::filesystem::remove(progressPath, ec);
+    }
+    
+    // 未确认任何包的失败会话没有可续传的进度
+    if (!complete && entry.ackedPackets == 0) {
+        return;
+    }
+    TranscriptionCache* cache = getResultCache();
+    if (!cache) {
+        return;
+    }
+    if (cache->store(entry)) {
+        logMessage(m_config.logLevel, ASR_LOG_INFO, std::string(complete ? "💾 识别结果已写入缓存" : "💾 已保存识别进度") +
+                   ": " + std::to_string(entry.ackedPackets) + "/" + std::to_string(entry.totalPackets) + " 个包");
+    } else {
+        logMessage(m_config.logLevel, ASR_LOG_WARN, "⚠️ 写入识别结果缓存失败: " + cache->getLastError());
+    }
+}
+
 // ============================================================================
 // 异步音频识别方法实现
 // ============================================================================
@@ -1509,7 +2032,10 @@ AudioFileInfo Asr::AsrManager::parseWavFile(const std::string& filePath, const s
 // ============================================================================
 
 void Asr::AsrManager::onOpen(AsrClient* client) {
-    (void)client;
+    // 备用会话与切换后正在收尾的旧会话不影响主会话状态与计时
+    if (client && client != getActiveClient()) {
+        return;
+    }
     logMessage(m_config.logLevel, ASR_LOG_INFO, "🔗 ASR连接已打开");
     updateStatus(AsrStatus::CONNECTED);
     
@@ -1518,7 +2044,10 @@ void Asr::AsrManager::onOpen(AsrClient* client) {
 }
 
 void Asr::AsrManager::onClose(AsrClient* client) {
-    (void)client;
+    // 备用会话与切换后正在收尾的旧会话不影响主会话状态与计时
+    if (client && client != getActiveClient()) {
+        return;
+    }
     logMessage(m_config.logLevel, ASR_LOG_INFO, "🔌 ASR连接已关闭");
     updateStatus(AsrStatus::DISCONNECTED);
     
@@ -1527,7 +2056,14 @@ void Asr::AsrManager::onClose(AsrClient* client) {
 }
 
 void Asr::AsrManager::onError(AsrClient* client, const std::string& error) {
-    (void)client;
+    // 所有会话的限流 / 配额 / 繁忙错误都反馈给调度器
+    if (client) {
+        RequestScheduler::instance().reportError(client->getLastError().code);
+    }
+    // 备用会话与切换后正在收尾的旧会话不影响主会话状态与计时
+    if (client && client != getActiveClient()) {
+        return;
+    }
     logMessage(m_config.logLevel, ASR_LOG_ERROR, "❌ ASR连接错误: " + error, true);
     updateStatus(AsrStatus::ERROR);
     
@@ -1543,9 +2079,27 @@ void Asr::AsrManager::onMessage(AsrClient* client, const std::string& message) {
         logMessage(m_config.logLevel, ASR_LOG_DEBUG, "📨 收到ASR消息: " + message);
     }
     
+    // 文件识别：累计结果供缓存；续传会话的时间戳平移到文件时间轴，
+    // 并与之前定稿的分句合并后再转发，回调方看到的是完整结果
+    std::string forwarded;
+    {
+        std::lock_guard<std::mutex> lock(m_fileResultMutex_);
+        if (m_fileResultActive_) {
+            std::vector<CachedUtterance> utterances;
+            if (TranscriptionCache::parseServerMessage(message, m_fileResultOffsetMs_, utterances)) {
+                m_fileResult_.utterances.resize(m_fileResultBase_);
+                m_fileResult_.utterances.insert(m_fileResult_.utterances.end(),
+                                                utterances.begin(), utterances.end());
+                if (m_fileResultBase_ > 0 || m_fileResultOffsetMs_ > 0) {
+                    forwarded = TranscriptionCache::toServerMessage(m_fileResult_.utterances);
+                }
+            }
+        }
+    }
+    
     // 如果有回调函数，转发消息
     if (m_callback) {
-        m_callback->onMessage(client, message);
+        m_callback->onMessage(client, forwarded.empty() ? message : forwarded);
     }
     
     // 解析消息并更新状态
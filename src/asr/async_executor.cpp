@@ -0,0 +1,162 @@
+//
+// 异步执行器实现
+//
+
+#include "asr/async_executor.h"
+#include "audio/trace_events.h"
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <map>
+
+namespace Asr {
+
+struct AsyncExecutor::Queue {
+    std::deque<Task> tasks;
+    std::multimap<Clock::time_point, Task> timers;
+    bool stopping = false;
+    uint64_t executed = 0;
+    size_t threads = 1;
+    std::mutex mutex;
+    std::condition_variable cv;
+
+    void run();
+};
+
+void AsyncExecutor::Queue::run() {
+    perfx::audio::trace::setThreadName("asr.async");
+    std::deque<Task> batch;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        // 到期的定时器排在已就绪任务之后，按到期顺序执行
+        const auto now = Clock::now();
+        while (!timers.empty() && timers.begin()->first <= now) {
+            tasks.push_back(std::move(timers.begin()->second));
+            timers.erase(timers.begin());
+        }
+        if (tasks.empty()) {
+            if (timers.empty()) {
+                cv.wait(lock);
+            } else {
+                cv.wait_until(lock, timers.begin()->first);
+            }
+            continue;
+        }
+
+        // 单线程时整批取出减少加锁；多线程时每次取一个，让其他线程分担
+        if (threads <= 1) {
+            batch.swap(tasks);
+        } else {
+            batch.push_back(std::move(tasks.front()));
+            tasks.pop_front();
+        }
+        lock.unlock();
+        for (auto& task : batch) {
+            try {
+                task();
+            } catch (const std::exception& e) {
+                std::cerr << "[ASR-ASYNC] 任务异常: " << e.what() << std::endl;
+            } catch (...) {
+                std::cerr << "[ASR-ASYNC] 任务发生未知异常" << std::endl;
+            }
+        }
+        const size_t count = batch.size();
+        // 任务可能持有执行器的最后一个引用，在锁外析构
+        batch.clear();
+        lock.lock();
+        executed += count;
+    }
+}
+
+AsyncExecutor::AsyncExecutor(int threads) : m_queue(std::make_shared<Queue>()) {
+    const int count = std::max(1, threads);
+    m_queue->threads = static_cast<size_t>(count);
+    m_threads.reserve(m_queue->threads);
+    for (int i = 0; i < count; ++i) {
+        std::shared_ptr<Queue> queue = m_queue;
+        m_threads.emplace_back([queue]() { queue->run(); });
+    }
+}
+
+AsyncExecutor::~AsyncExecutor() {
+    shutdown();
+}
+
+std::shared_ptr<AsyncExecutor> AsyncExecutor::shared() {
+    // 不析构：静态对象析构时完成的 Future 仍可能向它投递后续处理
+    static auto* executor = new std::shared_ptr<AsyncExecutor>(std::make_shared<AsyncExecutor>(1));
+    return *executor;
+}
+
+void AsyncExecutor::post(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(m_queue->mutex);
+        if (m_queue->stopping) {
+            return;
+        }
+        m_queue->tasks.push_back(std::move(task));
+    }
+    m_queue->cv.notify_one();
+}
+
+void AsyncExecutor::postAfter(int delayMs, Task task) {
+    if (delayMs <= 0) {
+        post(std::move(task));
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_queue->mutex);
+        if (m_queue->stopping) {
+            return;
+        }
+        // multimap 把相同的键插在末尾，同一时刻到期的任务保持投递顺序
+        m_queue->timers.emplace(Clock::now() + std::chrono::milliseconds(delayMs), std::move(task));
+    }
+    m_queue->cv.notify_one();
+}
+
+void AsyncExecutor::shutdown() {
+    std::deque<Task> tasks;
+    std::multimap<Clock::time_point, Task> timers;
+    {
+        std::lock_guard<std::mutex> lock(m_queue->mutex);
+        if (m_queue->stopping) {
+            return;
+        }
+        m_queue->stopping = true;
+        // 丢弃的任务可能持有 Future，在锁外析构
+        tasks.swap(m_queue->tasks);
+        timers.swap(m_queue->timers);
+    }
+    m_queue->cv.notify_all();
+    const auto self = std::this_thread::get_id();
+    for (auto& thread : m_threads) {
+        if (!thread.joinable()) {
+            continue;
+        }
+        // 在工作线程里析构时不能等待自己：分离后该线程执行完当前任务即退出
+        if (thread.get_id() == self) {
+            thread.detach();
+        } else {
+            thread.join();
+        }
+    }
+}
+
+bool AsyncExecutor::isWorkerThread() const {
+    const auto self = std::this_thread::get_id();
+    return std::any_of(m_threads.begin(), m_threads.end(),
+                       [self](const std::thread& thread) { return thread.get_id() == self; });
+}
+
+size_t AsyncExecutor::pendingTasks() const {
+    std::lock_guard<std::mutex> lock(m_queue->mutex);
+    return m_queue->tasks.size() + m_queue->timers.size();
+}
+
+uint64_t AsyncExecutor::executedTasks() const {
+    std::lock_guard<std::mutex> lock(m_queue->mutex);
+    return m_queue->executed;
+}
+
+} // namespace Asr
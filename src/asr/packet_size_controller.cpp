@@ -0,0 +1,293 @@
+//
+// 自适应音频分包时长实现
+//
+
+#include "asr/packet_size_controller.h"
+#include "audio/latency_metrics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Asr {
+
+namespace {
+
+// 平滑系数与 TCP 的 SRTT / RTTVAR 相同（RFC 6298）
+constexpr double kRttAlpha = 1.0 / 8.0;
+constexpr double kRttBeta = 1.0 / 4.0;
+// 停顿阻塞的结果占比上限：低于 5% 时停顿不影响 p95
+constexpr double kStallBudget = 0.05;
+// 停顿概率按约 512 个响应平均（丢包是稀疏事件，窗口太短估计不稳）
+constexpr double kStallRateGain = 1.0 / 512.0;
+// 基线 RTT 取最近两个窗口的最小值，窗口长度按样本数
+constexpr int kMinRttWindow = 256;
+// 所需包时长低于当前值的 1/kShrinkMargin 才考虑减小，留出估计误差
+constexpr double kShrinkMargin = 1.25;
+constexpr int kShrinkWindows = 2;
+// 减小后结果延迟上升超过 10% + 20ms 视为变差；退回后暂停减小的窗口数
+constexpr double kLatencyRegression = 1.10;
+constexpr double kLatencySlackMs = 20.0;
+constexpr int kHoldWindows = 6;
+constexpr uint64_t kMinProbeSamples = 3;
+
+perfx::audio::LatencyHistogram& rttHistogram() {
+    static auto& histogram = perfx::audio::MetricsRegistry::instance().histogram(perfx::audio::metrics::kAsrPacketRtt);
+    return histogram;
+}
+
+perfx::audio::LatencyHistogram& resultLatencyHistogram() {
+    static auto& histogram =
+        perfx::audio::MetricsRegistry::instance().histogram(perfx::audio::metrics::kAsrResultLatency);
+    return histogram;
+}
+
+perfx::audio::LatencyHistogram& packetDurationHistogram() {
+    static auto& histogram =
+        perfx::audio::MetricsRegistry::instance().histogram(perfx::audio::metrics::kAsrPacketDuration);
+    return histogram;
+}
+
+} // namespace
+
+PacketSizeController::PacketSizeController(const PacketSizeConfig& config) : m_config(config) {
+    m_packetMs = clampLocked(m_config.initialMs);
+}
+
+void PacketSizeController::setConfig(const PacketSizeConfig& config) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_config = config;
+    }
+    reset();
+}
+
+PacketSizeConfig PacketSizeController::getConfig() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_config;
+}
+
+void PacketSizeController::reset(int64_t nowNs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_packetMs = clampLocked(m_config.initialMs);
+    m_originNs = nowNs;
+    m_hasRtt = false;
+    m_srttMs = m_rttVarMs = m_resultLatencyMs = 0.0;
+    m_minRttMs = m_windowMinRttMs = m_prevMinRttMs = 0.0;
+    m_minRttSamples = 0;
+    m_stallRate = m_stallMs = 0.0;
+    m_hasResultLatency = false;
+    m_windowSamples = m_windowLosses = m_goodWindows = m_holdWindows = 0;
+    m_probing = false;
+    m_packets = m_rttSamples = m_resultSamples = m_losses = m_stalls = m_changes = 0;
+    m_history.clear();
+    if (m_config.recordMetrics) {
+        perfx::audio::MetricsRegistry::instance().counter(perfx::audio::metrics::kAsrPacketMsCurrent).store(m_packetMs);
+    }
+}
+
+int PacketSizeController::packetMs() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_packetMs;
+}
+
+size_t PacketSizeController::packetSamples(int sampleRate) const {
+    return static_cast<size_t>(sampleRate) * static_cast<size_t>(packetMs()) / 1000;
+}
+
+void PacketSizeController::onPacketSent(int packetMs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_packets;
+    if (m_config.recordMetrics) {
+        packetDurationHistogram().record(static_cast<uint64_t>(std::max(0, packetMs)));
+    }
+}
+
+void PacketSizeController::onRtt(int64_t rttNs, int64_t nowNs) {
+    if (rttNs <= 0) {
+        return;
+    }
+    if (m_config.recordMetrics) {
+        rttHistogram().record(static_cast<uint64_t>(rttNs / 1000));
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_originNs == 0) {
+        m_originNs = nowNs;
+    }
+    const double rttMs = static_cast<double>(rttNs) / 1e6;
+    updateMinRttLocked(rttMs);
+    if (!m_hasRtt) {
+        m_srttMs = rttMs;
+        m_rttVarMs = rttMs / 2.0;
+        m_hasRtt = true;
+    } else {
+        // 超过重传超时的样本：其后在途的包都被阻塞
+        const bool stalled = rttMs > m_srttMs + 4.0 * m_rttVarMs;
+        if (stalled) {
+            const double excessMs = rttMs - m_srttMs;
+            m_stallMs = m_stalls == 0 ? excessMs : (1.0 - kRttAlpha) * m_stallMs + kRttAlpha * excessMs;
+            ++m_stalls;
+        }
+        m_stallRate += kStallRateGain * ((stalled ? 1.0 : 0.0) - m_stallRate);
+        m_rttVarMs = (1.0 - kRttBeta) * m_rttVarMs + kRttBeta * std::fabs(m_srttMs - rttMs);
+        m_srttMs = (1.0 - kRttAlpha) * m_srttMs + kRttAlpha * rttMs;
+    }
+    ++m_rttSamples;
+    if (++m_windowSamples >= std::max(1, m_config.evaluateEvery)) {
+        evaluateLocked(nowNs);
+    }
+}
+
+void PacketSizeController::onResultLatency(int64_t latencyNs) {
+    if (latencyNs <= 0) {
+        return;
+    }
+    if (m_config.recordMetrics) {
+        resultLatencyHistogram().record(static_cast<uint64_t>(latencyNs / 1000));
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const double latencyMs = static_cast<double>(latencyNs) / 1e6;
+    m_resultLatencyMs = m_hasResultLatency ? (1.0 - kRttAlpha) * m_resultLatencyMs + kRttAlpha * latencyMs : latencyMs;
+    m_hasResultLatency = true;
+    ++m_resultSamples;
+}
+
+void PacketSizeController::onLoss(int64_t nowNs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_originNs == 0) {
+        m_originNs = nowNs;
+    }
+    ++m_losses;
+    ++m_windowLosses;
+    evaluateLocked(nowNs);
+}
+
+PacketSizeStats PacketSizeController::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    PacketSizeStats stats;
+    stats.adaptive = m_config.adaptive;
+    stats.packetMs = m_packetMs;
+    stats.srttMs = m_srttMs;
+    stats.rttVarMs = m_rttVarMs;
+    stats.minRttMs = m_minRttMs;
+    stats.resultLatencyMs = m_resultLatencyMs;
+    stats.stallRate = m_stallRate;
+    stats.stallMs = m_stallMs;
+    stats.packets = m_packets;
+    stats.rttSamples = m_rttSamples;
+    stats.resultSamples = m_resultSamples;
+    stats.losses = m_losses;
+    stats.stalls = m_stalls;
+    stats.changes = m_changes;
+    stats.history.assign(m_history.begin(), m_history.end());
+    return stats;
+}
+
+void PacketSizeController::evaluateLocked(int64_t nowNs) {
+    const int losses = m_windowLosses;
+    m_windowSamples = 0;
+    m_windowLosses = 0;
+    if (!m_config.adaptive) {
+        return;
+    }
+
+    // 1. 丢包：翻倍（此时 RTT 样本往往还没反映出问题）
+    if (losses > 0) {
+        m_goodWindows = 0;
+        m_probing = false;
+        applyLocked(clampLocked(m_packetMs * 2.0), "loss", nowNs);
+        return;
+    }
+    if (!m_hasRtt) {
+        return;
+    }
+
+    // 2. 平滑 RTT 远高于基线：带宽或服务端跟不上逐包开销，队列在增长
+    if (m_srttMs > 2.0 * m_minRttMs + m_packetMs) {
+        m_goodWindows = 0;
+        m_probing = false;
+        applyLocked(clampLocked(m_packetMs * 1.5), "queue", nowNs);
+        return;
+    }
+
+    // 3. 停顿阻塞的结果占比超出预算：增大包时长，减少每秒被阻塞的包数（每次最多 1.5 倍）
+    const double requiredMs = m_stallRate * m_stallMs / kStallBudget;
+    if (requiredMs > m_packetMs) {
+        m_goodWindows = 0;
+        m_probing = false;
+        applyLocked(clampLocked(std::min(requiredMs, m_packetMs * 1.5)), "stall", nowNs);
+        return;
+    }
+
+    // 4. 上次减小让结果延迟变差：退回并暂停一段时间
+    if (m_probing && m_resultSamples >= m_probeResultSamples + kMinProbeSamples) {
+        m_probing = false;
+        if (m_resultLatencyMs > m_probeLatencyMs * kLatencyRegression + kLatencySlackMs) {
+            m_goodWindows = 0;
+            m_holdWindows = kHoldWindows;
+            applyLocked(m_probeFromMs, "latency", nowNs);
+            return;
+        }
+    }
+
+    // 5. 停顿占比有余量：逐步减小，缩短首个部分结果的等待
+    if (m_holdWindows > 0) {
+        --m_holdWindows;
+        return;
+    }
+    if (requiredMs * kShrinkMargin < m_packetMs && m_packetMs > m_config.minMs) {
+        if (++m_goodWindows >= kShrinkWindows) {
+            m_goodWindows = 0;
+            m_probing = m_hasResultLatency;
+            m_probeFromMs = m_packetMs;
+            m_probeLatencyMs = m_resultLatencyMs;
+            m_probeResultSamples = m_resultSamples;
+            applyLocked(clampLocked(m_packetMs - m_config.stepMs), "fast-link", nowNs);
+        }
+    } else {
+        m_goodWindows = 0;
+    }
+}
+
+void PacketSizeController::updateMinRttLocked(double rttMs) {
+    m_windowMinRttMs = m_minRttSamples == 0 ? rttMs : std::min(m_windowMinRttMs, rttMs);
+    if (++m_minRttSamples >= kMinRttWindow) {
+        m_prevMinRttMs = m_windowMinRttMs;
+        m_minRttSamples = 0;
+    }
+    m_minRttMs = m_prevMinRttMs > 0.0 ? std::min(m_prevMinRttMs, m_windowMinRttMs) : m_windowMinRttMs;
+}
+
+void PacketSizeController::applyLocked(int toMs, const char* reason, int64_t nowNs) {
+    if (toMs == m_packetMs) {
+        return;
+    }
+    PacketSizeDecision decision;
+    decision.atMs = (nowNs - m_originNs) / 1000000;
+    decision.fromMs = m_packetMs;
+    decision.toMs = toMs;
+    decision.srttMs = m_srttMs;
+    decision.rttVarMs = m_rttVarMs;
+    decision.resultLatencyMs = m_resultLatencyMs;
+    decision.reason = reason;
+    m_history.push_back(std::move(decision));
+    if (m_history.size() > kHistorySize) {
+        m_history.pop_front();
+    }
+    m_packetMs = toMs;
+    ++m_changes;
+    if (m_config.recordMetrics) {
+        auto& registry = perfx::audio::MetricsRegistry::instance();
+        registry.counter(perfx::audio::metrics::kAsrPacketMsCurrent).store(m_packetMs);
+        registry.counter(perfx::audio::metrics::kAsrPacketSizeChanges).fetch_add(1);
+    }
+}
+
+int PacketSizeController::clampLocked(double ms) const {
+    const int step = std::max(1, m_config.stepMs);
+    const int minMs = std::max(step, m_config.minMs);
+    const int maxMs = std::max(minMs, m_config.maxMs);
+    // 按粒度向上取整：增大时至少覆盖目标
+    const int rounded = static_cast<int>(std::ceil(ms / step)) * step;
+    return std::max(minMs, std::min(maxMs, rounded));
+}
+
+} // namespace Asr
@@ -0,0 +1,455 @@
+//
+// 进程级 ASR 请求调度实现
+//
+
+#include "asr/request_scheduler.h"
+#include "asr/asr_client.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace Asr {
+
+namespace {
+
+// 无限制的会话数
+constexpr double kUnlimitedSessions = 1e9;
+// 等待期间轮询取消标志的间隔
+constexpr auto kPollInterval = std::chrono::milliseconds(100);
+// 收紧后的最低限制
+constexpr double kMinConnectsPerSecond = 0.1;
+constexpr double kMinAudioSecondsPerMinute = 6.0;
+// 配置为不限制的项收紧后，经过这么多个恢复周期没有再出错即取消限制
+constexpr int kRecoveryStepsToUnlimited = 4;
+
+int priorityIndex(RequestPriority priority) {
+    return static_cast<int>(priority);
+}
+
+double envDouble(const char* name, double fallback) {
+    const char* value = std::getenv(name);
+    if (!value || !*value) {
+        return fallback;
+    }
+    char* end = nullptr;
+    const double parsed = std::strtod(value, &end);
+    return end != value && parsed >= 0.0 ? parsed : fallback;
+}
+
+} // namespace
+
+const char* requestPriorityName(RequestPriority priority) {
+    switch (priority) {
+        case RequestPriority::LIVE:
+            return "live";
+        case RequestPriority::INTERACTIVE:
+            return "interactive";
+        case RequestPriority::BATCH:
+            return "batch";
+    }
+    return "unknown";
+}
+
+bool parseRequestPriority(const std::string& name, RequestPriority& priority) {
+    for (const RequestPriority candidate :
+         {RequestPriority::LIVE, RequestPriority::INTERACTIVE, RequestPriority::BATCH}) {
+        if (name == requestPriorityName(candidate)) {
+            priority = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// SessionLease
+// ============================================================================
+
+SessionLease::~SessionLease() {
+    release();
+}
+
+SessionLease::SessionLease(SessionLease&& other) noexcept
+    : m_scheduler(other.m_scheduler), m_priority(other.m_priority) {
+    other.m_scheduler = nullptr;
+}
+
+SessionLease& SessionLease::operator=(SessionLease&& other) noexcept {
+    if (this != &other) {
+        release();
+        m_scheduler = other.m_scheduler;
+        m_priority = other.m_priority;
+        other.m_scheduler = nullptr;
+    }
+    return *this;
+}
+
+void SessionLease::release() {
+    if (m_scheduler) {
+        m_scheduler->releaseSession(m_priority);
+        m_scheduler = nullptr;
+    }
+}
+
+// ============================================================================
+// RequestScheduler
+// ============================================================================
+
+void RequestScheduler::TokenBucket::refill(Clock::time_point now) {
+    if (rate > 0.0) {
+        const double elapsed = std::chrono::duration<double>(now - last).count();
+        tokens = std::min(capacity, tokens + elapsed * rate);
+    }
+    last = now;
+}
+
+RequestScheduler& RequestScheduler::instance() {
+    // 不析构：静态对象（例如 AsrManager 单例）析构时归还的许可仍指向有效的调度器
+    static RequestScheduler* scheduler = new RequestScheduler(limitsFromEnv());
+    return *scheduler;
+}
+
+SchedulerLimits RequestScheduler::limitsFromEnv() {
+    SchedulerLimits limits;
+    limits.maxSessions = static_cast<int>(envDouble("PERFX_ASR_MAX_SESSIONS", limits.maxSessions));
+    limits.connectsPerSecond = envDouble("PERFX_ASR_CONNECTS_PER_SEC", limits.connectsPerSecond);
+    limits.audioSecondsPerMinute = envDouble("PERFX_ASR_AUDIO_SEC_PER_MIN", limits.audioSecondsPerMinute);
+    return limits;
+}
+
+bool RequestScheduler::isLimitError(uint32_t code) {
+    return code == ERROR_RATE_LIMITED || code == ERROR_QUOTA_EXCEEDED || code == ERROR_SERVER_BUSY;
+}
+
+RequestScheduler::RequestScheduler(const SchedulerLimits& limits)
+    : m_limits(limits), m_rng(std::random_device{}()) {
+    resetLocked(Clock::now());
+}
+
+void RequestScheduler::setLimits(const SchedulerLimits& limits) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_limits = limits;
+        resetLocked(Clock::now());
+    }
+    m_cv.notify_all();
+}
+
+SchedulerLimits RequestScheduler::getLimits() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_limits;
+}
+
+void RequestScheduler::resetLocked(Clock::time_point now) {
+    m_sessionLimit = m_limits.maxSessions > 0 ? m_limits.maxSessions : kUnlimitedSessions;
+
+    m_connects.rate = m_limits.connectsPerSecond;
+    m_connects.capacity = std::max(1, m_limits.connectBurst);
+    m_connects.tokens = m_connects.capacity;
+    m_connects.last = now;
+
+    // 音频桶容量为一分钟的额度
+    m_audio.rate = m_limits.audioSecondsPerMinute / 60.0;
+    m_audio.capacity = m_limits.audioSecondsPerMinute;
+    m_audio.tokens = m_audio.capacity;
+    m_audio.last = now;
+
+    m_usageSeconds = 0.0;
+    m_usageStart = now;
+    m_backoffUntil = now;
+    m_lastLimitError = Clock::time_point();
+    m_lastRecovery = now;
+    m_consecutiveErrors = 0;
+}
+
+void RequestScheduler::refillLocked(Clock::time_point now) {
+    m_connects.refill(now);
+    m_audio.refill(now);
+    if (now - m_usageStart >= std::chrono::minutes(1)) {
+        m_usageSeconds = 0.0;
+        m_usageStart = now;
+    }
+
+    // 每个恢复周期内没有限流错误：会话上限加一，速率向配置值恢复一半；连续若干周期后完全恢复
+    const auto recovery = std::chrono::milliseconds(m_limits.recoveryMs);
+    if (m_lastLimitError == Clock::time_point() || now - m_lastLimitError < recovery ||
+        now - m_lastRecovery < recovery) {
+        return;
+    }
+    m_lastRecovery = now;
+    const int steps = static_cast<int>((now - m_lastLimitError) / recovery);
+
+    const double sessions = m_limits.maxSessions > 0 ? m_limits.maxSessions : kUnlimitedSessions;
+    m_sessionLimit = steps >= kRecoveryStepsToUnlimited ? sessions : std::min(sessions, m_sessionLimit + 1.0);
+
+    auto recover = [steps](TokenBucket& bucket, double configuredRate, double capacityPerRate) {
+        if (bucket.rate <= 0.0) {
+            return;
+        }
+        if (configuredRate > 0.0) {
+            bucket.rate = steps >= kRecoveryStepsToUnlimited ? configuredRate : (bucket.rate + configuredRate) / 2.0;
+        } else if (steps >= kRecoveryStepsToUnlimited) {
+            bucket.rate = 0.0;
+            return;
+        } else {
+            bucket.rate *= 2.0;
+        }
+        if (capacityPerRate > 0.0) {
+            bucket.capacity = bucket.rate * capacityPerRate;
+        }
+    };
+    recover(m_connects, m_limits.connectsPerSecond, 0.0);
+    recover(m_audio, m_limits.audioSecondsPerMinute / 60.0, 60.0);
+    if (steps >= kRecoveryStepsToUnlimited) {
+        m_lastLimitError = Clock::time_point();
+    }
+}
+
+bool RequestScheduler::isFrontLocked(RequestPriority priority, uint64_t ticket) const {
+    for (int p = 0; p < priorityIndex(priority); ++p) {
+        if (!m_waiters[p].empty()) {
+            return false;
+        }
+    }
+    return !m_waiters[priorityIndex(priority)].empty() && m_waiters[priorityIndex(priority)].front() == ticket;
+}
+
+bool RequestScheduler::canStartSessionLocked(RequestPriority priority, Clock::time_point now) const {
+    // 实时请求不退避：它的建连仍受令牌桶限制，且排在所有其他请求之前
+    if (priority != RequestPriority::LIVE && now < m_backoffUntil) {
+        return false;
+    }
+    int reserved = 0;
+    if (priority != RequestPriority::LIVE) {
+        reserved += m_limits.liveReservedSessions;
+    }
+    if (priority == RequestPriority::BATCH) {
+        reserved += m_limits.interactiveReservedSessions;
+    }
+    int active = 0;
+    for (const int count : m_active) {
+        active += count;
+    }
+    if (active + 1 > std::floor(m_sessionLimit) - reserved) {
+        return false;
+    }
+    return m_connects.rate <= 0.0 || m_connects.tokens >= 1.0;
+}
+
+bool RequestScheduler::canSendAudioLocked(RequestPriority priority, double seconds, Clock::time_point now) const {
+    if (m_audio.rate <= 0.0 || priority == RequestPriority::LIVE) {
+        return true;
+    }
+    if (now < m_backoffUntil) {
+        return false;
+    }
+    double reserved = m_limits.liveReservedAudio;
+    if (priority == RequestPriority::BATCH) {
+        reserved += m_limits.interactiveReservedAudio;
+    }
+    const double floor = m_audio.capacity * std::min(reserved, 0.9);
+    // 单次请求超过可用部分时，等到桶满即放行
+    const double need = std::min(seconds, m_audio.capacity - floor);
+    return m_audio.tokens - need >= floor;
+}
+
+RequestScheduler::Clock::time_point RequestScheduler::nextWakeLocked(Clock::time_point now) const {
+    Clock::time_point wake = now + kPollInterval;
+    if (m_backoffUntil > now) {
+        wake = std::min(wake, m_backoffUntil);
+    }
+    if (m_connects.rate > 0.0 && m_connects.tokens < 1.0) {
+        const auto untilToken = std::chrono::duration<double>((1.0 - m_connects.tokens) / m_connects.rate);
+        wake = std::min(wake, now + std::chrono::duration_cast<Clock::duration>(untilToken));
+    }
+    return wake;
+}
+
+void RequestScheduler::recordWaitLocked(RequestPriority priority, Clock::time_point begin, bool granted) {
+    auto& stats = m_stats.priorities[priorityIndex(priority)];
+    const double waitMs = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    stats.waitMsMax = std::max(stats.waitMsMax, waitMs);
+    stats.waitMsTotal += waitMs;
+    if (!granted) {
+        ++stats.timeouts;
+    }
+}
+
+SessionLease RequestScheduler::acquireSession(RequestPriority priority, int timeoutMs,
+                                              const std::atomic<bool>* cancel) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const Clock::time_point begin = Clock::now();
+    const Clock::time_point deadline =
+        timeoutMs < 0 ? Clock::time_point::max() : begin + std::chrono::milliseconds(timeoutMs);
+    const uint64_t ticket = m_nextTicket++;
+    auto& queue = m_waiters[priorityIndex(priority)];
+    queue.push_back(ticket);
+
+    while (true) {
+        const Clock::time_point now = Clock::now();
+        refillLocked(now);
+        if (isFrontLocked(priority, ticket) && canStartSessionLocked(priority, now)) {
+            queue.pop_front();
+            if (m_connects.rate > 0.0) {
+                m_connects.tokens -= 1.0;
+            }
+            ++m_active[priorityIndex(priority)];
+            ++m_stats.priorities[priorityIndex(priority)].granted;
+            recordWaitLocked(priority, begin, true);
+            lock.unlock();
+            m_cv.notify_all();
+            return SessionLease(this, priority);
+        }
+        if ((cancel && cancel->load()) || now >= deadline) {
+            queue.erase(std::find(queue.begin(), queue.end(), ticket));
+            recordWaitLocked(priority, begin, false);
+            lock.unlock();
+            m_cv.notify_all();
+            return SessionLease();
+        }
+        m_cv.wait_until(lock, std::min(deadline, nextWakeLocked(now)));
+    }
+}
+
+void RequestScheduler::releaseSession(RequestPriority priority) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_active[priorityIndex(priority)] = std::max(0, m_active[priorityIndex(priority)] - 1);
+    }
+    m_cv.notify_all();
+}
+
+bool RequestScheduler::acquireAudio(RequestPriority priority, double seconds, int timeoutMs,
+                                    const std::atomic<bool>* cancel) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const Clock::time_point begin = Clock::now();
+    refillLocked(begin);
+    auto charge = [this, priority, seconds]() {
+        if (m_audio.rate > 0.0) {
+            // 实时请求的透支最多一分钟额度
+            m_audio.tokens = std::max(-m_audio.capacity, m_audio.tokens - seconds);
+        }
+        m_usageSeconds += seconds;
+        m_stats.priorities[priorityIndex(priority)].audioSeconds += seconds;
+    };
+    if (priority == RequestPriority::LIVE || m_audio.rate <= 0.0) {
+        charge();
+        return true;
+    }
+
+    const Clock::time_point deadline =
+        timeoutMs < 0 ? Clock::time_point::max() : begin + std::chrono::milliseconds(timeoutMs);
+    const uint64_t ticket = m_nextTicket++;
+    // 音频与会话许可分开排队：等待会话的高优先级请求不能阻塞已有会话的发送，否则可能互相等待
+    auto& queue = m_audioWaiters[priorityIndex(priority)];
+    queue.push_back(ticket);
+    while (true) {
+        const Clock::time_point now = Clock::now();
+        refillLocked(now);
+        bool front = queue.front() == ticket;
+        for (int p = 0; p < priorityIndex(priority) && front; ++p) {
+            front = m_audioWaiters[p].empty();
+        }
+        if (front && canSendAudioLocked(priority, seconds, now)) {
+            queue.pop_front();
+            charge();
+            lock.unlock();
+            m_cv.notify_all();
+            return true;
+        }
+        if ((cancel && cancel->load()) || now >= deadline) {
+            queue.erase(std::find(queue.begin(), queue.end(), ticket));
+            recordWaitLocked(priority, begin, false);
+            lock.unlock();
+            m_cv.notify_all();
+            return false;
+        }
+        m_cv.wait_until(lock, std::min(deadline, nextWakeLocked(now)));
+    }
+}
+
+void RequestScheduler::reportError(uint32_t code) {
+    if (!isLimitError(code)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const Clock::time_point now = Clock::now();
+        refillLocked(now);
+        m_lastLimitError = now;
+        m_lastRecovery = now;
+
+        if (code == ERROR_RATE_LIMITED) {
+            ++m_stats.rateLimited;
+            m_connects.rate = m_connects.rate > 0.0 ? std::max(kMinConnectsPerSecond, m_connects.rate / 2.0) : 1.0;
+            m_connects.tokens = std::min(m_connects.tokens, 0.0);
+        } else if (code == ERROR_QUOTA_EXCEEDED) {
+            ++m_stats.quotaExceeded;
+            double perMinute = m_audio.rate * 60.0;
+            if (perMinute <= 0.0) {
+                const double elapsed = std::max(1.0, std::chrono::duration<double>(now - m_usageStart).count());
+                perMinute = m_usageSeconds / elapsed * 60.0;
+            }
+            perMinute = std::max(kMinAudioSecondsPerMinute, perMinute / 2.0);
+            m_audio.rate = perMinute / 60.0;
+            m_audio.capacity = perMinute;
+            m_audio.tokens = std::min(m_audio.tokens, 0.0);
+            m_audio.last = now;
+        } else {
+            ++m_stats.serverBusy;
+            int active = 0;
+            for (const int count : m_active) {
+                active += count;
+            }
+            m_sessionLimit = std::max(1.0, std::min(m_sessionLimit, static_cast<double>(active)) - 1.0);
+        }
+
+        m_backoffUntil = std::max(m_backoffUntil, now + std::chrono::milliseconds(backoffMsLocked(m_consecutiveErrors)));
+        ++m_consecutiveErrors;
+    }
+    m_cv.notify_all();
+}
+
+void RequestScheduler::reportSuccess() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_consecutiveErrors = 0;
+}
+
+uint32_t RequestScheduler::backoffMsLocked(uint32_t attempt) {
+    // 带抖动的指数退避：在 [cap/2, cap] 内均匀取值，避免各会话同时重试
+    const double base = std::max<uint32_t>(1, m_limits.backoffMinMs);
+    const double cap = std::min<double>(m_limits.backoffMaxMs, base * std::pow(2.0, std::min<uint32_t>(attempt, 20)));
+    std::uniform_real_distribution<double> jitter(cap / 2.0, cap);
+    return static_cast<uint32_t>(jitter(m_rng));
+}
+
+uint32_t RequestScheduler::retryDelayMs(uint32_t attempt) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Clock::time_point now = Clock::now();
+    const int64_t remaining =
+        m_backoffUntil > now ? std::chrono::duration_cast<std::chrono::milliseconds>(m_backoffUntil - now).count() : 0;
+    return std::max<uint32_t>(backoffMsLocked(attempt), static_cast<uint32_t>(remaining));
+}
+
+SchedulerStats RequestScheduler::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    SchedulerStats stats = m_stats;
+    const Clock::time_point now = Clock::now();
+    for (int p = 0; p < kRequestPriorityCount; ++p) {
+        stats.priorities[p].active = m_active[p];
+        stats.priorities[p].waiting = static_cast<int>(m_waiters[p].size() + m_audioWaiters[p].size());
+    }
+    stats.limits = m_limits;
+    stats.sessionLimit = m_sessionLimit >= kUnlimitedSessions ? 0.0 : m_sessionLimit;
+    stats.connectsPerSecond = m_connects.rate;
+    stats.audioSecondsPerMinute = m_audio.rate * 60.0;
+    // 桶的余量只在请求时更新，这里按经过的时间补算
+    TokenBucket audio = m_audio;
+    audio.refill(now);
+    stats.audioTokens = audio.tokens;
+    stats.backoffRemainingMs =
+        m_backoffUntil > now ? std::chrono::duration_cast<std::chrono::milliseconds>(m_backoffUntil - now).count() : 0;
+    return stats;
+}
+
+} // namespace Asr
@@ -0,0 +1,766 @@
+//
+// ASR 会话抓包与回放实现
+//
+
+#include "asr/session_capture.h"
+#include "asr/asr_client.h"
+#include <ixwebsocket/IXWebSocket.h>
+#include <ixwebsocket/IXWebSocketServer.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace Asr {
+
+namespace {
+
+constexpr char kMagic[4] = {'P', 'X', 'A', 'C'};
+constexpr uint8_t kVersion = 1;
+constexpr uint8_t kMaxDirection = static_cast<uint8_t>(CaptureDirection::Error);
+// 连接建立的等待上限，与 AsrClient::connect() 一致
+constexpr int kConnectTimeoutMs = 5000;
+
+using Clock = std::chrono::steady_clock;
+
+int64_t steadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now().time_since_epoch()).count();
+}
+
+size_t putVarint(uint64_t value, uint8_t* out) {
+    size_t size = 0;
+    while (value >= 0x80) {
+        out[size++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[size++] = static_cast<uint8_t>(value);
+    return size;
+}
+
+bool getVarint(const std::string& data, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= data.size()) {
+            return false;
+        }
+        const uint8_t byte = static_cast<uint8_t>(data[pos++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 把服务端一侧的抓包帧还原为 ix 消息（str 引用 frame.payload 或 empty）
+ */
+ix::WebSocketMessagePtr toMessage(const CaptureFrame& frame, const std::string& empty) {
+    switch (frame.direction) {
+    case CaptureDirection::ServerBinary:
+    case CaptureDirection::ServerText:
+        return std::make_unique<ix::WebSocketMessage>(
+            ix::WebSocketMessageType::Message, frame.payload, frame.payload.size(),
+            ix::WebSocketErrorInfo(), ix::WebSocketOpenInfo(), ix::WebSocketCloseInfo(),
+            frame.direction == CaptureDirection::ServerBinary);
+    case CaptureDirection::Open: {
+        ix::WebSocketHttpHeaders headers;
+        const json j = json::parse(frame.payload, nullptr, false);
+        if (j.is_object()) {
+            for (const auto& item : j.items()) {
+                if (item.value().is_string()) {
+                    headers[item.key()] = item.value().get<std::string>();
+                }
+            }
+        }
+        return std::make_unique<ix::WebSocketMessage>(
+            ix::WebSocketMessageType::Open, empty, 0, ix::WebSocketErrorInfo(),
+            ix::WebSocketOpenInfo("", headers), ix::WebSocketCloseInfo());
+    }
+    case CaptureDirection::Close: {
+        const json j = json::parse(frame.payload, nullptr, false);
+        ix::WebSocketCloseInfo closeInfo;
+        if (j.is_object()) {
+            closeInfo.code = j.value("code", 0);
+            closeInfo.reason = j.value("reason", std::string());
+            closeInfo.remote = true;
+        }
+        return std::make_unique<ix::WebSocketMessage>(
+            ix::WebSocketMessageType::Close, empty, 0, ix::WebSocketErrorInfo(),
+            ix::WebSocketOpenInfo(), closeInfo);
+    }
+    case CaptureDirection::Error: {
+        ix::WebSocketErrorInfo errorInfo;
+        errorInfo.reason = frame.payload;
+        return std::make_unique<ix::WebSocketMessage>(
+            ix::WebSocketMessageType::Error, empty, 0, errorInfo,
+            ix::WebSocketOpenInfo(), ix::WebSocketCloseInfo());
+    }
+    case CaptureDirection::ClientBinary:
+        break;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief 连接段：从一个 Open 事件（或抓包开头）到下一个 Open 之前
+ */
+struct Segment {
+    size_t begin = 0;
+    size_t end = 0;
+    int64_t originUs = 0;       ///< 段起点时间（Open 事件或第一帧）
+};
+
+std::vector<Segment> splitSegments(const std::vector<CaptureFrame>& frames) {
+    std::vector<Segment> segments;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        if (i == 0 || frames[i].direction == CaptureDirection::Open) {
+            if (!segments.empty()) {
+                segments.back().end = i;
+            }
+            Segment segment;
+            segment.begin = i;
+            segment.originUs = frames[i].timeUs;
+            segments.push_back(segment);
+        }
+    }
+    if (!segments.empty()) {
+        segments.back().end = frames.size();
+    }
+    return segments;
+}
+
+/**
+ * @brief 抓包时间 → 回放时间（纳秒），speed <= 0 时不等待
+ */
+int64_t scaledNs(int64_t captureUs, double speed) {
+    if (speed <= 0.0) {
+        return 0;
+    }
+    return static_cast<int64_t>(static_cast<double>(captureUs) * 1000.0 / speed);
+}
+
+} // namespace
+
+const char* captureDirectionName(CaptureDirection direction) {
+    switch (direction) {
+    case CaptureDirection::ClientBinary: return "client";
+    case CaptureDirection::ServerBinary: return "server";
+    case CaptureDirection::ServerText: return "text";
+    case CaptureDirection::Open: return "open";
+    case CaptureDirection::Close: return "close";
+    case CaptureDirection::Error: return "error";
+    }
+    return "unknown";
+}
+
+bool isServerSide(CaptureDirection direction) {
+    return direction != CaptureDirection::ClientBinary;
+}
+
+// ============================================================================
+// SessionRecorder
+// ============================================================================
+
+SessionRecorder::~SessionRecorder() {
+    close();
+}
+
+void SessionRecorder::open(const std::string& path, const std::string& metadata) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_path = path;
+    m_metadata = metadata;
+    m_closed = false;
+}
+
+bool SessionRecorder::ensureFileLocked() {
+    if (m_file) {
+        return true;
+    }
+    if (m_closed || m_path.empty() || !m_lastError.empty()) {
+        return false;
+    }
+    m_file = std::fopen(m_path.c_str(), "wb");
+    if (!m_file) {
+        m_lastError = "无法创建会话抓包文件: " + m_path;
+        std::cerr << "[ASR-CAPTURE] " << m_lastError << std::endl;
+        return false;
+    }
+    std::setvbuf(m_file, nullptr, _IOFBF, 64 * 1024);
+
+    uint8_t header[4 + 1 + 10];
+    std::memcpy(header, kMagic, 4);
+    header[4] = kVersion;
+    const size_t headerSize = 5 + putVarint(m_metadata.size(), header + 5);
+    std::fwrite(header, 1, headerSize, m_file);
+    std::fwrite(m_metadata.data(), 1, m_metadata.size(), m_file);
+    m_startNs = steadyNs();
+    m_lastUs = 0;
+    return true;
+}
+
+void SessionRecorder::record(CaptureDirection direction, const void* data, size_t size) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!ensureFileLocked()) {
+        return;
+    }
+    // 在锁内取时间，保证写入顺序与时间戳单调一致
+    const int64_t nowUs = (steadyNs() - m_startNs) / 1000;
+    const int64_t deltaUs = std::max<int64_t>(0, nowUs - m_lastUs);
+    m_lastUs += deltaUs;
+
+    uint8_t prefix[1 + 10 + 10];
+    prefix[0] = static_cast<uint8_t>(direction);
+    size_t prefixSize = 1;
+    prefixSize += putVarint(static_cast<uint64_t>(deltaUs), prefix + prefixSize);
+    prefixSize += putVarint(size, prefix + prefixSize);
+    std::fwrite(prefix, 1, prefixSize, m_file);
+    if (size > 0) {
+        std::fwrite(data, 1, size, m_file);
+    }
+    m_frames++;
+
+    // 连接结束时刷新，附到问题报告里的抓包不依赖进程正常退出
+    if (direction == CaptureDirection::Close || direction == CaptureDirection::Error) {
+        std::fflush(m_file);
+    }
+    if (std::ferror(m_file)) {
+        m_lastError = "写入会话抓包文件失败: " + m_path;
+        std::cerr << "[ASR-CAPTURE] " << m_lastError << std::endl;
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+void SessionRecorder::record(CaptureDirection direction, const std::string& payload) {
+    record(direction, payload.data(), payload.size());
+}
+
+void SessionRecorder::close() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closed = true;
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+uint64_t SessionRecorder::getFrameCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_frames;
+}
+
+std::string SessionRecorder::getLastError() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastError;
+}
+
+// ============================================================================
+// SessionCapture
+// ============================================================================
+
+bool SessionCapture::load(const std::string& path, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "无法打开会话抓包文件: " + path;
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    if (!parse(buffer.str(), error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+bool SessionCapture::parse(const std::string& data, std::string& error) {
+    m_metadata.clear();
+    m_frames.clear();
+    m_truncated = false;
+
+    if (data.size() < 5 || std::memcmp(data.data(), kMagic, 4) != 0) {
+        error = "不是会话抓包文件";
+        return false;
+    }
+    if (static_cast<uint8_t>(data[4]) != kVersion) {
+        error = "不支持的会话抓包版本 " + std::to_string(static_cast<uint8_t>(data[4]));
+        return false;
+    }
+    size_t pos = 5;
+    uint64_t metadataSize = 0;
+    if (!getVarint(data, pos, metadataSize) || metadataSize > data.size() - pos) {
+        error = "会话抓包文件头不完整";
+        return false;
+    }
+    m_metadata = data.substr(pos, static_cast<size_t>(metadataSize));
+    pos += static_cast<size_t>(metadataSize);
+
+    int64_t timeUs = 0;
+    while (pos < data.size()) {
+        const uint8_t direction = static_cast<uint8_t>(data[pos]);
+        if (direction > kMaxDirection) {
+            error = "会话抓包记录损坏（偏移 " + std::to_string(pos) + "）";
+            return false;
+        }
+        size_t cursor = pos + 1;
+        uint64_t deltaUs = 0;
+        uint64_t size = 0;
+        if (!getVarint(data, cursor, deltaUs) || !getVarint(data, cursor, size) ||
+            size > data.size() - cursor) {
+            m_truncated = true;
+            break;
+        }
+        timeUs += static_cast<int64_t>(deltaUs);
+        CaptureFrame frame;
+        frame.timeUs = timeUs;
+        frame.direction = static_cast<CaptureDirection>(direction);
+        frame.payload.assign(data, cursor, static_cast<size_t>(size));
+        m_frames.push_back(std::move(frame));
+        pos = cursor + static_cast<size_t>(size);
+    }
+    return true;
+}
+
+int64_t SessionCapture::getDurationUs() const {
+    return m_frames.empty() ? 0 : m_frames.back().timeUs;
+}
+
+size_t SessionCapture::countFrames(CaptureDirection direction) const {
+    return static_cast<size_t>(std::count_if(m_frames.begin(), m_frames.end(),
+        [direction](const CaptureFrame& frame) { return frame.direction == direction; }));
+}
+
+// ============================================================================
+// 注入回放
+// ============================================================================
+
+void replayIntoClient(const SessionCapture& capture, AsrClient& client, const ReplayOptions& options,
+                      ReplayStats& stats, const std::atomic<bool>* stop) {
+    const std::string empty;
+    const auto& frames = capture.getFrames();
+    stats.captureDurationUs = capture.getDurationUs();
+    stats.latencyUs.reserve(stats.latencyUs.size() + frames.size());
+
+    const int64_t startNs = steadyNs();
+    const int64_t originUs = frames.empty() ? 0 : frames.front().timeUs;
+    for (const auto& frame : frames) {
+        if (stop && *stop) {
+            break;
+        }
+        if (!isServerSide(frame.direction)) {
+            stats.clientFrames++;
+            continue;
+        }
+        if (options.speed > 0.0) {
+            const int64_t targetNs = startNs + scaledNs(frame.timeUs - originUs, options.speed);
+            const int64_t waitNs = targetNs - steadyNs();
+            if (waitNs > 0) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(waitNs));
+            }
+            stats.maxLagUs = std::max(stats.maxLagUs, (steadyNs() - targetNs) / 1000);
+        }
+
+        const ix::WebSocketMessagePtr message = toMessage(frame, empty);
+        const int64_t beginNs = steadyNs();
+        client.injectMessage(message);
+        stats.latencyUs.push_back((steadyNs() - beginNs) / 1000);
+        stats.serverFrames++;
+        stats.bytes += frame.payload.size();
+    }
+    stats.elapsedUs = (steadyNs() - startNs) / 1000;
+}
+
+// ============================================================================
+// 客户端回放
+// ============================================================================
+
+bool replayClientSide(const SessionCapture& capture, const std::string& url, const ReplayOptions& options,
+                      ReplayStats& stats, std::string& error, const std::atomic<bool>* stop) {
+    const auto& frames = capture.getFrames();
+    const std::vector<Segment> segments = splitSegments(frames);
+    if (segments.empty()) {
+        error = "会话抓包中没有帧";
+        return false;
+    }
+    const Segment& segment = segments.front();
+    size_t expectedServerFrames = 0;
+    for (size_t i = segment.begin; i < segment.end; ++i) {
+        const auto direction = frames[i].direction;
+        if (direction == CaptureDirection::ServerBinary || direction == CaptureDirection::ServerText) {
+            expectedServerFrames++;
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool opened = false;
+    bool closed = false;
+    int64_t lastSendNs = 0;
+
+    ix::WebSocket socket;
+    socket.setUrl(url);
+    socket.disableAutomaticReconnection();
+    socket.setOnMessageCallback([&](const ix::WebSocketMessagePtr& message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        switch (message->type) {
+        case ix::WebSocketMessageType::Open:
+            opened = true;
+            break;
+        case ix::WebSocketMessageType::Message:
+            stats.serverFrames++;
+            stats.bytes += message->str.size();
+            if (lastSendNs != 0) {
+                stats.latencyUs.push_back((steadyNs() - lastSendNs) / 1000);
+            }
+            break;
+        case ix::WebSocketMessageType::Close:
+        case ix::WebSocketMessageType::Error:
+            if (!opened) {
+                error = message->type == ix::WebSocketMessageType::Error
+                    ? message->errorInfo.reason : message->closeInfo.reason;
+            }
+            closed = true;
+            break;
+        default:
+            return;
+        }
+        cv.notify_all();
+    });
+    socket.start();
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait_for(lock, std::chrono::milliseconds(kConnectTimeoutMs), [&]() { return opened || closed; });
+        if (!opened) {
+            lock.unlock();
+            socket.stop();
+            if (error.empty()) {
+                error = "连接超时: " + url;
+            }
+            return false;
+        }
+    }
+
+    stats.captureDurationUs = frames[segment.end - 1].timeUs - segment.originUs;
+    const int64_t startNs = steadyNs();
+    for (size_t i = segment.begin; i < segment.end; ++i) {
+        const CaptureFrame& frame = frames[i];
+        if (frame.direction != CaptureDirection::ClientBinary) {
+            continue;
+        }
+        if (stop && *stop) {
+            break;
+        }
+        if (options.speed > 0.0) {
+            const int64_t targetNs = startNs + scaledNs(frame.timeUs - segment.originUs, options.speed);
+            const int64_t waitNs = targetNs - steadyNs();
+            if (waitNs > 0) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(waitNs));
+            }
+            stats.maxLagUs = std::max(stats.maxLagUs, (steadyNs() - targetNs) / 1000);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (closed) {
+                break;
+            }
+            lastSendNs = steadyNs();
+        }
+        socket.sendBinary(frame.payload);
+        stats.clientFrames++;
+    }
+
+    // 等待剩余的服务端帧：最后一个客户端帧之后按原始间隔缩放，再加上等待超时
+    const int64_t tailUs = options.speed > 0.0
+        ? scaledNs(frames[segment.end - 1].timeUs - segment.originUs, options.speed) / 1000 -
+              (steadyNs() - startNs) / 1000
+        : 0;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait_for(lock, std::chrono::microseconds(std::max<int64_t>(0, tailUs)) +
+                              std::chrono::milliseconds(options.clientWaitTimeoutMs),
+                    [&]() { return closed || stats.serverFrames >= expectedServerFrames || (stop && *stop); });
+    }
+    stats.elapsedUs = (steadyNs() - startNs) / 1000;
+    socket.stop();
+    return true;
+}
+
+// ============================================================================
+// SessionMockServer
+// ============================================================================
+
+class SessionMockServer::Impl {
+public:
+    /**
+     * @brief 模拟连接状态：客户端帧到达时间由连接线程写入，回放线程据此决定发送时机
+     */
+    struct Connection {
+        std::weak_ptr<ix::WebSocket> socket;
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<int64_t> clientArrivalNs;
+        bool closed = false;
+    };
+    using ConnectionPtr = std::shared_ptr<Connection>;
+
+    /**
+     * @brief 服务端帧的发送条件
+     */
+    struct Gate {
+        size_t clientFrames = 0;    ///< 段内先于该帧的客户端帧数
+        int64_t anchorUs = 0;       ///< 最后一个先行客户端帧的时间（没有时为段起点）
+    };
+
+    Impl(const SessionCapture& capture, const ReplayOptions& options)
+        : capture_(capture), options_(options) {
+        const auto& frames = capture_.getFrames();
+        segments_ = splitSegments(frames);
+        gates_.resize(frames.size());
+        for (const auto& segment : segments_) {
+            Gate gate;
+            gate.anchorUs = segment.originUs;
+            for (size_t i = segment.begin; i < segment.end; ++i) {
+                if (frames[i].direction == CaptureDirection::ClientBinary) {
+                    gate.clientFrames++;
+                    gate.anchorUs = frames[i].timeUs;
+                } else {
+                    gates_[i] = gate;
+                }
+            }
+        }
+    }
+
+    ~Impl() {
+        stop();
+    }
+
+    bool start(const std::string& host, int port, std::string& error) {
+        if (running_) {
+            return true;
+        }
+        if (segments_.empty()) {
+            error = "会话抓包中没有帧";
+            return false;
+        }
+        server_ = std::make_unique<ix::WebSocketServer>(port, host);
+        server_->disablePerMessageDeflate();
+        server_->setOnConnectionCallback(
+            [this](std::weak_ptr<ix::WebSocket> weakSocket, std::shared_ptr<ix::ConnectionState>) {
+                onConnection(std::move(weakSocket));
+            });
+        auto listening = server_->listen();
+        if (!listening.first) {
+            error = "模拟 ASR 服务端无法监听 " + host + ":" + std::to_string(port) + ": " + listening.second;
+            server_.reset();
+            return false;
+        }
+        running_ = true;
+        server_->start();
+        std::cout << "[ASR-REPLAY] 模拟服务端监听 ws://" << host << ":" << port
+                  << "（" << segments_.size() << " 个连接段）" << std::endl;
+        return true;
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex_);
+            for (const auto& connection : connections_) {
+                std::lock_guard<std::mutex> connectionLock(connection->mutex);
+                connection->cv.notify_all();
+            }
+        }
+        std::vector<std::thread> players;
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex_);
+            players.swap(players_);
+        }
+        for (auto& player : players) {
+            if (player.joinable()) {
+                player.join();
+            }
+        }
+        server_->stop();
+        server_.reset();
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex_);
+            connections_.clear();
+        }
+    }
+
+    uint64_t getSessionsServed() const {
+        return sessionsServed_;
+    }
+
+    ReplayStats getStats() const {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        ReplayStats stats = stats_;
+        stats.captureDurationUs = capture_.getDurationUs();
+        return stats;
+    }
+
+private:
+    void onConnection(std::weak_ptr<ix::WebSocket> weakSocket) {
+        auto socket = weakSocket.lock();
+        if (!socket) {
+            return;
+        }
+        auto connection = std::make_shared<Connection>();
+        connection->socket = weakSocket;
+        const size_t segmentIndex = nextSegment_++ % segments_.size();
+
+        socket->setOnMessageCallback([this, connection, segmentIndex](const ix::WebSocketMessagePtr& message) {
+            switch (message->type) {
+            case ix::WebSocketMessageType::Open: {
+                std::lock_guard<std::mutex> lock(connectionsMutex_);
+                if (!running_) {
+                    break;
+                }
+                connections_.push_back(connection);
+                players_.emplace_back([this, connection, segmentIndex]() { play(*connection, segmentIndex); });
+                break;
+            }
+            case ix::WebSocketMessageType::Message: {
+                {
+                    std::lock_guard<std::mutex> lock(connection->mutex);
+                    connection->clientArrivalNs.push_back(steadyNs());
+                    connection->cv.notify_all();
+                }
+                std::lock_guard<std::mutex> lock(statsMutex_);
+                stats_.clientFrames++;
+                break;
+            }
+            case ix::WebSocketMessageType::Close:
+            case ix::WebSocketMessageType::Error: {
+                std::lock_guard<std::mutex> lock(connection->mutex);
+                connection->closed = true;
+                connection->cv.notify_all();
+                break;
+            }
+            default:
+                break;
+            }
+        });
+    }
+
+    /**
+     * @brief 回放一个连接段的服务端帧
+     */
+    void play(Connection& connection, size_t segmentIndex) {
+        const auto& frames = capture_.getFrames();
+        const Segment& segment = segments_[segmentIndex];
+        const int64_t openNs = steadyNs();
+
+        for (size_t i = segment.begin; i < segment.end; ++i) {
+            const CaptureFrame& frame = frames[i];
+            // Open 由握手完成；客户端帧只作为发送条件
+            if (frame.direction == CaptureDirection::ClientBinary || frame.direction == CaptureDirection::Open) {
+                continue;
+            }
+            const Gate& gate = gates_[i];
+
+            int64_t anchorNs = openNs;
+            {
+                std::unique_lock<std::mutex> lock(connection.mutex);
+                const bool arrived = connection.cv.wait_for(
+                    lock, std::chrono::milliseconds(options_.clientWaitTimeoutMs), [&]() {
+                        return !running_ || connection.closed ||
+                               connection.clientArrivalNs.size() >= gate.clientFrames;
+                    });
+                if (!running_ || connection.closed) {
+                    return;
+                }
+                if (!arrived) {
+                    std::lock_guard<std::mutex> statsLock(statsMutex_);
+                    stats_.gateTimeouts++;
+                    anchorNs = steadyNs();
+                } else if (gate.clientFrames > 0) {
+                    anchorNs = connection.clientArrivalNs[gate.clientFrames - 1];
+                }
+
+                const int64_t targetNs = anchorNs + scaledNs(frame.timeUs - gate.anchorUs, options_.speed);
+                connection.cv.wait_for(lock, std::chrono::nanoseconds(std::max<int64_t>(0, targetNs - steadyNs())),
+                                       [&]() { return !running_ || connection.closed; });
+                if (!running_ || connection.closed) {
+                    return;
+                }
+                if (options_.speed > 0.0) {
+                    std::lock_guard<std::mutex> statsLock(statsMutex_);
+                    stats_.maxLagUs = std::max(stats_.maxLagUs, (steadyNs() - targetNs) / 1000);
+                }
+            }
+
+            auto socket = connection.socket.lock();
+            if (!socket) {
+                return;
+            }
+            if (frame.direction == CaptureDirection::ServerBinary) {
+                socket->sendBinary(frame.payload);
+            } else if (frame.direction == CaptureDirection::ServerText) {
+                socket->sendText(frame.payload);
+            } else {
+                // Close / Error：按抓包断开连接
+                const json j = json::parse(frame.payload, nullptr, false);
+                const uint16_t code = j.is_object() ? j.value("code", static_cast<uint16_t>(1000)) : 1000;
+                socket->close(code, j.is_object() ? j.value("reason", std::string()) : frame.payload);
+                break;
+            }
+            std::lock_guard<std::mutex> statsLock(statsMutex_);
+            stats_.serverFrames++;
+            stats_.bytes += frame.payload.size();
+        }
+        sessionsServed_++;
+    }
+
+    const SessionCapture& capture_;
+    ReplayOptions options_;
+    std::vector<Segment> segments_;
+    std::vector<Gate> gates_;
+
+    std::unique_ptr<ix::WebSocketServer> server_;
+    std::atomic<bool> running_{false};
+    std::atomic<size_t> nextSegment_{0};
+    std::atomic<uint64_t> sessionsServed_{0};
+
+    std::mutex connectionsMutex_;
+    std::vector<ConnectionPtr> connections_;
+    std::vector<std::thread> players_;
+
+    mutable std::mutex statsMutex_;
+    ReplayStats stats_;
+};
+
+SessionMockServer::SessionMockServer(const SessionCapture& capture, const ReplayOptions& options)
+    : m_impl(std::make_unique<Impl>(capture, options)) {
+}
+
+SessionMockServer::~SessionMockServer() = default;
+
+bool SessionMockServer::start(const std::string& host, int port, std::string& error) {
+    return m_impl->start(host, port, error);
+}
+
+void SessionMockServer::stop() {
+    m_impl->stop();
+}
+
+uint64_t SessionMockServer::getSessionsServed() const {
+    return m_impl->getSessionsServed();
+}
+
+ReplayStats SessionMockServer::getStats() const {
+    return m_impl->getStats();
+}
+
+} // namespace Asr
@@ -0,0 +1,284 @@
+//
+// 会话内存实现
+//
+
+#include "asr/session_memory.h"
+#include "audio/latency_metrics.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Asr {
+
+namespace {
+// 协议帧头：Header(4) + 序列号(4) + Payload Size(4)
+constexpr size_t kFramePrefix = 12;
+// 解压缓冲的初始大小：JSON 响应的压缩比通常在 4 倍以内
+constexpr size_t kInflateRatio = 4;
+constexpr size_t kMinInflateBytes = 1024;
+
+void writeBigEndian(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<uint8_t>((value >> ((3 - i) * 8)) & 0xFF);
+    }
+}
+
+size_t roundUpPow2(size_t value) {
+    size_t result = 256;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+}
+
+// ============================================================================
+// BufferPool
+// ============================================================================
+
+BufferPool::BufferPool(size_t maxFree) : m_maxFree(std::max<size_t>(1, maxFree)) {
+    m_free.reserve(m_maxFree);
+}
+
+std::vector<uint8_t> BufferPool::acquire(size_t bytes, bool* allocated) {
+    std::vector<uint8_t> buffer;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (bytes > m_blockSize) {
+            // 块大小只增不减：更小的请求继续使用大块，空闲块容量不足的全部丢弃
+            m_blockSize = roundUpPow2(bytes);
+            m_free.clear();
+        }
+        if (!m_free.empty()) {
+            buffer = std::move(m_free.back());
+            m_free.pop_back();
+            ++m_hits;
+            if (allocated) {
+                *allocated = false;
+            }
+            return buffer;
+        }
+        ++m_allocations;
+    }
+    if (allocated) {
+        *allocated = true;
+    }
+    buffer.reserve(m_blockSize);
+    return buffer;
+}
+
+void BufferPool::recycle(std::vector<uint8_t> buffer) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (buffer.capacity() < m_blockSize || m_free.size() >= m_maxFree) {
+        return;
+    }
+    buffer.clear();
+    m_free.push_back(std::move(buffer));
+}
+
+void BufferPool::clear() {
+    std::vector<std::vector<uint8_t>> blocks;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // 交换出来在锁外释放；空闲列表重新预留，归还时不再分配
+        blocks.swap(m_free);
+        m_free.reserve(m_maxFree);
+    }
+}
+
+size_t BufferPool::blockSize() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_blockSize;
+}
+
+size_t BufferPool::freeBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t bytes = 0;
+    for (const auto& block : m_free) {
+        bytes += block.capacity();
+    }
+    return bytes;
+}
+
+uint64_t BufferPool::hits() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hits;
+}
+
+uint64_t BufferPool::allocations() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_allocations;
+}
+
+// ============================================================================
+// SessionMemory
+// ============================================================================
+
+SessionMemory::SessionMemory() = default;
+
+SessionMemory::~SessionMemory() {
+    release();
+}
+
+void SessionMemory::countAllocation() {
+    static auto& counter =
+        perfx::audio::MetricsRegistry::instance().counter(perfx::audio::metrics::kAsrSessionAllocations);
+    counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<uint8_t> SessionMemory::encodeFrame(const std::array<uint8_t, 4>& header, int32_t sequence,
+                                                const void* payload, size_t size) {
+    std::lock_guard<std::mutex> lock(m_encodeMutex);
+    if (!m_deflateReady) {
+        m_deflate.zalloc = Z_NULL;
+        m_deflate.zfree = Z_NULL;
+        m_deflate.opaque = Z_NULL;
+        if (deflateInit2(&m_deflate, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8,
+                         Z_DEFAULT_STRATEGY) != Z_OK) {
+            return {};
+        }
+        m_deflateReady = true;
+        ++m_deflateInits;
+        countAllocation();
+    } else if (deflateReset(&m_deflate) != Z_OK) {
+        return {};
+    }
+
+    // 压缩结果直接写进帧内，不再经过单独的 payload 缓冲区
+    const size_t bound = deflateBound(&m_deflate, static_cast<uLong>(size));
+    bool allocated = false;
+    std::vector<uint8_t> frame = m_frames.acquire(kFramePrefix + bound, &allocated);
+    if (allocated) {
+        countAllocation();
+    }
+    frame.resize(kFramePrefix + bound);
+    std::memcpy(frame.data(), header.data(), header.size());
+    writeBigEndian(frame.data() + 4, static_cast<uint32_t>(sequence));
+
+    m_deflate.next_in = reinterpret_cast<Bytef*>(const_cast<void*>(payload));
+    m_deflate.avail_in = static_cast<uInt>(size);
+    m_deflate.next_out = frame.data() + kFramePrefix;
+    m_deflate.avail_out = static_cast<uInt>(bound);
+    if (deflate(&m_deflate, Z_FINISH) != Z_STREAM_END) {
+        m_frames.recycle(std::move(frame));
+        return {};
+    }
+    const size_t payloadSize = bound - m_deflate.avail_out;
+    writeBigEndian(frame.data() + 8, static_cast<uint32_t>(payloadSize));
+    frame.resize(kFramePrefix + payloadSize);
+    ++m_framesEncoded;
+    return frame;
+}
+
+void SessionMemory::recycle(std::vector<uint8_t> frame) {
+    m_frames.recycle(std::move(frame));
+}
+
+bool SessionMemory::decompress(const char* data, size_t size, std::string& out) {
+    std::lock_guard<std::mutex> lock(m_decodeMutex);
+    out.clear();
+    if (size == 0) {
+        return true;
+    }
+    if (!m_inflateReady) {
+        m_inflate.zalloc = Z_NULL;
+        m_inflate.zfree = Z_NULL;
+        m_inflate.opaque = Z_NULL;
+        m_inflate.next_in = Z_NULL;
+        m_inflate.avail_in = 0;
+        if (inflateInit2(&m_inflate, 16 + MAX_WBITS) != Z_OK) {
+            return false;
+        }
+        m_inflateReady = true;
+        ++m_inflateInits;
+        countAllocation();
+    } else if (inflateReset(&m_inflate) != Z_OK) {
+        return false;
+    }
+
+    const size_t capacity = out.capacity();
+    out.resize(std::max({capacity, size * kInflateRatio, kMinInflateBytes}));
+    m_inflate.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    m_inflate.avail_in = static_cast<uInt>(size);
+    size_t produced = 0;
+    bool ok = true;
+    while (true) {
+        m_inflate.next_out = reinterpret_cast<Bytef*>(&out[produced]);
+        m_inflate.avail_out = static_cast<uInt>(out.size() - produced);
+        const int ret = inflate(&m_inflate, Z_NO_FLUSH);
+        produced = out.size() - m_inflate.avail_out;
+        if (ret == Z_STREAM_ERROR || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR || ret == Z_NEED_DICT) {
+            ok = false;
+            break;
+        }
+        // 输出区写满说明还有数据，扩容继续；否则已结束或输入不完整
+        if (ret == Z_STREAM_END || m_inflate.avail_out != 0) {
+            break;
+        }
+        out.resize(out.size() * 2);
+    }
+    out.resize(ok ? produced : 0);
+    if (out.capacity() > capacity) {
+        ++m_scratchGrowths;
+        countAllocation();
+    }
+    ++m_responsesDecoded;
+    return ok;
+}
+
+std::string SessionMemory::takeText() {
+    std::lock_guard<std::mutex> lock(m_decodeMutex);
+    return std::move(m_text);
+}
+
+void SessionMemory::returnText(std::string text) {
+    std::lock_guard<std::mutex> lock(m_decodeMutex);
+    // 同时有两个调用方时保留容量较大的那个
+    if (text.capacity() > m_text.capacity()) {
+        m_text = std::move(text);
+    }
+}
+
+void SessionMemory::release() {
+    {
+        std::lock_guard<std::mutex> lock(m_encodeMutex);
+        if (m_deflateReady) {
+            deflateEnd(&m_deflate);
+            m_deflateReady = false;
+        }
+        m_frames.clear();
+    }
+    std::string text;
+    {
+        std::lock_guard<std::mutex> lock(m_decodeMutex);
+        if (m_inflateReady) {
+            inflateEnd(&m_inflate);
+            m_inflateReady = false;
+        }
+        text.swap(m_text);
+        ++m_releases;
+    }
+}
+
+SessionMemoryStats SessionMemory::stats() const {
+    SessionMemoryStats stats;
+    stats.poolHits = m_frames.hits();
+    stats.poolAllocations = m_frames.allocations();
+    stats.blockSize = m_frames.blockSize();
+    stats.retainedBytes = m_frames.freeBytes();
+    {
+        std::lock_guard<std::mutex> lock(m_encodeMutex);
+        stats.framesEncoded = m_framesEncoded;
+        stats.codecInits += m_deflateInits;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_decodeMutex);
+        stats.responsesDecoded = m_responsesDecoded;
+        stats.scratchGrowths = m_scratchGrowths;
+        stats.codecInits += m_inflateInits;
+        stats.releases = m_releases;
+        stats.retainedBytes += m_text.capacity();
+    }
+    return stats;
+}
+
+} // namespace Asr
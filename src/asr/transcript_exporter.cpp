@@ -0,0 +1,877 @@
+//
+// 转录结果导出实现
+//
+
+#include "asr/transcript_exporter.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace Asr {
+
+namespace {
+
+// ============================================================================
+// UTF-8 与断行规则
+// ============================================================================
+
+/**
+ * @brief 解码一个码点，非法序列按单字节 U+FFFD 处理
+ */
+uint32_t decodeUtf8(const std::string& text, size_t& pos) {
+    const unsigned char lead = static_cast<unsigned char>(text[pos]);
+    if (lead < 0x80) {
+        pos++;
+        return lead;
+    }
+    size_t extra;
+    uint32_t cp;
+    if ((lead & 0xE0) == 0xC0) {
+        extra = 1;
+        cp = lead & 0x1F;
+    } else if ((lead & 0xF0) == 0xE0) {
+        extra = 2;
+        cp = lead & 0x0F;
+    } else if ((lead & 0xF8) == 0xF0) {
+        extra = 3;
+        cp = lead & 0x07;
+    } else {
+        pos++;
+        return 0xFFFD;
+    }
+    if (text.size() - pos <= extra) {
+        pos++;
+        return 0xFFFD;
+    }
+    for (size_t i = 1; i <= extra; ++i) {
+        const unsigned char next = static_cast<unsigned char>(text[pos + i]);
+        if ((next & 0xC0) != 0x80) {
+            pos++;
+            return 0xFFFD;
+        }
+        cp = (cp << 6) | (next & 0x3F);
+    }
+    pos += extra + 1;
+    return cp;
+}
+
+/**
+ * @brief data 开头合法 UTF-8 序列的字节数（RFC 3629：拒绝过长编码、代理区与超出 U+10FFFF），非法时返回 0
+ */
+size_t validUtf8Length(const unsigned char* data, size_t size) {
+    const unsigned char lead = data[0];
+    size_t length;
+    unsigned char low = 0x80;
+    unsigned char high = 0xBF;
+    if (lead < 0x80) {
+        return 1;
+    } else if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        if (lead == 0xE0) low = 0xA0;
+        if (lead == 0xED) high = 0x9F;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        if (lead == 0xF0) low = 0x90;
+        if (lead == 0xF4) high = 0x8F;
+    } else {
+        return 0;
+    }
+    if (size < length || data[1] < low || data[1] > high) {
+        return 0;
+    }
+    for (size_t i = 2; i < length; ++i) {
+        if ((data[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+    }
+    return length;
+}
+
+bool isSpace(uint32_t cp) {
+    return cp == ' ' || cp == '\t' || cp == '\n' || cp == '\r' || cp == 0xA0 || cp == 0x3000;
+}
+
+/**
+ * @brief 全角字符（显示宽度 2 列）
+ */
+bool isWide(uint32_t cp) {
+    return (cp >= 0x1100 && cp <= 0x115F) || (cp >= 0x2E80 && cp <= 0xA4CF) ||
+           (cp >= 0xAC00 && cp <= 0xD7A3) || (cp >= 0xF900 && cp <= 0xFAFF) ||
+           (cp >= 0xFE30 && cp <= 0xFE4F) || (cp >= 0xFF00 && cp <= 0xFF60) ||
+           (cp >= 0xFFE0 && cp <= 0xFFE6) || (cp >= 0x20000 && cp <= 0x3FFFD);
+}
+
+/**
+ * @brief 可在任意字符间断行的文字（汉字、假名、全角符号）
+ */
+bool isBreakAnywhere(uint32_t cp) {
+    return (cp >= 0x2E80 && cp <= 0x30FF) || (cp >= 0x3400 && cp <= 0x4DBF) ||
+           (cp >= 0x4E00 && cp <= 0x9FFF) || (cp >= 0xF900 && cp <= 0xFAFF) ||
+           (cp >= 0xFF00 && cp <= 0xFF60) || (cp >= 0x20000 && cp <= 0x3FFFD);
+}
+
+bool isPunct(uint32_t cp) {
+    if (cp < 0x80) {
+        return std::ispunct(static_cast<int>(cp)) != 0;
+    }
+    return (cp >= 0x2000 && cp <= 0x206F) || (cp >= 0x3000 && cp <= 0x303F) ||
+           (cp >= 0xFF01 && cp <= 0xFF0F) || (cp >= 0xFF1A && cp <= 0xFF20) ||
+           (cp >= 0xFF3B && cp <= 0xFF40) || (cp >= 0xFF5B && cp <= 0xFF65);
+}
+
+/**
+ * @brief 开括号 / 前引号：可以出现在行首
+ */
+bool isOpeningPunct(uint32_t cp) {
+    switch (cp) {
+    case '(': case '[': case '{': case '"': case '\'':
+    case 0x2018: case 0x201C: case 0x3008: case 0x300A: case 0x300C:
+    case 0x300E: case 0x3010: case 0x3014: case 0x3016: case 0xFF08:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief 参与词级时间对齐的字符数（不计空白与标点，服务端的词通常不含标点）
+ */
+int contentLength(const std::string& text) {
+    int count = 0;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        const uint32_t cp = decodeUtf8(text, pos);
+        if (!isSpace(cp) && !isPunct(cp)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// ============================================================================
+// 分句切分
+// ============================================================================
+
+/**
+ * @brief 断行单元：西文单词、单个汉字，后随的标点并入前一单元（标点不出现在行首）
+ */
+struct TextUnit {
+    size_t begin = 0;           // 在分句文本中的字节范围
+    size_t end = 0;
+    int width = 0;              // 显示宽度（列）
+    bool spaceBefore = false;   // 与前一单元之间有空白
+    int contentBegin = 0;       // 之前的内容字符数
+    int contentCount = 0;
+    int64_t startMs = 0;
+    int64_t endMs = 0;
+};
+
+/**
+ * @brief 把分句切分为断行单元并估算每个单元的时间（成员容器复用，逐句处理不重复分配）
+ */
+class UnitLayout {
+public:
+    void build(const CachedUtterance& utterance) {
+        tokenize(utterance.text);
+        assignTimes(utterance);
+    }
+
+    const std::vector<TextUnit>& units() const { return m_units; }
+
+    /**
+     * @brief 单元时间来自词级结果（而不是按字数比例估算）
+     */
+    bool hasWordTimes() const { return m_exactWords; }
+
+private:
+    void tokenize(const std::string& text) {
+        m_units.clear();
+        bool pendingSpace = false;
+        bool inWord = false;
+        int content = 0;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            const size_t start = pos;
+            const uint32_t cp = decodeUtf8(text, pos);
+            if (isSpace(cp)) {
+                pendingSpace = !m_units.empty();
+                inWord = false;
+                continue;
+            }
+
+            const int width = isWide(cp) ? 2 : 1;
+            const bool punct = isPunct(cp);
+            const bool breakAnywhere = isBreakAnywhere(cp);
+            bool attach = false;
+            if (!m_units.empty() && !pendingSpace) {
+                attach = (inWord && !breakAnywhere) || (punct && !isOpeningPunct(cp));
+            }
+
+            if (attach) {
+                TextUnit& unit = m_units.back();
+                unit.end = pos;
+                unit.width += width;
+                unit.contentCount += punct ? 0 : 1;
+            } else {
+                TextUnit unit;
+                unit.begin = start;
+                unit.end = pos;
+                unit.width = width;
+                unit.spaceBefore = pendingSpace;
+                unit.contentBegin = content;
+                unit.contentCount = punct ? 0 : 1;
+                m_units.push_back(unit);
+            }
+            if (!punct) {
+                content++;
+            }
+            // 西文标点仍属于当前单词，全角标点结束单词
+            inWord = !breakAnywhere && !(punct && cp >= 0x80);
+            pendingSpace = false;
+        }
+        m_contentTotal = content;
+    }
+
+    void assignTimes(const CachedUtterance& utterance) {
+        m_wordEnds.clear();
+        int total = 0;
+        for (const auto& word : utterance.words) {
+            total += contentLength(word.text);
+            m_wordEnds.push_back(total);
+        }
+        // 词与分句文本的内容字符一一对应时按词对齐，否则按字数比例估算
+        m_exactWords = !utterance.words.empty() && total > 0 && total == m_contentTotal;
+
+        const int64_t duration = std::max<int64_t>(0, utterance.endMs - utterance.startMs);
+        for (auto& unit : m_units) {
+            if (m_exactWords) {
+                const size_t first = wordAt(unit.contentBegin);
+                const size_t last = wordAt(unit.contentBegin + std::max(unit.contentCount, 1) - 1);
+                unit.startMs = utterance.words[first].startMs;
+                unit.endMs = std::max(unit.startMs, utterance.words[last].endMs);
+            } else if (m_contentTotal > 0) {
+                unit.startMs = utterance.startMs + duration * unit.contentBegin / m_contentTotal;
+                unit.endMs = utterance.startMs +
+                    duration * (unit.contentBegin + unit.contentCount) / m_contentTotal;
+            } else {
+                unit.startMs = utterance.startMs;
+                unit.endMs = utterance.endMs;
+            }
+        }
+    }
+
+    size_t wordAt(int contentIndex) const {
+        const auto it = std::upper_bound(m_wordEnds.begin(), m_wordEnds.end(), contentIndex);
+        return std::min(static_cast<size_t>(it - m_wordEnds.begin()), m_wordEnds.size() - 1);
+    }
+
+    std::vector<TextUnit> m_units;
+    std::vector<int> m_wordEnds;
+    int m_contentTotal = 0;
+    bool m_exactWords = false;
+};
+
+// ============================================================================
+// 时间格式
+// ============================================================================
+
+/**
+ * @brief HH:MM:SS<sep>mmm（SRT 用逗号，WebVTT 用点）
+ */
+void writeClock(ExportWriter& writer, int64_t ms, char separator) {
+    ms = std::max<int64_t>(0, ms);
+    const int64_t hours = ms / 3600000;
+    const int minutes = static_cast<int>(ms / 60000 % 60);
+    const int seconds = static_cast<int>(ms / 1000 % 60);
+    const int millis = static_cast<int>(ms % 1000);
+    if (hours < 10) {
+        writer.put('0');
+    }
+    writer.writeInt(hours);
+    const char text[] = {
+        ':', static_cast<char>('0' + minutes / 10), static_cast<char>('0' + minutes % 10),
+        ':', static_cast<char>('0' + seconds / 10), static_cast<char>('0' + seconds % 10),
+        separator, static_cast<char>('0' + millis / 100), static_cast<char>('0' + millis / 10 % 10),
+        static_cast<char>('0' + millis % 10)
+    };
+    writer.write(text, sizeof(text));
+}
+
+/**
+ * @brief mm:ss.xx（LRC，分钟数不封顶）
+ */
+void writeLrcClock(ExportWriter& writer, int64_t ms) {
+    ms = std::max<int64_t>(0, ms);
+    const int64_t minutes = ms / 60000;
+    const int seconds = static_cast<int>(ms / 1000 % 60);
+    const int centis = static_cast<int>(ms % 1000 / 10);
+    if (minutes < 10) {
+        writer.put('0');
+    }
+    writer.writeInt(minutes);
+    const char text[] = {
+        ':', static_cast<char>('0' + seconds / 10), static_cast<char>('0' + seconds % 10),
+        '.', static_cast<char>('0' + centis / 10), static_cast<char>('0' + centis % 10)
+    };
+    writer.write(text, sizeof(text));
+}
+
+/**
+ * @brief WebVTT 字幕文本转义（& < > 必须转义，同时避免文本中出现 "-->"）
+ */
+void writeVttText(ExportWriter& writer, const char* data, size_t size) {
+    size_t run = 0;
+    for (size_t i = 0; i < size; ++i) {
+        const char* entity = nullptr;
+        switch (data[i]) {
+        case '&': entity = "&amp;"; break;
+        case '<': entity = "&lt;"; break;
+        case '>': entity = "&gt;"; break;
+        default: continue;
+        }
+        writer.write(data + run, i - run);
+        writer.write(entity, std::char_traits<char>::length(entity));
+        run = i + 1;
+    }
+    writer.write(data + run, size - run);
+}
+
+// ============================================================================
+// JSON
+// ============================================================================
+
+/**
+ * @brief {"utterances":[...],"count":N,"duration_ms":T}
+ *
+ * 总数与总时长在末尾输出，写出过程中不需要预先知道分句数量
+ */
+class JsonExporter : public TranscriptExporter {
+public:
+    JsonExporter(ExportWriter& writer, const ExportOptions& options) : m_writer(writer), m_options(options) {}
+
+    void begin() override {
+        static const char kHead[] = "{\"utterances\":[";
+        m_writer.write(kHead, sizeof(kHead) - 1);
+    }
+
+    void add(const CachedUtterance& utterance) override {
+        m_writer.write(m_count == 0 ? "\n  " : ",\n  ", m_count == 0 ? 3 : 4);
+        m_writer.write("{\"index\":", 9);
+        m_writer.writeInt(static_cast<int64_t>(m_count));
+        m_writer.write(",\"start_ms\":", 12);
+        m_writer.writeInt(utterance.startMs);
+        m_writer.write(",\"end_ms\":", 10);
+        m_writer.writeInt(utterance.endMs);
+        if (utterance.definite) {
+            m_writer.write(",\"definite\":true", 16);
+        } else {
+            m_writer.write(",\"definite\":false", 17);
+        }
+        if (!utterance.speaker.empty()) {
+            m_writer.write(",\"speaker\":", 11);
+            m_writer.writeJsonString(utterance.speaker);
+        }
+        m_writer.write(",\"text\":", 8);
+        m_writer.writeJsonString(utterance.text);
+
+        if (m_options.wordTimestamps && !utterance.words.empty()) {
+            m_writer.write(",\"words\":[", 10);
+            for (size_t i = 0; i < utterance.words.size(); ++i) {
+                const auto& word = utterance.words[i];
+                m_writer.write(i == 0 ? "{\"text\":" : ",{\"text\":", i == 0 ? 8 : 9);
+                m_writer.writeJsonString(word.text);
+                m_writer.write(",\"start_ms\":", 12);
+                m_writer.writeInt(word.startMs);
+                m_writer.write(",\"end_ms\":", 10);
+                m_writer.writeInt(word.endMs);
+                m_writer.put('}');
+            }
+            m_writer.put(']');
+        }
+        m_writer.put('}');
+
+        m_count++;
+        m_durationMs = std::max(m_durationMs, utterance.endMs);
+    }
+
+    void finish() override {
+        m_writer.write(m_count == 0 ? "]" : "\n]", m_count == 0 ? 1 : 2);
+        m_writer.write(",\"count\":", 9);
+        m_writer.writeInt(static_cast<int64_t>(m_count));
+        m_writer.write(",\"duration_ms\":", 15);
+        m_writer.writeInt(m_durationMs);
+        m_writer.write("}\n", 2);
+    }
+
+private:
+    ExportWriter& m_writer;
+    ExportOptions m_options;
+    size_t m_count = 0;
+    int64_t m_durationMs = 0;
+};
+
+// ============================================================================
+// SRT / WebVTT
+// ============================================================================
+
+class SubtitleExporter : public TranscriptExporter {
+public:
+    SubtitleExporter(ExportWriter& writer, const ExportOptions& options, bool webVtt)
+        : m_writer(writer), m_options(options), m_webVtt(webVtt) {
+        m_options.maxLineWidth = std::max(m_options.maxLineWidth, 1);
+        m_options.maxLines = std::max(m_options.maxLines, 1);
+    }
+
+    void begin() override {
+        if (m_webVtt) {
+            m_writer.write("WEBVTT\n\n", 8);
+        }
+    }
+
+    /**
+     * @brief 按显示宽度贪心断行；行数或时长超限时结束当前字幕
+     */
+    void add(const CachedUtterance& utterance) override {
+        m_layout.build(utterance);
+        const auto& units = m_layout.units();
+        if (units.empty()) {
+            return;
+        }
+
+        size_t cueBegin = 0;
+        int lineWidth = 0;
+        int lines = 1;
+        m_lineStarts.clear();
+        for (size_t i = 0; i < units.size(); ++i) {
+            const TextUnit& unit = units[i];
+            const int width = unit.width + (lineWidth > 0 && unit.spaceBefore ? 1 : 0);
+            if (i > cueBegin) {
+                const bool tooLong = unit.endMs - units[cueBegin].startMs > m_options.maxCueMs;
+                const bool lineFull = lineWidth + width > m_options.maxLineWidth;
+                if (tooLong || (lineFull && lines >= m_options.maxLines)) {
+                    writeCue(utterance, cueBegin, i);
+                    cueBegin = i;
+                    lineWidth = 0;
+                    lines = 1;
+                    m_lineStarts.clear();
+                } else if (lineFull) {
+                    m_lineStarts.push_back(i);
+                    lineWidth = 0;
+                    lines++;
+                }
+            }
+            lineWidth += unit.width + (lineWidth > 0 && unit.spaceBefore ? 1 : 0);
+        }
+        writeCue(utterance, cueBegin, units.size());
+    }
+
+    void finish() override {}
+
+private:
+    void writeCue(const CachedUtterance& utterance, size_t begin, size_t end) {
+        const auto& units = m_layout.units();
+        // 分句首尾沿用分句时间，中间的切分点取单元时间
+        const int64_t startMs = begin == 0 ? utterance.startMs : units[begin].startMs;
+        int64_t endMs = end == units.size() ? utterance.endMs : units[end - 1].endMs;
+        endMs = std::max(endMs, startMs + 1);
+
+        const char separator = m_webVtt ? '.' : ',';
+        if (!m_webVtt) {
+            m_writer.writeInt(static_cast<int64_t>(++m_cueIndex));
+            m_writer.put('\n');
+        }
+        writeClock(m_writer, startMs, separator);
+        m_writer.write(" --> ", 5);
+        writeClock(m_writer, endMs, separator);
+        m_writer.put('\n');
+
+        const bool wordTags = m_webVtt && m_options.wordTimestamps && m_layout.hasWordTimes();
+        int64_t lastTagMs = units[begin].startMs;
+        size_t nextLine = 0;
+        for (size_t i = begin; i < end; ++i) {
+            const TextUnit& unit = units[i];
+            if (nextLine < m_lineStarts.size() && m_lineStarts[nextLine] == i) {
+                m_writer.put('\n');
+                nextLine++;
+            } else if (i > begin && unit.spaceBefore) {
+                m_writer.put(' ');
+            }
+            // 卡拉 OK 式时间标签：<HH:MM:SS.mmm> 之后的文字从该时刻起高亮
+            if (wordTags && i > begin && unit.startMs > lastTagMs && unit.startMs < endMs) {
+                m_writer.put('<');
+                writeClock(m_writer, unit.startMs, '.');
+                m_writer.put('>');
+                lastTagMs = unit.startMs;
+            }
+            const char* text = utterance.text.data() + unit.begin;
+            if (m_webVtt) {
+                writeVttText(m_writer, text, unit.end - unit.begin);
+            } else {
+                m_writer.write(text, unit.end - unit.begin);
+            }
+        }
+        m_writer.write("\n\n", 2);
+    }
+
+    ExportWriter& m_writer;
+    ExportOptions m_options;
+    bool m_webVtt;
+    UnitLayout m_layout;
+    std::vector<size_t> m_lineStarts;
+    size_t m_cueIndex = 0;
+};
+
+// ============================================================================
+// LRC
+// ============================================================================
+
+/**
+ * @brief 每个分句一行 [mm:ss.xx]；开启词级时间时输出增强 LRC（<mm:ss.xx> 词标签）
+ */
+class LrcExporter : public TranscriptExporter {
+public:
+    LrcExporter(ExportWriter& writer, const ExportOptions& options) : m_writer(writer), m_options(options) {}
+
+    void begin() override {
+        if (!m_options.title.empty()) {
+            m_writer.write("[ti:", 4);
+            writeLineText(m_options.title);
+            m_writer.write("]\n", 2);
+        }
+        static const char kBy[] = "[by:PerfXAgent]\n\n";
+        m_writer.write(kBy, sizeof(kBy) - 1);
+    }
+
+    void add(const CachedUtterance& utterance) override {
+        m_layout.build(utterance);
+        const auto& units = m_layout.units();
+        if (units.empty()) {
+            return;
+        }
+
+        m_writer.put('[');
+        writeLrcClock(m_writer, utterance.startMs);
+        m_writer.put(']');
+
+        const bool wordTags = m_options.wordTimestamps && m_layout.hasWordTimes();
+        int64_t lastTagMs = -1;
+        for (size_t i = 0; i < units.size(); ++i) {
+            const TextUnit& unit = units[i];
+            if (i > 0 && unit.spaceBefore) {
+                m_writer.put(' ');
+            }
+            if (wordTags && unit.startMs > lastTagMs) {
+                m_writer.put('<');
+                writeLrcClock(m_writer, unit.startMs);
+                m_writer.put('>');
+                lastTagMs = unit.startMs;
+            }
+            m_writer.write(utterance.text.data() + unit.begin, unit.end - unit.begin);
+        }
+        if (wordTags) {
+            m_writer.put('<');
+            writeLrcClock(m_writer, std::max(utterance.endMs, lastTagMs));
+            m_writer.put('>');
+        }
+        m_writer.put('\n');
+    }
+
+    void finish() override {}
+
+private:
+    void writeLineText(const std::string& text) {
+        for (char c : text) {
+            m_writer.put(c == '\n' || c == '\r' || c == ']' ? ' ' : c);
+        }
+    }
+
+    ExportWriter& m_writer;
+    ExportOptions m_options;
+    UnitLayout m_layout;
+};
+
+/**
+ * @brief JSON 字符串中需要转义（或校验 UTF-8）的字节
+ */
+struct JsonEscapeTable {
+    bool escape[256] = {};
+    JsonEscapeTable() {
+        for (int c = 0; c < 0x20; ++c) {
+            escape[c] = true;
+        }
+        for (int c = 0x80; c < 0x100; ++c) {
+            escape[c] = true;
+        }
+        escape[static_cast<unsigned char>('"')] = true;
+        escape[static_cast<unsigned char>('\\')] = true;
+    }
+};
+
+const JsonEscapeTable kJsonEscape;
+
+} // namespace
+
+// ============================================================================
+// 格式
+// ============================================================================
+
+bool exportFormatFromName(const std::string& name, ExportFormat& format) {
+    std::string value = name;
+    if (!value.empty() && value[0] == '.') {
+        value.erase(0, 1);
+    }
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (value == "json") {
+        format = ExportFormat::Json;
+    } else if (value == "srt") {
+        format = ExportFormat::Srt;
+    } else if (value == "vtt" || value == "webvtt") {
+        format = ExportFormat::WebVtt;
+    } else if (value == "lrc") {
+        format = ExportFormat::Lrc;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+ExportOptions exportOptionsFromConfig(const AsrApiConfig& config) {
+    ExportOptions options;
+    options.wordTimestamps = config.enableWordTimeOffset;
+    return options;
+}
+
+const char* exportFormatExtension(ExportFormat format) {
+    switch (format) {
+    case ExportFormat::Json: return "json";
+    case ExportFormat::Srt: return "srt";
+    case ExportFormat::WebVtt: return "vtt";
+    case ExportFormat::Lrc: return "lrc";
+    }
+    return "txt";
+}
+
+// ============================================================================
+// 输出
+// ============================================================================
+
+bool StringSink::write(const char* data, size_t size) {
+    m_output.append(data, size);
+    return true;
+}
+
+FileSink::~FileSink() {
+    discard();
+}
+
+bool FileSink::open(const std::string& path, std::string& error) {
+    discard();
+    m_path = path;
+    m_tempPath = path + ".tmp";
+    m_failed = false;
+    m_file = std::fopen(m_tempPath.c_str(), "wb");
+    if (!m_file) {
+        error = "Failed to open for writing: " + m_tempPath;
+        return false;
+    }
+    // ExportWriter 已按块缓冲，关闭 stdio 缓冲避免二次拷贝
+    std::setvbuf(m_file, nullptr, _IONBF, 0);
+    return true;
+}
+
+bool FileSink::write(const char* data, size_t size) {
+    if (!m_file || m_failed) {
+        return false;
+    }
+    if (size > 0 && std::fwrite(data, 1, size, m_file) != size) {
+        m_failed = true;
+        return false;
+    }
+    return true;
+}
+
+bool FileSink::commit(std::string& error) {
+    if (!m_file) {
+        error = "Export file is not open";
+        return false;
+    }
+    const bool closed = std::fclose(m_file) == 0;
+    m_file = nullptr;
+    if (m_failed || !closed) {
+        error = "Failed to write: " + m_tempPath;
+        discard();
+        return false;
+    }
+
+    std::error_code ec;
+    fs::rename(m_tempPath, m_path, ec);
+    if (ec) {
+        error = "Failed to replace " + m_path + ": " + ec.message();
+        discard();
+        return false;
+    }
+    m_tempPath.clear();
+    return true;
+}
+
+void FileSink::discard() {
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+    if (!m_tempPath.empty()) {
+        std::error_code ec;
+        fs::remove(m_tempPath, ec);
+        m_tempPath.clear();
+    }
+}
+
+ExportWriter::ExportWriter(ExportSink& sink)
+    : m_sink(sink), m_buffer(new char[kBufferSize]) {}
+
+ExportWriter::~ExportWriter() {
+    flush();
+}
+
+void ExportWriter::write(const char* data, size_t size) {
+    if (size >= kBufferSize) {
+        // 大块数据直接写出，不经过缓冲
+        flush();
+        if (!m_failed && !m_sink.write(data, size)) {
+            m_failed = true;
+        }
+        return;
+    }
+    if (m_size + size > kBufferSize) {
+        flush();
+    }
+    std::copy(data, data + size, m_buffer.get() + m_size);
+    m_size += size;
+}
+
+void ExportWriter::writeInt(int64_t value) {
+    char text[24];
+    const auto result = std::to_chars(text, text + sizeof(text), value);
+    write(text, static_cast<size_t>(result.ptr - text));
+}
+
+void ExportWriter::writeJsonString(const char* data, size_t size) {
+    static const char kHex[] = "0123456789abcdef";
+    put('"');
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    size_t run = 0;
+    size_t i = 0;
+    while (i < size) {
+        const unsigned char c = bytes[i];
+        if (!kJsonEscape.escape[c]) {
+            ++i;
+            continue;
+        }
+        if (c >= 0x80) {
+            // 合法多字节序列原样输出，非法字节逐个替换为 U+FFFD，保证输出是合法 JSON
+            const size_t length = validUtf8Length(bytes + i, size - i);
+            if (length > 0) {
+                i += length;
+                continue;
+            }
+            write(data + run, i - run);
+            write("\xEF\xBF\xBD", 3);
+            run = ++i;
+            continue;
+        }
+        write(data + run, i - run);
+        run = ++i;
+        switch (c) {
+        case '"': write("\\\"", 2); break;
+        case '\\': write("\\\\", 2); break;
+        case '\n': write("\\n", 2); break;
+        case '\r': write("\\r", 2); break;
+        case '\t': write("\\t", 2); break;
+        case '\b': write("\\b", 2); break;
+        case '\f': write("\\f", 2); break;
+        default: {
+            const char escaped[] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0x0F]};
+            write(escaped, sizeof(escaped));
+            break;
+        }
+        }
+    }
+    write(data + run, size - run);
+    put('"');
+}
+
+bool ExportWriter::flush() {
+    if (m_size > 0) {
+        if (!m_failed && !m_sink.write(m_buffer.get(), m_size)) {
+            m_failed = true;
+        }
+        m_size = 0;
+    }
+    return !m_failed;
+}
+
+// ============================================================================
+// 导出器
+// ============================================================================
+
+std::unique_ptr<TranscriptExporter> TranscriptExporter::create(ExportFormat format, ExportWriter& writer,
+                                                               const ExportOptions& options) {
+    switch (format) {
+    case ExportFormat::Json:
+        return std::make_unique<JsonExporter>(writer, options);
+    case ExportFormat::Srt:
+        return std::make_unique<SubtitleExporter>(writer, options, false);
+    case ExportFormat::WebVtt:
+        return std::make_unique<SubtitleExporter>(writer, options, true);
+    case ExportFormat::Lrc:
+        return std::make_unique<LrcExporter>(writer, options);
+    }
+    return nullptr;
+}
+
+bool exportTranscript(const std::vector<CachedUtterance>& utterances, ExportFormat format,
+                      const std::string& filePath, const ExportOptions& options, std::string& error) {
+    FileSink sink;
+    if (!sink.open(filePath, error)) {
+        return false;
+    }
+    {
+        ExportWriter writer(sink);
+        auto exporter = TranscriptExporter::create(format, writer, options);
+        exporter->begin();
+        for (const auto& utterance : utterances) {
+            exporter->add(utterance);
+        }
+        exporter->finish();
+        if (!writer.flush()) {
+            error = "Failed to write: " + filePath;
+            sink.discard();
+            return false;
+        }
+    }
+    return sink.commit(error);
+}
+
+std::string exportTranscriptToString(const std::vector<CachedUtterance>& utterances, ExportFormat format,
+                                     const ExportOptions& options) {
+    std::string output;
+    StringSink sink(output);
+    {
+        ExportWriter writer(sink);
+        auto exporter = TranscriptExporter::create(format, writer, options);
+        exporter->begin();
+        for (const auto& utterance : utterances) {
+            exporter->add(utterance);
+        }
+        exporter->finish();
+    }
+    return output;
+}
+
+} // namespace Asr
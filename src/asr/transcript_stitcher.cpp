@@ -0,0 +1,157 @@
+//
+// 多会话转录拼接实现
+//
+
+#include "asr/transcript_stitcher.h"
+#include <algorithm>
+
+namespace Asr {
+
+TranscriptStitcher::TranscriptStitcher(int64_t guardMs, int64_t toleranceMs)
+    : m_guardMs(guardMs), m_toleranceMs(toleranceMs) {}
+
+void TranscriptStitcher::reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_committed.clear();
+    m_cutMs = 0;
+    m_sessions.clear();
+}
+
+TranscriptStitcher::Session* TranscriptStitcher::findLocked(const void* session) {
+    for (auto& s : m_sessions) {
+        if (s.id == session) {
+            return &s;
+        }
+    }
+    return nullptr;
+}
+
+const TranscriptStitcher::Session* TranscriptStitcher::findLocked(const void* session) const {
+    for (const auto& s : m_sessions) {
+        if (s.id == session) {
+            return &s;
+        }
+    }
+    return nullptr;
+}
+
+void TranscriptStitcher::beginSession(const void* session, int64_t startMs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (findLocked(session)) {
+        return;
+    }
+    Session s;
+    s.id = session;
+    s.startMs = startMs;
+    m_sessions.push_back(std::move(s));
+}
+
+void TranscriptStitcher::endSession(const void* session, int64_t endMs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (Session* s = findLocked(session)) {
+        s->endMs = endMs;
+    }
+}
+
+bool TranscriptStitcher::update(const void* session, const std::string& message) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Session* s = findLocked(session);
+    if (!s) {
+        return false;
+    }
+    std::vector<CachedUtterance> utterances;
+    if (!TranscriptionCache::parseServerMessage(message, s->startMs, utterances)) {
+        return false;
+    }
+    s->utterances = std::move(utterances);
+    return true;
+}
+
+void TranscriptStitcher::closeSession(const void* session) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = std::find_if(m_sessions.begin(), m_sessions.end(),
+                           [session](const Session& s) { return s.id == session; });
+    if (it == m_sessions.end()) {
+        return;
+    }
+
+    // 后继会话的起点；没有后继时（正常停止或断线重连）提交全部分句
+    const auto next = std::next(it);
+    const bool hasSuccessor = next != m_sessions.end();
+    const int64_t successorStartMs = hasSuccessor ? next->startMs : INT64_MAX;
+    const int64_t lastPacketMs = it->endMs >= 0 ? it->endMs : INT64_MAX;
+
+    for (const auto& utterance : it->utterances) {
+        if (utterance.text.empty() || utterance.startMs < m_cutMs - m_toleranceMs) {
+            continue;
+        }
+        // 停止发送时正在说的那句被截断，交给后继会话；后继会话覆盖不到开头的句子除外
+        const bool complete = !hasSuccessor || utterance.endMs <= lastPacketMs - m_guardMs;
+        if (!complete && utterance.startMs >= successorStartMs) {
+            continue;
+        }
+        CachedUtterance committed = utterance;
+        committed.definite = true;
+        m_cutMs = std::max(m_cutMs, committed.endMs);
+        m_committed.push_back(std::move(committed));
+    }
+    m_sessions.erase(it);
+}
+
+std::vector<CachedUtterance> TranscriptStitcher::sessionUtterances(const void* session) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Session* s = findLocked(session);
+    return s ? s->utterances : std::vector<CachedUtterance>();
+}
+
+std::vector<CachedUtterance> TranscriptStitcher::merged() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return mergedLocked();
+}
+
+std::vector<CachedUtterance> TranscriptStitcher::merged(int64_t& settledMs) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    settledMs = settledLocked();
+    return mergedLocked();
+}
+
+int64_t TranscriptStitcher::settledLocked() const {
+    if (m_sessions.empty()) {
+        return m_cutMs;
+    }
+    // 最早会话中连续的已定稿分句关闭时会按原样提交，位置不变；按 closeSession 的规则逐句模拟，
+    // 遇到未定稿、空文本或提交时会被跳过的分句即停止
+    const Session& front = m_sessions.front();
+    int64_t settled = front.startMs;
+    int64_t cut = m_cutMs;
+    for (const auto& utterance : front.utterances) {
+        if (utterance.startMs < m_cutMs - m_toleranceMs) {
+            continue;
+        }
+        if (!utterance.definite || utterance.text.empty() || utterance.startMs < cut - m_toleranceMs) {
+            settled = utterance.startMs;
+            break;
+        }
+        cut = std::max(cut, utterance.endMs);
+        settled = std::max(settled, utterance.endMs);
+    }
+    // 重叠期间后继会话的结果尚未输出，其覆盖的音频仍在等待结果
+    for (size_t i = 1; i < m_sessions.size(); ++i) {
+        settled = std::min(settled, m_sessions[i].startMs);
+    }
+    return settled;
+}
+
+std::vector<CachedUtterance> TranscriptStitcher::mergedLocked() const {
+    std::vector<CachedUtterance> result = m_committed;
+    if (!m_sessions.empty()) {
+        for (const auto& utterance : m_sessions.front().utterances) {
+            if (utterance.startMs >= m_cutMs - m_toleranceMs) {
+                result.push_back(utterance);
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace Asr
@@ -0,0 +1,367 @@
+//
+// 识别结果持久化缓存实现
+//
+
+#include "asr/transcription_cache.h"
+#include "audio/content_hash.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using json = nlohmann::json;
+
+namespace Asr {
+
+namespace {
+
+// 条目文件格式版本，结构变化时递增，旧版本条目视为未命中
+constexpr int kEntryVersion = 1;
+constexpr const char* kEntryExtension = ".json";
+
+json utterancesToJson(const std::vector<CachedUtterance>& utterances) {
+    json array = json::array();
+    for (const auto& utterance : utterances) {
+        json words = json::array();
+        for (const auto& word : utterance.words) {
+            words.push_back({
+                {"text", word.text},
+                {"start_time", word.startMs},
+                {"end_time", word.endMs}
+            });
+        }
+        json item = {
+            {"text", utterance.text},
+            {"start_time", utterance.startMs},
+            {"end_time", utterance.endMs},
+            {"definite", utterance.definite},
+            {"words", words}
+        };
+        if (!utterance.speaker.empty()) {
+            item["speaker"] = utterance.speaker;
+        }
+        array.push_back(std::move(item));
+    }
+    return array;
+}
+
+void utterancesFromJson(const json& array, int64_t offsetMs, std::vector<CachedUtterance>& utterances) {
+    for (const auto& item : array) {
+        if (!item.is_object()) {
+            continue;
+        }
+        CachedUtterance utterance;
+        utterance.text = item.value("text", std::string());
+        utterance.startMs = item.value("start_time", int64_t(0)) + offsetMs;
+        utterance.endMs = item.value("end_time", int64_t(0)) + offsetMs;
+        utterance.definite = item.value("definite", false);
+        if (item.contains("speaker") && item["speaker"].is_string()) {
+            utterance.speaker = item["speaker"].get<std::string>();
+        }
+        if (item.contains("words") && item["words"].is_array()) {
+            for (const auto& w : item["words"]) {
+                if (!w.is_object()) {
+                    continue;
+                }
+                CachedWord word;
+                word.text = w.value("text", std::string());
+                word.startMs = w.value("start_time", int64_t(0)) + offsetMs;
+                word.endMs = w.value("end_time", int64_t(0)) + offsetMs;
+                utterance.words.push_back(std::move(word));
+            }
+        }
+        utterances.push_back(std::move(utterance));
+    }
+}
+
+std::string joinUtteranceText(const std::vector<CachedUtterance>& utterances) {
+    std::string joined;
+    for (const auto& utterance : utterances) {
+        if (utterance.text.empty()) {
+            continue;
+        }
+        if (!joined.empty()) {
+            joined += "\n";
+        }
+        joined += utterance.text;
+    }
+    return joined;
+}
+
+std::string payloadChecksum(const json& payload) {
+    const std::string dumped = payload.dump();
+    return perfx::audio::toHex(perfx::audio::Xxh64::hash(dumped.data(), dumped.size()));
+}
+
+} // namespace
+
+// ============================================================================
+// TranscriptionCacheEntry
+// ============================================================================
+
+std::string TranscriptionCacheEntry::text() const {
+    return joinUtteranceText(utterances);
+}
+
+size_t TranscriptionCacheEntry::finalizedCount() const {
+    size_t count = 0;
+    while (count < utterances.size() && utterances[count].definite) {
+        ++count;
+    }
+    return count;
+}
+
+int64_t TranscriptionCacheEntry::finalizedEndMs() const {
+    const size_t count = finalizedCount();
+    return count > 0 ? utterances[count - 1].endMs : 0;
+}
+
+// ============================================================================
+// TranscriptionCache
+// ============================================================================
+
+TranscriptionCache::TranscriptionCache(const std::string& cacheDir, uint64_t maxBytes)
+    : m_cacheDir(cacheDir), m_maxBytes(maxBytes) {}
+
+std::string TranscriptionCache::makeKey(const std::vector<uint8_t>& pcm, const AsrApiConfig& config) {
+    // 直接对实际发出的请求取哈希，请求里新增的字段自动参与，不会漏掉；
+    // 去掉与结果无关的 uid / reqid，再加上服务地址（PERFX_ASR_URL 可改指其他服务）
+    json request = AsrClient::constructRequest(config);
+    request.erase("user");
+    request["request"].erase("reqid");
+    request["cluster"] = config.cluster;
+    const std::string paramString = request.dump();
+
+    const uint64_t audioHash = perfx::audio::Xxh64::hash(pcm.data(), pcm.size());
+    const uint64_t paramHash = perfx::audio::Xxh64::hash(paramString.data(), paramString.size());
+    return perfx::audio::toHex(audioHash) + "-" + perfx::audio::toHex(paramHash);
+}
+
+std::string TranscriptionCache::entryPath(const std::string& key) const {
+    return (std::filesystem::path(m_cacheDir) / (key + kEntryExtension)).string();
+}
+
+bool TranscriptionCache::load(const std::string& key, TranscriptionCacheEntry& entry) {
+    namespace fs = std::filesystem;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const std::string path = entryPath(key);
+    std::error_code ec;
+    if (!fs::exists(path, ec)) {
+        return false;
+    }
+    if (!readEntryFile(path, key, entry, &m_lastError)) {
+        fs::remove(path, ec);
+        return false;
+    }
+
+    // 刷新访问时间，作为 LRU 依据
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    return true;
+}
+
+bool TranscriptionCache::store(const TranscriptionCacheEntry& entry) {
+    if (entry.key.empty()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::error_code ec;
+    std::filesystem::create_directories(m_cacheDir, ec);
+    if (ec) {
+        m_lastError = "Failed to create cache directory: " + ec.message();
+        return false;
+    }
+    if (!writeEntryFile(entryPath(entry.key), entry, &m_lastError)) {
+        return false;
+    }
+
+    evictLocked(entry.key);
+    return true;
+}
+
+bool TranscriptionCache::writeEntryFile(const std::string& path, const TranscriptionCacheEntry& entry,
+                                        std::string* error) {
+    namespace fs = std::filesystem;
+    json payload = {
+        {"key", entry.key},
+        {"source_path", entry.sourcePath},
+        {"total_packets", entry.totalPackets},
+        {"acked_packets", entry.ackedPackets},
+        {"complete", entry.complete},
+        {"utterances", utterancesToJson(entry.utterances)}
+    };
+    json doc = {
+        {"version", kEntryVersion},
+        {"checksum", payloadChecksum(payload)},
+        {"payload", payload}
+    };
+
+    // 先写临时文件再重命名，中途崩溃不会留下写了一半的条目
+    std::error_code ec;
+    const std::string tempPath = path + ".tmp" +
+        std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        if (!file.is_open()) {
+            if (error) *error = "Failed to open cache entry for writing: " + tempPath;
+            return false;
+        }
+        file << doc.dump();
+        if (!file.good()) {
+            if (error) *error = "Failed to write cache entry: " + tempPath;
+            file.close();
+            fs::remove(tempPath, ec);
+            return false;
+        }
+    }
+    fs::rename(tempPath, path, ec);
+    if (ec) {
+        if (error) *error = "Failed to store cache entry: " + ec.message();
+        fs::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool TranscriptionCache::readEntryFile(const std::string& path, const std::string& key,
+                                       TranscriptionCacheEntry& entry, std::string* error) {
+    try {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            if (error) *error = "Failed to open cache entry: " + path;
+            return false;
+        }
+        json doc = json::parse(file);
+        const json& payload = doc.at("payload");
+        if (doc.value("version", 0) != kEntryVersion ||
+            doc.value("checksum", std::string()) != payloadChecksum(payload) ||
+            payload.value("key", std::string()) != key) {
+            if (error) *error = "Cache entry failed integrity check: " + path;
+            return false;
+        }
+
+        entry = TranscriptionCacheEntry();
+        entry.key = key;
+        entry.sourcePath = payload.value("source_path", std::string());
+        entry.totalPackets = payload.value("total_packets", size_t(0));
+        entry.ackedPackets = payload.value("acked_packets", size_t(0));
+        entry.complete = payload.value("complete", false);
+        utterancesFromJson(payload.value("utterances", json::array()), 0, entry.utterances);
+        return true;
+    } catch (const std::exception& e) {
+        if (error) *error = std::string("Failed to read cache entry: ") + e.what();
+        return false;
+    }
+}
+
+void TranscriptionCache::evictLocked(const std::string& keepKey) {
+    namespace fs = std::filesystem;
+    struct Item {
+        fs::path path;
+        uint64_t size;
+        fs::file_time_type lastUse;
+    };
+
+    std::error_code ec;
+    std::vector<Item> items;
+    uint64_t total = 0;
+    for (fs::directory_iterator it(m_cacheDir, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file(ec) || it->path().extension() != kEntryExtension) {
+            continue;
+        }
+        Item item{it->path(), static_cast<uint64_t>(it->file_size(ec)), it->last_write_time(ec)};
+        total += item.size;
+        items.push_back(std::move(item));
+    }
+    if (total <= m_maxBytes) {
+        return;
+    }
+
+    std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
+        return a.lastUse < b.lastUse;
+    });
+    const std::string keepName = keepKey + kEntryExtension;
+    for (const auto& item : items) {
+        if (total <= m_maxBytes) {
+            break;
+        }
+        if (item.path.filename() == keepName) {
+            continue;
+        }
+        if (fs::remove(item.path, ec)) {
+            total -= item.size;
+        }
+    }
+}
+
+void TranscriptionCache::remove(const std::string& key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::error_code ec;
+    std::filesystem::remove(entryPath(key), ec);
+}
+
+void TranscriptionCache::clear() {
+    namespace fs = std::filesystem;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::error_code ec;
+    for (fs::directory_iterator it(m_cacheDir, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().extension() == kEntryExtension) {
+            fs::remove(it->path(), ec);
+        }
+    }
+}
+
+uint64_t TranscriptionCache::totalBytes() const {
+    namespace fs = std::filesystem;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::error_code ec;
+    uint64_t total = 0;
+    for (fs::directory_iterator it(m_cacheDir, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().extension() == kEntryExtension) {
+            total += static_cast<uint64_t>(it->file_size(ec));
+        }
+    }
+    return total;
+}
+
+std::string TranscriptionCache::getLastError() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastError;
+}
+
+// ============================================================================
+// 与服务端消息格式互转
+// ============================================================================
+
+bool TranscriptionCache::parseServerMessage(const std::string& message, int64_t offsetMs,
+                                            std::vector<CachedUtterance>& utterances) {
+    try {
+        json j = json::parse(message);
+        if (!j.contains("result") || !j["result"].is_object()) {
+            return false;
+        }
+        const json& result = j["result"];
+        if (!result.contains("utterances") || !result["utterances"].is_array()) {
+            return false;
+        }
+        utterancesFromJson(result["utterances"], offsetMs, utterances);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+std::string TranscriptionCache::toServerMessage(const std::vector<CachedUtterance>& utterances) {
+    const int64_t duration = utterances.empty() ? 0 : utterances.back().endMs;
+    json message = {
+        {"audio_info", {{"duration", duration}}},
+        {"result", {
+            {"text", joinUtteranceText(utterances)},
+            {"utterances", utterancesToJson(utterances)}
+        }}
+    };
+    return message.dump();
+}
+
+} // namespace Asr
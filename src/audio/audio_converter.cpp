@@ -1,4 +1,5 @@
 #include "audio/audio_converter.h"
+#include "audio/trace_events.h"
 #include <vector>
 #include <iostream>
 #include <fstream>
@@ -59,7 +60,9 @@ public:
         // 启动转换线程
         std::cout << "[AUDIO-THREAD] Conversion thread started" << std::endl;
         conversionThread_ = std::thread([this, inputFile, outputFile]() {
+            trace::setThreadName("audio.converter");
             try {
+                PERFX_TRACE_SCOPE("audio.convert");
                 convertFile(inputFile, outputFile);
             } catch (const std::exception& e) {
                 lastError_ = "Conversion thread exception: " + std::string(e.what());
@@ -5,12 +5,19 @@
  */
 
 #include "../../include/audio/audio_device.h"
+#include "../../include/audio/device_registry.h"
+#include "../../include/audio/latency_metrics.h"
+#include "../../include/audio/trace_events.h"
 #include <portaudio.h>
 #include <stdexcept>
 #include <sstream>
 #include <mutex>
 #include <iostream>
 #include <functional>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
 
 namespace perfx {
 namespace audio {
@@ -40,28 +47,28 @@ public:
 
     /**
      * @brief 构造函数
-     * @details 初始化PortAudio库，如果初始化失败则抛出异常
+     * @details PortAudio 引用在打开流时向 DeviceRegistry 借用、关闭时归还，
+     *          设备空闲期间注册表可以重新初始化 PortAudio 刷新设备表
      */
     Impl() : errorCallback_(nullptr), stream_(nullptr, closeStream), callback_(nullptr) {
-        PaError err = Pa_Initialize();
-        if (err != paNoError) {
-            lastError_ = "Failed to initialize PortAudio: " + std::string(Pa_GetErrorText(err));
-            throw std::runtime_error(lastError_);
-        }
+        captureMetrics();   // 在回调外完成指标注册
     }
 
     /**
      * @brief 析构函数
-     * @details 关闭设备并终止PortAudio
+     * @details 关闭设备并归还PortAudio引用
      */
     ~Impl() {
         std::cout << "[AUDIO-THREAD] ~AudioDevice::Impl called" << std::endl;
         try {
+            stopWatchdog();
             stopStream();
             if (stream_) {
+                std::lock_guard<std::mutex> paLock(portAudioMutex());
                 Pa_CloseStream(stream_.get());
                 stream_.reset();
             }
+            streamLease_.reset();
         } catch (const std::exception& e) {
             std::cerr << "[AUDIO-THREAD][ERROR] Exception in AudioDevice::Impl destructor: " << e.what() << std::endl;
         }
@@ -86,7 +93,18 @@ public:
      * @return 设备信息列表
      */
     std::vector<DeviceInfo> getAvailableDevices() {
+        // 优先使用注册表缓存，避免每次都在调用线程上遍历 PortAudio
+        DeviceRegistry& registry = DeviceRegistry::getInstance();
+        if (registry.isReady()) {
+            return registry.getDevices();
+        }
+
         std::vector<DeviceInfo> devices;
+        PortAudioLease lease;
+        if (!lease.acquire(&lastError_)) {
+            return registry.getDevices();
+        }
+        std::lock_guard<std::mutex> paLock(portAudioMutex());
         int numDevices = Pa_GetDeviceCount();
         
         for (int i = 0; i < numDevices; i++) {
@@ -111,6 +129,11 @@ public:
 
             devices.push_back(info);
         }
+
+        // 注册表未就绪时其列表中只有虚拟设备
+        for (const auto& device : registry.getDevices()) {
+            devices.push_back(device);
+        }
         return devices;
     }
 
@@ -125,13 +148,26 @@ public:
      * @return 是否成功打开设备
      */
     bool openInputDevice(const DeviceInfo& device, const AudioConfig& config) {
+        std::lock_guard<std::recursive_mutex> lifecycleLock(lifecycleMutex_);
         std::lock_guard<std::mutex> lock(mutex_);
         try {
-            if (stream_) {
+            if (stream_ || virtualStream_) {
                 std::cout << "[AUDIO-THREAD] Device already open, closing current device first..." << std::endl;
                 closeDevice();
             }
 
+            VirtualDeviceConfig virtualConfig;
+            if (DeviceRegistry::getInstance().getVirtualDevice(device.index, virtualConfig)) {
+                return openVirtualInputDevice(device, virtualConfig, config);
+            }
+
+            // 打开成功后转为 streamLease_，失败时随局部变量归还（在 paLock 释放之后）
+            PortAudioLease lease;
+            if (!lease.acquire(&lastError_)) {
+                return false;
+            }
+            std::lock_guard<std::mutex> paLock(portAudioMutex());
+
             // 验证设备
             const PaDeviceInfo* deviceInfo = Pa_GetDeviceInfo(device.index);
             if (!deviceInfo) {
@@ -153,7 +189,9 @@ public:
             inputParameters.suggestedLatency = deviceInfo->defaultLowInputLatency;
             inputParameters.hostApiSpecificStreamInfo = nullptr;
 
-            // 检查设备是否支持请求的格式
+            // 检查设备是否支持请求的格式；改用备选格式时 effectiveConfig 随之更新，
+            // 打开成功后作为 currentConfig_，回调与下游按它解释采样数据
+            AudioConfig effectiveConfig = config;
             PaError formatCheck = Pa_IsFormatSupported(&inputParameters, nullptr, static_cast<double>(config.sampleRate));
             if (formatCheck != paNoError) {
                 std::cout << "[WARNING] Device may not support requested format: " << Pa_GetErrorText(formatCheck) << std::endl;
@@ -168,10 +206,7 @@ public:
                         std::cout << "[INFO] Device supports FLOAT32, will use that instead" << std::endl;
                         std::cout << "[WARNING] Audio callback will receive FLOAT32 data despite INT16 configuration!" << std::endl;
                         // 更新配置以反映实际使用的格式
-                        // 注意：这里创建一个修改后的配置副本
-                        AudioConfig modifiedConfig = config;
-                        modifiedConfig.format = SampleFormat::FLOAT32;
-                        currentConfig_ = modifiedConfig;
+                        effectiveConfig.format = SampleFormat::FLOAT32;
                         std::cout << "[INFO] Configuration updated to reflect actual device format: FLOAT32" << std::endl;
                     } else {
                         std::cout << "[ERROR] Device doesn't support FLOAT32 either: " << Pa_GetErrorText(formatCheck) << std::endl;
@@ -179,7 +214,6 @@ public:
                 }
             } else {
                 std::cout << "[INFO] Device supports requested format: " << inputParameters.sampleFormat << std::endl;
-                currentConfig_ = config;
             }
 
             // 打开音频流
@@ -207,8 +241,11 @@ public:
             }
 
             stream_.reset(rawStream);
-            currentConfig_ = config;
+            streamLease_ = std::move(lease);
+            currentConfig_ = effectiveConfig;
             currentDevice_ = device;
+            requestedConfig_ = config;
+            isInput_ = true;
             isOpen_ = true;  // 标记设备为已打开状态
             return true;
         } catch (const std::exception& e) {
@@ -217,6 +254,30 @@ public:
         }
     }
 
+    /**
+     * @brief 打开虚拟输入设备（不经过 PortAudio，调用方持有 mutex_）
+     */
+    bool openVirtualInputDevice(const DeviceInfo& device, const VirtualDeviceConfig& virtualConfig,
+                                const AudioConfig& config) {
+        auto stream = std::make_unique<VirtualInputStream>(virtualConfig, config);
+        std::string error;
+        if (!stream->open(error)) {
+            lastError_ = "Failed to open virtual device: " + error;
+            return false;
+        }
+
+        std::cout << "[AUDIO-THREAD] Opened virtual input device: " << device.name << " ("
+                  << virtualConfig.source << ", " << static_cast<int>(config.sampleRate) << " Hz, "
+                  << config.framesPerBuffer << " frames/buffer)" << std::endl;
+        virtualStream_ = std::move(stream);
+        currentConfig_ = config;
+        currentDevice_ = device;
+        requestedConfig_ = config;
+        isInput_ = true;
+        isOpen_ = true;
+        return true;
+    }
+
     /**
      * @brief 打开输出设备
      * @param device 要打开的输出设备信息
@@ -225,10 +286,17 @@ public:
      * @throw std::runtime_error 如果打开设备失败
      */
     bool openOutputDevice(const DeviceInfo& device, const AudioConfig& config) {
-        if (stream_) {
+        std::lock_guard<std::recursive_mutex> lifecycleLock(lifecycleMutex_);
+        if (stream_ || virtualStream_) {
             closeDevice();
         }
 
+        PortAudioLease lease;
+        if (!lease.acquire(&lastError_)) {
+            throw std::runtime_error(lastError_);
+        }
+        std::lock_guard<std::mutex> paLock(portAudioMutex());
+
         // 配置输出参数
         PaStreamParameters outputParameters;
         outputParameters.device = device.index;
@@ -253,7 +321,9 @@ public:
         }
 
         stream_.reset(rawStream);
+        streamLease_ = std::move(lease);
         currentConfig_ = config;
+        isInput_ = false;
         isOpen_ = true;  // 标记设备为已打开状态
         return true;
     }
@@ -263,7 +333,8 @@ public:
      * @return 是否成功启动
      */
     bool startStream() {
-        if (!isOpen_ || !stream_) {
+        std::lock_guard<std::recursive_mutex> lifecycleLock(lifecycleMutex_);
+        if (!isOpen_ || (!stream_ && !virtualStream_)) {
             std::cerr << "[AUDIO-THREAD][ERROR] Cannot start stream: device not open" << std::endl;
             return false;
         }
@@ -273,6 +344,17 @@ public:
             return true;
         }
         
+        // 虚拟设备不会丢失，不启动看门狗；播完（不循环）后停止回调即可
+        if (virtualStream_) {
+            lastCallbackTime_ = std::chrono::steady_clock::now().time_since_epoch().count();
+            isStreaming_ = true;
+            virtualStream_->start([this](const void* input, size_t frameCount, bool xrun, int64_t captureNs) {
+                virtualCallback(input, frameCount, xrun, captureNs);
+            });
+            std::cout << "[AUDIO-THREAD] Virtual audio stream started" << std::endl;
+            return true;
+        }
+        
         std::cout << "[AUDIO-THREAD] Starting audio stream..." << std::endl;
         
         PaError err = Pa_StartStream(stream_.get());
@@ -281,7 +363,13 @@ public:
             return false;
         }
         
+        lastCallbackTime_ = std::chrono::steady_clock::now().time_since_epoch().count();
+        deviceLost_ = false;
         isStreaming_ = true;
+        DeviceRegistry::getInstance().retainStream();
+        if (isInput_) {
+            startWatchdog();
+        }
         std::cout << "[AUDIO-THREAD] Audio stream started successfully" << std::endl;
         return true;
     }
@@ -292,9 +380,19 @@ public:
      * @throw std::runtime_error 如果停止失败
      */
     bool stopStream() {
-        if (!isStreaming_ || !stream_) {
+        std::lock_guard<std::recursive_mutex> lifecycleLock(lifecycleMutex_);
+        if (!isStreaming_ || (!stream_ && !virtualStream_)) {
             return false;
         }
+        if (virtualStream_) {
+            isStreaming_ = false;
+            virtualStream_->stop();
+            std::cout << "[AUDIO-THREAD] Virtual audio stream stopped" << std::endl;
+            return true;
+        }
+        // 先清除标志，避免看门狗把主动停止误判为设备丢失
+        isStreaming_ = false;
+        DeviceRegistry::getInstance().releaseStream();
         
         std::cout << "[AUDIO-THREAD] Stopping audio stream..." << std::endl;
         
@@ -305,7 +403,6 @@ public:
             std::cout << "[AUDIO-THREAD] Audio stream stopped successfully" << std::endl;
         }
         
-        isStreaming_ = false;
         return true;
     }
 
@@ -313,6 +410,13 @@ public:
      * @brief 关闭当前设备
      */
     void closeDevice() {
+        std::lock_guard<std::recursive_mutex> lifecycleLock(lifecycleMutex_);
+        if (virtualStream_) {
+            stopStream();
+            virtualStream_.reset();
+            isOpen_ = false;
+            return;
+        }
         if (!isOpen_ || !stream_) {
             return;
         }
@@ -321,14 +425,18 @@ public:
         
         stopStream();
         
-        PaError err = Pa_CloseStream(stream_.get());
-        if (err != paNoError) {
-            std::cerr << "[AUDIO-THREAD][ERROR] Failed to close stream: " << Pa_GetErrorText(err) << std::endl;
-        } else {
-            std::cout << "[AUDIO-THREAD] Audio stream closed successfully" << std::endl;
+        {
+            std::lock_guard<std::mutex> paLock(portAudioMutex());
+            PaError err = Pa_CloseStream(stream_.get());
+            if (err != paNoError) {
+                std::cerr << "[AUDIO-THREAD][ERROR] Failed to close stream: " << Pa_GetErrorText(err) << std::endl;
+            } else {
+                std::cout << "[AUDIO-THREAD] Audio stream closed successfully" << std::endl;
+            }
         }
         
         stream_.reset();
+        streamLease_.reset();
         isOpen_ = false;
     }
 
@@ -350,6 +458,9 @@ public:
      * @return 是否活动
      */
     bool isStreamActive() const {
+        if (virtualStream_) {
+            return virtualStream_->isActive();
+        }
         return stream_ && Pa_IsStreamActive(stream_.get()) == 1;
     }
 
@@ -367,7 +478,7 @@ public:
      */
     bool isDeviceOpen() const {
         std::lock_guard<std::mutex> lock(mutex_);
-        return stream_ != nullptr;
+        return stream_ != nullptr || virtualStream_ != nullptr;
     }
 
     /**
@@ -395,6 +506,11 @@ public:
     using ErrorCallback = std::function<void(const std::string&)>;
     ErrorCallback errorCallback_;
 
+    using DeviceChangedCallback = std::function<void(const DeviceInfo&, const AudioConfig&)>;
+    DeviceChangedCallback deviceChangedCallback_;
+    std::atomic<bool> failoverEnabled_{true};
+    std::atomic<uint64_t> xrunCount_{0};
+
 private:
     //--------------------------------------------------------------------------
     // 私有辅助函数
@@ -406,26 +522,224 @@ private:
      */
     static int streamCallback(const void* input, void* output,
                             unsigned long frameCount,
-                            const PaStreamCallbackTimeInfo* /*timeInfo*/,
+                            const PaStreamCallbackTimeInfo* timeInfo,
                             PaStreamCallbackFlags statusFlags,
                             void* userData) {
         auto* impl = static_cast<Impl*>(userData);
-        // 检查设备断开或异常
-        if ((statusFlags & paInputUnderflow) || (statusFlags & paInputOverflow) ||
-            (statusFlags & paOutputUnderflow) || (statusFlags & paOutputOverflow) ||
-            input == nullptr) {
-            impl->lastError_ = "Audio device disconnected or error occurred during streaming";
-            if (impl->errorCallback_) {
-                impl->errorCallback_(impl->lastError_);
-            }
-            return paAbort; // 终止流
+        const CaptureMetrics& captureStats = captureMetrics();
+        const int64_t beginNs = metrics::nowNs();
+        impl->lastCallbackTime_ = std::chrono::steady_clock::now().time_since_epoch().count();
+
+        // 上溢/下溢只是一次 xrun，按类型计数后继续，不再终止整个流
+        if (statusFlags & (paInputUnderflow | paInputOverflow | paOutputUnderflow | paOutputOverflow)) {
+            impl->xrunCount_.fetch_add(1, std::memory_order_relaxed);
+            if (statusFlags & paInputOverflow) captureStats.inputOverflow.fetch_add(1, std::memory_order_relaxed);
+            if (statusFlags & paInputUnderflow) captureStats.inputUnderflow.fetch_add(1, std::memory_order_relaxed);
+            if (statusFlags & paOutputOverflow) captureStats.outputOverflow.fetch_add(1, std::memory_order_relaxed);
+            if (statusFlags & paOutputUnderflow) captureStats.outputUnderflow.fetch_add(1, std::memory_order_relaxed);
         }
+
+        // 输入流拿不到数据说明设备已断开：结束本流，由看门狗线程切换到备用设备
+        if (impl->isInput_ && input == nullptr) {
+            impl->deviceLost_ = true;
+            impl->watchdogCv_.notify_one();
+            return paComplete;
+        }
+
+        // ADC 采样 → 回调的延迟；部分主机 API 不提供时间信息（为 0）
+        int64_t captureNs = beginNs;
+        if (impl->isInput_ && timeInfo && timeInfo->inputBufferAdcTime > 0.0 &&
+            timeInfo->currentTime >= timeInfo->inputBufferAdcTime) {
+            const double latencySec = timeInfo->currentTime - timeInfo->inputBufferAdcTime;
+            captureStats.inputLatencyUs.record(static_cast<uint64_t>(latencySec * 1e6));
+            captureNs = beginNs - static_cast<int64_t>(latencySec * 1e9);
+        }
+        metrics::setCurrentCaptureTime(captureNs);
+        trace::setThreadName("audio.callback");
+        PERFX_TRACE_SCOPE("audio.callback");
+        trace::flowBegin("audio.captured", static_cast<uint64_t>(captureNs));
+
         if (impl->callback_) {
             impl->callback_(input, output, frameCount);
         }
+        captureStats.callbackUs.record(static_cast<uint64_t>((metrics::nowNs() - beginNs) / 1000));
         return paContinue;
     }
 
+    /**
+     * @brief 虚拟设备回调（在虚拟流线程中调用），统计口径与 streamCallback 一致
+     * @param captureNs 首样本的标称采集时间，回调抖动计入输入延迟
+     */
+    void virtualCallback(const void* input, size_t frameCount, bool xrun, int64_t captureNs) {
+        const CaptureMetrics& captureStats = captureMetrics();
+        const int64_t beginNs = metrics::nowNs();
+        lastCallbackTime_ = std::chrono::steady_clock::now().time_since_epoch().count();
+
+        if (xrun) {
+            xrunCount_.fetch_add(1, std::memory_order_relaxed);
+            captureStats.inputOverflow.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (beginNs > captureNs) {
+            captureStats.inputLatencyUs.record(static_cast<uint64_t>((beginNs - captureNs) / 1000));
+        }
+        metrics::setCurrentCaptureTime(captureNs);
+        trace::setThreadName("audio.callback");
+        PERFX_TRACE_SCOPE("audio.callback");
+        trace::flowBegin("audio.captured", static_cast<uint64_t>(captureNs));
+
+        if (callback_) {
+            callback_(input, nullptr, frameCount);
+        }
+        captureStats.callbackUs.record(static_cast<uint64_t>((metrics::nowNs() - beginNs) / 1000));
+    }
+
+    /**
+     * @brief 回调中使用的指标（注册表查找需要加锁，首次构造后缓存引用）
+     */
+    struct CaptureMetrics {
+        LatencyHistogram& callbackUs;
+        LatencyHistogram& inputLatencyUs;
+        std::atomic<int64_t>& inputOverflow;
+        std::atomic<int64_t>& inputUnderflow;
+        std::atomic<int64_t>& outputOverflow;
+        std::atomic<int64_t>& outputUnderflow;
+    };
+
+    static const CaptureMetrics& captureMetrics() {
+        static const CaptureMetrics instance{
+            MetricsRegistry::instance().histogram(metrics::kCallbackDuration),
+            MetricsRegistry::instance().histogram(metrics::kInputLatency),
+            MetricsRegistry::instance().counter(metrics::kXrunInputOverflow),
+            MetricsRegistry::instance().counter(metrics::kXrunInputUnderflow),
+            MetricsRegistry::instance().counter(metrics::kXrunOutputOverflow),
+            MetricsRegistry::instance().counter(metrics::kXrunOutputUnderflow),
+        };
+        return instance;
+    }
+
+    //--------------------------------------------------------------------------
+    // 设备丢失检测与故障转移
+    //--------------------------------------------------------------------------
+
+    // 流运行中超过该时长没有回调即视为设备丢失
+    static constexpr auto kStallTimeout = std::chrono::milliseconds(1500);
+    static constexpr auto kWatchdogInterval = std::chrono::milliseconds(250);
+
+    void startWatchdog() {
+        std::lock_guard<std::mutex> lock(watchdogMutex_);
+        if (watchdogRunning_) {
+            return;
+        }
+        watchdogRunning_ = true;
+        watchdogThread_ = std::thread(&Impl::watchdogLoop, this);
+    }
+
+    void stopWatchdog() {
+        {
+            std::lock_guard<std::mutex> lock(watchdogMutex_);
+            if (!watchdogRunning_) {
+                return;
+            }
+            watchdogRunning_ = false;
+        }
+        watchdogCv_.notify_all();
+        if (watchdogThread_.joinable()) {
+            watchdogThread_.join();
+        }
+    }
+
+    /**
+     * @brief 看门狗线程：检测回调报告的断开或回调停滞
+     * @details 故障转移需要关闭/重新打开流，不能在音频回调中进行
+     */
+    void watchdogLoop() {
+        std::unique_lock<std::mutex> lock(watchdogMutex_);
+        while (watchdogRunning_) {
+            watchdogCv_.wait_for(lock, kWatchdogInterval);
+            if (!watchdogRunning_) {
+                break;
+            }
+            if (!isStreaming_ || !failoverEnabled_) {
+                continue;
+            }
+
+            auto now = std::chrono::steady_clock::now().time_since_epoch();
+            auto last = std::chrono::steady_clock::duration(lastCallbackTime_.load());
+            bool stalled = (now - last) > kStallTimeout;
+            if (!deviceLost_ && !stalled) {
+                continue;
+            }
+
+            lock.unlock();
+            performFailover(stalled && !deviceLost_ ? "callback stalled" : "input lost");
+            lock.lock();
+        }
+    }
+
+    /**
+     * @brief 关闭丢失的设备并用相同的请求配置打开备用设备
+     *
+     * 备用设备协商出的数据布局与原流不同时不启动流，交给回调方按新配置重建下游后再启动
+     */
+    void performFailover(const char* reason) {
+        std::lock_guard<std::recursive_mutex> lifecycleLock(lifecycleMutex_);
+        if (!isStreaming_) {
+            return;  // 已被主动停止
+        }
+
+        DeviceInfo lost = currentDevice_;
+        AudioConfig config = requestedConfig_;
+        const AudioConfig previous = currentConfig_;
+        std::cout << "[AUDIO-THREAD] Input device lost (" << reason << "): " << lost.name << std::endl;
+
+        closeDevice();
+        deviceLost_ = false;
+
+        DeviceRegistry& registry = DeviceRegistry::getInstance();
+        registry.requestRescan();
+        DeviceInfo fallback = registry.getFallbackInputDevice(lost, static_cast<int>(config.channels));
+        if (fallback.index < 0 && !registry.isReady()) {
+            PortAudioLease lease;
+            const bool paReady = lease.acquire();
+            std::lock_guard<std::mutex> paLock(portAudioMutex());
+            PaDeviceIndex defaultIndex = paReady ? Pa_GetDefaultInputDevice() : paNoDevice;
+            const PaDeviceInfo* info = defaultIndex != paNoDevice ? Pa_GetDeviceInfo(defaultIndex) : nullptr;
+            if (info && lost.name != info->name) {
+                fallback = DeviceInfo{};
+                fallback.index = defaultIndex;
+                fallback.name = info->name;
+                fallback.type = DeviceType::INPUT;
+                fallback.maxInputChannels = info->maxInputChannels;
+                fallback.maxOutputChannels = info->maxOutputChannels;
+                fallback.defaultSampleRate = info->defaultSampleRate;
+                fallback.defaultLatency = info->defaultLowInputLatency;
+            } else {
+                fallback.index = -1;
+            }
+        }
+
+        bool opened = fallback.index >= 0 && openInputDevice(fallback, config);
+        const bool sameLayout = opened && currentConfig_.sameStreamLayout(previous);
+        if (opened && !sameLayout && !deviceChangedCallback_) {
+            closeDevice();  // 没有人能按新格式重建下游
+            opened = false;
+        }
+        if (!opened || (sameLayout && !startStream())) {
+            lastError_ = "Audio device disconnected and no fallback device is available";
+            std::cerr << "[AUDIO-THREAD][ERROR] " << lastError_ << std::endl;
+            if (errorCallback_) {
+                errorCallback_(lastError_);
+            }
+            return;
+        }
+
+        std::cout << "[AUDIO-THREAD] Failed over to fallback device: " << fallback.name
+                  << (sameLayout ? "" : " (stream format changed, waiting for the owner to restart)") << std::endl;
+        if (deviceChangedCallback_) {
+            deviceChangedCallback_(fallback, currentConfig_);
+        }
+    }
+
     /**
      * @brief 将SampleFormat转换为PortAudio的PaSampleFormat
      * @param format 采样格式
@@ -452,12 +766,25 @@ private:
 
     mutable std::mutex mutex_;  // 互斥锁，保护共享资源
     std::unique_ptr<PaStream, void(*)(PaStream*)> stream_;  // 音频流指针
+    PortAudioLease streamLease_;  // stream_ 打开期间借用的 PortAudio 引用
+    std::unique_ptr<VirtualInputStream> virtualStream_;  // 虚拟设备的采集流（与 stream_ 互斥）
     AudioCallback callback_;  // 音频回调函数
     AudioConfig currentConfig_;  // 当前音频配置
     DeviceInfo currentDevice_;  // 当前设备信息
     std::string lastError_;  // 最后一次错误信息
     bool isOpen_ = false;  // 设备是否打开
-    bool isStreaming_ = false;  // 音频流是否正在运行
+    std::atomic<bool> isStreaming_{false};  // 音频流是否正在运行
+    bool isInput_ = false;  // 当前流是否为输入流
+
+    std::recursive_mutex lifecycleMutex_;  // 串行化打开/启动/停止/关闭与故障转移
+    AudioConfig requestedConfig_;  // 调用方请求的配置，故障转移时复用
+    std::atomic<bool> deviceLost_{false};  // 回调检测到设备断开
+    std::atomic<std::chrono::steady_clock::rep> lastCallbackTime_{0};  // 最近一次回调时间
+
+    std::mutex watchdogMutex_;
+    std::condition_variable watchdogCv_;
+    std::thread watchdogThread_;
+    bool watchdogRunning_ = false;
 };
 
 //==============================================================================
@@ -487,6 +814,13 @@ void AudioDevice::setErrorCallback(ErrorCallback cb) {
     impl_->errorCallback_ = std::move(cb);
 }
 
+void AudioDevice::setDeviceChangedCallback(DeviceChangedCallback cb) {
+    impl_->deviceChangedCallback_ = std::move(cb);
+}
+
+void AudioDevice::setFailoverEnabled(bool enabled) { impl_->failoverEnabled_ = enabled; }
+uint64_t AudioDevice::getXrunCount() const { return impl_->xrunCount_.load(); }
+
 //==============================================================================
 // 其他相关类实现
 //==============================================================================
@@ -5,6 +5,10 @@
 
 #include "audio/audio_manager.h"
 #include "audio/audio_types.h"
+#include "audio/device_registry.h"
+#include "audio/sample_pipeline.h"
+#include "asr/transcript_exporter.h"
+#include <cstdio>
 #include <fstream>
 #include <iostream>
 #include <nlohmann/json.hpp>
@@ -20,10 +24,119 @@
 #include <thread>
 #include <chrono>
 #include <functional>
+#include <algorithm>
 
 namespace perfx {
 namespace audio {
 
+// ============================================================================
+// 歌词导出
+// ============================================================================
+
+namespace {
+
+// 停止录音时等待消费者写完已采集数据的上限
+constexpr int kFlushTimeoutMs = 2000;
+
+/**
+ * @brief 歌词片段转换为导出器使用的分句（调用方持有 LyricSyncManager::mutex）
+ */
+std::vector<Asr::CachedUtterance> toUtterances(const std::vector<LyricSegment>& segments) {
+    std::vector<Asr::CachedUtterance> utterances;
+    utterances.reserve(segments.size());
+    for (const auto& segment : segments) {
+        Asr::CachedUtterance utterance;
+        utterance.text = segment.text;
+        utterance.startMs = static_cast<int64_t>(segment.startTime);
+        utterance.endMs = static_cast<int64_t>(segment.endTime);
+        utterance.definite = segment.isFinal;
+        utterances.push_back(std::move(utterance));
+    }
+    return utterances;
+}
+
+Asr::ExportOptions lyricExportOptions() {
+    Asr::ExportOptions options;
+    options.title = "ASR转录结果";
+    return options;
+}
+
+void writeJsonNumber(Asr::ExportWriter& writer, double value) {
+    char text[32];
+    const int length = std::snprintf(text, sizeof(text), "%.3f", value);
+    writer.write(text, static_cast<size_t>(std::max(length, 0)));
+}
+
+/**
+ * @brief 原有歌词 JSON 结构：fullText / totalDuration / segments
+ */
+void writeLyricJson(Asr::ExportWriter& writer, const LyricSyncManager& manager) {
+    writer.write("{\n  \"fullText\": ");
+    writer.writeJsonString(manager.fullText);
+    writer.write(",\n  \"totalDuration\": ");
+    writeJsonNumber(writer, manager.totalDuration);
+    writer.write(",\n  \"segments\": [");
+    for (size_t i = 0; i < manager.segments.size(); ++i) {
+        const auto& segment = manager.segments[i];
+        writer.write(i == 0 ? "\n    {\n      \"text\": " : ",\n    {\n      \"text\": ");
+        writer.writeJsonString(segment.text);
+        writer.write(",\n      \"startTime\": ");
+        writeJsonNumber(writer, segment.startTime);
+        writer.write(",\n      \"endTime\": ");
+        writeJsonNumber(writer, segment.endTime);
+        writer.write(",\n      \"confidence\": ");
+        writeJsonNumber(writer, segment.confidence);
+        writer.write(segment.isFinal ? ",\n      \"isFinal\": true\n    }" : ",\n      \"isFinal\": false\n    }");
+    }
+    writer.write("\n  ]\n}");
+}
+
+} // namespace
+
+std::string LyricSyncManager::exportToLRC() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return Asr::exportTranscriptToString(toUtterances(segments), Asr::ExportFormat::Lrc, lyricExportOptions());
+}
+
+std::string LyricSyncManager::exportToJSON() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string json;
+    Asr::StringSink sink(json);
+    {
+        Asr::ExportWriter writer(sink);
+        writeLyricJson(writer, *this);
+    }
+    return json;
+}
+
+bool LyricSyncManager::exportToFile(const std::string& filePath, const std::string& format, std::string& error) const {
+    Asr::ExportFormat exportFormat;
+    if (!Asr::exportFormatFromName(format, exportFormat)) {
+        error = "Unsupported lyric format: " + format;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (exportFormat != Asr::ExportFormat::Json) {
+        return Asr::exportTranscript(toUtterances(segments), exportFormat, filePath, lyricExportOptions(), error);
+    }
+
+    Asr::FileSink sink;
+    if (!sink.open(filePath, error)) {
+        return false;
+    }
+    {
+        Asr::ExportWriter writer(sink);
+        writeLyricJson(writer, *this);
+        if (!writer.flush()) {
+            error = "Failed to write: " + filePath;
+            sink.discard();
+            return false;
+        }
+    }
+    return sink.commit(error);
+}
+
 /**
  * @brief AudioManager的PIMPL实现类
  * 封装了AudioManager的具体实现细节
@@ -31,6 +144,7 @@ namespace audio {
 class AudioManager::Impl {
 public:
     AudioConfig config_;
+    SampleConverter inputConverter_;    // 按实际输入流格式选定的转换函数
     /**
      * @brief 构造函数
      * 初始化成员变量
@@ -89,79 +203,55 @@ public:
                 cleanup();
             }
 
-            // 1. 初始化 PortAudio 库
-            PaError err = Pa_Initialize();
-            if (err != paNoError) {
-                std::cerr << "PortAudio initialization failed: " << Pa_GetErrorText(err) << std::endl;
-                return false;
-            }
-
-            // 2. 创建并初始化音频设备
+            // 1. 创建并初始化音频设备（PortAudio 引用由 AudioDevice 在流打开期间向注册表借用）
             device_ = std::make_unique<AudioDevice>();
             if (!device_->initialize()) {
                 std::cerr << "[AUDIO-THREAD][ERROR] Failed to initialize audio device" << std::endl;
                 throw std::runtime_error("Failed to initialize audio device");
             }
 
-            // 3. 根据配置决定是否打开输入设备
+            // 2. 根据配置决定是否打开输入设备
             if (config.inputDevice.index >= 0) {
                 std::cout << "[AUDIO-THREAD] Opening input device with index: " << config.inputDevice.index << std::endl;
                 if (!device_->openInputDevice(config.inputDevice, config)) {
                     std::cerr << "Failed to open input device: " << device_->getLastError() << std::endl;
                     device_.reset();  // 清理设备资源
-                    Pa_Terminate();   // 清理 PortAudio
                     return false;
                 }
 
+                // 设备不支持请求的格式时会改用 FLOAT32，之后的处理一律按实际流格式进行
+                const SampleFormat streamFormat = device_->getCurrentConfig().format;
+                if (streamFormat != config_.format) {
+                    std::cout << "[AUDIO-THREAD] Stream format " << sampleFormatName(config_.format)
+                              << " not supported, using " << sampleFormatName(streamFormat) << std::endl;
+                    config_.format = streamFormat;
+                }
+
                 // 设置设备回调函数
                 device_->setCallback([this](const void* input, void* output, size_t frameCount) {
                     this->audioCallback(input, output, frameCount);
                 });
+
+                // 这里打开只为确定实际流格式；流在 startAudioStream 时重新打开，
+                // 未采集期间不占用 PortAudio，注册表可以随时刷新设备表
+                device_->closeDevice();
             } else {
                 std::cout << "[AUDIO-THREAD] No input device specified, operating in file/buffer mode" << std::endl;
             }
 
-            // 4. 初始化音频处理器
-            processor_ = std::make_unique<AudioProcessor>();
-            if (!processor_->initialize(config)) {
-                std::cerr << "Failed to initialize audio processor" << std::endl;
+            // 3. 按实际流格式初始化转换函数与音频处理器（含编码参数）
+            if (!createProcessor()) {
                 device_.reset();      // 清理设备资源
                 processor_.reset();   // 清理处理器资源
-                Pa_Terminate();       // 清理 PortAudio
                 return false;
             }
 
-            // 5. 配置编码格式和参数
-            processor_->setEncodingFormat(config.encodingFormat);
-            if (config.encodingFormat == EncodingFormat::OPUS) {
-                // 计算 Opus 帧大小（采样点数）
-                int samplesPerFrame = (config.opusFrameLength * static_cast<int>(config.sampleRate)) / 1000;
-                std::cout << "[AUDIO-THREAD] Opus frame size: " << samplesPerFrame << " samples" << std::endl;
-                std::cout << "- opusFrameLength:" << config.opusFrameLength << std::endl;
-                std::cout << "- sampleRate:" << static_cast<int>(config.sampleRate) << std::endl;
-                
-                // 检查缓冲区大小是否是帧大小的整数倍
-                if (samplesPerFrame % config.framesPerBuffer != 0) {
-                    std::cerr << "Warning: Opus frame size (" << samplesPerFrame 
-                             << ") is not a multiple of buffer size (" << config.framesPerBuffer << ")" << std::endl;
-                } else {
-                    std::cout << "[AUDIO-THREAD] Buffer size (" << config.framesPerBuffer 
-                             << ") is compatible with Opus frame size (" << samplesPerFrame << ")" << std::endl;
-                }
-                
-                processor_->setOpusFrameLength(config.opusFrameLength);
-            }
-
-            // 6. 初始化音频线程（仅在设备模式下需要）
-            if (config.inputDevice.index >= 0) {
-                audioThread_ = std::make_unique<AudioThread>();
-                if (!audioThread_->initialize(processor_.get())) {
-                    std::cerr << "[AUDIO-THREAD][ERROR] Failed to initialize audio thread" << std::endl;
-                    throw std::runtime_error("Failed to initialize audio thread");
-                }
+            // 4. 初始化音频线程（仅在设备模式下需要）
+            if (config.inputDevice.index >= 0 && !createConsumer()) {
+                throw std::runtime_error("Failed to initialize audio thread");
             }
 
-            // 7. 标记初始化完成
+            // 5. 标记初始化完成
             initialized_ = true;
             std::cout << "[AUDIO-THREAD] AudioManager initialization completed successfully" << std::endl;
 
@@ -169,10 +259,19 @@ public:
                 device_->setErrorCallback([this](const std::string& errorMsg) {
                     if (onError_) onError_(errorMsg);
                 });
+                // 输入设备丢失后已自动切换到备用设备：回调在看门狗线程中，投递到 AudioManager 所在线程再更新配置
+                device_->setDeviceChangedCallback([this](const DeviceInfo& device, const AudioConfig& streamConfig) {
+                    if (post_) {
+                        post_([this, device, streamConfig]() { applyDeviceChange(device, streamConfig); });
+                    }
+                });
             }
             return true;
         } catch (const std::exception& e) {
             std::cerr << "[AUDIO-THREAD][ERROR] Exception in AudioManager::initialize: " << e.what() << std::endl;
+            if (!initialized_) {
+                device_.reset();  // 关闭已打开的流，归还 PortAudio
+            }
             return false;
         }
     }
@@ -198,9 +297,7 @@ public:
         if (!outputFile.empty()) {
             if (!initializeWavFile(outputFile)) {
                 // 如果初始化WAV文件失败，停止音频流
-                if (audioThread_) {
-                    audioThread_->stop();
-                }
+                stopAudioStream();
                 return false;
             }
             recordingInfo_.state = RecordingState::RECORDING;
@@ -284,20 +381,20 @@ public:
             return true; // 已经是空闲状态
         }
         
+        // 设备流仍在运行，消费者保持运行（回调不会退回实时线程）；等待缓冲中已采集的数据写完再完成WAV文件
+        if (audioThread_ && !audioThread_->flush(kFlushTimeoutMs)) {
+            std::cerr << "[AUDIO-THREAD][WARN] Consumer flush timed out, WAV may miss the last buffers" << std::endl;
+        }
+
         // 标记为正在停止
         recordingInfo_.state = RecordingState::STOPPING;
-        
+
         // 如果有输出文件，完成WAV文件
         if (!recordingInfo_.outputFile.empty()) {
             finalizeWavFile();
             std::cout << "[AUDIO-THREAD] Recording completed: " << recordingInfo_.outputFile << std::endl;
         }
         
-        // 停止音频流
-        if (audioThread_) {
-            audioThread_->stop();
-        }
-        
         // 重置录音信息
         recordingInfo_.state = RecordingState::IDLE;
         recordingInfo_.outputFile.clear();
@@ -349,24 +446,28 @@ public:
 
     // 将一些方法移到public部分
     std::vector<DeviceInfo> getAvailableDevices() {
+        // 注册表已完成后台枚举时直接返回缓存，不在调用线程上访问 PortAudio
+        DeviceRegistry& registry = DeviceRegistry::getInstance();
+        if (registry.isReady()) {
+            return registry.getInputDevices();
+        }
+
         std::vector<DeviceInfo> devices;
         
-        // 如果已经初始化，直接使用
-        if (!initialized_) {
-            PaError err = Pa_Initialize();
-            if (err != paNoError) {
-                std::cerr << "PortAudio initialization failed: " << Pa_GetErrorText(err) << std::endl;
-                return devices;
-            }
+        // 已初始化时借用计数加一，否则临时初始化，返回时归还
+        PortAudioLease lease;
+        std::string paError;
+        if (!lease.acquire(&paError)) {
+            std::cerr << "PortAudio initialization failed: " << paError << std::endl;
+            return devices;
         }
+        // 注册表后台线程可能同时在枚举 / 重新初始化（先于 lease 释放）
+        std::unique_lock<std::mutex> paLock(portAudioMutex());
 
         // 获取设备数量
         int numDevices = Pa_GetDeviceCount();
         if (numDevices < 0) {
             std::cerr << "Error getting device count: " << Pa_GetErrorText(numDevices) << std::endl;
-            if (!initialized_) {
-                Pa_Terminate();
-            }
             return devices;
         }
 
@@ -389,9 +490,11 @@ public:
             }
         }
 
-        // 如果之前没有初始化，现在清理
-        if (!initialized_) {
-            Pa_Terminate();
+        paLock.unlock();
+
+        // 注册表未就绪时其列表中只有虚拟设备
+        for (const auto& device : registry.getInputDevices()) {
+            devices.push_back(device);
         }
         return devices;
     }
@@ -480,16 +583,7 @@ public:
         externalAudioCallback_ = nullptr;
         std::cout << "[AUDIO-THREAD] External audio callback cleared" << std::endl;
         
-        // 7. 终止 PortAudio
-        std::cout << "[AUDIO-THREAD] Terminating PortAudio..." << std::endl;
-        PaError err = Pa_Terminate();
-        if (err != paNoError) {
-            std::cerr << "PortAudio termination failed: " << Pa_GetErrorText(err) << std::endl;
-        } else {
-            std::cout << "[AUDIO-THREAD] PortAudio terminated successfully" << std::endl;
-        }
-        
-        // 8. 重置状态
+        // 7. 重置状态
         initialized_ = false;
         std::cout << "[AUDIO-THREAD] AudioManager::cleanup: cleanup completed" << std::endl;
     }
@@ -539,9 +633,7 @@ public:
         if (!initializeWavFile(outputFile)) {
             // 如果文件初始化失败，并且我们刚启动了流，那么需要停止它
             if (recordingInfo_.state == RecordingState::IDLE) {
-                if (audioThread_) {
-                    audioThread_->stop();
-                }
+                stopAudioStream();
             }
             return false;
         }
@@ -566,20 +658,20 @@ public:
             return true; // 已经是空闲状态
         }
         
+        // 设备流仍在运行，消费者保持运行（回调不会退回实时线程）；等待缓冲中已采集的数据写完再完成WAV文件
+        if (audioThread_ && !audioThread_->flush(kFlushTimeoutMs)) {
+            std::cerr << "[AUDIO-THREAD][WARN] Consumer flush timed out, WAV may miss the last buffers" << std::endl;
+        }
+
         // 标记为正在停止
         recordingInfo_.state = RecordingState::STOPPING;
-        
+
         // 如果有输出文件，完成WAV文件
         if (!recordingInfo_.outputFile.empty()) {
             finalizeWavFile();
             std::cout << "[AUDIO-THREAD] Recording completed: " << recordingInfo_.outputFile << std::endl;
         }
         
-        // 停止音频流
-        if (audioThread_) {
-            audioThread_->stop();
-        }
-        
         // 重置录音信息
         recordingInfo_.state = RecordingState::IDLE;
         recordingInfo_.outputFile.clear();
@@ -607,36 +699,43 @@ public:
     }
 
     void addLyricSegment(const LyricSegment& segment) {
-        (void)segment;
+        lyricSyncManager_.addSegment(segment);
     }
 
     std::string getCurrentLyric(double timeMs) {
-        (void)timeMs;
-        return "";
+        return lyricSyncManager_.getCurrentLyric(timeMs);
     }
 
     std::vector<LyricSegment> getAllLyricSegments() const {
-        return {};
+        std::lock_guard<std::mutex> lock(lyricSyncManager_.mutex);
+        return lyricSyncManager_.segments;
     }
 
     std::string getFullTranscriptionText() const {
-        return "";
+        std::lock_guard<std::mutex> lock(lyricSyncManager_.mutex);
+        return lyricSyncManager_.fullText;
     }
 
     std::string exportLyricsToLRC() const {
-        return "";
+        return lyricSyncManager_.exportToLRC();
     }
 
     std::string exportLyricsToJSON() const {
-        return "";
+        return lyricSyncManager_.exportToJSON();
     }
 
     bool saveLyricsToFile(const std::string& filePath, const std::string& format) {
-        (void)filePath; (void)format;
-        return false;
+        std::string error;
+        if (!lyricSyncManager_.exportToFile(filePath, format, error)) {
+            std::cerr << "[AUDIO-THREAD][ERROR] " << error << std::endl;
+            return false;
+        }
+        return true;
     }
 
-    void clearLyrics() {}
+    void clearLyrics() {
+        lyricSyncManager_.clear();
+    }
 
     bool startWritingToFile(const std::string& outputFile) {
         std::lock_guard<std::mutex> lock(mutex_);
@@ -679,6 +778,55 @@ public:
     }
 
     void setOnError(std::function<void(const std::string&)> cb) { onError_ = std::move(cb); }
+    void setOnDeviceChanged(std::function<void(const std::string&)> cb) { onDeviceChanged_ = std::move(cb); }
+    void setPost(std::function<void(std::function<void()>)> post) { post_ = std::move(post); }
+
+    /**
+     * @brief 故障转移后切换到新的输入设备（在 AudioManager 所在线程中调用）
+     * @param streamConfig 新设备实际打开的流配置
+     *
+     * 格式与原流相同时设备已恢复采集，只记录新设备；不同时流已打开但未启动，
+     * 按新格式重建转换函数、处理器与消费者（环形缓冲几何随之变化），通知外部后再启动
+     */
+    void applyDeviceChange(const DeviceInfo& device, const AudioConfig& streamConfig) {
+        bool restart = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            // 投递期间已被清理或重新初始化
+            if (!initialized_ || !device_ || device_->getCurrentDevice().index != device.index) {
+                return;
+            }
+            config_.inputDevice = device;
+            if (!streamConfig.sameStreamLayout(config_)) {
+                std::cout << "[AUDIO-THREAD] Fallback device uses " << sampleFormatName(streamConfig.format) << " @ "
+                          << static_cast<int>(streamConfig.sampleRate) << " Hz, rebuilding capture pipeline" << std::endl;
+                if (audioThread_) {
+                    audioThread_->stop();
+                }
+                config_.sampleRate = streamConfig.sampleRate;
+                config_.channels = streamConfig.channels;
+                config_.format = streamConfig.format;
+                config_.framesPerBuffer = streamConfig.framesPerBuffer;
+                if (!createProcessor() || !createConsumer()) {
+                    lastError_ = "Failed to rebuild capture pipeline for " + device.name;
+                    device_->closeDevice();
+                    if (onError_) onError_(lastError_);
+                    return;
+                }
+                restart = true;  // 故障转移只发生在流运行期间
+            }
+        }
+
+        // 外部（如实时转录控制器）在此按 getInputConverter() 更新转换函数，之后才会收到新格式的数据
+        if (onDeviceChanged_) onDeviceChanged_(device.name);
+
+        if (restart) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!startAudioStream() && onError_) {
+                onError_(lastError_);
+            }
+        }
+    }
 
 private:
     // 私有辅助方法
@@ -760,9 +908,16 @@ private:
             return false;
         }
         
-        // 写入音频数据
-        size_t bytesToWrite = frameCount * static_cast<int>(config_.channels) * 2; // INT16 = 2 bytes
-        wavFile_.write(static_cast<const char*>(data), bytesToWrite);
+        // 写入音频数据（WAV 固定为 16 位 PCM，其他流格式先转换）
+        const size_t samples = frameCount * static_cast<size_t>(inputConverter_.channels);
+        const size_t bytesToWrite = samples * sizeof(int16_t);
+        if (inputConverter_.format == SampleFormat::INT16) {
+            wavFile_.write(static_cast<const char*>(data), bytesToWrite);
+        } else {
+            recordingBuffer_.resize(samples);
+            inputConverter_.toInt16(data, recordingBuffer_.data(), samples);
+            wavFile_.write(reinterpret_cast<const char*>(recordingBuffer_.data()), bytesToWrite);
+        }
         
         // 更新录音信息
         recordingInfo_.recordedBytes += bytesToWrite;
@@ -792,20 +947,13 @@ private:
     }
     
     void updateWaveformData(const void* data, size_t frameCount) {
-        // 更新波形数据（用于UI显示）
-        const int16_t* samples = static_cast<const int16_t*>(data);
-        latestWaveformData_.clear();
-        latestWaveformData_.reserve(frameCount);
-        
-        for (size_t i = 0; i < frameCount; ++i) {
-            float normalizedSample = static_cast<float>(samples[i]) / 32768.0f;
-            latestWaveformData_.append(normalizedSample);
-        }
-        
-        // 限制波形数据大小，避免内存占用过大
-        if (latestWaveformData_.size() > 1000) {
-            latestWaveformData_ = latestWaveformData_.mid(latestWaveformData_.size() - 1000);
-        }
+        // 更新波形数据（用于UI显示，多声道混缩为单声道）
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        // 只保留最近 1000 个样本，避免内存占用过大
+        const size_t keep = std::min<size_t>(frameCount, 1000);
+        latestWaveformData_.resize(static_cast<int>(keep));
+        inputConverter_.toMonoFloat(bytes + (frameCount - keep) * inputConverter_.bytesPerFrame,
+                                    latestWaveformData_.data(), keep);
         
         // 添加调试信息，但限制频率
         static int updateCount = 0;
@@ -824,21 +972,107 @@ private:
         }
     }
     
+    /**
+     * @brief 按 config_（实际流格式）创建转换函数与音频处理器，并配置编码参数
+     */
+    bool createProcessor() {
+        inputConverter_ = SampleConverter::create(config_.format, static_cast<int>(config_.channels));
+        processor_ = std::make_shared<AudioProcessor>();
+        if (!processor_->initialize(config_)) {
+            std::cerr << "Failed to initialize audio processor" << std::endl;
+            return false;
+        }
+
+        processor_->setEncodingFormat(config_.encodingFormat);
+        if (config_.encodingFormat == EncodingFormat::OPUS) {
+            // 计算 Opus 帧大小（采样点数）
+            int samplesPerFrame = (config_.opusFrameLength * static_cast<int>(config_.sampleRate)) / 1000;
+            std::cout << "[AUDIO-THREAD] Opus frame size: " << samplesPerFrame << " samples" << std::endl;
+            std::cout << "- opusFrameLength:" << config_.opusFrameLength << std::endl;
+            std::cout << "- sampleRate:" << static_cast<int>(config_.sampleRate) << std::endl;
+            
+            // 检查缓冲区大小是否是帧大小的整数倍
+            if (samplesPerFrame % config_.framesPerBuffer != 0) {
+                std::cerr << "Warning: Opus frame size (" << samplesPerFrame 
+                         << ") is not a multiple of buffer size (" << config_.framesPerBuffer << ")" << std::endl;
+            } else {
+                std::cout << "[AUDIO-THREAD] Buffer size (" << config_.framesPerBuffer 
+                         << ") is compatible with Opus frame size (" << samplesPerFrame << ")" << std::endl;
+            }
+            
+            processor_->setOpusFrameLength(config_.opusFrameLength);
+        }
+        return true;
+    }
+
+    /**
+     * @brief 按当前处理器的配置创建消费者线程（环形缓冲在启动时按该配置分配）
+     */
+    bool createConsumer() {
+        audioThread_ = std::make_unique<AudioThread>();
+        if (!audioThread_->initialize(processor_.get())) {
+            std::cerr << "[AUDIO-THREAD][ERROR] Failed to initialize audio thread" << std::endl;
+            return false;
+        }
+        // 设备回调只写入环形缓冲；处理链、波形、WAV 写入与外部回调在消费者线程中完成
+        if (processor_->hasProcessingChain()) {
+            audioThread_->addProcessor(processor_);
+        }
+        audioThread_->setInputCallback([this](const void* input, void* output, unsigned long frameCount) {
+            this->consumeAudio(input, output, frameCount);
+        });
+        return true;
+    }
+
     bool startAudioStream() {
-        if (!device_ || !device_->isDeviceOpen()) {
+        if (!device_ || config_.inputDevice.index < 0) {
             lastError_ = "No audio device available";
             return false;
         }
+
+        // 流只在采集期间打开（期间持有 PortAudio 引用），按初始化时确定的实际格式打开
+        if (!device_->isDeviceOpen()) {
+            if (!device_->openInputDevice(config_.inputDevice, config_)) {
+                lastError_ = "Failed to open input device: " + device_->getLastError();
+                return false;
+            }
+            if (device_->getCurrentConfig().format != config_.format) {
+                lastError_ = "Input device no longer supports " + std::string(sampleFormatName(config_.format));
+                device_->closeDevice();
+                return false;
+            }
+        }
         
+        // 先启动消费者，确保第一个回调就能写入环形缓冲
+        if (audioThread_) {
+            audioThread_->startRecording();
+        }
+
         // 启动音频流
         if (!device_->startStream()) {
             lastError_ = "Failed to start audio stream: " + device_->getLastError();
+            device_->closeDevice();
             return false;
         }
         
         return true;
     }
 
+    /**
+     * @brief 停止设备流后再停止消费者（与 startAudioStream 顺序相反），回调不会落到内联路径
+     */
+    void stopAudioStream() {
+        if (device_ && device_->isStreamActive()) {
+            device_->stopStream();
+        }
+        if (audioThread_) {
+            audioThread_->stop();
+        }
+        if (device_) {
+            device_->closeDevice();
+        }
+    }
+
     /**
      * @brief 音频回调函数
      * @param input 输入音频数据
@@ -867,6 +1101,20 @@ private:
             lastLogTime = now;
         }
 
+        // 消费者运行时只做拷贝，其余工作移出实时线程
+        if (audioThread_ && audioThread_->submit(input, static_cast<unsigned long>(frameCount))) {
+            return;
+        }
+
+        // 消费者先于设备流启动、晚于设备流停止，正常不会走到这里；兜底沿用内联路径，不经过处理链
+        consumeAudio(input, output, frameCount);
+    }
+
+    /**
+     * @brief 处理一段（已经过处理链的）输入音频：波形、WAV 写入、外部回调
+     * @note 正常情况下在 AudioThread 的消费者线程中调用
+     */
+    void consumeAudio(const void* input, void* output, size_t frameCount) {
         // 1. 波形数据处理（现有逻辑）
         if (input && frameCount > 0) {
             updateWaveformData(input, frameCount);
@@ -896,7 +1144,7 @@ private:
     std::shared_ptr<AudioProcessor> processor_;
     std::unique_ptr<AudioThread> audioThread_;
     std::string currentOutputFile_;
-    std::vector<int16_t> recordingBuffer_;
+    std::vector<int16_t> recordingBuffer_;               // 非 INT16 流写入 WAV 前的转换缓冲
     std::unique_ptr<AudioDevice> device_;
     AudioConfig currentConfig_;
     std::string lastError_;
@@ -912,6 +1160,8 @@ private:
     // 外部音频回调
     std::function<void(const void*, void*, size_t)> externalAudioCallback_;
     std::function<void(const std::string&)> onError_;
+    std::function<void(const std::string&)> onDeviceChanged_;
+    std::function<void(std::function<void()>)> post_;   // 投递到 AudioManager 所在线程执行
 };
 
 // AudioManager构造函数和析构函数
@@ -919,6 +1169,13 @@ AudioManager::AudioManager() : impl_(std::make_unique<Impl>()) {
     impl_->setOnError([this](const std::string& err) {
         emitError(QString::fromStdString(err));
     });
+    impl_->setOnDeviceChanged([this](const std::string& deviceName) {
+        emit inputDeviceChanged(QString::fromStdString(deviceName));
+    });
+    // AudioManager 析构后已投递未执行的任务随之丢弃
+    impl_->setPost([this](std::function<void()> task) {
+        QMetaObject::invokeMethod(this, std::move(task), Qt::QueuedConnection);
+    });
 }
 
 AudioManager::~AudioManager() = default;
@@ -932,6 +1189,10 @@ const AudioConfig& AudioManager::getConfig() const {
     return impl_->config_;
 }
 
+SampleConverter AudioManager::getInputConverter() const {
+    return impl_->inputConverter_;
+}
+
 bool AudioManager::updateConfig(const AudioConfig& config) {
     impl_->cleanup();
     return impl_->initialize(config);
@@ -5,7 +5,11 @@
 
 #include "audio/audio_processor.h"
 #include "audio/audio_types.h"
+#include "audio/dsp_kernels.h"
+#include "audio/audio_processing_chain.h"
+#include "audio/sample_pipeline.h"
 #include <stdexcept>
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <iostream>
@@ -37,6 +41,13 @@ private:
     int kRequiredFrames;
     std::vector<int16_t> frameBuffer_;
     size_t bufferSize_;
+    std::unique_ptr<AudioProcessingChain> chain_;  ///< 高通 / 降噪 / AGC 处理链（未启用任何处理时为空）
+
+    // 按当前格式实例化的处理函数，配置变化时重新选定，处理时不再按格式分支
+    using ProcessFn = void (*)(Impl& self, void* data, unsigned long frameCount);
+    ProcessFn process_ = &processBlock<SampleFormat::INT16>;
+    SampleConverter converter_;
+    std::vector<float> scratch_;                    ///< INT24 / INT32 / FLOAT64 送入处理链前的浮点缓冲
 
 public:
     Impl() : opusEncoder_(nullptr), opusDecoder_(nullptr), initialized_(false), bufferSize_(0) {
@@ -69,6 +80,90 @@ public:
     }
     void updateConfig(const AudioConfig& config) {
         config_ = config;
+        rebuildChain();
+    }
+
+    /**
+     * @brief 按格式选定处理函数实例
+     */
+    static ProcessFn selectProcess(SampleFormat format) {
+        switch (format) {
+            case SampleFormat::INT16: return &processBlock<SampleFormat::INT16>;
+            case SampleFormat::INT24: return &processBlock<SampleFormat::INT24>;
+            case SampleFormat::INT32: return &processBlock<SampleFormat::INT32>;
+            case SampleFormat::FLOAT32: return &processBlock<SampleFormat::FLOAT32>;
+            case SampleFormat::FLOAT64: return &processBlock<SampleFormat::FLOAT64>;
+        }
+        return &processBlock<SampleFormat::INT16>;
+    }
+
+    /**
+     * @brief 就地处理一批交织样本：清洗浮点样本后送入处理链
+     *
+     * INT16 / FLOAT32 由处理链直接处理；其他格式分段转为浮点后处理再写回
+     */
+    template <SampleFormat F>
+    static void processBlock(Impl& self, void* data, unsigned long frameCount) {
+        const size_t channels = static_cast<size_t>(self.converter_.channels);
+        pipeline::scrub<F>(data, frameCount * channels);
+        if (!self.chain_) {
+            return;
+        }
+        if constexpr (F == SampleFormat::FLOAT32) {
+            self.chain_->process(static_cast<float*>(data), frameCount);
+        } else if constexpr (F == SampleFormat::INT16) {
+            self.chain_->process(static_cast<int16_t*>(data), frameCount);
+        } else {
+            uint8_t* bytes = static_cast<uint8_t*>(data);
+            const size_t scratchFrames = self.scratch_.size() / channels;
+            size_t remaining = frameCount;
+            while (remaining > 0) {
+                const size_t n = std::min(remaining, scratchFrames);
+                pipeline::toFloat<F>(bytes, self.scratch_.data(), n * channels);
+                self.chain_->process(self.scratch_.data(), n);
+                pipeline::fromFloat<F>(self.scratch_.data(), bytes, n * channels);
+                bytes += n * channels * SampleTraits<F>::kBytes;
+                remaining -= n;
+            }
+        }
+    }
+
+    /**
+     * @brief 按配置重建处理链与格式相关的函数，所有缓冲在此预分配
+     */
+    void rebuildChain() {
+        converter_ = SampleConverter::create(config_.format, static_cast<int>(config_.channels));
+        process_ = selectProcess(config_.format);
+        chain_.reset();
+        scratch_.clear();
+        if (!config_.enableHighPass && !config_.enableNoiseSuppression && !config_.enableAGC) {
+            return;
+        }
+        if (config_.format != SampleFormat::INT16 && config_.format != SampleFormat::FLOAT32) {
+            scratch_.assign(static_cast<size_t>(std::max(config_.framesPerBuffer, 1)) * converter_.channels, 0.0f);
+        }
+
+        ProcessingChainConfig chainConfig;
+        chainConfig.sampleRate = static_cast<int>(config_.sampleRate);
+        chainConfig.channels = static_cast<int>(config_.channels);
+        chainConfig.maxFramesPerCall = static_cast<size_t>(std::max(config_.framesPerBuffer, 1));
+        chainConfig.enableHighPass = config_.enableHighPass;
+        chainConfig.enableNoiseSuppression = config_.enableNoiseSuppression;
+        chainConfig.enableDereverb = config_.enableNoiseSuppression && config_.enableDereverb;
+        chainConfig.enableAGC = config_.enableAGC;
+        chain_ = AudioProcessingChain::createDefault(chainConfig);
+
+        std::cout << "[AUDIO-THREAD] Processing chain: " << chain_->stageCount() << " stages, block "
+                  << chain_->getBlockSize() << " frames, latency " << chain_->getLatencyFrames()
+                  << " frames" << std::endl;
+    }
+
+    bool hasProcessingChain() const {
+        return chain_ != nullptr;
+    }
+
+    std::vector<StageStats> getProcessingStats() const {
+        return chain_ ? chain_->getStageStats() : std::vector<StageStats>();
     }
 
     bool initialize(const AudioConfig& config) {
@@ -126,6 +221,7 @@ public:
         std::cout << "  - sampleRate: " << static_cast<int>(config_.sampleRate) << std::endl;
         std::cout << "  - channels: " << static_cast<int>(config_.channels) << std::endl;
         std::cout << "  - format: " << static_cast<int>(config_.format) << " (INT16=0, FLOAT32=3)" << std::endl;
+        rebuildChain();
         initialized_ = true;
         return true;
     }
@@ -133,17 +229,10 @@ public:
     void processAudio(const void* input, void* output, unsigned long frameCount) {
         if (!input || !output || frameCount == 0) return;
 
-        if (config_.format == SampleFormat::FLOAT32) {
-            // 处理 FLOAT32 格式
-            const float* floatInput = static_cast<const float*>(input);
-            float* floatOutput = static_cast<float*>(output);
-            std::memcpy(floatOutput, floatInput, frameCount * sizeof(float) * static_cast<int>(config_.channels));
-        } else {
-            // 处理 INT16 格式
-            const int16_t* intInput = static_cast<const int16_t*>(input);
-            int16_t* intOutput = static_cast<int16_t*>(output);
-            std::memcpy(intOutput, intInput, frameCount * sizeof(int16_t) * static_cast<int>(config_.channels));
+        if (output != input) {
+            std::memcpy(output, input, frameCount * converter_.bytesPerFrame);
         }
+        process_(*this, output, frameCount);
     }
 
     bool encodeOpus(const void* input, size_t frames, std::vector<std::vector<uint8_t>>& encodedFrames) {
@@ -156,33 +245,11 @@ public:
         std::cout << "[DEBUG] Opus encoding: frame size = " << samplesPerFrame_ 
                   << " samples, input frames = " << frames << std::endl;
 
-        // 将新数据添加到缓冲区，同时处理格式转换
+        // 将新数据转为 INT16 追加到缓冲区尾部（浮点 NaN 视为 0，超出 [-1.0, 1.0] 饱和截断）
         size_t newSamples = frames * channels;
-        if (config_.format == SampleFormat::FLOAT32) {
-            // 处理 FLOAT32 格式
-            const float* floatInput = static_cast<const float*>(input);
-            std::vector<int16_t> convertedSamples(newSamples);
-            
-            // 转换 FLOAT32 到 INT16
-            for (size_t i = 0; i < newSamples; ++i) {
-                float sample = floatInput[i];
-                // 处理无效值
-                if (std::isnan(sample) || std::isinf(sample)) {
-                    sample = 0.0f;
-                }
-                // 确保样本在 [-1.0, 1.0] 范围内
-                sample = std::max(-1.0f, std::min(1.0f, sample));
-                // 转换为 INT16
-                convertedSamples[i] = static_cast<int16_t>(std::round(sample * 32767.0f));
-            }
-            
-            // 添加到缓冲区
-            frameBuffer_.insert(frameBuffer_.end(), convertedSamples.begin(), convertedSamples.end());
-        } else {
-            // 直接处理 INT16 格式
-            const int16_t* pcm = static_cast<const int16_t*>(input);
-            frameBuffer_.insert(frameBuffer_.end(), pcm, pcm + newSamples);
-        }
+        size_t oldSize = frameBuffer_.size();
+        frameBuffer_.resize(oldSize + newSamples);
+        converter_.toInt16(input, frameBuffer_.data() + oldSize, newSamples);
         
         bufferSize_ += frames;
 
@@ -361,7 +428,11 @@ AudioProcessor::AudioProcessor() : impl_(std::make_unique<Impl>()) {}
 AudioProcessor::~AudioProcessor() = default;
 
 bool AudioProcessor::initialize(const AudioConfig& config) {
-    return impl_->initialize(config);
+    if (!impl_->initialize(config)) {
+        return false;
+    }
+    config_ = config;
+    return true;
 }
 
 const AudioConfig& AudioProcessor::getConfig() const {
@@ -374,19 +445,15 @@ void AudioProcessor::updateConfig(const AudioConfig& config) {
 }
 
 void AudioProcessor::processAudio(const void* input, void* output, unsigned long frameCount) {
-    if (!input || !output || frameCount == 0) return;
-
-    if (config_.format == SampleFormat::FLOAT32) {
-        // 处理 FLOAT32 格式
-        const float* floatInput = static_cast<const float*>(input);
-        float* floatOutput = static_cast<float*>(output);
-        std::memcpy(floatOutput, floatInput, frameCount * sizeof(float) * static_cast<int>(config_.channels));
-    } else {
-        // 处理 INT16 格式
-        const int16_t* intInput = static_cast<const int16_t*>(input);
-        int16_t* intOutput = static_cast<int16_t*>(output);
-        std::memcpy(intOutput, intInput, frameCount * sizeof(int16_t) * static_cast<int>(config_.channels));
-    }
+    impl_->processAudio(input, output, frameCount);
+}
+
+bool AudioProcessor::hasProcessingChain() const {
+    return impl_->hasProcessingChain();
+}
+
+std::vector<StageStats> AudioProcessor::getProcessingStats() const {
+    return impl_->getProcessingStats();
 }
 
 bool AudioProcessor::encodeOpus(const void* input, size_t frames, std::vector<std::vector<uint8_t>>& encodedFrames) {
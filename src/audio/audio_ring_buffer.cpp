@@ -0,0 +1,258 @@
+/**
+ * @file audio_ring_buffer.cpp
+ * @brief 单生产者 / 单消费者音频块环形缓冲与跨平台唤醒信号
+ */
+
+#include "../../include/audio/audio_ring_buffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace perfx {
+namespace audio {
+
+//------------------------------------------------------------------------------
+// ConsumerSignal
+//------------------------------------------------------------------------------
+
+#if defined(__linux__)
+
+struct ConsumerSignal::Impl {
+    int fd = -1;
+};
+
+ConsumerSignal::ConsumerSignal() : impl_(std::make_unique<Impl>()) {
+    impl_->fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+ConsumerSignal::~ConsumerSignal() {
+    if (impl_->fd >= 0) {
+        close(impl_->fd);
+    }
+}
+
+void ConsumerSignal::signal() {
+    if (impl_->fd < 0) return;
+    uint64_t one = 1;
+    // 计数器溢出（EAGAIN）时消费者必然已有未处理的唤醒，忽略即可
+    ssize_t written = write(impl_->fd, &one, sizeof(one));
+    (void)written;
+}
+
+bool ConsumerSignal::wait(int timeoutMs) {
+    if (impl_->fd < 0) {
+        // eventfd 创建失败时退化为定时轮询
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+        return false;
+    }
+    struct pollfd pfd{impl_->fd, POLLIN, 0};
+    int ret;
+    do {
+        ret = poll(&pfd, 1, timeoutMs);
+    } while (ret < 0 && errno == EINTR);
+    if (ret <= 0) {
+        return false;
+    }
+    uint64_t count = 0;
+    ssize_t readBytes = read(impl_->fd, &count, sizeof(count));
+    return readBytes == sizeof(count);
+}
+
+#elif defined(__APPLE__)
+
+struct ConsumerSignal::Impl {
+    dispatch_semaphore_t semaphore = nullptr;
+};
+
+ConsumerSignal::ConsumerSignal() : impl_(std::make_unique<Impl>()) {
+    impl_->semaphore = dispatch_semaphore_create(0);
+}
+
+ConsumerSignal::~ConsumerSignal() {
+    if (impl_->semaphore) {
+        dispatch_release(impl_->semaphore);
+    }
+}
+
+void ConsumerSignal::signal() {
+    dispatch_semaphore_signal(impl_->semaphore);
+}
+
+bool ConsumerSignal::wait(int timeoutMs) {
+    dispatch_time_t deadline = dispatch_time(DISPATCH_TIME_NOW, static_cast<int64_t>(timeoutMs) * NSEC_PER_MSEC);
+    return dispatch_semaphore_wait(impl_->semaphore, deadline) == 0;
+}
+
+#elif defined(_WIN32)
+
+struct ConsumerSignal::Impl {
+    HANDLE semaphore = nullptr;
+};
+
+ConsumerSignal::ConsumerSignal() : impl_(std::make_unique<Impl>()) {
+    impl_->semaphore = CreateSemaphoreW(nullptr, 0, LONG_MAX, nullptr);
+}
+
+ConsumerSignal::~ConsumerSignal() {
+    if (impl_->semaphore) {
+        CloseHandle(impl_->semaphore);
+    }
+}
+
+void ConsumerSignal::signal() {
+    ReleaseSemaphore(impl_->semaphore, 1, nullptr);
+}
+
+bool ConsumerSignal::wait(int timeoutMs) {
+    return WaitForSingleObject(impl_->semaphore, static_cast<DWORD>(timeoutMs)) == WAIT_OBJECT_0;
+}
+
+#else
+
+struct ConsumerSignal::Impl {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<bool> pending{false};
+};
+
+ConsumerSignal::ConsumerSignal() : impl_(std::make_unique<Impl>()) {}
+
+ConsumerSignal::~ConsumerSignal() = default;
+
+void ConsumerSignal::signal() {
+    // 生产者不加锁，通知可能在消费者进入等待前丢失，由等待超时兜底
+    impl_->pending.store(true, std::memory_order_release);
+    impl_->cv.notify_one();
+}
+
+bool ConsumerSignal::wait(int timeoutMs) {
+    std::unique_lock<std::mutex> lock(impl_->mutex);
+    bool woken = impl_->cv.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] {
+        return impl_->pending.load(std::memory_order_acquire);
+    });
+    impl_->pending.store(false, std::memory_order_relaxed);
+    return woken;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// AudioRingBuffer
+//------------------------------------------------------------------------------
+
+AudioRingBuffer::AudioRingBuffer(size_t slotCount, size_t framesPerSlot, size_t bytesPerFrame)
+    : slotCount_(std::max<size_t>(slotCount, 2)),
+      framesPerSlot_(std::max<size_t>(framesPerSlot, 1)),
+      bytesPerFrame_(std::max<size_t>(bytesPerFrame, 1)),
+      slotBytes_(framesPerSlot_ * bytesPerFrame_),
+      data_(slotCount_ * slotBytes_, 0),
+      frames_(slotCount_, 0),
+      captureNs_(slotCount_, 0) {}
+
+AudioRingBuffer::~AudioRingBuffer() = default;
+
+bool AudioRingBuffer::push(const void* data, size_t frames, int64_t captureNs) {
+    if (!data || frames == 0) return true;
+
+    const size_t needed = (frames + framesPerSlot_ - 1) / framesPerSlot_;
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    const size_t used = static_cast<size_t>(tail - head);
+
+    if (used + needed > slotCount_) {
+        droppedChunks_.fetch_add(1, std::memory_order_relaxed);
+        droppedFrames_.fetch_add(frames, std::memory_order_relaxed);
+        signal_.signal();
+        return false;
+    }
+
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    size_t remaining = frames;
+    for (size_t i = 0; i < needed; ++i) {
+        const size_t slot = static_cast<size_t>((tail + i) % slotCount_);
+        const size_t chunk = std::min(remaining, framesPerSlot_);
+        std::memcpy(data_.data() + slot * slotBytes_, src, chunk * bytesPerFrame_);
+        frames_[slot] = chunk;
+        captureNs_[slot] = captureNs;
+        src += chunk * bytesPerFrame_;
+        remaining -= chunk;
+    }
+    tail_.store(tail + needed, std::memory_order_release);
+
+    pushedChunks_.fetch_add(needed, std::memory_order_relaxed);
+    if (used + needed > highWatermark_.load(std::memory_order_relaxed)) {
+        highWatermark_.store(used + needed, std::memory_order_relaxed);
+    }
+
+    signal_.signal();
+    return true;
+}
+
+size_t AudioRingBuffer::available() const {
+    return static_cast<size_t>(tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_relaxed));
+}
+
+const uint8_t* AudioRingBuffer::front(size_t& frames, int64_t* captureNs) const {
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    if (tail_.load(std::memory_order_acquire) == head) {
+        frames = 0;
+        return nullptr;
+    }
+    const size_t slot = static_cast<size_t>(head % slotCount_);
+    frames = frames_[slot];
+    if (captureNs) {
+        *captureNs = captureNs_[slot];
+    }
+    return data_.data() + slot * slotBytes_;
+}
+
+void AudioRingBuffer::pop() {
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    if (tail_.load(std::memory_order_acquire) == head) return;
+    head_.store(head + 1, std::memory_order_release);
+}
+
+bool AudioRingBuffer::waitForData(int timeoutMs) {
+    if (available() > 0) return true;
+    signal_.wait(timeoutMs);
+    return available() > 0;
+}
+
+void AudioRingBuffer::wake() {
+    signal_.signal();
+}
+
+AudioRingBuffer::Stats AudioRingBuffer::getStats() const {
+    Stats stats;
+    stats.pushedChunks = pushedChunks_.load(std::memory_order_relaxed);
+    stats.droppedChunks = droppedChunks_.load(std::memory_order_relaxed);
+    stats.droppedFrames = droppedFrames_.load(std::memory_order_relaxed);
+    stats.capacity = slotCount_;
+    stats.highWatermark = highWatermark_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace audio
+} // namespace perfx
@@ -6,6 +6,10 @@
 #include "audio/audio_thread.h"
 #include "audio/audio_device.h"
 #include "audio/audio_processor.h"
+#include "audio/audio_ring_buffer.h"
+#include "audio/sample_pipeline.h"
+#include "audio/latency_metrics.h"
+#include "audio/trace_events.h"
 #include <portaudio.h>
 #include <stdexcept>
 #include <algorithm>
@@ -13,11 +17,22 @@
 #include <thread>
 #include <vector>
 #include <mutex>
+#include <atomic>
+#include <cstring>
 #include <iostream>
 
 namespace perfx {
 namespace audio {
 
+namespace {
+
+constexpr size_t kRingSlots = 64;           ///< 环形缓冲槽数（每槽一个回调缓冲）
+constexpr size_t kMaxBatchSlots = 8;        ///< 消费者单批最多合并的槽数
+constexpr int kConsumerWaitMs = 50;         ///< 消费者等待超时（兜底，正常由信号唤醒）
+constexpr size_t kDefaultFramesPerSlot = 1024;
+
+} // namespace
+
 /**
  * @class AudioThread::Impl
  * @brief AudioThread类的PIMPL实现，封装了音频处理的核心功能
@@ -27,7 +42,13 @@ public:
     /**
      * @brief 构造函数，初始化音频处理相关的成员变量
      */
-    Impl() : stream_(nullptr), running_(false), hasInputDevice_(false), hasOutputDevice_(false) {}
+    Impl() : stream_(nullptr), running_(false), hasInputDevice_(false), hasOutputDevice_(false),
+             consumerLagFrames_(MetricsRegistry::instance().histogram(metrics::kConsumerLag)),
+             ringOccupancy_(MetricsRegistry::instance().histogram(metrics::kRingOccupancy)),
+             captureToConsumerUs_(MetricsRegistry::instance().histogram(metrics::kCaptureToConsumer)),
+             ringDropped_(MetricsRegistry::instance().counter(metrics::kRingDropped)) {
+        stageTimers_.push_back(std::make_unique<StageTimer>());   // 最终回调
+    }
 
     /**
      * @brief 析构函数，确保在对象销毁时停止音频流
@@ -92,6 +113,11 @@ public:
             return;
         }
         
+        // 回调只写入环形缓冲，处理与分发由消费者线程完成
+        if (!startConsumer()) {
+            return;
+        }
+
         // 打开音频流
         PaError err = Pa_OpenStream(&stream_,
                                    &inputParams_,  // 输入参数
@@ -125,20 +151,14 @@ public:
      */
     void stop() {
         std::cout << "[DEBUG] AudioThread::stop() called" << std::endl;
-        if (!running_) return;
-
-        std::cout << "[DEBUG] Stopping recording thread..." << std::endl;
-        // 首先停止录音线程
-        if (isRecording_) {
-            isRecording_ = false;
-            if (recordingThread_.joinable()) {
-                recordingThread_.join();
-                std::cout << "[DEBUG] Recording thread stopped" << std::endl;
-            }
+        if (!running_) {
+            // 外部生产者模式下没有自己的流，只需停止消费者
+            stopConsumer();
+            return;
         }
 
         std::cout << "[DEBUG] Stopping PortAudio stream..." << std::endl;
-        // 然后停止音频流
+        // 先停止音频流（生产者），再停止消费者，确保缓冲中剩余数据被处理完
         if (stream_) {
             PaError err = Pa_StopStream(stream_);
             if (err != paNoError) {
@@ -155,6 +175,7 @@ public:
         }
 
         running_ = false;
+        stopConsumer();
         std::cout << "[DEBUG] AudioThread::stop() completed" << std::endl;
     }
 
@@ -186,6 +207,14 @@ public:
                 inputParams_.sampleFormat = paInt16;
                 std::cout << "[DEBUG] Using INT16 format for input" << std::endl;
                 break;
+            case SampleFormat::INT24:
+                inputParams_.sampleFormat = paInt24;
+                std::cout << "[DEBUG] Using INT24 format for input" << std::endl;
+                break;
+            case SampleFormat::INT32:
+                inputParams_.sampleFormat = paInt32;
+                std::cout << "[DEBUG] Using INT32 format for input" << std::endl;
+                break;
             default:
                 std::cerr << "[ERROR] Unsupported sample format: " << static_cast<int>(config_.format) << std::endl;
                 return false;
@@ -236,7 +265,11 @@ public:
      * @param processor 音频处理器实例
      */
     void addProcessor(std::shared_ptr<AudioProcessor> processor) {
+        if (!processor) return;
+        std::lock_guard<std::mutex> lock(stagesMutex_);
         processors_.push_back(processor);
+        // 计时器与处理器一一对应，末尾保留给最终回调
+        stageTimers_.insert(stageTimers_.end() - 1, std::make_unique<StageTimer>());
     }
 
     /**
@@ -244,9 +277,63 @@ public:
      * @param callback 输入回调函数
      */
     void setInputCallback(AudioCallback callback) {
+        std::lock_guard<std::mutex> lock(stagesMutex_);
         inputCallback_ = std::move(callback);
     }
 
+    /**
+     * @brief 写入一段输入音频（可在实时线程中调用：不加锁、不分配内存）
+     * @return 消费者未运行时返回 false；缓冲已满时数据被丢弃并计入统计
+     */
+    bool submit(const void* input, unsigned long frameCount) {
+        // 先登记为正在写入再检查运行标志（均为 seq_cst）：startConsumer 看到计数为 0 后，
+        // 新进入的生产者必然读到 consuming_ == false，不会访问正被替换的缓冲
+        producers_.fetch_add(1);
+        if (!consuming_.load()) {
+            producers_.fetch_sub(1, std::memory_order_release);
+            return false;
+        }
+        if (input && frameCount > 0) {
+            int64_t captureNs = metrics::currentCaptureTime();
+            if (captureNs == 0) {
+                captureNs = metrics::nowNs();
+            }
+            if (!ring_->push(input, frameCount, captureNs)) {
+                ringDropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        producers_.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    PipelineStats getPipelineStats() const {
+        PipelineStats stats;
+        if (ring_) {
+            AudioRingBuffer::Stats ring = ring_->getStats();
+            stats.pushedChunks = ring.pushedChunks;
+            stats.droppedChunks = ring.droppedChunks;
+            stats.droppedFrames = ring.droppedFrames;
+            stats.ringCapacity = ring.capacity;
+            stats.ringHighWatermark = ring.highWatermark;
+        }
+        stats.batches = batches_.load(std::memory_order_relaxed);
+        stats.frames = framesConsumed_.load(std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(stagesMutex_);
+        for (size_t i = 0; i < stageTimers_.size(); ++i) {
+            const StageTimer& timer = *stageTimers_[i];
+            PipelineStageTiming timing;
+            timing.name = i < processors_.size() ? "processor#" + std::to_string(i) : "callback";
+            timing.calls = timer.calls.load(std::memory_order_relaxed);
+            if (timing.calls > 0) {
+                timing.avgUs = timer.totalNs.load(std::memory_order_relaxed) / 1000.0 / timing.calls;
+            }
+            timing.maxUs = timer.maxNs.load(std::memory_order_relaxed) / 1000.0;
+            stats.stages.push_back(std::move(timing));
+        }
+        return stats;
+    }
+
     /**
      * @brief 获取音频流运行状态
      * @return 是否正在运行
@@ -270,33 +357,200 @@ public:
     }
 
     bool startRecording() {
+        return startConsumer();
+    }
+
+    /**
+     * @brief 等待消费者处理完调用前已写入的全部数据，消费者继续运行
+     * @return 消费者未运行时返回 true；超时返回 false
+     */
+    bool flush(int timeoutMs) {
         std::lock_guard<std::mutex> lock(mutex_);
-        if (isRecording_) {
-            return false;
+        if (!consuming_) {
+            return true;
         }
+        std::unique_lock<std::mutex> flushLock(flushMutex_);
+        const uint64_t ticket = ++flushRequested_;
+        ring_->wake();
+        return flushCv_.wait_for(flushLock, std::chrono::milliseconds(timeoutMs),
+                                 [this, ticket]() { return flushServed_ >= ticket; });
+    }
 
-        // 打印调用堆栈，辅助排查重复初始化问题
-        std::cerr << "AudioThread::startRecording called" << std::endl;
+private:
+    /**
+     * @brief 单个阶段的耗时累计（消费者线程写，统计接口读）
+     */
+    struct StageTimer {
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> totalNs{0};
+        std::atomic<uint64_t> maxNs{0};
+
+        void record(uint64_t ns) {
+            calls.fetch_add(1, std::memory_order_relaxed);
+            totalNs.fetch_add(ns, std::memory_order_relaxed);
+            if (ns > maxNs.load(std::memory_order_relaxed)) {
+                maxNs.store(ns, std::memory_order_relaxed);
+            }
+        }
+    };
 
-        // 确保音频处理器已初始化
-        if (!processor_) {
-            std::cerr << "[ERROR] Audio processor not set! AudioThread should receive processor from AudioManager." << std::endl;
-            return false;
+    /**
+     * @brief 按当前配置分配环形缓冲并启动消费者线程
+     */
+    bool startConsumer() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (consuming_) {
+            return true;
         }
 
-        // 开始录音
-        isRecording_ = true;
-        recordingThread_ = std::thread([this]() {
-            while (isRecording_) {
-                // 等待音频数据
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        const size_t framesPerSlot = config_.framesPerBuffer > 0
+            ? static_cast<size_t>(config_.framesPerBuffer) : kDefaultFramesPerSlot;
+        converter_ = SampleConverter::create(config_.format, static_cast<int>(config_.channels));
+        const size_t bytesPerFrame = converter_.bytesPerFrame;
+
+        // 环形缓冲只在几何参数变化时重建；消费者停止时设备流可能仍在运行，
+        // 替换前等待已读到旧运行标志、仍在写旧缓冲的生产者退出（push 只是一次拷贝）
+        if (!ring_ || ring_->framesPerSlot() != framesPerSlot || ring_->bytesPerFrame() != bytesPerFrame) {
+            while (producers_.load() != 0) {
+                std::this_thread::yield();
             }
-        });
+            ring_ = std::make_unique<AudioRingBuffer>(kRingSlots, framesPerSlot, bytesPerFrame);
+        }
+        batchBuffer_.assign(kMaxBatchSlots * framesPerSlot * bytesPerFrame, 0);
+        nonFiniteSamples_ = 0;
 
+        consuming_.store(true, std::memory_order_release);
+        consumerThread_ = std::thread([this]() { consumerLoop(); });
+        std::cout << "[AUDIO-THREAD] Consumer pipeline started (" << kRingSlots << " slots x "
+                  << framesPerSlot << " frames)" << std::endl;
         return true;
     }
 
-private:
+    /**
+     * @brief 停止消费者线程；退出前处理完缓冲中剩余的数据
+     */
+    void stopConsumer() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!consuming_) {
+            return;
+        }
+        consuming_.store(false);
+        ring_->wake();
+        if (consumerThread_.joinable()) {
+            consumerThread_.join();
+        }
+
+        AudioRingBuffer::Stats stats = ring_->getStats();
+        if (stats.droppedChunks > 0) {
+            std::cerr << "[AUDIO-THREAD][WARN] Ring buffer overflow: dropped " << stats.droppedChunks
+                      << " callbacks (" << stats.droppedFrames << " frames)" << std::endl;
+        }
+        std::cout << "[DEBUG] Consumer pipeline stopped" << std::endl;
+    }
+
+    /**
+     * @brief 消费者线程：阻塞等待唤醒，每次唤醒批量处理全部就绪数据
+     */
+    void consumerLoop() {
+        uint64_t served = 0;
+        while (consuming_.load(std::memory_order_acquire)) {
+            const bool ready = ring_->waitForData(kConsumerWaitMs);
+            // 先读请求再取数：本轮取空时，请求之前写入的数据都已处理
+            const uint64_t requested = flushRequested_.load(std::memory_order_acquire);
+            if (ready || requested != served) {
+                drainRing();
+            }
+            if (requested != served) {
+                served = requested;
+                {
+                    std::lock_guard<std::mutex> lock(flushMutex_);
+                    flushServed_ = served;
+                }
+                flushCv_.notify_all();
+            }
+        }
+        drainRing();
+    }
+
+    /**
+     * @brief 取出就绪的槽，合并为不超过 kMaxBatchSlots 槽的批次后依次处理
+     */
+    void drainRing() {
+        const size_t bytesPerFrame = ring_->bytesPerFrame();
+        const size_t capacityFrames = batchBuffer_.size() / bytesPerFrame;
+
+        while (ring_->available() > 0) {
+            const size_t pending = ring_->available();
+            ringOccupancy_.record(pending);
+            consumerLagFrames_.record(pending * ring_->framesPerSlot());
+
+            size_t frames = 0;
+            int64_t batchCaptureNs = 0;
+            while (frames < capacityFrames) {
+                size_t slotFrames = 0;
+                int64_t captureNs = 0;
+                const uint8_t* data = ring_->front(slotFrames, &captureNs);
+                if (!data || frames + slotFrames > capacityFrames) {
+                    break;
+                }
+                if (frames == 0) {
+                    batchCaptureNs = captureNs;
+                }
+                std::memcpy(batchBuffer_.data() + frames * bytesPerFrame, data, slotFrames * bytesPerFrame);
+                frames += slotFrames;
+                ring_->pop();
+            }
+            if (frames == 0) {
+                break;
+            }
+            if (batchCaptureNs > 0) {
+                const int64_t lagNs = metrics::nowNs() - batchCaptureNs;
+                captureToConsumerUs_.record(lagNs > 0 ? static_cast<uint64_t>(lagNs / 1000) : 0);
+            }
+            // 下游（如 ASR 发送）据此计算端到端延迟
+            metrics::setCurrentCaptureTime(batchCaptureNs);
+            trace::setThreadName("audio.consumer");
+            PERFX_TRACE_SCOPE("audio.consume");
+            trace::flowStep("audio.consumed", static_cast<uint64_t>(batchCaptureNs));
+            runStages(batchBuffer_.data(), frames);
+        }
+    }
+
+    /**
+     * @brief 依次运行已注册的处理器（就地处理），最后调用输入回调
+     */
+    void runStages(uint8_t* data, size_t frames) {
+        using Clock = std::chrono::steady_clock;
+
+        // NaN/Inf 替换为 0 后继续传递，而不是逐样本检查后丢弃整帧（整数格式为空操作）
+        const size_t replaced = converter_.scrub(data, frames * static_cast<size_t>(converter_.channels));
+        if (replaced > 0) {
+            uint64_t total = nonFiniteSamples_.fetch_add(replaced) + replaced;
+            if (total == replaced) {
+                std::cerr << "[AUDIO-THREAD][WARN] Non-finite " << sampleFormatName(converter_.format)
+                          << " samples replaced with silence" << std::endl;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(stagesMutex_);
+        for (size_t i = 0; i < processors_.size(); ++i) {
+            auto begin = Clock::now();
+            processors_[i]->processAudio(data, data, static_cast<unsigned long>(frames));
+            stageTimers_[i]->record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count()));
+        }
+
+        if (inputCallback_) {
+            auto begin = Clock::now();
+            inputCallback_(data, nullptr, static_cast<unsigned long>(frames));
+            stageTimers_.back()->record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count()));
+        }
+
+        batches_.fetch_add(1, std::memory_order_relaxed);
+        framesConsumed_.fetch_add(frames, std::memory_order_relaxed);
+    }
+
     /**
      * @brief PortAudio回调函数，处理音频数据的输入和输出
      * @param input 输入音频数据
@@ -313,59 +567,11 @@ private:
                            PaStreamCallbackFlags /*statusFlags*/,
                            void* userData) {
         auto* impl = static_cast<Impl*>(userData);
-        
-        // 严格输入校验
-        if (!input) {
-            std::cerr << "[ERROR] Input buffer is NULL in audio callback" << std::endl;
-            return paContinue;
-        }
-        if (frameCount == 0) {
-            std::cerr << "[ERROR] Frame count is 0 in audio callback" << std::endl;
-            return paContinue;
-        }
-        
-        // 根据配置的格式检查输入数据
-        bool dataValid = true;
-        if (impl->config_.format == SampleFormat::FLOAT32) {
-            const float* floatInput = static_cast<const float*>(input);
-            for (unsigned long i = 0; i < frameCount; ++i) {
-                if (!std::isfinite(floatInput[i])) {
-                    std::cerr << "[ERROR] Invalid float32 data at index " << i << ": " << floatInput[i] << std::endl;
-                    dataValid = false;
-                    break;
-                }
-            }
-        } else if (impl->config_.format == SampleFormat::INT16) {
-            // INT16数据不需要检查NaN/inf，因为整数不会有这些值
-            // INT16数据是有效的，不需要额外检查
-            static int callbackCount = 0;
-            static std::chrono::steady_clock::time_point lastLogTime = std::chrono::steady_clock::now();
-            static const int LOG_INTERVAL_MS = 1000; // 每秒更新一次日志
-
-            callbackCount++;
-            auto now = std::chrono::steady_clock::now();
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastLogTime).count();
-
-            if (elapsed >= LOG_INTERVAL_MS) {
-                std::cout << "\r[audioCallback] Processing INT16 input data, frameCount=240, total callbacks=" 
-                          << callbackCount << std::flush;
-                callbackCount = 0;
-                lastLogTime = now;
-            }
-        } else {
-            std::cerr << "[ERROR] Unsupported audio format in callback" << std::endl;
-            dataValid = false;
-        }
-        
-        if (!dataValid) {
-            std::cerr << "[ERROR] Invalid audio data detected, skipping frame" << std::endl;
-            return paContinue;
-        }
-        
-        if (impl->inputCallback_) {
-            impl->inputCallback_(input, nullptr, frameCount);
+
+        // 实时线程中只做拷贝与唤醒：格式校验已在 setInputDevice 中完成，清洗与处理交给消费者
+        if (input && frameCount > 0) {
+            impl->submit(input, frameCount);
         }
-        
         return paContinue;
     }
 
@@ -380,12 +586,32 @@ private:
     PaStreamParameters inputParams_;                      ///< 输入流参数
     PaStreamParameters outputParams_;                     ///< 输出流参数
     std::vector<std::shared_ptr<AudioProcessor>> processors_; ///< 音频处理器列表
-    AudioCallback inputCallback_;                         ///< 输入回调函数
-
-    std::mutex mutex_;
-    bool isRecording_;
-    std::thread recordingThread_;
+    AudioCallback inputCallback_;                         ///< 输入回调函数（消费者线程中调用）
+    std::vector<std::unique_ptr<StageTimer>> stageTimers_; ///< 各处理器 + 最终回调的耗时
+    mutable std::mutex stagesMutex_;                      ///< 保护处理器列表、计时器与回调
+    std::atomic<uint64_t> nonFiniteSamples_{0};           ///< 被替换的 NaN/Inf 样本累计数
+    SampleConverter converter_;                           ///< 按流格式选定的转换函数（启动消费者时设置）
+
+    std::unique_ptr<AudioRingBuffer> ring_;               ///< 回调 → 消费者的预分配环形缓冲
+    std::vector<uint8_t> batchBuffer_;                    ///< 消费者批处理缓冲
+    std::atomic<bool> consuming_{false};                  ///< 消费者线程运行标志
+    std::atomic<int> producers_{0};                       ///< 正在 submit 中写缓冲的生产者数
+    std::thread consumerThread_;                          ///< 消费者线程
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> framesConsumed_{0};
+
+    LatencyHistogram& consumerLagFrames_;                 ///< 取数时环形缓冲中积压的帧数（按槽估算）
+    LatencyHistogram& ringOccupancy_;                     ///< 取数时环形缓冲占用槽数
+    LatencyHistogram& captureToConsumerUs_;               ///< 采集 → 消费者开始处理
+    std::atomic<int64_t>& ringDropped_;
+
+    std::mutex mutex_;                                    ///< 串行化消费者启停与 flush
     std::shared_ptr<AudioProcessor> processor_;
+
+    std::atomic<uint64_t> flushRequested_{0};             ///< flush 请求序号
+    std::mutex flushMutex_;
+    std::condition_variable flushCv_;
+    uint64_t flushServed_ = 0;                            ///< 消费者已完成的 flush 序号（flushMutex_ 保护）
 };
 
 // AudioThread类实现
@@ -410,5 +636,17 @@ bool AudioThread::startRecording() {
     return impl_->startRecording();
 }
 
+bool AudioThread::flush(int timeoutMs) {
+    return impl_->flush(timeoutMs);
+}
+
+bool AudioThread::submit(const void* input, unsigned long frameCount) {
+    return impl_->submit(input, frameCount);
+}
+
+PipelineStats AudioThread::getPipelineStats() const {
+    return impl_->getPipelineStats();
+}
+
 } // namespace audio
 } // namespace perfx 
\ No newline at end of file
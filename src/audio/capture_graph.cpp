@@ -0,0 +1,529 @@
+/**
+ * @file capture_graph.cpp
+ * @brief 多输入源采集图：主时钟驱动、漂移估计与自适应重采样
+ */
+
+#include "../../include/audio/capture_graph.h"
+#include "../../include/audio/audio_device.h"
+#include "../../include/audio/latency_metrics.h"
+#include "../../include/audio/sample_pipeline.h"
+#include "../../include/audio/trace_events.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+
+namespace perfx {
+namespace audio {
+
+namespace {
+
+// 观测时长不足时不输出采样率估计
+constexpr double kMinEstimateSpanSec = 2.0;
+// FIFO 水位偏离目标 1 s 时重采样比调整 1%，最多 ±0.05%（远大于晶振漂移，远小于可闻的音高变化）
+constexpr double kFillGain = 0.01;
+constexpr double kMaxFillCorrection = 0.0005;
+// 重采样比的硬限制：估计异常（例如设备时间戳跳变）时不至于严重变调
+constexpr double kMaxRatioDeviation = 0.02;
+// 单次回调处理的最大帧数，超出时分段处理（缓冲按此预分配）
+constexpr size_t kMaxChunkFrames = 4096;
+
+/**
+ * @brief 单生产者 / 单消费者的 INT16 样本 FIFO（容量为 2 的幂）
+ */
+class SampleFifo {
+public:
+    explicit SampleFifo(size_t minCapacity) {
+        size_t capacity = 1;
+        while (capacity < minCapacity) {
+            capacity <<= 1;
+        }
+        buffer_.assign(capacity, 0);
+        mask_ = capacity - 1;
+    }
+
+    size_t available() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @return 实际写入的样本数（空间不足时只写入能容纳的部分）
+     */
+    size_t write(const int16_t* data, size_t count) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t free = buffer_.size() - (head - tail_.load(std::memory_order_acquire));
+        count = std::min(count, free);
+        for (size_t i = 0; i < count; ++i) {
+            buffer_[(head + i) & mask_] = data[i];
+        }
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    size_t read(int16_t* data, size_t count) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        count = std::min(count, head_.load(std::memory_order_acquire) - tail);
+        for (size_t i = 0; i < count; ++i) {
+            data[i] = buffer_[(tail + i) & mask_];
+        }
+        tail_.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    std::vector<int16_t> buffer_;
+    size_t mask_ = 0;
+    std::atomic<size_t> head_{0};
+    std::atomic<size_t> tail_{0};
+};
+
+/**
+ * @brief 4 点三次 Hermite 插值（在 x1 与 x2 之间，t ∈ [0, 1)）
+ */
+inline float hermite(float x0, float x1, float x2, float x3, float t) {
+    const float c1 = 0.5f * (x2 - x0);
+    const float c2 = x0 - 2.5f * x1 + 2.0f * x2 - 0.5f * x3;
+    const float c3 = 0.5f * (x3 - x0) + 1.5f * (x1 - x2);
+    return ((c3 * t + c2) * t + c1) * t + x1;
+}
+
+inline int16_t saturate(float value) {
+    return static_cast<int16_t>(std::lrint(std::max(-32768.0f, std::min(32767.0f, value))));
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+// DriftEstimator
+//------------------------------------------------------------------------------
+
+void DriftEstimator::reset() {
+    originNs_ = -1;
+    lastX_ = 0.0;
+    totalFrames_ = 0.0;
+    weight_ = meanX_ = meanY_ = cxx_ = cxy_ = 0.0;
+}
+
+void DriftEstimator::update(int64_t captureNs, size_t frames) {
+    if (originNs_ < 0) {
+        originNs_ = captureNs;
+    }
+    // 时间以秒计、相对首次回调；采用加权均值 + 协方差的增量形式，长时间运行也不损失精度
+    const double x = static_cast<double>(captureNs - originNs_) / 1e9;
+    const double decay = std::exp(-std::max(0.0, x - lastX_) / timeConstantSec_);
+    weight_ *= decay;
+    cxx_ *= decay;
+    cxy_ *= decay;
+
+    const double y = totalFrames_;
+    weight_ += 1.0;
+    const double dx = x - meanX_;
+    const double dy = y - meanY_;
+    meanX_ += dx / weight_;
+    meanY_ += dy / weight_;
+    cxx_ += dx * (x - meanX_);
+    cxy_ += dx * (y - meanY_);
+
+    lastX_ = std::max(lastX_, x);
+    totalFrames_ += static_cast<double>(frames);
+}
+
+double DriftEstimator::rateHz() const {
+    if (lastX_ < kMinEstimateSpanSec || cxx_ <= 0.0) {
+        return 0.0;
+    }
+    return cxy_ / cxx_;
+}
+
+//------------------------------------------------------------------------------
+// CaptureGraph::Impl
+//------------------------------------------------------------------------------
+
+class CaptureGraph::Impl {
+public:
+    struct Source {
+        CaptureSource info;
+        std::unique_ptr<AudioDevice> device;
+        SampleConverter converter;
+        DriftEstimator estimator;                   // 只在本源的回调线程中更新
+        std::atomic<double> rateHz{0.0};
+        std::vector<int16_t> mono;                  // 回调中转换后的单声道样本
+        std::unique_ptr<SampleFifo> fifo;           // 次要源 → 主时钟回调
+
+        // 重采样状态（只在主时钟回调中访问）
+        float history[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        double phase = 0.0;
+        bool primed = false;
+        std::vector<int16_t> pulled;
+        std::vector<int16_t> track;                 // 本块的输出轨道
+
+        std::atomic<double> ratio{1.0};
+        std::atomic<uint64_t> frames{0};
+        std::atomic<uint64_t> underruns{0};
+        std::atomic<uint64_t> overruns{0};
+    };
+
+    bool open(const std::vector<CaptureSource>& sources, const CaptureGraphConfig& config) {
+        close();
+        if (sources.empty()) {
+            setError("Capture graph needs at least one source");
+            return false;
+        }
+        config_ = config;
+        config_.framesPerBuffer = std::max<size_t>(1, std::min(config_.framesPerBuffer, kMaxChunkFrames));
+        targetFrames_ = static_cast<size_t>(config_.sampleRate) * static_cast<size_t>(std::max(1, config_.targetLatencyMs)) / 1000;
+
+        for (size_t i = 0; i < sources.size(); ++i) {
+            auto source = std::make_unique<Source>();
+            source->info = sources[i];
+            if (source->info.label.empty()) {
+                source->info.label = source->info.device.name;
+            }
+            source->estimator = DriftEstimator(config_.driftTimeConstantSec);
+
+            AudioConfig deviceConfig;
+            deviceConfig.sampleRate = static_cast<SampleRate>(config_.sampleRate);
+            deviceConfig.format = SampleFormat::INT16;
+            // monitor 源通常为立体声：按设备能力最多打开 2 声道，回调中混为单声道
+            deviceConfig.channels = static_cast<ChannelCount>(
+                std::max(1, std::min(2, source->info.device.maxInputChannels)));
+            deviceConfig.framesPerBuffer = static_cast<int>(config_.framesPerBuffer);
+            deviceConfig.inputDevice = source->info.device;
+
+            source->device = std::make_unique<AudioDevice>();
+            source->device->initialize();
+            // 只有主时钟源（麦克风）在断开时切换到备用设备；次要源切到麦克风会重复采集
+            source->device->setFailoverEnabled(i == 0);
+            if (!source->device->openInputDevice(source->info.device, deviceConfig)) {
+                setError("Failed to open " + source->info.label + ": " + source->device->getLastError());
+                sources_.push_back(std::move(source));
+                close();
+                return false;
+            }
+            const AudioConfig opened = source->device->getCurrentConfig();
+            source->converter = SampleConverter::create(opened.format, static_cast<int>(opened.channels));
+            source->mono.assign(kMaxChunkFrames, 0);
+            source->track.assign(kMaxChunkFrames, 0);
+            if (i > 0) {
+                // 目标水位之上留足余量：回调周期抖动与估计收敛前的偏差都不应导致丢弃
+                source->fifo = std::make_unique<SampleFifo>(targetFrames_ * 4 + kMaxChunkFrames);
+                source->pulled.assign(kMaxChunkFrames * 2 + 4, 0);
+            }
+
+            Source* raw = source.get();
+            const std::string label = source->info.label;
+            if (i == 0) {
+                source->device->setCallback([this](const void* input, void*, size_t frameCount) {
+                    onMaster(input, frameCount);
+                });
+            } else {
+                source->device->setCallback([this, raw](const void* input, void*, size_t frameCount) {
+                    onSecondary(*raw, input, frameCount);
+                });
+            }
+            source->device->setErrorCallback([this, label](const std::string& error) {
+                reportError(label + ": " + error);
+            });
+            sources_.push_back(std::move(source));
+        }
+
+        const size_t tracks = config_.mix ? 1 : sources_.size();
+        output_.assign(kMaxChunkFrames * tracks, 0);
+        std::cout << "[AUDIO] Capture graph opened: " << sources_.size() << " source(s), "
+                  << (config_.mix ? "mixed" : "separate tracks") << ", master " << sources_[0]->info.label
+                  << std::endl;
+        return true;
+    }
+
+    bool start() {
+        if (sources_.empty()) {
+            setError("Capture graph is not open");
+            return false;
+        }
+        // 先启动次要源，主时钟开始取数时 FIFO 已在积累
+        for (size_t i = sources_.size(); i-- > 0;) {
+            Source& source = *sources_[i];
+            source.estimator.reset();
+            source.rateHz.store(0.0, std::memory_order_relaxed);
+            source.phase = 0.0;
+            source.primed = false;
+            std::fill(std::begin(source.history), std::end(source.history), 0.0f);
+            if (!source.device->startStream()) {
+                setError("Failed to start " + source.info.label + ": " + source.device->getLastError());
+                stop();
+                return false;
+            }
+        }
+        running_ = true;
+        return true;
+    }
+
+    void stop() {
+        running_ = false;
+        for (auto& source : sources_) {
+            source->device->stopStream();
+        }
+    }
+
+    void close() {
+        stop();
+        for (auto& source : sources_) {
+            source->device->closeDevice();
+        }
+        sources_.clear();
+    }
+
+    void setCallback(AudioCallback callback) {
+        callback_ = std::move(callback);
+    }
+
+    void setErrorCallback(ErrorCallback callback) {
+        std::lock_guard<std::mutex> lock(errorMutex_);
+        errorCallback_ = std::move(callback);
+    }
+
+    int trackCount() const {
+        return config_.mix ? 1 : static_cast<int>(sources_.size());
+    }
+
+    std::vector<std::string> trackLabels() const {
+        std::vector<std::string> labels;
+        if (config_.mix) {
+            labels.push_back("mix");
+            return labels;
+        }
+        for (const auto& source : sources_) {
+            labels.push_back(source->info.label);
+        }
+        return labels;
+    }
+
+    std::vector<CaptureSourceStats> getStats() const {
+        std::vector<CaptureSourceStats> result;
+        const double masterRate = sources_.empty() ? 0.0 : sources_[0]->rateHz.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < sources_.size(); ++i) {
+            const Source& source = *sources_[i];
+            CaptureSourceStats stats;
+            stats.label = source.info.label;
+            stats.device = source.info.device.name;
+            stats.master = i == 0;
+            stats.rateHz = source.rateHz.load(std::memory_order_relaxed);
+            if (i > 0 && masterRate > 0.0 && stats.rateHz > 0.0) {
+                stats.driftPpm = (stats.rateHz / masterRate - 1.0) * 1e6;
+            }
+            stats.ratio = source.ratio.load(std::memory_order_relaxed);
+            if (source.fifo) {
+                stats.fillMs = static_cast<double>(source.fifo->available()) * 1000.0 / config_.sampleRate;
+            }
+            stats.frames = source.frames.load(std::memory_order_relaxed);
+            stats.underruns = source.underruns.load(std::memory_order_relaxed);
+            stats.overruns = source.overruns.load(std::memory_order_relaxed);
+            stats.xruns = source.device->getXrunCount();
+            result.push_back(std::move(stats));
+        }
+        return result;
+    }
+
+    uint64_t getXrunCount() const {
+        uint64_t total = 0;
+        for (const auto& source : sources_) {
+            total += source->device->getXrunCount();
+        }
+        return total;
+    }
+
+    bool isRunning() const {
+        return running_;
+    }
+
+    std::string getLastError() const {
+        std::lock_guard<std::mutex> lock(errorMutex_);
+        return lastError_;
+    }
+
+private:
+    /**
+     * @brief 按回调采集时间更新采样率估计（AudioDevice 在回调前按 ADC 时间设置了采集时间）
+     */
+    static void trackRate(Source& source, size_t frameCount) {
+        source.estimator.update(metrics::currentCaptureTime(), frameCount);
+        source.rateHz.store(source.estimator.rateHz(), std::memory_order_relaxed);
+        source.frames.fetch_add(frameCount, std::memory_order_relaxed);
+    }
+
+    void onSecondary(Source& source, const void* input, size_t frameCount) {
+        trackRate(source, frameCount);
+        const uint8_t* bytes = static_cast<const uint8_t*>(input);
+        for (size_t offset = 0; offset < frameCount; offset += kMaxChunkFrames) {
+            const size_t count = std::min(kMaxChunkFrames, frameCount - offset);
+            source.converter.toMonoInt16(bytes + offset * source.converter.bytesPerFrame, source.mono.data(), count);
+            if (source.fifo->write(source.mono.data(), count) < count) {
+                source.overruns.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void onMaster(const void* input, size_t frameCount) {
+        PERFX_TRACE_SCOPE("audio.graph_mix");
+        Source& master = *sources_[0];
+        trackRate(master, frameCount);
+
+        const uint8_t* bytes = static_cast<const uint8_t*>(input);
+        for (size_t offset = 0; offset < frameCount; offset += kMaxChunkFrames) {
+            const size_t count = std::min(kMaxChunkFrames, frameCount - offset);
+            master.converter.toMonoInt16(bytes + offset * master.converter.bytesPerFrame, master.track.data(), count);
+            for (size_t i = 1; i < sources_.size(); ++i) {
+                pullResampled(*sources_[i], master.rateHz.load(std::memory_order_relaxed), count);
+            }
+            mixTracks(count);
+            if (callback_) {
+                callback_(output_.data(), nullptr, count);
+            }
+        }
+    }
+
+    /**
+     * @brief 从次要源 FIFO 取出 count 个输出帧：重采样比 = 漂移比 × (1 + 水位修正)
+     */
+    void pullResampled(Source& source, double masterRate, size_t count) {
+        int16_t* out = source.track.data();
+        const size_t available = source.fifo->available();
+
+        double ratio = 1.0;
+        if (config_.driftCorrection) {
+            const double sourceRate = source.rateHz.load(std::memory_order_relaxed);
+            if (masterRate > 0.0 && sourceRate > 0.0) {
+                ratio = sourceRate / masterRate;
+            }
+            const double fillErrorSec =
+                (static_cast<double>(available) - static_cast<double>(targetFrames_)) / config_.sampleRate;
+            ratio *= 1.0 + std::max(-kMaxFillCorrection, std::min(kMaxFillCorrection, kFillGain * fillErrorSec));
+            ratio = std::max(1.0 - kMaxRatioDeviation, std::min(1.0 + kMaxRatioDeviation, ratio));
+        }
+        source.ratio.store(ratio, std::memory_order_relaxed);
+
+        // 启动或取空后先积累到目标水位，期间输出静音
+        if (!source.primed) {
+            if (available < targetFrames_) {
+                std::fill(out, out + count, int16_t(0));
+                return;
+            }
+            source.primed = true;
+        }
+
+        // 先按相位推进算出本块需要的输入样本数，不足时整块补静音并重新积累
+        size_t needed = 0;
+        double phase = source.phase;
+        for (size_t i = 0; i < count; ++i) {
+            phase += ratio;
+            while (phase >= 1.0) {
+                phase -= 1.0;
+                ++needed;
+            }
+        }
+        if (needed > source.pulled.size() || available < needed) {
+            source.underruns.fetch_add(1, std::memory_order_relaxed);
+            source.primed = false;
+            std::fill(out, out + count, int16_t(0));
+            return;
+        }
+        source.fifo->read(source.pulled.data(), needed);
+
+        float* h = source.history;
+        size_t next = 0;
+        phase = source.phase;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = saturate(hermite(h[0], h[1], h[2], h[3], static_cast<float>(phase)));
+            phase += ratio;
+            while (phase >= 1.0) {
+                phase -= 1.0;
+                h[0] = h[1];
+                h[1] = h[2];
+                h[2] = h[3];
+                h[3] = static_cast<float>(source.pulled[next++]);
+            }
+        }
+        source.phase = phase;
+    }
+
+    void mixTracks(size_t count) {
+        const size_t tracks = sources_.size();
+        if (config_.mix) {
+            // 近端与远端通常不同时说话，直接相加（饱和）而不是取平均，避免各自电平减半
+            for (size_t i = 0; i < count; ++i) {
+                int32_t sum = 0;
+                for (size_t t = 0; t < tracks; ++t) {
+                    sum += sources_[t]->track[i];
+                }
+                output_[i] = static_cast<int16_t>(std::max(-32768, std::min(32767, sum)));
+            }
+            return;
+        }
+        for (size_t t = 0; t < tracks; ++t) {
+            const int16_t* track = sources_[t]->track.data();
+            for (size_t i = 0; i < count; ++i) {
+                output_[i * tracks + t] = track[i];
+            }
+        }
+    }
+
+    void setError(const std::string& error) {
+        std::lock_guard<std::mutex> lock(errorMutex_);
+        lastError_ = error;
+        std::cerr << "[AUDIO][ERROR] " << error << std::endl;
+    }
+
+    void reportError(const std::string& error) {
+        ErrorCallback callback;
+        {
+            std::lock_guard<std::mutex> lock(errorMutex_);
+            lastError_ = error;
+            callback = errorCallback_;
+        }
+        if (callback) {
+            callback(error);
+        }
+    }
+
+    CaptureGraphConfig config_;
+    size_t targetFrames_ = 0;
+    std::vector<std::unique_ptr<Source>> sources_;
+    std::vector<int16_t> output_;
+    AudioCallback callback_;
+    std::atomic<bool> running_{false};
+
+    mutable std::mutex errorMutex_;
+    ErrorCallback errorCallback_;
+    std::string lastError_;
+};
+
+//------------------------------------------------------------------------------
+// CaptureGraph 公共接口
+//------------------------------------------------------------------------------
+
+CaptureGraph::CaptureGraph() : impl_(std::make_unique<Impl>()) {}
+
+CaptureGraph::~CaptureGraph() {
+    impl_->close();
+}
+
+bool CaptureGraph::open(const std::vector<CaptureSource>& sources, const CaptureGraphConfig& config) {
+    return impl_->open(sources, config);
+}
+
+bool CaptureGraph::start() { return impl_->start(); }
+void CaptureGraph::stop() { impl_->stop(); }
+void CaptureGraph::close() { impl_->close(); }
+void CaptureGraph::setCallback(AudioCallback callback) { impl_->setCallback(std::move(callback)); }
+void CaptureGraph::setErrorCallback(ErrorCallback callback) { impl_->setErrorCallback(std::move(callback)); }
+int CaptureGraph::trackCount() const { return impl_->trackCount(); }
+std::vector<std::string> CaptureGraph::trackLabels() const { return impl_->trackLabels(); }
+std::vector<CaptureSourceStats> CaptureGraph::getStats() const { return impl_->getStats(); }
+uint64_t CaptureGraph::getXrunCount() const { return impl_->getXrunCount(); }
+bool CaptureGraph::isRunning() const { return impl_->isRunning(); }
+std::string CaptureGraph::getLastError() const { return impl_->getLastError(); }
+
+} // namespace audio
+} // namespace perfx
@@ -0,0 +1,116 @@
+/**
+ * @file channel_splitter.cpp
+ * @brief 多声道输入按组拆分为单声道 INT16
+ */
+
+#include "audio/channel_splitter.h"
+#include "audio/dsp_kernels.h"
+#include <algorithm>
+
+namespace perfx {
+namespace audio {
+
+void ChannelSplitter::configure(const SampleConverter& converter, std::vector<ChannelGroup> groups) {
+    converter_ = converter;
+    const int channels = converter_.channels;
+
+    groups_.clear();
+    for (auto& group : groups) {
+        ChannelGroup sanitized;
+        sanitized.label = std::move(group.label);
+        for (int channel : group.channels) {
+            if (channel >= 0 && channel < channels &&
+                std::find(sanitized.channels.begin(), sanitized.channels.end(), channel) == sanitized.channels.end()) {
+                sanitized.channels.push_back(channel);
+            }
+        }
+        if (sanitized.channels.empty()) {
+            sanitized.channels.push_back(0);
+        }
+        groups_.push_back(std::move(sanitized));
+    }
+    if (groups_.empty()) {
+        ChannelGroup all;
+        for (int channel = 0; channel < channels; ++channel) {
+            all.channels.push_back(channel);
+        }
+        groups_.push_back(std::move(all));
+    }
+
+    downmixOnly_ = groups_.size() == 1 && static_cast<int>(groups_[0].channels.size()) == channels;
+    outputs_.assign(groups_.size(), nullptr);
+    capacity_ = 0;
+}
+
+std::vector<ChannelGroup> ChannelSplitter::perChannelGroups(int channels) {
+    std::vector<ChannelGroup> groups;
+    for (int channel = 0; channel < channels; ++channel) {
+        groups.push_back({"ch" + std::to_string(channel + 1), {channel}});
+    }
+    return groups;
+}
+
+void ChannelSplitter::reserve(size_t frames) {
+    if (frames <= capacity_) {
+        return;
+    }
+    const size_t channels = static_cast<size_t>(converter_.channels);
+    capacity_ = frames;
+    if (converter_.format != SampleFormat::INT16) {
+        interleaved_.resize(frames * channels);
+    }
+    mixes_.resize(frames * groups_.size());
+    if (!downmixOnly_) {
+        planes_.resize(frames * channels);
+        planePtrs_.resize(channels);
+        for (size_t ch = 0; ch < channels; ++ch) {
+            planePtrs_[ch] = planes_.data() + ch * frames;
+        }
+    }
+}
+
+void ChannelSplitter::split(const void* input, size_t frames) {
+    if (!input || frames == 0 || groups_.empty()) {
+        return;
+    }
+    reserve(frames);
+
+    if (downmixOnly_) {
+        if (converter_.isMonoInt16()) {
+            outputs_[0] = static_cast<const int16_t*>(input);
+        } else {
+            converter_.toMonoInt16(input, mixes_.data(), frames);
+            outputs_[0] = mixes_.data();
+        }
+        return;
+    }
+
+    const int channels = converter_.channels;
+    const int16_t* interleaved = static_cast<const int16_t*>(input);
+    if (converter_.format != SampleFormat::INT16) {
+        converter_.toInt16(input, interleaved_.data(), frames * static_cast<size_t>(channels));
+        interleaved = interleaved_.data();
+    }
+    dsp::deinterleave(interleaved, planePtrs_.data(), channels, frames);
+
+    for (size_t g = 0; g < groups_.size(); ++g) {
+        const std::vector<int>& members = groups_[g].channels;
+        if (members.size() == 1) {
+            outputs_[g] = planePtrs_[static_cast<size_t>(members[0])];
+            continue;
+        }
+        int16_t* mix = mixes_.data() + g * capacity_;
+        const int32_t count = static_cast<int32_t>(members.size());
+        for (size_t i = 0; i < frames; ++i) {
+            int32_t sum = 0;
+            for (int channel : members) {
+                sum += planePtrs_[static_cast<size_t>(channel)][i];
+            }
+            mix[i] = static_cast<int16_t>(sum / count);
+        }
+        outputs_[g] = mix;
+    }
+}
+
+} // namespace audio
+} // namespace perfx
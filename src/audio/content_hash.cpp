@@ -0,0 +1,244 @@
+/**
+ * @file content_hash.cpp
+ * @brief XXH64 流式哈希与分块并行文件哈希
+ */
+
+#include "../../include/audio/content_hash.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace perfx {
+namespace audio {
+
+//------------------------------------------------------------------------------
+// XXH64
+//------------------------------------------------------------------------------
+
+namespace {
+
+constexpr uint64_t kPrime1 = 11400714785074694791ULL;
+constexpr uint64_t kPrime2 = 14029467366897019727ULL;
+constexpr uint64_t kPrime3 = 1609587929392839161ULL;
+constexpr uint64_t kPrime4 = 9650029242287828579ULL;
+constexpr uint64_t kPrime5 = 2870177450012600261ULL;
+
+inline uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// 按小端读取，与参考实现的跨平台结果一致
+inline uint64_t read64(const unsigned char* p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+inline uint32_t read32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint64_t round64(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    acc = rotl(acc, 31);
+    return acc * kPrime1;
+}
+
+inline uint64_t mergeRound(uint64_t acc, uint64_t value) {
+    acc ^= round64(0, value);
+    return acc * kPrime1 + kPrime4;
+}
+
+} // namespace
+
+Xxh64::Xxh64(uint64_t seed) {
+    reset(seed);
+}
+
+void Xxh64::reset(uint64_t seed) {
+    seed_ = seed;
+    v1_ = seed + kPrime1 + kPrime2;
+    v2_ = seed + kPrime2;
+    v3_ = seed;
+    v4_ = seed - kPrime1;
+    totalLength_ = 0;
+    bufferSize_ = 0;
+}
+
+void Xxh64::update(const void* data, size_t length) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    totalLength_ += length;
+
+    if (bufferSize_ + length < 32) {
+        std::memcpy(buffer_ + bufferSize_, p, length);
+        bufferSize_ += length;
+        return;
+    }
+
+    if (bufferSize_ > 0) {
+        const size_t fill = 32 - bufferSize_;
+        std::memcpy(buffer_ + bufferSize_, p, fill);
+        v1_ = round64(v1_, read64(buffer_));
+        v2_ = round64(v2_, read64(buffer_ + 8));
+        v3_ = round64(v3_, read64(buffer_ + 16));
+        v4_ = round64(v4_, read64(buffer_ + 24));
+        p += fill;
+        length -= fill;
+        bufferSize_ = 0;
+    }
+
+    while (length >= 32) {
+        v1_ = round64(v1_, read64(p));
+        v2_ = round64(v2_, read64(p + 8));
+        v3_ = round64(v3_, read64(p + 16));
+        v4_ = round64(v4_, read64(p + 24));
+        p += 32;
+        length -= 32;
+    }
+
+    if (length > 0) {
+        std::memcpy(buffer_, p, length);
+        bufferSize_ = length;
+    }
+}
+
+uint64_t Xxh64::digest() const {
+    uint64_t h;
+    if (totalLength_ >= 32) {
+        h = rotl(v1_, 1) + rotl(v2_, 7) + rotl(v3_, 12) + rotl(v4_, 18);
+        h = mergeRound(h, v1_);
+        h = mergeRound(h, v2_);
+        h = mergeRound(h, v3_);
+        h = mergeRound(h, v4_);
+    } else {
+        h = seed_ + kPrime5;
+    }
+    h += totalLength_;
+
+    const unsigned char* p = buffer_;
+    size_t remaining = bufferSize_;
+    while (remaining >= 8) {
+        h ^= round64(0, read64(p));
+        h = rotl(h, 27) * kPrime1 + kPrime4;
+        p += 8;
+        remaining -= 8;
+    }
+    if (remaining >= 4) {
+        h ^= static_cast<uint64_t>(read32(p)) * kPrime1;
+        h = rotl(h, 23) * kPrime2 + kPrime3;
+        p += 4;
+        remaining -= 4;
+    }
+    while (remaining > 0) {
+        h ^= static_cast<uint64_t>(*p) * kPrime5;
+        h = rotl(h, 11) * kPrime1;
+        ++p;
+        --remaining;
+    }
+
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+uint64_t Xxh64::hash(const void* data, size_t length, uint64_t seed) {
+    Xxh64 state(seed);
+    state.update(data, length);
+    return state.digest();
+}
+
+std::string toHex(uint64_t value) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        out[static_cast<size_t>(i)] = digits[value & 0xF];
+        value >>= 4;
+    }
+    return out;
+}
+
+//------------------------------------------------------------------------------
+// 分块并行文件哈希
+//------------------------------------------------------------------------------
+
+std::string hashFileContent(const std::string& filePath, std::string* error,
+                            unsigned threads, size_t chunkSize) {
+    std::ifstream probe(filePath, std::ios::binary | std::ios::ate);
+    if (!probe.is_open()) {
+        if (error) *error = "Failed to open file for hashing: " + filePath;
+        return std::string();
+    }
+    const uint64_t fileSize = static_cast<uint64_t>(probe.tellg());
+    probe.close();
+
+    chunkSize = std::max<size_t>(chunkSize, 64 * 1024);
+    const size_t chunkCount = std::max<size_t>(1, static_cast<size_t>((fileSize + chunkSize - 1) / chunkSize));
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(std::min<size_t>(threads, chunkCount));
+
+    std::vector<uint64_t> chunkHashes(chunkCount, 0);
+    std::atomic<size_t> nextChunk{0};
+    std::atomic<bool> failed{false};
+
+    auto worker = [&]() {
+        std::ifstream in(filePath, std::ios::binary);
+        if (!in.is_open()) {
+            failed = true;
+            return;
+        }
+        // 每个线程一个 1MB 读缓冲，块内流式哈希
+        std::vector<char> buffer(1024 * 1024);
+        for (size_t index = nextChunk++; index < chunkCount && !failed; index = nextChunk++) {
+            const uint64_t offset = static_cast<uint64_t>(index) * chunkSize;
+            uint64_t remaining = std::min<uint64_t>(chunkSize, fileSize - std::min(fileSize, offset));
+            in.clear();
+            in.seekg(static_cast<std::streamoff>(offset));
+            Xxh64 state(index);
+            while (remaining > 0) {
+                const size_t toRead = static_cast<size_t>(std::min<uint64_t>(remaining, buffer.size()));
+                in.read(buffer.data(), static_cast<std::streamsize>(toRead));
+                if (static_cast<size_t>(in.gcount()) != toRead) {
+                    failed = true;
+                    return;
+                }
+                state.update(buffer.data(), toRead);
+                remaining -= toRead;
+            }
+            chunkHashes[index] = state.digest();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : pool) {
+        t.join();
+    }
+
+    if (failed) {
+        if (error) *error = "Failed to read file for hashing: " + filePath;
+        return std::string();
+    }
+
+    Xxh64 root(0);
+    root.update(chunkHashes.data(), chunkHashes.size() * sizeof(uint64_t));
+    root.update(&fileSize, sizeof(fileSize));
+    return toHex(root.digest()) + "-" + std::to_string(fileSize);
+}
+
+} // namespace audio
+} // namespace perfx
@@ -0,0 +1,592 @@
+/**
+ * @file device_registry.cpp
+ * @brief 音频设备注册表的实现
+ * @details 后台枚举并缓存设备信息，通过拓扑指纹检测热插拔
+ */
+
+#include "../../include/audio/device_registry.h"
+#include <portaudio.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <thread>
+
+namespace perfx {
+namespace audio {
+
+std::mutex& portAudioMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+//==============================================================================
+// DeviceRegistry::Impl 类实现
+//==============================================================================
+
+class DeviceRegistry::Impl {
+public:
+    using Event = DeviceRegistry::Event;
+    using Listener = DeviceRegistry::Listener;
+
+    Impl() {
+        registerEnvironmentDevices();
+    }
+
+    ~Impl() {
+        stop();
+    }
+
+    void start(int pollIntervalMs) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) {
+            return;
+        }
+        pollIntervalMs_ = pollIntervalMs > 0 ? pollIntervalMs : 2000;
+        running_ = true;
+        worker_ = std::thread(&Impl::workerLoop, this);
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_) {
+                return;
+            }
+            running_ = false;
+        }
+        cv_.notify_all();
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+
+        std::lock_guard<std::mutex> paLock(portAudioMutex());
+        paPinned_ = false;
+        // 仍有借用者时由最后一个借用者终止
+        if (paHeld_ && paBorrowers_ == 0) {
+            Pa_Terminate();
+            paHeld_ = false;
+        }
+    }
+
+    bool isReady() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return ready_;
+    }
+
+    bool waitUntilReady(int timeoutMs) const {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return readyCv_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() { return ready_; });
+    }
+
+    std::vector<DeviceInfo> getDevices() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<DeviceInfo> devices = devices_;
+        for (const auto& entry : virtualDevices_) {
+            devices.push_back(entry.info);
+        }
+        return devices;
+    }
+
+    std::vector<DeviceInfo> getInputDevices() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<DeviceInfo> inputs;
+        for (const auto& device : devices_) {
+            if (device.maxInputChannels > 0) {
+                inputs.push_back(device);
+            }
+        }
+        for (const auto& entry : virtualDevices_) {
+            inputs.push_back(entry.info);
+        }
+        return inputs;
+    }
+
+    bool findByName(const std::string& name, DeviceInfo& device) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& d : devices_) {
+            if (d.name == name) {
+                device = d;
+                return true;
+            }
+        }
+        for (const auto& entry : virtualDevices_) {
+            if (entry.info.name == name) {
+                device = entry.info;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool addVirtualDevice(const VirtualDeviceConfig& config, DeviceInfo& device, std::string& error) {
+        // 读取 WAV 头在锁外进行，索引在加锁后分配
+        if (!describeVirtualDevice(config, -1, device, error)) {
+            return false;
+        }
+        bool replaced = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = std::find_if(virtualDevices_.begin(), virtualDevices_.end(),
+                                   [&device](const VirtualEntry& entry) { return entry.info.name == device.name; });
+            if (it != virtualDevices_.end()) {
+                device.index = it->info.index;
+                it->info = device;
+                it->config = config;
+                replaced = true;
+            } else {
+                device.index = nextVirtualIndex_++;
+                virtualDevices_.push_back({device, config});
+            }
+        }
+        std::cout << "[AUDIO-THREAD] DeviceRegistry: virtual device " << device.index << " (" << device.name
+                  << ") -> " << config.source << std::endl;
+        if (!replaced) {
+            notify(Event::Changed, {device.name});
+        }
+        return true;
+    }
+
+    bool removeVirtualDevice(const std::string& name) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = std::find_if(virtualDevices_.begin(), virtualDevices_.end(),
+                                   [&name](const VirtualEntry& entry) { return entry.info.name == name; });
+            if (it == virtualDevices_.end()) {
+                return false;
+            }
+            virtualDevices_.erase(it);
+        }
+        notify(Event::Changed, {}, {name});
+        return true;
+    }
+
+    bool getVirtualDevice(int index, VirtualDeviceConfig& config) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& entry : virtualDevices_) {
+            if (entry.info.index == index) {
+                config = entry.config;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    DeviceInfo getFallbackInputDevice(const DeviceInfo& lost, int minChannels) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const DeviceInfo* candidate = nullptr;
+        for (const auto& d : devices_) {
+            if (d.name == lost.name || d.maxInputChannels < minChannels) {
+                continue;
+            }
+            if (d.isDefaultInput) {
+                return d;
+            }
+            if (!candidate) {
+                candidate = &d;
+            }
+        }
+        if (candidate) {
+            return *candidate;
+        }
+        DeviceInfo none{};
+        none.index = -1;
+        return none;
+    }
+
+    void requestRescan() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            rescanRequested_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    void retainStream() { ++activeStreams_; }
+    void releaseStream() {
+        if (activeStreams_.fetch_sub(1) <= 0) {
+            activeStreams_ = 0;
+        }
+    }
+
+    bool acquirePortAudio(std::string* error) {
+        std::lock_guard<std::mutex> paLock(portAudioMutex());
+        if (!paHeld_) {
+            PaError err = Pa_Initialize();
+            if (err != paNoError) {
+                if (error) {
+                    *error = "Failed to initialize PortAudio: " + std::string(Pa_GetErrorText(err));
+                }
+                return false;
+            }
+            paHeld_ = true;
+        }
+        ++paBorrowers_;
+        return true;
+    }
+
+    void releasePortAudio() {
+        std::lock_guard<std::mutex> paLock(portAudioMutex());
+        if (paBorrowers_ > 0) {
+            --paBorrowers_;
+        }
+        if (paBorrowers_ == 0 && paHeld_ && !paPinned_) {
+            Pa_Terminate();
+            paHeld_ = false;
+        }
+    }
+
+    int addListener(Listener listener) {
+        std::lock_guard<std::mutex> lock(listenerMutex_);
+        const int id = nextListenerId_++;
+        listeners_.emplace_back(id, std::move(listener));
+        return id;
+    }
+
+    void removeListener(int id) {
+        // 通知在持有 listenerMutex_ 时进行，注销返回后不会再回调
+        std::lock_guard<std::mutex> lock(listenerMutex_);
+        listeners_.erase(std::remove_if(listeners_.begin(), listeners_.end(),
+                                        [id](const auto& entry) { return entry.first == id; }),
+                         listeners_.end());
+    }
+
+private:
+    // 非 Linux 平台无低成本指纹时，每隔多少个轮询周期做一次完整枚举
+    static constexpr int kFullScanTicks = 15;
+    // 指纹变化后设备表仍未变化时的最大重试次数（ALSA 节点可能先于 PortAudio 可见）
+    static constexpr int kMaxUnchangedRescans = 3;
+
+    struct VirtualEntry {
+        DeviceInfo info;
+        VirtualDeviceConfig config;
+    };
+
+    /**
+     * @brief 注册 PERFX_VIRTUAL_DEVICES 中的虚拟设备（描述串以 ';' 分隔）
+     */
+    void registerEnvironmentDevices() {
+        const char* env = std::getenv("PERFX_VIRTUAL_DEVICES");
+        if (!env || !*env) {
+            return;
+        }
+        std::stringstream specs(env);
+        std::string spec;
+        while (std::getline(specs, spec, ';')) {
+            if (spec.empty()) {
+                continue;
+            }
+            VirtualDeviceConfig config;
+            DeviceInfo device;
+            std::string error;
+            if (!parseVirtualDeviceSpec(spec, config, error) || !addVirtualDevice(config, device, error)) {
+                std::cerr << "[AUDIO-THREAD][ERROR] Invalid virtual device '" << spec << "': " << error << std::endl;
+            }
+        }
+    }
+
+    /**
+     * @brief 探测输入设备支持的常用采样率
+     */
+    static std::vector<int> probeSampleRates(int index, const PaDeviceInfo* info) {
+        static const int kRates[] = {8000, 16000, 22050, 32000, 44100, 48000};
+        std::vector<int> rates;
+
+        PaStreamParameters params;
+        params.device = index;
+        params.channelCount = 1;
+        params.sampleFormat = paInt16;
+        params.suggestedLatency = info->defaultLowInputLatency;
+        params.hostApiSpecificStreamInfo = nullptr;
+
+        for (int rate : kRates) {
+            if (Pa_IsFormatSupported(&params, nullptr, static_cast<double>(rate)) == paFormatIsSupported) {
+                rates.push_back(rate);
+            }
+        }
+        return rates;
+    }
+
+    /**
+     * @brief 枚举全部设备（调用方需持有 portAudioMutex）
+     */
+    static std::vector<DeviceInfo> enumerate() {
+        std::vector<DeviceInfo> devices;
+        int numDevices = Pa_GetDeviceCount();
+        if (numDevices < 0) {
+            std::cerr << "[AUDIO-THREAD][ERROR] Error getting device count: " << Pa_GetErrorText(numDevices) << std::endl;
+            return devices;
+        }
+        PaDeviceIndex defaultInput = Pa_GetDefaultInputDevice();
+
+        for (int i = 0; i < numDevices; i++) {
+            const PaDeviceInfo* deviceInfo = Pa_GetDeviceInfo(i);
+            if (!deviceInfo) continue;
+
+            DeviceInfo info{};
+            info.index = i;
+            info.name = deviceInfo->name;
+            info.maxInputChannels = deviceInfo->maxInputChannels;
+            info.maxOutputChannels = deviceInfo->maxOutputChannels;
+            info.defaultSampleRate = deviceInfo->defaultSampleRate;
+            info.isDefaultInput = (i == defaultInput);
+
+            const PaHostApiInfo* hostApi = Pa_GetHostApiInfo(deviceInfo->hostApi);
+            if (hostApi && hostApi->name) {
+                info.hostApi = hostApi->name;
+            }
+
+            if (info.maxInputChannels > 0 && info.maxOutputChannels > 0) {
+                info.type = DeviceType::BOTH;
+            } else if (info.maxInputChannels > 0) {
+                info.type = DeviceType::INPUT;
+            } else {
+                info.type = DeviceType::OUTPUT;
+            }
+
+            if (info.maxInputChannels > 0) {
+                info.defaultLatency = deviceInfo->defaultLowInputLatency;
+                info.supportedSampleRates = probeSampleRates(i, deviceInfo);
+            } else {
+                info.defaultLatency = deviceInfo->defaultLowOutputLatency;
+            }
+
+            devices.push_back(info);
+        }
+        return devices;
+    }
+
+    /**
+     * @brief 读取音频拓扑指纹，不访问 PortAudio
+     * @return 指纹字符串；平台不支持时为空
+     */
+    static std::string readTopologyFingerprint() {
+#ifdef __linux__
+        std::ostringstream fingerprint;
+        for (const char* path : {"/proc/asound/cards", "/proc/asound/pcm"}) {
+            std::ifstream file(path);
+            if (file.is_open()) {
+                fingerprint << file.rdbuf();
+            }
+        }
+        return fingerprint.str();
+#else
+        return std::string();
+#endif
+    }
+
+    /**
+     * @brief 重新初始化 PortAudio 并枚举
+     * @param initial 首次枚举：有借用者时直接用其已初始化的 PortAudio 枚举
+     * @return 有借用者（无法重新初始化）或初始化失败时返回 false，设备表未刷新
+     */
+    bool rescan(std::vector<DeviceInfo>& devices, bool initial) {
+        std::lock_guard<std::mutex> paLock(portAudioMutex());
+        if (paBorrowers_ > 0) {
+            if (!initial) {
+                return false;
+            }
+            paPinned_ = true;
+            devices = enumerate();
+            return true;
+        }
+        if (paHeld_) {
+            Pa_Terminate();
+            paHeld_ = false;
+        }
+        PaError err = Pa_Initialize();
+        if (err != paNoError) {
+            std::cerr << "[AUDIO-THREAD][ERROR] PortAudio initialization failed: " << Pa_GetErrorText(err) << std::endl;
+            return false;
+        }
+        paHeld_ = true;
+        paPinned_ = true;
+        devices = enumerate();
+        return true;
+    }
+
+    void notify(Event event, const std::vector<std::string>& added = {},
+                const std::vector<std::string>& removed = {}) {
+        std::lock_guard<std::mutex> lock(listenerMutex_);
+        for (const auto& entry : listeners_) {
+            entry.second(event, added, removed);
+        }
+    }
+
+    /**
+     * @return 设备列表是否发生变化
+     */
+    bool publish(std::vector<DeviceInfo> devices, bool initial) {
+        std::vector<std::string> added;
+        std::vector<std::string> removed;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::set<std::string> oldNames;
+            std::set<std::string> newNames;
+            for (const auto& d : devices_) oldNames.insert(d.name);
+            for (const auto& d : devices) newNames.insert(d.name);
+            for (const auto& name : newNames) {
+                if (!oldNames.count(name)) added.push_back(name);
+            }
+            for (const auto& name : oldNames) {
+                if (!newNames.count(name)) removed.push_back(name);
+            }
+            devices_ = std::move(devices);
+            ready_ = true;
+        }
+
+        if (initial) {
+            readyCv_.notify_all();
+            std::cout << "[AUDIO-THREAD] DeviceRegistry: " << added.size() << " devices cached" << std::endl;
+            notify(Event::Ready, added);
+        } else if (!added.empty() || !removed.empty()) {
+            std::cout << "[AUDIO-THREAD] DeviceRegistry: devices changed (+" << added.size()
+                      << " / -" << removed.size() << ")" << std::endl;
+            notify(Event::Changed, added, removed);
+        }
+        return !added.empty() || !removed.empty();
+    }
+
+    void workerLoop() {
+        std::vector<DeviceInfo> initialDevices;
+        rescan(initialDevices, true);
+        publish(std::move(initialDevices), true);
+        std::string fingerprint = readTopologyFingerprint();
+        int ticksSinceFullScan = 0;
+        int unchangedRescans = 0;
+        bool pending = false;  // 检测到变化但尚未刷新出新的设备表
+        bool stale = false;    // 已通知 Stale
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (running_) {
+            cv_.wait_for(lock, std::chrono::milliseconds(pollIntervalMs_),
+                         [this]() { return !running_ || rescanRequested_; });
+            if (!running_) {
+                break;
+            }
+            bool requested = rescanRequested_;
+            rescanRequested_ = false;
+            lock.unlock();
+
+            bool changed = requested || pending;
+            std::string current = readTopologyFingerprint();
+            if (!current.empty()) {
+                if (current != fingerprint) {
+                    changed = true;
+                }
+            } else if (++ticksSinceFullScan >= kFullScanTicks && activeStreams_ == 0) {
+                ticksSinceFullScan = 0;
+                changed = true;
+            }
+
+            if (changed) {
+                std::vector<DeviceInfo> devices;
+                if (activeStreams_ > 0 || !rescan(devices, false)) {
+                    // 有活动流或借用者时不能重新初始化 PortAudio，待释放后再刷新；
+                    // 指纹保持不变，变化不会丢失
+                    pending = true;
+                    if (!stale) {
+                        stale = true;
+                        notify(Event::Stale);
+                    }
+                } else {
+                    stale = false;
+                    const bool listChanged = publish(std::move(devices), false);
+                    // 指纹变了但设备表未变：保留旧指纹，有限次数内继续重试
+                    if (listChanged || current == fingerprint || ++unchangedRescans >= kMaxUnchangedRescans) {
+                        fingerprint = current;
+                        unchangedRescans = 0;
+                        pending = false;
+                    } else {
+                        pending = true;
+                    }
+                }
+            }
+            lock.lock();
+        }
+    }
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    mutable std::condition_variable readyCv_;
+    std::thread worker_;
+    std::vector<DeviceInfo> devices_;
+    std::vector<VirtualEntry> virtualDevices_;
+    int nextVirtualIndex_ = kVirtualDeviceIndexBase;
+    std::atomic<int> activeStreams_{0};
+    int pollIntervalMs_ = 2000;
+    bool running_ = false;
+    bool ready_ = false;
+    bool rescanRequested_ = false;
+    // 以下仅在持有 portAudioMutex 时访问
+    bool paHeld_ = false;     // 注册表持有一次 Pa_Initialize
+    bool paPinned_ = false;   // 工作线程运行期间保持 PortAudio 初始化
+    int paBorrowers_ = 0;     // 借用 PortAudio 的模块数
+
+    std::mutex listenerMutex_;
+    std::vector<std::pair<int, Listener>> listeners_;
+    int nextListenerId_ = 1;
+};
+
+//==============================================================================
+// DeviceRegistry 类公共接口实现
+//==============================================================================
+
+DeviceRegistry& DeviceRegistry::getInstance() {
+    static DeviceRegistry instance;
+    return instance;
+}
+
+DeviceRegistry::DeviceRegistry() : impl_(std::make_unique<Impl>()) {}
+DeviceRegistry::~DeviceRegistry() = default;
+
+void DeviceRegistry::start(int pollIntervalMs) { impl_->start(pollIntervalMs); }
+void DeviceRegistry::stop() { impl_->stop(); }
+bool DeviceRegistry::isReady() const { return impl_->isReady(); }
+bool DeviceRegistry::waitUntilReady(int timeoutMs) const { return impl_->waitUntilReady(timeoutMs); }
+std::vector<DeviceInfo> DeviceRegistry::getDevices() const { return impl_->getDevices(); }
+std::vector<DeviceInfo> DeviceRegistry::getInputDevices() const { return impl_->getInputDevices(); }
+bool DeviceRegistry::findByName(const std::string& name, DeviceInfo& device) const { return impl_->findByName(name, device); }
+DeviceInfo DeviceRegistry::getFallbackInputDevice(const DeviceInfo& lost, int minChannels) const {
+    return impl_->getFallbackInputDevice(lost, minChannels);
+}
+bool DeviceRegistry::addVirtualDevice(const VirtualDeviceConfig& config, DeviceInfo& device, std::string& error) {
+    return impl_->addVirtualDevice(config, device, error);
+}
+bool DeviceRegistry::removeVirtualDevice(const std::string& name) { return impl_->removeVirtualDevice(name); }
+bool DeviceRegistry::getVirtualDevice(int index, VirtualDeviceConfig& config) const {
+    return impl_->getVirtualDevice(index, config);
+}
+void DeviceRegistry::requestRescan() { impl_->requestRescan(); }
+void DeviceRegistry::retainStream() { impl_->retainStream(); }
+void DeviceRegistry::releaseStream() { impl_->releaseStream(); }
+bool DeviceRegistry::acquirePortAudio(std::string* error) { return impl_->acquirePortAudio(error); }
+void DeviceRegistry::releasePortAudio() { impl_->releasePortAudio(); }
+int DeviceRegistry::addListener(Listener listener) { return impl_->addListener(std::move(listener)); }
+void DeviceRegistry::removeListener(int id) { impl_->removeListener(id); }
+
+//==============================================================================
+// PortAudioLease 类实现
+//==============================================================================
+
+bool PortAudioLease::acquire(std::string* error) {
+    if (!held_) {
+        held_ = DeviceRegistry::getInstance().acquirePortAudio(error);
+    }
+    return held_;
+}
+
+void PortAudioLease::reset() {
+    if (held_) {
+        held_ = false;
+        DeviceRegistry::getInstance().releasePortAudio();
+    }
+}
+
+} // namespace audio
+} // namespace perfx
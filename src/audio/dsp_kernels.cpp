@@ -0,0 +1,645 @@
+/**
+ * @file dsp_kernels.cpp
+ * @brief DSP 内核的标量实现、运行时分发与基准测试
+ */
+
+#include "../../include/audio/dsp_kernels.h"
+#include "dsp_kernels_internal.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#if defined(PERFX_DSP_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace perfx {
+namespace audio {
+namespace dsp {
+namespace detail {
+
+//-----------------------------------------------------------------------------
+// 标量实现（所有后端的参考实现，也用于处理 SIMD 循环的尾部）
+//-----------------------------------------------------------------------------
+
+static void scalarInt16ToFloat(const int16_t* in, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<float>(in[i]) * (1.0f / 32768.0f);
+    }
+}
+
+static void scalarFloatToInt16(const float* in, int16_t* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        float s = in[i];
+        if (s != s) {
+            s = 0.0f;
+        }
+        s = std::min(1.0f, std::max(-1.0f, s));
+        out[i] = static_cast<int16_t>(std::lrint(s * 32767.0f));
+    }
+}
+
+static void scalarInt24ToFloat(const uint8_t* in, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t* p = in + i * 3;
+        int32_t v = static_cast<int32_t>(static_cast<uint32_t>(p[0]) |
+                                         (static_cast<uint32_t>(p[1]) << 8) |
+                                         (static_cast<uint32_t>(p[2]) << 16));
+        if (v & 0x800000) {
+            v -= 0x1000000;
+        }
+        out[i] = static_cast<float>(v) * (1.0f / 8388608.0f);
+    }
+}
+
+static void scalarFloatToInt24(const float* in, uint8_t* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        float s = in[i];
+        if (s != s) {
+            s = 0.0f;
+        }
+        s = std::min(1.0f, std::max(-1.0f, s));
+        int32_t v = static_cast<int32_t>(std::lrint(s * 8388607.0f));
+        uint8_t* p = out + i * 3;
+        p[0] = static_cast<uint8_t>(v & 0xFF);
+        p[1] = static_cast<uint8_t>((v >> 8) & 0xFF);
+        p[2] = static_cast<uint8_t>((v >> 16) & 0xFF);
+    }
+}
+
+static void scalarInt32ToFloat(const int32_t* in, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<float>(in[i]) * (1.0f / 2147483648.0f);
+    }
+}
+
+static void scalarFloatToInt32(const float* in, int32_t* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        float s = in[i];
+        if (s != s) {
+            s = 0.0f;
+        }
+        s = std::min(kInt32MaxFloat, std::max(-2147483648.0f, s * 2147483648.0f));
+        out[i] = static_cast<int32_t>(std::lrint(s));
+    }
+}
+
+static void scalarFloatToDouble(const float* in, double* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<double>(in[i]);
+    }
+}
+
+static void scalarDoubleToFloat(const double* in, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<float>(in[i]);
+    }
+}
+
+static void scalarInterleaveStereo(const float* left, const float* right, float* out, size_t frames) {
+    for (size_t i = 0; i < frames; ++i) {
+        out[2 * i] = left[i];
+        out[2 * i + 1] = right[i];
+    }
+}
+
+static void scalarDeinterleaveStereo(const float* in, float* left, float* right, size_t frames) {
+    for (size_t i = 0; i < frames; ++i) {
+        left[i] = in[2 * i];
+        right[i] = in[2 * i + 1];
+    }
+}
+
+static void scalarDownmixStereoFloat(const float* in, float* out, size_t frames) {
+    for (size_t i = 0; i < frames; ++i) {
+        out[i] = (in[2 * i] + in[2 * i + 1]) * 0.5f;
+    }
+}
+
+static void scalarDownmixStereoInt16(const int16_t* in, int16_t* out, size_t frames) {
+    for (size_t i = 0; i < frames; ++i) {
+        int32_t sum = static_cast<int32_t>(in[2 * i]) + static_cast<int32_t>(in[2 * i + 1]);
+        out[i] = static_cast<int16_t>(sum >> 1);
+    }
+}
+
+static void scalarDeinterleaveStereoInt16(const int16_t* in, int16_t* left, int16_t* right, size_t frames) {
+    for (size_t i = 0; i < frames; ++i) {
+        left[i] = in[2 * i];
+        right[i] = in[2 * i + 1];
+    }
+}
+
+static void scalarDeinterleaveQuadInt16(const int16_t* in, int16_t* const* planes, size_t frames) {
+    for (size_t i = 0; i < frames; ++i) {
+        for (int ch = 0; ch < 4; ++ch) {
+            planes[ch][i] = in[4 * i + ch];
+        }
+    }
+}
+
+static void scalarDeinterleaveOctInt16(const int16_t* in, int16_t* const* planes, size_t frames) {
+    for (size_t i = 0; i < frames; ++i) {
+        for (int ch = 0; ch < 8; ++ch) {
+            planes[ch][i] = in[8 * i + ch];
+        }
+    }
+}
+
+static void scalarApplyGain(float* samples, size_t count, float gain) {
+    for (size_t i = 0; i < count; ++i) {
+        samples[i] *= gain;
+    }
+}
+
+static void scalarMeasureLevels(const float* samples, size_t count, float* peak, double* sumSquares) {
+    float p = *peak;
+    double sum = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        float a = std::fabs(samples[i]);
+        p = std::max(p, a);
+        sum += static_cast<double>(samples[i]) * samples[i];
+    }
+    *peak = p;
+    *sumSquares += sum;
+}
+
+static void scalarMeasureLevelsInt16(const int16_t* samples, size_t count, int32_t* peak, double* sumSquares) {
+    int32_t p = *peak;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        int32_t s = samples[i];
+        p = std::max(p, s < 0 ? -s : s);
+        sum += static_cast<uint64_t>(s * s);
+    }
+    *peak = p;
+    *sumSquares += static_cast<double>(sum);
+}
+
+static size_t scalarScrubNonFinite(float* samples, size_t count) {
+    size_t replaced = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!std::isfinite(samples[i])) {
+            samples[i] = 0.0f;
+            ++replaced;
+        }
+    }
+    return replaced;
+}
+
+const DspKernelTable* getScalarKernels() {
+    static const DspKernelTable table = {
+        "scalar",
+        scalarInt16ToFloat,
+        scalarFloatToInt16,
+        scalarInt24ToFloat,
+        scalarFloatToInt24,
+        scalarInt32ToFloat,
+        scalarFloatToInt32,
+        scalarFloatToDouble,
+        scalarDoubleToFloat,
+        scalarInterleaveStereo,
+        scalarDeinterleaveStereo,
+        scalarDownmixStereoFloat,
+        scalarDownmixStereoInt16,
+        scalarDeinterleaveStereoInt16,
+        scalarDeinterleaveQuadInt16,
+        scalarDeinterleaveOctInt16,
+        scalarApplyGain,
+        scalarMeasureLevels,
+        scalarMeasureLevelsInt16,
+        scalarScrubNonFinite
+    };
+    return &table;
+}
+
+} // namespace detail
+
+//-----------------------------------------------------------------------------
+// 运行时分发
+//-----------------------------------------------------------------------------
+
+namespace {
+
+using detail::DspKernelTable;
+
+bool cpuSupports(DspBackend backend) {
+    switch (backend) {
+        case DspBackend::SCALAR:
+            return true;
+#if defined(PERFX_DSP_X86)
+        case DspBackend::SSE2:
+#if defined(__x86_64__) || defined(_M_X64)
+            return true;  // x86-64 基线指令集
+#elif defined(_MSC_VER)
+        {
+            int info[4] = {0};
+            __cpuid(info, 1);
+            return (info[3] & (1 << 26)) != 0;
+        }
+#else
+            return __builtin_cpu_supports("sse2");
+#endif
+        case DspBackend::AVX2:
+#if defined(_MSC_VER)
+        {
+            int info[4] = {0};
+            __cpuid(info, 0);
+            if (info[0] < 7) {
+                return false;
+            }
+            __cpuid(info, 1);
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            const bool fma = (info[2] & (1 << 12)) != 0;
+            if (!osxsave || !fma || (_xgetbv(0) & 0x6) != 0x6) {
+                return false;
+            }
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+        }
+#else
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+#endif
+#if defined(PERFX_DSP_NEON)
+        case DspBackend::NEON:
+            return true;  // AArch64 基线指令集；32 位 ARM 需编译时启用 NEON
+#endif
+        default:
+            return false;
+    }
+}
+
+const DspKernelTable* tableFor(DspBackend backend) {
+    if (!cpuSupports(backend)) {
+        return nullptr;
+    }
+    switch (backend) {
+        case DspBackend::SCALAR: return detail::getScalarKernels();
+        case DspBackend::SSE2:   return detail::getSse2Kernels();
+        case DspBackend::AVX2:   return detail::getAvx2Kernels();
+        case DspBackend::NEON:   return detail::getNeonKernels();
+    }
+    return nullptr;
+}
+
+DspBackend detectBestBackend() {
+    const DspBackend order[] = {DspBackend::AVX2, DspBackend::SSE2, DspBackend::NEON};
+    for (DspBackend backend : order) {
+        if (tableFor(backend)) {
+            return backend;
+        }
+    }
+    return DspBackend::SCALAR;
+}
+
+struct Dispatch {
+    std::atomic<const DspKernelTable*> table;
+    std::atomic<DspBackend> backend;
+
+    Dispatch() {
+        DspBackend best = detectBestBackend();
+        backend.store(best);
+        table.store(tableFor(best));
+        std::cout << "[DSP] 使用内核实现: " << getBackendName(best) << std::endl;
+    }
+};
+
+Dispatch& dispatch() {
+    static Dispatch instance;
+    return instance;
+}
+
+inline const DspKernelTable& kernels() {
+    return *dispatch().table.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+DspBackend getActiveBackend() {
+    return dispatch().backend.load();
+}
+
+const char* getBackendName(DspBackend backend) {
+    switch (backend) {
+        case DspBackend::SCALAR: return "scalar";
+        case DspBackend::SSE2:   return "sse2";
+        case DspBackend::AVX2:   return "avx2";
+        case DspBackend::NEON:   return "neon";
+    }
+    return "unknown";
+}
+
+std::vector<DspBackend> getSupportedBackends() {
+    std::vector<DspBackend> result;
+    const DspBackend all[] = {DspBackend::SCALAR, DspBackend::SSE2, DspBackend::AVX2, DspBackend::NEON};
+    for (DspBackend backend : all) {
+        if (tableFor(backend)) {
+            result.push_back(backend);
+        }
+    }
+    return result;
+}
+
+bool setBackend(DspBackend backend) {
+    const DspKernelTable* table = tableFor(backend);
+    if (!table) {
+        return false;
+    }
+    dispatch().table.store(table);
+    dispatch().backend.store(backend);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// 公共接口
+//-----------------------------------------------------------------------------
+
+void int16ToFloat(const int16_t* in, float* out, size_t count) {
+    kernels().int16ToFloat(in, out, count);
+}
+
+void floatToInt16(const float* in, int16_t* out, size_t count) {
+    kernels().floatToInt16(in, out, count);
+}
+
+void int24ToFloat(const uint8_t* in, float* out, size_t count) {
+    kernels().int24ToFloat(in, out, count);
+}
+
+void floatToInt24(const float* in, uint8_t* out, size_t count) {
+    kernels().floatToInt24(in, out, count);
+}
+
+void int32ToFloat(const int32_t* in, float* out, size_t count) {
+    kernels().int32ToFloat(in, out, count);
+}
+
+void floatToInt32(const float* in, int32_t* out, size_t count) {
+    kernels().floatToInt32(in, out, count);
+}
+
+void floatToDouble(const float* in, double* out, size_t count) {
+    kernels().floatToDouble(in, out, count);
+}
+
+void doubleToFloat(const double* in, float* out, size_t count) {
+    kernels().doubleToFloat(in, out, count);
+}
+
+void interleave(const float* const* planes, float* out, int channels, size_t frames) {
+    if (channels == 2) {
+        kernels().interleaveStereo(planes[0], planes[1], out, frames);
+        return;
+    }
+    for (int ch = 0; ch < channels; ++ch) {
+        const float* plane = planes[ch];
+        for (size_t i = 0; i < frames; ++i) {
+            out[i * channels + ch] = plane[i];
+        }
+    }
+}
+
+void deinterleave(const float* in, float* const* planes, int channels, size_t frames) {
+    if (channels == 2) {
+        kernels().deinterleaveStereo(in, planes[0], planes[1], frames);
+        return;
+    }
+    for (int ch = 0; ch < channels; ++ch) {
+        float* plane = planes[ch];
+        for (size_t i = 0; i < frames; ++i) {
+            plane[i] = in[i * channels + ch];
+        }
+    }
+}
+
+void deinterleave(const int16_t* in, int16_t* const* planes, int channels, size_t frames) {
+    switch (channels) {
+        case 2:
+            kernels().deinterleaveStereoInt16(in, planes[0], planes[1], frames);
+            return;
+        case 4:
+            kernels().deinterleaveQuadInt16(in, planes, frames);
+            return;
+        case 8:
+            kernels().deinterleaveOctInt16(in, planes, frames);
+            return;
+        default:
+            break;
+    }
+    for (int ch = 0; ch < channels; ++ch) {
+        int16_t* plane = planes[ch];
+        for (size_t i = 0; i < frames; ++i) {
+            plane[i] = in[i * channels + ch];
+        }
+    }
+}
+
+void downmixToMono(const float* in, float* out, int channels, size_t frames) {
+    if (channels <= 1) {
+        if (in != out) {
+            std::memcpy(out, in, frames * sizeof(float));
+        }
+        return;
+    }
+    if (channels == 2) {
+        kernels().downmixStereoFloat(in, out, frames);
+        return;
+    }
+    const float scale = 1.0f / static_cast<float>(channels);
+    for (size_t i = 0; i < frames; ++i) {
+        float sum = 0.0f;
+        for (int ch = 0; ch < channels; ++ch) {
+            sum += in[i * channels + ch];
+        }
+        out[i] = sum * scale;
+    }
+}
+
+void downmixToMono(const int16_t* in, int16_t* out, int channels, size_t frames) {
+    if (channels <= 1) {
+        if (in != out) {
+            std::memcpy(out, in, frames * sizeof(int16_t));
+        }
+        return;
+    }
+    if (channels == 2) {
+        kernels().downmixStereoInt16(in, out, frames);
+        return;
+    }
+    for (size_t i = 0; i < frames; ++i) {
+        int32_t sum = 0;
+        for (int ch = 0; ch < channels; ++ch) {
+            sum += in[i * channels + ch];
+        }
+        out[i] = static_cast<int16_t>(sum / channels);
+    }
+}
+
+void applyGain(float* samples, size_t count, float gain) {
+    if (gain == 1.0f) {
+        return;
+    }
+    kernels().applyGain(samples, count, gain);
+}
+
+LevelInfo measureLevels(const float* samples, size_t count) {
+    LevelInfo info;
+    if (!samples || count == 0) {
+        return info;
+    }
+    float peak = 0.0f;
+    double sumSquares = 0.0;
+    kernels().measureLevels(samples, count, &peak, &sumSquares);
+    info.peak = std::min(1.0f, peak);
+    info.rms = static_cast<float>(std::sqrt(sumSquares / static_cast<double>(count)));
+    return info;
+}
+
+LevelInfo measureLevels(const int16_t* samples, size_t count) {
+    LevelInfo info;
+    if (!samples || count == 0) {
+        return info;
+    }
+    int32_t peak = 0;
+    double sumSquares = 0.0;
+    kernels().measureLevelsInt16(samples, count, &peak, &sumSquares);
+    info.peak = std::min(1.0f, static_cast<float>(peak) / 32768.0f);
+    info.rms = static_cast<float>(std::sqrt(sumSquares / static_cast<double>(count)) / 32768.0);
+    return info;
+}
+
+size_t scrubNonFinite(float* samples, size_t count) {
+    return kernels().scrubNonFinite(samples, count);
+}
+
+//-----------------------------------------------------------------------------
+// 基准测试
+//-----------------------------------------------------------------------------
+
+namespace {
+
+template <typename Fn>
+double measureNsPerSample(Fn&& fn, size_t samples, int iterations) {
+    fn();  // 预热缓存与分支预测
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    return ns / (static_cast<double>(samples) * iterations);
+}
+
+} // namespace
+
+std::vector<BenchmarkResult> runBenchmarks(size_t samples, int iterations) {
+    std::vector<BenchmarkResult> results;
+    if (samples == 0 || iterations <= 0) {
+        return results;
+    }
+
+    const DspBackend best = detectBestBackend();
+    const DspKernelTable& scalar = *detail::getScalarKernels();
+    const DspKernelTable& simd = *tableFor(best);
+
+    // 输入数据：[-1.2, 1.2] 的随机样本，覆盖饱和路径
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-1.2f, 1.2f);
+    std::vector<float> floatIn(samples * 2);
+    for (float& s : floatIn) {
+        s = dist(rng);
+    }
+    std::vector<int16_t> int16In(samples * 2);
+    std::vector<int32_t> int32In(samples);
+    std::vector<uint8_t> int24In(samples * 3);
+    scalar.floatToInt16(floatIn.data(), int16In.data(), int16In.size());
+    scalar.floatToInt32(floatIn.data(), int32In.data(), samples);
+    scalar.floatToInt24(floatIn.data(), int24In.data(), samples);
+
+    std::vector<float> floatOut(samples * 2);
+    std::vector<float> floatOut2(samples);
+    std::vector<int16_t> int16Out(samples);
+    // 拆分输出：8 个平面，每个平面最多容纳立体声拆分的 samples / 2 帧
+    const size_t planeStride = samples / 2 + 1;
+    std::vector<int16_t> int16Planes(planeStride * 8);
+    int16_t* planes[8];
+    for (size_t ch = 0; ch < 8; ++ch) {
+        planes[ch] = int16Planes.data() + ch * planeStride;
+    }
+    std::vector<int32_t> int32Out(samples);
+    std::vector<uint8_t> int24Out(samples * 3);
+    std::vector<double> doubleBuf(samples);
+    std::vector<float> work(samples);
+    scalar.floatToDouble(floatIn.data(), doubleBuf.data(), samples);
+
+    auto bench = [&](const char* name, auto&& run) {
+        BenchmarkResult r;
+        r.kernel = name;
+        r.backend = getBackendName(best);
+        r.scalarNsPerSample = measureNsPerSample([&] { run(scalar); }, samples, iterations);
+        r.simdNsPerSample = measureNsPerSample([&] { run(simd); }, samples, iterations);
+        r.speedup = r.simdNsPerSample > 0.0 ? r.scalarNsPerSample / r.simdNsPerSample : 0.0;
+        results.push_back(r);
+    };
+
+    bench("int16ToFloat", [&](const DspKernelTable& k) { k.int16ToFloat(int16In.data(), floatOut.data(), samples); });
+    bench("floatToInt16", [&](const DspKernelTable& k) { k.floatToInt16(floatIn.data(), int16Out.data(), samples); });
+    bench("int24ToFloat", [&](const DspKernelTable& k) { k.int24ToFloat(int24In.data(), floatOut.data(), samples); });
+    bench("floatToInt24", [&](const DspKernelTable& k) { k.floatToInt24(floatIn.data(), int24Out.data(), samples); });
+    bench("int32ToFloat", [&](const DspKernelTable& k) { k.int32ToFloat(int32In.data(), floatOut.data(), samples); });
+    bench("floatToInt32", [&](const DspKernelTable& k) { k.floatToInt32(floatIn.data(), int32Out.data(), samples); });
+    bench("floatToDouble", [&](const DspKernelTable& k) { k.floatToDouble(floatIn.data(), doubleBuf.data(), samples); });
+    bench("doubleToFloat", [&](const DspKernelTable& k) { k.doubleToFloat(doubleBuf.data(), floatOut.data(), samples); });
+    bench("interleaveStereo", [&](const DspKernelTable& k) {
+        k.interleaveStereo(floatIn.data(), floatIn.data() + samples, floatOut.data(), samples);
+    });
+    bench("deinterleaveStereo", [&](const DspKernelTable& k) {
+        k.deinterleaveStereo(floatIn.data(), floatOut.data(), floatOut2.data(), samples);
+    });
+    bench("downmixStereoFloat", [&](const DspKernelTable& k) { k.downmixStereoFloat(floatIn.data(), floatOut.data(), samples); });
+    bench("downmixStereoInt16", [&](const DspKernelTable& k) { k.downmixStereoInt16(int16In.data(), int16Out.data(), samples); });
+    // 多声道拆分按输入样本总数计时：N 声道拆出 samples / N 帧
+    bench("deinterleaveStereoInt16", [&](const DspKernelTable& k) {
+        k.deinterleaveStereoInt16(int16In.data(), planes[0], planes[1], samples / 2);
+    });
+    bench("deinterleaveQuadInt16", [&](const DspKernelTable& k) { k.deinterleaveQuadInt16(int16In.data(), planes, samples / 4); });
+    bench("deinterleaveOctInt16", [&](const DspKernelTable& k) { k.deinterleaveOctInt16(int16In.data(), planes, samples / 8); });
+    bench("applyGain", [&](const DspKernelTable& k) {
+        std::memcpy(work.data(), floatIn.data(), samples * sizeof(float));
+        k.applyGain(work.data(), samples, 0.5f);
+    });
+    bench("measureLevels", [&](const DspKernelTable& k) {
+        float peak = 0.0f;
+        double sum = 0.0;
+        k.measureLevels(floatIn.data(), samples, &peak, &sum);
+    });
+    bench("measureLevelsInt16", [&](const DspKernelTable& k) {
+        int32_t peak = 0;
+        double sum = 0.0;
+        k.measureLevelsInt16(int16In.data(), samples, &peak, &sum);
+    });
+    bench("scrubNonFinite", [&](const DspKernelTable& k) {
+        std::memcpy(work.data(), floatIn.data(), samples * sizeof(float));
+        k.scrubNonFinite(work.data(), samples);
+    });
+
+    std::cout << "[DSP] 基准测试: " << samples << " 样本 x " << iterations
+              << " 次, scalar vs " << getBackendName(best) << std::endl;
+    for (const auto& r : results) {
+        std::cout << "  " << std::left << std::setw(24) << r.kernel << std::right << std::fixed
+                  << std::setprecision(3) << std::setw(8) << r.scalarNsPerSample << " ns  "
+                  << std::setw(8) << r.simdNsPerSample << " ns  x"
+                  << std::setprecision(2) << r.speedup << std::endl;
+    }
+    return results;
+}
+
+} // namespace dsp
+} // namespace audio
+} // namespace perfx
@@ -0,0 +1,209 @@
+/**
+ * @file dsp_kernels_avx2.cpp
+ * @brief DSP 内核的 AVX2 实现
+ * @details 只覆盖宽度翻倍有明显收益的内核，其余沿用 SSE2 实现；
+ *          函数通过 target 属性单独启用 AVX2，整个库仍按基线指令集编译
+ */
+
+#include "dsp_kernels_internal.h"
+
+#if defined(PERFX_DSP_X86)
+#include <immintrin.h>
+#endif
+
+namespace perfx {
+namespace audio {
+namespace dsp {
+namespace detail {
+
+#if defined(PERFX_DSP_X86)
+
+namespace {
+
+// movemask 结果中置位的个数（popcnt 不属于 AVX2 的要求）
+inline int countMaskBits(unsigned mask) {
+    mask = mask - ((mask >> 1) & 0x55u);
+    mask = (mask & 0x33u) + ((mask >> 2) & 0x33u);
+    return static_cast<int>((mask + (mask >> 4)) & 0x0Fu);
+}
+
+PERFX_TARGET_AVX2
+inline __m256 zeroNaN(__m256 v) {
+    return _mm256_and_ps(v, _mm256_cmp_ps(v, v, _CMP_EQ_OQ));
+}
+
+PERFX_TARGET_AVX2
+void avx2Int16ToFloat(const int16_t* in, float* out, size_t count) {
+    const __m256 scale = _mm256_set1_ps(1.0f / 32768.0f);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i a = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+        __m256i b = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 8)));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(a), scale));
+        _mm256_storeu_ps(out + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(b), scale));
+    }
+    getSse2Kernels()->int16ToFloat(in + i, out + i, count - i);
+}
+
+PERFX_TARGET_AVX2
+void avx2FloatToInt16(const float* in, int16_t* out, size_t count) {
+    const __m256 lo = _mm256_set1_ps(-1.0f);
+    const __m256 hi = _mm256_set1_ps(1.0f);
+    const __m256 scale = _mm256_set1_ps(32767.0f);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256 a = _mm256_min_ps(_mm256_max_ps(zeroNaN(_mm256_loadu_ps(in + i)), lo), hi);
+        __m256 b = _mm256_min_ps(_mm256_max_ps(zeroNaN(_mm256_loadu_ps(in + i + 8)), lo), hi);
+        __m256i packed = _mm256_packs_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(a, scale)),
+                                            _mm256_cvtps_epi32(_mm256_mul_ps(b, scale)));
+        // packs 按 128 位通道交错，重排回顺序
+        packed = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+    }
+    getSse2Kernels()->floatToInt16(in + i, out + i, count - i);
+}
+
+PERFX_TARGET_AVX2
+void avx2Int32ToFloat(const int32_t* in, float* out, size_t count) {
+    const __m256 scale = _mm256_set1_ps(1.0f / 2147483648.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    getSse2Kernels()->int32ToFloat(in + i, out + i, count - i);
+}
+
+PERFX_TARGET_AVX2
+void avx2FloatToInt32(const float* in, int32_t* out, size_t count) {
+    const __m256 lo = _mm256_set1_ps(-2147483648.0f);
+    const __m256 hi = _mm256_set1_ps(kInt32MaxFloat);
+    const __m256 scale = _mm256_set1_ps(2147483648.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 v = _mm256_mul_ps(zeroNaN(_mm256_loadu_ps(in + i)), scale);
+        v = _mm256_min_ps(_mm256_max_ps(v, lo), hi);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_cvtps_epi32(v));
+    }
+    getSse2Kernels()->floatToInt32(in + i, out + i, count - i);
+}
+
+PERFX_TARGET_AVX2
+void avx2FloatToDouble(const float* in, double* out, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_pd(out + i, _mm256_cvtps_pd(_mm_loadu_ps(in + i)));
+        _mm256_storeu_pd(out + i + 4, _mm256_cvtps_pd(_mm_loadu_ps(in + i + 4)));
+    }
+    getSse2Kernels()->floatToDouble(in + i, out + i, count - i);
+}
+
+PERFX_TARGET_AVX2
+void avx2DownmixStereoFloat(const float* in, float* out, size_t frames) {
+    const __m256 half = _mm256_set1_ps(0.5f);
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        __m256 a = _mm256_loadu_ps(in + 2 * i);
+        __m256 b = _mm256_loadu_ps(in + 2 * i + 8);
+        // hadd 结果为 [a01 a23 b01 b23 | a45 a67 b45 b67]，重排 64 位块恢复顺序
+        __m256 sum = _mm256_hadd_ps(a, b);
+        sum = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(sum), _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(sum, half));
+    }
+    getSse2Kernels()->downmixStereoFloat(in + 2 * i, out + i, frames - i);
+}
+
+PERFX_TARGET_AVX2
+void avx2ApplyGain(float* samples, size_t count, float gain) {
+    const __m256 g = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        _mm256_storeu_ps(samples + i, _mm256_mul_ps(_mm256_loadu_ps(samples + i), g));
+        _mm256_storeu_ps(samples + i + 8, _mm256_mul_ps(_mm256_loadu_ps(samples + i + 8), g));
+    }
+    getSse2Kernels()->applyGain(samples + i, count - i, gain);
+}
+
+PERFX_TARGET_AVX2
+void avx2MeasureLevels(const float* samples, size_t count, float* peak, double* sumSquares) {
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    __m256 vpeak = _mm256_set1_ps(*peak);
+    __m256d sumLo = _mm256_setzero_pd();
+    __m256d sumHi = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 v = _mm256_loadu_ps(samples + i);
+        vpeak = _mm256_max_ps(vpeak, _mm256_and_ps(v, absMask));
+        __m256d lo = _mm256_cvtps_pd(_mm256_castps256_ps128(v));
+        __m256d hi = _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1));
+        sumLo = _mm256_fmadd_pd(lo, lo, sumLo);
+        sumHi = _mm256_fmadd_pd(hi, hi, sumHi);
+    }
+
+    alignas(32) float peaks[8];
+    alignas(32) double sums[4];
+    _mm256_store_ps(peaks, vpeak);
+    _mm256_store_pd(sums, _mm256_add_pd(sumLo, sumHi));
+
+    float p = peaks[0];
+    for (int k = 1; k < 8; ++k) {
+        p = p > peaks[k] ? p : peaks[k];
+    }
+    *peak = p;
+    *sumSquares += (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    getSse2Kernels()->measureLevels(samples + i, count - i, peak, sumSquares);
+}
+
+PERFX_TARGET_AVX2
+size_t avx2ScrubNonFinite(float* samples, size_t count) {
+    const __m256 zero = _mm256_setzero_ps();
+    size_t replaced = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 v = _mm256_loadu_ps(samples + i);
+        __m256 finite = _mm256_cmp_ps(_mm256_sub_ps(v, v), zero, _CMP_EQ_OQ);
+        int mask = _mm256_movemask_ps(finite);
+        if (mask != 0xFF) {
+            _mm256_storeu_ps(samples + i, _mm256_and_ps(v, finite));
+            replaced += static_cast<size_t>(8 - countMaskBits(static_cast<unsigned>(mask)));
+        }
+    }
+    return replaced + getSse2Kernels()->scrubNonFinite(samples + i, count - i);
+}
+
+} // namespace
+
+const DspKernelTable* getAvx2Kernels() {
+    const DspKernelTable* sse2 = getSse2Kernels();
+    if (!sse2) {
+        return nullptr;
+    }
+    static const DspKernelTable table = [sse2] {
+        DspKernelTable t = *sse2;
+        t.name = "avx2";
+        t.int16ToFloat = avx2Int16ToFloat;
+        t.floatToInt16 = avx2FloatToInt16;
+        t.int32ToFloat = avx2Int32ToFloat;
+        t.floatToInt32 = avx2FloatToInt32;
+        t.floatToDouble = avx2FloatToDouble;
+        t.downmixStereoFloat = avx2DownmixStereoFloat;
+        t.applyGain = avx2ApplyGain;
+        t.measureLevels = avx2MeasureLevels;
+        t.scrubNonFinite = avx2ScrubNonFinite;
+        return t;
+    }();
+    return &table;
+}
+
+#else
+
+const DspKernelTable* getAvx2Kernels() {
+    return nullptr;
+}
+
+#endif
+
+} // namespace detail
+} // namespace dsp
+} // namespace audio
+} // namespace perfx
@@ -0,0 +1,71 @@
+#pragma once
+
+/**
+ * @file dsp_kernels_internal.h
+ * @brief DSP 内核分发表（仅供 dsp_kernels*.cpp 使用）
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PERFX_DSP_X86 1
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || (defined(__ARM_NEON) && defined(__arm__))
+#define PERFX_DSP_NEON 1
+#endif
+
+// GCC/Clang 使用函数级 target 属性，无需为单个源文件设置 -mavx2；MSVC 的内部函数无需额外开关
+#if defined(__GNUC__) || defined(__clang__)
+#define PERFX_TARGET_SSE2 __attribute__((target("sse2")))
+#define PERFX_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define PERFX_TARGET_SSE2
+#define PERFX_TARGET_AVX2
+#endif
+
+namespace perfx {
+namespace audio {
+namespace dsp {
+namespace detail {
+
+struct DspKernelTable {
+    const char* name;
+
+    void (*int16ToFloat)(const int16_t*, float*, size_t);
+    void (*floatToInt16)(const float*, int16_t*, size_t);
+    void (*int24ToFloat)(const uint8_t*, float*, size_t);
+    void (*floatToInt24)(const float*, uint8_t*, size_t);
+    void (*int32ToFloat)(const int32_t*, float*, size_t);
+    void (*floatToInt32)(const float*, int32_t*, size_t);
+    void (*floatToDouble)(const float*, double*, size_t);
+    void (*doubleToFloat)(const double*, float*, size_t);
+
+    void (*interleaveStereo)(const float*, const float*, float*, size_t);
+    void (*deinterleaveStereo)(const float*, float*, float*, size_t);
+    void (*downmixStereoFloat)(const float*, float*, size_t);
+    void (*downmixStereoInt16)(const int16_t*, int16_t*, size_t);
+    void (*deinterleaveStereoInt16)(const int16_t*, int16_t*, int16_t*, size_t);
+    void (*deinterleaveQuadInt16)(const int16_t*, int16_t* const*, size_t);
+    void (*deinterleaveOctInt16)(const int16_t*, int16_t* const*, size_t);
+
+    void (*applyGain)(float*, size_t, float);
+    void (*measureLevels)(const float*, size_t, float*, double*);
+    void (*measureLevelsInt16)(const int16_t*, size_t, int32_t*, double*);
+    size_t (*scrubNonFinite)(float*, size_t);
+};
+
+// 各实现返回完整的分发表；未编译对应指令集时返回 nullptr
+const DspKernelTable* getScalarKernels();
+const DspKernelTable* getSse2Kernels();
+const DspKernelTable* getAvx2Kernels();
+const DspKernelTable* getNeonKernels();
+
+// 浮点转整数时使用的上界（最接近 2^31 且小于它的 float）
+constexpr float kInt32MaxFloat = 2147483520.0f;
+
+} // namespace detail
+} // namespace dsp
+} // namespace audio
+} // namespace perfx
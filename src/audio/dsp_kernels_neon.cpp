@@ -0,0 +1,331 @@
+/**
+ * @file dsp_kernels_neon.cpp
+ * @brief DSP 内核的 NEON 实现（ARM / Apple Silicon）
+ * @details INT24 紧凑格式沿用标量实现；float64 转换仅在 AArch64 上向量化
+ */
+
+#include "dsp_kernels_internal.h"
+
+#if defined(PERFX_DSP_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace perfx {
+namespace audio {
+namespace dsp {
+namespace detail {
+
+#if defined(PERFX_DSP_NEON)
+
+namespace {
+
+inline float32x4_t zeroNaN(float32x4_t v) {
+    return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(v), vceqq_f32(v, v)));
+}
+
+void neonInt16ToFloat(const int16_t* in, float* out, size_t count) {
+    const float32x4_t scale = vdupq_n_f32(1.0f / 32768.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t v = vld1q_s16(in + i);
+        vst1q_f32(out + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+        vst1q_f32(out + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+    }
+    getScalarKernels()->int16ToFloat(in + i, out + i, count - i);
+}
+
+// AArch64 上与 SSE/AVX 的 cvtps 及标量 lrint 一致（就近舍入、偶数优先）；ARMv7 退化为四舍五入
+inline int32x4_t roundToInt(float32x4_t v) {
+#if defined(__aarch64__) || defined(_M_ARM64)
+    return vcvtnq_s32_f32(v);
+#else
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    const uint32x4_t negative = vcltq_f32(v, vdupq_n_f32(0.0f));
+    float32x4_t bias = vbslq_f32(negative, vnegq_f32(half), half);
+    return vcvtq_s32_f32(vaddq_f32(v, bias));
+#endif
+}
+
+void neonFloatToInt16(const float* in, int16_t* out, size_t count) {
+    const float32x4_t lo = vdupq_n_f32(-1.0f);
+    const float32x4_t hi = vdupq_n_f32(1.0f);
+    const float32x4_t scale = vdupq_n_f32(32767.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        float32x4_t a = vminq_f32(vmaxq_f32(zeroNaN(vld1q_f32(in + i)), lo), hi);
+        float32x4_t b = vminq_f32(vmaxq_f32(zeroNaN(vld1q_f32(in + i + 4)), lo), hi);
+        int16x4_t ia = vqmovn_s32(roundToInt(vmulq_f32(a, scale)));
+        int16x4_t ib = vqmovn_s32(roundToInt(vmulq_f32(b, scale)));
+        vst1q_s16(out + i, vcombine_s16(ia, ib));
+    }
+    getScalarKernels()->floatToInt16(in + i, out + i, count - i);
+}
+
+void neonInt32ToFloat(const int32_t* in, float* out, size_t count) {
+    const float32x4_t scale = vdupq_n_f32(1.0f / 2147483648.0f);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(out + i, vmulq_f32(vcvtq_f32_s32(vld1q_s32(in + i)), scale));
+    }
+    getScalarKernels()->int32ToFloat(in + i, out + i, count - i);
+}
+
+void neonFloatToInt32(const float* in, int32_t* out, size_t count) {
+    const float32x4_t lo = vdupq_n_f32(-2147483648.0f);
+    const float32x4_t hi = vdupq_n_f32(kInt32MaxFloat);
+    const float32x4_t scale = vdupq_n_f32(2147483648.0f);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t v = vmulq_f32(zeroNaN(vld1q_f32(in + i)), scale);
+        v = vminq_f32(vmaxq_f32(v, lo), hi);
+        vst1q_s32(out + i, roundToInt(v));
+    }
+    getScalarKernels()->floatToInt32(in + i, out + i, count - i);
+}
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+void neonFloatToDouble(const float* in, double* out, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t v = vld1q_f32(in + i);
+        vst1q_f64(out + i, vcvt_f64_f32(vget_low_f32(v)));
+        vst1q_f64(out + i + 2, vcvt_high_f64_f32(v));
+    }
+    getScalarKernels()->floatToDouble(in + i, out + i, count - i);
+}
+
+void neonDoubleToFloat(const double* in, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x2_t a = vcvt_f32_f64(vld1q_f64(in + i));
+        float32x2_t b = vcvt_f32_f64(vld1q_f64(in + i + 2));
+        vst1q_f32(out + i, vcombine_f32(a, b));
+    }
+    getScalarKernels()->doubleToFloat(in + i, out + i, count - i);
+}
+#endif
+
+void neonInterleaveStereo(const float* left, const float* right, float* out, size_t frames) {
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        float32x4x2_t v;
+        v.val[0] = vld1q_f32(left + i);
+        v.val[1] = vld1q_f32(right + i);
+        vst2q_f32(out + 2 * i, v);
+    }
+    getScalarKernels()->interleaveStereo(left + i, right + i, out + 2 * i, frames - i);
+}
+
+void neonDeinterleaveStereo(const float* in, float* left, float* right, size_t frames) {
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        float32x4x2_t v = vld2q_f32(in + 2 * i);
+        vst1q_f32(left + i, v.val[0]);
+        vst1q_f32(right + i, v.val[1]);
+    }
+    getScalarKernels()->deinterleaveStereo(in + 2 * i, left + i, right + i, frames - i);
+}
+
+void neonDownmixStereoFloat(const float* in, float* out, size_t frames) {
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        float32x4x2_t v = vld2q_f32(in + 2 * i);
+        vst1q_f32(out + i, vmulq_f32(vaddq_f32(v.val[0], v.val[1]), half));
+    }
+    getScalarKernels()->downmixStereoFloat(in + 2 * i, out + i, frames - i);
+}
+
+void neonDownmixStereoInt16(const int16_t* in, int16_t* out, size_t frames) {
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        // vhaddq 计算 (a + b) >> 1，中间结果不溢出
+        int16x8x2_t v = vld2q_s16(in + 2 * i);
+        vst1q_s16(out + i, vhaddq_s16(v.val[0], v.val[1]));
+    }
+    getScalarKernels()->downmixStereoInt16(in + 2 * i, out + i, frames - i);
+}
+
+void neonDeinterleaveStereoInt16(const int16_t* in, int16_t* left, int16_t* right, size_t frames) {
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        int16x8x2_t v = vld2q_s16(in + 2 * i);
+        vst1q_s16(left + i, v.val[0]);
+        vst1q_s16(right + i, v.val[1]);
+    }
+    getScalarKernels()->deinterleaveStereoInt16(in + 2 * i, left + i, right + i, frames - i);
+}
+
+void neonDeinterleaveQuadInt16(const int16_t* in, int16_t* const* planes, size_t frames) {
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        int16x8x4_t v = vld4q_s16(in + 4 * i);
+        for (int ch = 0; ch < 4; ++ch) {
+            vst1q_s16(planes[ch] + i, v.val[ch]);
+        }
+    }
+    if (i < frames) {
+        int16_t* const rest[4] = {planes[0] + i, planes[1] + i, planes[2] + i, planes[3] + i};
+        getScalarKernels()->deinterleaveQuadInt16(in + 4 * i, rest, frames - i);
+    }
+}
+
+void neonDeinterleaveOctInt16(const int16_t* in, int16_t* const* planes, size_t frames) {
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        // vld4 按 4 路拆分后，第 k 路的偶数位为声道 k、奇数位为声道 k + 4，再用 uzp 分开
+        int16x8x4_t a = vld4q_s16(in + 8 * i);
+        int16x8x4_t b = vld4q_s16(in + 8 * i + 32);
+        for (int ch = 0; ch < 4; ++ch) {
+            int16x8x2_t v = vuzpq_s16(a.val[ch], b.val[ch]);
+            vst1q_s16(planes[ch] + i, v.val[0]);
+            vst1q_s16(planes[ch + 4] + i, v.val[1]);
+        }
+    }
+    if (i < frames) {
+        int16_t* rest[8];
+        for (int k = 0; k < 8; ++k) {
+            rest[k] = planes[k] + i;
+        }
+        getScalarKernels()->deinterleaveOctInt16(in + 8 * i, rest, frames - i);
+    }
+}
+
+void neonApplyGain(float* samples, size_t count, float gain) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        vst1q_f32(samples + i, vmulq_n_f32(vld1q_f32(samples + i), gain));
+        vst1q_f32(samples + i + 4, vmulq_n_f32(vld1q_f32(samples + i + 4), gain));
+    }
+    getScalarKernels()->applyGain(samples + i, count - i, gain);
+}
+
+void neonMeasureLevels(const float* samples, size_t count, float* peak, double* sumSquares) {
+    float32x4_t vpeak = vdupq_n_f32(*peak);
+    size_t i = 0;
+#if defined(__aarch64__) || defined(_M_ARM64)
+    float64x2_t sumLo = vdupq_n_f64(0.0);
+    float64x2_t sumHi = vdupq_n_f64(0.0);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t v = vld1q_f32(samples + i);
+        vpeak = vmaxq_f32(vpeak, vabsq_f32(v));
+        float64x2_t lo = vcvt_f64_f32(vget_low_f32(v));
+        float64x2_t hi = vcvt_high_f64_f32(v);
+        sumLo = vfmaq_f64(sumLo, lo, lo);
+        sumHi = vfmaq_f64(sumHi, hi, hi);
+    }
+    *sumSquares += vaddvq_f64(vaddq_f64(sumLo, sumHi));
+    *peak = vmaxvq_f32(vpeak);
+#else
+    // 32 位 ARM 没有双精度向量，按块累加单精度后再并入双精度总和
+    while (i + 4 <= count) {
+        float32x4_t blockSum = vdupq_n_f32(0.0f);
+        size_t end = i + 1024 < count ? i + 1024 : count;
+        for (; i + 4 <= end; i += 4) {
+            float32x4_t v = vld1q_f32(samples + i);
+            vpeak = vmaxq_f32(vpeak, vabsq_f32(v));
+            blockSum = vmlaq_f32(blockSum, v, v);
+        }
+        float32x2_t s = vadd_f32(vget_low_f32(blockSum), vget_high_f32(blockSum));
+        *sumSquares += static_cast<double>(vget_lane_f32(s, 0)) + vget_lane_f32(s, 1);
+    }
+    float32x2_t p = vpmax_f32(vget_low_f32(vpeak), vget_high_f32(vpeak));
+    p = vpmax_f32(p, p);
+    *peak = vget_lane_f32(p, 0);
+#endif
+    getScalarKernels()->measureLevels(samples + i, count - i, peak, sumSquares);
+}
+
+void neonMeasureLevelsInt16(const int16_t* samples, size_t count, int32_t* peak, double* sumSquares) {
+    // 分别跟踪最大/最小值，避免对 -32768 取绝对值溢出
+    int16x8_t vmax = vdupq_n_s16(0);
+    int16x8_t vmin = vdupq_n_s16(0);
+    uint64x2_t sum = vdupq_n_u64(0);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t v = vld1q_s16(samples + i);
+        vmax = vmaxq_s16(vmax, v);
+        vmin = vminq_s16(vmin, v);
+        int32x4_t lo = vmull_s16(vget_low_s16(v), vget_low_s16(v));
+        int32x4_t hi = vmull_s16(vget_high_s16(v), vget_high_s16(v));
+        sum = vpadalq_u32(sum, vreinterpretq_u32_s32(lo));
+        sum = vpadalq_u32(sum, vreinterpretq_u32_s32(hi));
+    }
+
+    int16_t maxs[8];
+    int16_t mins[8];
+    vst1q_s16(maxs, vmax);
+    vst1q_s16(mins, vmin);
+    int32_t p = *peak;
+    for (int k = 0; k < 8; ++k) {
+        int32_t hiAbs = maxs[k];
+        int32_t loAbs = -static_cast<int32_t>(mins[k]);
+        p = p > hiAbs ? p : hiAbs;
+        p = p > loAbs ? p : loAbs;
+    }
+    *peak = p;
+    *sumSquares += static_cast<double>(vgetq_lane_u64(sum, 0) + vgetq_lane_u64(sum, 1));
+    getScalarKernels()->measureLevelsInt16(samples + i, count - i, peak, sumSquares);
+}
+
+size_t neonScrubNonFinite(float* samples, size_t count) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    size_t replaced = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t v = vld1q_f32(samples + i);
+        uint32x4_t finite = vceqq_f32(vsubq_f32(v, v), zero);
+        // 每个非有限样本对应的通道为 1
+        uint32x4_t bad = vshrq_n_u32(vmvnq_u32(finite), 31);
+        uint32x2_t folded = vadd_u32(vget_low_u32(bad), vget_high_u32(bad));
+        uint32_t n = vget_lane_u32(vpadd_u32(folded, folded), 0);
+        if (n != 0) {
+            vst1q_f32(samples + i, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(v), finite)));
+            replaced += n;
+        }
+    }
+    return replaced + getScalarKernels()->scrubNonFinite(samples + i, count - i);
+}
+
+} // namespace
+
+const DspKernelTable* getNeonKernels() {
+    static const DspKernelTable table = [] {
+        DspKernelTable t = *getScalarKernels();
+        t.name = "neon";
+        t.int16ToFloat = neonInt16ToFloat;
+        t.floatToInt16 = neonFloatToInt16;
+        t.int32ToFloat = neonInt32ToFloat;
+        t.floatToInt32 = neonFloatToInt32;
+#if defined(__aarch64__) || defined(_M_ARM64)
+        t.floatToDouble = neonFloatToDouble;
+        t.doubleToFloat = neonDoubleToFloat;
+#endif
+        t.interleaveStereo = neonInterleaveStereo;
+        t.deinterleaveStereo = neonDeinterleaveStereo;
+        t.downmixStereoFloat = neonDownmixStereoFloat;
+        t.downmixStereoInt16 = neonDownmixStereoInt16;
+        t.deinterleaveStereoInt16 = neonDeinterleaveStereoInt16;
+        t.deinterleaveQuadInt16 = neonDeinterleaveQuadInt16;
+        t.deinterleaveOctInt16 = neonDeinterleaveOctInt16;
+        t.applyGain = neonApplyGain;
+        t.measureLevels = neonMeasureLevels;
+        t.measureLevelsInt16 = neonMeasureLevelsInt16;
+        t.scrubNonFinite = neonScrubNonFinite;
+        return t;
+    }();
+    return &table;
+}
+
+#else
+
+const DspKernelTable* getNeonKernels() {
+    return nullptr;
+}
+
+#endif
+
+} // namespace detail
+} // namespace dsp
+} // namespace audio
+} // namespace perfx
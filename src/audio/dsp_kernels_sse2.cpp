@@ -0,0 +1,375 @@
+/**
+ * @file dsp_kernels_sse2.cpp
+ * @brief DSP 内核的 SSE2 实现
+ * @details INT24 紧凑格式无法高效向量化，沿用标量实现；各循环尾部交给标量实现处理
+ */
+
+#include "dsp_kernels_internal.h"
+
+#if defined(PERFX_DSP_X86)
+#include <emmintrin.h>
+#endif
+
+namespace perfx {
+namespace audio {
+namespace dsp {
+namespace detail {
+
+#if defined(PERFX_DSP_X86)
+
+namespace {
+
+// movemask 结果中置位的个数
+const int kMaskBits[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+PERFX_TARGET_SSE2
+inline __m128 zeroNaN(__m128 v) {
+    return _mm_and_ps(v, _mm_cmpeq_ps(v, v));
+}
+
+PERFX_TARGET_SSE2
+void sse2Int16ToFloat(const int16_t* in, float* out, size_t count) {
+    const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    getScalarKernels()->int16ToFloat(in + i, out + i, count - i);
+}
+
+PERFX_TARGET_SSE2
+void sse2FloatToInt16(const float* in, int16_t* out, size_t count) {
+    const __m128 lo = _mm_set1_ps(-1.0f);
+    const __m128 hi = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(32767.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128 a = _mm_min_ps(_mm_max_ps(zeroNaN(_mm_loadu_ps(in + i)), lo), hi);
+        __m128 b = _mm_min_ps(_mm_max_ps(zeroNaN(_mm_loadu_ps(in + i + 4)), lo), hi);
+        __m128i ia = _mm_cvtps_epi32(_mm_mul_ps(a, scale));
+        __m128i ib = _mm_cvtps_epi32(_mm_mul_ps(b, scale));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(ia, ib));
+    }
+    getScalarKernels()->floatToInt16(in + i, out + i, count - i);
+}
+
+PERFX_TARGET_SSE2
+void sse2Int32ToFloat(const int32_t* in, float* out, size_t count) {
+    const __m128 scale = _mm_set1_ps(1.0f / 2147483648.0f);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+    }
+    getScalarKernels()->int32ToFloat(in + i, out + i, count - i);
+}
+
+PERFX_TARGET_SSE2
+void sse2FloatToInt32(const float* in, int32_t* out, size_t count) {
+    const __m128 lo = _mm_set1_ps(-2147483648.0f);
+    const __m128 hi = _mm_set1_ps(kInt32MaxFloat);
+    const __m128 scale = _mm_set1_ps(2147483648.0f);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_mul_ps(zeroNaN(_mm_loadu_ps(in + i)), scale);
+        v = _mm_min_ps(_mm_max_ps(v, lo), hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_cvtps_epi32(v));
+    }
+    getScalarKernels()->floatToInt32(in + i, out + i, count - i);
+}
+
+PERFX_TARGET_SSE2
+void sse2FloatToDouble(const float* in, double* out, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_loadu_ps(in + i);
+        _mm_storeu_pd(out + i, _mm_cvtps_pd(v));
+        _mm_storeu_pd(out + i + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+    getScalarKernels()->floatToDouble(in + i, out + i, count - i);
+}
+
+PERFX_TARGET_SSE2
+void sse2DoubleToFloat(const double* in, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 a = _mm_cvtpd_ps(_mm_loadu_pd(in + i));
+        __m128 b = _mm_cvtpd_ps(_mm_loadu_pd(in + i + 2));
+        _mm_storeu_ps(out + i, _mm_movelh_ps(a, b));
+    }
+    getScalarKernels()->doubleToFloat(in + i, out + i, count - i);
+}
+
+PERFX_TARGET_SSE2
+void sse2InterleaveStereo(const float* left, const float* right, float* out, size_t frames) {
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        __m128 l = _mm_loadu_ps(left + i);
+        __m128 r = _mm_loadu_ps(right + i);
+        _mm_storeu_ps(out + 2 * i, _mm_unpacklo_ps(l, r));
+        _mm_storeu_ps(out + 2 * i + 4, _mm_unpackhi_ps(l, r));
+    }
+    getScalarKernels()->interleaveStereo(left + i, right + i, out + 2 * i, frames - i);
+}
+
+PERFX_TARGET_SSE2
+void sse2DeinterleaveStereo(const float* in, float* left, float* right, size_t frames) {
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        __m128 a = _mm_loadu_ps(in + 2 * i);
+        __m128 b = _mm_loadu_ps(in + 2 * i + 4);
+        _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+    getScalarKernels()->deinterleaveStereo(in + 2 * i, left + i, right + i, frames - i);
+}
+
+PERFX_TARGET_SSE2
+void sse2DownmixStereoFloat(const float* in, float* out, size_t frames) {
+    const __m128 half = _mm_set1_ps(0.5f);
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        __m128 a = _mm_loadu_ps(in + 2 * i);
+        __m128 b = _mm_loadu_ps(in + 2 * i + 4);
+        __m128 l = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 r = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_add_ps(l, r), half));
+    }
+    getScalarKernels()->downmixStereoFloat(in + 2 * i, out + i, frames - i);
+}
+
+PERFX_TARGET_SSE2
+void sse2DownmixStereoInt16(const int16_t* in, int16_t* out, size_t frames) {
+    const __m128i ones = _mm_set1_epi16(1);
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        // madd 将相邻的 L/R 相加为 32 位，不会溢出
+        __m128i a = _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i)), ones);
+        __m128i b = _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i + 8)), ones);
+        a = _mm_srai_epi32(a, 1);
+        b = _mm_srai_epi32(b, 1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(a, b));
+    }
+    getScalarKernels()->downmixStereoInt16(in + 2 * i, out + i, frames - i);
+}
+
+PERFX_TARGET_SSE2
+void sse2DeinterleaveStereoInt16(const int16_t* in, int16_t* left, int16_t* right, size_t frames) {
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        // 每个 32 位单元为一帧 [L R]：左移再算术右移取出 L，直接算术右移取出 R
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i + 8));
+        __m128i l = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+                                    _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+        __m128i r = _mm_packs_epi32(_mm_srai_epi32(a, 16), _mm_srai_epi32(b, 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(left + i), l);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(right + i), r);
+    }
+    getScalarKernels()->deinterleaveStereoInt16(in + 2 * i, left + i, right + i, frames - i);
+}
+
+PERFX_TARGET_SSE2
+void sse2DeinterleaveQuadInt16(const int16_t* in, int16_t* const* planes, size_t frames) {
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        // 8 帧 x 4 声道转置：两轮 16 位交错把同一声道的样本聚到一起，再按 64 位拼接
+        const __m128i* src = reinterpret_cast<const __m128i*>(in + 4 * i);
+        __m128i r0 = _mm_loadu_si128(src);
+        __m128i r1 = _mm_loadu_si128(src + 1);
+        __m128i r2 = _mm_loadu_si128(src + 2);
+        __m128i r3 = _mm_loadu_si128(src + 3);
+        __m128i a = _mm_unpacklo_epi16(r0, r1);
+        __m128i b = _mm_unpackhi_epi16(r0, r1);
+        __m128i c = _mm_unpacklo_epi16(r2, r3);
+        __m128i d = _mm_unpackhi_epi16(r2, r3);
+        __m128i e = _mm_unpacklo_epi16(a, b);
+        __m128i f = _mm_unpackhi_epi16(a, b);
+        __m128i g = _mm_unpacklo_epi16(c, d);
+        __m128i h = _mm_unpackhi_epi16(c, d);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(planes[0] + i), _mm_unpacklo_epi64(e, g));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(planes[1] + i), _mm_unpackhi_epi64(e, g));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(planes[2] + i), _mm_unpacklo_epi64(f, h));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(planes[3] + i), _mm_unpackhi_epi64(f, h));
+    }
+    if (i < frames) {
+        int16_t* const rest[4] = {planes[0] + i, planes[1] + i, planes[2] + i, planes[3] + i};
+        getScalarKernels()->deinterleaveQuadInt16(in + 4 * i, rest, frames - i);
+    }
+}
+
+PERFX_TARGET_SSE2
+void sse2DeinterleaveOctInt16(const int16_t* in, int16_t* const* planes, size_t frames) {
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        // 8x8 的 16 位矩阵转置：依次按 16 / 32 / 64 位交错
+        const __m128i* src = reinterpret_cast<const __m128i*>(in + 8 * i);
+        __m128i r[8];
+        for (int k = 0; k < 8; ++k) {
+            r[k] = _mm_loadu_si128(src + k);
+        }
+        __m128i a[8];
+        for (int k = 0; k < 4; ++k) {
+            a[2 * k] = _mm_unpacklo_epi16(r[2 * k], r[2 * k + 1]);
+            a[2 * k + 1] = _mm_unpackhi_epi16(r[2 * k], r[2 * k + 1]);
+        }
+        __m128i b[8];
+        for (int k = 0; k < 2; ++k) {
+            b[4 * k] = _mm_unpacklo_epi32(a[4 * k], a[4 * k + 2]);
+            b[4 * k + 1] = _mm_unpackhi_epi32(a[4 * k], a[4 * k + 2]);
+            b[4 * k + 2] = _mm_unpacklo_epi32(a[4 * k + 1], a[4 * k + 3]);
+            b[4 * k + 3] = _mm_unpackhi_epi32(a[4 * k + 1], a[4 * k + 3]);
+        }
+        for (int k = 0; k < 4; ++k) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(planes[2 * k] + i), _mm_unpacklo_epi64(b[k], b[k + 4]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(planes[2 * k + 1] + i), _mm_unpackhi_epi64(b[k], b[k + 4]));
+        }
+    }
+    if (i < frames) {
+        int16_t* rest[8];
+        for (int k = 0; k < 8; ++k) {
+            rest[k] = planes[k] + i;
+        }
+        getScalarKernels()->deinterleaveOctInt16(in + 8 * i, rest, frames - i);
+    }
+}
+
+PERFX_TARGET_SSE2
+void sse2ApplyGain(float* samples, size_t count, float gain) {
+    const __m128 g = _mm_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm_storeu_ps(samples + i, _mm_mul_ps(_mm_loadu_ps(samples + i), g));
+        _mm_storeu_ps(samples + i + 4, _mm_mul_ps(_mm_loadu_ps(samples + i + 4), g));
+    }
+    getScalarKernels()->applyGain(samples + i, count - i, gain);
+}
+
+PERFX_TARGET_SSE2
+void sse2MeasureLevels(const float* samples, size_t count, float* peak, double* sumSquares) {
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 vpeak = _mm_set1_ps(*peak);
+    __m128d sumLo = _mm_setzero_pd();
+    __m128d sumHi = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_loadu_ps(samples + i);
+        vpeak = _mm_max_ps(vpeak, _mm_and_ps(v, absMask));
+        __m128d lo = _mm_cvtps_pd(v);
+        __m128d hi = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+        sumLo = _mm_add_pd(sumLo, _mm_mul_pd(lo, lo));
+        sumHi = _mm_add_pd(sumHi, _mm_mul_pd(hi, hi));
+    }
+
+    alignas(16) float peaks[4];
+    alignas(16) double sums[2];
+    _mm_store_ps(peaks, vpeak);
+    _mm_store_pd(sums, _mm_add_pd(sumLo, sumHi));
+
+    float p = peaks[0];
+    for (int k = 1; k < 4; ++k) {
+        p = p > peaks[k] ? p : peaks[k];
+    }
+    *peak = p;
+    *sumSquares += sums[0] + sums[1];
+    getScalarKernels()->measureLevels(samples + i, count - i, peak, sumSquares);
+}
+
+PERFX_TARGET_SSE2
+void sse2MeasureLevelsInt16(const int16_t* samples, size_t count, int32_t* peak, double* sumSquares) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i vmax = zero;
+    __m128i vmin = zero;
+    __m128i sum = zero;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+        vmax = _mm_max_epi16(vmax, v);
+        vmin = _mm_min_epi16(vmin, v);
+        // 两个 -32768 的平方和为 2^31，按无符号解释后再扩展到 64 位累加
+        __m128i sq = _mm_madd_epi16(v, v);
+        sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(sq, zero));
+        sum = _mm_add_epi64(sum, _mm_unpackhi_epi32(sq, zero));
+    }
+
+    alignas(16) int16_t maxs[8];
+    alignas(16) int16_t mins[8];
+    alignas(16) uint64_t sums[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(maxs), vmax);
+    _mm_store_si128(reinterpret_cast<__m128i*>(mins), vmin);
+    _mm_store_si128(reinterpret_cast<__m128i*>(sums), sum);
+
+    int32_t p = *peak;
+    for (int k = 0; k < 8; ++k) {
+        int32_t hiAbs = maxs[k];
+        int32_t loAbs = -static_cast<int32_t>(mins[k]);
+        p = p > hiAbs ? p : hiAbs;
+        p = p > loAbs ? p : loAbs;
+    }
+    *peak = p;
+    *sumSquares += static_cast<double>(sums[0] + sums[1]);
+    getScalarKernels()->measureLevelsInt16(samples + i, count - i, peak, sumSquares);
+}
+
+PERFX_TARGET_SSE2
+size_t sse2ScrubNonFinite(float* samples, size_t count) {
+    const __m128 zero = _mm_setzero_ps();
+    size_t replaced = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_loadu_ps(samples + i);
+        // 有限值 x - x == 0；Inf - Inf 与 NaN 均为 NaN
+        __m128 finite = _mm_cmpeq_ps(_mm_sub_ps(v, v), zero);
+        int mask = _mm_movemask_ps(finite);
+        if (mask != 0xF) {
+            _mm_storeu_ps(samples + i, _mm_and_ps(v, finite));
+            replaced += static_cast<size_t>(4 - kMaskBits[mask]);
+        }
+    }
+    return replaced + getScalarKernels()->scrubNonFinite(samples + i, count - i);
+}
+
+} // namespace
+
+const DspKernelTable* getSse2Kernels() {
+    static const DspKernelTable table = [] {
+        DspKernelTable t = *getScalarKernels();
+        t.name = "sse2";
+        t.int16ToFloat = sse2Int16ToFloat;
+        t.floatToInt16 = sse2FloatToInt16;
+        t.int32ToFloat = sse2Int32ToFloat;
+        t.floatToInt32 = sse2FloatToInt32;
+        t.floatToDouble = sse2FloatToDouble;
+        t.doubleToFloat = sse2DoubleToFloat;
+        t.interleaveStereo = sse2InterleaveStereo;
+        t.deinterleaveStereo = sse2DeinterleaveStereo;
+        t.downmixStereoFloat = sse2DownmixStereoFloat;
+        t.downmixStereoInt16 = sse2DownmixStereoInt16;
+        t.deinterleaveStereoInt16 = sse2DeinterleaveStereoInt16;
+        t.deinterleaveQuadInt16 = sse2DeinterleaveQuadInt16;
+        t.deinterleaveOctInt16 = sse2DeinterleaveOctInt16;
+        t.applyGain = sse2ApplyGain;
+        t.measureLevels = sse2MeasureLevels;
+        t.measureLevelsInt16 = sse2MeasureLevelsInt16;
+        t.scrubNonFinite = sse2ScrubNonFinite;
+        return t;
+    }();
+    return &table;
+}
+
+#else
+
+const DspKernelTable* getSse2Kernels() {
+    return nullptr;
+}
+
+#endif
+
+} // namespace detail
+} // namespace dsp
+} // namespace audio
+} // namespace perfx
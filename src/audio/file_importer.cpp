@@ -1,32 +1,141 @@
 #include "audio/file_importer.h"
+#include "audio/content_hash.h"
+#include "audio/trace_events.h"
 #include <fstream>
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <sys/clonefile.h>
+#endif
 
 namespace perfx {
 namespace audio {
 
+namespace {
+
+// 内容存储目录（位于导入目标目录下）
+constexpr const char* kBlobDirName = ".blobs";
+
+#if defined(__linux__)
+
+/**
+ * @brief Linux: 先尝试 FICLONE（btrfs/xfs 等写时复制），不支持时用 copy_file_range 在内核内复制
+ */
+bool nativeClone(const std::string& sourcePath, const std::string& targetPath, std::string& method) {
+    int src = ::open(sourcePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (src < 0) {
+        return false;
+    }
+    struct stat st;
+    if (::fstat(src, &st) != 0) {
+        ::close(src);
+        return false;
+    }
+    int dst = ::open(targetPath.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, st.st_mode & 0666);
+    if (dst < 0) {
+        ::close(src);
+        return false;
+    }
+
+    bool ok = false;
+#ifdef FICLONE
+    if (::ioctl(dst, FICLONE, src) == 0) {
+        method = "reflink";
+        ok = true;
+    }
+#endif
+    if (!ok) {
+        off_t remaining = st.st_size;
+        ok = true;
+        while (remaining > 0) {
+            ssize_t copied = ::copy_file_range(src, nullptr, dst, nullptr, static_cast<size_t>(remaining), 0);
+            if (copied <= 0) {
+                ok = false;
+                break;
+            }
+            remaining -= copied;
+        }
+        if (ok) {
+            method = "copy_file_range";
+        }
+    }
+
+    ::close(src);
+    ::close(dst);
+    if (!ok) {
+        ::unlink(targetPath.c_str());
+    }
+    return ok;
+}
+
+#elif defined(__APPLE__)
+
+/**
+ * @brief macOS: APFS 上 clonefile 为写时复制
+ */
+bool nativeClone(const std::string& sourcePath, const std::string& targetPath, std::string& method) {
+    if (::clonefile(sourcePath.c_str(), targetPath.c_str(), 0) == 0) {
+        method = "reflink";
+        return true;
+    }
+    return false;
+}
+
+#else
+
+bool nativeClone(const std::string&, const std::string&, std::string&) {
+    return false;
+}
+
+#endif
+
+} // namespace
+
 FileImporter::FileImporter() = default;
 FileImporter::~FileImporter() = default;
 
+void FileImporter::setLastError(const std::string& error) {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    lastError_ = error;
+}
+
 bool FileImporter::isValidAudioFile(const std::string& filePath) {
+    std::string error;
+    if (!validateAudioFile(filePath, error)) {
+        setLastError(error);
+        return false;
+    }
+    return true;
+}
+
+bool FileImporter::validateAudioFile(const std::string& filePath, std::string& error) {
     // 检查文件是否存在
     if (!std::filesystem::exists(filePath)) {
-        lastError_ = "File does not exist: " + filePath;
+        error = "File does not exist: " + filePath;
         return false;
     }
 
     // 检查文件扩展名
     std::string extension = std::filesystem::path(filePath).extension().string();
     std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
-    
+
     // 支持的音频文件格式
     const std::vector<std::string> supportedFormats = {
         ".wav", ".mp3", ".ogg", ".flac", ".m4a", ".aac"
     };
 
     if (std::find(supportedFormats.begin(), supportedFormats.end(), extension) == supportedFormats.end()) {
-        lastError_ = "Unsupported audio format: " + extension;
+        error = "Unsupported audio format: " + extension;
         return false;
     }
 
@@ -34,7 +143,7 @@ bool FileImporter::isValidAudioFile(const std::string& filePath) {
     if (extension == ".wav") {
         std::ifstream file(filePath, std::ios::binary);
         if (!file.is_open()) {
-            lastError_ = "Failed to open file: " + filePath;
+            error = "Failed to open file: " + filePath;
             return false;
         }
 
@@ -44,7 +153,7 @@ bool FileImporter::isValidAudioFile(const std::string& filePath) {
 
         // 检查WAV文件头
         if (memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) {
-            lastError_ = "Invalid WAV file header";
+            error = "Invalid WAV file header";
             return false;
         }
     }
@@ -52,25 +161,28 @@ bool FileImporter::isValidAudioFile(const std::string& filePath) {
     return true;
 }
 
-bool FileImporter::createTargetDirectory(const std::string& dirPath) {
-    try {
-        if (!std::filesystem::exists(dirPath)) {
-            return std::filesystem::create_directories(dirPath);
-        }
-        return true;
-    } catch (const std::exception& e) {
-        lastError_ = std::string("Failed to create directory: ") + e.what();
+bool FileImporter::createTargetDirectory(const std::string& dirPath, std::string& error) {
+    std::error_code ec;
+    std::filesystem::create_directories(dirPath, ec);
+    if (ec) {
+        error = "Failed to create directory: " + ec.message();
         return false;
     }
+    return true;
 }
 
-bool FileImporter::copyFile(const std::string& sourcePath, const std::string& targetPath) {
+bool FileImporter::cloneFile(const std::string& sourcePath, const std::string& targetPath,
+                             std::string& method, std::string& error) {
+    if (nativeClone(sourcePath, targetPath, method)) {
+        return true;
+    }
     try {
-        std::filesystem::copy_file(sourcePath, targetPath, 
-                                 std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::copy_file(sourcePath, targetPath,
+                                   std::filesystem::copy_options::overwrite_existing);
+        method = "copy";
         return true;
     } catch (const std::exception& e) {
-        lastError_ = std::string("Failed to copy file: ") + e.what();
+        error = std::string("Failed to copy file: ") + e.what();
         return false;
     }
 }
@@ -78,60 +190,157 @@ bool FileImporter::copyFile(const std::string& sourcePath, const std::string& ta
 std::string FileImporter::getSavedFileDirectory(const std::string& sourcePath, const std::string& targetDir) const {
     // 获取文件名（不含扩展名）
     std::string fileName = std::filesystem::path(sourcePath).stem().string();
-    
+
     // 创建目标目录路径
     std::string targetPath = std::filesystem::path(targetDir) / fileName;
-    
+
     // 返回完整的目标目录路径
     return std::filesystem::absolute(targetPath).string();
 }
 
-bool FileImporter::importAudioFile(const std::string& sourcePath, const std::string& targetDir) {
+bool FileImporter::importOne(const std::string& sourcePath, const std::string& targetDir,
+                             unsigned hashThreads, ImportResult& result) {
+    namespace fs = std::filesystem;
+    result = ImportResult();
+    result.sourcePath = sourcePath;
+
     // 验证源文件
-    if (!isValidAudioFile(sourcePath)) {
+    if (!validateAudioFile(sourcePath, result.error)) {
         return false;
     }
 
-    // 获取文件名（不含扩展名）
-    std::string fileName = std::filesystem::path(sourcePath).stem().string();
-    
-    // 创建目标目录
-    std::string targetPath = std::filesystem::path(targetDir) / fileName;
-    if (!createTargetDirectory(targetPath)) {
+    // 1. 内容哈希（大文件分块并行）
+    result.contentHash = hashFileContent(sourcePath, &result.error, hashThreads);
+    if (result.contentHash.empty()) {
         return false;
     }
 
-    // 复制文件到目标目录
-    std::string targetFilePath = (std::filesystem::path(targetPath) / 
-                                std::filesystem::path(sourcePath).filename()).string();
-    
-    if (copyFile(sourcePath, targetFilePath)) {
-        // 显示保存目录信息
-        std::cout << "\n=== 文件保存信息 ===" << std::endl;
-        std::cout << "文件已保存到目录: " << targetPath << std::endl;
-        std::cout << "完整文件路径: " << targetFilePath << std::endl;
-        std::cout << "该目录将作为该文件的工作目录" << std::endl;
-        return true;
+    // 2. 写入内容存储：<targetDir>/.blobs/<前两位>/<哈希><扩展名>
+    std::string extension = fs::path(sourcePath).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    const fs::path blobDir = fs::path(targetDir) / kBlobDirName / result.contentHash.substr(0, 2);
+    const fs::path blobPath = blobDir / (result.contentHash + extension);
+    result.blobPath = blobPath.string();
+    if (!createTargetDirectory(blobDir.string(), result.error)) {
+        return false;
     }
-    
-    return false;
+
+    std::error_code ec;
+    if (fs::exists(blobPath, ec)) {
+        result.deduplicated = true;
+        result.method = "reused";
+    } else {
+        // 先写临时文件再重命名，并行导入相同内容时不会看到写了一半的文件
+        const fs::path tempPath = blobDir / (result.contentHash + ".tmp" +
+            std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())));
+        fs::remove(tempPath, ec);
+        if (!cloneFile(sourcePath, tempPath.string(), result.method, result.error)) {
+            fs::remove(tempPath, ec);
+            return false;
+        }
+        fs::rename(tempPath, blobPath, ec);
+        if (ec) {
+            result.error = "Failed to store imported file: " + ec.message();
+            fs::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    // 3. 工作目录中的文件从内容存储 reflink / 复制得到；不用硬链接，否则就地修改工作文件会改写
+    //    内容存储，进而影响所有去重到同一哈希的导入
+    const fs::path targetPath = fs::path(targetDir) / fs::path(sourcePath).stem();
+    if (!createTargetDirectory(targetPath.string(), result.error)) {
+        return false;
+    }
+    const fs::path targetFilePath = targetPath / fs::path(sourcePath).filename();
+    result.storedPath = targetFilePath.string();
+
+    // 已存在的工作文件（包括旧版本留下的硬链接）先删除再重新生成
+    fs::remove(targetFilePath, ec);
+    std::string workMethod;
+    if (!cloneFile(blobPath.string(), targetFilePath.string(), workMethod, result.error)) {
+        return false;
+    }
+    return true;
+}
+
+bool FileImporter::importAudioFile(const std::string& sourcePath, const std::string& targetDir,
+                                   ImportResult* result) {
+    ImportResult local;
+    ImportResult& r = result ? *result : local;
+    r.success = importOne(sourcePath, targetDir, 0, r);
+    if (!r.success) {
+        setLastError(r.error);
+        return false;
+    }
+
+    // 显示保存目录信息
+    std::cout << "\n=== 文件保存信息 ===" << std::endl;
+    std::cout << "文件已保存到目录: " << std::filesystem::path(r.storedPath).parent_path().string() << std::endl;
+    std::cout << "完整文件路径: " << r.storedPath << std::endl;
+    std::cout << "内容存储: " << r.blobPath << " (" << r.method << ")" << std::endl;
+    std::cout << "该目录将作为该文件的工作目录" << std::endl;
+    return true;
 }
 
-size_t FileImporter::importAudioFiles(const std::vector<std::string>& sourcePaths, 
-                                    const std::string& targetDir) {
-    size_t successCount = 0;
-    
-    for (const auto& sourcePath : sourcePaths) {
-        if (importAudioFile(sourcePath, targetDir)) {
-            successCount++;
-        } else {
-            std::cerr << "Failed to import file: " << sourcePath << std::endl;
-            std::cerr << "Error: " << lastError_ << std::endl;
+size_t FileImporter::importAudioFiles(const std::vector<std::string>& sourcePaths,
+                                    const std::string& targetDir,
+                                    const ImportProgressCallback& progress,
+                                    unsigned maxParallel) {
+    if (sourcePaths.empty()) {
+        return 0;
+    }
+
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    if (maxParallel == 0) {
+        maxParallel = std::min(hardware, 4u);
+    }
+    const unsigned workers = static_cast<unsigned>(std::min<size_t>(maxParallel, sourcePaths.size()));
+    // 文件级并行与块级并行共享 CPU，避免线程数相乘
+    const unsigned hashThreads = std::max(1u, hardware / workers);
+
+    std::atomic<size_t> nextIndex{0};
+    std::atomic<size_t> successCount{0};
+    std::mutex progressMutex;
+    size_t completed = 0;
+
+    auto worker = [&]() {
+        for (size_t index = nextIndex++; index < sourcePaths.size(); index = nextIndex++) {
+            ImportResult result;
+            {
+                PERFX_TRACE_SCOPE("audio.import_file");
+                result.success = importOne(sourcePaths[index], targetDir, hashThreads, result);
+            }
+
+            std::lock_guard<std::mutex> lock(progressMutex);
+            ++completed;
+            if (result.success) {
+                successCount++;
+            } else {
+                setLastError(result.error);
+                std::cerr << "Failed to import file: " << result.sourcePath << std::endl;
+                std::cerr << "Error: " << result.error << std::endl;
+            }
+            if (progress) {
+                progress(completed, sourcePaths.size(), result);
+            }
         }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < workers; ++i) {
+        pool.emplace_back([&worker]() {
+            trace::setThreadName("audio.importer");
+            worker();
+        });
     }
-    
+    worker();
+    for (auto& t : pool) {
+        t.join();
+    }
+
     return successCount;
 }
 
 } // namespace audio
-} // namespace perfx 
\ No newline at end of file
+} // namespace perfx
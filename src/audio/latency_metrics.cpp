@@ -0,0 +1,306 @@
+/**
+ * @file latency_metrics.cpp
+ * @brief 采集路径延迟 / xrun 指标注册表实现
+ */
+
+#include "../../include/audio/latency_metrics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace perfx {
+namespace audio {
+
+//------------------------------------------------------------------------------
+// 时间基准与线程局部采集时间
+//------------------------------------------------------------------------------
+
+namespace metrics {
+
+namespace {
+thread_local int64_t tlsCaptureNs = 0;
+}
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void setCurrentCaptureTime(int64_t captureNs) {
+    tlsCaptureNs = captureNs;
+}
+
+int64_t currentCaptureTime() {
+    return tlsCaptureNs;
+}
+
+} // namespace metrics
+
+//------------------------------------------------------------------------------
+// LatencyHistogram
+//------------------------------------------------------------------------------
+
+size_t LatencyHistogram::bucketIndex(uint64_t value) {
+    if (value < 8) {
+        return static_cast<size_t>(value);
+    }
+    int exponent = 63;
+    while (!(value & (uint64_t{1} << exponent))) {
+        --exponent;
+    }
+    const size_t sub = static_cast<size_t>((value >> (exponent - 2)) & 3u);
+    const size_t index = 8 + static_cast<size_t>(exponent - 3) * 4 + sub;
+    return std::min(index, kBucketCount - 1);
+}
+
+uint64_t LatencyHistogram::bucketLower(size_t index) {
+    if (index < 8) {
+        return index;
+    }
+    const int exponent = static_cast<int>((index - 8) / 4) + 3;
+    const uint64_t sub = (index - 8) % 4;
+    return (4 + sub) << (exponent - 2);
+}
+
+uint64_t LatencyHistogram::bucketUpper(size_t index) {
+    if (index < 8) {
+        return index;
+    }
+    return bucketLower(index) + (uint64_t{1} << ((index - 8) / 4 + 1)) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t current = min_.load(std::memory_order_relaxed);
+    while (value < current && !min_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+    current = max_.load(std::memory_order_relaxed);
+    while (value > current && !max_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(UINT64_MAX, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::percentile(double quantile) const {
+    const uint64_t total = count();
+    if (total == 0) {
+        return 0;
+    }
+    quantile = std::min(std::max(quantile, 0.0), 1.0);
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantile * total)));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            const uint64_t mid = bucketLower(i) + (bucketUpper(i) - bucketLower(i)) / 2;
+            return std::min(std::max(mid, min()), max());
+        }
+    }
+    return max();
+}
+
+uint64_t LatencyHistogram::min() const {
+    const uint64_t value = min_.load(std::memory_order_relaxed);
+    return value == UINT64_MAX ? 0 : value;
+}
+
+double LatencyHistogram::mean() const {
+    const uint64_t total = count();
+    return total > 0 ? static_cast<double>(sum_.load(std::memory_order_relaxed)) / static_cast<double>(total) : 0.0;
+}
+
+//------------------------------------------------------------------------------
+// MetricsRegistry
+//------------------------------------------------------------------------------
+
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::~MetricsRegistry() {
+    stopPeriodicDump();
+}
+
+LatencyHistogram& MetricsRegistry::histogram(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = histograms_[name];
+    if (!slot) {
+        slot = std::make_unique<LatencyHistogram>();
+    }
+    return *slot;
+}
+
+std::atomic<int64_t>& MetricsRegistry::counter(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = counters_[name];
+    if (!slot) {
+        slot = std::make_unique<std::atomic<int64_t>>(0);
+    }
+    return *slot;
+}
+
+MetricsSnapshot MetricsRegistry::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    MetricsSnapshot snapshot;
+    for (const auto& entry : histograms_) {
+        const LatencyHistogram& h = *entry.second;
+        HistogramSummary summary;
+        summary.name = entry.first;
+        summary.count = h.count();
+        summary.min = h.min();
+        summary.max = h.max();
+        summary.mean = h.mean();
+        summary.p50 = h.percentile(0.50);
+        summary.p90 = h.percentile(0.90);
+        summary.p99 = h.percentile(0.99);
+        snapshot.histograms.push_back(std::move(summary));
+    }
+    for (const auto& entry : counters_) {
+        snapshot.counters.emplace_back(entry.first, entry.second->load(std::memory_order_relaxed));
+    }
+    return snapshot;
+}
+
+std::string MetricsRegistry::formatReport() const {
+    MetricsSnapshot snap = snapshot();
+    std::ostringstream out;
+    out << "[METRICS] ---- latency / xrun report ----\n";
+    for (const auto& h : snap.histograms) {
+        if (h.count == 0) {
+            continue;
+        }
+        out << "[METRICS] " << std::left << std::setw(30) << h.name << std::right
+            << " n=" << h.count
+            << " min=" << h.min
+            << " p50=" << h.p50
+            << " p90=" << h.p90
+            << " p99=" << h.p99
+            << " max=" << h.max
+            << " mean=" << std::fixed << std::setprecision(1) << h.mean << "\n";
+    }
+    for (const auto& c : snap.counters) {
+        out << "[METRICS] " << std::left << std::setw(30) << c.first << std::right << " " << c.second << "\n";
+    }
+    return out.str();
+}
+
+void MetricsRegistry::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : histograms_) {
+        entry.second->reset();
+    }
+    for (auto& entry : counters_) {
+        entry.second->store(0, std::memory_order_relaxed);
+    }
+}
+
+void MetricsRegistry::startPeriodicDump(int intervalMs) {
+    if (intervalMs <= 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(dumpMutex_);
+    dumpIntervalMs_ = intervalMs;
+    if (dumpRunning_) {
+        dumpCv_.notify_all();
+        return;
+    }
+    dumpRunning_ = true;
+    dumpThread_ = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(dumpMutex_);
+        while (dumpRunning_) {
+            dumpCv_.wait_for(lock, std::chrono::milliseconds(dumpIntervalMs_));
+            if (!dumpRunning_) {
+                break;
+            }
+            lock.unlock();
+            std::cout << formatReport() << std::flush;
+            lock.lock();
+        }
+    });
+}
+
+void MetricsRegistry::stopPeriodicDump() {
+    {
+        std::lock_guard<std::mutex> lock(dumpMutex_);
+        if (!dumpRunning_) {
+            return;
+        }
+        dumpRunning_ = false;
+    }
+    dumpCv_.notify_all();
+    if (dumpThread_.joinable()) {
+        dumpThread_.join();
+    }
+}
+
+//------------------------------------------------------------------------------
+// UtteranceLatencyTracker
+//------------------------------------------------------------------------------
+
+UtteranceLatencyTracker::UtteranceLatencyTracker()
+    : micToPacket_(MetricsRegistry::instance().histogram(metrics::kMicToPacket)),
+      micToFirstPartial_(MetricsRegistry::instance().histogram(metrics::kMicToFirstPartial)),
+      packetsSent_(MetricsRegistry::instance().counter(metrics::kAsrPacketsSent)),
+      utterances_(MetricsRegistry::instance().counter(metrics::kAsrUtterances)) {}
+
+void UtteranceLatencyTracker::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    utteranceStartNs_ = 0;
+    partialReported_ = false;
+}
+
+void UtteranceLatencyTracker::onPacketSent(int64_t captureNs) {
+    packetsSent_.fetch_add(1, std::memory_order_relaxed);
+    if (captureNs <= 0) {
+        return;
+    }
+    const int64_t now = metrics::nowNs();
+    if (now > captureNs) {
+        micToPacket_.record(static_cast<uint64_t>((now - captureNs) / 1000));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (utteranceStartNs_ == 0) {
+        utteranceStartNs_ = captureNs;
+        partialReported_ = false;
+    }
+}
+
+void UtteranceLatencyTracker::onResult(bool hasText, bool definite) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (utteranceStartNs_ == 0) {
+        return;
+    }
+    if (hasText && !partialReported_) {
+        const int64_t now = metrics::nowNs();
+        if (now > utteranceStartNs_) {
+            micToFirstPartial_.record(static_cast<uint64_t>((now - utteranceStartNs_) / 1000));
+        }
+        partialReported_ = true;
+    }
+    if (definite) {
+        utterances_.fetch_add(1, std::memory_order_relaxed);
+        utteranceStartNs_ = 0;
+        partialReported_ = false;
+    }
+}
+
+} // namespace audio
+} // namespace perfx
@@ -0,0 +1,36 @@
+/**
+ * @file sample_pipeline.cpp
+ * @brief 采样格式转换函数表的实例选择
+ */
+
+#include "audio/sample_pipeline.h"
+#include <algorithm>
+
+namespace perfx {
+namespace audio {
+
+template <SampleFormat F>
+SampleConverter SampleConverter::forChannels(int channels) {
+    switch (channels) {
+        case 1: return make<F, MonoLayout>(channels);
+        case 2: return make<F, StereoLayout>(channels);
+        default: return make<F, DynamicLayout>(channels);
+    }
+}
+
+SampleConverter SampleConverter::create(SampleFormat format, int channels) {
+    // 中间缓冲按段处理，单帧必须能放进一段
+    channels = std::max(1, std::min(channels, static_cast<int>(pipeline::kChunkSamples)));
+
+    switch (format) {
+        case SampleFormat::INT16: return forChannels<SampleFormat::INT16>(channels);
+        case SampleFormat::INT24: return forChannels<SampleFormat::INT24>(channels);
+        case SampleFormat::INT32: return forChannels<SampleFormat::INT32>(channels);
+        case SampleFormat::FLOAT32: return forChannels<SampleFormat::FLOAT32>(channels);
+        case SampleFormat::FLOAT64: return forChannels<SampleFormat::FLOAT64>(channels);
+    }
+    return forChannels<SampleFormat::INT16>(1);
+}
+
+} // namespace audio
+} // namespace perfx
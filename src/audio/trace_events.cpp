@@ -0,0 +1,355 @@
+/**
+ * @file trace_events.cpp
+ * @brief 跨线程事件追踪实现
+ * @details 每个线程持有一个当前事件块，只由本线程追加；块在创建时登记到全局列表，
+ *          已写入的槽位在 clear() 之前不会被改写，导出线程按 size（acquire）读取已提交
+ *          部分即可，无需与写入线程同步。clear() 递增纪元，各线程下次记录时换用新块
+ */
+
+#include "../../include/audio/trace_events.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace perfx {
+namespace audio {
+namespace trace {
+
+namespace detail {
+std::atomic<bool> g_enabled{false};
+}
+
+namespace {
+
+constexpr size_t kChunkEvents = 4096;
+
+/**
+ * @brief 追踪事件（32 字节）
+ *
+ * phase 与 Chrome trace 一致：X 时间片（arg 为时长 ns）、i 瞬时、C 计数（arg 为值）、
+ * s / t / f 流事件（arg 为流 id）
+ */
+struct Event {
+    int64_t tsNs;
+    int64_t arg;
+    const char* name;
+    char phase;
+};
+
+struct Chunk {
+    explicit Chunk(uint32_t threadId, const char* name) : tid(threadId), threadName(name) {}
+
+    const uint32_t tid;
+    std::atomic<const char*> threadName;
+    std::atomic<uint32_t> size{0};
+    std::array<Event, kChunkEvents> events;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<Chunk>> chunks;
+    std::atomic<uint64_t> epoch{1};
+    std::atomic<uint32_t> nextTid{1};
+    std::atomic<bool> full{false};
+    std::atomic<uint64_t> dropped{0};
+    size_t maxEvents = kDefaultMaxEvents;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+struct ThreadState {
+    uint32_t tid = 0;
+    uint64_t epoch = 0;
+    const char* name = nullptr;
+    std::shared_ptr<Chunk> chunk;
+};
+
+thread_local ThreadState tlsState;
+thread_local uint64_t tlsFlow = 0;
+
+/**
+ * @brief 取得本线程可写入的事件块，必要时（首次 / 已满 / 已清空）分配新块
+ * @return 超出事件上限时返回 nullptr
+ */
+Chunk* writableChunk() {
+    Registry& reg = registry();
+    ThreadState& state = tlsState;
+    const uint64_t epoch = reg.epoch.load(std::memory_order_relaxed);
+    if (state.chunk && state.epoch == epoch &&
+        state.chunk->size.load(std::memory_order_relaxed) < kChunkEvents) {
+        return state.chunk.get();
+    }
+    if (reg.full.load(std::memory_order_relaxed) && state.epoch == epoch) {
+        reg.dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    if (state.tid == 0) {
+        state.tid = reg.nextTid.fetch_add(1, std::memory_order_relaxed);
+    }
+    state.epoch = reg.epoch.load(std::memory_order_relaxed);
+    if ((reg.chunks.size() + 1) * kChunkEvents > reg.maxEvents) {
+        reg.full.store(true, std::memory_order_relaxed);
+        reg.dropped.fetch_add(1, std::memory_order_relaxed);
+        state.chunk.reset();
+        return nullptr;
+    }
+    state.chunk = std::make_shared<Chunk>(state.tid, state.name);
+    reg.chunks.push_back(state.chunk);
+    return state.chunk.get();
+}
+
+void append(int64_t tsNs, int64_t arg, const char* name, char phase) {
+    Chunk* chunk = writableChunk();
+    if (!chunk) {
+        return;
+    }
+    const uint32_t index = chunk->size.load(std::memory_order_relaxed);
+    chunk->events[index] = Event{tsNs, arg, name, phase};
+    chunk->size.store(index + 1, std::memory_order_release);
+}
+
+/**
+ * @brief 写出 JSON 字符串（事件名通常是 ASCII 字面量，仍按规范转义）
+ */
+void appendJsonString(std::string& out, const char* text) {
+    out += '"';
+    for (const char* p = text; *p; ++p) {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+    out += '"';
+}
+
+void appendMicros(std::string& out, int64_t ns) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%lld.%03lld", static_cast<long long>(ns / 1000),
+                  static_cast<long long>(ns % 1000));
+    out += buffer;
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+// 记录
+//------------------------------------------------------------------------------
+
+namespace detail {
+
+void recordSlice(const char* name, int64_t beginNs, int64_t endNs) {
+    append(beginNs, std::max<int64_t>(0, endNs - beginNs), name, 'X');
+}
+
+void recordInstant(const char* name) {
+    append(metrics::nowNs(), 0, name, 'i');
+}
+
+void recordCounter(const char* name, int64_t value) {
+    append(metrics::nowNs(), value, name, 'C');
+}
+
+void recordFlow(const char* name, uint64_t id, char phase) {
+    append(metrics::nowNs(), static_cast<int64_t>(id), name, phase);
+}
+
+void setThreadName(const char* name) {
+    ThreadState& state = tlsState;
+    if (state.name == name) {
+        return;
+    }
+    state.name = name;
+    if (state.chunk) {
+        state.chunk->threadName.store(name, std::memory_order_relaxed);
+    }
+}
+
+} // namespace detail
+
+void setCurrentFlow(uint64_t id) {
+    tlsFlow = id;
+}
+
+uint64_t currentFlow() {
+    return tlsFlow;
+}
+
+//------------------------------------------------------------------------------
+// 控制
+//------------------------------------------------------------------------------
+
+void start(size_t maxEvents) {
+    Registry& reg = registry();
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.maxEvents = std::max(maxEvents, kChunkEvents);
+    }
+    clear();
+    detail::g_enabled.store(true, std::memory_order_relaxed);
+}
+
+void stop() {
+    detail::g_enabled.store(false, std::memory_order_relaxed);
+}
+
+void clear() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.chunks.clear();
+    reg.epoch.fetch_add(1, std::memory_order_relaxed);
+    reg.full.store(false, std::memory_order_relaxed);
+    reg.dropped.store(0, std::memory_order_relaxed);
+}
+
+TraceStats stats() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    TraceStats result;
+    std::vector<uint32_t> tids;
+    for (const auto& chunk : reg.chunks) {
+        result.events += chunk->size.load(std::memory_order_acquire);
+        tids.push_back(chunk->tid);
+    }
+    std::sort(tids.begin(), tids.end());
+    result.threads = static_cast<size_t>(std::unique(tids.begin(), tids.end()) - tids.begin());
+    result.dropped = reg.dropped.load(std::memory_order_relaxed);
+    return result;
+}
+
+std::string startFromEnv() {
+    const char* path = std::getenv("PERFX_TRACE");
+    if (!path || !*path) {
+        return std::string();
+    }
+    start();
+    std::cout << "[TRACE] Tracing enabled, writing " << path << " on exit" << std::endl;
+    return path;
+}
+
+//------------------------------------------------------------------------------
+// 导出
+//------------------------------------------------------------------------------
+
+bool writeChromeTrace(const std::string& path, std::string& error) {
+    std::vector<std::shared_ptr<Chunk>> chunks;
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        chunks = reg.chunks;
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        error = "Cannot write trace file: " + path;
+        return false;
+    }
+
+    // 时间戳相对于最早事件，避免 steady_clock 的大数值
+    int64_t originNs = INT64_MAX;
+    for (const auto& chunk : chunks) {
+        const uint32_t size = chunk->size.load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < size; ++i) {
+            originNs = std::min(originNs, chunk->events[i].tsNs);
+        }
+    }
+    if (originNs == INT64_MAX) {
+        originNs = 0;
+    }
+
+    std::string out;
+    out.reserve(1 << 20);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    const auto separator = [&out, &first]() {
+        if (!first) out += ",\n";
+        first = false;
+    };
+
+    // 线程名元数据（同一线程的多个块只输出一次）
+    std::vector<uint32_t> namedTids;
+    for (const auto& chunk : chunks) {
+        const char* name = chunk->threadName.load(std::memory_order_relaxed);
+        if (!name || std::find(namedTids.begin(), namedTids.end(), chunk->tid) != namedTids.end()) {
+            continue;
+        }
+        namedTids.push_back(chunk->tid);
+        separator();
+        out += "{\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(chunk->tid) +
+               ",\"name\":\"thread_name\",\"args\":{\"name\":";
+        appendJsonString(out, name);
+        out += "}}";
+    }
+
+    for (const auto& chunk : chunks) {
+        const uint32_t size = chunk->size.load(std::memory_order_acquire);
+        const std::string tid = std::to_string(chunk->tid);
+        for (uint32_t i = 0; i < size; ++i) {
+            const Event& event = chunk->events[i];
+            const int64_t ts = event.tsNs - originNs;
+            separator();
+            out += "{\"pid\":1,\"tid\":" + tid + ",\"ts\":";
+            appendMicros(out, ts);
+            out += ",\"name\":";
+            appendJsonString(out, event.name);
+            switch (event.phase) {
+            case 'X':
+                out += ",\"ph\":\"X\",\"dur\":";
+                appendMicros(out, event.arg);
+                out += '}';
+                break;
+            case 'i':
+                out += ",\"ph\":\"i\",\"s\":\"t\"}";
+                break;
+            case 'C':
+                out += ",\"ph\":\"C\",\"args\":{\"value\":" + std::to_string(event.arg) + "}}";
+                break;
+            default:
+                // 流事件绑定到所在的时间片：每个步骤输出一个 1 µs 的同名时间片作为锚点，
+                // 流名称统一为 pipeline，按 id 串联
+                out += ",\"ph\":\"X\",\"dur\":1},\n{\"pid\":1,\"tid\":" + tid + ",\"ts\":";
+                appendMicros(out, ts);
+                out += ",\"name\":\"pipeline\",\"cat\":\"flow\",\"ph\":\"";
+                out += event.phase;
+                out += "\",\"id\":" + std::to_string(static_cast<uint64_t>(event.arg));
+                out += event.phase == 's' ? "}" : ",\"bp\":\"e\"}";
+                break;
+            }
+            if (out.size() > (1 << 20) - 512) {
+                std::fwrite(out.data(), 1, out.size(), file);
+                out.clear();
+            }
+        }
+    }
+    out += "\n]}\n";
+    std::fwrite(out.data(), 1, out.size(), file);
+
+    const bool ok = std::ferror(file) == 0;
+    if (std::fclose(file) != 0 || !ok) {
+        error = "Failed to write trace file: " + path;
+        return false;
+    }
+    return true;
+}
+
+} // namespace trace
+} // namespace audio
+} // namespace perfx
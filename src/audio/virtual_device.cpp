@@ -0,0 +1,666 @@
+/**
+ * @file virtual_device.cpp
+ * @brief 虚拟输入设备：WAV 回放 / 信号生成器
+ * @details 按实时或自由运行时钟产生采集缓冲，可注入回调抖动与上溢，用于无麦克风环境下的实时链路基准
+ */
+
+#include "../../include/audio/virtual_device.h"
+#include "../../include/audio/latency_metrics.h"
+#include "../../include/audio/sample_pipeline.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace perfx {
+namespace audio {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+std::string trim(const std::string& text) {
+    const size_t begin = text.find_first_not_of(" \t");
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    const size_t end = text.find_last_not_of(" \t");
+    return text.substr(begin, end - begin + 1);
+}
+
+bool parseNumber(const std::string& text, double& value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return end && *end == '\0' && std::isfinite(value);
+}
+
+bool isGenerator(const std::string& source) {
+    return source == "speech" || source == "noise" || source == "silence" ||
+           source == "sine" || source.rfind("sine:", 0) == 0;
+}
+
+//------------------------------------------------------------------------------
+// WAV 读取
+//------------------------------------------------------------------------------
+
+struct WavFormat {
+    uint16_t format = 0;        // 1 = PCM, 3 = IEEE float
+    int channels = 0;
+    int sampleRate = 0;
+    int bitsPerSample = 0;
+    uint64_t dataOffset = 0;
+    uint64_t dataSize = 0;
+};
+
+uint16_t readLe16(const unsigned char* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t readLe32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+/**
+ * @brief 解析 WAV 块结构，定位 fmt 与 data 块
+ */
+bool readWavFormat(std::ifstream& file, WavFormat& wav, std::string& error) {
+    unsigned char header[12];
+    if (!file.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        std::memcmp(header, "RIFF", 4) != 0 || std::memcmp(header + 8, "WAVE", 4) != 0) {
+        error = "not a RIFF/WAVE file";
+        return false;
+    }
+
+    bool foundFmt = false;
+    unsigned char chunk[8];
+    while (file.read(reinterpret_cast<char*>(chunk), sizeof(chunk))) {
+        const uint32_t chunkSize = readLe32(chunk + 4);
+        if (std::memcmp(chunk, "fmt ", 4) == 0) {
+            unsigned char fmt[40] = {};
+            const size_t size = std::min<size_t>(chunkSize, sizeof(fmt));
+            if (chunkSize < 16 || !file.read(reinterpret_cast<char*>(fmt), static_cast<std::streamsize>(size))) {
+                error = "truncated fmt chunk";
+                return false;
+            }
+            wav.format = readLe16(fmt);
+            wav.channels = readLe16(fmt + 2);
+            wav.sampleRate = static_cast<int>(readLe32(fmt + 4));
+            wav.bitsPerSample = readLe16(fmt + 14);
+            // WAVE_FORMAT_EXTENSIBLE：实际格式在子格式 GUID 的前两个字节
+            if (wav.format == 0xFFFE && size >= 26) {
+                wav.format = readLe16(fmt + 24);
+            }
+            file.seekg(static_cast<std::streamoff>(chunkSize - size + (chunkSize & 1)), std::ios::cur);
+            foundFmt = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            wav.dataOffset = static_cast<uint64_t>(file.tellg());
+            wav.dataSize = chunkSize;
+            break;
+        } else {
+            file.seekg(static_cast<std::streamoff>(chunkSize + (chunkSize & 1)), std::ios::cur);
+        }
+    }
+
+    if (!foundFmt || wav.dataOffset == 0) {
+        error = foundFmt ? "missing data chunk" : "missing fmt chunk";
+        return false;
+    }
+    const bool pcm = wav.format == 1 &&
+                     (wav.bitsPerSample == 16 || wav.bitsPerSample == 24 || wav.bitsPerSample == 32);
+    const bool ieee = wav.format == 3 && wav.bitsPerSample == 32;
+    if (!pcm && !ieee) {
+        error = "unsupported WAV encoding (format " + std::to_string(wav.format) + ", " +
+                std::to_string(wav.bitsPerSample) + " bit)";
+        return false;
+    }
+    if (wav.channels <= 0 || wav.sampleRate <= 0) {
+        error = "invalid WAV header";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 读取整个 WAV 数据块为交织 float（-1~1）
+ */
+bool readWavSamples(const std::string& path, std::vector<float>& samples, WavFormat& wav, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        error = "cannot open " + path;
+        return false;
+    }
+    if (!readWavFormat(file, wav, error)) {
+        error = path + ": " + error;
+        return false;
+    }
+
+    const size_t bytesPerSample = static_cast<size_t>(wav.bitsPerSample / 8);
+    // 流式写出的 WAV 头中 data 大小可能未回填（0 或 0xFFFFFFFF），读到文件尾为止
+    file.seekg(0, std::ios::end);
+    const uint64_t available = static_cast<uint64_t>(file.tellg()) - wav.dataOffset;
+    const uint64_t dataSize = (wav.dataSize == 0 || wav.dataSize > available) ? available : wav.dataSize;
+    file.seekg(static_cast<std::streamoff>(wav.dataOffset));
+
+    std::vector<unsigned char> raw(static_cast<size_t>(dataSize));
+    if (!file.read(reinterpret_cast<char*>(raw.data()), static_cast<std::streamsize>(raw.size()))) {
+        error = path + ": truncated data chunk";
+        return false;
+    }
+
+    const size_t count = raw.size() / bytesPerSample;
+    samples.resize(count - count % static_cast<size_t>(wav.channels));
+    const unsigned char* p = raw.data();
+    for (size_t i = 0; i < samples.size(); ++i, p += bytesPerSample) {
+        if (wav.format == 3) {
+            float value;
+            std::memcpy(&value, p, sizeof(value));
+            samples[i] = value;
+        } else if (wav.bitsPerSample == 16) {
+            samples[i] = static_cast<int16_t>(readLe16(p)) / 32768.0f;
+        } else if (wav.bitsPerSample == 24) {
+            const int32_t value = static_cast<int32_t>((static_cast<uint32_t>(p[0]) << 8) |
+                                                       (static_cast<uint32_t>(p[1]) << 16) |
+                                                       (static_cast<uint32_t>(p[2]) << 24)) >> 8;
+            samples[i] = static_cast<float>(value / 8388608.0);
+        } else {
+            samples[i] = static_cast<float>(static_cast<int32_t>(readLe32(p)) / 2147483648.0);
+        }
+    }
+    if (samples.empty()) {
+        error = path + ": no audio data";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 转换通道数并线性插值重采样（仅在打开时执行一次）
+ */
+std::vector<float> convertLayout(const std::vector<float>& input, int inputRate, int inputChannels,
+                                 int outputRate, int outputChannels) {
+    const size_t inputFrames = input.size() / static_cast<size_t>(inputChannels);
+
+    // 1. 通道：目标单声道取平均，源单声道复制到各通道，其余按序号对应、多余补零
+    std::vector<float> mapped(inputFrames * static_cast<size_t>(outputChannels), 0.0f);
+    for (size_t f = 0; f < inputFrames; ++f) {
+        const float* in = &input[f * static_cast<size_t>(inputChannels)];
+        float* out = &mapped[f * static_cast<size_t>(outputChannels)];
+        if (outputChannels == 1) {
+            float sum = 0.0f;
+            for (int c = 0; c < inputChannels; ++c) sum += in[c];
+            out[0] = sum / static_cast<float>(inputChannels);
+        } else if (inputChannels == 1) {
+            for (int c = 0; c < outputChannels; ++c) out[c] = in[0];
+        } else {
+            for (int c = 0; c < std::min(inputChannels, outputChannels); ++c) out[c] = in[c];
+        }
+    }
+    if (inputRate == outputRate) {
+        return mapped;
+    }
+
+    // 2. 采样率
+    const double step = static_cast<double>(inputRate) / outputRate;
+    const size_t outputFrames = static_cast<size_t>(inputFrames / step);
+    std::vector<float> output(outputFrames * static_cast<size_t>(outputChannels));
+    for (size_t f = 0; f < outputFrames; ++f) {
+        const double position = f * step;
+        const size_t i0 = static_cast<size_t>(position);
+        const size_t i1 = std::min(i0 + 1, inputFrames - 1);
+        const float frac = static_cast<float>(position - i0);
+        for (int c = 0; c < outputChannels; ++c) {
+            const float a = mapped[i0 * outputChannels + c];
+            const float b = mapped[i1 * outputChannels + c];
+            output[f * outputChannels + c] = a + (b - a) * frac;
+        }
+    }
+    return output;
+}
+
+//------------------------------------------------------------------------------
+// 来源
+//------------------------------------------------------------------------------
+
+/**
+ * @brief 采样来源：按目标采样率 / 通道数产生交织 float
+ */
+class SignalSource {
+public:
+    virtual ~SignalSource() = default;
+
+    /**
+     * @return 实际产生的帧数；小于 frames 表示来源已结束
+     */
+    virtual size_t read(float* output, size_t frames) = 0;
+};
+
+class FileSource : public SignalSource {
+public:
+    FileSource(std::vector<float> samples, int channels, bool loop)
+        : samples_(std::move(samples)), channels_(static_cast<size_t>(channels)), loop_(loop) {}
+
+    size_t read(float* output, size_t frames) override {
+        const size_t totalFrames = samples_.size() / channels_;
+        size_t produced = 0;
+        while (produced < frames) {
+            if (position_ == totalFrames) {
+                if (!loop_) break;
+                position_ = 0;
+            }
+            const size_t n = std::min(frames - produced, totalFrames - position_);
+            std::memcpy(output + produced * channels_, &samples_[position_ * channels_], n * channels_ * sizeof(float));
+            position_ += n;
+            produced += n;
+        }
+        return produced;
+    }
+
+private:
+    std::vector<float> samples_;
+    size_t channels_;
+    bool loop_;
+    size_t position_ = 0;
+};
+
+class GeneratorSource : public SignalSource {
+public:
+    GeneratorSource(const std::string& kind, int sampleRate, int channels, uint32_t seed)
+        : sampleRate_(sampleRate), channels_(channels), noiseState_(seed ? seed : 1u) {
+        if (kind == "speech") {
+            kind_ = Kind::Speech;
+        } else if (kind == "noise") {
+            kind_ = Kind::Noise;
+        } else if (kind == "silence") {
+            kind_ = Kind::Silence;
+        } else {
+            kind_ = Kind::Sine;
+            double frequency = 0.0;
+            if (kind.size() > 5 && parseNumber(kind.substr(5), frequency) && frequency > 0.0) {
+                frequency_ = frequency;
+            }
+        }
+    }
+
+    size_t read(float* output, size_t frames) override {
+        for (size_t f = 0; f < frames; ++f, ++sampleIndex_) {
+            const float value = static_cast<float>(next());
+            for (int c = 0; c < channels_; ++c) {
+                output[f * channels_ + c] = value;
+            }
+        }
+        return frames;
+    }
+
+private:
+    enum class Kind { Speech, Sine, Noise, Silence };
+
+    double noise() {
+        noiseState_ = noiseState_ * 1664525u + 1013904223u;
+        return static_cast<double>(noiseState_ >> 8) / (1u << 24) - 0.5;
+    }
+
+    // 与 perfx-cli bench 的合成信号一致：2 秒调幅谐波“说话” + 1 秒停顿，叠加低电平噪声
+    double next() {
+        const double t = static_cast<double>(sampleIndex_) / sampleRate_;
+        switch (kind_) {
+            case Kind::Speech: {
+                double voice = 0.0;
+                if (std::fmod(t, 3.0) < 2.0) {
+                    const double envelope = 0.5 + 0.5 * std::sin(2.0 * kPi * 4.0 * t);
+                    voice = envelope * (0.0916 * std::sin(2.0 * kPi * 180.0 * t) +
+                                        0.0458 * std::sin(2.0 * kPi * 360.0 * t) +
+                                        0.0244 * std::sin(2.0 * kPi * 1100.0 * t));
+                }
+                return voice + noise() * 0.0061;
+            }
+            case Kind::Sine:
+                return 0.25 * std::sin(2.0 * kPi * frequency_ * t);
+            case Kind::Noise:
+                return noise() * 0.5;
+            case Kind::Silence:
+            default:
+                return 0.0;
+        }
+    }
+
+    Kind kind_ = Kind::Speech;
+    int sampleRate_;
+    int channels_;
+    double frequency_ = 440.0;
+    uint32_t noiseState_;
+    uint64_t sampleIndex_ = 0;
+};
+
+//------------------------------------------------------------------------------
+// 采样格式转换
+//------------------------------------------------------------------------------
+
+/**
+ * @brief 浮点样本写为设备格式（整数按 2^(N-1) 缩放，与 WAV 读取互逆，文件回放逐位一致）
+ */
+template <SampleFormat F>
+void convertSamples(const float* input, size_t count, unsigned char* output) {
+    for (size_t i = 0; i < count; ++i) {
+        const double value = std::max(-1.0, std::min(1.0, static_cast<double>(input[i])));
+        if constexpr (F == SampleFormat::INT16) {
+            const int16_t sample = static_cast<int16_t>(std::lrint(std::min(value * 32768.0, 32767.0)));
+            std::memcpy(output + i * 2, &sample, 2);
+        } else if constexpr (F == SampleFormat::INT24) {
+            // PortAudio paInt24：紧凑的 3 字节小端
+            const int32_t sample = static_cast<int32_t>(std::lrint(std::min(value * 8388608.0, 8388607.0)));
+            output[i * 3] = static_cast<unsigned char>(sample & 0xFF);
+            output[i * 3 + 1] = static_cast<unsigned char>((sample >> 8) & 0xFF);
+            output[i * 3 + 2] = static_cast<unsigned char>((sample >> 16) & 0xFF);
+        } else if constexpr (F == SampleFormat::INT32) {
+            const int32_t sample = static_cast<int32_t>(std::llrint(std::min(value * 2147483648.0, 2147483647.0)));
+            std::memcpy(output + i * 4, &sample, 4);
+        } else {
+            std::memcpy(output + i * 4, &input[i], 4);
+        }
+    }
+}
+
+using ConvertFn = void (*)(const float* input, size_t count, unsigned char* output);
+
+/**
+ * @brief 按格式选定转换函数（打开设备时调用一次），不支持的格式返回空
+ */
+ConvertFn selectConverter(SampleFormat format) {
+    switch (format) {
+        case SampleFormat::INT16: return &convertSamples<SampleFormat::INT16>;
+        case SampleFormat::INT24: return &convertSamples<SampleFormat::INT24>;
+        case SampleFormat::INT32: return &convertSamples<SampleFormat::INT32>;
+        case SampleFormat::FLOAT32: return &convertSamples<SampleFormat::FLOAT32>;
+        default: return nullptr;
+    }
+}
+
+std::string sourceDisplayName(const std::string& source) {
+    if (isGenerator(source)) {
+        return source;
+    }
+    const size_t slash = source.find_last_of("/\\");
+    return slash == std::string::npos ? source : source.substr(slash + 1);
+}
+
+} // namespace
+
+//==============================================================================
+// 描述串 / 设备信息
+//==============================================================================
+
+bool parseVirtualDeviceSpec(const std::string& spec, VirtualDeviceConfig& config, std::string& error) {
+    VirtualDeviceConfig parsed;
+    size_t begin = 0;
+    bool first = true;
+    while (begin <= spec.size()) {
+        size_t end = spec.find(',', begin);
+        if (end == std::string::npos) end = spec.size();
+        const std::string item = trim(spec.substr(begin, end - begin));
+        begin = end + 1;
+
+        if (first) {
+            first = false;
+            if (item.empty()) {
+                error = "missing source";
+                return false;
+            }
+            parsed.source = item;
+            continue;
+        }
+        if (item.empty()) {
+            continue;
+        }
+
+        const size_t eq = item.find('=');
+        const std::string key = trim(item.substr(0, eq));
+        const std::string value = eq == std::string::npos ? std::string() : trim(item.substr(eq + 1));
+        double number = 0.0;
+        if (key == "name") {
+            parsed.name = value;
+        } else if (key == "clock") {
+            if (value == "realtime") {
+                parsed.clock = VirtualClock::Realtime;
+            } else if (value == "free") {
+                parsed.clock = VirtualClock::FreeRunning;
+            } else {
+                error = "clock must be realtime or free";
+                return false;
+            }
+        } else if (key == "loop") {
+            parsed.loop = value != "0" && value != "false";
+        } else if (!parseNumber(value, number)) {
+            error = "invalid value for " + key + ": '" + value + "'";
+            return false;
+        } else if (key == "speed" && number > 0.0) {
+            parsed.speed = number;
+        } else if (key == "jitter" && number >= 0.0) {
+            parsed.jitterMs = number;
+        } else if (key == "xrun" && number >= 0.0 && number < 1.0) {
+            parsed.xrunRate = number;
+        } else if (key == "seed" && number >= 0.0) {
+            parsed.seed = static_cast<uint32_t>(number);
+        } else if (key == "rate" && number >= 1000.0 && number <= 384000.0) {
+            parsed.sampleRate = static_cast<int>(number);
+        } else if (key == "channels" && number >= 1.0 && number <= 32.0) {
+            parsed.channels = static_cast<int>(number);
+        } else {
+            error = "invalid option '" + item + "'";
+            return false;
+        }
+    }
+    config = parsed;
+    return true;
+}
+
+bool describeVirtualDevice(const VirtualDeviceConfig& config, int index, DeviceInfo& device, std::string& error) {
+    int sampleRate = config.sampleRate;
+    int channels = config.channels;
+    if (!isGenerator(config.source)) {
+        std::ifstream file(config.source, std::ios::binary);
+        WavFormat wav;
+        if (!file.is_open()) {
+            error = "cannot open " + config.source;
+            return false;
+        }
+        if (!readWavFormat(file, wav, error)) {
+            error = config.source + ": " + error;
+            return false;
+        }
+        sampleRate = wav.sampleRate;
+        channels = wav.channels;
+    }
+
+    device = DeviceInfo{};
+    device.index = index;
+    device.name = config.name.empty() ? "Virtual: " + sourceDisplayName(config.source) : config.name;
+    device.type = DeviceType::INPUT;
+    // 打开时会转换通道数，单声道来源也可按立体声打开
+    device.maxInputChannels = std::max(channels, 2);
+    device.maxOutputChannels = 0;
+    device.defaultSampleRate = sampleRate;
+    device.defaultLatency = 0.0;
+    device.hostApi = kVirtualHostApi;
+    device.supportedSampleRates = {8000, 16000, 22050, 32000, 44100, 48000};
+    return true;
+}
+
+//==============================================================================
+// VirtualInputStream::Impl 类实现
+//==============================================================================
+
+class VirtualInputStream::Impl {
+public:
+    Impl(const VirtualDeviceConfig& device, const AudioConfig& config)
+        : device_(device), config_(config), rng_(device.seed) {}
+
+    ~Impl() {
+        stop();
+    }
+
+    bool open(std::string& error) {
+        const int sampleRate = static_cast<int>(config_.sampleRate);
+        const int channels = static_cast<int>(config_.channels);
+        if (config_.framesPerBuffer <= 0 || sampleRate <= 0 || channels <= 0) {
+            error = "invalid stream configuration";
+            return false;
+        }
+        convert_ = selectConverter(config_.format);
+        if (!convert_) {
+            error = "unsupported sample format for virtual device";
+            return false;
+        }
+
+        if (isGenerator(device_.source)) {
+            source_ = std::make_unique<GeneratorSource>(device_.source, sampleRate, channels, device_.seed);
+        } else {
+            std::vector<float> samples;
+            WavFormat wav;
+            if (!readWavSamples(device_.source, samples, wav, error)) {
+                return false;
+            }
+            samples = convertLayout(samples, wav.sampleRate, wav.channels, sampleRate, channels);
+            std::cout << "[AUDIO-THREAD] Virtual device loaded " << device_.source << " ("
+                      << samples.size() / channels * 1000 / sampleRate << " ms at " << sampleRate << " Hz)"
+                      << std::endl;
+            source_ = std::make_unique<FileSource>(std::move(samples), channels, device_.loop);
+        }
+
+        const size_t samplesPerBuffer = static_cast<size_t>(config_.framesPerBuffer) * channels;
+        floatBuffer_.assign(samplesPerBuffer, 0.0f);
+        outputBuffer_.assign(samplesPerBuffer * bytesPerSample(config_.format), 0);
+        return true;
+    }
+
+    bool start(Callback callback) {
+        if (!source_ || running_) {
+            return running_;
+        }
+        callback_ = std::move(callback);
+        finished_ = false;
+        running_ = true;
+        thread_ = std::thread(&Impl::run, this);
+        return true;
+    }
+
+    void stop() {
+        running_ = false;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    bool isActive() const {
+        return running_ && !finished_;
+    }
+
+    std::atomic<uint64_t> framesDelivered_{0};
+    std::atomic<uint64_t> xrunCount_{0};
+
+private:
+    /**
+     * @brief 回调线程：按标称时间表产生缓冲
+     * @details 第 n 个缓冲的标称完成时间为 start + (n+1) × 周期，按绝对时间等待，抖动不会累积为漂移
+     */
+    void run() {
+        const size_t frames = static_cast<size_t>(config_.framesPerBuffer);
+        const size_t channels = static_cast<size_t>(config_.channels);
+        const double periodNs = frames * 1e9 / static_cast<double>(config_.sampleRate) / device_.speed;
+        const bool realtime = device_.clock == VirtualClock::Realtime;
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        const int64_t startNs = metrics::nowNs();
+        const auto startTime = std::chrono::steady_clock::now();
+        bool pendingXrun = false;
+
+        for (uint64_t n = 0; running_; ++n) {
+            const int64_t dueOffsetNs = static_cast<int64_t>((n + 1) * periodNs);
+            if (realtime) {
+                int64_t wakeNs = dueOffsetNs;
+                if (device_.jitterMs > 0.0) {
+                    wakeNs += static_cast<int64_t>(unit(rng_) * device_.jitterMs * 1e6);
+                }
+                std::this_thread::sleep_until(startTime + std::chrono::nanoseconds(wakeNs));
+                if (!running_) {
+                    break;
+                }
+            }
+
+            const size_t produced = source_->read(floatBuffer_.data(), frames);
+            if (produced == 0) {
+                finished_ = true;
+                std::cout << "[AUDIO-THREAD] Virtual device reached end of source" << std::endl;
+                break;
+            }
+            if (produced < frames) {
+                std::fill(floatBuffer_.begin() + static_cast<std::ptrdiff_t>(produced * channels),
+                          floatBuffer_.end(), 0.0f);
+            }
+
+            // 上溢：下游没有及时取走，本缓冲的数据丢失
+            if (device_.xrunRate > 0.0 && unit(rng_) < device_.xrunRate) {
+                pendingXrun = true;
+                xrunCount_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            convert_(floatBuffer_.data(), frames * channels, outputBuffer_.data());
+            const int64_t captureNs = realtime ? startNs + dueOffsetNs - static_cast<int64_t>(periodNs)
+                                               : metrics::nowNs();
+            if (callback_) {
+                callback_(outputBuffer_.data(), frames, pendingXrun, captureNs);
+            }
+            pendingXrun = false;
+            framesDelivered_.fetch_add(frames, std::memory_order_relaxed);
+            if (!realtime) {
+                std::this_thread::yield();
+            }
+
+            if (produced < frames) {
+                finished_ = true;
+                std::cout << "[AUDIO-THREAD] Virtual device reached end of source" << std::endl;
+                break;
+            }
+        }
+    }
+
+    VirtualDeviceConfig device_;
+    AudioConfig config_;
+    std::mt19937 rng_;
+    std::unique_ptr<SignalSource> source_;
+    std::vector<float> floatBuffer_;
+    std::vector<unsigned char> outputBuffer_;
+    ConvertFn convert_ = nullptr;
+    Callback callback_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> finished_{false};
+};
+
+//==============================================================================
+// VirtualInputStream 类公共接口实现
+//==============================================================================
+
+VirtualInputStream::VirtualInputStream(const VirtualDeviceConfig& device, const AudioConfig& config)
+    : impl_(std::make_unique<Impl>(device, config)) {}
+VirtualInputStream::~VirtualInputStream() = default;
+
+bool VirtualInputStream::open(std::string& error) { return impl_->open(error); }
+bool VirtualInputStream::start(Callback callback) { return impl_->start(std::move(callback)); }
+void VirtualInputStream::stop() { impl_->stop(); }
+bool VirtualInputStream::isActive() const { return impl_->isActive(); }
+uint64_t VirtualInputStream::getFramesDelivered() const { return impl_->framesDelivered_.load(); }
+uint64_t VirtualInputStream::getXrunCount() const { return impl_->xrunCount_.load(); }
+
+} // namespace audio
+} // namespace perfx
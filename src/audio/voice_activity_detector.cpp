@@ -0,0 +1,231 @@
+/**
+ * @file voice_activity_detector.cpp
+ * @brief 客户端语音活动检测的实现
+ * @details 能量 + 过零率快速判决，自适应噪声底，pre-roll/hangover 与时间戳偏移映射
+ */
+
+#include "../../include/audio/voice_activity_detector.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace perfx {
+namespace audio {
+
+VoiceActivityDetector::VoiceActivityDetector(const VadConfig& config)
+    : config_(config)
+{
+    int sampleRate = config_.sampleRate > 0 ? config_.sampleRate : 16000;
+    int frameMs = config_.frameMs > 0 ? config_.frameMs : 10;
+    config_.sampleRate = sampleRate;
+    config_.frameMs = frameMs;
+
+    frameSamples_ = static_cast<size_t>(sampleRate) * frameMs / 1000;
+    hangoverFrames_ = std::max(0, config_.hangoverMs / frameMs);
+    preRollCapacity_ = static_cast<size_t>(std::max(0, config_.preRollMs)) * sampleRate / 1000;
+    maxSilenceSamples_ = static_cast<size_t>(std::max(0, config_.maxSilenceMs)) * sampleRate / 1000;
+
+    pending_.reserve(frameSamples_);
+    preRoll_.resize(preRollCapacity_);
+    reset();
+}
+
+void VoiceActivityDetector::reset() {
+    pending_.clear();
+    preRollHead_ = 0;
+    preRollSize_ = 0;
+    inSpeech_ = false;
+    hangoverLeft_ = 0;
+    silenceEmitted_ = 0;
+    noiseFloorDb_ = config_.energyThresholdDb;
+    inputPos_ = 0;
+    outputPos_ = 0;
+    nextContiguous_ = -1;
+    stats_ = VadStats();
+
+    std::lock_guard<std::mutex> lock(mapMutex_);
+    segments_.clear();
+}
+
+size_t VoiceActivityDetector::process(const int16_t* samples, size_t count, std::vector<int16_t>& out) {
+    if (!samples || count == 0 || frameSamples_ == 0) {
+        return 0;
+    }
+
+    const size_t before = out.size();
+    stats_.inputSamples += count;
+
+    auto handleFrame = [&](const int16_t* frame) {
+        const int64_t framePos = inputPos_;
+        const bool speech = classifyFrame(frame);
+
+        if (speech) {
+            ++stats_.speechFrames;
+            if (!inSpeech_) {
+                flushPreRoll(out);
+            }
+            inSpeech_ = true;
+            hangoverLeft_ = hangoverFrames_;
+            silenceEmitted_ = 0;
+            emitSamples(frame, frameSamples_, framePos, out);
+        } else {
+            ++stats_.silenceFrames;
+            bool emit = false;
+            if (inSpeech_ && hangoverLeft_ > 0) {
+                --hangoverLeft_;
+                emit = true;
+            } else {
+                inSpeech_ = false;
+                emit = config_.mode == VadMode::COMPRESS && silenceEmitted_ < maxSilenceSamples_;
+            }
+
+            if (emit) {
+                silenceEmitted_ += frameSamples_;
+                emitSamples(frame, frameSamples_, framePos, out);
+            } else {
+                // 暂存为 pre-roll，下一次语音起点时补发
+                for (size_t i = 0; i < frameSamples_ && preRollCapacity_ > 0; ++i) {
+                    if (preRollSize_ < preRollCapacity_) {
+                        preRoll_[(preRollHead_ + preRollSize_) % preRollCapacity_] = frame[i];
+                        ++preRollSize_;
+                    } else {
+                        preRoll_[preRollHead_] = frame[i];
+                        preRollHead_ = (preRollHead_ + 1) % preRollCapacity_;
+                    }
+                }
+            }
+        }
+        inputPos_ += static_cast<int64_t>(frameSamples_);
+    };
+
+    size_t offset = 0;
+
+    // 先补齐上次残留的不完整帧
+    if (!pending_.empty()) {
+        size_t need = std::min(frameSamples_ - pending_.size(), count);
+        pending_.insert(pending_.end(), samples, samples + need);
+        offset = need;
+        if (pending_.size() == frameSamples_) {
+            handleFrame(pending_.data());
+            pending_.clear();
+        }
+    }
+
+    // 完整帧直接在输入缓冲上处理，不做拷贝
+    while (count - offset >= frameSamples_) {
+        handleFrame(samples + offset);
+        offset += frameSamples_;
+    }
+
+    if (offset < count) {
+        pending_.insert(pending_.end(), samples + offset, samples + count);
+    }
+
+    const size_t appended = out.size() - before;
+    stats_.outputSamples += appended;
+    return appended;
+}
+
+bool VoiceActivityDetector::classifyFrame(const int16_t* frame) {
+    double energy = 0.0;
+    size_t crossings = 0;
+    for (size_t i = 0; i < frameSamples_; ++i) {
+        double s = frame[i];
+        energy += s * s;
+        if (i > 0 && ((frame[i - 1] >= 0) != (frame[i] >= 0))) {
+            ++crossings;
+        }
+    }
+
+    double rms = std::sqrt(energy / static_cast<double>(frameSamples_)) / 32768.0;
+    float db = static_cast<float>(20.0 * std::log10(rms + 1e-10));
+    float zcr = frameSamples_ > 1 ? static_cast<float>(crossings) / static_cast<float>(frameSamples_ - 1) : 0.0f;
+
+    float threshold = config_.energyThresholdDb;
+    if (config_.adaptiveNoiseFloor) {
+        threshold = std::max(threshold, noiseFloorDb_ + config_.speechMarginDb);
+
+        // 噪声底快降慢升：静音时迅速贴近真实底噪，持续的新噪声在数秒内被吸收
+        if (db < noiseFloorDb_) {
+            noiseFloorDb_ += config_.noiseFloorFallAlpha * (db - noiseFloorDb_);
+        } else {
+            noiseFloorDb_ += std::min(config_.noiseFloorRiseDb, db - noiseFloorDb_);
+        }
+        stats_.noiseFloorDb = noiseFloorDb_;
+    }
+
+    if (db <= threshold) {
+        return false;
+    }
+    // 过零率过高通常是宽带噪声；但能量明显高于门限时（如清擦音）仍判为语音
+    return zcr <= config_.zcrMax || db > threshold + config_.speechMarginDb;
+}
+
+void VoiceActivityDetector::emitSamples(const int16_t* samples, size_t count, int64_t inputPos,
+                                        std::vector<int16_t>& out) {
+    if (inputPos != nextContiguous_) {
+        std::lock_guard<std::mutex> lock(mapMutex_);
+        segments_.push_back({outputPos_, inputPos});
+    }
+    out.insert(out.end(), samples, samples + count);
+    outputPos_ += static_cast<int64_t>(count);
+    nextContiguous_ = inputPos + static_cast<int64_t>(count);
+
+    // 已发送的样本之前的 pre-roll 不再与后续帧相邻
+    preRollSize_ = 0;
+    preRollHead_ = 0;
+}
+
+void VoiceActivityDetector::flushPreRoll(std::vector<int16_t>& out) {
+    if (preRollSize_ == 0) {
+        return;
+    }
+    const size_t size = preRollSize_;
+    const size_t head = preRollHead_;
+    const int64_t start = inputPos_ - static_cast<int64_t>(size);
+
+    size_t first = std::min(size, preRollCapacity_ - head);
+    emitSamples(preRoll_.data() + head, first, start, out);
+    if (first < size) {
+        emitSamples(preRoll_.data(), size - first, start + static_cast<int64_t>(first), out);
+    }
+}
+
+int64_t VoiceActivityDetector::mapOutputToInputMs(int64_t outputMs) const {
+    const int64_t sampleRate = config_.sampleRate;
+    const int64_t outputSample = outputMs * sampleRate / 1000;
+
+    std::lock_guard<std::mutex> lock(mapMutex_);
+    if (segments_.empty()) {
+        return outputMs;
+    }
+
+    auto it = std::upper_bound(segments_.begin(), segments_.end(), outputSample,
+                               [](int64_t value, const OffsetSegment& seg) { return value < seg.outputStart; });
+    if (it == segments_.begin()) {
+        return segments_.front().inputStart * 1000 / sampleRate;
+    }
+    --it;
+    int64_t inputSample = it->inputStart + (outputSample - it->outputStart);
+    return inputSample * 1000 / sampleRate;
+}
+
+void VoiceActivityDetector::discardMappingBefore(int64_t outputMs) {
+    const int64_t outputSample = outputMs * config_.sampleRate / 1000;
+
+    std::lock_guard<std::mutex> lock(mapMutex_);
+    // 保留包含 outputSample 的段：其前面的段在下一段开始时就已结束
+    auto it = std::upper_bound(segments_.begin(), segments_.end(), outputSample,
+                               [](int64_t value, const OffsetSegment& seg) { return value < seg.outputStart; });
+    if (it == segments_.begin()) {
+        return;
+    }
+    segments_.erase(segments_.begin(), std::prev(it));
+}
+
+VadStats VoiceActivityDetector::getStats() const {
+    return stats_;
+}
+
+} // namespace audio
+} // namespace perfx
@@ -0,0 +1,644 @@
+//
+// perfx-caption-loadtest：字幕广播服务器压力测试
+//
+// 在本进程内启动 CaptionServer 并按固定频率发布模拟转录结果，同时用少量线程
+// 驱动数千个非阻塞 WebSocket 订阅者（poll 多路复用，不为每个订阅者创建线程）。
+// 一部分订阅者在测试期间不读取数据，用于验证慢速客户端的丢弃 / 快照策略不会
+// 拖慢其他订阅者；另一部分在中途断开后携带序号重连，用于验证续传。
+//
+// 用法：
+//   perfx-caption-loadtest [--clients N] [--slow N] [--reconnect N] [--rate HZ]
+//                          [--seconds S] [--threads T] [--sender-threads T] [--port P] [--json]
+//   perfx-caption-loadtest --connect HOST:PORT [--clients N] ...   只做订阅端，连接已有服务器
+//
+
+#include "logic/caption_server.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using json = nlohmann::json;
+
+namespace {
+
+struct Options {
+    int clients = 1000;
+    int slowClients = 0;
+    int reconnectClients = 0;
+    int rateHz = 20;
+    int seconds = 10;
+    int clientThreads = 4;
+    int senderThreads = 4;
+    int port = 0;
+    std::string connectHost;
+    bool asJson = false;
+};
+
+int64_t nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void printUsage() {
+    std::cerr <<
+        "Usage: perfx-caption-loadtest [options]\n"
+        "  --clients N          subscribers to simulate (default 1000)\n"
+        "  --slow N             of which never read until the end (default 0)\n"
+        "  --reconnect N        of which disconnect halfway and resume with since=<seq> (default 0)\n"
+        "  --rate HZ            transcript updates per second (default 20)\n"
+        "  --seconds S          test duration (default 10)\n"
+        "  --threads T          client poll threads (default 4)\n"
+        "  --sender-threads T   caption server sender threads (default 4)\n"
+        "  --port P             caption server port (default: free port)\n"
+        "  --connect HOST:PORT  subscribe to an existing server instead of starting one\n"
+        "  --json               print the report as JSON\n";
+}
+
+#ifndef _WIN32
+
+/**
+ * @brief 单个模拟订阅者：最小化的 WebSocket 客户端（只处理服务端文本帧 / ping / close）
+ */
+struct SimClient {
+    int fd = -1;
+    bool slow = false;
+    bool reconnect = false;
+    bool upgraded = false;
+    bool closed = false;
+    std::string inbox;
+    std::string outbox;
+
+    uint64_t lastSeq = 0;
+    uint64_t frames = 0;
+    uint64_t snapshots = 0;
+    uint64_t gaps = 0;            ///< 序号不连续且不是快照
+    bool awaitingFirstAfterResume = false;
+};
+
+// 已完成握手或确认失败的连接数，发布方等待全部连接就绪后开始计时
+std::atomic<int> g_settled{0};
+
+struct ThreadResult {
+    std::vector<int64_t> latenciesUs;
+    uint64_t frames = 0;
+    uint64_t snapshots = 0;
+    uint64_t gaps = 0;
+    uint64_t connected = 0;
+    uint64_t failedConnects = 0;
+    uint64_t disconnects = 0;
+    uint64_t slowFrames = 0;
+    uint64_t slowSnapshots = 0;
+    uint64_t resumesWithDelta = 0;
+    uint64_t resumesWithSnapshot = 0;
+};
+
+bool extractUint(const std::string& payload, const char* key, uint64_t& value) {
+    const size_t pos = payload.find(key);
+    if (pos == std::string::npos) return false;
+    value = std::strtoull(payload.c_str() + pos + std::strlen(key), nullptr, 10);
+    return true;
+}
+
+bool openConnection(SimClient& client, const std::string& host, int port, bool hasSince, uint64_t since) {
+    client.fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (client.fd < 0) return false;
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (::inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1 ||
+        ::connect(client.fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(client.fd);
+        client.fd = -1;
+        return false;
+    }
+    int one = 1;
+    ::setsockopt(client.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (client.slow) {
+        // 慢速客户端：缩小接收缓冲，尽快让服务端感受到背压
+        int small = 4096;
+        ::setsockopt(client.fd, SOL_SOCKET, SO_RCVBUF, &small, sizeof(small));
+    }
+
+    // 握手请求立即发出（服务端握手超时只有几秒，不能等全部连接建立后再发）
+    std::string path = "/captions";
+    if (hasSince) path += "?since=" + std::to_string(since);
+    const std::string request = "GET " + path + " HTTP/1.1\r\n"
+                                "Host: " + host + ":" + std::to_string(port) + "\r\n"
+                                "Upgrade: websocket\r\n"
+                                "Connection: Upgrade\r\n"
+                                "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                                "Sec-WebSocket-Version: 13\r\n\r\n";
+    if (::send(client.fd, request.data(), request.size(), 0) != static_cast<ssize_t>(request.size())) {
+        ::close(client.fd);
+        client.fd = -1;
+        return false;
+    }
+    ::fcntl(client.fd, F_SETFL, ::fcntl(client.fd, F_GETFL) | O_NONBLOCK);
+
+    client.outbox.clear();
+    client.inbox.clear();
+    client.upgraded = false;
+    client.closed = false;
+    return true;
+}
+
+void closeConnection(SimClient& client) {
+    if (client.fd >= 0) {
+        ::close(client.fd);
+        client.fd = -1;
+    }
+    client.closed = true;
+}
+
+/**
+ * @brief 客户端发往服务端的帧必须加掩码（掩码为 0 时内容不变）
+ */
+void queueControlFrame(SimClient& client, uint8_t opcode, const std::string& payload) {
+    const size_t length = std::min<size_t>(payload.size(), 125);
+    client.outbox.push_back(static_cast<char>(0x80 | opcode));
+    client.outbox.push_back(static_cast<char>(0x80 | length));
+    client.outbox.append(4, '\0');
+    client.outbox.append(payload, 0, length);
+}
+
+void handleFrame(SimClient& client, uint8_t opcode, const std::string& payload, ThreadResult& result,
+                 bool measure) {
+    if (opcode == 0x9) {
+        queueControlFrame(client, 0xA, payload);
+        return;
+    }
+    if (opcode == 0x8) {
+        closeConnection(client);
+        result.disconnects++;
+        return;
+    }
+    if (opcode != 0x1) {
+        return;
+    }
+
+    uint64_t seq = 0;
+    uint64_t tsUs = 0;
+    extractUint(payload, "\"seq\":", seq);
+    const bool snapshot = payload.find("\"type\":\"snapshot\"") != std::string::npos;
+
+    if (client.awaitingFirstAfterResume) {
+        client.awaitingFirstAfterResume = false;
+        (snapshot ? result.resumesWithSnapshot : result.resumesWithDelta)++;
+    }
+    if (!snapshot && client.lastSeq != 0 && seq != client.lastSeq + 1) {
+        client.gaps++;
+        result.gaps++;
+    }
+    client.lastSeq = std::max(client.lastSeq, seq);
+    client.frames++;
+    result.frames++;
+    if (snapshot) {
+        client.snapshots++;
+        result.snapshots++;
+    }
+    if (client.slow) {
+        result.slowFrames++;
+        if (snapshot) result.slowSnapshots++;
+    } else if (measure && !snapshot && extractUint(payload, "\"ts_us\":", tsUs)) {
+        result.latenciesUs.push_back(nowUs() - static_cast<int64_t>(tsUs));
+    }
+}
+
+/**
+ * @brief 解析收到的数据：先是 101 握手响应，之后是服务端（不带掩码）的帧
+ */
+void parseInbox(SimClient& client, ThreadResult& result, bool measure) {
+    if (!client.upgraded) {
+        const size_t end = client.inbox.find("\r\n\r\n");
+        if (end == std::string::npos) return;
+        g_settled++;
+        if (client.inbox.compare(0, 12, "HTTP/1.1 101") != 0) {
+            closeConnection(client);
+            result.failedConnects++;
+            return;
+        }
+        client.upgraded = true;
+        result.connected++;
+        client.inbox.erase(0, end + 4);
+    }
+
+    size_t offset = 0;
+    while (!client.closed) {
+        const size_t available = client.inbox.size() - offset;
+        if (available < 2) break;
+        const auto* bytes = reinterpret_cast<const uint8_t*>(client.inbox.data() + offset);
+        const uint8_t opcode = bytes[0] & 0x0F;
+        uint64_t length = bytes[1] & 0x7F;
+        size_t header = 2;
+        if (length == 126) {
+            if (available < 4) break;
+            length = (static_cast<uint64_t>(bytes[2]) << 8) | bytes[3];
+            header = 4;
+        } else if (length == 127) {
+            if (available < 10) break;
+            length = 0;
+            for (int i = 0; i < 8; ++i) length = (length << 8) | bytes[2 + i];
+            header = 10;
+        }
+        if (available < header + length) break;
+        handleFrame(client, opcode, client.inbox.substr(offset + header, length), result, measure);
+        offset += header + length;
+    }
+    client.inbox.erase(0, offset);
+}
+
+void clientThread(std::vector<SimClient>& clients, const std::string& host, int port,
+                  std::atomic<bool>& running, std::atomic<bool>& slowRelease, std::atomic<bool>& reconnectNow,
+                  ThreadResult& result) {
+    std::vector<pollfd> fds;
+    std::vector<size_t> owners;
+    char buffer[65536];
+    bool reconnectDone = false;
+
+    for (auto& client : clients) {
+        if (!openConnection(client, host, port, false, 0)) {
+            result.failedConnects++;
+            g_settled++;
+            client.closed = true;
+        }
+    }
+
+    while (running) {
+        if (reconnectNow && !reconnectDone) {
+            reconnectDone = true;
+            for (auto& client : clients) {
+                if (!client.reconnect || client.closed) continue;
+                const uint64_t since = client.lastSeq;
+                closeConnection(client);
+                if (openConnection(client, host, port, since != 0, since)) {
+                    client.awaitingFirstAfterResume = true;
+                } else {
+                    result.failedConnects++;
+                }
+            }
+        }
+
+        const bool drainSlow = slowRelease;
+        fds.clear();
+        owners.clear();
+        for (size_t i = 0; i < clients.size(); ++i) {
+            auto& client = clients[i];
+            if (client.closed || client.fd < 0) continue;
+            short events = 0;
+            if (!client.slow || drainSlow || !client.upgraded) events |= POLLIN;
+            if (!client.outbox.empty()) events |= POLLOUT;
+            if (events == 0) continue;
+            fds.push_back(pollfd{client.fd, events, 0});
+            owners.push_back(i);
+        }
+        if (fds.empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        if (::poll(fds.data(), fds.size(), 50) <= 0) continue;
+
+        for (size_t k = 0; k < fds.size(); ++k) {
+            auto& client = clients[owners[k]];
+            const short revents = fds[k].revents;
+            if (revents & POLLOUT) {
+                const ssize_t n = ::send(client.fd, client.outbox.data(), client.outbox.size(), 0);
+                if (n > 0) client.outbox.erase(0, static_cast<size_t>(n));
+            }
+            if (revents & (POLLIN | POLLHUP | POLLERR)) {
+                const ssize_t n = ::recv(client.fd, buffer, sizeof(buffer), 0);
+                if (n > 0) {
+                    client.inbox.append(buffer, static_cast<size_t>(n));
+                    parseInbox(client, result, !drainSlow);
+                } else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                    if (!client.upgraded) g_settled++;
+                    closeConnection(client);
+                    result.disconnects++;
+                }
+            }
+        }
+    }
+
+    for (auto& client : clients) {
+        closeConnection(client);
+    }
+}
+
+/**
+ * @brief 模拟转录：最后一句不断增长，每隔约 2 秒定稿并开始新的一句
+ */
+class TranscriptSimulator {
+public:
+    explicit TranscriptSimulator(int rateHz) : definiteEvery_(std::max(1, rateHz * 2)) {}
+
+    const std::vector<Asr::CachedUtterance>& next() {
+        if (utterances_.empty() || utterances_.back().definite) {
+            Asr::CachedUtterance utterance;
+            utterance.startMs = nextStartMs_;
+            utterance.endMs = nextStartMs_;
+            utterances_.push_back(utterance);
+        }
+        auto& current = utterances_.back();
+        current.text += kWords[tick_ % kWordCount];
+        current.endMs += 50;
+        if (++tick_ % definiteEvery_ == 0) {
+            current.definite = true;
+            nextStartMs_ = current.endMs + 300;
+        }
+        return utterances_;
+    }
+
+private:
+    static constexpr const char* kWords[] = {"字幕", "广播", "测试", "实时", "转录", "延迟", "订阅", "快照"};
+    static constexpr int kWordCount = 8;
+
+    int definiteEvery_;
+    uint64_t tick_ = 0;
+    int64_t nextStartMs_ = 0;
+    std::vector<Asr::CachedUtterance> utterances_;
+};
+
+constexpr const char* TranscriptSimulator::kWords[];
+
+void raiseFileLimit() {
+    rlimit limit{};
+    if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+int64_t percentile(std::vector<int64_t>& values, double p) {
+    if (values.empty()) return 0;
+    const size_t index = std::min(values.size() - 1, static_cast<size_t>(p * (values.size() - 1)));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+int runLoadTest(const Options& options) {
+    raiseFileLimit();
+
+    std::string host = "127.0.0.1";
+    int port = options.port;
+    std::unique_ptr<perfx::logic::CaptionServer> server;
+
+    if (!options.connectHost.empty()) {
+        const size_t colon = options.connectHost.rfind(':');
+        if (colon == std::string::npos) {
+            std::cerr << "--connect expects HOST:PORT" << std::endl;
+            return 2;
+        }
+        host = options.connectHost.substr(0, colon);
+        port = std::atoi(options.connectHost.c_str() + colon + 1);
+    } else {
+        perfx::logic::CaptionServerConfig config;
+        config.host = host;
+        config.port = port > 0 ? port : 0;
+        config.maxClients = static_cast<size_t>(options.clients) + 64;
+        config.senderThreads = options.senderThreads;
+        if (config.port == 0) {
+            // 让内核分配端口：先绑定临时套接字取得空闲端口
+            int probe = ::socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            socklen_t length = sizeof(addr);
+            if (probe >= 0 && ::bind(probe, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 &&
+                ::getsockname(probe, reinterpret_cast<sockaddr*>(&addr), &length) == 0) {
+                config.port = ntohs(addr.sin_port);
+            }
+            if (probe >= 0) ::close(probe);
+        }
+        port = config.port;
+        server = std::make_unique<perfx::logic::CaptionServer>(config);
+        std::string error;
+        if (!server->start(error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+    }
+
+    // 分配客户端到各个 poll 线程
+    const int threadCount = std::max(1, std::min(options.clientThreads, options.clients));
+    std::vector<std::vector<SimClient>> groups(threadCount);
+    for (int i = 0; i < options.clients; ++i) {
+        SimClient client;
+        client.slow = i < options.slowClients;
+        client.reconnect = !client.slow && i < options.slowClients + options.reconnectClients;
+        groups[i % threadCount].push_back(std::move(client));
+    }
+
+    std::atomic<bool> running{true};
+    std::atomic<bool> slowRelease{false};
+    std::atomic<bool> reconnectNow{false};
+    std::vector<ThreadResult> results(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back(clientThread, std::ref(groups[t]), host, port, std::ref(running),
+                             std::ref(slowRelease), std::ref(reconnectNow), std::ref(results[t]));
+    }
+
+    // 等待订阅者连接完成后开始发布
+    const auto connectDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (g_settled < options.clients && std::chrono::steady_clock::now() < connectDeadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    std::fprintf(stderr, "%d/%d subscribers settled, publishing\n", g_settled.load(), options.clients);
+
+    TranscriptSimulator simulator(options.rateHz);
+    const auto interval = std::chrono::microseconds(1000000 / std::max(1, options.rateHz));
+    const auto begin = std::chrono::steady_clock::now();
+    const auto end = begin + std::chrono::seconds(options.seconds);
+    auto nextTick = begin;
+    uint64_t published = 0;
+    int64_t publishCostUs = 0;
+    int64_t maxPublishCostUs = 0;
+
+    while (std::chrono::steady_clock::now() < end) {
+        if (server) {
+            const int64_t t0 = nowUs();
+            server->publish(simulator.next());
+            const int64_t cost = nowUs() - t0;
+            publishCostUs += cost;
+            maxPublishCostUs = std::max(maxPublishCostUs, cost);
+            published++;
+        }
+        if (!reconnectNow && std::chrono::steady_clock::now() - begin >= std::chrono::seconds(options.seconds) / 2) {
+            reconnectNow = true;
+        }
+        nextTick += interval;
+        std::this_thread::sleep_until(nextTick);
+    }
+
+    // 放开慢速客户端，确认它们最终收到快照而不是完整积压
+    slowRelease = true;
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    running = false;
+    for (auto& thread : threads) thread.join();
+
+    ThreadResult total;
+    for (auto& result : results) {
+        total.latenciesUs.insert(total.latenciesUs.end(), result.latenciesUs.begin(), result.latenciesUs.end());
+        total.frames += result.frames;
+        total.snapshots += result.snapshots;
+        total.gaps += result.gaps;
+        total.connected += result.connected;
+        total.failedConnects += result.failedConnects;
+        total.disconnects += result.disconnects;
+        total.slowFrames += result.slowFrames;
+        total.slowSnapshots += result.slowSnapshots;
+        total.resumesWithDelta += result.resumesWithDelta;
+        total.resumesWithSnapshot += result.resumesWithSnapshot;
+    }
+
+    json report = {
+        {"clients", options.clients},
+        {"slow_clients", options.slowClients},
+        {"reconnect_clients", options.reconnectClients},
+        {"rate_hz", options.rateHz},
+        {"seconds", options.seconds},
+        {"connections", total.connected},
+        {"failed_connects", total.failedConnects},
+        {"disconnects", total.disconnects},
+        {"frames_received", total.frames},
+        {"snapshots_received", total.snapshots},
+        {"sequence_gaps", total.gaps},
+        {"slow_frames_received", total.slowFrames},
+        {"slow_snapshots_received", total.slowSnapshots},
+        {"resumes_with_delta", total.resumesWithDelta},
+        {"resumes_with_snapshot", total.resumesWithSnapshot},
+        {"latency_us", {
+            {"samples", total.latenciesUs.size()},
+            {"p50", percentile(total.latenciesUs, 0.50)},
+            {"p95", percentile(total.latenciesUs, 0.95)},
+            {"p99", percentile(total.latenciesUs, 0.99)},
+            {"max", percentile(total.latenciesUs, 1.0)}
+        }}
+    };
+    if (server) {
+        const auto stats = server->getStats();
+        report["server"] = {
+            {"published", published},
+            {"publish_avg_us", published ? publishCostUs / static_cast<int64_t>(published) : 0},
+            {"publish_max_us", maxPublishCostUs},
+            {"frames_sent", stats.framesSent},
+            {"frames_dropped", stats.framesDropped},
+            {"snapshots_sent", stats.snapshotsSent},
+            {"resumes", stats.resumes},
+            {"stalled_disconnects", stats.stalledDisconnects}
+        };
+        server->stop();
+    }
+
+    if (options.asJson) {
+        std::printf("%s\n", report.dump(2).c_str());
+        return 0;
+    }
+
+    const auto& latency = report["latency_us"];
+    std::printf("Subscribers: %d (%d slow, %d reconnecting), connected %llu, failed %llu, disconnects %llu\n",
+                options.clients, options.slowClients, options.reconnectClients,
+                static_cast<unsigned long long>(total.connected),
+                static_cast<unsigned long long>(total.failedConnects),
+                static_cast<unsigned long long>(total.disconnects));
+    std::printf("Frames received: %llu (snapshots %llu, sequence gaps %llu)\n",
+                static_cast<unsigned long long>(total.frames),
+                static_cast<unsigned long long>(total.snapshots),
+                static_cast<unsigned long long>(total.gaps));
+    std::printf("Latency publish->receive: p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms (%zu samples)\n",
+                latency["p50"].get<int64_t>() / 1000.0, latency["p95"].get<int64_t>() / 1000.0,
+                latency["p99"].get<int64_t>() / 1000.0, latency["max"].get<int64_t>() / 1000.0,
+                total.latenciesUs.size());
+    std::printf("Slow clients: %llu frames after release (%llu snapshots)\n",
+                static_cast<unsigned long long>(total.slowFrames),
+                static_cast<unsigned long long>(total.slowSnapshots));
+    std::printf("Resumes: %llu with deltas, %llu fell back to snapshot\n",
+                static_cast<unsigned long long>(total.resumesWithDelta),
+                static_cast<unsigned long long>(total.resumesWithSnapshot));
+    if (report.contains("server")) {
+        const auto& stats = report["server"];
+        std::printf("Server: %llu updates (publish avg %lld us, max %lld us), %llu frames sent, "
+                    "%llu dropped, %llu snapshots, %llu resumes, %llu stalled\n",
+                    stats["published"].get<unsigned long long>(),
+                    stats["publish_avg_us"].get<long long>(), stats["publish_max_us"].get<long long>(),
+                    stats["frames_sent"].get<unsigned long long>(),
+                    stats["frames_dropped"].get<unsigned long long>(),
+                    stats["snapshots_sent"].get<unsigned long long>(),
+                    stats["resumes"].get<unsigned long long>(),
+                    stats["stalled_disconnects"].get<unsigned long long>());
+    }
+    return 0;
+}
+
+#endif
+
+bool parseIntArg(int argc, char* argv[], int& i, int& value) {
+    if (i + 1 >= argc) {
+        std::cerr << "Missing value for " << argv[i] << std::endl;
+        return false;
+    }
+    char* end = nullptr;
+    value = static_cast<int>(std::strtol(argv[++i], &end, 10));
+    return end && *end == '\0' && value >= 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        bool ok = true;
+        if (arg == "--clients") ok = parseIntArg(argc, argv, i, options.clients);
+        else if (arg == "--slow") ok = parseIntArg(argc, argv, i, options.slowClients);
+        else if (arg == "--reconnect") ok = parseIntArg(argc, argv, i, options.reconnectClients);
+        else if (arg == "--rate") ok = parseIntArg(argc, argv, i, options.rateHz);
+        else if (arg == "--seconds") ok = parseIntArg(argc, argv, i, options.seconds);
+        else if (arg == "--threads") ok = parseIntArg(argc, argv, i, options.clientThreads);
+        else if (arg == "--sender-threads") ok = parseIntArg(argc, argv, i, options.senderThreads);
+        else if (arg == "--port") ok = parseIntArg(argc, argv, i, options.port);
+        else if (arg == "--connect" && i + 1 < argc) options.connectHost = argv[++i];
+        else if (arg == "--json") options.asJson = true;
+        else if (arg == "-h" || arg == "--help") {
+            printUsage();
+            return 0;
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            ok = false;
+        }
+        if (!ok) {
+            printUsage();
+            return 2;
+        }
+    }
+
+#ifndef _WIN32
+    // 报告写到 stdout（printf），服务器日志（std::cout）改写到 stderr
+    std::cout.rdbuf(std::cerr.rdbuf());
+    return runLoadTest(options);
+#else
+    std::cerr << "perfx-caption-loadtest requires POSIX sockets" << std::endl;
+    return 1;
+#endif
+}
@@ -0,0 +1,373 @@
+//
+// 守护进程本地控制套接字实现
+//
+
+#include "control_server.h"
+#include <cstdlib>
+#include <iostream>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using json = nlohmann::json;
+
+namespace perfx {
+namespace cli {
+
+namespace {
+
+// 接收线程轮询间隔，决定 stop() 的最长等待
+constexpr int kAcceptPollMs = 200;
+// 单行请求的长度上限，超过视为协议错误并断开
+constexpr size_t kMaxRequestBytes = 1024 * 1024;
+// 发送超时：客户端长时间不读取时断开，避免发送线程卡住
+constexpr int kSendTimeoutMs = 1000;
+// 每个连接待发送数据的上限，超过说明客户端跟不上事件推送，断开
+constexpr size_t kMaxQueuedBytes = 4 * 1024 * 1024;
+
+#ifndef _WIN32
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;  // macOS：由 SO_NOSIGPIPE 屏蔽 SIGPIPE
+#endif
+
+/**
+ * @brief 创建 AF_UNIX 流套接字（close-on-exec）
+ */
+int createUnixSocket() {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0) {
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    return fd;
+}
+
+void configureConnection(int fd) {
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    timeval timeout{};
+    timeout.tv_sec = kSendTimeoutMs / 1000;
+    timeout.tv_usec = (kSendTimeoutMs % 1000) * 1000;
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+#ifdef SO_NOSIGPIPE
+    int on = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+}
+
+#endif
+
+} // namespace
+
+// ============================================================================
+// ControlConnection
+// ============================================================================
+
+ControlConnection::ControlConnection(int fd) : fd_(fd) {
+#ifndef _WIN32
+    writer_ = std::thread(&ControlConnection::writerLoop, this);
+#endif
+}
+
+ControlConnection::~ControlConnection() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        finishing_ = true;
+    }
+    queueCv_.notify_all();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+#ifndef _WIN32
+    ::close(fd_);
+#endif
+}
+
+bool ControlConnection::sendLine(const std::string& line) {
+#ifndef _WIN32
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        if (closed_) {
+            return false;
+        }
+        if (queuedBytes_ + line.size() + 1 > kMaxQueuedBytes) {
+            std::cerr << "[DAEMON] Control client is not reading, disconnecting" << std::endl;
+        } else {
+            queue_.push_back(line + "\n");
+            queuedBytes_ += queue_.back().size();
+            queueCv_.notify_one();
+            return true;
+        }
+    }
+    shutdown();
+    return false;
+#else
+    (void)line;
+    return false;
+#endif
+}
+
+void ControlConnection::writerLoop() {
+#ifndef _WIN32
+    while (true) {
+        std::string data;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            queueCv_.wait(lock, [this] { return closed_ || finishing_ || !queue_.empty(); });
+            if (closed_ || queue_.empty()) {
+                return;
+            }
+            data = std::move(queue_.front());
+            queue_.pop_front();
+            queuedBytes_ -= data.size();
+        }
+
+        size_t written = 0;
+        while (written < data.size()) {
+            ssize_t n = ::send(fd_, data.data() + written, data.size() - written, kSendFlags);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                shutdown();
+                return;
+            }
+            written += static_cast<size_t>(n);
+        }
+    }
+#endif
+}
+
+void ControlConnection::shutdown() {
+#ifndef _WIN32
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        closed_ = true;
+        queue_.clear();
+        queuedBytes_ = 0;
+    }
+    queueCv_.notify_all();
+    ::shutdown(fd_, SHUT_RDWR);
+#endif
+}
+
+// ============================================================================
+// ControlServer
+// ============================================================================
+
+ControlServer::ControlServer(std::string socketPath) : socketPath_(std::move(socketPath)) {}
+
+ControlServer::~ControlServer() {
+    stop();
+}
+
+std::string ControlServer::defaultSocketPath() {
+    if (const char* runtimeDir = std::getenv("XDG_RUNTIME_DIR")) {
+        if (*runtimeDir) {
+            return std::string(runtimeDir) + "/perfx-agent.sock";
+        }
+    }
+#ifndef _WIN32
+    return "/tmp/perfx-agent-" + std::to_string(::getuid()) + ".sock";
+#else
+    return "perfx-agent.sock";
+#endif
+}
+
+#ifndef _WIN32
+
+bool ControlServer::start(Handler handler, std::string& error) {
+    if (running_) {
+        return true;
+    }
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socketPath_.size() >= sizeof(addr.sun_path)) {
+        error = "Socket path too long: " + socketPath_;
+        return false;
+    }
+    std::strncpy(addr.sun_path, socketPath_.c_str(), sizeof(addr.sun_path) - 1);
+
+    // 已有守护进程在监听时拒绝启动；残留的套接字文件直接删除
+    int probe = createUnixSocket();
+    if (probe >= 0) {
+        if (::connect(probe, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+            ::close(probe);
+            error = "Another daemon is already listening on " + socketPath_;
+            return false;
+        }
+        ::close(probe);
+    }
+    ::unlink(socketPath_.c_str());
+
+    listenFd_ = createUnixSocket();
+    if (listenFd_ < 0) {
+        error = std::string("socket() failed: ") + std::strerror(errno);
+        return false;
+    }
+
+    // 绑定前收紧 umask，避免套接字文件在 chmod 之前短暂可被他人连接
+    const mode_t oldMask = ::umask(0177);
+    const int bound = ::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    ::umask(oldMask);
+    if (bound != 0 || ::listen(listenFd_, 8) != 0) {
+        error = "Failed to listen on " + socketPath_ + ": " + std::strerror(errno);
+        ::close(listenFd_);
+        listenFd_ = -1;
+        return false;
+    }
+
+    handler_ = std::move(handler);
+    running_ = true;
+    acceptThread_ = std::thread(&ControlServer::acceptLoop, this);
+    std::cerr << "[DAEMON] Control socket listening on " << socketPath_ << std::endl;
+    return true;
+}
+
+void ControlServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (acceptThread_.joinable()) {
+        acceptThread_.join();
+    }
+    ::close(listenFd_);
+    listenFd_ = -1;
+    ::unlink(socketPath_.c_str());
+
+    std::vector<Worker> workers;
+    {
+        std::lock_guard<std::mutex> lock(workersMutex_);
+        workers.swap(workers_);
+    }
+    for (auto& worker : workers) {
+        worker.connection->shutdown();
+    }
+    for (auto& worker : workers) {
+        if (worker.thread.joinable()) {
+            worker.thread.join();
+        }
+    }
+}
+
+void ControlServer::acceptLoop() {
+    while (running_) {
+        pollfd pfd{listenFd_, POLLIN, 0};
+        const int ready = ::poll(&pfd, 1, kAcceptPollMs);
+        reapFinished();
+        if (ready <= 0 || !(pfd.revents & POLLIN)) {
+            continue;
+        }
+        const int fd = ::accept(listenFd_, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+        configureConnection(fd);
+
+        auto connection = std::make_shared<ControlConnection>(fd);
+        auto finished = std::make_shared<std::atomic<bool>>(false);
+        std::lock_guard<std::mutex> lock(workersMutex_);
+        workers_.push_back(Worker{connection, std::thread([this, connection, finished]() {
+            serveConnection(connection);
+            *finished = true;
+        }), finished});
+    }
+}
+
+void ControlServer::reapFinished() {
+    std::lock_guard<std::mutex> lock(workersMutex_);
+    for (auto it = workers_.begin(); it != workers_.end();) {
+        if (*it->finished) {
+            it->thread.join();
+            it = workers_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ControlServer::serveConnection(std::shared_ptr<ControlConnection> connection) {
+    std::string buffer;
+    char chunk[4096];
+    while (running_) {
+        const ssize_t n = ::recv(connection->fd(), chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+        if (buffer.size() > kMaxRequestBytes) {
+            connection->sendLine(json{{"ok", false}, {"error", "request too large"}}.dump(-1, ' ', false, json::error_handler_t::replace));
+            break;
+        }
+
+        size_t newline;
+        while ((newline = buffer.find('\n')) != std::string::npos) {
+            std::string line = buffer.substr(0, newline);
+            buffer.erase(0, newline + 1);
+            if (line.empty() || line == "\r") {
+                continue;
+            }
+
+            json response;
+            try {
+                response = handler_(json::parse(line), *connection);
+            } catch (const json::exception& e) {
+                response = {{"ok", false}, {"error", std::string("invalid request: ") + e.what()}};
+            } catch (const std::exception& e) {
+                response = {{"ok", false}, {"error", e.what()}};
+            }
+            if (!connection->sendLine(response.dump(-1, ' ', false, json::error_handler_t::replace))) {
+                return;
+            }
+        }
+    }
+    connection->setSubscribed(false);
+}
+
+void ControlServer::broadcast(const json& event) {
+    // 识别文本可能含非法 UTF-8，替换而不是抛异常
+    const std::string line = event.dump(-1, ' ', false, json::error_handler_t::replace);
+    std::vector<std::shared_ptr<ControlConnection>> subscribers;
+    {
+        std::lock_guard<std::mutex> lock(workersMutex_);
+        for (auto& worker : workers_) {
+            if (worker.connection->isSubscribed()) {
+                subscribers.push_back(worker.connection);
+            }
+        }
+    }
+    for (auto& connection : subscribers) {
+        connection->sendLine(line);
+    }
+}
+
+#else
+
+bool ControlServer::start(Handler, std::string& error) {
+    error = "Daemon mode requires Unix domain sockets and is not supported on this platform";
+    return false;
+}
+
+void ControlServer::stop() {}
+void ControlServer::acceptLoop() {}
+void ControlServer::serveConnection(std::shared_ptr<ControlConnection>) {}
+void ControlServer::reapFinished() {}
+void ControlServer::broadcast(const json&) {}
+
+#endif
+
+} // namespace cli
+} // namespace perfx
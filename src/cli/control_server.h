@@ -0,0 +1,128 @@
+//
+// 守护进程本地控制套接字
+//
+// 在 Unix 域套接字上接收以换行分隔的 JSON 请求，每个请求返回一行 JSON 响应。
+// 订阅了事件的连接还会收到服务端主动推送的事件行（同样以换行分隔）。
+// 套接字文件权限为 0600，只有启动守护进程的用户可以连接。
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace perfx {
+namespace cli {
+
+/**
+ * @brief 控制连接
+ *
+ * 发送经有界队列交给本连接的发送线程，调用方（事件推送、请求处理）不会被慢读的客户端阻塞；
+ * 队列超限时断开该连接
+ */
+class ControlConnection {
+public:
+    explicit ControlConnection(int fd);
+    ~ControlConnection();
+
+    ControlConnection(const ControlConnection&) = delete;
+    ControlConnection& operator=(const ControlConnection&) = delete;
+
+    /**
+     * @brief 排队发送一行（自动追加换行），多个线程可同时调用，不阻塞
+     * @return 连接已断开或发送队列已满（随即断开）时返回 false
+     */
+    bool sendLine(const std::string& line);
+
+    void setSubscribed(bool subscribed) { subscribed_ = subscribed; }
+    bool isSubscribed() const { return subscribed_; }
+
+    int fd() const { return fd_; }
+
+    /**
+     * @brief 立即断开，丢弃尚未发送的数据
+     */
+    void shutdown();
+
+private:
+    void writerLoop();
+
+    int fd_;
+    std::mutex queueMutex_;
+    std::condition_variable queueCv_;
+    std::deque<std::string> queue_;
+    size_t queuedBytes_ = 0;
+    bool finishing_ = false;            // 析构：发完已排队的数据后退出
+    std::atomic<bool> subscribed_{false};
+    std::atomic<bool> closed_{false};
+    std::thread writer_;
+};
+
+/**
+ * @brief Unix 域套接字控制服务器
+ *
+ * 每个连接一个线程（控制连接数量很少，请求可能阻塞较长时间，如文件识别）
+ */
+class ControlServer {
+public:
+    using Handler = std::function<nlohmann::json(const nlohmann::json& request, ControlConnection& connection)>;
+
+    explicit ControlServer(std::string socketPath);
+    ~ControlServer();
+
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+
+    /**
+     * @brief 绑定套接字并启动接收线程
+     * @param error 失败原因
+     */
+    bool start(Handler handler, std::string& error);
+
+    /**
+     * @brief 关闭监听与全部连接，删除套接字文件
+     */
+    void stop();
+
+    /**
+     * @brief 向所有订阅了事件的连接推送一行 JSON
+     */
+    void broadcast(const nlohmann::json& event);
+
+    const std::string& getSocketPath() const { return socketPath_; }
+
+    /**
+     * @brief 默认套接字路径：$XDG_RUNTIME_DIR/perfx-agent.sock，未设置时为 /tmp/perfx-agent-<uid>.sock
+     */
+    static std::string defaultSocketPath();
+
+private:
+    void acceptLoop();
+    void serveConnection(std::shared_ptr<ControlConnection> connection);
+    void reapFinished();
+
+    struct Worker {
+        std::shared_ptr<ControlConnection> connection;
+        std::thread thread;
+        std::shared_ptr<std::atomic<bool>> finished;
+    };
+
+    std::string socketPath_;
+    Handler handler_;
+    int listenFd_ = -1;
+    std::atomic<bool> running_{false};
+    std::thread acceptThread_;
+    std::mutex workersMutex_;
+    std::vector<Worker> workers_;
+};
+
+} // namespace cli
+} // namespace perfx
@@ -0,0 +1,2045 @@
+//
+// perfx-cli：无界面命令行工具 / 守护进程
+//
+// 子命令：
+//   transcribe [--json] [--timeout MS] [--export srt|vtt|lrc|json] [--words] [--index DIR]
+//              [--priority live|interactive|batch] <file>...
+//                                                    批量识别音频文件，可导出字幕文件、加入全文索引
+//   search [--index DIR] [--limit N] [--json] <query>...
+//                                                    在全文索引中查找说过某句话的录音与时间点
+//   live [--device N|NAME] [--virtual SPEC] [--jsonl] [--no-vad] [--no-processing] [--duration SEC]
+//        [--partial] [--captions [HOST:]PORT] [--channels N] [--group LABEL=CH,CH]...
+//        [--source [LABEL=]DEVICE]... [--virtual-source [LABEL=]SPEC]... [--mix] [--no-drift-correction]
+//                                                    实时采集识别，结果输出到 stdout；多声道 / 多输入源时每个声道（组）/ 源一个会话
+//   devices [--json]                                  列出输入设备（含 PERFX_VIRTUAL_DEVICES 注册的虚拟设备）
+//   bench [--seconds N] [--file F] [--capture SPEC] [--index-hours H] [--channels N] [--drift PPM]
+//         [--link PROFILE] [--json]
+//                                                     处理链 / VAD / 采集链路 / 多声道拆分 / 多源漂移补偿 / 文件识别 / 全文索引基准
+//   replay [--mode inject|server|client] [--speed X|--fast] [--port N] [--url URL] [--json] <capture>
+//                                                     回放 ASR 会话抓包（PERFX_ASR_CAPTURE_DIR 录制），无需连接云端
+//   daemon [--socket PATH] [--captions [HOST:]PORT]   常驻后台，通过本地控制套接字接收命令
+//
+// 设置 PERFX_TRACE=<file.json> 时记录事件追踪，退出时写出 Chrome trace（守护进程另有 trace.start / trace.stop 命令）。
+// 结果写到 stdout，库内部日志统一重定向到 stderr，便于管道处理。
+//
+
+#include "control_server.h"
+#include "asr/asr_client.h"
+#include "asr/packet_size_controller.h"
+#include "asr/request_scheduler.h"
+#include "asr/session_capture.h"
+#include "asr/transcript_exporter.h"
+#include "asr/transcript_stitcher.h"
+#include "audio/audio_device.h"
+#include "audio/audio_processing_chain.h"
+#include "audio/audio_thread.h"
+#include "audio/capture_graph.h"
+#include "audio/channel_splitter.h"
+#include "audio/device_registry.h"
+#include "audio/dsp_kernels.h"
+#include "audio/latency_metrics.h"
+#include "audio/trace_events.h"
+#include "audio/voice_activity_detector.h"
+#include "logic/caption_server.h"
+#include "logic/transcript_index.h"
+#include "logic/transcription_engine.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+using perfx::logic::CaptionServer;
+using perfx::logic::CaptionServerConfig;
+using perfx::logic::LiveOptions;
+using perfx::logic::LiveSource;
+using perfx::logic::LiveStats;
+using perfx::logic::TranscriptIndex;
+using perfx::logic::TranscriptIndexConfig;
+using perfx::logic::TranscriptionEngine;
+using perfx::logic::TranscriptUpdate;
+
+namespace {
+
+std::atomic<bool> g_stopRequested{false};
+
+// 结果输出流：指向原始 stdout；std::cout 被重定向到 stderr 用于日志
+std::ostream* g_out = nullptr;
+std::mutex g_outMutex;
+
+void onSignal(int) {
+    g_stopRequested = true;
+}
+
+void installSignalHandlers() {
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+#ifdef SIGPIPE
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+}
+
+void printUsage() {
+    std::cerr <<
+        "Usage: perfx-cli <command> [options]\n"
+        "\n"
+        "Commands:\n"
+        "  transcribe [--json] [--timeout MS] [--export srt|vtt|lrc|json] [--words] [--index DIR]\n"
+        "             [--priority live|interactive|batch] <file>...\n"
+        "      Recognize audio files and print the transcript.\n"
+        "      --export also writes <file stem>.<format> next to each input.\n"
+        "      --words adds word timings to the export (WebVTT tags, enhanced LRC, JSON words).\n"
+        "      --index adds each transcript to the full-text index in DIR.\n"
+        "      --priority sets the request scheduler class (default interactive); batch only uses\n"
+        "      session and audio quota left over by live and interactive requests.\n"
+        "  search [--index DIR] [--limit N] [--json] <query>...\n"
+        "      Find recordings and timestamps containing a phrase (default index: ./data/transcript_index).\n"
+        "  live [--device N|NAME] [--virtual SPEC] [--jsonl] [--no-vad] [--no-processing] [--duration SEC]\n"
+        "       [--partial] [--captions [HOST:]PORT] [--channels N] [--group LABEL=CH,CH]...\n"
+        "       [--source [LABEL=]DEVICE]... [--virtual-source [LABEL=]SPEC]... [--mix] [--no-drift-correction]\n"
+        "      Capture from an input device and stream recognized utterances to stdout.\n"
+        "      --channels N captures N channels and runs one ASR session per channel (labels ch1..chN);\n"
+        "      --group runs one session per group instead, mixing the listed channels (1-based).\n"
+        "      --virtual captures from a virtual device instead (see SPEC below).\n"
+        "      --source adds another input device (e.g. a PulseAudio/PipeWire monitor source) captured\n"
+        "      alongside --device (label \"mic\"); its clock drift is estimated and resampled away.\n"
+        "      Each source gets its own ASR session, or one mixed session with --mix.\n"
+        "      --captions also serves live captions on ws://HOST:PORT/captions (default host 127.0.0.1).\n"
+        "  devices [--json]\n"
+        "      List input devices.\n"
+        "  bench [--seconds N] [--file F] [--capture SPEC] [--index-hours H] [--channels N] [--drift PPM]\n"
+        "        [--link lan|wifi|cellular|satellite|all] [--json]\n"
+        "      Benchmark the processing chain and VAD; with --file also measure file ASR (cache disabled).\n"
+        "      --capture runs N seconds of a virtual device through the live capture pipeline.\n"
+        "      --index-hours builds a full-text index over H hours of synthetic transcript and times queries.\n"
+        "      --channels times the per-channel split + VAD path on N channels of synthetic audio.\n"
+        "      --drift captures two virtual devices whose clocks differ by PPM for N seconds, with and\n"
+        "      without drift correction, and reports the estimated drift and FIFO fill.\n"
+        "      --link simulates 600 s of live ASR over the link profile with fixed 50/100/200 ms and\n"
+        "      adaptive packet sizes, and reports result latency, packet rate and header overhead.\n"
+        "  replay [--mode inject|server|client] [--speed X|--fast] [--port N] [--url URL] [--json] <capture>\n"
+        "      Replay an ASR session capture (recorded with PERFX_ASR_CAPTURE_DIR=DIR) without the cloud.\n"
+        "      inject (default) feeds the server frames through the ASR client and prints the transcript.\n"
+        "      server serves the capture as a mock ASR server on 127.0.0.1:PORT (default 8766) until\n"
+        "      interrupted; point clients at it with PERFX_ASR_URL=ws://127.0.0.1:PORT.\n"
+        "      client sends the client frames to --url (default: a built-in mock server) and times responses.\n"
+        "      --speed scales the original timing (default 1); --fast replays without waiting.\n"
+        "  daemon [--socket PATH] [--captions [HOST:]PORT]\n"
+        "      Run in the background and accept JSON-line commands on a local control socket.\n"
+        "      Commands: status, devices, live.start, live.stop, transcript, transcribe, subscribe,\n"
+        "      trace.start, trace.stop, shutdown\n"
+        "\n"
+        "Virtual device SPEC: <file.wav|speech|sine[:HZ]|noise|silence>[,key=value...]\n"
+        "  keys: name, clock=realtime|free, speed, loop=0|1, jitter (ms), xrun (probability per buffer),\n"
+        "        seed, rate, channels      e.g. sample/38s.wav,speed=4,jitter=2,xrun=0.01\n"
+        "  PERFX_VIRTUAL_DEVICES=\"SPEC;SPEC\" registers virtual devices for all commands and the GUI.\n"
+        "\n"
+        "PERFX_TRACE=FILE records cross-thread trace events and writes Chrome trace JSON to FILE on exit\n"
+        "  (open in chrome://tracing or https://ui.perfetto.dev).\n";
+}
+
+std::string formatTimestamp(int64_t ms) {
+    std::ostringstream oss;
+    oss << std::setfill('0') << std::setw(2) << ms / 3600000 << ":"
+        << std::setw(2) << (ms / 60000) % 60 << ":"
+        << std::setw(2) << (ms / 1000) % 60 << "."
+        << std::setw(3) << ms % 1000;
+    return oss.str();
+}
+
+json utteranceToJson(const Asr::CachedUtterance& utterance) {
+    json result = {
+        {"text", utterance.text},
+        {"start_ms", utterance.startMs},
+        {"end_ms", utterance.endMs},
+        {"definite", utterance.definite}
+    };
+    if (!utterance.speaker.empty()) {
+        result["speaker"] = utterance.speaker;
+    }
+    return result;
+}
+
+json utterancesToJson(const std::vector<Asr::CachedUtterance>& utterances) {
+    json array = json::array();
+    for (const auto& utterance : utterances) {
+        array.push_back(utteranceToJson(utterance));
+    }
+    return array;
+}
+
+json packetSizeToJson(const Asr::PacketSizeStats& stats) {
+    json history = json::array();
+    for (const auto& decision : stats.history) {
+        history.push_back({
+            {"at_ms", decision.atMs},
+            {"from_ms", decision.fromMs},
+            {"to_ms", decision.toMs},
+            {"srtt_ms", decision.srttMs},
+            {"result_latency_ms", decision.resultLatencyMs},
+            {"reason", decision.reason}
+        });
+    }
+    return {
+        {"adaptive", stats.adaptive},
+        {"packet_ms", stats.packetMs},
+        {"srtt_ms", stats.srttMs},
+        {"rttvar_ms", stats.rttVarMs},
+        {"result_latency_ms", stats.resultLatencyMs},
+        {"losses", stats.losses},
+        {"changes", stats.changes},
+        {"history", history}
+    };
+}
+
+json memoryStatsToJson(const Asr::SessionMemoryStats& stats) {
+    return {
+        {"frames_encoded", stats.framesEncoded},
+        {"responses_decoded", stats.responsesDecoded},
+        {"allocations", stats.allocations()},
+        {"pool_hits", stats.poolHits},
+        {"pool_allocations", stats.poolAllocations},
+        {"scratch_growths", stats.scratchGrowths},
+        {"codec_inits", stats.codecInits},
+        {"block_bytes", stats.blockSize},
+        {"retained_bytes", stats.retainedBytes}
+    };
+}
+
+json schedulerStatsToJson(const Asr::SchedulerStats& stats) {
+    json priorities = json::object();
+    for (int i = 0; i < Asr::kRequestPriorityCount; ++i) {
+        const auto& entry = stats.priorities[static_cast<size_t>(i)];
+        priorities[Asr::requestPriorityName(static_cast<Asr::RequestPriority>(i))] = {
+            {"active", entry.active},
+            {"waiting", entry.waiting},
+            {"granted", entry.granted},
+            {"timeouts", entry.timeouts},
+            {"wait_ms_max", entry.waitMsMax},
+            {"wait_ms_avg", entry.granted > 0 ? entry.waitMsTotal / static_cast<double>(entry.granted) : 0.0},
+            {"audio_seconds", entry.audioSeconds}
+        };
+    }
+    return {
+        {"max_sessions", stats.limits.maxSessions},
+        {"session_limit", stats.sessionLimit},
+        {"connects_per_second", stats.connectsPerSecond},
+        {"audio_seconds_per_minute", stats.audioSecondsPerMinute},
+        {"audio_tokens", stats.audioTokens},
+        {"backoff_remaining_ms", stats.backoffRemainingMs},
+        {"rate_limited", stats.rateLimited},
+        {"quota_exceeded", stats.quotaExceeded},
+        {"server_busy", stats.serverBusy},
+        {"priorities", priorities}
+    };
+}
+
+json liveStatsToJson(const LiveStats& stats) {
+    json result = {
+        {"active", stats.active},
+        {"device", stats.deviceName},
+        {"captured_ms", stats.capturedMs},
+        {"sent_ms", stats.sentMs},
+        {"packets_sent", stats.packetsSent},
+        {"send_failures", stats.sendFailures},
+        {"reconnects", stats.reconnects},
+        {"xruns", stats.xruns},
+        {"vad_input_samples", stats.vad.inputSamples},
+        {"vad_output_samples", stats.vad.outputSamples},
+        {"vad_noise_floor_db", stats.vad.noiseFloorDb}
+    };
+    if (!stats.channels.empty()) {
+        result["packet_size"] = packetSizeToJson(stats.channels.front().packetSize);
+        result["memory"] = memoryStatsToJson(stats.channels.front().memory);
+    }
+    if (stats.channels.size() > 1) {
+        json channels = json::array();
+        for (const auto& channel : stats.channels) {
+            channels.push_back({
+                {"label", channel.label},
+                {"channels", channel.channels},
+                {"sent_ms", channel.sentMs},
+                {"packets_sent", channel.packetsSent},
+                {"send_failures", channel.sendFailures},
+                {"reconnects", channel.reconnects},
+                {"process_us", channel.processNs / 1000},
+                {"vad_output_samples", channel.vad.outputSamples},
+                {"packet_size", packetSizeToJson(channel.packetSize)},
+                {"memory", memoryStatsToJson(channel.memory)}
+            });
+        }
+        result["capture_channels"] = stats.captureChannels;
+        result["split_us"] = stats.splitNs / 1000;
+        result["channels"] = channels;
+    }
+    if (!stats.sources.empty()) {
+        json sources = json::array();
+        for (const auto& source : stats.sources) {
+            sources.push_back({
+                {"label", source.label},
+                {"device", source.device},
+                {"master", source.master},
+                {"rate_hz", source.rateHz},
+                {"drift_ppm", source.driftPpm},
+                {"ratio", source.ratio},
+                {"fill_ms", source.fillMs},
+                {"underruns", source.underruns},
+                {"overruns", source.overruns},
+                {"xruns", source.xruns}
+            });
+        }
+        result["sources"] = sources;
+    }
+    return result;
+}
+
+void writeLine(const std::string& line) {
+    std::lock_guard<std::mutex> lock(g_outMutex);
+    *g_out << line << std::endl;
+}
+
+/**
+ * @brief 解析 "--name value" 形式的参数
+ */
+bool takeValue(const std::vector<std::string>& args, size_t& i, std::string& value) {
+    if (i + 1 >= args.size()) {
+        std::cerr << "Missing value for " << args[i] << std::endl;
+        return false;
+    }
+    value = args[++i];
+    return true;
+}
+
+bool parseInt(const std::string& text, int& value) {
+    try {
+        size_t pos = 0;
+        value = std::stoi(text, &pos);
+        return pos == text.size();
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+bool parseDouble(const std::string& text, double& value) {
+    try {
+        size_t pos = 0;
+        value = std::stod(text, &pos);
+        return pos == text.size();
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+/**
+ * @brief 按 "[HOST:]PORT" 启动字幕广播服务器
+ */
+std::unique_ptr<CaptionServer> startCaptionServer(const std::string& spec) {
+    CaptionServerConfig config;
+    std::string port = spec;
+    const size_t colon = spec.rfind(':');
+    if (colon != std::string::npos) {
+        config.host = spec.substr(0, colon);
+        port = spec.substr(colon + 1);
+    }
+    if (!parseInt(port, config.port) || config.port <= 0 || config.port > 65535) {
+        std::cerr << "Invalid caption address: " << spec << std::endl;
+        return nullptr;
+    }
+
+    auto server = std::make_unique<CaptionServer>(config);
+    std::string error;
+    if (!server->start(error)) {
+        std::cerr << error << std::endl;
+        return nullptr;
+    }
+    return server;
+}
+
+/**
+ * @brief 解析 "LABEL=1,2" 形式的声道分组（命令行声道号从 1 开始）
+ */
+bool parseChannelGroup(const std::string& text, perfx::audio::ChannelGroup& group) {
+    const size_t equals = text.find('=');
+    if (equals == std::string::npos || equals == 0) {
+        std::cerr << "Invalid channel group (expected LABEL=CH,CH): " << text << std::endl;
+        return false;
+    }
+    group.label = text.substr(0, equals);
+    group.channels.clear();
+    std::istringstream list(text.substr(equals + 1));
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        int channel = 0;
+        if (!parseInt(item, channel) || channel <= 0) {
+            std::cerr << "Invalid channel in group " << group.label << ": " << item << std::endl;
+            return false;
+        }
+        group.channels.push_back(channel - 1);
+    }
+    if (group.channels.empty()) {
+        std::cerr << "Empty channel group: " << group.label << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 拆分 "[LABEL=]VALUE"：'=' 之前含 ',' 时视为虚拟设备描述串的一部分而不是标签
+ */
+void splitSourceLabel(const std::string& text, std::string& label, std::string& value) {
+    const size_t equals = text.find('=');
+    if (equals == std::string::npos || equals == 0 || text.find(',') < equals) {
+        label.clear();
+        value = text;
+        return;
+    }
+    label = text.substr(0, equals);
+    value = text.substr(equals + 1);
+}
+
+// ============================================================================
+// transcribe
+// ============================================================================
+
+int runTranscribe(const std::vector<std::string>& args) {
+    bool asJson = false;
+    int timeoutMs = 30000;
+    bool exportEnabled = false;
+    Asr::ExportFormat exportFormat = Asr::ExportFormat::Srt;
+    // 词级时间默认跟随文件识别客户端的请求配置（enableWordTimeOffset），--words 强制输出
+    Asr::ExportOptions exportOptions = Asr::exportOptionsFromConfig(Asr::AsrApiConfig());
+    std::string indexDir;
+    Asr::RequestPriority priority = Asr::RequestPriority::INTERACTIVE;
+    std::vector<std::string> files;
+
+    for (size_t i = 0; i < args.size(); ++i) {
+        std::string value;
+        if (args[i] == "--json") {
+            asJson = true;
+        } else if (args[i] == "--timeout") {
+            if (!takeValue(args, i, value) || !parseInt(value, timeoutMs)) return 2;
+        } else if (args[i] == "--priority") {
+            if (!takeValue(args, i, value)) return 2;
+            if (!Asr::parseRequestPriority(value, priority)) {
+                std::cerr << "Unknown priority: " << value << std::endl;
+                return 2;
+            }
+        } else if (args[i] == "--export") {
+            if (!takeValue(args, i, value)) return 2;
+            if (!Asr::exportFormatFromName(value, exportFormat)) {
+                std::cerr << "Unknown export format: " << value << std::endl;
+                return 2;
+            }
+            exportEnabled = true;
+        } else if (args[i] == "--words") {
+            exportOptions.wordTimestamps = true;
+        } else if (args[i] == "--index") {
+            if (!takeValue(args, i, indexDir)) return 2;
+        } else if (!args[i].empty() && args[i][0] == '-') {
+            std::cerr << "Unknown option: " << args[i] << std::endl;
+            return 2;
+        } else {
+            files.push_back(args[i]);
+        }
+    }
+    if (files.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    std::unique_ptr<TranscriptIndex> index;
+    if (!indexDir.empty()) {
+        TranscriptIndexConfig indexConfig;
+        indexConfig.directory = indexDir;
+        index = std::make_unique<TranscriptIndex>(indexConfig);
+        std::string error;
+        if (!index->open(error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+    }
+
+    TranscriptionEngine engine;
+    int failures = 0;
+    for (const auto& file : files) {
+        if (g_stopRequested) break;
+
+        std::vector<Asr::CachedUtterance> utterances;
+        const bool ok = engine.transcribeFile(file, utterances, timeoutMs, priority);
+        if (ok && index) {
+            // 每个文件完成后立即提交，中途退出时已完成的文件仍可查询
+            std::string error;
+            index->addRecording(std::filesystem::absolute(file).string(), utterances);
+            if (!index->commit(error)) {
+                ++failures;
+                std::cerr << file << ": " << error << std::endl;
+            }
+        }
+        if (!ok) {
+            ++failures;
+            std::cerr << file << ": " << engine.getLastError() << std::endl;
+        } else if (exportEnabled) {
+            std::filesystem::path exportPath(file);
+            exportPath.replace_extension(Asr::exportFormatExtension(exportFormat));
+            exportOptions.title = std::filesystem::path(file).stem().string();
+            std::string error;
+            if (!Asr::exportTranscript(utterances, exportFormat, exportPath.string(), exportOptions, error)) {
+                ++failures;
+                std::cerr << file << ": " << error << std::endl;
+            }
+        }
+
+        if (asJson) {
+            json result = {{"file", file}, {"ok", ok}, {"utterances", utterancesToJson(utterances)}};
+            if (!ok) result["error"] = engine.getLastError();
+            writeLine(result.dump());
+        } else if (ok) {
+            if (files.size() > 1) writeLine("== " + file);
+            for (const auto& utterance : utterances) {
+                writeLine("[" + formatTimestamp(utterance.startMs) + " --> " +
+                          formatTimestamp(utterance.endMs) + "] " + utterance.text);
+            }
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+// ============================================================================
+// search
+// ============================================================================
+
+int runSearch(const std::vector<std::string>& args) {
+    TranscriptIndexConfig config;
+    bool asJson = false;
+    int limit = 100;
+    std::string query;
+
+    for (size_t i = 0; i < args.size(); ++i) {
+        std::string value;
+        if (args[i] == "--index") {
+            if (!takeValue(args, i, config.directory)) return 2;
+        } else if (args[i] == "--json") {
+            asJson = true;
+        } else if (args[i] == "--limit") {
+            if (!takeValue(args, i, value) || !parseInt(value, limit) || limit < 0) return 2;
+        } else if (!args[i].empty() && args[i][0] == '-') {
+            std::cerr << "Unknown option: " << args[i] << std::endl;
+            return 2;
+        } else {
+            if (!query.empty()) query += " ";
+            query += args[i];
+        }
+    }
+    if (query.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    TranscriptIndex index(config);
+    std::string error;
+    if (!index.open(error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    const auto begin = std::chrono::steady_clock::now();
+    const auto hits = index.search(query, static_cast<size_t>(limit));
+    const double elapsedMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    if (asJson) {
+        json items = json::array();
+        for (const auto& hit : hits) {
+            items.push_back({{"recording", hit.recording}, {"start_ms", hit.startMs}, {"end_ms", hit.endMs}});
+        }
+        writeLine(json{{"query", query}, {"elapsed_ms", elapsedMs}, {"hits", items}}.dump());
+    } else {
+        for (const auto& hit : hits) {
+            writeLine(hit.recording + " [" + formatTimestamp(hit.startMs) + " --> " +
+                      formatTimestamp(hit.endMs) + "]");
+        }
+        std::cerr << hits.size() << " hits in " << elapsedMs << " ms" << std::endl;
+    }
+    return hits.empty() ? 1 : 0;
+}
+
+// ============================================================================
+// live
+// ============================================================================
+
+/**
+ * @brief 按描述串注册虚拟输入设备
+ */
+bool registerVirtualDevice(const std::string& spec, perfx::audio::DeviceInfo& device) {
+    perfx::audio::VirtualDeviceConfig config;
+    std::string error;
+    if (!perfx::audio::parseVirtualDeviceSpec(spec, config, error) ||
+        !perfx::audio::DeviceRegistry::getInstance().addVirtualDevice(config, device, error)) {
+        std::cerr << "Invalid virtual device '" << spec << "': " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int runLive(const std::vector<std::string>& args) {
+    LiveOptions options;
+    bool jsonLines = false;
+    bool partial = false;
+    int durationSec = 0;
+    std::string captionSpec;
+
+    for (size_t i = 0; i < args.size(); ++i) {
+        std::string value;
+        if (args[i] == "--device") {
+            if (!takeValue(args, i, value)) return 2;
+            if (!parseInt(value, options.deviceIndex)) {
+                options.deviceIndex = -1;
+                options.deviceName = value;
+            }
+        } else if (args[i] == "--virtual") {
+            if (!takeValue(args, i, value)) return 2;
+            perfx::audio::DeviceInfo device;
+            if (!registerVirtualDevice(value, device)) return 2;
+            options.deviceIndex = -1;
+            options.deviceName = device.name;
+        } else if (args[i] == "--jsonl") {
+            jsonLines = true;
+        } else if (args[i] == "--no-vad") {
+            options.enableVad = false;
+        } else if (args[i] == "--no-processing") {
+            options.enableProcessing = false;
+        } else if (args[i] == "--partial") {
+            partial = true;
+        } else if (args[i] == "--duration") {
+            if (!takeValue(args, i, value) || !parseInt(value, durationSec)) return 2;
+        } else if (args[i] == "--captions") {
+            if (!takeValue(args, i, captionSpec)) return 2;
+        } else if (args[i] == "--channels") {
+            if (!takeValue(args, i, value) || !parseInt(value, options.channels) || options.channels <= 0) return 2;
+        } else if (args[i] == "--group") {
+            perfx::audio::ChannelGroup group;
+            if (!takeValue(args, i, value) || !parseChannelGroup(value, group)) return 2;
+            options.channelGroups.push_back(std::move(group));
+        } else if (args[i] == "--source" || args[i] == "--virtual-source") {
+            const bool isVirtual = args[i] == "--virtual-source";
+            if (!takeValue(args, i, value)) return 2;
+            LiveSource source;
+            std::string target;
+            splitSourceLabel(value, source.label, target);
+            if (isVirtual) {
+                perfx::audio::DeviceInfo device;
+                if (!registerVirtualDevice(target, device)) return 2;
+                source.deviceName = device.name;
+            } else if (!parseInt(target, source.deviceIndex)) {
+                source.deviceIndex = -1;
+                source.deviceName = target;
+            }
+            options.extraSources.push_back(std::move(source));
+        } else if (args[i] == "--mix") {
+            options.mixSources = true;
+        } else if (args[i] == "--no-drift-correction") {
+            options.driftCorrection = false;
+        } else {
+            std::cerr << "Unknown option: " << args[i] << std::endl;
+            return 2;
+        }
+    }
+
+    std::unique_ptr<CaptionServer> captions;
+    if (!captionSpec.empty() && !(captions = startCaptionServer(captionSpec))) {
+        return 1;
+    }
+
+    TranscriptionEngine engine;
+
+    // 定稿分句只输出一次；--partial 时额外输出尚未定稿的最后一句。
+    // 多声道时各会话的结果按时间合并，新定稿的分句可能排在已输出的分句之前，因此按 说话人 + 起始时间 去重
+    std::mutex emitMutex;
+    std::set<std::pair<std::string, int64_t>> emitted;
+    std::string lastPartial;
+    engine.setUpdateCallback([&](const TranscriptUpdate& update) {
+        if (captions) {
+            captions->publish(update.utterances, update.final);
+        }
+        std::lock_guard<std::mutex> lock(emitMutex);
+        for (size_t i = 0; i < update.utterances.size(); ++i) {
+            const auto& utterance = update.utterances[i];
+            if (!utterance.definite && !update.final) {
+                if (partial && i + 1 == update.utterances.size() && utterance.text != lastPartial) {
+                    lastPartial = utterance.text;
+                    if (jsonLines) {
+                        json event = utteranceToJson(utterance);
+                        event["type"] = "partial";
+                        writeLine(event.dump());
+                    } else {
+                        std::cerr << "\r… " << utterance.text << std::flush;
+                    }
+                }
+                continue;
+            }
+            if (!emitted.insert({utterance.speaker, utterance.startMs}).second) {
+                continue;
+            }
+            if (jsonLines) {
+                json event = utteranceToJson(utterance);
+                event["type"] = "final";
+                writeLine(event.dump());
+            } else {
+                if (partial) std::cerr << "\r" << std::flush;
+                const std::string speaker = utterance.speaker.empty() ? std::string() : "[" + utterance.speaker + "] ";
+                writeLine("[" + formatTimestamp(utterance.startMs) + "] " + speaker + utterance.text);
+            }
+            lastPartial.clear();
+        }
+    });
+    engine.setErrorCallback([](const std::string& error) {
+        std::cerr << "error: " << error << std::endl;
+    });
+
+    if (!engine.startLive(options)) {
+        std::cerr << "Failed to start live capture: " << engine.getLastError() << std::endl;
+        return 1;
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    while (!g_stopRequested) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (durationSec > 0 &&
+            std::chrono::steady_clock::now() - started >= std::chrono::seconds(durationSec)) {
+            break;
+        }
+    }
+    engine.stopLive();
+
+    const LiveStats stats = engine.getLiveStats();
+    std::cerr << "Captured " << stats.capturedMs << " ms, sent " << stats.sentMs << " ms in "
+              << stats.packetsSent << " packets, reconnects " << stats.reconnects
+              << ", xruns " << stats.xruns << std::endl;
+    for (const auto& channel : stats.channels) {
+        const Asr::PacketSizeStats& sizing = channel.packetSize;
+        std::cerr << std::fixed << std::setprecision(1) << "  " << std::left << std::setw(10)
+                  << (channel.label.empty() ? "packets" : channel.label) << std::right << " "
+                  << (sizing.adaptive ? "adaptive " : "fixed ") << sizing.packetMs << " ms, srtt " << sizing.srttMs
+                  << " ms, result latency " << sizing.resultLatencyMs << " ms, " << sizing.changes << " changes, "
+                  << sizing.losses << " losses" << std::endl;
+        // 会话内存的分配次数只在会话开始时增长，之后保持不变
+        const Asr::SessionMemoryStats& memory = channel.memory;
+        std::cerr << "  " << std::setw(10) << "" << " memory " << memory.allocations() << " allocations for "
+                  << memory.framesEncoded << " frames / " << memory.responsesDecoded << " responses, "
+                  << memory.poolHits << " pool hits" << std::endl;
+    }
+    if (stats.channels.size() > 1 && stats.capturedMs > 0) {
+        // 每秒音频在消费者线程中的耗时：拆分为各组共享，其余按组统计
+        const double seconds = stats.capturedMs / 1000.0;
+        std::cerr << std::fixed << std::setprecision(1) << "  split " << stats.captureChannels << " channels: "
+                  << stats.splitNs / 1000.0 / seconds << " us/s" << std::endl;
+        for (const auto& channel : stats.channels) {
+            std::cerr << "  " << std::left << std::setw(10) << channel.label << std::right
+                      << " sent " << std::setw(7) << channel.sentMs << " ms in " << channel.packetsSent
+                      << " packets, " << channel.processNs / 1000.0 / seconds << " us/s" << std::endl;
+        }
+    }
+    for (const auto& source : stats.sources) {
+        std::cerr << std::fixed << std::setprecision(1) << "  " << std::left << std::setw(10) << source.label
+                  << std::right << (source.master ? " master  " : " ") << source.rateHz << " Hz";
+        if (!source.master) {
+            std::cerr << ", drift " << source.driftPpm << " ppm, ratio " << std::setprecision(6) << source.ratio
+                      << std::setprecision(1) << ", fill " << source.fillMs << " ms, underruns " << source.underruns
+                      << ", overruns " << source.overruns;
+        }
+        std::cerr << ", xruns " << source.xruns << std::endl;
+    }
+    if (captions) {
+        captions->stop();
+    }
+    return 0;
+}
+
+// ============================================================================
+// devices
+// ============================================================================
+
+int runDevices(const std::vector<std::string>& args) {
+    const bool asJson = !args.empty() && args[0] == "--json";
+    const auto devices = TranscriptionEngine::listInputDevices();
+
+    if (asJson) {
+        json array = json::array();
+        for (const auto& device : devices) {
+            array.push_back({
+                {"index", device.index},
+                {"name", device.name},
+                {"host_api", device.hostApi},
+                {"channels", device.maxInputChannels},
+                {"default_sample_rate", device.defaultSampleRate},
+                {"default", device.isDefaultInput}
+            });
+        }
+        writeLine(array.dump(2));
+        return 0;
+    }
+
+    for (const auto& device : devices) {
+        std::ostringstream line;
+        line << (device.isDefaultInput ? "* " : "  ") << std::setw(3) << device.index << "  "
+             << device.name << " (" << device.hostApi << ", " << device.maxInputChannels << " ch, "
+             << static_cast<int>(device.defaultSampleRate) << " Hz)";
+        writeLine(line.str());
+    }
+    return 0;
+}
+
+// ============================================================================
+// replay
+// ============================================================================
+
+/**
+ * @brief 回放时的识别回调：与实时识别一样经 TranscriptStitcher 维护分句
+ */
+class ReplayCallback : public Asr::AsrCallback {
+public:
+    void onOpen(Asr::AsrClient* client) override {
+        stitcher.beginSession(client, 0);
+    }
+    void onMessage(Asr::AsrClient* client, const std::string& message) override {
+        messages++;
+        if (stitcher.update(client, message)) {
+            updates++;
+        }
+    }
+    void onError(Asr::AsrClient*, const std::string& error) override {
+        errors.push_back(error);
+    }
+    void onClose(Asr::AsrClient* client) override {
+        stitcher.closeSession(client);
+    }
+
+    Asr::TranscriptStitcher stitcher;
+    uint64_t messages = 0;
+    uint64_t updates = 0;
+    std::vector<std::string> errors;
+};
+
+/**
+ * @brief 微秒样本的分位数摘要
+ */
+json latencySummary(std::vector<int64_t> values) {
+    if (values.empty()) {
+        return {{"count", 0}};
+    }
+    std::sort(values.begin(), values.end());
+    const auto at = [&values](double quantile) {
+        return values[std::min(values.size() - 1, static_cast<size_t>(quantile * values.size()))];
+    };
+    return {{"count", values.size()}, {"p50", at(0.50)}, {"p99", at(0.99)}, {"max", values.back()}};
+}
+
+json replayStatsToJson(const Asr::ReplayStats& stats) {
+    return {
+        {"server_frames", stats.serverFrames},
+        {"client_frames", stats.clientFrames},
+        {"bytes", stats.bytes},
+        {"capture_ms", stats.captureDurationUs / 1000.0},
+        {"elapsed_ms", stats.elapsedUs / 1000.0},
+        {"max_lag_us", stats.maxLagUs},
+        {"gate_timeouts", stats.gateTimeouts},
+        {"latency_us", latencySummary(stats.latencyUs)}
+    };
+}
+
+int runReplay(const std::vector<std::string>& args) {
+    std::string mode = "inject";
+    std::string url;
+    std::string path;
+    int port = 8766;
+    bool asJson = false;
+    Asr::ReplayOptions options;
+
+    for (size_t i = 0; i < args.size(); ++i) {
+        std::string value;
+        if (args[i] == "--json") {
+            asJson = true;
+        } else if (args[i] == "--mode") {
+            if (!takeValue(args, i, mode)) return 2;
+        } else if (args[i] == "--speed") {
+            if (!takeValue(args, i, value) || !parseDouble(value, options.speed) || options.speed <= 0.0) {
+                std::cerr << "Invalid speed" << std::endl;
+                return 2;
+            }
+        } else if (args[i] == "--fast") {
+            options.speed = 0.0;
+        } else if (args[i] == "--port") {
+            if (!takeValue(args, i, value) || !parseInt(value, port) || port <= 0 || port > 65535) return 2;
+        } else if (args[i] == "--url") {
+            if (!takeValue(args, i, url)) return 2;
+        } else if (!args[i].empty() && args[i][0] == '-') {
+            std::cerr << "Unknown option: " << args[i] << std::endl;
+            return 2;
+        } else {
+            path = args[i];
+        }
+    }
+    if (path.empty() || (mode != "inject" && mode != "server" && mode != "client")) {
+        printUsage();
+        return 2;
+    }
+
+    Asr::SessionCapture capture;
+    std::string error;
+    if (!capture.load(path, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    if (capture.isTruncated()) {
+        std::cerr << path << ": capture is truncated, replaying the complete frames" << std::endl;
+    }
+
+    json report = {
+        {"capture", path},
+        {"mode", mode},
+        {"speed", options.speed},
+        {"frames", capture.getFrames().size()},
+        {"truncated", capture.isTruncated()}
+    };
+
+    if (mode == "server") {
+        Asr::SessionMockServer server(capture, options);
+        if (!server.start("127.0.0.1", port, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        std::cerr << "Serving " << path << " on ws://127.0.0.1:" << port << " (Ctrl-C to stop)" << std::endl;
+        while (!g_stopRequested) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        server.stop();
+        report["sessions"] = server.getSessionsServed();
+        report["stats"] = replayStatsToJson(server.getStats());
+    } else if (mode == "client") {
+        // 未指定地址时回放到内置模拟服务端，测量本机协议往返时序
+        std::unique_ptr<Asr::SessionMockServer> server;
+        if (url.empty()) {
+            server = std::make_unique<Asr::SessionMockServer>(capture, options);
+            if (!server->start("127.0.0.1", port, error)) {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+            url = "ws://127.0.0.1:" + std::to_string(port);
+        }
+        Asr::ReplayStats stats;
+        const bool ok = Asr::replayClientSide(capture, url, options, stats, error, &g_stopRequested);
+        if (server) {
+            server->stop();
+        }
+        if (!ok) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        report["url"] = url;
+        report["stats"] = replayStatsToJson(stats);
+    } else {
+        ReplayCallback callback;
+        Asr::AsrClient client;
+        client.setCallback(&callback);
+        Asr::ReplayStats stats;
+        Asr::replayIntoClient(capture, client, options, stats, &g_stopRequested);
+        report["stats"] = replayStatsToJson(stats);
+        report["memory"] = memoryStatsToJson(client.getMemoryStats());
+        report["messages"] = callback.messages;
+        report["errors"] = callback.errors;
+
+        const auto utterances = callback.stitcher.merged();
+        if (asJson) {
+            report["utterances"] = utterancesToJson(utterances);
+        } else {
+            for (const auto& utterance : utterances) {
+                writeLine("[" + formatTimestamp(utterance.startMs) + " --> " +
+                          formatTimestamp(utterance.endMs) + "] " + utterance.text);
+            }
+        }
+    }
+
+    if (asJson) {
+        writeLine(report.dump(2));
+        return 0;
+    }
+    const json& stats = report["stats"];
+    const json& latency = stats["latency_us"];
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1)
+        << "Replay (" << mode << "): " << stats["server_frames"].get<uint64_t>() << " server / "
+        << stats["client_frames"].get<uint64_t>() << " client frames, "
+        << stats["capture_ms"].get<double>() << " ms captured in "
+        << stats["elapsed_ms"].get<double>() << " ms, max lag "
+        << stats["max_lag_us"].get<int64_t>() << " us";
+    if (latency["count"].get<size_t>() > 0) {
+        out << "\n  " << (mode == "inject" ? "dispatch" : "response")
+            << " p50 " << latency["p50"].get<int64_t>() << " us"
+            << "  p99 " << latency["p99"].get<int64_t>() << " us"
+            << "  max " << latency["max"].get<int64_t>() << " us";
+    }
+    writeLine(out.str());
+    return 0;
+}
+
+// ============================================================================
+// bench
+// ============================================================================
+
+/**
+ * @brief 合成测试信号：语音频段的调幅谐波 + 白噪声，交替出现“说话 / 停顿”
+ */
+std::vector<int16_t> synthesizeSpeechLike(int sampleRate, double seconds) {
+    const size_t total = static_cast<size_t>(sampleRate * seconds);
+    std::vector<int16_t> samples(total);
+    uint32_t noiseState = 0x12345678u;
+    const double kPi = 3.14159265358979323846;
+    for (size_t i = 0; i < total; ++i) {
+        const double t = static_cast<double>(i) / sampleRate;
+        noiseState = noiseState * 1664525u + 1013904223u;
+        const double noise = (static_cast<double>(noiseState >> 8) / (1u << 24) - 0.5) * 200.0;
+        const bool talking = std::fmod(t, 3.0) < 2.0;
+        double voice = 0.0;
+        if (talking) {
+            const double envelope = 0.5 + 0.5 * std::sin(2.0 * kPi * 4.0 * t);
+            voice = envelope * (3000.0 * std::sin(2.0 * kPi * 180.0 * t) +
+                                1500.0 * std::sin(2.0 * kPi * 360.0 * t) +
+                                800.0 * std::sin(2.0 * kPi * 1100.0 * t));
+        }
+        samples[i] = static_cast<int16_t>(std::max(-32768.0, std::min(32767.0, voice + noise)));
+    }
+    return samples;
+}
+
+/**
+ * @brief 合成中文转录：按 Zipf 分布从常用字组词、从词表组句，约每秒 4 个字
+ */
+class SyntheticTranscript {
+public:
+    SyntheticTranscript() : rng_(20240601u) {
+        std::vector<double> weights;
+        for (int k = 0; k < kChars; ++k) weights.push_back(1.0 / (k + 1));
+        std::discrete_distribution<int> charDist(weights.begin(), weights.end());
+        std::discrete_distribution<int> lengthDist({25, 55, 12, 8});
+        for (int w = 0; w < kWords; ++w) {
+            std::string word;
+            const int length = lengthDist(rng_) + 1;
+            for (int c = 0; c < length; ++c) {
+                appendCodePoint(word, 0x4E00 + static_cast<uint32_t>(charDist(rng_)) * 5 % 20902);
+            }
+            words_.push_back(std::move(word));
+        }
+        weights.clear();
+        for (int k = 0; k < kWords; ++k) weights.push_back(1.0 / (k + 1));
+        wordDist_ = std::discrete_distribution<int>(weights.begin(), weights.end());
+    }
+
+    /**
+     * @brief 一段录音的分句（时长约 durationMs）
+     */
+    std::vector<Asr::CachedUtterance> recording(int64_t durationMs) {
+        static const char* const kLatin[] = {"API", "OK", "Python", "GPU", "model", "demo"};
+        std::vector<Asr::CachedUtterance> utterances;
+        std::uniform_int_distribution<int> utteranceMs(2000, 8000);
+        std::uniform_int_distribution<int> percent(0, 99);
+        int64_t time = 0;
+        while (time < durationMs) {
+            Asr::CachedUtterance utterance;
+            utterance.startMs = time;
+            utterance.endMs = time + utteranceMs(rng_);
+            utterance.definite = true;
+            const int64_t chars = (utterance.endMs - utterance.startMs) * 4 / 1000;
+            int64_t written = 0;
+            while (written < chars) {
+                const int roll = percent(rng_);
+                if (roll < 3) {
+                    utterance.text += std::string(" ") + kLatin[roll * 2 + percent(rng_) % 2] + " ";
+                    written += 2;
+                    continue;
+                }
+                const std::string& word = words_[wordDist_(rng_)];
+                utterance.text += word;
+                written += static_cast<int64_t>(word.size() / 3);
+                if (roll > 90) utterance.text += "，";
+            }
+            utterance.text += "。";
+            time = utterance.endMs + 300;
+            utterances.push_back(std::move(utterance));
+        }
+        return utterances;
+    }
+
+    std::mt19937& rng() { return rng_; }
+
+    static void appendCodePoint(std::string& out, uint32_t cp) {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+
+private:
+    static constexpr int kChars = 3500;
+    static constexpr int kWords = 8000;
+    std::mt19937 rng_;
+    std::vector<std::string> words_;
+    std::discrete_distribution<int> wordDist_;
+};
+
+/**
+ * @brief 全文索引基准：每小时一段录音逐个提交（模拟会话结束时增量更新），再测各类查询延迟
+ */
+json benchTranscriptIndex(int hours) {
+    namespace fs = std::filesystem;
+    const fs::path directory = fs::temp_directory_path() / ("perfx-index-bench-" + std::to_string(
+        std::chrono::steady_clock::now().time_since_epoch().count()));
+    perfx::logic::TranscriptIndexConfig config;
+    config.directory = directory.string();
+    perfx::logic::TranscriptIndex index(config);
+    std::string error;
+    if (!index.open(error)) {
+        return {{"error", error}};
+    }
+
+    SyntheticTranscript synthetic;
+    std::vector<std::string> samples;   // 查询样本来源：每段录音取若干分句
+    uint64_t textBytes = 0;
+    uint64_t utteranceCount = 0;
+    const auto buildBegin = std::chrono::steady_clock::now();
+    for (int h = 0; h < hours; ++h) {
+        const auto utterances = synthetic.recording(3600 * 1000);
+        for (size_t i = 0; i < utterances.size(); ++i) {
+            textBytes += utterances[i].text.size();
+            if (i % 97 == 0) samples.push_back(utterances[i].text);
+        }
+        utteranceCount += utterances.size();
+        index.addRecording("synthetic-" + std::to_string(h) + ".wav", utterances);
+        if (!index.commit(error)) {
+            fs::remove_all(directory);
+            return {{"error", error}};
+        }
+    }
+    const double buildMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildBegin).count();
+    const auto stats = index.getStats();
+
+    // 查询：从样本分句截取 N 个字（CJK 字 3 字节），另加随机 4 字串（大多不命中）
+    struct QueryClass {
+        const char* name;
+        int chars;
+    };
+    const QueryClass classes[] = {{"1 char", 1}, {"2 chars", 2}, {"4 chars", 4}, {"8 chars", 8}, {"random 4 chars", -4}};
+    json queries = json::array();
+    for (const auto& queryClass : classes) {
+        std::vector<double> latencies;
+        uint64_t totalHits = 0;
+        for (int q = 0; q < 200 && !samples.empty(); ++q) {
+            std::string query;
+            if (queryClass.chars > 0) {
+                const std::string& text = samples[synthetic.rng()() % samples.size()];
+                std::vector<size_t> starts;
+                for (size_t pos = 0; pos + 3 <= text.size(); ++pos) {
+                    if (static_cast<unsigned char>(text[pos]) >= 0xE4 && static_cast<unsigned char>(text[pos]) <= 0xE9) {
+                        starts.push_back(pos);
+                    }
+                }
+                if (starts.size() < static_cast<size_t>(queryClass.chars)) continue;
+                const size_t first = synthetic.rng()() % (starts.size() - queryClass.chars + 1);
+                for (int c = 0; c < queryClass.chars; ++c) query.append(text, starts[first + c], 3);
+            } else {
+                for (int c = 0; c < -queryClass.chars; ++c) {
+                    SyntheticTranscript::appendCodePoint(query, 0x4E00 + synthetic.rng()() % 20902);
+                }
+            }
+            const auto begin = std::chrono::steady_clock::now();
+            const auto hits = index.search(query, 100);
+            latencies.push_back(
+                std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count());
+            totalHits += hits.size();
+        }
+        if (latencies.empty()) continue;
+        std::sort(latencies.begin(), latencies.end());
+        queries.push_back({
+            {"class", queryClass.name},
+            {"queries", latencies.size()},
+            {"p50_us", latencies[latencies.size() / 2]},
+            {"p99_us", latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)]},
+            {"avg_hits", static_cast<double>(totalHits) / latencies.size()}
+        });
+    }
+
+    fs::remove_all(directory);
+    return {
+        {"hours", hours},
+        {"utterances", utteranceCount},
+        {"text_bytes", textBytes},
+        {"build_ms", buildMs},
+        {"segments", stats.segments},
+        {"terms", stats.terms},
+        {"postings_bytes", stats.postingsBytes},
+        {"disk_bytes", stats.diskBytes},
+        {"bytes_per_hour", hours > 0 ? stats.diskBytes / hours : 0},
+        {"queries", queries}
+    };
+}
+
+/**
+ * @brief 采集链路基准：虚拟设备 → AudioThread 环形缓冲 → 处理链 → VAD，与 live 的采集路径一致
+ * @param seconds 采集的音频时长（虚拟设备时钟下）
+ */
+json benchCapture(const std::string& spec, int seconds) {
+    namespace audio = perfx::audio;
+    audio::DeviceInfo device;
+    if (!registerVirtualDevice(spec, device)) {
+        return {{"spec", spec}, {"error", "invalid virtual device"}};
+    }
+
+    audio::AudioConfig config;
+    config.sampleRate = audio::SampleRate::RATE_16000;
+    config.format = audio::SampleFormat::INT16;
+    config.channels = audio::ChannelCount::MONO;
+    config.framesPerBuffer = 256;
+    config.enableHighPass = true;
+    config.enableNoiseSuppression = true;
+    config.enableAGC = true;
+    config.inputDevice = device;
+
+    audio::VadConfig vadConfig;
+    audio::VoiceActivityDetector vad(vadConfig);
+    std::vector<int16_t> vadOutput;
+    std::atomic<uint64_t> consumedFrames{0};
+
+    auto processor = std::make_shared<audio::AudioProcessor>();
+    audio::AudioThread thread;
+    audio::AudioDevice capture;
+    if (!processor->initialize(config)) {
+        return {{"spec", spec}, {"error", "failed to initialize audio processor"}};
+    }
+    thread.initialize(processor.get());
+    if (processor->hasProcessingChain()) {
+        thread.addProcessor(processor);
+    }
+    thread.setInputCallback([&](const void* input, void*, unsigned long frameCount) {
+        vad.process(static_cast<const int16_t*>(input), frameCount, vadOutput);
+        vadOutput.clear();
+        consumedFrames += frameCount;
+    });
+    capture.setCallback([&thread](const void* input, void*, size_t frameCount) {
+        thread.submit(input, static_cast<unsigned long>(frameCount));
+    });
+    if (!capture.openInputDevice(device, config)) {
+        return {{"spec", spec}, {"error", capture.getLastError()}};
+    }
+
+    audio::MetricsRegistry::instance().reset();
+    const uint64_t targetFrames = static_cast<uint64_t>(seconds) * 16000;
+    thread.startRecording();
+    const auto begin = std::chrono::steady_clock::now();
+    capture.startStream();
+    // 不循环的文件播完、或已采集到目标时长即结束
+    while (!g_stopRequested && consumedFrames < targetFrames && capture.isStreamActive()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    capture.stopStream();
+    thread.stop();
+    const double elapsedMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    capture.closeDevice();
+    perfx::audio::DeviceRegistry::getInstance().removeVirtualDevice(device.name);
+
+    const audio::PipelineStats pipeline = thread.getPipelineStats();
+    const int64_t audioMs = static_cast<int64_t>(pipeline.frames * 1000 / 16000);
+    json report = {
+        {"spec", spec},
+        {"device", device.name},
+        {"frames_per_buffer", config.framesPerBuffer},
+        {"audio_ms", audioMs},
+        {"elapsed_ms", elapsedMs},
+        {"realtime_factor", audioMs > 0 ? elapsedMs / audioMs : 0.0},
+        {"xruns", capture.getXrunCount()},
+        {"ring_dropped_chunks", pipeline.droppedChunks},
+        {"ring_dropped_frames", pipeline.droppedFrames},
+        {"ring_high_watermark", pipeline.ringHighWatermark},
+        {"ring_capacity", pipeline.ringCapacity},
+        {"vad_sent_ratio", vad.getStats().inputSamples
+                               ? static_cast<double>(vad.getStats().outputSamples) / vad.getStats().inputSamples
+                               : 0.0}
+    };
+    json stages = json::array();
+    for (const auto& stage : pipeline.stages) {
+        stages.push_back({{"name", stage.name}, {"calls", stage.calls}, {"avg_us", stage.avgUs}, {"max_us", stage.maxUs}});
+    }
+    report["stages"] = stages;
+    json latency = json::object();
+    for (const auto& histogram : audio::MetricsRegistry::instance().snapshot().histograms) {
+        if (histogram.count == 0) continue;
+        latency[histogram.name] = {{"count", histogram.count}, {"p50", histogram.p50},
+                                   {"p99", histogram.p99}, {"max", histogram.max}};
+    }
+    report["latency_us"] = latency;
+    return report;
+}
+
+/**
+ * @brief 多声道拆分基准：N 个麦克风轮流发言（每人 4 s），其余声道只有底噪，
+ *        走 live 的 ChannelSplitter → 每声道 VAD 路径，统计拆分与各声道的耗时和发送比例
+ */
+json benchChannels(int channels, int seconds) {
+    namespace audio = perfx::audio;
+    constexpr int kRate = 16000;
+    constexpr size_t kChunk = 256;  // 与采集回调的 framesPerBuffer 一致
+    const std::vector<int16_t> voice = synthesizeSpeechLike(kRate, seconds);
+    const size_t frames = voice.size();
+    const size_t turnFrames = static_cast<size_t>(kRate) * 4;
+
+    std::vector<int16_t> interleaved(frames * static_cast<size_t>(channels));
+    uint32_t noiseState = 0x9E3779B9u;
+    for (size_t i = 0; i < frames; ++i) {
+        const int speaker = static_cast<int>((i / turnFrames) % static_cast<size_t>(channels));
+        for (int ch = 0; ch < channels; ++ch) {
+            noiseState = noiseState * 1664525u + 1013904223u;
+            const int16_t noise = static_cast<int16_t>(static_cast<int32_t>(noiseState >> 24) - 128);
+            interleaved[i * channels + ch] = ch == speaker ? voice[i] : noise;
+        }
+    }
+
+    audio::ChannelSplitter splitter;
+    splitter.configure(audio::SampleConverter::create(audio::SampleFormat::INT16, channels),
+                       audio::ChannelSplitter::perChannelGroups(channels));
+
+    // 拆分：当前 SIMD 实现与标量实现各跑一遍
+    const auto timeSplit = [&]() {
+        const auto begin = std::chrono::steady_clock::now();
+        for (size_t offset = 0; offset < frames; offset += kChunk) {
+            splitter.split(interleaved.data() + offset * channels, std::min(kChunk, frames - offset));
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / frames;
+    };
+    const audio::dsp::DspBackend backend = audio::dsp::getActiveBackend();
+    const double splitNs = timeSplit();
+    audio::dsp::setBackend(audio::dsp::DspBackend::SCALAR);
+    const double splitScalarNs = timeSplit();
+    audio::dsp::setBackend(backend);
+
+    // 每声道 VAD：拆分一次，各声道依次处理（与 TranscriptionEngine 的消费者线程一致）
+    std::vector<std::unique_ptr<audio::VoiceActivityDetector>> vads;
+    for (int ch = 0; ch < channels; ++ch) {
+        vads.push_back(std::make_unique<audio::VoiceActivityDetector>(audio::VadConfig()));
+    }
+    std::vector<double> vadNs(static_cast<size_t>(channels), 0.0);
+    std::vector<int16_t> vadOutput;
+    for (size_t offset = 0; offset < frames; offset += kChunk) {
+        const size_t count = std::min(kChunk, frames - offset);
+        splitter.split(interleaved.data() + offset * channels, count);
+        for (int ch = 0; ch < channels; ++ch) {
+            const auto begin = std::chrono::steady_clock::now();
+            vadOutput.clear();
+            vads[ch]->process(splitter.output(static_cast<size_t>(ch)), count, vadOutput);
+            vadNs[ch] += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+        }
+    }
+
+    json perChannel = json::array();
+    for (int ch = 0; ch < channels; ++ch) {
+        const auto stats = vads[ch]->getStats();
+        perChannel.push_back({
+            {"label", splitter.group(static_cast<size_t>(ch)).label},
+            {"vad_us_per_s", vadNs[ch] / 1000.0 / seconds},
+            {"sent_ratio", stats.inputSamples ? static_cast<double>(stats.outputSamples) / stats.inputSamples : 0.0}
+        });
+    }
+    return {
+        {"channels", channels},
+        {"audio_ms", seconds * 1000},
+        {"backend", audio::dsp::getBackendName(backend)},
+        {"split_ns_per_frame", splitNs},
+        {"split_scalar_ns_per_frame", splitScalarNs},
+        {"per_channel", perChannel}
+    };
+}
+
+/**
+ * @brief 多源漂移基准：两个实时时钟的虚拟设备，次要源的时钟快 ppm，
+ *        分别在开启 / 关闭漂移补偿时采集 seconds 秒，统计漂移估计与 FIFO 水位（即两轨的相对延迟）
+ */
+json benchDrift(double ppm, int seconds) {
+    namespace audio = perfx::audio;
+    json runs = json::array();
+    for (const bool correction : {true, false}) {
+        audio::DeviceInfo master;
+        audio::DeviceInfo secondary;
+        std::ostringstream secondarySpec;
+        secondarySpec << std::setprecision(12) << "speech,name=drift-sys,channels=2,speed=" << 1.0 + ppm / 1e6;
+        if (!registerVirtualDevice("speech,name=drift-mic", master) ||
+            !registerVirtualDevice(secondarySpec.str(), secondary)) {
+            return {{"ppm", ppm}, {"error", "invalid virtual device"}};
+        }
+
+        audio::CaptureGraphConfig config;
+        config.driftCorrection = correction;
+        audio::CaptureGraph graph;
+        std::atomic<uint64_t> outputFrames{0};
+        graph.setCallback([&outputFrames](const void*, void*, size_t frameCount) { outputFrames += frameCount; });
+        json run = {{"drift_correction", correction}};
+        if (!graph.open({{master, "mic"}, {secondary, "sys"}}, config) || !graph.start()) {
+            run["error"] = graph.getLastError();
+        } else {
+            // 启动阶段先积累到目标水位，之后按 100 ms 采样水位
+            double fillMin = 0.0;
+            double fillMax = 0.0;
+            bool sampled = false;
+            const auto begin = std::chrono::steady_clock::now();
+            while (!g_stopRequested && std::chrono::steady_clock::now() - begin < std::chrono::seconds(seconds)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                const double fill = graph.getStats()[1].fillMs;
+                if (std::chrono::steady_clock::now() - begin < std::chrono::seconds(1)) {
+                    continue;
+                }
+                fillMin = sampled ? std::min(fillMin, fill) : fill;
+                fillMax = sampled ? std::max(fillMax, fill) : fill;
+                sampled = true;
+            }
+            const audio::CaptureSourceStats stats = graph.getStats()[1];
+            graph.stop();
+            run["estimated_ppm"] = stats.driftPpm;
+            run["ratio"] = stats.ratio;
+            run["fill_target_ms"] = config.targetLatencyMs;
+            run["fill_end_ms"] = stats.fillMs;
+            run["fill_min_ms"] = fillMin;
+            run["fill_max_ms"] = fillMax;
+            run["underruns"] = stats.underruns;
+            run["overruns"] = stats.overruns;
+            run["output_ms"] = outputFrames * 1000 / static_cast<uint64_t>(config.sampleRate);
+        }
+        graph.close();
+        audio::DeviceRegistry::getInstance().removeVirtualDevice(master.name);
+        audio::DeviceRegistry::getInstance().removeVirtualDevice(secondary.name);
+        runs.push_back(run);
+    }
+    return {{"ppm", ppm}, {"seconds", seconds}, {"runs", runs}};
+}
+
+/**
+ * @brief 模拟链路参数
+ */
+struct LinkProfile {
+    const char* name;
+    double rttMs;
+    double jitterMs;
+    double loss;                    ///< 每包丢失（TCP 重传）概率
+    double kbps;                    ///< 上行带宽
+};
+
+constexpr LinkProfile kLinkProfiles[] = {
+    {"lan", 15.0, 3.0, 0.0, 2000.0},
+    {"wifi", 40.0, 15.0, 0.005, 1000.0},
+    {"cellular", 150.0, 60.0, 0.02, 600.0},
+    {"satellite", 600.0, 50.0, 0.01, 1000.0},
+};
+
+/**
+ * @brief 分包时长的离散事件仿真：固定包时长 fixedMs（0 表示使用自适应控制器）下
+ *        实时发送 audioSec 秒音频，统计结果延迟（音频中点 → 收到覆盖它的响应）
+ *
+ * 链路模型：每包 80 B 协议开销 + 32 B/ms 音频，上行串行发送；丢包按 TCP 重传处理，
+ * 等待 RTO（max(200ms, 3·RTT)）且阻塞其后的包（按序到达）；服务端逐包处理 8ms + 音频时长的 5%
+ */
+json simulatePacketSizing(const LinkProfile& link, int fixedMs, int audioSec) {
+    constexpr double kOverheadBytes = 80.0;
+    constexpr double kAudioBytesPerMs = 32.0;   // 16kHz INT16 单声道
+    constexpr double kServerFixedMs = 8.0;
+    constexpr double kServerPerAudioMs = 0.05;
+
+    struct Response {
+        double atMs;
+        double sentMs;
+        double audioMidMs;
+    };
+
+    Asr::PacketSizeConfig config;
+    config.adaptive = fixedMs == 0;
+    config.initialMs = fixedMs == 0 ? 100 : fixedMs;
+    config.minMs = std::min(config.minMs, config.initialMs);
+    config.recordMetrics = false;
+    Asr::PacketSizeController controller(config);
+
+    std::mt19937 rng(42);
+    std::normal_distribution<double> jitter(0.0, link.jitterMs);
+    std::bernoulli_distribution lost(link.loss);
+    const double rtoMs = std::max(200.0, 3.0 * link.rttMs);
+    auto oneWay = [&]() { return link.rttMs / 2.0 + std::fabs(jitter(rng)); };
+    auto toNs = [](double ms) { return static_cast<int64_t>(ms * 1e6); };
+
+    std::deque<Response> inFlight;
+    std::vector<double> latencies;
+    double audioMs = 0.0;
+    double uplinkFreeMs = 0.0, lastArrivalMs = 0.0, serverFreeMs = 0.0, lastResponseMs = 0.0;
+    double totalBytes = 0.0;
+    uint64_t packets = 0;
+    auto deliver = [&](double untilMs) {
+        while (!inFlight.empty() && inFlight.front().atMs <= untilMs) {
+            const Response response = inFlight.front();
+            inFlight.pop_front();
+            controller.onRtt(toNs(response.atMs - response.sentMs), toNs(response.atMs));
+            controller.onResultLatency(toNs(response.atMs - response.sentMs));
+            latencies.push_back(response.atMs - response.audioMidMs);
+        }
+    };
+
+    while (audioMs < audioSec * 1000.0) {
+        const int packetMs = controller.packetMs();
+        const double sendMs = audioMs + packetMs;
+        deliver(sendMs);
+
+        const double bytes = kOverheadBytes + kAudioBytesPerMs * packetMs;
+        uplinkFreeMs = std::max(sendMs, uplinkFreeMs) + bytes * 8.0 / link.kbps;
+        double arrivalMs = uplinkFreeMs + oneWay() + (lost(rng) ? rtoMs : 0.0);
+        arrivalMs = lastArrivalMs = std::max(arrivalMs, lastArrivalMs);
+        serverFreeMs = std::max(arrivalMs, serverFreeMs) + kServerFixedMs + kServerPerAudioMs * packetMs;
+        const double responseMs = lastResponseMs = std::max(serverFreeMs + oneWay(), lastResponseMs);
+
+        inFlight.push_back({responseMs, sendMs, audioMs + packetMs / 2.0});
+        controller.onPacketSent(packetMs);
+        totalBytes += bytes;
+        ++packets;
+        audioMs = sendMs;
+    }
+    deliver(std::numeric_limits<double>::max());
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        return latencies.empty() ? 0.0 : latencies[static_cast<size_t>(p * (latencies.size() - 1))];
+    };
+    const Asr::PacketSizeStats stats = controller.stats();
+    json run = {
+        {"packet_ms", fixedMs == 0 ? json("adaptive") : json(fixedMs)},
+        {"latency_p50_ms", percentile(0.50)},
+        {"latency_p95_ms", percentile(0.95)},
+        {"packets_per_s", packets / static_cast<double>(audioSec)},
+        {"overhead_pct", totalBytes > 0 ? 100.0 * kOverheadBytes * packets / totalBytes : 0.0}
+    };
+    if (fixedMs == 0) {
+        run["final_packet_ms"] = stats.packetMs;
+        run["changes"] = stats.changes;
+        run["srtt_ms"] = stats.srttMs;
+        run["stall_rate"] = stats.stallRate;
+        run["stall_ms"] = stats.stallMs;
+    }
+    return run;
+}
+
+/**
+ * @brief 分包基准：各链路上固定 50 / 100 / 200ms 与自适应包时长的对比
+ */
+json benchPacketSizing(const std::string& linkName) {
+    constexpr int kAudioSec = 600;
+    json links = json::array();
+    for (const auto& link : kLinkProfiles) {
+        if (linkName != "all" && linkName != link.name) {
+            continue;
+        }
+        json runs = json::array();
+        for (const int fixedMs : {50, 100, 200, 0}) {
+            runs.push_back(simulatePacketSizing(link, fixedMs, kAudioSec));
+        }
+        links.push_back({
+            {"link", link.name},
+            {"rtt_ms", link.rttMs},
+            {"jitter_ms", link.jitterMs},
+            {"loss", link.loss},
+            {"kbps", link.kbps},
+            {"runs", runs}
+        });
+    }
+    return {{"audio_s", kAudioSec}, {"links", links}};
+}
+
+int runBench(const std::vector<std::string>& args) {
+    int seconds = 10;
+    int indexHours = 0;
+    int channels = 0;
+    double driftPpm = 0.0;
+    std::string linkName;
+    bool asJson = false;
+    std::string file;
+    std::string captureSpec;
+
+    for (size_t i = 0; i < args.size(); ++i) {
+        std::string value;
+        if (args[i] == "--seconds") {
+            if (!takeValue(args, i, value) || !parseInt(value, seconds) || seconds <= 0) return 2;
+        } else if (args[i] == "--file") {
+            if (!takeValue(args, i, file)) return 2;
+        } else if (args[i] == "--capture") {
+            if (!takeValue(args, i, captureSpec)) return 2;
+        } else if (args[i] == "--index-hours") {
+            if (!takeValue(args, i, value) || !parseInt(value, indexHours) || indexHours <= 0) return 2;
+        } else if (args[i] == "--channels") {
+            if (!takeValue(args, i, value) || !parseInt(value, channels) || channels <= 0 || channels > 64) return 2;
+        } else if (args[i] == "--drift") {
+            if (!takeValue(args, i, value) || !parseDouble(value, driftPpm) || driftPpm == 0.0 ||
+                std::fabs(driftPpm) > 10000.0) return 2;
+        } else if (args[i] == "--link") {
+            if (!takeValue(args, i, linkName)) return 2;
+            const bool known = linkName == "all" ||
+                std::any_of(std::begin(kLinkProfiles), std::end(kLinkProfiles),
+                            [&linkName](const LinkProfile& link) { return linkName == link.name; });
+            if (!known) {
+                std::cerr << "Unknown link profile: " << linkName << std::endl;
+                return 2;
+            }
+        } else if (args[i] == "--json") {
+            asJson = true;
+        } else {
+            std::cerr << "Unknown option: " << args[i] << std::endl;
+            return 2;
+        }
+    }
+
+    json report;
+
+    // 1. 处理链：各阶段每块耗时
+    perfx::audio::ProcessingChainConfig chainConfig;
+    const auto stages = perfx::audio::AudioProcessingChain::benchmark(chainConfig, seconds);
+    json stagesJson = json::array();
+    for (const auto& stage : stages) {
+        stagesJson.push_back({
+            {"name", stage.name},
+            {"blocks", stage.blocks},
+            {"avg_us_per_block", stage.avgUsPerBlock},
+            {"max_us_per_block", stage.maxUsPerBlock}
+        });
+    }
+    report["processing_chain"] = {{"block_ms", chainConfig.blockMs}, {"stages", stagesJson}};
+
+    // 2. VAD：合成音频上的吞吐与压缩比
+    {
+        perfx::audio::VadConfig vadConfig;
+        perfx::audio::VoiceActivityDetector vad(vadConfig);
+        const auto input = synthesizeSpeechLike(vadConfig.sampleRate, seconds);
+        std::vector<int16_t> output;
+        output.reserve(input.size());
+
+        const size_t chunk = 256;  // 与采集回调的 framesPerBuffer 一致
+        const auto begin = std::chrono::steady_clock::now();
+        for (size_t offset = 0; offset < input.size(); offset += chunk) {
+            vad.process(input.data() + offset, std::min(chunk, input.size() - offset), output);
+        }
+        const double elapsedMs =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        const auto stats = vad.getStats();
+        report["vad"] = {
+            {"audio_ms", seconds * 1000},
+            {"elapsed_ms", elapsedMs},
+            {"realtime_factor", elapsedMs / (seconds * 1000.0)},
+            {"sent_ratio", stats.inputSamples ? static_cast<double>(stats.outputSamples) / stats.inputSamples : 0.0}
+        };
+    }
+
+    // 3. 采集链路：虚拟设备按实时 / 加速 / 自由运行时钟驱动
+    if (!captureSpec.empty()) {
+        report["capture"] = benchCapture(captureSpec, seconds);
+    }
+
+    // 4. 多声道：拆分与每声道 VAD
+    if (channels > 0) {
+        report["channels"] = benchChannels(channels, seconds);
+    }
+
+    // 4b. 多源采集：时钟漂移估计与补偿
+    if (driftPpm != 0.0) {
+        report["drift"] = benchDrift(driftPpm, seconds);
+    }
+
+    // 4c. ASR 分包：模拟链路上固定与自适应包时长的结果延迟
+    if (!linkName.empty()) {
+        report["packet_sizing"] = benchPacketSizing(linkName);
+    }
+
+    // 5. 文件识别：端到端耗时（禁用结果缓存，避免命中缓存）
+    if (!file.empty()) {
+        Asr::AsrConfig asrConfig = TranscriptionEngine::defaultAsrConfig();
+        asrConfig.enableResultCache = false;
+        TranscriptionEngine engine(asrConfig);
+
+        std::vector<Asr::CachedUtterance> utterances;
+        const auto begin = std::chrono::steady_clock::now();
+        const bool ok = engine.transcribeFile(file, utterances);
+        const double elapsedMs =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        const int64_t spanMs = utterances.empty() ? 0 : utterances.back().endMs;
+        report["file_asr"] = {
+            {"file", file},
+            {"ok", ok},
+            {"elapsed_ms", elapsedMs},
+            {"transcript_span_ms", spanMs},
+            {"realtime_factor", spanMs > 0 ? elapsedMs / spanMs : 0.0},
+            {"utterances", utterances.size()}
+        };
+        if (!ok) report["file_asr"]["error"] = engine.getLastError();
+    }
+
+    // 6. 全文索引：合成转录上的索引大小与查询延迟
+    if (indexHours > 0) {
+        report["transcript_index"] = benchTranscriptIndex(indexHours);
+    }
+
+    if (asJson) {
+        writeLine(report.dump(2));
+        return 0;
+    }
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    out << "Processing chain (" << chainConfig.blockMs << " ms blocks, " << seconds << " s):\n";
+    for (const auto& stage : stages) {
+        out << "  " << std::left << std::setw(20) << stage.name << std::right
+            << " avg " << std::setw(8) << stage.avgUsPerBlock << " us"
+            << "  max " << std::setw(8) << stage.maxUsPerBlock << " us\n";
+    }
+    const auto& vadReport = report["vad"];
+    out << "VAD: " << vadReport["elapsed_ms"].get<double>() << " ms for " << seconds << " s of audio"
+        << " (RTF " << std::setprecision(5) << vadReport["realtime_factor"].get<double>() << std::setprecision(2)
+        << "), sent ratio " << vadReport["sent_ratio"].get<double>() << "\n";
+    if (report.contains("capture")) {
+        const auto& captureReport = report["capture"];
+        if (captureReport.contains("error")) {
+            out << "Capture: " << captureReport["error"].get<std::string>() << "\n";
+        } else {
+            out << "Capture (" << captureReport["device"].get<std::string>() << "): "
+                << captureReport["audio_ms"].get<int64_t>() << " ms of audio in "
+                << captureReport["elapsed_ms"].get<double>() << " ms (RTF "
+                << captureReport["realtime_factor"].get<double>() << "), xruns "
+                << captureReport["xruns"].get<uint64_t>() << ", ring drops "
+                << captureReport["ring_dropped_chunks"].get<uint64_t>() << ", ring peak "
+                << captureReport["ring_high_watermark"].get<size_t>() << "/"
+                << captureReport["ring_capacity"].get<size_t>() << "\n";
+            for (const auto& item : captureReport["latency_us"].items()) {
+                out << "  " << std::left << std::setw(30) << item.key() << std::right
+                    << " p50 " << std::setw(8) << item.value()["p50"].get<uint64_t>() << " us"
+                    << "  p99 " << std::setw(8) << item.value()["p99"].get<uint64_t>() << " us\n";
+            }
+        }
+    }
+    if (report.contains("channels")) {
+        const auto& channelReport = report["channels"];
+        out << "Channels: " << channelReport["channels"].get<int>() << " x " << seconds << " s, split "
+            << channelReport["split_ns_per_frame"].get<double>() << " ns/frame ("
+            << channelReport["backend"].get<std::string>() << "), scalar "
+            << channelReport["split_scalar_ns_per_frame"].get<double>() << " ns/frame\n";
+        for (const auto& channel : channelReport["per_channel"]) {
+            out << "  " << std::left << std::setw(8) << channel["label"].get<std::string>() << std::right
+                << " VAD " << std::setw(8) << channel["vad_us_per_s"].get<double>() << " us/s"
+                << "  sent ratio " << channel["sent_ratio"].get<double>() << "\n";
+        }
+    }
+    if (report.contains("drift")) {
+        const auto& driftReport = report["drift"];
+        out << "Drift (" << driftReport["ppm"].get<double>() << " ppm, " << seconds << " s):\n";
+        if (driftReport.contains("error")) {
+            out << "  " << driftReport["error"].get<std::string>() << "\n";
+        }
+        for (const auto& run : driftReport.value("runs", json::array())) {
+            out << "  correction " << std::left << std::setw(4) << (run["drift_correction"].get<bool>() ? "on" : "off")
+                << std::right;
+            if (run.contains("error")) {
+                out << run["error"].get<std::string>() << "\n";
+                continue;
+            }
+            out << " estimated " << run["estimated_ppm"].get<double>() << " ppm, ratio " << std::setprecision(6)
+                << run["ratio"].get<double>() << std::setprecision(2) << ", fill "
+                << run["fill_min_ms"].get<double>() << ".." << run["fill_max_ms"].get<double>() << " ms (target "
+                << run["fill_target_ms"].get<int>() << "), underruns " << run["underruns"].get<uint64_t>()
+                << ", overruns " << run["overruns"].get<uint64_t>() << "\n";
+        }
+    }
+    if (report.contains("packet_sizing")) {
+        const auto& sizingReport = report["packet_sizing"];
+        out << "Packet sizing (" << sizingReport["audio_s"].get<int>() << " s simulated per run):\n";
+        for (const auto& link : sizingReport["links"]) {
+            out << "  " << link["link"].get<std::string>() << " (rtt " << link["rtt_ms"].get<double>() << " ms, jitter "
+                << link["jitter_ms"].get<double>() << " ms, loss " << link["loss"].get<double>() * 100.0 << "%, "
+                << link["kbps"].get<double>() << " kbps)\n";
+            for (const auto& run : link["runs"]) {
+                const std::string size = run["packet_ms"].is_string() ? "adaptive"
+                                                                      : std::to_string(run["packet_ms"].get<int>()) + " ms";
+                out << "    " << std::left << std::setw(9) << size << std::right
+                    << " latency p50 " << std::setw(8) << run["latency_p50_ms"].get<double>() << " ms"
+                    << "  p95 " << std::setw(8) << run["latency_p95_ms"].get<double>() << " ms"
+                    << "  " << std::setw(6) << run["packets_per_s"].get<double>() << " pkt/s"
+                    << "  overhead " << run["overhead_pct"].get<double>() << "%";
+                if (run.contains("final_packet_ms")) {
+                    out << "  -> " << run["final_packet_ms"].get<int>() << " ms (" << run["changes"].get<uint64_t>()
+                        << " changes)";
+                }
+                out << "\n";
+            }
+        }
+    }
+    if (report.contains("file_asr")) {
+        const auto& asrReport = report["file_asr"];
+        out << "File ASR: " << (asrReport["ok"].get<bool>() ? "ok" : "failed") << ", "
+            << asrReport["elapsed_ms"].get<double>() << " ms, span "
+            << asrReport["transcript_span_ms"].get<int64_t>() << " ms (RTF "
+            << asrReport["realtime_factor"].get<double>() << ")\n";
+    }
+    if (report.contains("transcript_index")) {
+        const auto& indexReport = report["transcript_index"];
+        if (indexReport.contains("error")) {
+            out << "Transcript index: " << indexReport["error"].get<std::string>() << "\n";
+        } else {
+            out << "Transcript index: " << indexReport["hours"].get<int>() << " h, "
+                << indexReport["utterances"].get<uint64_t>() << " utterances, built in "
+                << indexReport["build_ms"].get<double>() << " ms\n"
+                << "  size " << indexReport["disk_bytes"].get<uint64_t>() / 1024.0 / 1024.0 << " MiB ("
+                << indexReport["bytes_per_hour"].get<uint64_t>() / 1024.0 << " KiB/h, text "
+                << indexReport["text_bytes"].get<uint64_t>() / 1024.0 / 1024.0 << " MiB), "
+                << indexReport["terms"].get<uint64_t>() << " terms in "
+                << indexReport["segments"].get<size_t>() << " segments\n";
+            for (const auto& query : indexReport["queries"]) {
+                out << "  " << std::left << std::setw(16) << query["class"].get<std::string>() << std::right
+                    << " p50 " << std::setw(9) << query["p50_us"].get<double>() << " us"
+                    << "  p99 " << std::setw(9) << query["p99_us"].get<double>() << " us"
+                    << "  avg hits " << query["avg_hits"].get<double>() << "\n";
+            }
+        }
+    }
+    std::string text = out.str();
+    text.pop_back();
+    writeLine(text);
+    return 0;
+}
+
+// ============================================================================
+// daemon
+// ============================================================================
+
+int runDaemon(const std::vector<std::string>& args) {
+    std::string socketPath = perfx::cli::ControlServer::defaultSocketPath();
+    std::string captionSpec;
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (args[i] == "--socket") {
+            if (!takeValue(args, i, socketPath)) return 2;
+        } else if (args[i] == "--captions") {
+            if (!takeValue(args, i, captionSpec)) return 2;
+        } else {
+            std::cerr << "Unknown option: " << args[i] << std::endl;
+            return 2;
+        }
+    }
+
+    std::unique_ptr<CaptionServer> captions;
+    if (!captionSpec.empty() && !(captions = startCaptionServer(captionSpec))) {
+        return 1;
+    }
+
+    TranscriptionEngine engine;
+    perfx::cli::ControlServer server(socketPath);
+
+    engine.setUpdateCallback([&server, &captions](const TranscriptUpdate& update) {
+        // 字幕只广播实时识别结果，文件识别结果仍通过控制套接字返回
+        if (captions && update.source == "live") {
+            captions->publish(update.utterances, update.final);
+        }
+        server.broadcast({
+            {"event", "transcript"},
+            {"source", update.source},
+            {"final", update.final},
+            {"utterances", utterancesToJson(update.utterances)}
+        });
+    });
+    engine.setErrorCallback([&server](const std::string& error) {
+        std::cerr << "[DAEMON] " << error << std::endl;
+        server.broadcast({{"event", "error"}, {"message", error}});
+    });
+
+    auto handler = [&engine, &captions](const json& request, perfx::cli::ControlConnection& connection) -> json {
+        const std::string command = request.value("cmd", "");
+
+        if (command == "status") {
+            return {{"ok", true}, {"live", liveStatsToJson(engine.getLiveStats())},
+                    {"scheduler", schedulerStatsToJson(Asr::RequestScheduler::instance().stats())}};
+        }
+        if (command == "devices") {
+            json devices = json::array();
+            for (const auto& device : TranscriptionEngine::listInputDevices()) {
+                devices.push_back({{"index", device.index}, {"name", device.name},
+                                   {"default", device.isDefaultInput}});
+            }
+            return {{"ok", true}, {"devices", devices}};
+        }
+        if (command == "live.start") {
+            LiveOptions options;
+            options.deviceIndex = request.value("device_index", -1);
+            options.deviceName = request.value("device_name", "");
+            options.enableVad = request.value("vad", true);
+            options.enableProcessing = request.value("processing", true);
+            options.channels = request.value("channels", 1);
+            if (request.contains("groups") && request["groups"].is_array()) {
+                // [{"label": "alice", "channels": [0, 1]}, ...]，声道号从 0 开始
+                for (const auto& item : request["groups"]) {
+                    perfx::audio::ChannelGroup group;
+                    group.label = item.value("label", "");
+                    group.channels = item.value("channels", std::vector<int>());
+                    options.channelGroups.push_back(std::move(group));
+                }
+            }
+            if (request.contains("sources") && request["sources"].is_array()) {
+                // [{"device_name": "Monitor of ...", "label": "remote"}, ...]
+                for (const auto& item : request["sources"]) {
+                    LiveSource source;
+                    source.deviceIndex = item.value("device_index", -1);
+                    source.deviceName = item.value("device_name", "");
+                    source.label = item.value("label", "");
+                    options.extraSources.push_back(std::move(source));
+                }
+            }
+            options.sourceLabel = request.value("source_label", options.sourceLabel);
+            options.mixSources = request.value("mix", false);
+            options.driftCorrection = request.value("drift_correction", true);
+            if (captions && !engine.isLive()) {
+                captions->reset();
+            }
+            if (!engine.startLive(options)) {
+                return {{"ok", false}, {"error", engine.getLastError()}};
+            }
+            return {{"ok", true}};
+        }
+        if (command == "live.stop") {
+            engine.stopLive();
+            return {{"ok", true}, {"utterances", utterancesToJson(engine.getLiveTranscript())}};
+        }
+        if (command == "transcript") {
+            return {{"ok", true}, {"utterances", utterancesToJson(engine.getLiveTranscript())}};
+        }
+        if (command == "transcribe") {
+            const std::string file = request.value("file", "");
+            if (file.empty()) {
+                return {{"ok", false}, {"error", "missing 'file'"}};
+            }
+            Asr::RequestPriority priority = Asr::RequestPriority::INTERACTIVE;
+            if (request.contains("priority") &&
+                !Asr::parseRequestPriority(request.value("priority", ""), priority)) {
+                return {{"ok", false}, {"error", "unknown 'priority'"}};
+            }
+            std::vector<Asr::CachedUtterance> utterances;
+            if (!engine.transcribeFile(file, utterances, request.value("timeout_ms", 30000), priority)) {
+                return {{"ok", false}, {"error", engine.getLastError()}};
+            }
+            return {{"ok", true}, {"file", file}, {"utterances", utterancesToJson(utterances)}};
+        }
+        if (command == "subscribe") {
+            connection.setSubscribed(request.value("enable", true));
+            return {{"ok", true}};
+        }
+        if (command == "trace.start") {
+            const size_t maxEvents = request.value("max_events", perfx::audio::trace::kDefaultMaxEvents);
+            perfx::audio::trace::start(maxEvents);
+            return {{"ok", true}};
+        }
+        if (command == "trace.stop") {
+            const std::string path = request.value("path", "");
+            if (path.empty()) {
+                return {{"ok", false}, {"error", "missing 'path'"}};
+            }
+            perfx::audio::trace::stop();
+            std::string traceError;
+            if (!perfx::audio::trace::writeChromeTrace(path, traceError)) {
+                return {{"ok", false}, {"error", traceError}};
+            }
+            const perfx::audio::trace::TraceStats stats = perfx::audio::trace::stats();
+            return {{"ok", true}, {"path", path}, {"events", stats.events},
+                    {"dropped", stats.dropped}, {"threads", stats.threads}};
+        }
+        if (command == "shutdown") {
+            g_stopRequested = true;
+            return {{"ok", true}};
+        }
+        return {{"ok", false}, {"error", "unknown command: " + command}};
+    };
+
+    std::string error;
+    if (!server.start(handler, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    while (!g_stopRequested) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+
+    std::cerr << "[DAEMON] Shutting down" << std::endl;
+    engine.stopLive();
+    server.stop();
+    if (captions) {
+        captions->stop();
+    }
+    return 0;
+}
+
+int runCommand(const std::string& command, const std::vector<std::string>& args) {
+    if (command == "transcribe") return runTranscribe(args);
+    if (command == "live") return runLive(args);
+    if (command == "devices") return runDevices(args);
+    if (command == "bench") return runBench(args);
+    if (command == "search") return runSearch(args);
+    if (command == "replay") return runReplay(args);
+    if (command == "daemon") return runDaemon(args);
+    if (command == "-h" || command == "--help" || command == "help") {
+        printUsage();
+        return 0;
+    }
+
+    std::cerr << "Unknown command: " << command << std::endl;
+    printUsage();
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // 结果写到原始 stdout，库日志（std::cout）改写到 stderr
+    std::ostream resultStream(std::cout.rdbuf());
+    g_out = &resultStream;
+    std::cout.rdbuf(std::cerr.rdbuf());
+
+    installSignalHandlers();
+
+    if (argc < 2) {
+        printUsage();
+        return 2;
+    }
+    const std::string command = argv[1];
+    const std::vector<std::string> args(argv + 2, argv + argc);
+
+    const std::string tracePath = perfx::audio::trace::startFromEnv();
+    const int status = runCommand(command, args);
+    if (!tracePath.empty() && perfx::audio::trace::enabled()) {
+        perfx::audio::trace::stop();
+        std::string error;
+        if (perfx::audio::trace::writeChromeTrace(tracePath, error)) {
+            const perfx::audio::trace::TraceStats stats = perfx::audio::trace::stats();
+            std::cerr << "[TRACE] Wrote " << stats.events << " events (" << stats.dropped
+                      << " dropped) to " << tracePath << std::endl;
+        } else {
+            std::cerr << "[TRACE] " << error << std::endl;
+        }
+    }
+    return status;
+}
@@ -0,0 +1,682 @@
+//
+// 字幕广播服务器实现
+//
+
+#include "logic/caption_server.h"
+#include <ixwebsocket/IXHttpServer.h>
+#include <ixwebsocket/IXWebSocket.h>
+#include <ixwebsocket/IXWebSocketCloseConstants.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+using json = nlohmann::json;
+
+namespace perfx {
+namespace logic {
+
+namespace {
+
+// 监听队列长度：ix 默认值为 5，大量观看端同时（重）连时会触发 SYN 重传，连接延迟数秒
+constexpr int kListenBacklog = 512;
+// 发送阻塞检测间隔
+constexpr int kWatchdogIntervalMs = 250;
+// 没有新帧时发送线程的兜底扫描间隔
+constexpr int kRescanIntervalMs = 100;
+
+int64_t nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+int64_t steadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+json utteranceToJson(size_t index, const Asr::CachedUtterance& utterance) {
+    json result = {
+        {"index", index},
+        {"text", utterance.text},
+        {"start_ms", utterance.startMs},
+        {"end_ms", utterance.endMs},
+        {"definite", utterance.definite}
+    };
+    if (!utterance.speaker.empty()) {
+        result["speaker"] = utterance.speaker;
+    }
+    return result;
+}
+
+bool sameUtterance(const Asr::CachedUtterance& a, const Asr::CachedUtterance& b) {
+    return a.definite == b.definite && a.startMs == b.startMs && a.endMs == b.endMs && a.text == b.text &&
+           a.speaker == b.speaker;
+}
+
+/**
+ * @brief 序列化为一次性共享帧（非法 UTF-8 替换为 U+FFFD，发送时无需逐客户端校验）
+ */
+CaptionFramePtr makeFrame(uint64_t seq, bool snapshot, const json& body) {
+    auto frame = std::make_shared<CaptionFrame>();
+    frame->seq = seq;
+    frame->snapshot = snapshot;
+    frame->payload = body.dump(-1, ' ', false, json::error_handler_t::replace);
+    return frame;
+}
+
+/**
+ * @brief 从请求 URI 中解析 since=<seq>
+ */
+bool parseSince(const std::string& uri, uint64_t& since) {
+    const size_t query = uri.find('?');
+    if (query == std::string::npos) {
+        return false;
+    }
+    size_t pos = query + 1;
+    while (pos < uri.size()) {
+        size_t end = uri.find('&', pos);
+        if (end == std::string::npos) end = uri.size();
+        const std::string param = uri.substr(pos, end - pos);
+        if (param.compare(0, 6, "since=") == 0 && param.size() > 6) {
+            char* parsedEnd = nullptr;
+            since = std::strtoull(param.c_str() + 6, &parsedEnd, 10);
+            return parsedEnd && *parsedEnd == '\0';
+        }
+        pos = end + 1;
+    }
+    return false;
+}
+
+std::string uriPath(const std::string& uri) {
+    return uri.substr(0, uri.find('?'));
+}
+
+} // namespace
+
+//==============================================================================
+// CaptionServer::Impl
+//==============================================================================
+
+class CaptionServer::Impl {
+public:
+    /**
+     * @brief 订阅者状态
+     *
+     * 每个订阅者的发送队列是共享历史帧末尾 clientQueueFrames 帧上的一个游标（cursor 为
+     * 已发送的最后序号），发布新帧无需逐个订阅者入队；落后超过队列上限时改发快照。
+     */
+    struct Subscriber {
+        std::weak_ptr<ix::WebSocket> socket;
+        std::atomic<bool> busy{false};          ///< 正被某个发送线程处理
+
+        std::mutex mutex;                       ///< 保护下面三个字段
+        uint64_t cursor = 0;
+        bool needsSnapshot = true;
+        uint64_t epoch = 0;                     ///< 每次续传递增，防止发送线程覆盖新游标
+
+        std::atomic<int64_t> sendStartedNs{0};  ///< 正在发送时的开始时间，0 表示空闲
+        std::atomic<bool> closed{false};
+    };
+    using SubscriberPtr = std::shared_ptr<Subscriber>;
+    using SubscriberList = std::vector<SubscriberPtr>;
+
+    /**
+     * @brief 发送线程持有的最近帧窗口（每次有新帧时在 stateMutex_ 内复制指针）
+     */
+    struct Window {
+        uint64_t firstSeq = 0;
+        uint64_t lastSeq = 0;
+        std::vector<CaptionFramePtr> frames;
+    };
+
+    explicit Impl(const CaptionServerConfig& config) : config_(config) {
+        config_.senderThreads = std::max(1, config_.senderThreads);
+        config_.clientQueueFrames = std::max<size_t>(1, config_.clientQueueFrames);
+        config_.historyFrames = std::max(config_.historyFrames, config_.clientQueueFrames);
+        subscriberList_ = std::make_shared<const SubscriberList>();
+    }
+
+    ~Impl() {
+        stop();
+    }
+
+    bool start(std::string& error) {
+        if (running_) {
+            return true;
+        }
+
+        server_ = std::make_unique<ix::HttpServer>(config_.port, config_.host,
+                                                   kListenBacklog, config_.maxClients);
+        // 每个客户端单独压缩会让 CPU 随订阅者数线性增长，字幕帧很小，直接发送明文
+        server_->disablePerMessageDeflate();
+        server_->setOnConnectionCallback(
+            [this](ix::HttpRequestPtr request, std::shared_ptr<ix::ConnectionState>) {
+                return handleHttp(request);
+            });
+        server_->ix::WebSocketServer::setOnConnectionCallback(
+            [this](std::weak_ptr<ix::WebSocket> weakSocket, std::shared_ptr<ix::ConnectionState>) {
+                onWebSocketConnection(std::move(weakSocket));
+            });
+
+        auto listening = server_->listen();
+        if (!listening.first) {
+            error = "Caption server failed to listen on " + config_.host + ":" +
+                    std::to_string(config_.port) + ": " + listening.second;
+            server_.reset();
+            return false;
+        }
+
+        running_ = true;
+        for (int i = 0; i < config_.senderThreads; ++i) {
+            senders_.emplace_back([this, i]() { senderLoop(static_cast<size_t>(i)); });
+        }
+        watchdogThread_ = std::thread([this]() { watchdogLoop(); });
+        server_->start();
+
+        std::cout << "[CAPTION] Listening on ws://" << config_.host << ":" << config_.port
+                  << "/captions (" << config_.senderThreads << " sender threads)" << std::endl;
+        return true;
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        wakeSenders();
+        watchdogCv_.notify_all();
+        // 看门狗先退出，此后只有服务器自身会关闭连接
+        if (watchdogThread_.joinable()) {
+            watchdogThread_.join();
+        }
+
+        // 关闭连接交给服务器：它按自己的连接表关闭并等待连接线程退出，不再从订阅者列表
+        // 逐个 close()（连接线程可能已退出并清除了消息回调）。close() 同时会中止阻塞中的发送
+        server_->stop();
+        for (auto& sender : senders_) {
+            if (sender.joinable()) {
+                sender.join();
+            }
+        }
+        senders_.clear();
+        {
+            std::lock_guard<std::mutex> lock(subscribersMutex_);
+            subscriberList_ = std::make_shared<const SubscriberList>();
+        }
+        server_.reset();
+        std::cout << "[CAPTION] Stopped" << std::endl;
+    }
+
+    bool isRunning() const {
+        return running_;
+    }
+
+    uint64_t publish(const std::vector<Asr::CachedUtterance>& utterances, bool final) {
+        uint64_t seq = 0;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex_);
+
+            json changed = json::array();
+            for (size_t i = 0; i < utterances.size(); ++i) {
+                if (i >= published_.size() || !sameUtterance(utterances[i], published_[i])) {
+                    changed.push_back(utteranceToJson(i, utterances[i]));
+                }
+            }
+            if (changed.empty() && utterances.size() == published_.size() && final == publishedFinal_) {
+                return 0;
+            }
+
+            published_ = utterances;
+            publishedFinal_ = final;
+            seq = lastSeq_ + 1;
+            history_.push_back(makeFrame(seq, false, {
+                {"type", "delta"},
+                {"seq", seq},
+                {"ts_us", nowUs()},
+                {"count", utterances.size()},
+                {"final", final},
+                {"utterances", std::move(changed)}
+            }));
+            while (history_.size() > config_.historyFrames) {
+                history_.pop_front();
+            }
+            lastSeq_ = seq;
+        }
+        framesPublished_++;
+        wakeSenders();
+        return seq;
+    }
+
+    void reset() {
+        {
+            std::lock_guard<std::mutex> lock(stateMutex_);
+            published_.clear();
+            publishedFinal_ = false;
+            // 历史清空后任何游标都不在窗口内，所有客户端改发（空）快照
+            history_.clear();
+            lastSeq_ = lastSeq_ + 1;
+        }
+        wakeSenders();
+    }
+
+    CaptionFramePtr getSnapshot() const {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        return snapshotLocked();
+    }
+
+    CaptionServerStats getStats() const {
+        CaptionServerStats stats;
+        stats.lastSeq = lastSeq_;
+        stats.clients = subscribers()->size();
+        stats.framesPublished = framesPublished_;
+        stats.framesSent = framesSent_;
+        stats.framesDropped = framesDropped_;
+        stats.snapshotsSent = snapshotsSent_;
+        stats.resumes = resumes_;
+        stats.stalledDisconnects = stalledDisconnects_;
+        return stats;
+    }
+
+    CaptionServerConfig config_;
+
+private:
+    CaptionFramePtr snapshotLocked() const {
+        const uint64_t seq = lastSeq_;
+        if (snapshot_ && snapshot_->seq == seq) {
+            return snapshot_;
+        }
+        json utterances = json::array();
+        for (size_t i = 0; i < published_.size(); ++i) {
+            utterances.push_back(utteranceToJson(i, published_[i]));
+        }
+        snapshot_ = makeFrame(seq, true, {
+            {"type", "snapshot"},
+            {"seq", seq},
+            {"ts_us", nowUs()},
+            {"count", published_.size()},
+            {"final", publishedFinal_},
+            {"utterances", std::move(utterances)}
+        });
+        return snapshot_;
+    }
+
+    void captureWindow(Window& window) const {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        const size_t count = std::min(history_.size(), config_.clientQueueFrames);
+        window.frames.assign(history_.end() - static_cast<std::ptrdiff_t>(count), history_.end());
+        window.lastSeq = lastSeq_;
+        window.firstSeq = window.frames.empty() ? window.lastSeq + 1 : window.frames.front()->seq;
+    }
+
+    // ============================================================================
+    // 连接管理
+    // ============================================================================
+
+    std::shared_ptr<const SubscriberList> subscribers() const {
+        std::lock_guard<std::mutex> lock(subscribersMutex_);
+        return subscriberList_;
+    }
+
+    void onWebSocketConnection(std::weak_ptr<ix::WebSocket> weakSocket) {
+        auto socket = weakSocket.lock();
+        if (!socket) {
+            return;
+        }
+        auto subscriber = std::make_shared<Subscriber>();
+        subscriber->socket = weakSocket;
+
+        // 回调中只持有 weak_ptr 形式的连接，避免 WebSocket ↔ Subscriber 循环引用
+        socket->setOnMessageCallback([this, subscriber](const ix::WebSocketMessagePtr& message) {
+            switch (message->type) {
+            case ix::WebSocketMessageType::Open: {
+                uint64_t since = 0;
+                const bool hasSince = parseSince(message->openInfo.uri, since);
+                resume(*subscriber, hasSince, since);
+                attach(subscriber);
+                break;
+            }
+            case ix::WebSocketMessageType::Message:
+                onClientMessage(*subscriber, message->str);
+                break;
+            case ix::WebSocketMessageType::Close:
+            case ix::WebSocketMessageType::Error:
+                detach(subscriber);
+                break;
+            default:
+                break;
+            }
+        });
+    }
+
+    /**
+     * @brief 订阅者列表写时复制：连接变动很少，发送线程每轮只取一次指针
+     */
+    void attach(const SubscriberPtr& subscriber) {
+        {
+            std::lock_guard<std::mutex> lock(subscribersMutex_);
+            auto list = std::make_shared<SubscriberList>(*subscriberList_);
+            list->push_back(subscriber);
+            subscriberList_ = std::move(list);
+        }
+        wakeSenders();
+    }
+
+    void detach(const SubscriberPtr& subscriber) {
+        subscriber->closed = true;
+        std::lock_guard<std::mutex> lock(subscribersMutex_);
+        auto list = std::make_shared<SubscriberList>(*subscriberList_);
+        list->erase(std::remove(list->begin(), list->end(), subscriber), list->end());
+        subscriberList_ = std::move(list);
+    }
+
+    /**
+     * @brief 按客户端给出的序号设置游标：窗口内由发送线程补发增量，否则发快照
+     */
+    void resume(Subscriber& subscriber, bool hasSince, uint64_t since) {
+        const uint64_t lastSeq = lastSeq_;
+        const bool valid = hasSince && since <= lastSeq;
+        {
+            std::lock_guard<std::mutex> lock(subscriber.mutex);
+            subscriber.epoch++;
+            subscriber.cursor = valid ? since : 0;
+            subscriber.needsSnapshot = !valid;
+        }
+        if (valid && lastSeq - since <= config_.clientQueueFrames) {
+            resumes_++;
+        }
+    }
+
+    /**
+     * @brief 客户端消息：{"resume": <seq>} 重新同步（例如客户端检测到序号跳变）
+     */
+    void onClientMessage(Subscriber& subscriber, const std::string& text) {
+        json request = json::parse(text, nullptr, false);
+        if (request.is_object() && request.contains("resume") && request["resume"].is_number_unsigned()) {
+            resume(subscriber, true, request["resume"].get<uint64_t>());
+            wakeSenders();
+        }
+    }
+
+    /**
+     * @brief 关闭仍处于连接状态的订阅者（调用方先用 closed.exchange(true) 认领）
+     *
+     * detach() 在连接线程收到 Close/Error 时先置 closed，之后连接线程才会退出并清除
+     * 消息回调，因此认领成功时连接线程仍在运行
+     */
+    static void closeSocket(Subscriber& subscriber, uint16_t code, const std::string& reason) {
+        if (auto socket = subscriber.socket.lock()) {
+            socket->close(code, reason);
+        }
+    }
+
+    // ============================================================================
+    // 发送
+    // ============================================================================
+
+    void wakeSenders() {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+            generation_++;
+        }
+        wakeCv_.notify_all();
+    }
+
+    /**
+     * @brief 发送线程：有新帧时扫描全部订阅者，各线程从不同位置开始，
+     *        通过 busy 标志认领订阅者，阻塞中的客户端只占用认领它的那个线程
+     */
+    void senderLoop(size_t index) {
+        uint64_t seenGeneration = 0;
+        bool morePending = false;
+        Window window;
+        while (running_) {
+            if (!morePending) {
+                std::unique_lock<std::mutex> lock(wakeMutex_);
+                wakeCv_.wait_for(lock, std::chrono::milliseconds(kRescanIntervalMs),
+                                 [&]() { return !running_ || generation_ != seenGeneration; });
+                seenGeneration = generation_;
+            }
+            if (!running_) {
+                break;
+            }
+
+            captureWindow(window);
+            const auto list = subscribers();
+            const size_t count = list->size();
+            const size_t start = count * index / static_cast<size_t>(config_.senderThreads);
+            morePending = false;
+            for (size_t k = 0; k < count && running_; ++k) {
+                morePending |= serve(*(*list)[(start + k) % count], window);
+            }
+        }
+    }
+
+    /**
+     * @brief 向一个订阅者发送其游标之后的帧
+     * @return 本轮达到配额后仍有待发送帧
+     */
+    bool serve(Subscriber& subscriber, Window& window) {
+        // 每轮最多发送的帧数：积压较多的客户端让出线程，保证公平
+        constexpr int kFramesPerTurn = 16;
+
+        if (subscriber.closed || subscriber.busy.exchange(true)) {
+            return false;
+        }
+        auto socket = subscriber.socket.lock();
+        int sent = 0;
+        bool pending = false;
+        while (socket && running_ && !subscriber.closed) {
+            if (window.lastSeq != lastSeq_) {
+                captureWindow(window);
+            }
+
+            CaptionFramePtr frame;
+            uint64_t epoch = 0;
+            uint64_t skipped = 0;
+            {
+                std::lock_guard<std::mutex> lock(subscriber.mutex);
+                if (!subscriber.needsSnapshot && subscriber.cursor >= window.lastSeq) {
+                    break;  // 已追上
+                }
+                if (sent >= kFramesPerTurn) {
+                    pending = true;
+                    break;
+                }
+                epoch = subscriber.epoch;
+                if (!subscriber.needsSnapshot && subscriber.cursor + 1 >= window.firstSeq) {
+                    frame = window.frames[subscriber.cursor + 1 - window.firstSeq];
+                } else {
+                    // 新连接、续传超出窗口、落后超过队列上限或转录被重置：直接跳到最新状态
+                    if (!subscriber.needsSnapshot && subscriber.cursor != 0) {
+                        skipped = window.lastSeq - subscriber.cursor;
+                    }
+                    subscriber.needsSnapshot = false;
+                }
+            }
+            if (!frame) {
+                frame = getSnapshot();
+                framesDropped_ += skipped;
+            }
+
+            // 服务端发送在对端不读取、内核缓冲写满时会阻塞，由看门狗负责超时断开
+            subscriber.sendStartedNs = steadyNs();
+            const bool ok = socket->sendUtf8Text(frame->payload).success;
+            subscriber.sendStartedNs = 0;
+            if (!ok) {
+                subscriber.closed = true;
+                break;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(subscriber.mutex);
+                if (subscriber.epoch == epoch) {
+                    subscriber.cursor = std::max(subscriber.cursor, frame->seq);
+                }
+            }
+            sent++;
+            framesSent_++;
+            if (frame->snapshot) {
+                snapshotsSent_++;
+            }
+        }
+        subscriber.busy = false;
+
+        // 处理期间可能有新帧发布而其他线程因 busy 跳过了它，释放后再检查一次
+        if (!pending && socket && !subscriber.closed && running_) {
+            std::lock_guard<std::mutex> lock(subscriber.mutex);
+            pending = subscriber.needsSnapshot || subscriber.cursor < lastSeq_;
+        }
+        return pending;
+    }
+
+    /**
+     * @brief 关闭发送阻塞超时的连接：close() 会中止阻塞中的发送，释放发送线程
+     */
+    void watchdogLoop() {
+        const int64_t stallNs = static_cast<int64_t>(config_.sendStallTimeoutMs) * 1000000;
+        while (running_) {
+            {
+                std::unique_lock<std::mutex> lock(watchdogMutex_);
+                watchdogCv_.wait_for(lock, std::chrono::milliseconds(kWatchdogIntervalMs),
+                                     [this]() { return !running_; });
+            }
+            const int64_t now = steadyNs();
+            const auto list = subscribers();
+            for (const auto& subscriber : *list) {
+                const int64_t started = subscriber->sendStartedNs;
+                if (started != 0 && now - started > stallNs && running_ && !subscriber->closed.exchange(true)) {
+                    closeSocket(*subscriber, ix::WebSocketCloseConstants::kInternalErrorCode,
+                                "caption client stalled");
+                    stalledDisconnects_++;
+                }
+            }
+        }
+    }
+
+    // ============================================================================
+    // HTTP
+    // ============================================================================
+
+    ix::HttpResponsePtr handleHttp(const ix::HttpRequestPtr& request) {
+        ix::WebSocketHttpHeaders headers;
+        headers["Content-Type"] = "application/json; charset=utf-8";
+        headers["Cache-Control"] = "no-store";
+        headers["Access-Control-Allow-Origin"] = "*";
+
+        const std::string path = uriPath(request->uri);
+        if (request->method != "GET") {
+            return std::make_shared<ix::HttpResponse>(405, "Method Not Allowed", ix::HttpErrorCode::Ok, headers,
+                                                      "{\"error\":\"method not allowed\"}");
+        }
+
+        if (path == "/transcript") {
+            return std::make_shared<ix::HttpResponse>(200, "OK", ix::HttpErrorCode::Ok, headers,
+                                                      transcriptBody(request->uri));
+        }
+        if (path == "/stats") {
+            const CaptionServerStats stats = getStats();
+            const json body = {
+                {"clients", stats.clients},
+                {"last_seq", stats.lastSeq},
+                {"frames_published", stats.framesPublished},
+                {"frames_sent", stats.framesSent},
+                {"frames_dropped", stats.framesDropped},
+                {"snapshots_sent", stats.snapshotsSent},
+                {"resumes", stats.resumes},
+                {"stalled_disconnects", stats.stalledDisconnects}
+            };
+            return std::make_shared<ix::HttpResponse>(200, "OK", ix::HttpErrorCode::Ok, headers, body.dump());
+        }
+        return std::make_shared<ix::HttpResponse>(404, "Not Found", ix::HttpErrorCode::Ok, headers,
+                                                  "{\"error\":\"not found\"}");
+    }
+
+    /**
+     * @brief 轮询接口：since 在历史窗口内返回增量帧数组，否则返回只含快照的数组
+     */
+    std::string transcriptBody(const std::string& uri) {
+        uint64_t since = 0;
+        const bool hasSince = parseSince(uri, since);
+
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        std::vector<CaptionFramePtr> frames;
+        if (hasSince && since <= lastSeq_ && !history_.empty() && since + 1 >= history_.front()->seq) {
+            for (const auto& frame : history_) {
+                if (frame->seq > since) frames.push_back(frame);
+            }
+        } else if (!(hasSince && since == lastSeq_)) {
+            frames.push_back(snapshotLocked());
+        }
+
+        std::string body = "[";
+        for (size_t i = 0; i < frames.size(); ++i) {
+            if (i > 0) body += ",";
+            body += frames[i]->payload;
+        }
+        body += "]";
+        return body;
+    }
+
+    std::unique_ptr<ix::HttpServer> server_;
+    std::atomic<bool> running_{false};
+
+    // 转录状态与历史帧
+    mutable std::mutex stateMutex_;
+    std::vector<Asr::CachedUtterance> published_;
+    bool publishedFinal_ = false;
+    std::atomic<uint64_t> lastSeq_{0};          ///< 只在 stateMutex_ 内修改，发送线程无锁读取
+    std::deque<CaptionFramePtr> history_;
+    mutable CaptionFramePtr snapshot_;
+
+    // 订阅者
+    mutable std::mutex subscribersMutex_;
+    std::shared_ptr<const SubscriberList> subscriberList_;
+
+    // 发送线程
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCv_;
+    uint64_t generation_ = 0;
+    std::vector<std::thread> senders_;
+    std::thread watchdogThread_;
+    std::mutex watchdogMutex_;
+    std::condition_variable watchdogCv_;
+
+    // 统计
+    std::atomic<uint64_t> framesPublished_{0};
+    std::atomic<uint64_t> framesSent_{0};
+    std::atomic<uint64_t> framesDropped_{0};
+    std::atomic<uint64_t> snapshotsSent_{0};
+    std::atomic<uint64_t> resumes_{0};
+    std::atomic<uint64_t> stalledDisconnects_{0};
+};
+
+//==============================================================================
+// CaptionServer
+//==============================================================================
+
+CaptionServer::CaptionServer(const CaptionServerConfig& config)
+    : impl_(std::make_unique<Impl>(config)) {}
+
+CaptionServer::~CaptionServer() = default;
+
+bool CaptionServer::start(std::string& error) { return impl_->start(error); }
+void CaptionServer::stop() { impl_->stop(); }
+bool CaptionServer::isRunning() const { return impl_->isRunning(); }
+
+uint64_t CaptionServer::publish(const std::vector<Asr::CachedUtterance>& utterances, bool final) {
+    return impl_->publish(utterances, final);
+}
+
+void CaptionServer::reset() { impl_->reset(); }
+CaptionFramePtr CaptionServer::getSnapshot() const { return impl_->getSnapshot(); }
+CaptionServerStats CaptionServer::getStats() const { return impl_->getStats(); }
+const CaptionServerConfig& CaptionServer::getConfig() const { return impl_->config_; }
+
+} // namespace logic
+} // namespace perfx
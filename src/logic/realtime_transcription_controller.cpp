@@ -1,5 +1,9 @@
 #include "logic/realtime_transcription_controller.h"
 #include "asr/asr_client.h"
+#include "asr/transcript_exporter.h"
+#include "logic/transcript_index.h"
+#include "audio/device_registry.h"
+#include "audio/trace_events.h"
 #include <iostream>
 #include <QTimer>
 #include <QTime>
@@ -14,10 +18,16 @@
 #include <QApplication>
 #include <chrono>
 #include <thread>
+#include <cstdlib>
 
 namespace perfx {
 namespace logic {
 
+// 备用会话的建立（连接 + 初始化包）需要的提前量
+static constexpr int64_t kStandbyLeadMs = 15000;
+// 备用会话建立失败后的重试间隔
+static constexpr int kStandbyRetryMs = 5000;
+
 // Omitting the ControllerAsrCallback for now as we simulate the results
 
 RealtimeTranscriptionController::RealtimeTranscriptionController(QObject* parent)
@@ -38,6 +48,44 @@ RealtimeTranscriptionController::RealtimeTranscriptionController(QObject* parent
     // 使用单例模式的ASR管理器，而不是创建新实例
     realtimeAsrManager_ = &Asr::AsrManager::instance();
     
+    // 客户端VAD（与采集配置一致：16kHz 单声道 INT16）
+    audio::VadConfig vadConfig;
+    vadConfig.sampleRate = 16000;
+    asrVad_ = std::make_unique<audio::VoiceActivityDetector>(vadConfig);
+    asrVadOutput_.reserve(4096);
+    if (const char* vadEnv = std::getenv("ASR_CLIENT_VAD")) {
+        std::string value = vadEnv;
+        clientVadEnabled_ = !(value == "0" || value == "false" || value == "off");
+    }
+    std::cout << "[CTRL] Client VAD " << (clientVadEnabled_ ? "enabled" : "disabled") << std::endl;
+    
+    // 延迟 / xrun 指标周期输出（PERFX_METRICS_DUMP_MS=5000 表示每5秒输出一次）
+    if (const char* dumpEnv = std::getenv("PERFX_METRICS_DUMP_MS")) {
+        int intervalMs = std::atoi(dumpEnv);
+        if (intervalMs > 0) {
+            audio::MetricsRegistry::instance().startPeriodicDump(intervalMs);
+            std::cout << "[CTRL] Metrics dump every " << intervalMs << "ms" << std::endl;
+        }
+    }
+    
+    // 字幕广播（PERFX_CAPTION_PORT=8765 启用；PERFX_CAPTION_HOST=0.0.0.0 允许局域网观看）
+    if (const char* portEnv = std::getenv("PERFX_CAPTION_PORT")) {
+        int port = std::atoi(portEnv);
+        if (port > 0) {
+            CaptionServerConfig captionConfig;
+            captionConfig.port = port;
+            if (const char* hostEnv = std::getenv("PERFX_CAPTION_HOST")) {
+                captionConfig.host = hostEnv;
+            }
+            captionServer_ = std::make_unique<CaptionServer>(captionConfig);
+            std::string error;
+            if (!captionServer_->start(error)) {
+                std::cout << "[CTRL] " << error << std::endl;
+                captionServer_.reset();
+            }
+        }
+    }
+    
     // 初始化ASR回调
     realtimeAsrCallback_ = std::make_unique<RealtimeAsrCallback>(this);
     realtimeAsrManager_->setCallback(realtimeAsrCallback_.get());
@@ -50,6 +98,36 @@ RealtimeTranscriptionController::RealtimeTranscriptionController(QObject* parent
     connect(waveformTimer_, &QTimer::timeout, this, &RealtimeTranscriptionController::updateWaveform);
     std::cout << "[CTRL] RealtimeTranscriptionController: waveform timer created" << std::endl;
     
+    // 设备注册表检测到热插拔或完成首次枚举时刷新设备列表
+    audio::DeviceRegistry& registry = audio::DeviceRegistry::getInstance();
+    registry.start();
+    // 注册表在工作线程中通知，切换到控制器所在线程后再刷新
+    deviceListenerId_ = registry.addListener(
+        [this](audio::DeviceRegistry::Event event, const std::vector<std::string>& added,
+               const std::vector<std::string>& removed) {
+            if (event == audio::DeviceRegistry::Event::Stale) {
+                return;
+            }
+            if (event == audio::DeviceRegistry::Event::Changed) {
+                std::cout << "[CTRL] Audio devices changed: +" << added.size()
+                          << " / -" << removed.size() << std::endl;
+            }
+            QMetaObject::invokeMethod(this, [this]() { refreshAudioDevices(); }, Qt::QueuedConnection);
+        });
+    
+    // 录音中设备丢失，AudioDevice 已自动切换到备用设备
+    connect(audioManager_.get(), &audio::AudioManager::inputDeviceChanged, this,
+            [this](const QString& deviceName) {
+                std::cout << "[CTRL] Input device failed over to: " << deviceName.toStdString() << std::endl;
+                // 备用设备的流格式可能不同；AudioManager 在重新启动采集之前发出该信号
+                inputConverter_ = audioManager_->getInputConverter();
+                audio::DeviceInfo device;
+                if (audio::DeviceRegistry::getInstance().findByName(deviceName.toStdString(), device)) {
+                    selectedDeviceId_ = device.index;
+                }
+                emit deviceSelectionResult(true, QString("输入设备已断开，已切换到: %1").arg(deviceName));
+            });
+    
     std::cout << "[CTRL] RealtimeTranscriptionController: all member variables initialized" << std::endl;
 }
 
@@ -66,14 +144,26 @@ void RealtimeTranscriptionController::shutdown() {
         enableRealtimeAsr(false);
     }
     
+    // 设备事件回调引用了 this，必须在析构前注销
+    if (deviceListenerId_ != 0) {
+        audio::DeviceRegistry::getInstance().removeListener(deviceListenerId_);
+        deviceListenerId_ = 0;
+    }
+    
     // 2. 确保ASR连接被正确断开
     if (realtimeAsrManager_) {
         std::cout << "[ASR-THREAD] Disconnecting ASR manager..." << std::endl;
+        stopSessionRollover();                  // 回收会话切换线程
         realtimeAsrManager_->stopRecognition(); // 先停止识别
         realtimeAsrManager_->disconnect();      // 再断开连接
         std::cout << "[ASR-THREAD] ASR manager disconnected." << std::endl;
     }
     
+    // 断开字幕观看端
+    if (captionServer_) {
+        captionServer_->stop();
+    }
+    
     // 3. 停止录音（如果正在录音）
     if (isRecording_) {
         std::cout << "[AUDIO-THREAD] Stopping active recording..." << std::endl;
@@ -113,7 +203,7 @@ void RealtimeTranscriptionController::refreshAudioDevices() {
         std::cout << "[DEBUG] audioManager_ is nullptr, recreating AudioManager..." << std::endl;
         audioManager_ = std::make_unique<audio::AudioManager>();
     }
-    // 获取真实的音频设备列表
+    // 获取真实的音频设备列表（注册表就绪后返回缓存，不在GUI线程上遍历PortAudio）
     if (audioManager_) {
         availableDevices_ = audioManager_->getAvailableDevices();
         QStringList deviceNames;
@@ -203,6 +293,17 @@ void RealtimeTranscriptionController::selectAudioDevice(int deviceId) {
         std::cout << "[DEBUG] Setting channels to device max: " << selectedDevice->maxInputChannels << std::endl;
     }
     config.framesPerBuffer = 256;
+
+    // 语音前处理：高通 + 降噪 + AGC（ASR_AUDIO_PROCESSING=0 关闭）
+    bool audioProcessing = true;
+    if (const char* procEnv = std::getenv("ASR_AUDIO_PROCESSING")) {
+        std::string value = procEnv;
+        audioProcessing = !(value == "0" || value == "false" || value == "off");
+    }
+    config.enableHighPass = audioProcessing;
+    config.enableNoiseSuppression = audioProcessing;
+    config.enableAGC = audioProcessing;
+    std::cout << "[CTRL] Audio processing chain " << (audioProcessing ? "enabled" : "disabled") << std::endl;
     
     // 设置输入设备信息
     config.inputDevice = *selectedDevice;
@@ -220,6 +321,7 @@ void RealtimeTranscriptionController::selectAudioDevice(int deviceId) {
             return;
         }
         std::cout << "[DEBUG] Audio manager initialized successfully" << std::endl;
+        inputConverter_ = audioManager_->getInputConverter();
         
         // **关键修复：设置音频数据回调，确保音频数据能传递到ASR**
         audioManager_->setExternalAudioCallback([this](const void* input, void* output, size_t frameCount) {
@@ -287,25 +389,24 @@ void RealtimeTranscriptionController::onAudioData(const void* input, void* outpu
         lastControllerLog = now;
     }
     
-    // 将INT16音频数据转换为浮点数用于波形显示
-    const int16_t* samples = static_cast<const int16_t*>(input);
-    QVector<float> waveformData;
-    waveformData.reserve(frameCount);
-    
-    for (size_t i = 0; i < frameCount; ++i) {
-        // 将INT16转换为-1.0到1.0的浮点数
-        float normalizedSample = static_cast<float>(samples[i]) / 32768.0f;
-        waveformData.append(normalizedSample);
-    }
+    // 混缩为单声道浮点用于波形显示（按实际流格式，经打开设备时选定的转换函数）
+    QVector<float> waveformData(static_cast<int>(frameCount));
+    inputConverter_.toMonoFloat(input, waveformData.data(), frameCount);
     
     // **关键修复：直接发送波形数据到UI，不依赖定时器**
     if (!waveformData.isEmpty()) {
         emit waveformUpdated(waveformData);
     }
     
-    // 处理实时ASR音频数据
+    // 处理实时ASR音频数据（ASR 需要单声道 INT16）
     if (realtimeAsrEnabled_) {
-        processAsrAudio(input, frameCount);
+        if (inputConverter_.isMonoInt16()) {
+            processAsrAudio(input, frameCount);
+        } else {
+            asrMonoBuffer_.resize(frameCount);
+            inputConverter_.toMonoInt16(input, asrMonoBuffer_.data(), frameCount);
+            processAsrAudio(asrMonoBuffer_.data(), frameCount);
+        }
     }
 }
 
@@ -457,6 +558,7 @@ void RealtimeTranscriptionController::saveRecordingFiles() {
     QString timeStr = now.toString("HHmmss");
     QString wavFilePath = QString("%1/%2.wav").arg(workDir).arg(timeStr);
     QString txtFilePath = QString("%1/%2.txt").arg(workDir).arg(timeStr);
+    QString srtFilePath = QString("%1/%2.srt").arg(workDir).arg(timeStr);
     
     // 复制WAV文件
     QFile tempFile(tempWavFilePath_);
@@ -500,8 +602,39 @@ void RealtimeTranscriptionController::saveRecordingFiles() {
         QMessageBox::warning(parentWindow, "警告", "无法创建文本文件，但录音文件已保存");
     }
     
+    // 字幕文件（采集时间线，与 WAV 对齐）
+    std::vector<Asr::CachedUtterance> subtitles;
+    {
+        // 已定稿分句的映射表可能已被裁剪，沿用缓存中的映射结果
+        std::lock_guard<std::mutex> mapsLock(asrUtteranceMapsMutex_);
+        subtitles = mapStitchedUtterancesLocked(asrStitcher_.merged());
+    }
+    QString savedFiles = QString("%1\n%2").arg(wavFilePath).arg(txtFilePath);
+    std::string exportError;
+    if (Asr::exportTranscript(subtitles, Asr::ExportFormat::Srt, srtFilePath.toStdString(),
+                              Asr::ExportOptions(), exportError)) {
+        std::cout << "[INFO] Subtitle file saved: " << srtFilePath.toStdString() << std::endl;
+        savedFiles += "\n" + srtFilePath;
+    } else {
+        std::cout << "[ERROR] Failed to save subtitle file: " << exportError << std::endl;
+    }
+    
+    // 加入全文索引（失败不影响保存结果）
+    if (!subtitles.empty()) {
+        TranscriptIndex index;
+        std::string indexError;
+        if (index.open(indexError)) {
+            index.addRecording(wavFilePath.toStdString(), subtitles);
+            if (!index.commit(indexError)) {
+                std::cout << "[WARNING] Failed to index transcript: " << indexError << std::endl;
+            }
+        } else {
+            std::cout << "[WARNING] Failed to open transcript index: " << indexError << std::endl;
+        }
+    }
+    
     QMessageBox::information(parentWindow, "保存成功", 
-                           QString("录音文件已保存到:\n%1\n%2").arg(wavFilePath).arg(txtFilePath));
+                           QString("录音文件已保存到:\n%1").arg(savedFiles));
 }
 
 // ============================================================================
@@ -530,8 +663,6 @@ void RealtimeAsrCallback::onClose(Asr::AsrClient* client) {
 }
 
 void RealtimeAsrCallback::onMessage(Asr::AsrClient* client, const std::string& message) {
-    (void)client; // 未使用
-    
 //    std::cout << "[DEBUG] ASR message received: " << message << std::endl;
     
     if (!controller_) {
@@ -559,27 +690,8 @@ void RealtimeAsrCallback::onMessage(Asr::AsrClient* client, const std::string& m
         
         // 使用与audio_to_text_window.cpp完全相同的逻辑
         if (resultObj.contains("utterances") && resultObj["utterances"].isArray()) {
-            QList<QVariantMap> utterList;
-            for (const auto& utteranceVal : resultObj["utterances"].toArray()) {
-                QJsonObject utterObj = utteranceVal.toObject();
-                QVariantMap map;
-                map["text"] = utterObj["text"].toString();
-                map["definite"] = utterObj["definite"].toBool();
-                map["start_time"] = utterObj["start_time"].toInt();
-                map["end_time"] = utterObj["end_time"].toInt();
-                // 保留 words 字段
-                if (utterObj.contains("words") && utterObj["words"].isArray()) {
-                    QVariantList wordList;
-                    for (const auto& wordVal : utterObj["words"].toArray()) {
-                        wordList.append(wordVal.toObject().toVariantMap());
-                    }
-                    map["words"] = wordList;
-                } else {
-                    map["words"] = QVariantList();
-                }
-                utterList.append(map);
-            }
-            emit controller_->asrUtterancesUpdated(utterList);
+            // 会话切换期间可能同时有两个会话返回结果，由控制器按时间边界拼接
+            controller_->handleAsrUtterances(client, message);
         } else if (resultObj.contains("text")) {
             QString text = resultObj["text"].toString();
             
@@ -600,6 +712,7 @@ void RealtimeAsrCallback::onMessage(Asr::AsrClient* client, const std::string& m
                 controller_->setCumulativeTranscriptionText(text);
             }
             
+            controller_->recordAsrResultLatency(!text.isEmpty(), isFinal);
             std::cout << "[DEBUG] 提取到text: " << text.toStdString() << ", isFinal: " << isFinal << std::endl;
             emit controller_->onAsrTranscriptionUpdated(text, isFinal);
         }
@@ -643,6 +756,12 @@ void RealtimeTranscriptionController::enableRealtimeAsr(bool enable) {
                 realtimeAsrManager_->startAsrThread();
             }
             
+            // 实时字幕优先于文件识别取得会话许可与音频额度（与文件窗口共用同一个管理器，每次开始时设置）
+            Asr::AsrConfig liveConfig = realtimeAsrManager_->getConfig();
+            liveConfig.requestPriority = Asr::RequestPriority::LIVE;
+            liveConfig.schedulerWaitMs = 2000;
+            realtimeAsrManager_->setConfig(liveConfig);
+            
             // 关键修复：在发送音频数据之前，先发送Full Client Request
             if (!realtimeAsrManager_->startRecognition()) {
                 std::cout << "[ERROR] Failed to start ASR recognition" << std::endl;
@@ -650,6 +769,26 @@ void RealtimeTranscriptionController::enableRealtimeAsr(bool enable) {
                 return;
             }
             
+            // 新会话的时间线从0开始
+            asrVad_->reset();
+            asrLatency_.reset();
+            asrBufferCaptureNs_ = 0;
+            
+            // 发送时间线从0开始，当前主会话是拼接器中的第一个会话
+            asrSentMs_ = 0;
+            asrStitcher_.reset();
+            asrStitcher_.beginSession(realtimeAsrManager_->getActiveClient(), 0);
+            {
+                std::lock_guard<std::mutex> mapsLock(asrUtteranceMapsMutex_);
+                asrUtteranceMaps_.clear();
+            }
+            if (captionServer_) {
+                captionServer_->reset();
+            }
+            rolloverState_ = RolloverState::Idle;
+            asrSessionStart_ = std::chrono::steady_clock::now();
+            nextStandbyAttempt_ = asrSessionStart_;
+            
             realtimeAsrEnabled_ = true;
             std::cout << "[INFO] Real-time ASR enabled" << std::endl;
             emit onAsrConnectionStatusChanged(true);
@@ -658,6 +797,9 @@ void RealtimeTranscriptionController::enableRealtimeAsr(bool enable) {
             // 禁用实时ASR
             realtimeAsrEnabled_ = false;
             
+            // 等待会话切换的后台线程结束，丢弃未接入的备用会话
+            stopSessionRollover();
+            
             // 停止ASR识别
             if (realtimeAsrManager_) {
                 realtimeAsrManager_->stopRecognition();
@@ -667,6 +809,16 @@ void RealtimeTranscriptionController::enableRealtimeAsr(bool enable) {
             asrAudioBuffer_.clear();
             asrBufferSize_ = 0;
             
+            if (clientVadEnabled_) {
+                audio::VadStats vadStats = asrVad_->getStats();
+                double sentRatio = vadStats.inputSamples > 0
+                    ? static_cast<double>(vadStats.outputSamples) / static_cast<double>(vadStats.inputSamples) : 1.0;
+                std::cout << "[INFO] Client VAD: sent " << static_cast<int>(sentRatio * 100.0)
+                          << "% of captured audio (" << vadStats.outputSamples << "/" << vadStats.inputSamples
+                          << " samples)" << std::endl;
+            }
+            
+            std::cout << audio::MetricsRegistry::instance().formatReport();
             std::cout << "[INFO] Real-time ASR disabled" << std::endl;
             emit onAsrConnectionStatusChanged(false);
         }
@@ -684,6 +836,27 @@ void RealtimeTranscriptionController::enableRealtimeAsr(bool enable) {
 // ASR线程状态判断和启动/关闭接口实现
 // ============================================================================
 
+void RealtimeTranscriptionController::setClientVadEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(asrMutex_);
+    clientVadEnabled_ = enabled;
+    asrVad_->reset();
+    // 映射方式改变，缓存的映射结果作废
+    std::lock_guard<std::mutex> mapsLock(asrUtteranceMapsMutex_);
+    asrUtteranceMaps_.clear();
+}
+
+void RealtimeTranscriptionController::recordAsrResultLatency(bool hasText, bool definite) {
+    asrLatency_.onResult(hasText, definite);
+}
+
+qint64 RealtimeTranscriptionController::mapAsrTimeMs(qint64 asrTimeMs) const {
+    // VoiceActivityDetector 的映射表自带锁，不需要 asrMutex_（发送期间会持有它）
+    if (!clientVadEnabled_) {
+        return asrTimeMs;
+    }
+    return asrVad_->mapOutputToInputMs(asrTimeMs);
+}
+
 bool RealtimeTranscriptionController::isAsrThreadRunning() const {
     return realtimeAsrEnabled_ && realtimeAsrManager_ && realtimeAsrManager_->isConnected();
 }
@@ -709,6 +882,8 @@ void RealtimeTranscriptionController::resetAsrState() {
         // 停止实时ASR
         realtimeAsrEnabled_ = false;
         
+        stopSessionRollover();
+        
         // 清理音频缓冲区
         asrAudioBuffer_.clear();
         asrBufferSize_ = 0;
@@ -755,6 +930,12 @@ void RealtimeTranscriptionController::processAsrAudio(const void* data, size_t f
         static std::chrono::steady_clock::time_point lastConnectionLog = std::chrono::steady_clock::now();
         static int consecutiveFailures = 0;
         
+        // 重叠窗口内主会话断开：直接切换到已在接收音频的备用会话
+        if (!realtimeAsrManager_->isConnected() && rolloverState_ == RolloverState::Overlap) {
+            std::cout << "[WARNING] Primary ASR session lost during overlap, promoting standby" << std::endl;
+            updateSessionRollover(true);
+        }
+        
         if (!realtimeAsrManager_->isConnected()) {
             connectionCheckCount++;
             auto now = std::chrono::steady_clock::now();
@@ -772,10 +953,14 @@ void RealtimeTranscriptionController::processAsrAudio(const void* data, size_t f
                 if (consecutiveFailures >= 10) {
                     std::cout << "[WARNING] Too many consecutive ASR connection failures, attempting reconnection..." << std::endl;
                     try {
-                        // 尝试重新连接
-                        if (realtimeAsrManager_->connect()) {
+                        // 尝试重新连接（新会话需要重新发送初始化包，时间戳从0开始）
+                        const Asr::AsrClient* previousClient = realtimeAsrManager_->getActiveClient();
+                        if (realtimeAsrManager_->startRecognition()) {
                             std::cout << "[INFO] ASR reconnection successful" << std::endl;
                             consecutiveFailures = 0;
+                            asrStitcher_.closeSession(previousClient);
+                            asrStitcher_.beginSession(realtimeAsrManager_->getActiveClient(), asrSentMs_);
+                            asrSessionStart_ = std::chrono::steady_clock::now();
                             emit onAsrConnectionStatusChanged(true);
                         } else {
                             std::cout << "[ERROR] ASR reconnection failed" << std::endl;
@@ -799,25 +984,42 @@ void RealtimeTranscriptionController::processAsrAudio(const void* data, size_t f
             consecutiveFailures = 0;
         }
         
-        // 累积音频数据
+        // 消费者线程在回调前设置了这批数据的采集时间
+        const int64_t chunkCaptureNs = audio::metrics::currentCaptureTime();
+        
+        // 客户端VAD：只保留语音段（含 pre-roll/hangover）
         const int16_t* samples = static_cast<const int16_t*>(data);
+        size_t sampleCount = frameCount;
+        if (clientVadEnabled_) {
+            asrVadOutput_.clear();
+            asrVad_->process(samples, frameCount, asrVadOutput_);
+            samples = asrVadOutput_.data();
+            sampleCount = asrVadOutput_.size();
+        }
+        if (sampleCount == 0) {
+            return;
+        }
+        
+        // 累积音频数据
+        if (asrBufferSize_ == 0) {
+            asrBufferCaptureNs_ = chunkCaptureNs;
+        }
         size_t oldSize = asrAudioBuffer_.size();
-        asrAudioBuffer_.resize(oldSize + frameCount * sizeof(int16_t));
-        std::memcpy(asrAudioBuffer_.data() + oldSize, samples, frameCount * sizeof(int16_t));
-        asrBufferSize_ += frameCount;
-        
-        // 检查是否有完整的100ms包
-        while (asrBufferSize_ >= ASR_PACKET_SIZE) {
-            // 提取100ms的音频数据
-            std::vector<uint8_t> audioPacket;
-            audioPacket.resize(ASR_PACKET_SIZE * sizeof(int16_t));
-            
-            std::memcpy(audioPacket.data(), 
-                       asrAudioBuffer_.data(), 
-                       ASR_PACKET_SIZE * sizeof(int16_t));
+        asrAudioBuffer_.resize(oldSize + sampleCount * sizeof(int16_t));
+        std::memcpy(asrAudioBuffer_.data() + oldSize, samples, sampleCount * sizeof(int16_t));
+        asrBufferSize_ += sampleCount;
+        
+        // 检查是否有完整的包（包时长按测得的链路 RTT 与结果延迟调整）
+        const size_t packetSamples = realtimeAsrManager_->getPacketSizeController()->packetSamples(ASR_SAMPLE_RATE);
+        while (asrBufferSize_ >= packetSamples) {
+            // 提取一个包的音频数据（复用发包缓冲的容量）
+            asrPacketBuffer_.assign(asrAudioBuffer_.begin(),
+                                    asrAudioBuffer_.begin() + packetSamples * sizeof(int16_t));
             
-            // 发送到ASR服务
-            if (!sendAsrAudioPacket(audioPacket, false)) {
+            // 发送到ASR服务；追踪流 id 取触发本次发包的那批数据的采集时间，由 AsrClient 关联到识别结果
+            PERFX_TRACE_SCOPE("asr.packetize");
+            audio::trace::setCurrentFlow(static_cast<uint64_t>(chunkCaptureNs));
+            if (!sendAsrAudioPacket(asrPacketBuffer_, false)) {
                 // 发送失败，增加失败计数
                 consecutiveFailures++;
                 std::cout << "[WARNING] Failed to send ASR audio packet, failure count: " << consecutiveFailures << std::endl;
@@ -828,14 +1030,25 @@ void RealtimeTranscriptionController::processAsrAudio(const void* data, size_t f
                     emit asrError("Too many ASR send failures");
                     return;
                 }
+            } else {
+                asrLatency_.onPacketSent(asrBufferCaptureNs_);
+                audio::trace::flowStep("asr.packet_sent", static_cast<uint64_t>(chunkCaptureNs));
+            }
+            // 发送时间线与VAD输出时间线保持一致（发送失败的包同样计入）
+            asrSentMs_ += static_cast<int64_t>(packetSamples) * 1000 / ASR_SAMPLE_RATE;
+            // 剩余数据的首样本顺延一个包的时长
+            if (asrBufferCaptureNs_ > 0) {
+                asrBufferCaptureNs_ += static_cast<int64_t>(packetSamples) * 1000000000LL / ASR_SAMPLE_RATE;
             }
             
             // 移除已发送的数据
             asrAudioBuffer_.erase(asrAudioBuffer_.begin(), 
-                                 asrAudioBuffer_.begin() + ASR_PACKET_SIZE * sizeof(int16_t));
-            asrBufferSize_ -= ASR_PACKET_SIZE;
+                                 asrAudioBuffer_.begin() + packetSamples * sizeof(int16_t));
+            asrBufferSize_ -= packetSamples;
         }
         
+        updateSessionRollover();
+        
     } catch (const std::exception& e) {
         std::cerr << "[ERROR] Exception in processAsrAudio: " << e.what() << std::endl;
         emit asrError(QString("Exception in processAsrAudio: %1").arg(e.what()));
@@ -845,6 +1058,240 @@ void RealtimeTranscriptionController::processAsrAudio(const void* data, size_t f
     }
 }
 
+// ============================================================================
+// 会话无缝切换（先建后断）
+// ============================================================================
+
+void RealtimeTranscriptionController::updateSessionRollover(bool primaryLost) {
+    // 调用方持有 asrMutex_；后台线程不获取 asrMutex_，因此可以在这里 join
+    const Asr::AsrConfig config = realtimeAsrManager_->getConfig();
+    if (config.liveSessionMaxMs <= 0) {
+        return;
+    }
+    
+    const auto now = std::chrono::steady_clock::now();
+    const int64_t ageMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - asrSessionStart_).count();
+    
+    switch (rolloverState_) {
+    case RolloverState::Idle:
+        // 到期前提前建立备用会话，留出握手与重叠窗口的时间
+        if (ageMs >= config.liveSessionMaxMs - config.liveSessionOverlapMs - kStandbyLeadMs &&
+            now >= nextStandbyAttempt_) {
+            if (standbyOpenThread_.joinable()) {
+                standbyOpenThread_.join();
+            }
+            standbyOpenDone_ = false;
+            standbySessionStart_ = now;
+            standbyOpenThread_ = std::thread([this]() {
+                std::unique_ptr<Asr::AsrClient> client = realtimeAsrManager_->openStandbySession();
+                {
+                    std::lock_guard<std::mutex> lock(standbyMutex_);
+                    pendingStandby_ = std::move(client);
+                }
+                standbyOpenDone_ = true;
+            });
+            rolloverState_ = RolloverState::Opening;
+            std::cout << "[CTRL] ASR session age " << ageMs / 1000 << "s, opening standby session" << std::endl;
+        }
+        break;
+        
+    case RolloverState::Opening: {
+        if (!standbyOpenDone_) {
+            break;
+        }
+        std::unique_ptr<Asr::AsrClient> client;
+        {
+            std::lock_guard<std::mutex> lock(standbyMutex_);
+            client = std::move(pendingStandby_);
+        }
+        if (!client) {
+            std::cout << "[WARNING] Failed to open standby ASR session, retrying in "
+                      << kStandbyRetryMs / 1000 << "s" << std::endl;
+            nextStandbyAttempt_ = now + std::chrono::milliseconds(kStandbyRetryMs);
+            rolloverState_ = RolloverState::Idle;
+            break;
+        }
+        // 与发包在同一把锁内：备用会话收到的第一个包就是 asrSentMs_ 处的音频
+        asrStitcher_.beginSession(client.get(), asrSentMs_);
+        realtimeAsrManager_->attachStandbySession(std::move(client));
+        overlapStartMs_ = asrSentMs_;
+        rolloverState_ = RolloverState::Overlap;
+        std::cout << "[CTRL] Standby ASR session attached at " << asrSentMs_ << "ms, overlap started" << std::endl;
+        break;
+    }
+    
+    case RolloverState::Overlap:
+        // 重叠音频足够新会话同步上下文，或主会话已到期 / 断开时切换
+        if (primaryLost || asrSentMs_ - overlapStartMs_ >= config.liveSessionOverlapMs ||
+            ageMs >= config.liveSessionMaxMs) {
+            std::unique_ptr<Asr::AsrClient> previous = realtimeAsrManager_->promoteStandbySession();
+            asrSessionStart_ = standbySessionStart_;
+            rolloverState_ = RolloverState::Idle;
+            if (!previous) {
+                break;
+            }
+            asrStitcher_.endSession(previous.get(), asrSentMs_);
+            if (sessionDrainThread_.joinable()) {
+                sessionDrainThread_.join();
+            }
+            sessionDrainThread_ = std::thread(&RealtimeTranscriptionController::finishDrainingSession,
+                                              this, std::move(previous));
+            std::cout << "[CTRL] ASR session rolled over at " << asrSentMs_ << "ms (overlap "
+                      << asrSentMs_ - overlapStartMs_ << "ms)" << std::endl;
+        }
+        break;
+    }
+}
+
+void RealtimeTranscriptionController::finishDrainingSession(std::unique_ptr<Asr::AsrClient> client) {
+    // 结束包（负序号）通知服务端音频已结束，等待旧会话把最后的分句定稿
+    const size_t packetSamples = realtimeAsrManager_->getPacketSizeController()->packetSamples(ASR_SAMPLE_RATE);
+    std::vector<uint8_t> silence(packetSamples * sizeof(int16_t), 0);
+    client->sendAudio(silence, -1);
+    
+    const int timeoutMs = realtimeAsrManager_->getConfig().liveSessionFinalizeTimeoutMs;
+    client->finalResponseAsync(timeoutMs).wait(timeoutMs);
+    const bool finalized = client->hasReceivedFinalResponse();
+    client->disconnect();
+    
+    asrStitcher_.closeSession(client.get());
+    emitStitchedUtterances();
+    std::cout << "[CTRL] Previous ASR session closed (" << (finalized ? "finalized" : "finalize timeout")
+              << ")" << std::endl;
+}
+
+void RealtimeTranscriptionController::stopSessionRollover() {
+    if (standbyOpenThread_.joinable()) {
+        standbyOpenThread_.join();
+    }
+    if (sessionDrainThread_.joinable()) {
+        sessionDrainThread_.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(standbyMutex_);
+        if (pendingStandby_) {
+            pendingStandby_->disconnect();
+            pendingStandby_.reset();
+        }
+    }
+    if (realtimeAsrManager_) {
+        realtimeAsrManager_->discardStandbySession();
+    }
+    rolloverState_ = RolloverState::Idle;
+}
+
+void RealtimeTranscriptionController::handleAsrUtterances(const Asr::AsrClient* client, const std::string& message) {
+    PERFX_TRACE_SCOPE("asr.utterances");
+    if (!asrStitcher_.update(client, message)) {
+        return;
+    }
+    
+    // 延迟统计只看主会话；结果包含会话内全部语句，以最后一条（当前语句）为准
+    if (realtimeAsrManager_ && client == realtimeAsrManager_->getActiveClient()) {
+        const std::vector<Asr::CachedUtterance> utterances = asrStitcher_.sessionUtterances(client);
+        if (!utterances.empty()) {
+            recordAsrResultLatency(!utterances.back().text.empty(), utterances.back().definite);
+        }
+    }
+    emitStitchedUtterances();
+}
+
+std::vector<Asr::CachedUtterance> RealtimeTranscriptionController::mapStitchedUtterancesLocked(
+    const std::vector<Asr::CachedUtterance>& merged) {
+    // 客户端VAD丢弃了静音段，发送时间线需映射回采集时间线；已定稿的分句沿用缓存的映射结果
+    asrUtteranceMaps_.resize(merged.size());
+    std::vector<Asr::CachedUtterance> mapped;
+    mapped.reserve(merged.size());
+    for (size_t i = 0; i < merged.size(); ++i) {
+        const auto& utterance = merged[i];
+        UtteranceMapCache& slot = asrUtteranceMaps_[i];
+        if (slot.definite && utterance.definite && slot.rawStartMs == utterance.startMs &&
+            slot.rawEndMs == utterance.endMs && slot.text == utterance.text) {
+            mapped.push_back(slot.mapped);
+            continue;
+        }
+        Asr::CachedUtterance result = utterance;
+        result.startMs = mapAsrTimeMs(utterance.startMs);
+        result.endMs = mapAsrTimeMs(utterance.endMs);
+        for (auto& word : result.words) {
+            word.startMs = mapAsrTimeMs(word.startMs);
+            word.endMs = mapAsrTimeMs(word.endMs);
+        }
+        slot.definite = utterance.definite;
+        slot.map.clear();
+        if (utterance.definite) {
+            slot.text = utterance.text;
+            slot.rawStartMs = utterance.startMs;
+            slot.rawEndMs = utterance.endMs;
+            slot.mapped = result;
+        }
+        mapped.push_back(std::move(result));
+    }
+    return mapped;
+}
+
+void RealtimeTranscriptionController::emitStitchedUtterances() {
+    QList<QVariantMap> utterList;
+    std::vector<Asr::CachedUtterance> captions;
+    // 已定稿的分句不再变化：沿用上次构建的 QVariantMap（隐式共享，复制不分配），
+    // 每个响应只为未定稿的分句重建，界面列表的构建量不随会话时长增长
+    std::lock_guard<std::mutex> mapsLock(asrUtteranceMapsMutex_);
+    int64_t settledMs = 0;
+    const std::vector<Asr::CachedUtterance> merged = mapStitchedUtterancesLocked(asrStitcher_.merged(settledMs));
+    utterList.reserve(static_cast<int>(merged.size()));
+    for (size_t i = 0; i < merged.size(); ++i) {
+        const auto& utterance = merged[i];
+        if (captionServer_) {
+            Asr::CachedUtterance caption;
+            caption.text = utterance.text;
+            caption.definite = utterance.definite;
+            caption.startMs = utterance.startMs;
+            caption.endMs = utterance.endMs;
+            captions.push_back(std::move(caption));
+        }
+        UtteranceMapCache& slot = asrUtteranceMaps_[i];
+        if (utterance.definite && !slot.map.isEmpty()) {
+            utterList.append(slot.map);
+            continue;
+        }
+        QVariantMap map;
+        map["text"] = QString::fromStdString(utterance.text);
+        map["definite"] = utterance.definite;
+        map["start_time"] = static_cast<qint64>(utterance.startMs);
+        map["end_time"] = static_cast<qint64>(utterance.endMs);
+        QVariantList wordList;
+        for (const auto& word : utterance.words) {
+            QVariantMap wordMap;
+            wordMap["text"] = QString::fromStdString(word.text);
+            wordMap["start_time"] = static_cast<qint64>(word.startMs);
+            wordMap["end_time"] = static_cast<qint64>(word.endMs);
+            wordList.append(wordMap);
+        }
+        map["words"] = wordList;
+        utterList.append(map);
+        if (utterance.definite) {
+            slot.map = map;
+        }
+    }
+    // 此前的分句都已定稿并缓存了映射结果，不再需要对应的映射段
+    if (clientVadEnabled_) {
+        asrVad_->discardMappingBefore(settledMs);
+    }
+    if (captionServer_) {
+        captionServer_->publish(captions);
+    }
+    emit asrUtterancesUpdated(utterList);
+
+    // 界面在 GUI 线程按排队顺序处理上面的信号，随后排队的这个调用标记文本已刷新
+    if (audio::trace::enabled()) {
+        const uint64_t flow = audio::trace::currentFlow();
+        QMetaObject::invokeMethod(this, [flow]() {
+            audio::trace::setThreadName("ui.main");
+            audio::trace::flowEnd("ui.text_rendered", flow);
+        }, Qt::QueuedConnection);
+    }
+}
+
 bool RealtimeTranscriptionController::sendAsrAudioPacket(const std::vector<uint8_t>& audioData, bool isLast) {
     try {
         if (!realtimeAsrManager_) {
@@ -0,0 +1,1495 @@
+//
+// 转录全文索引实现
+//
+
+#include "logic/transcript_index.h"
+#include "asr/transcript_exporter.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace perfx {
+namespace logic {
+
+namespace {
+
+constexpr uint32_t kSegmentVersion = 1;
+constexpr char kSegmentMagic[4] = {'P', 'X', 'T', 'I'};
+constexpr const char* kSegmentExtension = ".pxti";
+constexpr const char* kManifestName = "manifest.json";
+constexpr const char* kLockName = "index.lock";
+// 已删除录音的分句超过有效分句时整体压缩
+constexpr double kGarbageCompactRatio = 1.0;
+
+// ============================================================================
+// 段文件格式（按本机字节序存储，读取时逐条 memcpy，不要求对齐）
+//
+//   [倒排数据][分句表 UtteranceEntry × N][词典 TermEntry × M（按词字节序）][词文本][SegmentFooter]
+// ============================================================================
+
+struct UtteranceEntry {
+    uint32_t recordingId;
+    uint32_t startMs;
+    uint32_t endMs;
+};
+
+struct TermEntry {
+    uint64_t postingsOffset;
+    uint32_t postingsSize;
+    uint32_t termOffset;
+    uint32_t termLength;
+    uint32_t utteranceCount;    // 包含该词的分句数（查询时用于决定求交顺序）
+};
+
+struct SegmentFooter {
+    uint64_t utterancesOffset;
+    uint64_t termsOffset;
+    uint64_t termBytesOffset;
+    uint32_t utteranceCount;
+    uint32_t termCount;
+    uint32_t version;
+    char magic[4];
+};
+
+static_assert(sizeof(UtteranceEntry) == 12, "UtteranceEntry must be packed");
+static_assert(sizeof(TermEntry) == 24, "TermEntry must be packed");
+static_assert(sizeof(SegmentFooter) == 40, "SegmentFooter must be packed");
+
+uint32_t clampMs(int64_t ms) {
+    return static_cast<uint32_t>(std::min<int64_t>(std::max<int64_t>(ms, 0), UINT32_MAX));
+}
+
+void appendVarint(std::string& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+bool readVarint(const uint8_t*& p, const uint8_t* end, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35 && p < end; shift += 7) {
+        const uint8_t byte = *p++;
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// 分词
+// ============================================================================
+
+uint32_t decodeUtf8(const std::string& text, size_t& pos) {
+    const unsigned char lead = static_cast<unsigned char>(text[pos]);
+    if (lead < 0x80) {
+        pos++;
+        return lead;
+    }
+    size_t extra;
+    uint32_t cp;
+    if ((lead & 0xE0) == 0xC0) {
+        extra = 1;
+        cp = lead & 0x1F;
+    } else if ((lead & 0xF0) == 0xE0) {
+        extra = 2;
+        cp = lead & 0x0F;
+    } else if ((lead & 0xF8) == 0xF0) {
+        extra = 3;
+        cp = lead & 0x07;
+    } else {
+        pos++;
+        return 0xFFFD;
+    }
+    if (text.size() - pos <= extra) {
+        pos++;
+        return 0xFFFD;
+    }
+    for (size_t i = 1; i <= extra; ++i) {
+        const unsigned char next = static_cast<unsigned char>(text[pos + i]);
+        if ((next & 0xC0) != 0x80) {
+            pos++;
+            return 0xFFFD;
+        }
+        cp = (cp << 6) | (next & 0x3F);
+    }
+    pos += extra + 1;
+    return cp;
+}
+
+void appendUtf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+/**
+ * @brief 按二元组切分的文字：汉字、假名、谚文
+ */
+bool isCjk(uint32_t cp) {
+    return (cp >= 0x3040 && cp <= 0x30FF) || (cp >= 0x3400 && cp <= 0x4DBF) ||
+           (cp >= 0x4E00 && cp <= 0x9FFF) || (cp >= 0xAC00 && cp <= 0xD7A3) ||
+           (cp >= 0xF900 && cp <= 0xFAFF) || (cp >= 0x20000 && cp <= 0x3FFFF);
+}
+
+/**
+ * @brief 分隔符：空白、标点、符号（不参与索引）
+ */
+bool isSeparator(uint32_t cp) {
+    if (cp < 0x80) {
+        return !((cp >= '0' && cp <= '9') || (cp >= 'a' && cp <= 'z') || (cp >= 'A' && cp <= 'Z'));
+    }
+    return cp == 0xA0 || cp == 0xFFFD || (cp >= 0x2000 && cp <= 0x2BFF) || (cp >= 0x3000 && cp <= 0x303F) ||
+           (cp >= 0xFE30 && cp <= 0xFE4F) || (cp >= 0xFF00 && cp <= 0xFF0F) || (cp >= 0xFF1A && cp <= 0xFF20) ||
+           (cp >= 0xFF3B && cp <= 0xFF40) || (cp >= 0xFF5B && cp <= 0xFF65);
+}
+
+/**
+ * @brief 分词结果（词文本存放在共享缓冲中，逐句复用不重复分配）
+ */
+struct Token {
+    uint32_t offset;
+    uint32_t length;
+    uint32_t position;
+    bool prefix;        // 查询中的单字：匹配以该字开头的任意词
+};
+
+class Tokenizer {
+public:
+    /**
+     * @param query 查询模式：CJK 串末字只在串长为 1 时输出（作为前缀词）
+     */
+    void tokenize(const std::string& text, bool query) {
+        m_arena.clear();
+        m_tokens.clear();
+        m_word.clear();
+        m_run.clear();
+        m_runText = &text;
+        m_query = query;
+        m_position = 0;
+
+        size_t pos = 0;
+        while (pos < text.size()) {
+            const size_t start = pos;
+            uint32_t cp = decodeUtf8(text, pos);
+            // 全角 ASCII 转半角，西文转小写
+            if (cp >= 0xFF01 && cp <= 0xFF5E) {
+                cp -= 0xFEE0;
+            }
+            if (cp >= 'A' && cp <= 'Z') {
+                cp += 'a' - 'A';
+            }
+
+            if (isCjk(cp)) {
+                flushWord();
+                m_run.emplace_back(start, pos);
+            } else if (isSeparator(cp)) {
+                // 标点与空白只结束西文单词，CJK 串跨越标点继续
+                flushWord();
+            } else {
+                flushRun();
+                appendUtf8(m_word, cp);
+            }
+        }
+        flushWord();
+        flushRun();
+    }
+
+    const std::vector<Token>& tokens() const { return m_tokens; }
+
+    std::string_view term(const Token& token) const {
+        return std::string_view(m_arena.data() + token.offset, token.length);
+    }
+
+private:
+    void emit(const char* data, size_t size, bool prefix) {
+        m_tokens.push_back({static_cast<uint32_t>(m_arena.size()), static_cast<uint32_t>(size), m_position, prefix});
+        m_arena.append(data, size);
+    }
+
+    void flushWord() {
+        if (m_word.empty()) {
+            return;
+        }
+        if (!m_run.empty()) {
+            flushRun();
+        }
+        emit(m_word.data(), m_word.size(), false);
+        m_position++;
+        m_word.clear();
+    }
+
+    void flushRun() {
+        if (m_run.empty()) {
+            return;
+        }
+        const std::string& text = *m_runText;
+        for (size_t i = 0; i + 1 < m_run.size(); ++i) {
+            // 相邻两字在原文中可能隔着标点，拼接两段字节
+            const uint32_t offset = static_cast<uint32_t>(m_arena.size());
+            m_arena.append(text, m_run[i].first, m_run[i].second - m_run[i].first);
+            m_arena.append(text, m_run[i + 1].first, m_run[i + 1].second - m_run[i + 1].first);
+            m_tokens.push_back({offset, static_cast<uint32_t>(m_arena.size() - offset), m_position, false});
+            m_position++;
+        }
+        const auto& last = m_run.back();
+        if (!m_query || m_run.size() == 1) {
+            emit(text.data() + last.first, last.second - last.first, m_query);
+        }
+        m_position++;
+        m_run.clear();
+    }
+
+    std::string m_arena;
+    std::vector<Token> m_tokens;
+    std::string m_word;
+    std::vector<std::pair<size_t, size_t>> m_run;    // 当前 CJK 串各字的字节范围
+    const std::string* m_runText = nullptr;
+    uint32_t m_position = 0;
+    bool m_query = false;
+};
+
+// ============================================================================
+// 只读映射
+// ============================================================================
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path, std::string& error) {
+#if defined(_WIN32)
+        m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) {
+            error = "Failed to open " + path;
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+            error = "Empty or unreadable file: " + path;
+            close();
+            return false;
+        }
+        m_size = static_cast<size_t>(size.QuadPart);
+        m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_mapping) {
+            error = "Failed to map " + path;
+            close();
+            return false;
+        }
+        m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!m_data) {
+            error = "Failed to map " + path;
+            close();
+            return false;
+        }
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            error = "Failed to open " + path;
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            error = "Empty or unreadable file: " + path;
+            ::close(fd);
+            return false;
+        }
+        m_size = static_cast<size_t>(st.st_size);
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            error = "Failed to map " + path;
+            m_size = 0;
+            return false;
+        }
+        m_data = static_cast<const uint8_t*>(data);
+#endif
+        return true;
+    }
+
+    void close() {
+#if defined(_WIN32)
+        if (m_data) UnmapViewOfFile(m_data);
+        if (m_mapping) CloseHandle(m_mapping);
+        if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+        m_mapping = nullptr;
+        m_file = INVALID_HANDLE_VALUE;
+#else
+        if (m_data) munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+#if defined(_WIN32)
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#endif
+};
+
+/**
+ * @brief 索引目录的跨进程写锁（index.lock 上的独占 flock / LockFileEx，进程退出时由系统释放）
+ *
+ * 界面、实时控制器、命令行可能同时打开同一目录；commit 在锁内重新读取 manifest 再合并写回
+ */
+class DirectoryLock {
+public:
+    DirectoryLock() = default;
+    ~DirectoryLock() { unlock(); }
+
+    DirectoryLock(const DirectoryLock&) = delete;
+    DirectoryLock& operator=(const DirectoryLock&) = delete;
+
+    bool lock(const std::string& directory, std::string& error) {
+        const std::string path = (fs::path(directory) / kLockName).string();
+#if defined(_WIN32)
+        m_file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_ALWAYS,
+                             FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) {
+            error = "Failed to open " + path;
+            return false;
+        }
+        OVERLAPPED overlapped = {};
+        if (!LockFileEx(m_file, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &overlapped)) {
+            error = "Failed to lock " + path;
+            CloseHandle(m_file);
+            m_file = INVALID_HANDLE_VALUE;
+            return false;
+        }
+#else
+        m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (m_fd < 0) {
+            error = "Failed to open " + path;
+            return false;
+        }
+        // flock 按打开的文件描述归属，同一进程内的两个实例也互斥
+        int result;
+        do {
+            result = flock(m_fd, LOCK_EX);
+        } while (result != 0 && errno == EINTR);
+        if (result != 0) {
+            error = "Failed to lock " + path;
+            ::close(m_fd);
+            m_fd = -1;
+            return false;
+        }
+#endif
+        return true;
+    }
+
+    void unlock() {
+#if defined(_WIN32)
+        if (m_file != INVALID_HANDLE_VALUE) {
+            OVERLAPPED overlapped = {};
+            UnlockFileEx(m_file, 0, MAXDWORD, MAXDWORD, &overlapped);
+            CloseHandle(m_file);
+            m_file = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (m_fd >= 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+#endif
+    }
+
+private:
+#if defined(_WIN32)
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+#else
+    int m_fd = -1;
+#endif
+};
+
+// ============================================================================
+// 段读取
+// ============================================================================
+
+/**
+ * @brief 顺序读取一个词的倒排（只向前移动，位置按需解码）
+ */
+class PostingCursor {
+public:
+    PostingCursor(const uint8_t* data, size_t size) : m_p(data), m_end(data + size) {}
+
+    bool exhausted() const { return m_exhausted; }
+    uint32_t utterance() const { return m_utterance; }
+
+    /**
+     * @brief 移动到第一个分句号 >= target 的条目
+     */
+    bool advanceTo(uint32_t target) {
+        while (!m_exhausted && (!m_started || m_utterance < target)) {
+            next();
+        }
+        return !m_exhausted;
+    }
+
+    void appendPositions(std::vector<uint32_t>& out) const {
+        const uint8_t* p = m_positions;
+        uint32_t position = 0;
+        for (uint32_t i = 0; i < m_count; ++i) {
+            uint32_t gap;
+            if (!readVarint(p, m_end, gap)) {
+                return;
+            }
+            position += gap;
+            out.push_back(position);
+        }
+    }
+
+private:
+    void next() {
+        uint32_t delta;
+        if (m_p >= m_end || !readVarint(m_p, m_end, delta) || !readVarint(m_p, m_end, m_count)) {
+            m_exhausted = true;
+            return;
+        }
+        m_utterance += delta;
+        m_started = true;
+        m_positions = m_p;
+        uint32_t gap;
+        for (uint32_t i = 0; i < m_count; ++i) {
+            if (!readVarint(m_p, m_end, gap)) {
+                m_exhausted = true;
+                return;
+            }
+        }
+    }
+
+    const uint8_t* m_p;
+    const uint8_t* m_end;
+    const uint8_t* m_positions = nullptr;
+    uint32_t m_utterance = 0;
+    uint32_t m_count = 0;
+    bool m_started = false;
+    bool m_exhausted = false;
+};
+
+class Segment {
+public:
+    bool open(const std::string& path, std::string& error) {
+        if (!m_file.open(path, error)) {
+            return false;
+        }
+        const uint8_t* data = m_file.data();
+        const size_t size = m_file.size();
+        if (size < sizeof(SegmentFooter)) {
+            error = "Truncated index segment: " + path;
+            return false;
+        }
+        std::memcpy(&m_footer, data + size - sizeof(SegmentFooter), sizeof(SegmentFooter));
+        const uint64_t termBytesEnd = size - sizeof(SegmentFooter);
+        const bool valid =
+            std::memcmp(m_footer.magic, kSegmentMagic, sizeof(kSegmentMagic)) == 0 &&
+            m_footer.version == kSegmentVersion &&
+            m_footer.termsOffset == m_footer.utterancesOffset + uint64_t(m_footer.utteranceCount) * sizeof(UtteranceEntry) &&
+            m_footer.termBytesOffset == m_footer.termsOffset + uint64_t(m_footer.termCount) * sizeof(TermEntry) &&
+            m_footer.termBytesOffset <= termBytesEnd;
+        if (!valid) {
+            error = "Invalid index segment: " + path;
+            return false;
+        }
+        // 词典条目越界检查只做一次，查询时不再检查
+        for (uint32_t i = 0; i < m_footer.termCount; ++i) {
+            const TermEntry entry = term(i);
+            if (entry.postingsOffset + entry.postingsSize > m_footer.utterancesOffset ||
+                m_footer.termBytesOffset + entry.termOffset + entry.termLength > termBytesEnd) {
+                error = "Corrupted index segment: " + path;
+                return false;
+            }
+        }
+        m_path = path;
+        return true;
+    }
+
+    const std::string& path() const { return m_path; }
+    uint32_t utteranceCount() const { return m_footer.utteranceCount; }
+    uint32_t termCount() const { return m_footer.termCount; }
+    uint64_t postingsBytes() const { return m_footer.utterancesOffset; }
+    uint64_t fileBytes() const { return m_file.size(); }
+
+    UtteranceEntry utterance(uint32_t index) const {
+        UtteranceEntry entry;
+        std::memcpy(&entry, m_file.data() + m_footer.utterancesOffset + uint64_t(index) * sizeof(UtteranceEntry),
+                    sizeof(entry));
+        return entry;
+    }
+
+    TermEntry term(uint32_t index) const {
+        TermEntry entry;
+        std::memcpy(&entry, m_file.data() + m_footer.termsOffset + uint64_t(index) * sizeof(TermEntry), sizeof(entry));
+        return entry;
+    }
+
+    std::string_view termText(const TermEntry& entry) const {
+        return std::string_view(reinterpret_cast<const char*>(m_file.data() + m_footer.termBytesOffset + entry.termOffset),
+                                entry.termLength);
+    }
+
+    const uint8_t* postings(const TermEntry& entry) const {
+        return m_file.data() + entry.postingsOffset;
+    }
+
+    /**
+     * @brief 词典中 >= key 的第一个条目
+     */
+    uint32_t lowerBound(std::string_view key) const {
+        uint32_t low = 0;
+        uint32_t high = m_footer.termCount;
+        while (low < high) {
+            const uint32_t mid = low + (high - low) / 2;
+            if (termText(term(mid)) < key) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return low;
+    }
+
+    /**
+     * @brief 精确匹配或前缀匹配的词典范围 [first, last)
+     */
+    std::pair<uint32_t, uint32_t> termRange(std::string_view key, bool prefix) const {
+        const uint32_t first = lowerBound(key);
+        uint32_t last = first;
+        if (!prefix) {
+            if (first < m_footer.termCount && termText(term(first)) == key) {
+                last = first + 1;
+            }
+            return {first, last};
+        }
+        while (last < m_footer.termCount && termText(term(last)).substr(0, key.size()) == key) {
+            last++;
+        }
+        return {first, last};
+    }
+
+private:
+    MappedFile m_file;
+    SegmentFooter m_footer{};
+    std::string m_path;
+};
+
+using SegmentPtr = std::shared_ptr<const Segment>;
+
+// ============================================================================
+// 段写入
+// ============================================================================
+
+/**
+ * @brief 顺序写出段文件：先逐词写倒排，最后写分句表、词典与尾部
+ */
+class SegmentWriter {
+public:
+    SegmentWriter() : m_writer(m_sink) {}
+
+    bool open(const std::string& path, std::string& error) {
+        return m_sink.open(path, error);
+    }
+
+    void addTerm(std::string_view term, const std::string& postings, uint32_t utteranceCount) {
+        TermEntry entry;
+        entry.postingsOffset = m_offset;
+        entry.postingsSize = static_cast<uint32_t>(postings.size());
+        entry.termOffset = static_cast<uint32_t>(m_termBytes.size());
+        entry.termLength = static_cast<uint32_t>(term.size());
+        entry.utteranceCount = utteranceCount;
+        m_terms.push_back(entry);
+        m_termBytes.append(term.data(), term.size());
+        m_writer.write(postings.data(), postings.size());
+        m_offset += postings.size();
+    }
+
+    bool finish(const std::vector<UtteranceEntry>& utterances, std::string& error) {
+        SegmentFooter footer{};
+        footer.utterancesOffset = m_offset;
+        footer.termsOffset = footer.utterancesOffset + utterances.size() * sizeof(UtteranceEntry);
+        footer.termBytesOffset = footer.termsOffset + m_terms.size() * sizeof(TermEntry);
+        footer.utteranceCount = static_cast<uint32_t>(utterances.size());
+        footer.termCount = static_cast<uint32_t>(m_terms.size());
+        footer.version = kSegmentVersion;
+        std::memcpy(footer.magic, kSegmentMagic, sizeof(kSegmentMagic));
+
+        m_writer.write(reinterpret_cast<const char*>(utterances.data()), utterances.size() * sizeof(UtteranceEntry));
+        m_writer.write(reinterpret_cast<const char*>(m_terms.data()), m_terms.size() * sizeof(TermEntry));
+        m_writer.write(m_termBytes);
+        m_writer.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+        if (!m_writer.flush()) {
+            error = "Failed to write index segment";
+            m_sink.discard();
+            return false;
+        }
+        return m_sink.commit(error);
+    }
+
+private:
+    Asr::FileSink m_sink;
+    Asr::ExportWriter m_writer;
+    std::vector<TermEntry> m_terms;
+    std::string m_termBytes;
+    uint64_t m_offset = 0;
+};
+
+/**
+ * @brief 内存中构建新段（commit 前新增的录音）
+ */
+class SegmentBuilder {
+public:
+    /**
+     * @return 分句包含可索引的词
+     */
+    bool addUtterance(uint32_t recordingId, const Asr::CachedUtterance& utterance) {
+        m_tokenizer.tokenize(utterance.text, false);
+        const auto& tokens = m_tokenizer.tokens();
+        if (tokens.empty()) {
+            return false;
+        }
+        const uint32_t id = static_cast<uint32_t>(m_utterances.size());
+        m_utterances.push_back({recordingId, clampMs(utterance.startMs), clampMs(utterance.endMs)});
+
+        // 按 (词, 位置) 排序后分组，每个词在本句追加一条倒排
+        m_order.resize(tokens.size());
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            m_order[i] = static_cast<uint32_t>(i);
+        }
+        std::sort(m_order.begin(), m_order.end(), [&](uint32_t a, uint32_t b) {
+            const int cmp = m_tokenizer.term(tokens[a]).compare(m_tokenizer.term(tokens[b]));
+            return cmp < 0 || (cmp == 0 && tokens[a].position < tokens[b].position);
+        });
+
+        size_t i = 0;
+        while (i < m_order.size()) {
+            const std::string_view term = m_tokenizer.term(tokens[m_order[i]]);
+            size_t j = i + 1;
+            while (j < m_order.size() && m_tokenizer.term(tokens[m_order[j]]) == term) {
+                j++;
+            }
+            m_key.assign(term.data(), term.size());
+            TermPostings& postings = m_terms[m_key];
+            appendVarint(postings.bytes, id - postings.lastUtterance);
+            appendVarint(postings.bytes, static_cast<uint32_t>(j - i));
+            uint32_t previous = 0;
+            for (size_t k = i; k < j; ++k) {
+                const uint32_t position = tokens[m_order[k]].position;
+                appendVarint(postings.bytes, position - previous);
+                previous = position;
+            }
+            postings.lastUtterance = id;
+            postings.utteranceCount++;
+            i = j;
+        }
+        return true;
+    }
+
+    bool empty() const { return m_utterances.empty(); }
+
+    /**
+     * @param ids 暂定录音号 → 提交时分配的正式录音号；不在表中的（已被替换或撤销的暂存录音）写为 0，查询时视为已删除
+     */
+    bool write(const std::string& path, const std::unordered_map<uint32_t, uint32_t>& ids, std::string& error) {
+        std::vector<const std::pair<const std::string, TermPostings>*> sorted;
+        sorted.reserve(m_terms.size());
+        for (const auto& item : m_terms) {
+            sorted.push_back(&item);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+
+        // 倒排只引用分句号，换录音号只需改分句表；不改 m_utterances，提交失败后可以重试
+        std::vector<UtteranceEntry> utterances = m_utterances;
+        for (auto& utterance : utterances) {
+            const auto it = ids.find(utterance.recordingId);
+            utterance.recordingId = it != ids.end() ? it->second : 0;
+        }
+
+        SegmentWriter writer;
+        if (!writer.open(path, error)) {
+            return false;
+        }
+        for (const auto* item : sorted) {
+            writer.addTerm(item->first, item->second.bytes, item->second.utteranceCount);
+        }
+        return writer.finish(utterances, error);
+    }
+
+private:
+    struct TermPostings {
+        std::string bytes;
+        uint32_t lastUtterance = 0;
+        uint32_t utteranceCount = 0;
+    };
+
+    Tokenizer m_tokenizer;
+    std::vector<uint32_t> m_order;
+    std::string m_key;
+    std::unordered_map<std::string, TermPostings> m_terms;
+    std::vector<UtteranceEntry> m_utterances;
+};
+
+/**
+ * @brief 流式合并若干段：按词典序多路归并，倒排按新分句号重新编码，丢弃已删除录音的分句
+ *
+ * 合并后的分句按 (录音号, 开始时间) 排列，查询时每个段内的命中天然有序，可以提前结束
+ */
+bool mergeSegments(const std::vector<SegmentPtr>& inputs, const std::unordered_set<uint32_t>& live,
+                   const std::string& path, std::string& error) {
+    constexpr uint32_t kDropped = UINT32_MAX;
+    struct Source {
+        UtteranceEntry entry;
+        uint32_t segment;
+        uint32_t index;
+    };
+    std::vector<Source> sources;
+    std::vector<std::vector<uint32_t>> remap(inputs.size());
+    for (size_t s = 0; s < inputs.size(); ++s) {
+        remap[s].resize(inputs[s]->utteranceCount(), kDropped);
+        for (uint32_t i = 0; i < inputs[s]->utteranceCount(); ++i) {
+            const UtteranceEntry entry = inputs[s]->utterance(i);
+            if (live.count(entry.recordingId)) {
+                sources.push_back({entry, static_cast<uint32_t>(s), i});
+            }
+        }
+    }
+    std::stable_sort(sources.begin(), sources.end(), [](const Source& a, const Source& b) {
+        return a.entry.recordingId < b.entry.recordingId ||
+               (a.entry.recordingId == b.entry.recordingId && a.entry.startMs < b.entry.startMs);
+    });
+    std::vector<UtteranceEntry> utterances;
+    utterances.reserve(sources.size());
+    for (const auto& source : sources) {
+        remap[source.segment][source.index] = static_cast<uint32_t>(utterances.size());
+        utterances.push_back(source.entry);
+    }
+    sources.clear();
+    sources.shrink_to_fit();
+
+    SegmentWriter writer;
+    if (!writer.open(path, error)) {
+        return false;
+    }
+
+    // (段号, 词典下标)
+    using Cursor = std::pair<size_t, uint32_t>;
+    auto greater = [&](const Cursor& a, const Cursor& b) {
+        const int cmp = inputs[a.first]->termText(inputs[a.first]->term(a.second))
+                            .compare(inputs[b.first]->termText(inputs[b.first]->term(b.second)));
+        return cmp > 0 || (cmp == 0 && a.first > b.first);
+    };
+    std::priority_queue<Cursor, std::vector<Cursor>, decltype(greater)> heap(greater);
+    for (size_t s = 0; s < inputs.size(); ++s) {
+        if (inputs[s]->termCount() > 0) {
+            heap.push({s, 0});
+        }
+    }
+
+    // 一个词在各段中的条目：新分句号 + 原位置数据（位置差值原样复制）
+    struct Posting {
+        uint32_t utterance;
+        uint32_t count;
+        const uint8_t* positions;
+        uint32_t size;
+    };
+    std::vector<Posting> entries;
+    std::string term;
+    std::string postings;
+    while (!heap.empty()) {
+        const Cursor top = heap.top();
+        term.assign(inputs[top.first]->termText(inputs[top.first]->term(top.second)));
+        entries.clear();
+
+        while (!heap.empty()) {
+            const Cursor cursor = heap.top();
+            const Segment& segment = *inputs[cursor.first];
+            const TermEntry entry = segment.term(cursor.second);
+            if (segment.termText(entry) != term) {
+                break;
+            }
+            heap.pop();
+            if (cursor.second + 1 < segment.termCount()) {
+                heap.push({cursor.first, cursor.second + 1});
+            }
+
+            const uint8_t* p = segment.postings(entry);
+            const uint8_t* end = p + entry.postingsSize;
+            uint32_t utterance = 0;
+            while (p < end) {
+                uint32_t delta, count, gap;
+                if (!readVarint(p, end, delta) || !readVarint(p, end, count)) {
+                    break;
+                }
+                utterance += delta;
+                const uint8_t* positions = p;
+                for (uint32_t i = 0; i < count && readVarint(p, end, gap); ++i) {
+                }
+                const auto& segmentRemap = remap[cursor.first];
+                const uint32_t mapped = utterance < segmentRemap.size() ? segmentRemap[utterance] : kDropped;
+                if (mapped != kDropped) {
+                    entries.push_back({mapped, count, positions, static_cast<uint32_t>(p - positions)});
+                }
+            }
+        }
+        if (entries.empty()) {
+            continue;
+        }
+
+        std::sort(entries.begin(), entries.end(),
+                  [](const Posting& a, const Posting& b) { return a.utterance < b.utterance; });
+        postings.clear();
+        uint32_t lastOut = 0;
+        for (const auto& posting : entries) {
+            appendVarint(postings, posting.utterance - lastOut);
+            appendVarint(postings, posting.count);
+            postings.append(reinterpret_cast<const char*>(posting.positions), posting.size);
+            lastOut = posting.utterance;
+        }
+        writer.addTerm(term, postings, static_cast<uint32_t>(entries.size()));
+    }
+    return writer.finish(utterances, error);
+}
+
+/**
+ * @brief 段量级：按文件大小取 4 为底的对数
+ */
+int segmentTier(uint64_t bytes) {
+    return static_cast<int>(std::log(static_cast<double>(std::max<uint64_t>(bytes, 1))) / std::log(4.0));
+}
+
+// ============================================================================
+// 查询
+// ============================================================================
+
+/**
+ * @brief 查询词的倒排游标（前缀匹配时为多个词的并集）
+ */
+struct QueryCursor {
+    std::vector<PostingCursor> parts;
+    uint64_t frequency = 0;
+    uint32_t position = 0;          // 在查询中的位置
+    uint32_t utterance = 0;
+    bool exhausted = false;
+
+    bool advanceTo(uint32_t target) {
+        utterance = UINT32_MAX;
+        for (auto& part : parts) {
+            if (part.advanceTo(target)) {
+                utterance = std::min(utterance, part.utterance());
+            }
+        }
+        exhausted = utterance == UINT32_MAX;
+        return !exhausted;
+    }
+
+    void positions(std::vector<uint32_t>& out) const {
+        out.clear();
+        for (const auto& part : parts) {
+            if (!part.exhausted() && part.utterance() == utterance) {
+                part.appendPositions(out);
+            }
+        }
+        if (parts.size() > 1) {
+            std::sort(out.begin(), out.end());
+        }
+    }
+};
+
+/**
+ * @brief 在一个段中执行短语查询（逐分句求交，游标按最稀有的词推进）
+ *
+ * 段内分句按 (录音号, 开始时间) 排列，收集到 limit 个有效命中即可停止
+ */
+template <typename IsLive>
+void searchSegment(const Segment& segment, const Tokenizer& query, size_t limit, IsLive isLive,
+                   std::vector<UtteranceEntry>& hits) {
+    const auto& tokens = query.tokens();
+    std::vector<QueryCursor> cursors(tokens.size());
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const auto range = segment.termRange(query.term(tokens[i]), tokens[i].prefix);
+        if (range.first == range.second) {
+            return;
+        }
+        cursors[i].position = tokens[i].position;
+        for (uint32_t t = range.first; t < range.second; ++t) {
+            const TermEntry entry = segment.term(t);
+            cursors[i].parts.emplace_back(segment.postings(entry), entry.postingsSize);
+            cursors[i].frequency += entry.utteranceCount;
+        }
+    }
+    std::sort(cursors.begin(), cursors.end(),
+              [](const QueryCursor& a, const QueryCursor& b) { return a.frequency < b.frequency; });
+
+    const size_t n = cursors.size();
+    std::vector<std::vector<uint32_t>> positions(n);
+    size_t found = 0;
+    uint32_t target = 0;
+    while (true) {
+        // 所有游标对齐到同一分句
+        if (!cursors[0].advanceTo(target)) {
+            return;
+        }
+        target = cursors[0].utterance;
+        bool aligned = true;
+        for (size_t i = 1; i < n; ++i) {
+            if (!cursors[i].advanceTo(target)) {
+                return;
+            }
+            if (cursors[i].utterance != target) {
+                target = cursors[i].utterance;
+                aligned = false;
+                break;
+            }
+        }
+        if (!aligned) {
+            continue;
+        }
+
+        // 位置校验：各词相对位置与查询一致
+        for (size_t i = 0; i < n; ++i) {
+            cursors[i].positions(positions[i]);
+        }
+        bool matched = false;
+        for (uint32_t anchor : positions[0]) {
+            const int64_t base = int64_t(anchor) - cursors[0].position;
+            if (base < 0) {
+                continue;
+            }
+            matched = true;
+            for (size_t i = 1; i < n && matched; ++i) {
+                matched = std::binary_search(positions[i].begin(), positions[i].end(),
+                                             static_cast<uint32_t>(base + cursors[i].position));
+            }
+            if (matched) {
+                break;
+            }
+        }
+        if (matched) {
+            const UtteranceEntry entry = segment.utterance(target);
+            if (isLive(entry.recordingId)) {
+                hits.push_back(entry);
+                if (limit > 0 && ++found >= limit) {
+                    return;
+                }
+            }
+        }
+        if (target == UINT32_MAX) {
+            return;
+        }
+        target++;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Impl
+// ============================================================================
+
+class TranscriptIndex::Impl {
+public:
+    struct Recording {
+        uint32_t id = 0;
+        std::string path;
+        uint32_t utterances = 0;
+        int64_t durationMs = 0;
+    };
+
+    /**
+     * @brief 已提交状态（不可变，查询持有快照，写入时整体替换）
+     */
+    struct State {
+        std::vector<SegmentPtr> segments;
+        std::unordered_map<uint32_t, Recording> recordings;
+        std::unordered_map<std::string, uint32_t> byPath;
+    };
+
+    explicit Impl(const TranscriptIndexConfig& config)
+        : config_(config),
+          directory_(config.directory.empty() ? TranscriptIndex::defaultDirectory() : config.directory),
+          state_(std::make_shared<State>()) {
+        config_.mergeFactor = std::max<size_t>(config_.mergeFactor, 2);
+    }
+
+    bool open(std::string& error) {
+        std::lock_guard<std::mutex> writeLock(writeMutex_);
+        std::error_code ec;
+        fs::create_directories(directory_, ec);
+        if (ec) {
+            error = "Failed to create index directory " + directory_ + ": " + ec.message();
+            return false;
+        }
+
+        // 持锁清理，避免删掉其他写入者刚写好、尚未写进 manifest 的段
+        DirectoryLock directoryLock;
+        if (!directoryLock.lock(directory_, error)) {
+            return false;
+        }
+        auto state = std::make_shared<State>();
+        if (!loadManifest(*state, nullptr, error)) {
+            return false;
+        }
+        std::unordered_set<std::string> referenced;
+        for (const auto& segment : state->segments) {
+            referenced.insert(fs::path(segment->path()).filename().string());
+        }
+
+        // 清理上次中断留下的临时文件与未被引用的段
+        for (const auto& entry : fs::directory_iterator(directory_, ec)) {
+            const std::string name = entry.path().filename().string();
+            const bool segmentFile = entry.path().extension() == kSegmentExtension;
+            const bool tempFile = entry.path().extension() == ".tmp";
+            if ((segmentFile && !referenced.count(name)) || tempFile) {
+                std::error_code removeError;
+                fs::remove(entry.path(), removeError);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        state_ = std::move(state);
+        return true;
+    }
+
+    void addRecording(const std::string& path, const std::vector<Asr::CachedUtterance>& utterances) {
+        std::lock_guard<std::mutex> writeLock(writeMutex_);
+        // 正式录音号在 commit 时持目录锁分配（其他写入者可能已用掉本实例看到的号）
+        Recording recording;
+        recording.id = nextPendingId_++;
+        recording.path = path;
+        if (!builder_) {
+            builder_ = std::make_unique<SegmentBuilder>();
+        }
+        // 段内分句按开始时间排列（查询按段内顺序提前结束）
+        std::vector<const Asr::CachedUtterance*> ordered;
+        ordered.reserve(utterances.size());
+        for (const auto& utterance : utterances) {
+            ordered.push_back(&utterance);
+        }
+        std::stable_sort(ordered.begin(), ordered.end(), [](const Asr::CachedUtterance* a, const Asr::CachedUtterance* b) {
+            return a->startMs < b->startMs;
+        });
+        for (const auto* utterance : ordered) {
+            if (builder_->addUtterance(recording.id, *utterance)) {
+                recording.utterances++;
+                recording.durationMs = std::max(recording.durationMs, utterance->endMs);
+            }
+        }
+        pendingRemovals_.erase(path);
+        pending_[path] = std::move(recording);
+    }
+
+    bool removeRecording(const std::string& path) {
+        std::lock_guard<std::mutex> writeLock(writeMutex_);
+        const bool pending = pending_.erase(path) > 0;
+        const auto state = snapshot();
+        const bool committed = state->byPath.count(path) > 0;
+        // 其他写入者可能已提交该录音而本实例尚未看到，commit 时按磁盘上的 manifest 删除
+        pendingRemovals_.insert(path);
+        return pending || committed;
+    }
+
+    bool commit(std::string& error, bool compactAll) {
+        std::lock_guard<std::mutex> writeLock(writeMutex_);
+        // 其他写入者可能在本实例打开之后提交过：持目录锁重新读取 manifest，在其基础上合并本实例的改动
+        DirectoryLock directoryLock;
+        if (!directoryLock.lock(directory_, error)) {
+            return false;
+        }
+        auto state = std::make_shared<State>();
+        if (!loadManifest(*state, snapshot().get(), error)) {
+            return false;
+        }
+
+        for (const auto& path : pendingRemovals_) {
+            eraseRecording(*state, path);
+        }
+        std::unordered_map<uint32_t, uint32_t> ids;
+        for (const auto& item : pending_) {
+            eraseRecording(*state, item.first);
+            Recording recording = item.second;
+            recording.id = nextRecordingId_++;
+            ids[item.second.id] = recording.id;
+            state->byPath[item.first] = recording.id;
+            state->recordings[recording.id] = std::move(recording);
+        }
+
+        std::vector<std::string> obsolete;
+        if (builder_ && !builder_->empty()) {
+            const std::string file = nextSegmentName();
+            if (!builder_->write((fs::path(directory_) / file).string(), ids, error)) {
+                return false;
+            }
+            auto segment = std::make_shared<Segment>();
+            if (!segment->open((fs::path(directory_) / file).string(), error)) {
+                return false;
+            }
+            state->segments.push_back(std::move(segment));
+        }
+
+        if (!mergeSegmentsIfNeeded(*state, compactAll, obsolete, error) || !writeManifest(*state, error)) {
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(stateMutex_);
+            state_ = state;
+        }
+        builder_.reset();
+        pending_.clear();
+        pendingRemovals_.clear();
+        nextPendingId_ = 1;
+
+        // manifest 已不再引用，正在查询的快照仍持有映射（POSIX 下删除不影响已映射的内容）
+        for (const auto& path : obsolete) {
+            std::error_code ec;
+            fs::remove(path, ec);
+        }
+        return true;
+    }
+
+    std::vector<TranscriptHit> search(const std::string& query, size_t limit) const {
+        std::vector<TranscriptHit> results;
+        Tokenizer tokenizer;
+        tokenizer.tokenize(query, true);
+        if (tokenizer.tokens().empty()) {
+            return results;
+        }
+
+        const auto state = snapshot();
+        // 过滤已删除 / 被替换的录音；每个段最多取 limit 个，合并后再取前 limit 个
+        const auto isLive = [&](uint32_t recordingId) { return state->recordings.count(recordingId) > 0; };
+        std::vector<UtteranceEntry> hits;
+        for (const auto& segment : state->segments) {
+            searchSegment(*segment, tokenizer, limit, isLive, hits);
+        }
+        auto less = [](const UtteranceEntry& a, const UtteranceEntry& b) {
+            return a.recordingId < b.recordingId || (a.recordingId == b.recordingId && a.startMs < b.startMs);
+        };
+        if (limit > 0 && hits.size() > limit) {
+            std::partial_sort(hits.begin(), hits.begin() + limit, hits.end(), less);
+            hits.resize(limit);
+        } else {
+            std::sort(hits.begin(), hits.end(), less);
+        }
+
+        results.reserve(hits.size());
+        for (const auto& hit : hits) {
+            TranscriptHit result;
+            result.recordingId = hit.recordingId;
+            result.recording = state->recordings.at(hit.recordingId).path;
+            result.startMs = hit.startMs;
+            result.endMs = hit.endMs;
+            results.push_back(std::move(result));
+        }
+        return results;
+    }
+
+    TranscriptIndexStats getStats() const {
+        const auto state = snapshot();
+        TranscriptIndexStats stats;
+        stats.recordings = state->recordings.size();
+        stats.segments = state->segments.size();
+        for (const auto& segment : state->segments) {
+            stats.utterances += segment->utteranceCount();
+            stats.terms += segment->termCount();
+            stats.postingsBytes += segment->postingsBytes();
+            stats.diskBytes += segment->fileBytes();
+        }
+        for (const auto& item : state->recordings) {
+            stats.indexedMs += item.second.durationMs;
+        }
+        return stats;
+    }
+
+    const std::string& directory() const { return directory_; }
+
+private:
+    std::shared_ptr<const State> snapshot() const {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        return state_;
+    }
+
+    /**
+     * @brief 读取磁盘上的 manifest（调用方持有目录锁）
+     * @param reuse 已打开的段按文件名复用，不重复映射；可为空
+     */
+    bool loadManifest(State& state, const State* reuse, std::string& error) {
+        const fs::path manifestPath = fs::path(directory_) / kManifestName;
+        if (!fs::exists(manifestPath)) {
+            nextRecordingId_ = 1;
+            return true;
+        }
+        std::unordered_map<std::string, SegmentPtr> opened;
+        if (reuse) {
+            for (const auto& segment : reuse->segments) {
+                opened[fs::path(segment->path()).filename().string()] = segment;
+            }
+        }
+        try {
+            std::ifstream in(manifestPath);
+            const json manifest = json::parse(in);
+            nextRecordingId_ = manifest.value("next_recording_id", 1u);
+            // 提交失败时本实例可能已写出更大编号的段文件，不回退
+            nextSegmentId_ = std::max(nextSegmentId_, manifest.value("next_segment_id", 1u));
+            for (const auto& item : manifest.at("recordings")) {
+                Recording recording;
+                recording.id = item.at("id").get<uint32_t>();
+                recording.path = item.at("path").get<std::string>();
+                recording.utterances = item.value("utterances", 0u);
+                recording.durationMs = item.value("duration_ms", int64_t(0));
+                state.byPath[recording.path] = recording.id;
+                state.recordings[recording.id] = std::move(recording);
+            }
+            for (const auto& item : manifest.at("segments")) {
+                const std::string file = item.get<std::string>();
+                const auto it = opened.find(file);
+                if (it != opened.end()) {
+                    state.segments.push_back(it->second);
+                    continue;
+                }
+                auto segment = std::make_shared<Segment>();
+                if (!segment->open((fs::path(directory_) / file).string(), error)) {
+                    return false;
+                }
+                state.segments.push_back(std::move(segment));
+            }
+        } catch (const std::exception& e) {
+            error = std::string("Invalid index manifest: ") + e.what();
+            return false;
+        }
+        return true;
+    }
+
+    static void eraseRecording(State& state, const std::string& path) {
+        const auto it = state.byPath.find(path);
+        if (it != state.byPath.end()) {
+            state.recordings.erase(it->second);
+            state.byPath.erase(it);
+        }
+    }
+
+    std::string nextSegmentName() {
+        char name[32];
+        std::snprintf(name, sizeof(name), "seg-%06u%s", nextSegmentId_++, kSegmentExtension);
+        return name;
+    }
+
+    /**
+     * @brief 分层合并：同一量级的段达到 mergeFactor 个时合并为一个（可能逐级向上）；
+     *        已删除录音的分句多于有效分句、或 compactAll 时合并全部段
+     */
+    bool mergeSegmentsIfNeeded(State& state, bool compactAll, std::vector<std::string>& obsolete, std::string& error) {
+        std::unordered_set<uint32_t> live;
+        uint64_t liveUtterances = 0;
+        for (const auto& item : state.recordings) {
+            live.insert(item.first);
+            liveUtterances += item.second.utterances;
+        }
+        uint64_t totalUtterances = 0;
+        for (const auto& segment : state.segments) {
+            totalUtterances += segment->utteranceCount();
+        }
+        const bool tooMuchGarbage =
+            totalUtterances > liveUtterances &&
+            static_cast<double>(totalUtterances - liveUtterances) > kGarbageCompactRatio * std::max<uint64_t>(liveUtterances, 1);
+
+        if ((compactAll || tooMuchGarbage) && !state.segments.empty()) {
+            return mergeGroup(state, state.segments, live, obsolete, error);
+        }
+
+        while (true) {
+            std::unordered_map<int, std::vector<SegmentPtr>> tiers;
+            std::vector<SegmentPtr>* group = nullptr;
+            for (const auto& segment : state.segments) {
+                auto& tier = tiers[segmentTier(segment->fileBytes())];
+                tier.push_back(segment);
+                if (tier.size() >= config_.mergeFactor) {
+                    group = &tier;
+                    break;
+                }
+            }
+            if (!group) {
+                return true;
+            }
+            if (!mergeGroup(state, *group, live, obsolete, error)) {
+                return false;
+            }
+        }
+    }
+
+    bool mergeGroup(State& state, std::vector<SegmentPtr> group, const std::unordered_set<uint32_t>& live,
+                    std::vector<std::string>& obsolete, std::string& error) {
+        const std::string file = nextSegmentName();
+        const std::string path = (fs::path(directory_) / file).string();
+        if (!mergeSegments(group, live, path, error)) {
+            return false;
+        }
+        auto merged = std::make_shared<Segment>();
+        if (!merged->open(path, error)) {
+            return false;
+        }
+        if (merged->utteranceCount() == 0) {
+            // 全部分句都属于已删除的录音
+            obsolete.push_back(path);
+            merged.reset();
+        }
+
+        std::vector<SegmentPtr> remaining;
+        for (const auto& segment : state.segments) {
+            if (std::find(group.begin(), group.end(), segment) == group.end()) {
+                remaining.push_back(segment);
+            } else {
+                obsolete.push_back(segment->path());
+            }
+        }
+        if (merged) {
+            remaining.push_back(std::move(merged));
+        }
+        state.segments.swap(remaining);
+        return true;
+    }
+
+    bool writeManifest(const State& state, std::string& error) {
+        json recordings = json::array();
+        std::vector<const Recording*> sorted;
+        for (const auto& item : state.recordings) {
+            sorted.push_back(&item.second);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const Recording* a, const Recording* b) { return a->id < b->id; });
+        for (const auto* recording : sorted) {
+            recordings.push_back({
+                {"id", recording->id},
+                {"path", recording->path},
+                {"utterances", recording->utterances},
+                {"duration_ms", recording->durationMs}
+            });
+        }
+        json segments = json::array();
+        for (const auto& segment : state.segments) {
+            segments.push_back(fs::path(segment->path()).filename().string());
+        }
+        const json manifest = {
+            {"version", kSegmentVersion},
+            {"next_recording_id", nextRecordingId_},
+            {"next_segment_id", nextSegmentId_},
+            {"recordings", recordings},
+            {"segments", segments}
+        };
+
+        Asr::FileSink sink;
+        if (!sink.open((fs::path(directory_) / kManifestName).string(), error)) {
+            return false;
+        }
+        const std::string text = manifest.dump(1, ' ', false, json::error_handler_t::replace);
+        if (!sink.write(text.data(), text.size())) {
+            sink.discard();
+            error = "Failed to write index manifest";
+            return false;
+        }
+        return sink.commit(error);
+    }
+
+    TranscriptIndexConfig config_;
+    std::string directory_;
+
+    mutable std::mutex stateMutex_;
+    std::shared_ptr<const State> state_;
+
+    std::mutex writeMutex_;
+    std::unique_ptr<SegmentBuilder> builder_;
+    std::unordered_map<std::string, Recording> pending_;
+    std::unordered_set<std::string> pendingRemovals_;
+    uint32_t nextPendingId_ = 1;       // 暂存录音的暂定录音号
+    uint32_t nextRecordingId_ = 1;
+    uint32_t nextSegmentId_ = 1;
+};
+
+// ============================================================================
+// TranscriptIndex
+// ============================================================================
+
+TranscriptIndex::TranscriptIndex(const TranscriptIndexConfig& config) : impl_(std::make_unique<Impl>(config)) {}
+
+TranscriptIndex::~TranscriptIndex() = default;
+
+std::string TranscriptIndex::defaultDirectory() {
+    return (fs::current_path() / "data" / "transcript_index").string();
+}
+
+bool TranscriptIndex::open(std::string& error) { return impl_->open(error); }
+
+void TranscriptIndex::addRecording(const std::string& recording, const std::vector<Asr::CachedUtterance>& utterances) {
+    impl_->addRecording(recording, utterances);
+}
+
+bool TranscriptIndex::removeRecording(const std::string& recording) { return impl_->removeRecording(recording); }
+
+bool TranscriptIndex::commit(std::string& error) { return impl_->commit(error, false); }
+
+bool TranscriptIndex::compact(std::string& error) { return impl_->commit(error, true); }
+
+std::vector<TranscriptHit> TranscriptIndex::search(const std::string& query, size_t limit) const {
+    return impl_->search(query, limit);
+}
+
+TranscriptIndexStats TranscriptIndex::getStats() const { return impl_->getStats(); }
+
+const std::string& TranscriptIndex::getDirectory() const { return impl_->directory(); }
+
+} // namespace logic
+} // namespace perfx
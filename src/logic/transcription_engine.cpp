@@ -0,0 +1,832 @@
+//
+// 无界面转录引擎实现
+//
+
+#include "logic/transcription_engine.h"
+#include "asr/asr_client.h"
+#include "asr/transcript_stitcher.h"
+#include "audio/audio_device.h"
+#include "audio/audio_processor.h"
+#include "audio/audio_thread.h"
+#include "audio/capture_graph.h"
+#include "audio/sample_pipeline.h"
+#include "audio/device_registry.h"
+#include "audio/latency_metrics.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace perfx {
+namespace logic {
+
+namespace {
+
+// 实时识别的采集格式：16kHz INT16（与图形界面一致），多声道时按声道组拆为单声道送入各自的 ASR 会话
+constexpr int kLiveSampleRate = 16000;
+// 发送缓冲预留的音频时长（不小于分包控制器的上限）
+constexpr int kLivePendingReserveMs = 1000;
+// 连接断开后两次重连尝试的最小间隔
+constexpr int kLiveReconnectIntervalMs = 2000;
+// 实时会话等待调度许可的上限：超时后按重连间隔再试，不让消费线程长时间阻塞
+constexpr int kLiveSchedulerWaitMs = 1000;
+
+/**
+ * @brief 把 AsrManager 的回调转发给引擎
+ */
+class EngineAsrSink : public Asr::AsrCallback {
+public:
+    using MessageHandler = std::function<void(Asr::AsrClient*, const std::string&)>;
+    using ErrorHandler = std::function<void(const std::string&)>;
+
+    EngineAsrSink(MessageHandler onMessage, ErrorHandler onError)
+        : onMessage_(std::move(onMessage)), onError_(std::move(onError)) {}
+
+    void onOpen(Asr::AsrClient*) override {}
+    void onClose(Asr::AsrClient*) override {}
+
+    void onMessage(Asr::AsrClient* client, const std::string& message) override {
+        if (onMessage_) onMessage_(client, message);
+    }
+
+    void onError(Asr::AsrClient*, const std::string& error) override {
+        if (onError_) onError_(error);
+    }
+
+private:
+    MessageHandler onMessage_;
+    ErrorHandler onError_;
+};
+
+} // namespace
+
+//==============================================================================
+// TranscriptionEngine::Impl
+//==============================================================================
+
+class TranscriptionEngine::Impl {
+public:
+    explicit Impl(const Asr::AsrConfig& config)
+        : config_(config),
+          fileSink_([this](Asr::AsrClient*, const std::string& message) { onFileMessage(message); },
+                    [this](const std::string& error) { reportError("ASR: " + error); }) {}
+
+    ~Impl() {
+        stopLive();
+    }
+
+    // ============================================================================
+    // 文件识别
+    // ============================================================================
+
+    bool transcribeFile(const std::string& filePath, std::vector<Asr::CachedUtterance>& utterances, int timeoutMs,
+                        Asr::RequestPriority priority) {
+        std::lock_guard<std::mutex> fileLock(fileMutex_);
+        if (!fileAsr_) {
+            fileAsr_ = std::make_unique<Asr::AsrManager>();
+            fileAsr_->setConfig(config_);
+            fileAsr_->setCallback(&fileSink_);
+        }
+        Asr::AsrConfig fileConfig = fileAsr_->getConfig();
+        if (fileConfig.requestPriority != priority) {
+            fileConfig.requestPriority = priority;
+            fileAsr_->setConfig(fileConfig);
+        }
+        {
+            std::lock_guard<std::mutex> lock(fileResultMutex_);
+            fileSource_ = filePath;
+            fileUtterances_.clear();
+        }
+
+        const bool ok = fileAsr_->recognizeAudioFile(filePath, true, timeoutMs);
+        {
+            std::lock_guard<std::mutex> lock(fileResultMutex_);
+            utterances = fileUtterances_;
+        }
+        if (!ok) {
+            reportError("File recognition failed: " + filePath);
+            return false;
+        }
+
+        TranscriptUpdate update;
+        update.source = filePath;
+        update.utterances = utterances;
+        update.final = true;
+        publish(update);
+        return true;
+    }
+
+    // ============================================================================
+    // 实时识别
+    // ============================================================================
+
+    bool startLive(const LiveOptions& options) {
+        std::lock_guard<std::mutex> controlLock(controlMutex_);
+        if (liveRunning_) {
+            return true;
+        }
+
+        audio::DeviceInfo device;
+        if (!selectInputDevice(options.deviceIndex, options.deviceName, device)) {
+            return false;
+        }
+
+        // 多源采集：采集图输出每源一条单声道轨道（或混为一条），按轨道拆分到各会话
+        std::vector<audio::CaptureSource> sources;
+        if (!options.extraSources.empty()) {
+            if (options.channels > 1 || !options.channelGroups.empty()) {
+                reportError("Extra capture sources cannot be combined with multi-channel capture");
+                return false;
+            }
+            sources.push_back({device, options.sourceLabel});
+            for (const auto& extra : options.extraSources) {
+                audio::CaptureSource source;
+                if (!selectInputDevice(extra.deviceIndex, extra.deviceName, source.device)) {
+                    return false;
+                }
+                source.label = extra.label.empty() ? source.device.name : extra.label;
+                sources.push_back(std::move(source));
+            }
+        }
+
+        // 声道数取显式设置与分组引用的最大声道号中较大者
+        int channels = std::max(1, options.channels);
+        for (const auto& group : options.channelGroups) {
+            for (int channel : group.channels) {
+                channels = std::max(channels, channel + 1);
+            }
+        }
+        if (!sources.empty()) {
+            channels = options.mixSources ? 1 : static_cast<int>(sources.size());
+        } else if (device.maxInputChannels > 0 && channels > device.maxInputChannels) {
+            reportError("Input device " + device.name + " has only " + std::to_string(device.maxInputChannels) +
+                        " channels, " + std::to_string(channels) + " requested");
+            return false;
+        }
+
+        audio::AudioConfig config;
+        config.sampleRate = audio::SampleRate::RATE_16000;
+        config.format = audio::SampleFormat::INT16;
+        config.channels = static_cast<audio::ChannelCount>(channels);
+        config.framesPerBuffer = 256;
+        config.enableHighPass = options.enableProcessing;
+        config.enableNoiseSuppression = options.enableProcessing;
+        config.enableAGC = options.enableProcessing;
+        config.inputDevice = device;
+
+        // 1. ASR 会话：每个声道组一个，先建立会话再启动采集，避免开头的音频无处可发。
+        //    上一次的会话已在 stopLive 中断开，此时没有回调会访问旧的 lanes_
+        std::vector<audio::ChannelGroup> groups = options.channelGroups;
+        if (groups.empty() && channels > 1) {
+            groups = audio::ChannelSplitter::perChannelGroups(channels);
+            if (!sources.empty()) {
+                for (size_t i = 0; i < groups.size(); ++i) {
+                    groups[i].label = sources[i].label;
+                }
+            }
+        }
+        lanes_.clear();
+        const size_t laneCount = std::max<size_t>(1, groups.size());
+        for (size_t i = 0; i < laneCount; ++i) {
+            lanes_.push_back(std::make_unique<LiveLane>(this, i < groups.size() ? groups[i].label : std::string()));
+        }
+        for (size_t i = 0; i < lanes_.size(); ++i) {
+            if (!lanes_[i]->asr->startRecognition()) {
+                reportError("Failed to start ASR recognition" +
+                            (lanes_[i]->label.empty() ? std::string() : " for " + lanes_[i]->label));
+                stopRecognitionAll();
+                return false;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(liveMutex_);
+            options_ = options;
+            deviceName_ = device.name;
+            captureChannels_ = channels;
+            capturedSamples_ = 0;
+            splitNs_ = 0;
+            for (auto& lane : lanes_) {
+                lane->stitcher.beginSession(lane->asr->getActiveClient(), 0);
+            }
+        }
+
+        // 2. 采集：设备回调只写入环形缓冲，处理链、VAD 与发送在消费者线程中完成
+        try {
+            if (sources.empty()) {
+                device_ = std::make_unique<audio::AudioDevice>();
+                device_->initialize();
+                if (!device_->openInputDevice(device, config)) {
+                    reportError("Failed to open input device: " + device_->getLastError());
+                    teardownCapture();
+                    stopRecognitionAll();
+                    return false;
+                }
+                // 设备不支持 INT16 时会改用 FLOAT32：处理链按实际格式实例化，拆分声道时再转换
+                config.format = device_->getCurrentConfig().format;
+            } else {
+                audio::CaptureGraphConfig graphConfig;
+                graphConfig.sampleRate = kLiveSampleRate;
+                graphConfig.framesPerBuffer = static_cast<size_t>(config.framesPerBuffer);
+                graphConfig.mix = options.mixSources;
+                graphConfig.driftCorrection = options.driftCorrection;
+                graph_ = std::make_unique<audio::CaptureGraph>();
+                if (!graph_->open(sources, graphConfig)) {
+                    reportError("Failed to open capture sources: " + graph_->getLastError());
+                    teardownCapture();
+                    stopRecognitionAll();
+                    return false;
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(liveMutex_);
+                splitter_.configure(audio::SampleConverter::create(config.format, channels), groups);
+                for (size_t i = 0; i < lanes_.size(); ++i) {
+                    lanes_[i]->channels = splitter_.group(i).channels;
+                }
+            }
+
+            processor_ = std::make_shared<audio::AudioProcessor>();
+            if (!processor_->initialize(config)) {
+                reportError("Failed to initialize audio processor");
+                teardownCapture();
+                stopRecognitionAll();
+                return false;
+            }
+
+            thread_ = std::make_unique<audio::AudioThread>();
+            thread_->initialize(processor_.get());
+            if (processor_->hasProcessingChain()) {
+                thread_->addProcessor(processor_);
+            }
+            thread_->setInputCallback([this](const void* input, void*, unsigned long frameCount) {
+                consumeLive(input, frameCount);
+            });
+            auto submit = [this](const void* input, void*, size_t frameCount) {
+                thread_->submit(input, static_cast<unsigned long>(frameCount));
+            };
+            auto onAudioError = [this](const std::string& error) { reportError("Audio: " + error); };
+            if (graph_) {
+                graph_->setCallback(submit);
+                graph_->setErrorCallback(onAudioError);
+            } else {
+                device_->setCallback(submit);
+                device_->setErrorCallback(onAudioError);
+                device_->setDeviceChangedCallback([this, config](const audio::DeviceInfo& changed,
+                                                                 const audio::AudioConfig& streamConfig) {
+                    {
+                        std::lock_guard<std::mutex> lock(liveMutex_);
+                        deviceName_ = changed.name;
+                    }
+                    std::cout << "[ENGINE] Input device failed over to: " << changed.name << std::endl;
+                    // 声道拆分与处理链按原格式建立，备用设备格式不同时流不会启动，需要重新开始实时识别
+                    if (!streamConfig.sameStreamLayout(config)) {
+                        reportError("Fallback device " + changed.name + " uses a different sample format; "
+                                    "restart live transcription");
+                    }
+                });
+            }
+
+            liveRunning_ = true;
+            thread_->startRecording();
+            if (graph_ ? !graph_->start() : !device_->startStream()) {
+                liveRunning_ = false;
+                reportError("Failed to start audio stream: " +
+                            (graph_ ? graph_->getLastError() : device_->getLastError()));
+                teardownCapture();
+                stopRecognitionAll();
+                return false;
+            }
+        } catch (const std::exception& e) {
+            liveRunning_ = false;
+            reportError(std::string("Failed to start capture: ") + e.what());
+            teardownCapture();
+            stopRecognitionAll();
+            return false;
+        }
+
+        std::cout << "[ENGINE] Live transcription started on device " << device.index
+                  << " (" << device.name << "), "
+                  << (sources.empty() ? std::to_string(channels) + " channel(s), "
+                                      : std::to_string(sources.size()) + " source(s), ")
+                  << lanes_.size() << " ASR session(s)" << std::endl;
+        return true;
+    }
+
+    void stopLive() {
+        std::lock_guard<std::mutex> controlLock(controlMutex_);
+        if (!liveRunning_) {
+            return;
+        }
+
+        // 1. 停止采集；消费者退出前处理完缓冲中的剩余数据
+        if (device_) {
+            device_->stopStream();
+        }
+        if (graph_) {
+            graph_->stop();
+        }
+        if (thread_) {
+            thread_->stop();
+        }
+
+        // 2. 各会话剩余不足一包的音频作为结束包发送
+        {
+            std::lock_guard<std::mutex> lock(liveMutex_);
+            liveRunning_ = false;
+            for (auto& lane : lanes_) {
+                if (lane->asr->isConnected()) {
+                    const size_t packetSamples = lane->asr->getPacketSizeController()->packetSamples(kLiveSampleRate);
+                    lane->pending.resize(std::max(packetSamples, lane->pending.size()), 0);
+                    sendLivePacketLocked(*lane, lane->pending.data(), lane->pending.size(), true);
+                }
+                lane->pending.clear();
+                lane->stitcher.endSession(lane->asr->getActiveClient(), lane->sentMs);
+            }
+        }
+
+        // 3. 等待最后的分句定稿（所有会话共用一个超时，连接断开的会话立即返回）
+        const auto deadline = std::chrono::steady_clock::now() +
+                              std::chrono::milliseconds(config_.liveSessionFinalizeTimeoutMs);
+        std::vector<Asr::AsrFuture<std::string>> finals;
+        for (auto& lane : lanes_) {
+            if (const Asr::AsrClient* client = lane->asr->getActiveClient()) {
+                finals.push_back(client->finalResponseAsync(config_.liveSessionFinalizeTimeoutMs));
+            }
+        }
+        for (const auto& response : finals) {
+            const auto remainingMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            response.wait(static_cast<int>(std::max<int64_t>(0, remainingMs)));
+        }
+        std::vector<const Asr::AsrClient*> clients;
+        for (auto& lane : lanes_) {
+            clients.push_back(lane->asr->getActiveClient());
+        }
+        stopRecognitionAll();
+        teardownCapture();
+
+        for (size_t i = 0; i < lanes_.size(); ++i) {
+            lanes_[i]->stitcher.closeSession(clients[i]);
+        }
+        publishLive(true);
+        std::cout << "[ENGINE] Live transcription stopped" << std::endl;
+    }
+
+    bool isLive() const {
+        return liveRunning_;
+    }
+
+    LiveStats getLiveStats() const {
+        std::lock_guard<std::mutex> lock(liveMutex_);
+        LiveStats stats;
+        stats.active = liveRunning_;
+        stats.deviceName = deviceName_;
+        stats.capturedMs = static_cast<int64_t>(capturedSamples_) * 1000 / kLiveSampleRate;
+        stats.captureChannels = captureChannels_;
+        stats.splitNs = splitNs_;
+        if (device_) {
+            stats.xruns = device_->getXrunCount();
+        }
+        if (graph_) {
+            stats.xruns = graph_->getXrunCount();
+            stats.sources = graph_->getStats();
+        }
+        for (const auto& lane : lanes_) {
+            LiveChannelStats channel;
+            channel.label = lane->label;
+            channel.channels = lane->channels;
+            channel.sentMs = lane->sentMs;
+            channel.packetsSent = lane->packetsSent;
+            channel.sendFailures = lane->sendFailures;
+            channel.reconnects = lane->reconnects;
+            channel.processNs = lane->processNs;
+            channel.vad = lane->vad->getStats();
+            channel.packetSize = lane->asr->getPacketSizeStats();
+            channel.memory = lane->asr->getMemoryStats();
+
+            stats.sentMs += channel.sentMs;
+            stats.packetsSent += channel.packetsSent;
+            stats.sendFailures += channel.sendFailures;
+            stats.reconnects += channel.reconnects;
+            stats.vad.inputSamples += channel.vad.inputSamples;
+            stats.vad.outputSamples += channel.vad.outputSamples;
+            stats.vad.speechFrames += channel.vad.speechFrames;
+            stats.vad.silenceFrames += channel.vad.silenceFrames;
+            if (stats.channels.empty()) {
+                stats.vad.noiseFloorDb = channel.vad.noiseFloorDb;
+            }
+            stats.channels.push_back(std::move(channel));
+        }
+        return stats;
+    }
+
+    /**
+     * @brief 合并各会话的结果：每个会话先映射回采集时间线并打上标签，再按起始时间排序
+     */
+    std::vector<Asr::CachedUtterance> getLiveTranscript() const {
+        std::vector<Asr::CachedUtterance> utterances;
+        for (const auto& lane : lanes_) {
+            std::vector<Asr::CachedUtterance> laneUtterances = mapToCaptureTime(*lane);
+            for (auto& utterance : laneUtterances) {
+                utterance.speaker = lane->label;
+                utterances.push_back(std::move(utterance));
+            }
+        }
+        if (lanes_.size() > 1) {
+            std::stable_sort(utterances.begin(), utterances.end(),
+                             [](const Asr::CachedUtterance& a, const Asr::CachedUtterance& b) {
+                                 return a.startMs < b.startMs;
+                             });
+        }
+        return utterances;
+    }
+
+    // ============================================================================
+    // 回调与错误
+    // ============================================================================
+
+    void setUpdateCallback(UpdateCallback callback) {
+        std::lock_guard<std::mutex> lock(callbackMutex_);
+        updateCallback_ = std::move(callback);
+    }
+
+    void setErrorCallback(ErrorCallback callback) {
+        std::lock_guard<std::mutex> lock(callbackMutex_);
+        errorCallback_ = std::move(callback);
+    }
+
+    std::string getLastError() const {
+        std::lock_guard<std::mutex> lock(callbackMutex_);
+        return lastError_;
+    }
+
+    Asr::AsrConfig config_;
+
+private:
+    bool selectInputDevice(int deviceIndex, const std::string& deviceName, audio::DeviceInfo& device) {
+        const std::vector<audio::DeviceInfo> devices = listInputDevices(10000);
+        if (devices.empty()) {
+            reportError("No input devices available");
+            return false;
+        }
+        if (!deviceName.empty()) {
+            for (const auto& d : devices) {
+                if (d.name == deviceName) {
+                    device = d;
+                    return true;
+                }
+            }
+            for (const auto& d : devices) {
+                if (d.name.find(deviceName) != std::string::npos) {
+                    device = d;
+                    return true;
+                }
+            }
+            reportError("Input device not found: " + deviceName);
+            return false;
+        }
+        if (deviceIndex >= 0) {
+            for (const auto& d : devices) {
+                if (d.index == deviceIndex) {
+                    device = d;
+                    return true;
+                }
+            }
+            reportError("Input device not found: " + std::to_string(deviceIndex));
+            return false;
+        }
+        auto it = std::find_if(devices.begin(), devices.end(),
+                               [](const audio::DeviceInfo& d) { return d.isDefaultInput; });
+        device = it != devices.end() ? *it : devices.front();
+        return true;
+    }
+
+    /**
+     * @brief 一个声道组的识别状态：独立的 ASR 会话、VAD、分包缓冲与结果拼接
+     *
+     * 成员按析构顺序排列：asr 最后声明、最先析构，其回调线程退出后才销毁 sink 与 stitcher
+     */
+    struct LiveLane {
+        LiveLane(Impl* owner, std::string laneLabel)
+            : label(std::move(laneLabel)),
+              sink([this, owner](Asr::AsrClient* client, const std::string& message) {
+                       owner->onLiveMessage(*this, client, message);
+                   },
+                   [this, owner](const std::string& error) {
+                       owner->reportError(label.empty() ? "ASR: " + error : "ASR [" + label + "]: " + error);
+                   }) {
+            audio::VadConfig vadConfig;
+            vadConfig.sampleRate = kLiveSampleRate;
+            vad = std::make_unique<audio::VoiceActivityDetector>(vadConfig);
+            pending.reserve(static_cast<size_t>(kLiveSampleRate) * kLivePendingReserveMs / 1000);
+            asr = std::make_unique<Asr::AsrManager>();
+            Asr::AsrConfig liveConfig = owner->config_;
+            liveConfig.requestPriority = Asr::RequestPriority::LIVE;
+            liveConfig.schedulerWaitMs = kLiveSchedulerWaitMs;
+            asr->setConfig(liveConfig);
+            asr->setCallback(&sink);
+        }
+
+        const std::string label;                    // 为空表示单会话（不标注说话人）
+        std::vector<int> channels;
+        EngineAsrSink sink;
+        std::unique_ptr<audio::VoiceActivityDetector> vad;  // 映射表自带锁，时间映射无需 liveMutex_
+        std::vector<int16_t> vadOutput;
+        std::vector<int16_t> pending;               // 未凑满一包的样本
+        std::vector<uint8_t> packet;                // 发包缓冲（复用容量，发包不再分配）
+        int64_t sentMs = 0;
+        uint64_t packetsSent = 0;
+        uint64_t sendFailures = 0;
+        uint64_t reconnects = 0;
+        int64_t processNs = 0;
+        std::chrono::steady_clock::time_point lastReconnectAttempt;
+        Asr::TranscriptStitcher stitcher;
+        // 已定稿分句映射到采集时间线后的结果（按拼接结果中的位置），沿用后 VAD 映射表可以裁剪
+        struct MappedUtterance {
+            int64_t rawStartMs = 0;
+            int64_t rawEndMs = 0;
+            Asr::CachedUtterance mapped;
+        };
+        std::mutex mappedMutex;
+        std::vector<MappedUtterance> mapped;
+        std::unique_ptr<Asr::AsrManager> asr;
+    };
+
+    void stopRecognitionAll() {
+        for (auto& lane : lanes_) {
+            lane->asr->stopRecognition();
+            lane->asr->disconnect();
+        }
+    }
+
+    void teardownCapture() {
+        if (thread_) {
+            thread_->stop();
+        }
+        if (device_) {
+            device_->stopStream();
+            device_->closeDevice();
+        }
+        if (graph_) {
+            graph_->close();
+        }
+        thread_.reset();
+        device_.reset();
+        graph_.reset();
+        processor_.reset();
+    }
+
+    /**
+     * @brief 消费者线程：按声道组拆分 → 各组 VAD → 按分包控制器的包时长发送
+     *
+     * 静音的麦克风经 VAD 后没有输出，对应会话不发送任何数据
+     */
+    void consumeLive(const void* input, unsigned long frameCount) {
+        if (!input || frameCount == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(liveMutex_);
+        if (!liveRunning_) {
+            return;
+        }
+        capturedSamples_ += frameCount;
+
+        int64_t begin = audio::metrics::nowNs();
+        splitter_.split(input, frameCount);
+        int64_t end = audio::metrics::nowNs();
+        splitNs_ += end - begin;
+
+        for (size_t g = 0; g < lanes_.size(); ++g) {
+            LiveLane& lane = *lanes_[g];
+            begin = end;
+            const int16_t* samples = splitter_.output(g);
+            size_t count = frameCount;
+            if (options_.enableVad) {
+                lane.vadOutput.clear();
+                lane.vad->process(samples, count, lane.vadOutput);
+                samples = lane.vadOutput.data();
+                count = lane.vadOutput.size();
+            }
+            lane.pending.insert(lane.pending.end(), samples, samples + count);
+
+            // 包时长由该会话的分包控制器按链路状况调整
+            const size_t packetSamples = lane.asr->getPacketSizeController()->packetSamples(kLiveSampleRate);
+            size_t offset = 0;
+            while (lane.pending.size() - offset >= packetSamples) {
+                sendLivePacketLocked(lane, lane.pending.data() + offset, packetSamples, false);
+                offset += packetSamples;
+            }
+            lane.pending.erase(lane.pending.begin(), lane.pending.begin() + static_cast<std::ptrdiff_t>(offset));
+            end = audio::metrics::nowNs();
+            lane.processNs += end - begin;
+        }
+    }
+
+    void sendLivePacketLocked(LiveLane& lane, const int16_t* samples, size_t count, bool isLast) {
+        if (!lane.asr->isConnected()) {
+            reconnectLiveLocked(lane);
+        }
+        const auto* bytes = reinterpret_cast<const uint8_t*>(samples);
+        lane.packet.assign(bytes, bytes + count * sizeof(int16_t));
+        if (lane.asr->sendAudio(lane.packet, isLast)) {
+            ++lane.packetsSent;
+        } else {
+            ++lane.sendFailures;
+        }
+        // 发送时间线与 VAD 输出时间线保持一致（发送失败的包同样计入）
+        lane.sentMs += static_cast<int64_t>(count) * 1000 / kLiveSampleRate;
+    }
+
+    /**
+     * @brief 连接断开后重建会话；新会话的结果从当前发送位置开始拼接
+     */
+    void reconnectLiveLocked(LiveLane& lane) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lane.lastReconnectAttempt < std::chrono::milliseconds(kLiveReconnectIntervalMs)) {
+            return;
+        }
+        lane.lastReconnectAttempt = now;
+
+        const std::string name = lane.label.empty() ? std::string("ASR") : "ASR [" + lane.label + "]";
+        const Asr::AsrClient* previous = lane.asr->getActiveClient();
+        if (!lane.asr->startRecognition()) {
+            std::cout << "[ENGINE] " << name << " reconnection failed, retrying in "
+                      << kLiveReconnectIntervalMs / 1000 << "s" << std::endl;
+            return;
+        }
+        ++lane.reconnects;
+        lane.stitcher.closeSession(previous);
+        lane.stitcher.beginSession(lane.asr->getActiveClient(), lane.sentMs);
+        std::cout << "[ENGINE] " << name << " reconnected at " << lane.sentMs << "ms" << std::endl;
+    }
+
+    void onLiveMessage(LiveLane& lane, Asr::AsrClient* client, const std::string& message) {
+        if (lane.stitcher.update(client, message)) {
+            publishLive(false);
+        }
+    }
+
+    void onFileMessage(const std::string& message) {
+        TranscriptUpdate update;
+        {
+            std::lock_guard<std::mutex> lock(fileResultMutex_);
+            std::vector<Asr::CachedUtterance> utterances;
+            if (!Asr::TranscriptionCache::parseServerMessage(message, 0, utterances)) {
+                return;
+            }
+            fileUtterances_ = utterances;
+            update.source = fileSource_;
+            update.utterances = std::move(utterances);
+        }
+        publish(update);
+    }
+
+    void publishLive(bool final) {
+        TranscriptUpdate update;
+        update.source = "live";
+        update.utterances = getLiveTranscript();
+        update.final = final;
+        publish(update);
+    }
+
+    /**
+     * @brief 取会话的拼接结果：客户端 VAD 丢弃了静音段，发送时间线需映射回采集时间线
+     *
+     * 已定稿的分句沿用缓存的映射结果，之后裁剪掉不再需要的 VAD 映射段。
+     * 拼接快照、缓存更新与裁剪在同一把锁内完成，避免旧快照用已裁剪的映射表
+     */
+    std::vector<Asr::CachedUtterance> mapToCaptureTime(LiveLane& lane) const {
+        if (!options_.enableVad) {
+            return lane.stitcher.merged();
+        }
+        std::lock_guard<std::mutex> lock(lane.mappedMutex);
+        int64_t settledMs = 0;
+        std::vector<Asr::CachedUtterance> utterances = lane.stitcher.merged(settledMs);
+        const audio::VoiceActivityDetector& vad = *lane.vad;
+        lane.mapped.resize(utterances.size());
+        for (size_t i = 0; i < utterances.size(); ++i) {
+            auto& utterance = utterances[i];
+            LiveLane::MappedUtterance& slot = lane.mapped[i];
+            if (slot.mapped.definite && utterance.definite && slot.rawStartMs == utterance.startMs &&
+                slot.rawEndMs == utterance.endMs && slot.mapped.text == utterance.text) {
+                utterance = slot.mapped;
+                continue;
+            }
+            const int64_t rawStartMs = utterance.startMs;
+            const int64_t rawEndMs = utterance.endMs;
+            utterance.startMs = vad.mapOutputToInputMs(utterance.startMs);
+            utterance.endMs = vad.mapOutputToInputMs(utterance.endMs);
+            for (auto& word : utterance.words) {
+                word.startMs = vad.mapOutputToInputMs(word.startMs);
+                word.endMs = vad.mapOutputToInputMs(word.endMs);
+            }
+            slot.mapped.definite = false;
+            if (utterance.definite) {
+                slot.rawStartMs = rawStartMs;
+                slot.rawEndMs = rawEndMs;
+                slot.mapped = utterance;
+            }
+        }
+        lane.vad->discardMappingBefore(settledMs);
+        return utterances;
+    }
+
+    void publish(const TranscriptUpdate& update) {
+        UpdateCallback callback;
+        {
+            std::lock_guard<std::mutex> lock(callbackMutex_);
+            callback = updateCallback_;
+        }
+        if (callback) {
+            callback(update);
+        }
+    }
+
+    void reportError(const std::string& error) {
+        ErrorCallback callback;
+        {
+            std::lock_guard<std::mutex> lock(callbackMutex_);
+            lastError_ = error;
+            callback = errorCallback_;
+        }
+        std::cerr << "[ENGINE][ERROR] " << error << std::endl;
+        if (callback) {
+            callback(error);
+        }
+    }
+
+    // 文件识别
+    std::mutex fileMutex_;                          // 串行化文件识别
+    std::unique_ptr<Asr::AsrManager> fileAsr_;
+    EngineAsrSink fileSink_;
+    std::mutex fileResultMutex_;
+    std::string fileSource_;
+    std::vector<Asr::CachedUtterance> fileUtterances_;
+
+    // 实时识别
+    std::mutex controlMutex_;                       // 串行化 startLive / stopLive
+    std::unique_ptr<audio::AudioDevice> device_;
+    std::unique_ptr<audio::CaptureGraph> graph_;    // 多源采集时代替 device_
+    std::shared_ptr<audio::AudioProcessor> processor_;
+    std::unique_ptr<audio::AudioThread> thread_;
+    std::atomic<bool> liveRunning_{false};
+    std::vector<std::unique_ptr<LiveLane>> lanes_;  // 只在 startLive 中（无会话运行时）重建
+
+    mutable std::mutex liveMutex_;                  // 消费者线程与统计接口共享的状态
+    LiveOptions options_;
+    std::string deviceName_;
+    int captureChannels_ = 1;
+    audio::ChannelSplitter splitter_;               // 实际输入流格式 → 各声道组的单声道 INT16
+    uint64_t capturedSamples_ = 0;
+    int64_t splitNs_ = 0;
+
+    // 回调
+    mutable std::mutex callbackMutex_;
+    UpdateCallback updateCallback_;
+    ErrorCallback errorCallback_;
+    std::string lastError_;
+};
+
+//==============================================================================
+// TranscriptionEngine 公共接口
+//==============================================================================
+
+TranscriptionEngine::TranscriptionEngine(const Asr::AsrConfig& config)
+    : impl_(std::make_unique<Impl>(config)) {}
+
+TranscriptionEngine::~TranscriptionEngine() = default;
+
+Asr::AsrConfig TranscriptionEngine::defaultAsrConfig() {
+    Asr::AsrConfig config;
+    Asr::AsrManager::loadConfigFromEnv(config);
+    return config;
+}
+
+std::vector<audio::DeviceInfo> TranscriptionEngine::listInputDevices(int timeoutMs) {
+    audio::DeviceRegistry& registry = audio::DeviceRegistry::getInstance();
+    registry.start();
+    registry.waitUntilReady(timeoutMs);
+    return registry.getInputDevices();
+}
+
+void TranscriptionEngine::setUpdateCallback(UpdateCallback callback) { impl_->setUpdateCallback(std::move(callback)); }
+void TranscriptionEngine::setErrorCallback(ErrorCallback callback) { impl_->setErrorCallback(std::move(callback)); }
+const Asr::AsrConfig& TranscriptionEngine::getConfig() const { return impl_->config_; }
+
+bool TranscriptionEngine::transcribeFile(const std::string& filePath, std::vector<Asr::CachedUtterance>& utterances,
+                                         int timeoutMs, Asr::RequestPriority priority) {
+    return impl_->transcribeFile(filePath, utterances, timeoutMs, priority);
+}
+
+bool TranscriptionEngine::startLive(const LiveOptions& options) { return impl_->startLive(options); }
+void TranscriptionEngine::stopLive() { impl_->stopLive(); }
+bool TranscriptionEngine::isLive() const { return impl_->isLive(); }
+LiveStats TranscriptionEngine::getLiveStats() const { return impl_->getLiveStats(); }
+std::vector<Asr::CachedUtterance> TranscriptionEngine::getLiveTranscript() const { return impl_->getLiveTranscript(); }
+std::string TranscriptionEngine::getLastError() const { return impl_->getLastError(); }
+
+} // namespace logic
+} // namespace perfx
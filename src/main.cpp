@@ -12,13 +12,22 @@
 #include <iostream>
 #include <cstdlib>
 #include "../include/ui/input_method_manager.h"
+#include "../include/ui/startup_pipeline.h"
+#include "../include/audio/trace_events.h"
 
 int main(int argc, char *argv[]) {
+    // 启动追踪从这里开始计时
+    perfx::ui::StartupTrace::instance().begin();
+    // PERFX_TRACE=<file.json> 时记录跨线程事件追踪，退出时写出
+    const std::string tracePath = perfx::audio::trace::startFromEnv();
+    perfx::audio::trace::setThreadName("ui.main");
+    
     // 设置环境变量
     qputenv("IMKCFRunLoopWakeUpReliable", "0");
     qputenv("QT_MAC_DISABLE_IMK", "0");
     
     QApplication app(argc, argv);
+    perfx::ui::StartupTrace::instance().mark("qapplication_ready");
     
     // 全局样式表：统一弹窗、按钮、标签风格
     app.setStyleSheet(
@@ -42,7 +51,16 @@ int main(int argc, char *argv[]) {
     try {
         perfx::ui::MainWindow w;
         w.show();
-        return app.exec();
+        perfx::ui::StartupTrace::instance().mark("main_window_shown");
+        const int status = app.exec();
+        if (!tracePath.empty()) {
+            perfx::audio::trace::stop();
+            std::string error;
+            if (!perfx::audio::trace::writeChromeTrace(tracePath, error)) {
+                fprintf(stderr, "[TRACE] %s\n", error.c_str());
+            }
+        }
+        return status;
     } catch (const std::exception& e) {
         fprintf(stderr, "[FATAL] main exception: %s\n", e.what());
         return 1;
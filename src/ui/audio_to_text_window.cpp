@@ -3,6 +3,7 @@
 #include "audio/file_importer.h"
 #include "audio/audio_converter.h"
 #include "audio/audio_manager.h"
+#include "logic/transcript_index.h"
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QDir>
@@ -74,9 +75,28 @@ void EnhancedAsrCallback::onMessage(Asr::AsrClient* client, const std::string& m
         
         if (resultObj.contains("utterances") && resultObj["utterances"].isArray()) {
             QStringList all_utterances;
+            std::vector<Asr::CachedUtterance> utterances;
             for (const auto& utteranceVal : resultObj["utterances"].toArray()) {
-                QString text = utteranceVal.toObject()["text"].toString();
+                const QJsonObject utteranceObj = utteranceVal.toObject();
+                QString text = utteranceObj["text"].toString();
                 if (!text.isEmpty()) all_utterances.append(text);
+
+                Asr::CachedUtterance utterance;
+                utterance.text = text.toStdString();
+                utterance.startMs = utteranceObj["start_time"].toInteger();
+                utterance.endMs = utteranceObj["end_time"].toInteger();
+                utterance.definite = utteranceObj["definite"].toBool();
+                for (const auto& wordVal : utteranceObj["words"].toArray()) {
+                    const QJsonObject wordObj = wordVal.toObject();
+                    utterance.words.push_back({wordObj["text"].toString().toStdString(),
+                                               wordObj["start_time"].toInteger(),
+                                               wordObj["end_time"].toInteger()});
+                }
+                utterances.push_back(std::move(utterance));
+            }
+            {
+                std::lock_guard<std::mutex> lock(utterancesMutex_);
+                utterances_ = std::move(utterances);
             }
             currentText_ = all_utterances.join('\n');
             m_intermediateLine.clear();
@@ -141,6 +161,13 @@ void EnhancedAsrCallback::onError(Asr::AsrClient* client, const std::string& err
     }
 }
 
+std::vector<Asr::CachedUtterance> EnhancedAsrCallback::takeUtterances() {
+    std::lock_guard<std::mutex> lock(utterancesMutex_);
+    std::vector<Asr::CachedUtterance> utterances;
+    utterances.swap(utterances_);
+    return utterances;
+}
+
 void EnhancedAsrCallback::clearText() {
     if (!textEdit_) return;
     currentText_.clear();
@@ -658,14 +685,40 @@ void AudioToTextWindow::viewLyrics()
 
 void AudioToTextWindow::exportLrcFile()
 {
-    // TODO: 实现LRC文件导出逻辑
-    QMessageBox::information(this, "提示", "LRC文件导出功能待实现");
+    exportTranscriptFile(Asr::ExportFormat::Lrc, "LRC歌词 (*.lrc)");
 }
 
 void AudioToTextWindow::exportJsonFile()
 {
-    // TODO: 实现JSON文件导出逻辑
-    QMessageBox::information(this, "提示", "JSON文件导出功能待实现");
+    exportTranscriptFile(Asr::ExportFormat::Json, "JSON (*.json)");
+}
+
+void AudioToTextWindow::exportTranscriptFile(Asr::ExportFormat format, const QString& filter)
+{
+    if (lastUtterances_.empty()) {
+        QMessageBox::information(this, "提示", "没有可导出的转录结果，请先完成转录。");
+        return;
+    }
+
+    const QString filePath = QFileDialog::getSaveFileName(this, "导出转录结果", QDir::homePath(), filter);
+    if (filePath.isEmpty()) {
+        return;
+    }
+
+    Asr::ExportOptions options = lastExportOptions_;
+    std::string error;
+    if (!Asr::exportTranscript(lastUtterances_, format, filePath.toStdString(), options, error)) {
+        QMessageBox::critical(this, "错误", QString::fromStdString(error));
+        return;
+    }
+    updateStatusBar("已导出: " + filePath);
+}
+
+Asr::ExportOptions AudioToTextWindow::currentExportOptions() const
+{
+    // 词级时间跟随产生本次结果的客户端请求配置
+    const Asr::AsrClient* client = asrManager_ ? asrManager_->getActiveClient() : nullptr;
+    return Asr::exportOptionsFromConfig(client ? client->getApiConfig() : Asr::AsrApiConfig());
 }
 
 void AudioToTextWindow::clearLyrics()
@@ -685,7 +738,34 @@ void AudioToTextWindow::onAsrFinished()
     
     std::string lrcFilePath = (std::filesystem::path(workDir) / (workFilePath.stem().string() + "_lyrics.lrc")).string();
     std::string jsonFilePath = (std::filesystem::path(workDir) / (workFilePath.stem().string() + "_lyrics.json")).string();
-        
+
+    if (asrCallback_) {
+        lastUtterances_ = asrCallback_->takeUtterances();
+    }
+    lastExportOptions_ = currentExportOptions();
+    if (!lastUtterances_.empty()) {
+        Asr::ExportOptions options = lastExportOptions_;
+        options.title = workFilePath.stem().string();
+        std::string error;
+        if (!Asr::exportTranscript(lastUtterances_, Asr::ExportFormat::Lrc, lrcFilePath, options, error) ||
+            !Asr::exportTranscript(lastUtterances_, Asr::ExportFormat::Json, jsonFilePath, options, error)) {
+            std::cerr << "[UI][ERROR] 保存转录结果失败: " << error << std::endl;
+        } else {
+            std::cout << "[UI] 转录结果已保存: " << lrcFilePath << ", " << jsonFilePath << std::endl;
+        }
+
+        // 加入全文索引
+        logic::TranscriptIndex index;
+        if (index.open(error)) {
+            index.addRecording(std::filesystem::absolute(workFilePath).string(), lastUtterances_);
+            if (!index.commit(error)) {
+                std::cerr << "[UI][ERROR] 更新转录索引失败: " << error << std::endl;
+            }
+        } else {
+            std::cerr << "[UI][ERROR] 打开转录索引失败: " << error << std::endl;
+        }
+    }
+
     // Process the next file
     ++currentWorkFile_;
     startNextAsrTask();
@@ -706,6 +786,11 @@ void AudioToTextWindow::startNextAsrTask()
     // 确保回调被正确设置
     if (asrCallback_) {
         std::cout << "[UI] ASR回调已设置，开始识别" << std::endl;
+        // 用户等待结果的文件识别；管理器与实时字幕共用，需恢复为交互式优先级
+        Asr::AsrConfig fileConfig = asrManager_->getConfig();
+        fileConfig.requestPriority = Asr::RequestPriority::INTERACTIVE;
+        fileConfig.schedulerWaitMs = Asr::AsrConfig().schedulerWaitMs;
+        asrManager_->setConfig(fileConfig);
         asrManager_->recognizeAudioFileAsync(workFile);
     } else {
         std::cerr << "[UI][ERROR] ASR回调未设置" << std::endl;
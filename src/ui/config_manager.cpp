@@ -147,7 +147,11 @@ AsrConfig ConfigManager::loadConfig() {
     // ============================================================================
     
     auto [config, source] = ConfigLoader::loadConfigWithPriority(configFilePath_);
-    
+    applyLoadedConfig(config, source);
+    return config;
+}
+
+void ConfigManager::applyLoadedConfig(const AsrConfig& config, ConfigSource source) {
     // 更新当前配置状态
     currentConfig_ = config;
     currentConfigSource_ = source;
@@ -158,8 +162,6 @@ AsrConfig ConfigManager::loadConfig() {
     qDebug() << "   - 来源:" << QString::fromStdString(config.configSource);
     qDebug() << "   - App ID:" << QString::fromStdString(config.appId);
     qDebug() << "   - 有效:" << (config.isValid ? "是" : "否");
-    
-    return config;
 }
 
 bool ConfigManager::saveConfig(const AsrConfig& config) {
@@ -7,6 +7,7 @@
 #include "ui/app_icon_button.h"
 #include "ui/config_manager.h"
 #include "ui/global_state.h"
+#include "ui/startup_pipeline.h"
 #include "asr/secure_key_manager.h"
 #include <QVBoxLayout>
 #include <QPushButton>
@@ -41,6 +42,7 @@ MainWindow::MainWindow(QWidget* parent)
     , configManager_(nullptr)
     , asrConfigLoaded_(false)
     , asrConfigValid_(false)
+    , startupPipeline_(nullptr)
 {
     // Make the window frameless and transparent
     setWindowFlags(Qt::FramelessWindowHint);
@@ -95,29 +97,87 @@ void MainWindow::setupUi() {
     createMainMenuPage();
     stackedWidget_->addWidget(mainMenuWidget_);
     
-    // Create system configuration window (this needs to be pre-created because configuration might affect other features)
-    systemConfigWindow_ = new SystemConfigWindow(this);
-    stackedWidget_->addWidget(systemConfigWindow_);
-    
-    // Create audio to text window
-    audioToTextWindow_ = new AudioToTextWindow(this);
-    stackedWidget_->addWidget(audioToTextWindow_);
-    
-    // Connect system configuration window signals
-    connect(systemConfigWindow_, &SystemConfigWindow::backToMainMenuRequested,
-            this, &MainWindow::switchToMainMenu);
-    connect(systemConfigWindow_, &SystemConfigWindow::configUpdated,
-            this, &MainWindow::onConfigUpdated);
-    
-    // Connect audio to text window signals
-    connect(audioToTextWindow_, &AudioToTextWindow::backToMainMenuRequested,
-            this, &MainWindow::switchToMainMenu);
+    // 二级页面（系统配置、文件转文字、实时录音）改为首次导航时创建，见 ensureXxxWindow()
 
     // Start with main menu
     stackedWidget_->setCurrentWidget(mainMenuWidget_);
+    StartupTrace::instance().mark("main_menu_built");
+
+    // 主菜单先绘制，事件循环空闲后再启动后台初始化
+    QTimer::singleShot(0, this, &MainWindow::startDeferredInit);
+}
+
+void MainWindow::startDeferredInit() {
+    if (startupPipeline_) {
+        return;
+    }
+    StartupTrace::instance().mark("first_event_loop");
+
+    startupPipeline_ = new StartupPipeline(this);
+    connect(startupPipeline_, &StartupPipeline::configReady,
+            this, &MainWindow::onAsrConfigReady);
+    connect(startupPipeline_, &StartupPipeline::devicesReady, this,
+            [](const QStringList& names, const QList<int>&) {
+                qDebug() << "[STARTUP] 🎤 可用输入设备:" << names.size() << "个";
+            });
+    connect(startupPipeline_, &StartupPipeline::finished,
+            this, &MainWindow::onStartupFinished);
+    startupPipeline_->start();
+}
+
+void MainWindow::onStartupFinished() {
+    qDebug() << "[STARTUP] ✅ 后台初始化全部完成";
+}
+
+AudioToTextWindow* MainWindow::ensureAudioToTextWindow() {
+    if (!audioToTextWindow_) {
+        ScopedStartupPhase phase("create_audio_to_text_window");
+        audioToTextWindow_ = new AudioToTextWindow(this);
+        stackedWidget_->addWidget(audioToTextWindow_);
+        connect(audioToTextWindow_, &AudioToTextWindow::backToMainMenuRequested,
+                this, &MainWindow::switchToMainMenu);
+    }
+    return audioToTextWindow_;
+}
+
+RealtimeAudioToTextWindow* MainWindow::ensureRealtimeAudioToTextWindow() {
+    if (!realtimeAudioToTextWindow_) {
+        ScopedStartupPhase phase("create_realtime_window");
+        realtimeAudioToTextWindow_ = new RealtimeAudioToTextWindow(this);
+        stackedWidget_->addWidget(realtimeAudioToTextWindow_);
+        connect(realtimeAudioToTextWindow_, &RealtimeAudioToTextWindow::backToMainMenuRequested, 
+                this, &MainWindow::switchToMainMenu);
+    }
+    return realtimeAudioToTextWindow_;
+}
 
-    // 主菜单显示后，2秒后再初始化ASR配置
-    QTimer::singleShot(2000, this, &MainWindow::loadAsrConfig);
+SystemConfigWindow* MainWindow::ensureSystemConfigWindow() {
+    if (!systemConfigWindow_) {
+        ScopedStartupPhase phase("create_system_config_window");
+        systemConfigWindow_ = new SystemConfigWindow(this);
+        stackedWidget_->addWidget(systemConfigWindow_);
+        connect(systemConfigWindow_, &SystemConfigWindow::backToMainMenuRequested,
+                this, &MainWindow::switchToMainMenu);
+        connect(systemConfigWindow_, &SystemConfigWindow::configUpdated,
+                this, &MainWindow::onConfigUpdated);
+    }
+    return systemConfigWindow_;
+}
+
+bool MainWindow::checkAsrReady() {
+    // 配置仍在后台加载中
+    if (!asrConfigLoaded_) {
+        QMessageBox::information(this, "正在初始化", 
+            "ASR配置正在加载，请稍候再试。");
+        return false;
+    }
+    // 检查ASR凭证有效性
+    if (perfx::ui::asr_valid == 0) {
+        QMessageBox::warning(this, "ASR未就绪", 
+            "ASR配置未验证或验证失败，请先配置ASR。");
+        return false;
+    }
+    return true;
 }
 
 void MainWindow::setupTitleBar(QVBoxLayout* mainLayout) {
@@ -201,97 +261,41 @@ void MainWindow::setupTitleBar(QVBoxLayout* mainLayout) {
     connect(minimizeButton, &QPushButton::clicked, this, &MainWindow::showMinimized);
 }
 
-void MainWindow::loadAsrConfig() {
-    try {
-        qDebug() << "==========================================";
-        qDebug() << "[loadAsrConfig] 🚀 开始加载ASR配置...";
-        qDebug() << "==========================================";
-        
-        // 获取配置管理器实例
-        configManager_ = ConfigManager::instance();
-        qDebug() << "[loadAsrConfig] ✅ 配置管理器实例获取成功";
-        
-        // 使用QPointer来安全地检查对象是否还存在
-        QPointer<MainWindow> self(this);
-        
-        // 延迟一点点后验证ASR
-        QTimer::singleShot(100, this, [self]() {
-            try {
-                // 检查MainWindow是否还存在
-                if (!self) {
-                    qDebug() << "[loadAsrConfig] ❌ MainWindow已被销毁，跳过ASR验证";
-                    return;
-                }
-                
-                qDebug() << "[loadAsrConfig] 🔍 开始验证ASR配置...";
-                
-                // 检查配置管理器是否有效
-                if (!self->configManager_) {
-                    qDebug() << "[loadAsrConfig] ❌ 配置管理器无效，跳过ASR验证";
-                    perfx::ui::asr_valid = 0;
-                    return;
-                }
-                
-                qDebug() << "[loadAsrConfig] 📋 开始加载ASR配置...";
-                
-                // 加载ASR配置
-                AsrConfig config = self->configManager_->loadConfig();
-                self->asrConfigLoaded_ = true;
-                self->asrConfigValid_ = self->configManager_->hasValidConfig();
-                
-                // 详细打印配置信息
-                qDebug() << "[loadAsrConfig] 📊 配置加载结果:";
-                qDebug() << "   - 配置来源: " << QString::fromStdString(config.configSource);
-                qDebug() << "   - App ID: " << QString::fromStdString(config.appId);
-                qDebug() << "   - Access Token: " << QString::fromStdString(Asr::maskSensitiveInfo(config.accessToken, 4, 4));
-                qDebug() << "   - Secret Key: " << QString::fromStdString(Asr::maskSensitiveInfo(config.secretKey, 4, 4));
-                qDebug() << "   - 配置有效: " << (config.isValid ? "是" : "否");
-                qDebug() << "   - 配置已加载: " << (self->asrConfigLoaded_ ? "是" : "否");
-                qDebug() << "   - 配置验证: " << (self->asrConfigValid_ ? "通过" : "失败");
-                
-                // 打印配置来源说明
-                if (config.configSource == "environment_variables") {
-                    qDebug() << "[loadAsrConfig] 🎯 使用环境变量配置 (ASR_* 前缀)";
-                    qDebug() << "   💡 这是用户自定义的环境变量配置，优先级最高";
-                } else if (config.configSource == "user_config") {
-                    qDebug() << "[loadAsrConfig] 🎯 使用用户界面配置";
-                    qDebug() << "   💡 这是通过系统配置界面保存的配置";
-                } else if (config.configSource == "trial_mode") {
-                    qDebug() << "[loadAsrConfig] 🎯 使用体验模式配置";
-                    qDebug() << "   💡 这是厂商提供的混淆配置，用于体验功能";
-                    qDebug() << "   💡 建议设置环境变量以获得完整功能";
-                } else {
-                    qDebug() << "[loadAsrConfig] 🎯 使用未知配置来源: " << QString::fromStdString(config.configSource);
-                }
-                
-                if (self->asrConfigValid_) {
-                    perfx::ui::asr_valid = 1;
-                    qDebug() << "[loadAsrConfig] ✅ ASR验证成功 - 凭证有效";
-                    qDebug() << "   🎉 现在可以使用ASR功能了！";
-                } else {
-                    perfx::ui::asr_valid = 0;
-                    qDebug() << "[loadAsrConfig] ❌ ASR验证失败 - 需要用户配置";
-                    qDebug() << "   💡 请前往系统配置界面设置ASR凭证";
-                }
-                
-                qDebug() << "==========================================";
-                qDebug() << "[loadAsrConfig] 🏁 ASR配置加载完成";
-                qDebug() << "==========================================";
-                
-            } catch (const std::exception& e) {
-                qDebug() << "[loadAsrConfig] ❌ ASR验证异常:" << e.what();
-                perfx::ui::asr_valid = 0;
-            } catch (...) {
-                qDebug() << "[loadAsrConfig] ❌ ASR验证未知异常";
-                perfx::ui::asr_valid = 0;
-            }
-        });
-    } catch (const std::exception& e) {
-        qDebug() << "[loadAsrConfig] ❌ 配置管理器初始化异常:" << e.what();
-        perfx::ui::asr_valid = 0;
-    } catch (...) {
-        qDebug() << "[loadAsrConfig] ❌ 配置管理器初始化未知异常";
+void MainWindow::onAsrConfigReady(bool valid) {
+    // 配置已由 StartupPipeline 在后台线程加载，这里只更新状态
+    configManager_ = ConfigManager::instance();
+    const AsrConfig& config = startupPipeline_->asrConfig();
+    asrConfigLoaded_ = true;
+    asrConfigValid_ = valid;
+    
+    // 详细打印配置信息
+    qDebug() << "[loadAsrConfig] 📊 配置加载结果:";
+    qDebug() << "   - 配置来源: " << QString::fromStdString(config.configSource);
+    qDebug() << "   - App ID: " << QString::fromStdString(config.appId);
+    qDebug() << "   - Access Token: " << QString::fromStdString(Asr::maskSensitiveInfo(config.accessToken, 4, 4));
+    qDebug() << "   - Secret Key: " << QString::fromStdString(Asr::maskSensitiveInfo(config.secretKey, 4, 4));
+    qDebug() << "   - 配置有效: " << (config.isValid ? "是" : "否");
+    qDebug() << "   - 配置验证: " << (asrConfigValid_ ? "通过" : "失败");
+    
+    // 打印配置来源说明
+    if (config.configSource == "environment_variables") {
+        qDebug() << "[loadAsrConfig] 🎯 使用环境变量配置 (ASR_* 前缀)";
+    } else if (config.configSource == "user_config") {
+        qDebug() << "[loadAsrConfig] 🎯 使用用户界面配置";
+    } else if (config.configSource == "trial_mode") {
+        qDebug() << "[loadAsrConfig] 🎯 使用体验模式配置";
+        qDebug() << "   💡 建议设置环境变量以获得完整功能";
+    } else {
+        qDebug() << "[loadAsrConfig] 🎯 使用未知配置来源: " << QString::fromStdString(config.configSource);
+    }
+    
+    if (asrConfigValid_) {
+        perfx::ui::asr_valid = 1;
+        qDebug() << "[loadAsrConfig] ✅ ASR验证成功 - 凭证有效";
+    } else {
         perfx::ui::asr_valid = 0;
+        qDebug() << "[loadAsrConfig] ❌ ASR验证失败 - 需要用户配置";
+        qDebug() << "   💡 请前往系统配置界面设置ASR凭证";
     }
 }
 
@@ -536,48 +540,30 @@ void MainWindow::mouseMoveEvent(QMouseEvent *event) {
 }
 
 void MainWindow::switchToAudioToText() {
-    // 检查ASR凭证有效性
-    if (perfx::ui::asr_valid == 0) {
-        QMessageBox::warning(this, "ASR未就绪", 
-            "ASR配置未验证或验证失败，请先配置ASR。");
+    if (!checkAsrReady()) {
         return;
     }
-    if (audioToTextWindow_) {
-        stackedWidget_->setCurrentWidget(audioToTextWindow_);
-    } else {
-        qWarning() << "audioToTextWindow_ is nullptr!";
-    }
+    stackedWidget_->setCurrentWidget(ensureAudioToTextWindow());
 }
 
 void MainWindow::switchToRealtimeAudioToText() {
-    // 检查ASR凭证有效性
-    if (perfx::ui::asr_valid == 0) {
-        QMessageBox::warning(this, "ASR未就绪", 
-            "ASR配置未验证或验证失败，请先配置ASR。");
+    if (!checkAsrReady()) {
         return;
     }
-    
-    if (!realtimeAudioToTextWindow_) {
-        realtimeAudioToTextWindow_ = new RealtimeAudioToTextWindow(this);
-        stackedWidget_->addWidget(realtimeAudioToTextWindow_);
-        connect(realtimeAudioToTextWindow_, &RealtimeAudioToTextWindow::backToMainMenuRequested, 
-                this, &MainWindow::switchToMainMenu);
-    }
-    
-    if (realtimeAudioToTextWindow_) {
-        stackedWidget_->setCurrentWidget(realtimeAudioToTextWindow_);
-        realtimeAudioToTextWindow_->startMicCollection();
-    } else {
-        qWarning() << "realtimeAudioToTextWindow_ is nullptr!";
+    // PortAudio 不是线程安全的，后台初始化完成前不能打开录音页
+    if (!startupPipeline_ || !startupPipeline_->isAudioReady()) {
+        QMessageBox::information(this, "正在初始化",
+            "音频设备正在初始化，请稍候再试。");
+        return;
     }
+
+    RealtimeAudioToTextWindow* window = ensureRealtimeAudioToTextWindow();
+    stackedWidget_->setCurrentWidget(window);
+    window->startMicCollection();
 }
 
 void MainWindow::switchToSystemConfig() {
-    if (systemConfigWindow_) {
-        stackedWidget_->setCurrentWidget(systemConfigWindow_);
-    } else {
-        qWarning() << "systemConfigWindow_ is nullptr!";
-    }
+    stackedWidget_->setCurrentWidget(ensureSystemConfigWindow());
 }
 
 void MainWindow::switchToMainMenu() {
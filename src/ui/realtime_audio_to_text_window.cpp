@@ -2,6 +2,7 @@
 #include "ui/config_manager.h"
 #include "ui/global_state.h"
 #include "logic/realtime_transcription_controller.h"
+#include "audio/trace_events.h"
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QDir>
@@ -742,6 +743,7 @@ void RealtimeAudioToTextWindow::onAsrConnectionStatusChanged(bool connected) {
 }
 
 void RealtimeAudioToTextWindow::onAsrUtterancesUpdated(const QList<QVariantMap>& utterances) {
+    PERFX_TRACE_SCOPE("ui.render_transcript");
     // 不要每次都清空lines，而是累积新的内容
     QStringList newLines;
     QString previewLine;
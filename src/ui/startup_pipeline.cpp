@@ -0,0 +1,291 @@
+#include "ui/startup_pipeline.h"
+#include "asr/asr_manager.h"
+#include "audio/device_registry.h"
+#include <QtConcurrent>
+#include <QFutureWatcher>
+#include <QThread>
+#include <QDebug>
+#include <algorithm>
+
+namespace perfx {
+namespace ui {
+
+// ============================================================================
+// StartupTrace
+// ============================================================================
+
+StartupTrace& StartupTrace::instance() {
+    static StartupTrace trace;
+    return trace;
+}
+
+StartupTrace::StartupTrace() {
+    clock_.start();
+}
+
+void StartupTrace::begin() {
+    QMutexLocker locker(&mutex_);
+    clock_.restart();
+    phases_.clear();
+}
+
+qint64 StartupTrace::elapsedMs() const {
+    return clock_.elapsed();
+}
+
+void StartupTrace::record(const QString& name, qint64 startMs, qint64 durationMs, bool ok) {
+    StartupPhase phase;
+    phase.name = name;
+    phase.thread = QThread::isMainThread() ? QStringLiteral("gui") : QStringLiteral("worker");
+    phase.startMs = startMs;
+    phase.durationMs = durationMs;
+    phase.ok = ok;
+
+    QMutexLocker locker(&mutex_);
+    phases_.push_back(phase);
+}
+
+void StartupTrace::mark(const QString& name) {
+    record(name, elapsedMs(), 0, true);
+}
+
+std::vector<StartupPhase> StartupTrace::phases() const {
+    QMutexLocker locker(&mutex_);
+    return phases_;
+}
+
+void StartupTrace::dump() const {
+    std::vector<StartupPhase> sorted = phases();
+    std::sort(sorted.begin(), sorted.end(), [](const StartupPhase& a, const StartupPhase& b) {
+        return a.startMs < b.startMs;
+    });
+
+    qDebug() << "==========================================";
+    qDebug() << "[STARTUP] ⏱️ 启动阶段耗时 (相对进程启动):";
+    for (const auto& phase : sorted) {
+        qDebug().noquote() << QString("   - %1 @%2ms +%3ms [%4]%5")
+                                  .arg(phase.name, -22)
+                                  .arg(phase.startMs, 6)
+                                  .arg(phase.durationMs, 5)
+                                  .arg(phase.thread)
+                                  .arg(phase.ok ? QString() : QStringLiteral(" ❌"));
+    }
+    qDebug() << "[STARTUP] 🏁 总计:" << elapsedMs() << "ms";
+    qDebug() << "==========================================";
+}
+
+// ============================================================================
+// ScopedStartupPhase
+// ============================================================================
+
+ScopedStartupPhase::ScopedStartupPhase(const QString& name)
+    : name_(name)
+    , startMs_(StartupTrace::instance().elapsedMs())
+{
+}
+
+ScopedStartupPhase::~ScopedStartupPhase() {
+    StartupTrace& trace = StartupTrace::instance();
+    trace.record(name_, startMs_, trace.elapsedMs() - startMs_, ok_);
+}
+
+// ============================================================================
+// StartupPipeline
+// ============================================================================
+
+// 某些宿主 API 枚举很慢，超时后不阻塞其余启动流程
+static constexpr int kDeviceRegistryTimeoutMs = 10000;
+
+StartupPipeline::StartupPipeline(QObject* parent)
+    : QObject(parent)
+{
+    // 三个任务互相独立，各占一个线程即可；不使用全局线程池，避免与界面中的 QtConcurrent 任务抢占
+    pool_.setMaxThreadCount(3);
+}
+
+StartupPipeline::~StartupPipeline() {
+    // 等待尚未结束的任务，避免其访问已销毁的对象
+    pool_.waitForDone();
+    // removeListener 返回后不会再有回调；已投递的调用随本对象销毁被丢弃
+    if (registryListener_ >= 0) {
+        audio::DeviceRegistry::getInstance().removeListener(registryListener_);
+    }
+}
+
+void StartupPipeline::start() {
+    if (started_) {
+        return;
+    }
+    started_ = true;
+
+    qDebug() << "[STARTUP] 🚀 启动后台初始化任务 @" << StartupTrace::instance().elapsedMs() << "ms";
+
+    startAudioTask();
+    startConfigTask();
+    startStatsTask();
+}
+
+void StartupPipeline::startAudioTask() {
+    ++pendingTasks_;
+
+    auto* watcher = new QFutureWatcher<AudioResult>(this);
+    connect(watcher, &QFutureWatcher<AudioResult>::finished, this, [this, watcher]() {
+        AudioResult result = watcher->result();
+        watcher->deleteLater();
+
+        if (result.timedOut) {
+            // 超时得到的空列表不是最终结果：设备列表保持未就绪，注册表就绪后再刷新
+            emit audioReady(false);
+            watchRegistryReady();
+        } else {
+            publishDevices(std::move(result.devices));
+        }
+        onTaskFinished();
+    });
+
+    watcher->setFuture(QtConcurrent::run(&pool_, []() {
+        // PortAudio 初始化、设备枚举与采样率探测都在注册表的后台线程中完成
+        ScopedStartupPhase phase("audio_device_registry");
+        AudioResult result;
+        audio::DeviceRegistry& registry = audio::DeviceRegistry::getInstance();
+        registry.start();
+        result.timedOut = !registry.waitUntilReady(kDeviceRegistryTimeoutMs);
+        if (result.timedOut) {
+            qWarning() << "[STARTUP] 设备枚举超时";
+            phase.setOk(false);
+            return result;
+        }
+        result.devices = registry.getInputDevices();
+        return result;
+    }));
+}
+
+void StartupPipeline::publishDevices(std::vector<audio::DeviceInfo> devices) {
+    inputDevices_ = std::move(devices);
+    audioReady_ = true;
+
+    QStringList names;
+    QList<int> indices;
+    for (const auto& device : inputDevices_) {
+        names << QString::fromStdString(device.name);
+        indices << device.index;
+    }
+
+    emit audioReady(true);
+    emit devicesReady(names, indices);
+}
+
+void StartupPipeline::watchRegistryReady() {
+    audio::DeviceRegistry& registry = audio::DeviceRegistry::getInstance();
+    // 监听者在注册表工作线程中被调用，切换到 GUI 线程再读取设备列表
+    registryListener_ = registry.addListener([this](audio::DeviceRegistry::Event event,
+                                                    const std::vector<std::string>&,
+                                                    const std::vector<std::string>&) {
+        if (event == audio::DeviceRegistry::Event::Ready) {
+            QMetaObject::invokeMethod(this, [this]() { onRegistryReady(); }, Qt::QueuedConnection);
+        }
+    });
+    // 超时与注册监听者之间可能已经就绪
+    if (registry.isReady()) {
+        QMetaObject::invokeMethod(this, [this]() { onRegistryReady(); }, Qt::QueuedConnection);
+    }
+}
+
+void StartupPipeline::onRegistryReady() {
+    if (audioReady_) {
+        return;
+    }
+    audio::DeviceRegistry& registry = audio::DeviceRegistry::getInstance();
+    if (registryListener_ >= 0) {
+        registry.removeListener(registryListener_);
+        registryListener_ = -1;
+    }
+    StartupTrace::instance().mark("audio_device_registry_late");
+    qDebug() << "[STARTUP] 设备枚举在超时后完成";
+    publishDevices(registry.getInputDevices());
+}
+
+void StartupPipeline::startConfigTask() {
+    ++pendingTasks_;
+
+    // ConfigManager 是 QObject，必须在 GUI 线程创建以保持线程归属；后台只读取配置，
+    // 结果回到 GUI 线程再写入 ConfigManager，界面不会与加载并发访问其状态
+    ConfigManager* configManager = ConfigManager::instance();
+    const QString configPath = configManager->getConfigFilePath();
+
+    auto* watcher = new QFutureWatcher<ConfigResult>(this);
+    connect(watcher, &QFutureWatcher<ConfigResult>::finished, this, [this, watcher, configManager]() {
+        ConfigResult result = watcher->result();
+        watcher->deleteLater();
+
+        if (result.loaded) {
+            configManager->applyLoadedConfig(result.config, result.source);
+        }
+        asrConfig_ = result.config;
+        configReady_ = true;
+
+        emit configReady(configManager->hasValidConfig());
+        onTaskFinished();
+    });
+
+    watcher->setFuture(QtConcurrent::run(&pool_, [configPath]() {
+        ScopedStartupPhase phase("config_load");
+        ConfigResult result;
+        try {
+            auto loaded = ConfigLoader::loadConfigWithPriority(configPath);
+            result.config = loaded.first;
+            result.source = loaded.second;
+            result.loaded = true;
+        } catch (const std::exception& e) {
+            qWarning() << "[STARTUP] 配置加载异常:" << e.what();
+            phase.setOk(false);
+        }
+        return result;
+    }));
+}
+
+void StartupPipeline::startStatsTask() {
+    ++pendingTasks_;
+
+    auto* watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher]() {
+        bool ok = watcher->result();
+        watcher->deleteLater();
+
+        statsReady_ = true;
+
+        emit statsReady(ok);
+        onTaskFinished();
+    });
+
+    watcher->setFuture(QtConcurrent::run(&pool_, []() {
+        bool ok = true;
+        try {
+            {
+                // 首次访问单例时会读取环境变量并打印日志配置
+                ScopedStartupPhase phase("asr_manager_init");
+                Asr::AsrManager::instance();
+            }
+            ScopedStartupPhase phase("asr_stats_load");
+            ok = Asr::AsrManager::instance().loadStats();
+            phase.setOk(ok);
+        } catch (const std::exception& e) {
+            qWarning() << "[STARTUP] ASR统计加载异常:" << e.what();
+            ok = false;
+        }
+        return ok;
+    }));
+}
+
+void StartupPipeline::onTaskFinished() {
+    if (--pendingTasks_ > 0) {
+        return;
+    }
+
+    StartupTrace::instance().mark("startup_complete");
+    StartupTrace::instance().dump();
+    emit finished();
+}
+
+} // namespace ui
+} // namespace perfx